@@ -44,6 +44,7 @@
 #include "bp/tagescl.h"
 #include "bp/twolevel.h"
 #include "libs/cache_lib.h"
+#include "cmp_threads.h"
 #include "model.h"
 #include "thread.h"
 #include "uop_cache.h"
@@ -83,8 +84,8 @@ extern void tc_do_stat(Op*, Flag);
 /******************************************************************************/
 /* Global Variables */
 
-Bp_Recovery_Info* bp_recovery_info = NULL;
-Bp_Data*          g_bp_data        = NULL;
+SIM_THREAD_LOCAL Bp_Recovery_Info* bp_recovery_info = NULL;
+SIM_THREAD_LOCAL Bp_Data*          g_bp_data        = NULL;
 Flag              USE_LATE_BP      = FALSE;
 extern List       op_buf;
 extern uns        operating_mode;
@@ -136,19 +137,19 @@ void bp_sched_recovery(Bp_Recovery_Info* bp_recovery_info, Op* op,
                        Flag force_offpath) {
   ASSERT(op->proc_id, bp_recovery_info->proc_id == op->proc_id);
   ASSERT(0, !op->off_path);
-  if (op->oracle_info.recover_at_exec) {
-    INC_STAT_EVENT(0, SCHEDULED_EXEC_LAT, cycle_count - op->recovery_info.predict_cycle);
-    STAT_EVENT(0, SCHEDULED_EXEC_RECOVERIES);
+  if (OP_ORACLE(op).recover_at_exec) {
+    SHARED_INC_STAT_EVENT(0, SCHEDULED_EXEC_LAT, cycle_count - op->recovery_info.predict_cycle);
+    SHARED_STAT_EVENT(0, SCHEDULED_EXEC_RECOVERIES);
   }
-  else if (op->oracle_info.recover_at_decode) {
-    INC_STAT_EVENT(0, SCHEDULED_DECODE_LAT, cycle_count - op->recovery_info.predict_cycle);
-    STAT_EVENT(0, SCHEDULED_DECODE_RECOVERIES);
+  else if (OP_ORACLE(op).recover_at_decode) {
+    SHARED_INC_STAT_EVENT(0, SCHEDULED_DECODE_LAT, cycle_count - op->recovery_info.predict_cycle);
+    SHARED_STAT_EVENT(0, SCHEDULED_DECODE_RECOVERIES);
   }
 
   if(bp_recovery_info->recovery_cycle == MAX_CTR ||
      op->op_num <= bp_recovery_info->recovery_op_num) {
-    const Addr next_fetch_addr = op->oracle_info.npc;
-    ASSERT(0, op->oracle_info.npc);
+    const Addr next_fetch_addr = OP_ORACLE(op).npc;
+    ASSERT(0, OP_ORACLE(op).npc);
     const uns latency = late_bp_recovery ? LATE_BP_LATENCY : 1;
     DEBUG(
       bp_recovery_info->proc_id,
@@ -156,8 +157,8 @@ void bp_sched_recovery(Bp_Recovery_Info* bp_recovery_info, Op* op,
       unsstr64(op->op_num), hexstr64s(op->inst_info->addr),
       hexstr64s(next_fetch_addr), op->off_path);
     inc_bstat_miss(op);
-    ASSERT(op->proc_id, !op->oracle_info.recovery_sch);
-    op->oracle_info.recovery_sch          = TRUE;
+    ASSERT(op->proc_id, !OP_ORACLE(op).recovery_sch);
+    OP_ORACLE(op).recovery_sch            = TRUE;
     bp_recovery_info->recovery_cycle      = cycle + latency;
     bp_recovery_info->recovery_fetch_addr = next_fetch_addr;
     if(op->proc_id)
@@ -178,8 +179,8 @@ void bp_sched_recovery(Bp_Recovery_Info* bp_recovery_info, Op* op,
 
     if(force_offpath) {
       ASSERT(op->proc_id, late_bp_recovery);
-      bp_recovery_info->recovery_fetch_addr    = op->oracle_info.late_pred_npc;
-      bp_recovery_info->recovery_info.new_dir  = op->oracle_info.late_pred;
+      bp_recovery_info->recovery_fetch_addr    = OP_ORACLE(op).late_pred_npc;
+      bp_recovery_info->recovery_info.new_dir  = OP_ORACLE(op).late_pred;
       bp_recovery_info->recovery_force_offpath = TRUE;
       bp_recovery_info->late_bp_recovery_wrong = TRUE;
     } else {
@@ -191,6 +192,7 @@ void bp_sched_recovery(Bp_Recovery_Info* bp_recovery_info, Op* op,
 void inc_bstat_fetched(Op* op) {
   Flag new_entry;
   int64 key = convert_to_cmp_addr(op->table_info->cf_type, op->inst_info->addr);
+  cmp_threads_lock();  // per_branch_stat is shared by all cores
   Per_Branch_Stat* bstat = (Per_Branch_Stat*) hash_table_access_create(&per_branch_stat, key, &new_entry);
   if (new_entry) {
     memset(bstat, 0, sizeof(*bstat));
@@ -199,20 +201,23 @@ void inc_bstat_fetched(Op* op) {
   }
 
   // target if taken
-  if (op->oracle_info.pred == TAKEN && !(op->oracle_info.recover_at_exec || op->oracle_info.recover_at_decode))
-    bstat->target = op->oracle_info.npc;
+  if (OP_ORACLE(op).pred == TAKEN && !(OP_ORACLE(op).recover_at_exec || OP_ORACLE(op).recover_at_decode))
+    bstat->target = OP_ORACLE(op).npc;
+  cmp_threads_unlock();
 }
 
 void inc_bstat_miss(Op* op) {
   int64 key = convert_to_cmp_addr(op->table_info->cf_type, op->inst_info->addr);
+  cmp_threads_lock();
   Per_Branch_Stat* bstat = (Per_Branch_Stat*) hash_table_access(&per_branch_stat, key);
+  cmp_threads_unlock();
   ASSERT(bp_recovery_info->proc_id, bstat);
 
-  const uns8 mispred = (op->table_info->cf_type == CF_CBR) && !op->oracle_info.btb_miss;
-  const uns8 misfetch = op->oracle_info.misfetch;
-  const uns8 btb_miss = op->oracle_info.btb_miss;
+  const uns8 mispred = (op->table_info->cf_type == CF_CBR) && !OP_ORACLE(op).btb_miss;
+  const uns8 misfetch = OP_ORACLE(op).misfetch;
+  const uns8 btb_miss = OP_ORACLE(op).btb_miss;
 
-  ASSERT(bp_recovery_info->proc_id, op->oracle_info.recover_at_decode || op->oracle_info.recover_at_exec);
+  ASSERT(bp_recovery_info->proc_id, OP_ORACLE(op).recover_at_decode || OP_ORACLE(op).recover_at_exec);
 
   if (op->off_path)
     return;  // TODO(peterbraun): add off-path branch stats
@@ -223,7 +228,7 @@ void inc_bstat_miss(Op* op) {
     return;
   }
 
-  if (op->fetched_from_uop_cache && op->oracle_info.recover_at_decode)
+  if (op->fetched_from_uop_cache && OP_ORACLE(op).recover_at_decode)
     STAT_EVENT(bp_recovery_info->proc_id, RECOVER_AT_DECODE_BR_FROM_UOC);
 }
 
@@ -248,11 +253,11 @@ void bp_sched_redirect(Bp_Recovery_Info* bp_recovery_info, Op* op,
     bp_recovery_info->redirect_op->redirect_scheduled = TRUE;
     ASSERT(bp_recovery_info->proc_id, bp_recovery_info->proc_id == op->proc_id);
     ASSERT_PROC_ID_IN_ADDR(op->proc_id,
-                           bp_recovery_info->redirect_op->oracle_info.pred_npc);
+                           OP_ORACLE(bp_recovery_info->redirect_op).pred_npc);
   }
   ASSERT(bp_recovery_info->proc_id, bp_recovery_info->proc_id == op->proc_id);
   ASSERT_PROC_ID_IN_ADDR(op->proc_id,
-                         bp_recovery_info->redirect_op->oracle_info.pred_npc);
+                         OP_ORACLE(bp_recovery_info->redirect_op).pred_npc);
 }
 
 
@@ -330,10 +335,10 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
   ASSERT(bp_data->proc_id, op->table_info->cf_type);
 
   /* set address used to predict branch */
-  // op->oracle_info.pred_addr         = addr;
-  op->oracle_info.pred_addr         = op->inst_info->addr;
-  op->oracle_info.btb_miss_resolved = FALSE;
-  op->cf_within_fetch               = br_num;
+  // OP_ORACLE(op).pred_addr         = addr;
+  OP_ORACLE(op).pred_addr         = op->inst_info->addr;
+  OP_ORACLE(op).btb_miss_resolved = FALSE;
+  op->cf_within_fetch             = br_num;
 
   /* initialize recovery information---this stuff might be
      overwritten by a prediction function that uses and
@@ -341,15 +346,15 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
   op->recovery_info.proc_id          = op->proc_id;
   op->recovery_info.pred_global_hist = bp_data->global_hist;
   op->recovery_info.targ_hist        = bp_data->targ_hist;
-  op->recovery_info.new_dir          = op->oracle_info.dir;
+  op->recovery_info.new_dir          = OP_ORACLE(op).dir;
   op->recovery_info.crs_next         = bp_data->crs.next;
   op->recovery_info.crs_tos          = bp_data->crs.tos;
   op->recovery_info.crs_depth        = bp_data->crs.depth;
   op->recovery_info.op_num           = op->op_num;
   op->recovery_info.PC               = op->inst_info->addr;
   op->recovery_info.cf_type          = op->table_info->cf_type;
-  op->recovery_info.oracle_dir       = op->oracle_info.dir;
-  op->recovery_info.branchTarget     = op->oracle_info.target;
+  op->recovery_info.oracle_dir       = OP_ORACLE(op).dir;
+  op->recovery_info.branchTarget     = OP_ORACLE(op).target;
   op->recovery_info.predict_cycle    = cycle_count;
 
   bp_data->bp->timestamp_func(op);
@@ -381,24 +386,24 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
 
   // {{{ special case--system calls
   if(op->table_info->cf_type == CF_SYS) {
-    op->oracle_info.pred          = TAKEN;
-    op->oracle_info.misfetch      = FALSE;
-    op->oracle_info.mispred       = FALSE;
-    op->oracle_info.late_misfetch = FALSE;
-    op->oracle_info.late_mispred  = FALSE;
-    op->oracle_info.btb_miss      = FALSE;
-    op->oracle_info.no_target     = FALSE;
+    OP_ORACLE(op).pred          = TAKEN;
+    OP_ORACLE(op).misfetch      = FALSE;
+    OP_ORACLE(op).mispred       = FALSE;
+    OP_ORACLE(op).late_misfetch = FALSE;
+    OP_ORACLE(op).late_mispred  = FALSE;
+    OP_ORACLE(op).btb_miss      = FALSE;
+    OP_ORACLE(op).no_target     = FALSE;
     // Syscalls cause flush of later ops at decode
-    op->oracle_info.recover_at_decode = TRUE;
-    op->oracle_info.recover_at_exec = FALSE;
-    ASSERT_PROC_ID_IN_ADDR(op->proc_id, op->oracle_info.npc);
-    op->oracle_info.pred_npc      = op->oracle_info.npc;
-    op->oracle_info.late_pred_npc = op->oracle_info.npc;
+    OP_ORACLE(op).recover_at_decode = TRUE;
+    OP_ORACLE(op).recover_at_exec = FALSE;
+    ASSERT_PROC_ID_IN_ADDR(op->proc_id, OP_ORACLE(op).npc);
+    OP_ORACLE(op).pred_npc      = OP_ORACLE(op).npc;
+    OP_ORACLE(op).late_pred_npc = OP_ORACLE(op).npc;
     bp_data->bp->spec_update_func(op);
     if(USE_LATE_BP) {
       bp_data->late_bp->spec_update_func(op);
     }
-    return op->oracle_info.npc;
+    return OP_ORACLE(op).npc;
   }
   else
     ASSERT(0, !(op->table_info->bar_type & BAR_FETCH));
@@ -410,14 +415,14 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
   // In the event of a btb miss, the branch will predicted as
   // normal, but will incur the redirect penalty for missing in the
   // btb.  btb_miss and pred_target are set appropriately.
-  op->oracle_info.no_target = TRUE;
-  op->oracle_info.misfetch      = FALSE;
+  OP_ORACLE(op).no_target = TRUE;
+  OP_ORACLE(op).misfetch      = FALSE;
   btb_target = bp_data->bp_btb->pred_func(bp_data, op);
   if(btb_target) {
     // btb hit
-    op->oracle_info.btb_miss  = FALSE;
-    op->oracle_info.no_target = FALSE;
-    pred_target               = *btb_target;
+    OP_ORACLE(op).btb_miss  = FALSE;
+    OP_ORACLE(op).no_target = FALSE;
+    pred_target             = *btb_target;
     if (op->table_info->cf_type != CF_ICO && op->table_info->cf_type != CF_RET &&
         !(op->table_info->bar_type & BAR_FETCH)) {
       STAT_EVENT(op->proc_id, BTB_CORRECT + op->off_path * NUM_BR_STATS);
@@ -434,10 +439,10 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
     // In the case where fall-through == branch target, ignore BTB miss
     // This almost never happes but if it does, without the fix below, it would cause
     // recovery where the recovery address is incorrect
-    if (pc_plus_offset == op->oracle_info.target) {
-      op->oracle_info.btb_miss  = FALSE;
-      op->oracle_info.no_target = FALSE;
-      op->oracle_info.pred      = TAKEN;
+    if (pc_plus_offset == OP_ORACLE(op).target) {
+      OP_ORACLE(op).btb_miss  = FALSE;
+      OP_ORACLE(op).no_target = FALSE;
+      OP_ORACLE(op).pred      = TAKEN;
       btb_target = &pred_target; //make !NULL
       if (op->table_info->cf_type != CF_ICO && op->table_info->cf_type != CF_RET &&
           !(op->table_info->bar_type & BAR_FETCH)) {
@@ -446,20 +451,20 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
     }
     else {
       // btb miss
-      op->oracle_info.btb_miss  = TRUE;
+      OP_ORACLE(op).btb_miss  = TRUE;
     }
   }
   // overwrite pred_target with indirect predictor
   if(ENABLE_IBP && (op->table_info->cf_type == CF_IBR || op->table_info->cf_type == CF_ICALL)) {
     ibp_target = bp_data->bp_ibtb->pred_func(bp_data, op);
     if(ibp_target) {
-      pred_target               = ibp_target;
-      op->oracle_info.no_target = FALSE;
-      op->oracle_info.ibp_miss  = FALSE;
+      pred_target             = ibp_target;
+      OP_ORACLE(op).no_target = FALSE;
+      OP_ORACLE(op).ibp_miss  = FALSE;
       STAT_EVENT(op->proc_id, IBTB_CORRECT + op->off_path * NUM_BR_STATS);
     }
     else {
-      op->oracle_info.ibp_miss  = TRUE;
+      OP_ORACLE(op).ibp_miss  = TRUE;
       STAT_EVENT(op->proc_id, IBTB_INCORRECT + op->off_path * NUM_BR_STATS);
     }
   }
@@ -469,103 +474,103 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
   switch(op->table_info->cf_type) {
     case CF_BR:
       // BR will be predicted at decode, but fill in the info here
-      op->oracle_info.late_pred = TAKEN;
-      op->oracle_info.pred_orig = TAKEN;
+      OP_ORACLE(op).late_pred = TAKEN;
+      OP_ORACLE(op).pred_orig = TAKEN;
       if(!op->off_path)
         STAT_EVENT(op->proc_id, CF_BR_USED_TARGET_CORRECT +
-                                  (pred_target != op->oracle_info.npc));
+                                  (pred_target != OP_ORACLE(op).npc));
       // On BTB hit, ensure that target is correct (no aliasing or jitted code)
-      if (btb_target && pred_target == op->oracle_info.npc) {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = FALSE;
-        op->oracle_info.pred = TAKEN;
-        op->oracle_info.pred_npc = pred_target;
+      if (btb_target && pred_target == OP_ORACLE(op).npc) {
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = FALSE;
+        OP_ORACLE(op).pred = TAKEN;
+        OP_ORACLE(op).pred_npc = pred_target;
         STAT_EVENT(op->proc_id, BR_CORRECT + op->off_path * NUM_BR_STATS);
        }
       else {
-        op->oracle_info.recover_at_decode = TRUE;
-        op->oracle_info.recover_at_exec = FALSE;
-        op->oracle_info.pred = NOT_TAKEN;
-        op->oracle_info.pred_npc = pc_plus_offset;
+        OP_ORACLE(op).recover_at_decode = TRUE;
+        OP_ORACLE(op).recover_at_exec = FALSE;
+        OP_ORACLE(op).pred = NOT_TAKEN;
+        OP_ORACLE(op).pred_npc = pc_plus_offset;
         STAT_EVENT(op->proc_id, BR_RECOVER + op->off_path * NUM_BR_STATS);
       }
       break;
 
     case CF_CBR:
       // Branch predictors may use pred_global_hist as input.
-      op->oracle_info.pred_global_hist = bp_data->global_hist;
+      OP_ORACLE(op).pred_global_hist = bp_data->global_hist;
 
       if(PERFECT_BP) {
-        op->oracle_info.pred      = op->oracle_info.dir;
-        op->oracle_info.pred_orig = op->oracle_info.dir;
-        op->oracle_info.no_target = FALSE;
+        OP_ORACLE(op).pred      = OP_ORACLE(op).dir;
+        OP_ORACLE(op).pred_orig = OP_ORACLE(op).dir;
+        OP_ORACLE(op).no_target = FALSE;
       } else {
         ASSERT(op->proc_id, !PERFECT_NT_BTB); //currently not supported
-        op->oracle_info.pred = bp_data->bp->pred_func(op);
-        op->oracle_info.pred_orig = op->oracle_info.pred;
+        OP_ORACLE(op).pred = bp_data->bp->pred_func(op);
+        OP_ORACLE(op).pred_orig = OP_ORACLE(op).pred;
         if(USE_LATE_BP) {
-          op->oracle_info.late_pred = bp_data->late_bp->pred_func(op);
+          OP_ORACLE(op).late_pred = bp_data->late_bp->pred_func(op);
         }
       }
       // Update history used by the rest of Scarab.
       bp_data->global_hist = (bp_data->global_hist >> 1) |
-                             (op->oracle_info.pred << 31);
+                             (OP_ORACLE(op).pred << 31);
 
-      if(op->oracle_info.btb_miss && op->oracle_info.pred == NOT_TAKEN)
+      if(OP_ORACLE(op).btb_miss && OP_ORACLE(op).pred == NOT_TAKEN)
         btb_miss_nt = TRUE;
 
       if(PERFECT_CBR_BTB ||
-         (PERFECT_NT_BTB && op->oracle_info.pred == NOT_TAKEN)) {
-        pred_target               = op->oracle_info.target;
-        op->oracle_info.btb_miss  = FALSE;
-        op->oracle_info.no_target = FALSE;
+         (PERFECT_NT_BTB && OP_ORACLE(op).pred == NOT_TAKEN)) {
+        pred_target             = OP_ORACLE(op).target;
+        OP_ORACLE(op).btb_miss  = FALSE;
+        OP_ORACLE(op).no_target = FALSE;
       }
 
-      if(!op->off_path && op->oracle_info.pred)
+      if(!op->off_path && OP_ORACLE(op).pred)
         STAT_EVENT(op->proc_id, CF_CBR_USED_TARGET_CORRECT +
-                                  (pred_target != op->oracle_info.npc));
+                                  (pred_target != OP_ORACLE(op).npc));
 
       // pred_target is set by BTB on hit. For CBR we may however, still want to execute fall-through
-      if (op->oracle_info.pred == NOT_TAKEN) {
+      if (OP_ORACLE(op).pred == NOT_TAKEN) {
         pred_target = pc_plus_offset;
       }
 
       // Regular mispredict resolved at exec
       // On dir misprediction, treat as correctly predicted if fall-through happens to match target
-      if (btb_target && op->oracle_info.dir != op->oracle_info.pred && pc_plus_offset != op->oracle_info.target) {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = TRUE;
-        op->oracle_info.pred_npc = pred_target;
+      if (btb_target && OP_ORACLE(op).dir != OP_ORACLE(op).pred && pc_plus_offset != OP_ORACLE(op).target) {
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = TRUE;
+        OP_ORACLE(op).pred_npc = pred_target;
 
-        if (op->oracle_info.pred == TAKEN )
+        if (OP_ORACLE(op).pred == TAKEN )
           ASSERT(0, pred_target != pc_plus_offset);
-        if (op->oracle_info.pred == NOT_TAKEN)
+        if (OP_ORACLE(op).pred == NOT_TAKEN)
           ASSERT(0, pred_target == pc_plus_offset);
 
         STAT_EVENT(op->proc_id, CBR_RECOVER_MISPREDICT + op->off_path * NUM_BR_STATS);
       }
       // Although the btb hits and cbr is correctly predicted, target address may be wrong (aliasing or jitted code)
-      else if (btb_target && pred_target != op->oracle_info.npc) {
-          op->oracle_info.recover_at_decode = TRUE;
-          op->oracle_info.recover_at_exec = FALSE;
-          op->oracle_info.pred_npc = pred_target;
+      else if (btb_target && pred_target != OP_ORACLE(op).npc) {
+          OP_ORACLE(op).recover_at_decode = TRUE;
+          OP_ORACLE(op).recover_at_exec = FALSE;
+          OP_ORACLE(op).pred_npc = pred_target;
           STAT_EVENT(op->proc_id, CBR_RECOVER_MISFETCH + op->off_path * NUM_BR_STATS);
       }
       // Correctly predicted
       else if (btb_target) {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = FALSE;
-        op->oracle_info.pred_npc = pred_target;
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = FALSE;
+        OP_ORACLE(op).pred_npc = pred_target;
         STAT_EVENT(op->proc_id, CBR_CORRECT + op->off_path * NUM_BR_STATS);
       }
       // If BTB missed, the branch will be assumed not taken at fetch. At decode we detect
       // the branch and will predict. There are 4 outcomes:
       // 1. Branch is predicted taken, violating not-taken assumption, causing flush at decode
-      else if (!btb_target && op->oracle_info.pred == TAKEN && op->oracle_info.dir == TAKEN) {
-        op->oracle_info.recover_at_decode = TRUE;
-        op->oracle_info.recover_at_exec = FALSE;
-        op->oracle_info.pred = NOT_TAKEN;
-        op->oracle_info.pred_npc = pc_plus_offset;
+      else if (!btb_target && OP_ORACLE(op).pred == TAKEN && OP_ORACLE(op).dir == TAKEN) {
+        OP_ORACLE(op).recover_at_decode = TRUE;
+        OP_ORACLE(op).recover_at_exec = FALSE;
+        OP_ORACLE(op).pred = NOT_TAKEN;
+        OP_ORACLE(op).pred_npc = pc_plus_offset;
         STAT_EVENT(op->proc_id, CBR_RECOVER_BTB_MISS_T_T + op->off_path * NUM_BR_STATS);
 	      if (FDIP_BP_CONFIDENCE)
           fdip_inc_cnt_btb_miss(op->proc_id);
@@ -573,31 +578,31 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
       // 2. Branch is predicted taken, violating not-taken asumption. This would flush at decode,
       // however, the branch will flush again at exec when it is determined that the prediction was wrong
       // Scarab does not support flushing twice per op. Flushing at exec should not introduce inaccuracy.
-      else if (!btb_target && op->oracle_info.pred == TAKEN && op->oracle_info.dir == NOT_TAKEN) {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = TRUE;
-        op->oracle_info.pred = NOT_TAKEN;
-        op->oracle_info.pred_npc = pred_target; //Not accurate. At fetch it would execute pc_plus_offset, at decode would resteer frontend to pred_taken
+      else if (!btb_target && OP_ORACLE(op).pred == TAKEN && OP_ORACLE(op).dir == NOT_TAKEN) {
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = TRUE;
+        OP_ORACLE(op).pred = NOT_TAKEN;
+        OP_ORACLE(op).pred_npc = pred_target; //Not accurate. At fetch it would execute pc_plus_offset, at decode would resteer frontend to pred_taken
         STAT_EVENT(op->proc_id, CBR_RECOVER_BTB_MISS_T_NT + op->off_path * NUM_BR_STATS);
 	      if (FDIP_BP_CONFIDENCE)
           fdip_inc_cnt_btb_miss(op->proc_id);
       }
       // 3. Branch is predicted not-taken causing branch to continue to exec where the flush is triggered
-      else if (!btb_target && op->oracle_info.pred == NOT_TAKEN && op->oracle_info.dir == TAKEN) {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = TRUE;
-        op->oracle_info.pred = NOT_TAKEN;
-        op->oracle_info.pred_npc = pc_plus_offset;
+      else if (!btb_target && OP_ORACLE(op).pred == NOT_TAKEN && OP_ORACLE(op).dir == TAKEN) {
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = TRUE;
+        OP_ORACLE(op).pred = NOT_TAKEN;
+        OP_ORACLE(op).pred_npc = pc_plus_offset;
         STAT_EVENT(op->proc_id, CBR_RECOVER_BTB_MISS_NT_T + op->off_path * NUM_BR_STATS);
 	      if (FDIP_BP_CONFIDENCE)
           fdip_inc_cnt_btb_miss(op->proc_id);
       }
       // 4. Branch is predicted not-taken which is correct causing no flush
-      else if (!btb_target && op->oracle_info.pred == NOT_TAKEN && op->oracle_info.dir == NOT_TAKEN) {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = FALSE;
-        op->oracle_info.pred = NOT_TAKEN;
-        op->oracle_info.pred_npc = pc_plus_offset;
+      else if (!btb_target && OP_ORACLE(op).pred == NOT_TAKEN && OP_ORACLE(op).dir == NOT_TAKEN) {
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = FALSE;
+        OP_ORACLE(op).pred = NOT_TAKEN;
+        OP_ORACLE(op).pred_npc = pc_plus_offset;
         STAT_EVENT(op->proc_id, CBR_CORRECT_BTB_MISS_NT_NT + op->off_path * NUM_BR_STATS);
       }
       else {
@@ -607,31 +612,31 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
       break;
 
     case CF_CALL:
-      op->oracle_info.pred      = TAKEN;
-      op->oracle_info.pred_orig = TAKEN;
-      op->oracle_info.late_pred = TAKEN;
+      OP_ORACLE(op).pred      = TAKEN;
+      OP_ORACLE(op).pred_orig = TAKEN;
+      OP_ORACLE(op).late_pred = TAKEN;
       if(ENABLE_CRS)
         CRS_REALISTIC ? bp_crs_realistic_push(bp_data, op) :
                         bp_crs_push(bp_data, op);
       if(!op->off_path)
         STAT_EVENT(op->proc_id, CF_CALL_USED_TARGET_CORRECT +
-                                  (pred_target != op->oracle_info.npc));
+                                  (pred_target != OP_ORACLE(op).npc));
       // On BTB hit, ensure that target is correct (no aliasing or jitted code)
-      if (btb_target && pred_target == op->oracle_info.npc) {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = FALSE;
-        op->oracle_info.pred = TAKEN;
-        op->oracle_info.pred_npc = pred_target;
+      if (btb_target && pred_target == OP_ORACLE(op).npc) {
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = FALSE;
+        OP_ORACLE(op).pred = TAKEN;
+        OP_ORACLE(op).pred_npc = pred_target;
           DEBUG(bp_data->proc_id,
         "no flush BP:  op_num:%s  off_path:%d  cf_type:%s  addr:%s  p_npc:%s  "
         "t_npc:0x%s  btb_miss:%d  mispred:%d  misfetch:%d  no_tar:%d\n",
         unsstr64(op->op_num), op->off_path,
         cf_type_names[op->table_info->cf_type], hexstr64s(op->inst_info->addr),
-        hexstr64s(op->oracle_info.pred_npc), hexstr64s(op->oracle_info.npc),
-        op->oracle_info.btb_miss, op->oracle_info.mispred,
-        op->oracle_info.recover_at_exec,op->oracle_info.recover_at_decode);
+        hexstr64s(OP_ORACLE(op).pred_npc), hexstr64s(OP_ORACLE(op).npc),
+        OP_ORACLE(op).btb_miss, OP_ORACLE(op).mispred,
+        OP_ORACLE(op).recover_at_exec,OP_ORACLE(op).recover_at_decode);
 
-        ASSERT(0, op->oracle_info.pred == op->oracle_info.dir);
+        ASSERT(0, OP_ORACLE(op).pred == OP_ORACLE(op).dir);
         STAT_EVENT(op->proc_id, CALL_CORRECT + op->off_path * NUM_BR_STATS);
       }
       else {
@@ -640,58 +645,58 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
         "t_npc:0x%s  btb_miss:%d  mispred:%d  misfetch:%d  no_tar:%d predtarg %llx npc %llx\n",
         unsstr64(op->op_num), op->off_path,
         cf_type_names[op->table_info->cf_type], hexstr64s(op->inst_info->addr),
-        hexstr64s(op->oracle_info.pred_npc), hexstr64s(op->oracle_info.npc),
-        op->oracle_info.btb_miss, op->oracle_info.mispred,
-                op->oracle_info.recover_at_exec,op->oracle_info.recover_at_decode, pred_target, op->oracle_info.npc);
-
-        op->oracle_info.recover_at_decode = TRUE;
-        op->oracle_info.recover_at_exec = FALSE;
-        op->oracle_info.pred = NOT_TAKEN;
-        op->oracle_info.pred_npc = pc_plus_offset;
+        hexstr64s(OP_ORACLE(op).pred_npc), hexstr64s(OP_ORACLE(op).npc),
+        OP_ORACLE(op).btb_miss, OP_ORACLE(op).mispred,
+                OP_ORACLE(op).recover_at_exec,OP_ORACLE(op).recover_at_decode, pred_target, OP_ORACLE(op).npc);
+
+        OP_ORACLE(op).recover_at_decode = TRUE;
+        OP_ORACLE(op).recover_at_exec = FALSE;
+        OP_ORACLE(op).pred = NOT_TAKEN;
+        OP_ORACLE(op).pred_npc = pc_plus_offset;
         STAT_EVENT(op->proc_id, CALL_RECOVER + op->off_path * NUM_BR_STATS);
       }
       break;
 
     case CF_IBR:
       if(PERFECT_BP) {
-        op->oracle_info.pred      = op->oracle_info.dir;
-        op->oracle_info.pred_orig = op->oracle_info.dir;
-        op->oracle_info.late_pred = op->oracle_info.dir;
+        OP_ORACLE(op).pred      = OP_ORACLE(op).dir;
+        OP_ORACLE(op).pred_orig = OP_ORACLE(op).dir;
+        OP_ORACLE(op).late_pred = OP_ORACLE(op).dir;
       } else {
-        op->oracle_info.pred      = TAKEN;
-        op->oracle_info.pred_orig = TAKEN;
-        op->oracle_info.late_pred = TAKEN;
+        OP_ORACLE(op).pred      = TAKEN;
+        OP_ORACLE(op).pred_orig = TAKEN;
+        OP_ORACLE(op).late_pred = TAKEN;
       }
       if(!op->off_path)
         STAT_EVENT(op->proc_id, CF_IBR_USED_TARGET_CORRECT +
-                   (pred_target != op->oracle_info.npc));
+                   (pred_target != OP_ORACLE(op).npc));
       if (ENABLE_IBP && ibp_target) {
-        ASSERT(op->proc_id, op->oracle_info.target == op->oracle_info.npc);
-        if (op->oracle_info.target == pred_target) {
-          op->oracle_info.recover_at_decode = FALSE;
-          op->oracle_info.recover_at_exec = FALSE;
-          op->oracle_info.pred_npc = pred_target;
+        ASSERT(op->proc_id, OP_ORACLE(op).target == OP_ORACLE(op).npc);
+        if (OP_ORACLE(op).target == pred_target) {
+          OP_ORACLE(op).recover_at_decode = FALSE;
+          OP_ORACLE(op).recover_at_exec = FALSE;
+          OP_ORACLE(op).pred_npc = pred_target;
           STAT_EVENT(op->proc_id, IBR_CORRECT_IBTB + op->off_path * NUM_BR_STATS);
         }
         else {
-          op->oracle_info.recover_at_decode = FALSE;
-          op->oracle_info.recover_at_exec = TRUE;
-          op->oracle_info.pred_npc = pred_target;
+          OP_ORACLE(op).recover_at_decode = FALSE;
+          OP_ORACLE(op).recover_at_exec = TRUE;
+          OP_ORACLE(op).pred_npc = pred_target;
           STAT_EVENT(op->proc_id, IBR_RECOVER_IBTB_MISFETCH + op->off_path * NUM_BR_STATS);
         }
       }
       else if (btb_target) {
-        if (op->oracle_info.target == pred_target) {
-          op->oracle_info.recover_at_decode = FALSE;
-          op->oracle_info.recover_at_exec = FALSE;
-          op->oracle_info.pred_npc = pred_target;
+        if (OP_ORACLE(op).target == pred_target) {
+          OP_ORACLE(op).recover_at_decode = FALSE;
+          OP_ORACLE(op).recover_at_exec = FALSE;
+          OP_ORACLE(op).pred_npc = pred_target;
           STAT_EVENT(op->proc_id, IBR_CORRECT_BTB + op->off_path * NUM_BR_STATS);
         }
         else {
-          op->oracle_info.recover_at_decode = FALSE;
-          op->oracle_info.recover_at_exec = TRUE;
-          op->oracle_info.pred_npc = pred_target;
-          op->oracle_info.misfetch      = TRUE;
+          OP_ORACLE(op).recover_at_decode = FALSE;
+          OP_ORACLE(op).recover_at_exec = TRUE;
+          OP_ORACLE(op).pred_npc = pred_target;
+          OP_ORACLE(op).misfetch      = TRUE;
           STAT_EVENT(op->proc_id, IBR_RECOVER_BTB_MISFETCH + op->off_path * NUM_BR_STATS);
         }
       }
@@ -699,10 +704,10 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
       // until exec to resolve the branch target. We would not know which target to fetch
       // at decode so we can just recover at exec
       else {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = TRUE;
-        op->oracle_info.pred = NOT_TAKEN;
-        op->oracle_info.pred_npc = pc_plus_offset;
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = TRUE;
+        OP_ORACLE(op).pred = NOT_TAKEN;
+        OP_ORACLE(op).pred_npc = pc_plus_offset;
         STAT_EVENT(op->proc_id, IBR_RECOVER_XBTB_MISS + op->off_path * NUM_BR_STATS);
       }
 
@@ -710,48 +715,48 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
 
     case CF_ICALL:
       if(PERFECT_BP) {
-        op->oracle_info.pred      = op->oracle_info.dir;
-        op->oracle_info.pred_orig = op->oracle_info.dir;
-        op->oracle_info.late_pred = op->oracle_info.dir;
+        OP_ORACLE(op).pred      = OP_ORACLE(op).dir;
+        OP_ORACLE(op).pred_orig = OP_ORACLE(op).dir;
+        OP_ORACLE(op).late_pred = OP_ORACLE(op).dir;
       } else {
-        op->oracle_info.pred      = TAKEN;
-        op->oracle_info.pred_orig = TAKEN;
-        op->oracle_info.late_pred = TAKEN;
+        OP_ORACLE(op).pred      = TAKEN;
+        OP_ORACLE(op).pred_orig = TAKEN;
+        OP_ORACLE(op).late_pred = TAKEN;
       }
       if(ENABLE_CRS)
         CRS_REALISTIC ? bp_crs_realistic_push(bp_data, op) :
           bp_crs_push(bp_data, op);
       if(!op->off_path)
         STAT_EVENT(op->proc_id, CF_ICALL_USED_TARGET_CORRECT +
-                   (pred_target != op->oracle_info.npc));
+                   (pred_target != OP_ORACLE(op).npc));
 
       if (ENABLE_IBP && ibp_target) {
-        ASSERT(op->proc_id, op->oracle_info.target == op->oracle_info.npc);
-        if (op->oracle_info.target == pred_target) {
-          op->oracle_info.recover_at_decode = FALSE;
-          op->oracle_info.recover_at_exec = FALSE;
-          op->oracle_info.pred_npc = pred_target;
+        ASSERT(op->proc_id, OP_ORACLE(op).target == OP_ORACLE(op).npc);
+        if (OP_ORACLE(op).target == pred_target) {
+          OP_ORACLE(op).recover_at_decode = FALSE;
+          OP_ORACLE(op).recover_at_exec = FALSE;
+          OP_ORACLE(op).pred_npc = pred_target;
           STAT_EVENT(op->proc_id, ICALL_CORRECT_IBTB + op->off_path * NUM_BR_STATS);
         }
         else {
-          op->oracle_info.recover_at_decode = FALSE;
-          op->oracle_info.recover_at_exec = TRUE;
-          op->oracle_info.pred_npc = pred_target;
-          op->oracle_info.misfetch      = TRUE;
+          OP_ORACLE(op).recover_at_decode = FALSE;
+          OP_ORACLE(op).recover_at_exec = TRUE;
+          OP_ORACLE(op).pred_npc = pred_target;
+          OP_ORACLE(op).misfetch      = TRUE;
           STAT_EVENT(op->proc_id, ICALL_RECOVER_IBTB_MISFETCH + op->off_path * NUM_BR_STATS);
         }
       }
       else if (btb_target) {
-        if (op->oracle_info.target == pred_target) {
-          op->oracle_info.recover_at_decode = FALSE;
-          op->oracle_info.recover_at_exec = FALSE;
-          op->oracle_info.pred_npc = pred_target;
+        if (OP_ORACLE(op).target == pred_target) {
+          OP_ORACLE(op).recover_at_decode = FALSE;
+          OP_ORACLE(op).recover_at_exec = FALSE;
+          OP_ORACLE(op).pred_npc = pred_target;
           STAT_EVENT(op->proc_id, ICALL_CORRECT_BTB + op->off_path * NUM_BR_STATS);
         }
         else {
-          op->oracle_info.recover_at_decode = FALSE;
-          op->oracle_info.recover_at_exec = TRUE;
-          op->oracle_info.pred_npc = pred_target;
+          OP_ORACLE(op).recover_at_decode = FALSE;
+          OP_ORACLE(op).recover_at_exec = TRUE;
+          OP_ORACLE(op).pred_npc = pred_target;
           STAT_EVENT(op->proc_id, ICALL_RECOVER_BTB_MISFETCH + op->off_path * NUM_BR_STATS);
         }
       }
@@ -759,19 +764,19 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
       // until exec to resolve the branch target. We would not know which target to fetch
       // at decode so we can just recover at exec
       else {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = TRUE;
-        op->oracle_info.pred = NOT_TAKEN;
-        op->oracle_info.pred_npc = pc_plus_offset;
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = TRUE;
+        OP_ORACLE(op).pred = NOT_TAKEN;
+        OP_ORACLE(op).pred_npc = pc_plus_offset;
         STAT_EVENT(op->proc_id, ICALL_RECOVER_XBTB_MISS + op->off_path * NUM_BR_STATS);
       }
 
       break;
 
     case CF_ICO:
-      op->oracle_info.pred      = TAKEN;
-      op->oracle_info.pred_orig = TAKEN;
-      op->oracle_info.late_pred = TAKEN;
+      OP_ORACLE(op).pred      = TAKEN;
+      OP_ORACLE(op).pred_orig = TAKEN;
+      OP_ORACLE(op).late_pred = TAKEN;
       if(ENABLE_CRS) {
         pred_target = CRS_REALISTIC ? bp_crs_realistic_pop(bp_data, op) :
                                       bp_crs_pop(bp_data, op);
@@ -779,20 +784,20 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
                         bp_crs_push(bp_data, op);
         if(!op->off_path)
           STAT_EVENT(op->proc_id, CF_ICO_USED_TARGET_CORRECT +
-                                    (pred_target != op->oracle_info.npc));
+                                    (pred_target != OP_ORACLE(op).npc));
       }
 
-      if (pred_target != op->oracle_info.npc) {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = TRUE;
-        op->oracle_info.pred_npc = pred_target;
+      if (pred_target != OP_ORACLE(op).npc) {
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = TRUE;
+        OP_ORACLE(op).pred_npc = pred_target;
         STAT_EVENT(op->proc_id, ICO_RECOVER + op->off_path * NUM_BR_STATS);
       }
       else {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = FALSE;
-        op->oracle_info.pred = NOT_TAKEN;
-        op->oracle_info.pred_npc = pc_plus_offset;
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = FALSE;
+        OP_ORACLE(op).pred = NOT_TAKEN;
+        OP_ORACLE(op).pred_npc = pc_plus_offset;
         STAT_EVENT(op->proc_id, ICO_CORRECT + op->off_path * NUM_BR_STATS);
       }
 
@@ -800,55 +805,55 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
 
     case CF_RET:
       if(PERFECT_BP) {
-        op->oracle_info.pred      = op->oracle_info.dir;
-        op->oracle_info.pred_orig = op->oracle_info.dir;
-        op->oracle_info.late_pred = op->oracle_info.dir;
+        OP_ORACLE(op).pred      = OP_ORACLE(op).dir;
+        OP_ORACLE(op).pred_orig = OP_ORACLE(op).dir;
+        OP_ORACLE(op).late_pred = OP_ORACLE(op).dir;
       } else {
-        op->oracle_info.pred      = TAKEN;
-        op->oracle_info.pred_orig = TAKEN;
-        op->oracle_info.late_pred = TAKEN;
+        OP_ORACLE(op).pred      = TAKEN;
+        OP_ORACLE(op).pred_orig = TAKEN;
+        OP_ORACLE(op).late_pred = TAKEN;
       }
       if(ENABLE_CRS)
         pred_target = CRS_REALISTIC ? bp_crs_realistic_pop(bp_data, op) :
                                       bp_crs_pop(bp_data, op);
       if(!op->off_path)
         STAT_EVENT(op->proc_id, CF_RET_USED_TARGET_CORRECT +
-                                  (pred_target != op->oracle_info.npc));
+                                  (pred_target != OP_ORACLE(op).npc));
       if (pred_target == 0) { //RAS Underflow
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = TRUE;
-        op->oracle_info.pred_npc = pc_plus_offset;
-        op->oracle_info.pred = NOT_TAKEN;
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = TRUE;
+        OP_ORACLE(op).pred_npc = pc_plus_offset;
+        OP_ORACLE(op).pred = NOT_TAKEN;
         STAT_EVENT(op->proc_id, RET_RECOVER_UFLOW + op->off_path * NUM_BR_STATS);
       }
-      else if (pred_target != op->oracle_info.npc) {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = TRUE;
-        op->oracle_info.pred_npc = pred_target;
+      else if (pred_target != OP_ORACLE(op).npc) {
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = TRUE;
+        OP_ORACLE(op).pred_npc = pred_target;
         STAT_EVENT(op->proc_id, RET_RECOVER + op->off_path * NUM_BR_STATS);
       }
       else {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = FALSE;
-        op->oracle_info.pred_npc = pred_target;
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = FALSE;
+        OP_ORACLE(op).pred_npc = pred_target;
         STAT_EVENT(op->proc_id, RET_CORRECT + op->off_path * NUM_BR_STATS);
       }
       break;
 
     default:
       ASSERT(op->proc_id, 0); //should not happen
-      op->oracle_info.pred      = TAKEN;
-      op->oracle_info.pred_orig = TAKEN;
-      op->oracle_info.late_pred = TAKEN;
+      OP_ORACLE(op).pred      = TAKEN;
+      OP_ORACLE(op).pred_orig = TAKEN;
+      OP_ORACLE(op).late_pred = TAKEN;
       if(!op->off_path)
         STAT_EVENT(op->proc_id, CF_DEFAULT_USED_TARGET_CORRECT +
-                                  (pred_target != op->oracle_info.npc));
+                                  (pred_target != OP_ORACLE(op).npc));
       break;
   }
   // }}}
 
   pred_target = convert_to_cmp_addr(op->proc_id, pred_target);
-  if(op->oracle_info.btb_miss && op->oracle_info.pred == NOT_TAKEN)
+  if(OP_ORACLE(op).btb_miss && OP_ORACLE(op).pred == NOT_TAKEN)
     btb_miss_nt = TRUE;
 
   bp_data->bp->spec_update_func(op);
@@ -861,35 +866,35 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
         "t_npc:0x%s  btb_miss:%d  mispred:%d  misfetch:%d  no_tar:%d dir%d pred%d offset %llx target %llx\n",
         unsstr64(op->op_num), op->off_path,
         cf_type_names[op->table_info->cf_type], hexstr64s(op->inst_info->addr),
-        hexstr64s(op->oracle_info.pred_npc), hexstr64s(op->oracle_info.npc),
-        op->oracle_info.btb_miss, op->oracle_info.mispred,
-        op->oracle_info.recover_at_exec,op->oracle_info.recover_at_decode,
-        op->oracle_info.dir , op->oracle_info.pred,
-        pc_plus_offset, op->oracle_info.target);
-
-  ASSERT(op->proc_id, op->oracle_info.pred_npc);
-  if (op->oracle_info.dir != op->oracle_info.pred && pc_plus_offset != op->oracle_info.target) {
-    if (!(op->oracle_info.recover_at_exec || op->oracle_info.recover_at_decode))
-      ASSERT(op->proc_id, op->oracle_info.recover_at_exec || op->oracle_info.recover_at_decode);
+        hexstr64s(OP_ORACLE(op).pred_npc), hexstr64s(OP_ORACLE(op).npc),
+        OP_ORACLE(op).btb_miss, OP_ORACLE(op).mispred,
+        OP_ORACLE(op).recover_at_exec,OP_ORACLE(op).recover_at_decode,
+        OP_ORACLE(op).dir , OP_ORACLE(op).pred,
+        pc_plus_offset, OP_ORACLE(op).target);
+
+  ASSERT(op->proc_id, OP_ORACLE(op).pred_npc);
+  if (OP_ORACLE(op).dir != OP_ORACLE(op).pred && pc_plus_offset != OP_ORACLE(op).target) {
+    if (!(OP_ORACLE(op).recover_at_exec || OP_ORACLE(op).recover_at_decode))
+      ASSERT(op->proc_id, OP_ORACLE(op).recover_at_exec || OP_ORACLE(op).recover_at_decode);
   }
 
-  ASSERT_PROC_ID_IN_ADDR(op->proc_id, op->oracle_info.pred_npc);
-  bp_predict_op_evaluate(bp_data, op, op->oracle_info.pred_npc);
+  ASSERT_PROC_ID_IN_ADDR(op->proc_id, OP_ORACLE(op).pred_npc);
+  bp_predict_op_evaluate(bp_data, op, OP_ORACLE(op).pred_npc);
 
   // The case where BTB-miss not-taken branch pollute global hist
   // mispred || misfetch will trigger a re-steer but no chance to fix the global hist
   if(btb_miss_nt &&
-      (((op->oracle_info.pred != op->oracle_info.dir) && (op->oracle_info.pred_npc != op->oracle_info.npc)) ||
-      (!op->oracle_info.mispred && op->oracle_info.pred_npc != op->oracle_info.npc)))
+      (((OP_ORACLE(op).pred != OP_ORACLE(op).dir) && (OP_ORACLE(op).pred_npc != OP_ORACLE(op).npc)) ||
+      (!OP_ORACLE(op).mispred && OP_ORACLE(op).pred_npc != OP_ORACLE(op).npc)))
     STAT_EVENT(op->proc_id, FDIP_BTB_MISS_NT_RESTEER_ONPATH + op->off_path);
 
   if (!op->off_path) {
-    if (op->oracle_info.recover_at_exec)
-      STAT_EVENT(0, BP_EXEC_RECOVERIES);
-    else if (op->oracle_info.recover_at_decode)
-      STAT_EVENT(0, BP_DECODE_RECOVERIES);
+    if (OP_ORACLE(op).recover_at_exec)
+      SHARED_STAT_EVENT(0, BP_EXEC_RECOVERIES);
+    else if (OP_ORACLE(op).recover_at_decode)
+      SHARED_STAT_EVENT(0, BP_DECODE_RECOVERIES);
   }
-  return op->oracle_info.pred_npc;
+  return OP_ORACLE(op).pred_npc;
 }
 
 /* Separate performing branch prediction from evaluating the prediction into
@@ -898,24 +903,24 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
 Addr bp_predict_op_evaluate(Bp_Data* bp_data, Op *op, Addr prediction) {
   // If the direction prediction is wrong, but next address happens to be right
   // anyway, do not treat this as a misprediction.
-  op->oracle_info.mispred = (op->oracle_info.pred != op->oracle_info.dir) &&
-                            (prediction != op->oracle_info.npc);
-  op->oracle_info.misfetch = !op->oracle_info.mispred &&
-                             prediction != op->oracle_info.npc;
+  OP_ORACLE(op).mispred = (OP_ORACLE(op).pred != OP_ORACLE(op).dir) &&
+                            (prediction != OP_ORACLE(op).npc);
+  OP_ORACLE(op).misfetch = !OP_ORACLE(op).mispred &&
+                             prediction != OP_ORACLE(op).npc;
 
   if(USE_LATE_BP) {
-    const Addr late_prediction = op->oracle_info.late_pred_npc;
-    op->oracle_info.late_mispred  = (op->oracle_info.late_pred !=
-                                    op->oracle_info.dir) &&
-                                   (late_prediction != op->oracle_info.npc);
-    op->oracle_info.late_misfetch = !op->oracle_info.late_mispred &&
-                                    late_prediction != op->oracle_info.npc;
+    const Addr late_prediction = OP_ORACLE(op).late_pred_npc;
+    OP_ORACLE(op).late_mispred  = (OP_ORACLE(op).late_pred !=
+                                    OP_ORACLE(op).dir) &&
+                                   (late_prediction != OP_ORACLE(op).npc);
+    OP_ORACLE(op).late_misfetch = !OP_ORACLE(op).late_mispred &&
+                                    late_prediction != OP_ORACLE(op).npc;
   }
 
   op->bp_cycle = cycle_count;
 
   // {{{ stats and debugging
-  if(!op->oracle_info.btb_miss) {
+  if(!OP_ORACLE(op).btb_miss) {
     if(!op->off_path)
       STAT_EVENT(op->proc_id, BTB_ON_PATH_HIT);
     else
@@ -927,33 +932,33 @@ Addr bp_predict_op_evaluate(Bp_Data* bp_data, Op *op, Addr prediction) {
       STAT_EVENT(op->proc_id, BTB_OFF_PATH_MISS);
   }
 
-  STAT_EVENT(op->proc_id, BP_ON_PATH_CORRECT + op->oracle_info.mispred +
-                            2 * op->oracle_info.misfetch + 3 * op->off_path);
+  STAT_EVENT(op->proc_id, BP_ON_PATH_CORRECT + OP_ORACLE(op).mispred +
+                            2 * OP_ORACLE(op).misfetch + 3 * op->off_path);
   STAT_EVENT(op->proc_id,
-             LATE_BP_ON_PATH_CORRECT + op->oracle_info.late_mispred +
-               2 * op->oracle_info.late_misfetch + 3 * op->off_path);
+             LATE_BP_ON_PATH_CORRECT + OP_ORACLE(op).late_mispred +
+               2 * OP_ORACLE(op).late_misfetch + 3 * op->off_path);
 
   if(!op->off_path) {
-    if(op->oracle_info.mispred)
+    if(OP_ORACLE(op).mispred)
       td->td_info.mispred_counter++;
     else
       td->td_info.corrpred_counter++;
   }
 
   if(op->table_info->cf_type == CF_CBR) {
-    STAT_EVENT(op->proc_id, CBR_ON_PATH_CORRECT + op->oracle_info.mispred +
+    STAT_EVENT(op->proc_id, CBR_ON_PATH_CORRECT + OP_ORACLE(op).mispred +
                               2 * op->off_path);
     if(!op->off_path) {
       STAT_EVENT(op->proc_id,
-                 CBR_ON_PATH_CORRECT_PER1000INST + op->oracle_info.mispred);
-      if(op->oracle_info.mispred)
+                 CBR_ON_PATH_CORRECT_PER1000INST + OP_ORACLE(op).mispred);
+      if(OP_ORACLE(op).mispred)
         _DEBUGA(op->proc_id, 0, "ON PATH HW MISPRED  addr:0x%s  pghist:0x%s\n",
                 hexstr64s(op->inst_info->addr),
-                hexstr64s(op->oracle_info.pred_global_hist));
+                hexstr64s(OP_ORACLE(op).pred_global_hist));
       else
         _DEBUGA(op->proc_id, 0, "ON PATH HW CORRECT  addr:0x%s  pghist:0x%s\n",
                 hexstr64s(op->inst_info->addr),
-                hexstr64s(op->oracle_info.pred_global_hist));
+                hexstr64s(OP_ORACLE(op).pred_global_hist));
     }
   }
   // }}}
@@ -962,40 +967,40 @@ Addr bp_predict_op_evaluate(Bp_Data* bp_data, Op *op, Addr prediction) {
     bp_data->proc_id,
     "BTB:  op_num:%s  off_path:%d  cf_type:%s  addr:0x%s  btb_miss:%d\n",
     unsstr64(op->op_num), op->off_path, cf_type_names[op->table_info->cf_type],
-    hexstr64s(op->inst_info->addr), op->oracle_info.btb_miss);
+    hexstr64s(op->inst_info->addr), OP_ORACLE(op).btb_miss);
 
   DEBUG(bp_data->proc_id,
         "BP:  op_num:%s  off_path:%d  cf_type:%s  addr:%s  p_npc:%s  "
         "t_npc:0x%s  btb_miss:%d  mispred:%d  misfetch:%d  no_tar:%d\n",
         unsstr64(op->op_num), op->off_path,
         cf_type_names[op->table_info->cf_type], hexstr64s(op->inst_info->addr),
-        hexstr64s(prediction), hexstr64s(op->oracle_info.npc),
-        op->oracle_info.btb_miss, op->oracle_info.mispred,
-        op->oracle_info.misfetch, op->oracle_info.no_target);
+        hexstr64s(prediction), hexstr64s(OP_ORACLE(op).npc),
+        OP_ORACLE(op).btb_miss, OP_ORACLE(op).mispred,
+        OP_ORACLE(op).misfetch, OP_ORACLE(op).no_target);
 
   if(ENABLE_BP_CONF && IS_CONF_CF(op)) {
     bp_data->br_conf->pred_func(op);
 
     if(!op->off_path) {
-      if(op->oracle_info.pred_conf) {
-        if(!op->oracle_info.mispred)
+      if(OP_ORACLE(op).pred_conf) {
+        if(!OP_ORACLE(op).mispred)
           STAT_EVENT(op->proc_id, BP_ON_PATH_CONF_PVP);
         else
           STAT_EVENT(op->proc_id, BP_ON_PATH_CONF_PVP_BOT);
       } else {
-        if(op->oracle_info.mispred)
+        if(OP_ORACLE(op).mispred)
           STAT_EVENT(op->proc_id, BP_ON_PATH_CONF_PVN);
         else
           STAT_EVENT(op->proc_id, BP_ON_PATH_CONF_PVN_BOT);
       }
-      if(op->oracle_info.mispred) {
-        if(!op->oracle_info.pred_conf)
+      if(OP_ORACLE(op).mispred) {
+        if(!OP_ORACLE(op).pred_conf)
           STAT_EVENT(op->proc_id, BP_ON_PATH_CONF_SPEC);
         else
           STAT_EVENT(op->proc_id, BP_ON_PATH_CONF_SPEC_BOT);
       }
     }
-    if(!(op->oracle_info.pred_conf))
+    if(!(OP_ORACLE(op).pred_conf))
       td->td_info.low_conf_count++;
     DEBUG(bp_data->proc_id, "low_conf_count:%d \n", td->td_info.low_conf_count);
   }
@@ -1013,18 +1018,18 @@ void bp_target_known_op(Bp_Data* bp_data, Op* op) {
   ASSERT(bp_data->proc_id, op->table_info->cf_type);
 
   // if it was a btb miss, it is time to write it into the btb
-  if(op->oracle_info.btb_miss && op->oracle_info.dir == TAKEN) {
+  if(OP_ORACLE(op).btb_miss && OP_ORACLE(op).dir == TAKEN) {
     bp_data->bp_btb->update_func(bp_data, op);
     STAT_EVENT(bp_data->proc_id, BTB_UPDATE_BTB_MISS);
-  } else if (op->oracle_info.btb_miss == FALSE && op->oracle_info.dir == TAKEN) {
+  } else if (OP_ORACLE(op).btb_miss == FALSE && OP_ORACLE(op).dir == TAKEN) {
     // For jitted CF we want to update the BTB if the target changes, even on btb hit
     // or For indirects we want to update the BTB if the target changes, even on btb hit
     // The detection relies on the target stored in the btb
     Addr line_addr;
-    Addr * btb_entry = (Addr*)cache_access(&bp_data->btb, op->oracle_info.pred_addr, &line_addr, FALSE);
+    Addr * btb_entry = (Addr*)line_cache_access(bp_data->btb, OP_ORACLE(op).pred_addr, &line_addr, FALSE);
     // The following assertion can fail (due to eviction?)
     // ASSERT(bp_data->proc_id, btb_entry);
-    if (btb_entry && *btb_entry != op->oracle_info.target) {
+    if (btb_entry && *btb_entry != OP_ORACLE(op).target) {
       bp_data->bp_btb->update_func(bp_data, op);
       STAT_EVENT(bp_data->proc_id, BTB_UPDATE_BTB_HIT_JITTED_NOT_CF + op->table_info->cf_type);
     }
@@ -1061,7 +1066,7 @@ void bp_resolve_op(Bp_Data* bp_data, Op* op) {
   if(ENABLE_BP_CONF && IS_CONF_CF(op)) {
     bp_data->br_conf->update_func(op);
   }
-  if(op->oracle_info.misfetch || op->oracle_info.mispred) {
+  if(OP_ORACLE(op).misfetch || OP_ORACLE(op).mispred) {
     INC_STAT_EVENT(op->proc_id, BP_MISP_PENALTY,
                    op->exec_cycle - op->issue_cycle);
   }
@@ -1090,8 +1095,8 @@ void bp_retire_op(Bp_Data* bp_data, Op* op) {
  */
 
 void bp_recover_op(Bp_Data* bp_data, Cf_Type cf_type, Recovery_Info* info) {
-  STAT_EVENT(0, PERFORMED_EXEC_RECOVERIES);
-  INC_STAT_EVENT(0, PERFORMED_RECOVERY_LAT, cycle_count - info->predict_cycle);
+  SHARED_STAT_EVENT(0, PERFORMED_EXEC_RECOVERIES);
+  SHARED_INC_STAT_EVENT(0, PERFORMED_RECOVERY_LAT, cycle_count - info->predict_cycle);
   /* always recover the global history */
   if(cf_type == CF_CBR) {
     bp_data->global_hist = (info->pred_global_hist >> 1) |
@@ -29,7 +29,9 @@
 #ifndef __BP_H__
 #define __BP_H__
 
+#include "globals/global_defs.h"
 #include "globals/global_types.h"
+#include "libs/cache_engine_c.h"
 #include "libs/cache_lib.h"
 #include "libs/hash_lib.h"
 #include "op.h"
@@ -140,7 +142,7 @@ typedef struct Bp_Data_struct {
   struct Br_Conf_struct* br_conf;
 
   uns32 global_hist;
-  Cache btb;
+  Line_Cache* btb;
 
   struct {
     Crs_Entry* entries;
@@ -219,6 +221,8 @@ typedef struct Bp_struct {
   void (*recover_func)(Recovery_Info*); /* called to recover the bp when a
                                            misprediction is realized */
   uns8 (*full_func)(uns);
+  void (*checkpoint_func)(uns); /* called to save or load the tables of a core
+                                   (see checkpoint.h), NULL if unsupported */
 } Bp;
 
 typedef struct Bp_Btb_struct {
@@ -263,8 +267,8 @@ typedef struct Br_Conf_struct {
 extern Bp                bp_table[];
 extern Bp_Btb            bp_btb_table[];
 extern Bp_Ibtb           bp_ibtb_table[];
-extern Bp_Data*          g_bp_data;
-extern Bp_Recovery_Info* bp_recovery_info;
+extern SIM_THREAD_LOCAL Bp_Data*          g_bp_data;
+extern SIM_THREAD_LOCAL Bp_Recovery_Info* bp_recovery_info;
 extern Br_Conf           br_conf_table[];
 
 /**************************************************************************************/
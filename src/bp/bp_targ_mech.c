@@ -110,16 +110,16 @@ Addr bp_crs_pop(Bp_Data* bp_data, Op* op) {
     DEBUG_CRS(bp_data->proc_id, "UNDERFLOW  head:%d  tail:%d  offpath:%d\n",
               bp_data->crs.head, bp_data->crs.tail, op->off_path);
     STAT_EVENT(op->proc_id, CRS_MISS_ON_PATH + PERFECT_CRS + 2 * op->off_path);
-    return PERFECT_CRS ? op->oracle_info.target :
+    return PERFECT_CRS ? OP_ORACLE(op).target :
                          convert_to_cmp_addr(bp_data->proc_id, 0);
   }
   bp_data->crs.tail = new_tail;
   bp_data->crs.depth--;
   ASSERT(bp_data->proc_id, bp_data->crs.depth >= 0);
   if(!op->off_path) {
-    if(addr != op->oracle_info.npc)
+    if(addr != OP_ORACLE(op).npc)
       DEBUG_CRS(bp_data->proc_id, "MISS       addr:0x%s  true:0x%s\n",
-                hexstr64s(addr), hexstr64s(op->oracle_info.npc));
+                hexstr64s(addr), hexstr64s(OP_ORACLE(op).npc));
     bp_data->crs.tail_save  = bp_data->crs.tail;
     bp_data->crs.depth_save = bp_data->crs.depth;
   }
@@ -131,10 +131,10 @@ Addr bp_crs_pop(Bp_Data* bp_data, Op* op) {
     bp_data->crs.head, bp_data->crs.tail, bp_data->crs.depth,
     unsstr64(bp_data->crs.entries[bp_data->crs.tail << 1 | flag].op_num),
     hexstr64s(addr), cf_type_names[op->table_info->cf_type], op->off_path,
-    hexstr64s(op->oracle_info.npc), addr != op->oracle_info.npc);
-  mispred = PERFECT_CRS ? 0 : addr != op->oracle_info.npc;
+    hexstr64s(OP_ORACLE(op).npc), addr != OP_ORACLE(op).npc);
+  mispred = PERFECT_CRS ? 0 : addr != OP_ORACLE(op).npc;
   STAT_EVENT(op->proc_id, CRS_MISS_ON_PATH + !mispred + 2 * op->off_path);
-  return PERFECT_CRS ? op->oracle_info.target : addr;
+  return PERFECT_CRS ? OP_ORACLE(op).target : addr;
 }
 
 
@@ -222,7 +222,7 @@ Addr bp_crs_realistic_pop(Bp_Data* bp_data, Op* op) {
     DEBUG_CRS(bp_data->proc_id, "UNDERFLOW  next:%d  tos: %d  offpath:%d\n",
               bp_data->crs.next, bp_data->crs.tos, op->off_path);
     STAT_EVENT(op->proc_id, CRS_MISS_ON_PATH + PERFECT_CRS + 2 * op->off_path);
-    return PERFECT_CRS ? op->oracle_info.target :
+    return PERFECT_CRS ? OP_ORACLE(op).target :
                          convert_to_cmp_addr(bp_data->proc_id, 0);
   }
 
@@ -232,9 +232,9 @@ Addr bp_crs_realistic_pop(Bp_Data* bp_data, Op* op) {
   ASSERT(bp_data->proc_id, bp_data->crs.depth >= 0);
   bp_data->crs.tos = new_tos;
 
-  if(addr != op->oracle_info.npc)
+  if(addr != OP_ORACLE(op).npc)
     DEBUG_CRS(bp_data->proc_id, "MISS       addr:0x%s  true:0x%s\n",
-              hexstr64s(addr), hexstr64s(op->oracle_info.npc));
+              hexstr64s(addr), hexstr64s(OP_ORACLE(op).npc));
 
   op->recovery_info.crs_next  = bp_data->crs.next;
   op->recovery_info.crs_tos   = bp_data->crs.tos;
@@ -246,10 +246,10 @@ Addr bp_crs_realistic_pop(Bp_Data* bp_data, Op* op) {
             bp_data->crs.next, bp_data->crs.tos, bp_data->crs.depth, old_tos,
             unsstr64(bp_data->crs.entries[old_tos].op_num), hexstr64s(addr),
             cf_type_names[op->table_info->cf_type], op->off_path,
-            hexstr64s(op->oracle_info.npc), addr != op->oracle_info.npc);
-  mispred = PERFECT_CRS ? 0 : addr != op->oracle_info.npc;
+            hexstr64s(OP_ORACLE(op).npc), addr != OP_ORACLE(op).npc);
+  mispred = PERFECT_CRS ? 0 : addr != OP_ORACLE(op).npc;
   STAT_EVENT(op->proc_id, CRS_MISS_ON_PATH + !mispred + 2 * op->off_path);
-  return PERFECT_CRS ? op->oracle_info.target : addr;
+  return PERFECT_CRS ? OP_ORACLE(op).target : addr;
 }
 
 
@@ -270,8 +270,8 @@ void bp_crs_realistic_recover(Bp_Data* bp_data, Recovery_Info* info) {
 
 void bp_btb_gen_init(Bp_Data* bp_data) {
   // btb line size set to 1
-  init_cache(&bp_data->btb, "BTB", BTB_ENTRIES, BTB_ASSOC, 1, sizeof(Addr),
-             REPL_TRUE_LRU);
+  bp_data->btb = line_cache_create("BTB", BTB_ENTRIES, BTB_ASSOC, 1,
+                                   sizeof(Addr), REPL_TRUE_LRU);
 }
 
 
@@ -282,9 +282,9 @@ Addr* bp_btb_gen_pred(Bp_Data* bp_data, Op* op) {
   Addr line_addr;
 
   return PERFECT_BTB ?
-           &op->oracle_info.target :
-           (Addr*)cache_access(&bp_data->btb, op->oracle_info.pred_addr,
-                               &line_addr, TRUE);
+           &OP_ORACLE(op).target :
+           (Addr*)line_cache_access(bp_data->btb, OP_ORACLE(op).pred_addr,
+                                    &line_addr, TRUE);
 }
 
 
@@ -292,22 +292,23 @@ Addr* bp_btb_gen_pred(Bp_Data* bp_data, Op* op) {
 /* bp_btb_gen_update: */
 
 void bp_btb_gen_update(Bp_Data* bp_data, Op* op) {
-  Addr  fetch_addr = op->oracle_info.pred_addr;
+  Addr  fetch_addr = OP_ORACLE(op).pred_addr;
   Addr *btb_line, btb_line_addr, repl_line_addr;
 
   ASSERT(bp_data->proc_id, bp_data->proc_id == op->proc_id);
   if(BTB_OFF_PATH_WRITES || !op->off_path) {
     DEBUG_BTB(bp_data->proc_id, "Writing BTB  addr:0x%s  target:0x%s\n",
-              hexstr64s(fetch_addr), hexstr64s(op->oracle_info.target));
+              hexstr64s(fetch_addr), hexstr64s(OP_ORACLE(op).target));
     STAT_EVENT(op->proc_id, BTB_ON_PATH_WRITE + op->off_path);
 
-    btb_line = (Addr*)cache_access(&bp_data->btb, fetch_addr, &btb_line_addr,
-                                   TRUE);
+    btb_line = (Addr*)line_cache_access(bp_data->btb, fetch_addr,
+                                        &btb_line_addr, TRUE);
     if (!btb_line) {
-      btb_line  = (Addr*)cache_insert(&bp_data->btb, bp_data->proc_id, fetch_addr,
-                                      &btb_line_addr, &repl_line_addr);
+      btb_line  = (Addr*)line_cache_insert(bp_data->btb, bp_data->proc_id,
+                                           fetch_addr, &btb_line_addr,
+                                           &repl_line_addr);
     }
-    *btb_line = op->oracle_info.target;
+    *btb_line = OP_ORACLE(op).target;
     // FIXME: the exceptions to this assert are really about x86 vs Alpha
     ASSERT(bp_data->proc_id, (fetch_addr == btb_line_addr) || TRUE);
   }
@@ -336,28 +337,28 @@ Addr bp_ibtb_tc_tagged_pred(Bp_Data* bp_data, Op* op) {
   Addr  target;
 
   if(PERFECT_IBP)
-    return op->oracle_info.target;
+    return OP_ORACLE(op).target;
 
   /* branch history can be updated in one of two ways */
   /* 1. branch history (USE_PAT_HIST) */
   /* 2. path history */
   if(USE_PAT_HIST) {
-    addr               = op->oracle_info.pred_addr;
+    addr               = OP_ORACLE(op).pred_addr;
     bp_data->targ_hist = bp_data->global_hist; /* use global history from
                                                   conditional branches */
-    hist                           = bp_data->targ_hist;
-    op->oracle_info.pred_targ_hist = bp_data->targ_hist;
-    op->recovery_info.targ_hist    = bp_data->targ_hist;
+    hist                         = bp_data->targ_hist;
+    OP_ORACLE(op).pred_targ_hist = bp_data->targ_hist;
+    op->recovery_info.targ_hist  = bp_data->targ_hist;
   } else {
-    addr                           = op->oracle_info.pred_addr;
-    hist                           = bp_data->targ_hist;
-    op->oracle_info.pred_targ_hist = bp_data->targ_hist;
+    addr                         = OP_ORACLE(op).pred_addr;
+    hist                         = bp_data->targ_hist;
+    OP_ORACLE(op).pred_targ_hist = bp_data->targ_hist;
     bp_data->targ_hist >>= bp_data->target_bit_length;
     op->recovery_info.targ_hist = bp_data->targ_hist |
-                                  (op->oracle_info.target >> 2 &
+                                  (OP_ORACLE(op).target >> 2 &
                                    N_BIT_MASK(bp_data->target_bit_length)
                                      << (32 - bp_data->target_bit_length));
-    bp_data->targ_hist |= op->oracle_info.target >> 2 &
+    bp_data->targ_hist |= OP_ORACLE(op).target >> 2 &
                           N_BIT_MASK(bp_data->target_bit_length)
                             << (32 - bp_data->target_bit_length);
   }
@@ -374,10 +375,10 @@ Addr bp_ibtb_tc_tagged_pred(Bp_Data* bp_data, Op* op) {
 
   if(!op->off_path)
     STAT_EVENT(op->proc_id,
-               TARG_ON_PATH_MISS + (target == op->oracle_info.npc));
+               TARG_ON_PATH_MISS + (target == OP_ORACLE(op).npc));
   else
     STAT_EVENT(op->proc_id,
-               TARG_OFF_PATH_MISS + (target == op->oracle_info.npc));
+               TARG_OFF_PATH_MISS + (target == OP_ORACLE(op).npc));
 
   return target;
 }
@@ -387,8 +388,8 @@ Addr bp_ibtb_tc_tagged_pred(Bp_Data* bp_data, Op* op) {
 /* bp_tc_tagged_update: */
 
 void bp_ibtb_tc_tagged_update(Bp_Data* bp_data, Op* op) {
-  Addr  addr     = op->oracle_info.pred_addr;
-  uns32 hist     = op->oracle_info.pred_targ_hist;
+  Addr  addr     = OP_ORACLE(op).pred_addr;
+  uns32 hist     = OP_ORACLE(op).pred_targ_hist;
   uns32 tc_index = hist ^ addr;
   Addr* tc_line;
   Addr  tc_line_addr;
@@ -401,13 +402,13 @@ void bp_ibtb_tc_tagged_update(Bp_Data* bp_data, Op* op) {
         unsstr64(op->op_num));
   tc_line = (Addr*)cache_access(&bp_data->tc_tagged, tc_index, &tc_line_addr, TRUE);
   if (tc_line) {
-    // ASSERT(bp_data->proc_id, !op->oracle_info.ibp_miss);
+    // ASSERT(bp_data->proc_id, !OP_ORACLE(op).ibp_miss);
   } else {
-    // ASSERT(bp_data->proc_id, op->oracle_info.ibp_miss);
+    // ASSERT(bp_data->proc_id, OP_ORACLE(op).ibp_miss);
     tc_line = (Addr*)cache_insert(&bp_data->tc_tagged, bp_data->proc_id, tc_index,
                                   &tc_line_addr, &repl_line_addr);
   }
-  *tc_line = op->oracle_info.target;
+  *tc_line = OP_ORACLE(op).target;
 
   STAT_EVENT(op->proc_id, TARG_ON_PATH_WRITE + op->off_path);
 }
@@ -450,28 +451,28 @@ Addr bp_ibtb_tc_tagless_pred(Bp_Data* bp_data, Op* op) {
   Addr  tc_entry;
 
   if(PERFECT_IBP)
-    return op->oracle_info.target;
+    return OP_ORACLE(op).target;
 
   /* branch history can be updated in one of two ways */
   /* 1. branch history (USE_PAT_HIST) */
   /* 2. path history */
   if(USE_PAT_HIST) {
-    addr               = op->oracle_info.pred_addr;
+    addr               = OP_ORACLE(op).pred_addr;
     bp_data->targ_hist = bp_data->global_hist; /* use global history from
                                                   conditional branches */
-    hist                           = bp_data->targ_hist;
-    op->oracle_info.pred_targ_hist = bp_data->targ_hist;
-    op->recovery_info.targ_hist    = bp_data->targ_hist;
+    hist                         = bp_data->targ_hist;
+    OP_ORACLE(op).pred_targ_hist = bp_data->targ_hist;
+    op->recovery_info.targ_hist  = bp_data->targ_hist;
   } else {
-    addr                           = op->oracle_info.pred_addr;
-    hist                           = bp_data->targ_hist;
-    op->oracle_info.pred_targ_hist = bp_data->targ_hist;
+    addr                         = OP_ORACLE(op).pred_addr;
+    hist                         = bp_data->targ_hist;
+    OP_ORACLE(op).pred_targ_hist = bp_data->targ_hist;
     bp_data->targ_hist >>= bp_data->target_bit_length;
     op->recovery_info.targ_hist = bp_data->targ_hist |
-                                  (op->oracle_info.target >> 2 &
+                                  (OP_ORACLE(op).target >> 2 &
                                    N_BIT_MASK(bp_data->target_bit_length)
                                      << (32 - bp_data->target_bit_length));
-    bp_data->targ_hist |= op->oracle_info.target >> 2 &
+    bp_data->targ_hist |= OP_ORACLE(op).target >> 2 &
                           N_BIT_MASK(bp_data->target_bit_length)
                             << (32 - bp_data->target_bit_length);
   }
@@ -489,10 +490,10 @@ Addr bp_ibtb_tc_tagless_pred(Bp_Data* bp_data, Op* op) {
 
   if(!op->off_path)
     STAT_EVENT(op->proc_id,
-               TARG_ON_PATH_MISS + (tc_entry == op->oracle_info.npc));
+               TARG_ON_PATH_MISS + (tc_entry == OP_ORACLE(op).npc));
   else
     STAT_EVENT(op->proc_id,
-               TARG_OFF_PATH_MISS + (tc_entry == op->oracle_info.npc));
+               TARG_OFF_PATH_MISS + (tc_entry == OP_ORACLE(op).npc));
 
   return tc_entry;
 }
@@ -502,8 +503,8 @@ Addr bp_ibtb_tc_tagless_pred(Bp_Data* bp_data, Op* op) {
 /* bp_tc_tagless_update */
 
 void bp_ibtb_tc_tagless_update(Bp_Data* bp_data, Op* op) {
-  Addr  addr        = op->oracle_info.pred_addr;
-  uns32 hist        = op->oracle_info.pred_targ_hist;
+  Addr  addr        = OP_ORACLE(op).pred_addr;
+  uns32 hist        = OP_ORACLE(op).pred_targ_hist;
   uns32 cooked_hist = COOK_HIST_BITS(hist, 0);
   uns32 cooked_addr = COOK_ADDR_BITS(addr, 2);
   uns32 tc_index    = cooked_hist ^ cooked_addr;
@@ -516,7 +517,7 @@ void bp_ibtb_tc_tagless_update(Bp_Data* bp_data, Op* op) {
 
   DEBUG(bp_data->proc_id, "Writing target cache target for op_num:%s\n",
         unsstr64(op->op_num));
-  bp_data->tc_tagless[tc_index] = op->oracle_info.target;
+  bp_data->tc_tagless[tc_index] = OP_ORACLE(op).target;
 
   STAT_EVENT(op->proc_id, TARG_ON_PATH_WRITE + op->off_path);
 }
@@ -567,7 +568,7 @@ void bp_ibtb_tc_hybrid_init(Bp_Data* bp_data) {
 
 Addr bp_ibtb_tc_hybrid_pred(Bp_Data* bp_data, Op* op) {
   Addr  target;
-  Addr  addr        = op->oracle_info.pred_addr;
+  Addr  addr        = OP_ORACLE(op).pred_addr;
   uns32 hist        = bp_data->global_hist;
   uns32 cooked_hist = COOK_HIST_BITS(hist, 0);
   uns32 cooked_addr = COOK_ADDR_BITS(addr, 2);
@@ -591,8 +592,8 @@ Addr bp_ibtb_tc_hybrid_pred(Bp_Data* bp_data, Op* op) {
     target = bp_ibtb_tc_tagless_pred(bp_data, op);
   }
 
-  op->oracle_info.pred_global_hist       = bp_data->global_hist;
-  op->oracle_info.pred_tc_selector_entry = sel_entry;
+  OP_ORACLE(op).pred_global_hist       = bp_data->global_hist;
+  OP_ORACLE(op).pred_tc_selector_entry = sel_entry;
 
   return target;
 }
@@ -602,13 +603,13 @@ Addr bp_ibtb_tc_hybrid_pred(Bp_Data* bp_data, Op* op) {
 /* bp_tc_hybrid_update: */
 
 void bp_ibtb_tc_hybrid_update(Bp_Data* bp_data, Op* op) {
-  Addr  addr             = op->oracle_info.pred_addr;
-  uns32 hist             = op->oracle_info.pred_global_hist;
+  Addr  addr             = OP_ORACLE(op).pred_addr;
+  uns32 hist             = OP_ORACLE(op).pred_global_hist;
   uns32 cooked_hist      = COOK_HIST_BITS(hist, 0);
   uns32 cooked_addr      = COOK_ADDR_BITS(addr, 2);
   uns32 sel_index        = cooked_hist ^ cooked_addr;
   uns8  sel_entry        = bp_data->tc_selector[sel_index];
-  Flag  predicted_tagged = op->oracle_info.pred_tc_selector_entry >=
+  Flag  predicted_tagged = OP_ORACLE(op).pred_tc_selector_entry >=
                           TC_SELECTOR_TAGGED_WEAK;
 
   ASSERT(bp_data->proc_id, bp_data->proc_id == op->proc_id);
@@ -620,16 +621,16 @@ void bp_ibtb_tc_hybrid_update(Bp_Data* bp_data, Op* op) {
     sel_entry       = bp_data->tc_selector[sel_index];
   }
 
-  ASSERT(bp_data->proc_id, !op->oracle_info.mispred);
+  ASSERT(bp_data->proc_id, !OP_ORACLE(op).mispred);
 
-  if(op->oracle_info.no_target) {  // branch was not predicted at all
+  if(OP_ORACLE(op).no_target) {  // branch was not predicted at all
     // Update both predictors
     // No change to selector
     bp_ibtb_tc_tagged_update(bp_data, op);
     bp_ibtb_tc_tagless_update(bp_data, op);
     if(!op->off_path)
       STAT_EVENT(op->proc_id, TARG_HYBRID_NO_PRED);
-  } else if(op->oracle_info.misfetch) {
+  } else if(OP_ORACLE(op).misfetch) {
     // Update the predictor that made the prediction
     // Change the selector so that it does not use this predictor again
     if(predicted_tagged) {  // predicted by tagged predictor
@@ -48,7 +48,7 @@ class CBP_To_Scarab_Intf {
   uns8 pred(Op* op) {
     uns proc_id = op->proc_id;
     if(op->off_path)
-      return op->oracle_info.dir;
+      return OP_ORACLE(op).dir;
     return cbp_predictors.at(proc_id).GetPrediction(op->inst_info->addr, &op->bp_confidence);
   }
 
@@ -62,12 +62,12 @@ class CBP_To_Scarab_Intf {
 
     if(is_conditional_branch(op)) {
       cbp_predictors.at(proc_id).UpdatePredictor(
-        op->inst_info->addr, optype, op->oracle_info.dir, op->oracle_info.pred,
-        op->oracle_info.target);
+        op->inst_info->addr, optype, OP_ORACLE(op).dir, OP_ORACLE(op).pred,
+        OP_ORACLE(op).target);
     } else {
       cbp_predictors.at(proc_id).TrackOtherInst(op->inst_info->addr, optype,
-                                                op->oracle_info.dir,
-                                                op->oracle_info.target);
+                                                OP_ORACLE(op).dir,
+                                                OP_ORACLE(op).target);
     }
   }
 
@@ -25,6 +25,7 @@
 
 extern "C" {
 #include "bp/bp.param.h"
+#include "checkpoint.h"
 #include "core.param.h"
 #include "globals/assert.h"
 #include "statistics.h"
@@ -68,8 +69,8 @@ uns8 bp_gshare_pred(Op* op) {
   const uns   proc_id      = op->proc_id;
   const auto& gshare_state = gshare_state_all_cores.at(proc_id);
 
-  const Addr  addr      = op->oracle_info.pred_addr;
-  const uns32 hist      = op->oracle_info.pred_global_hist;
+  const Addr  addr      = OP_ORACLE(op).pred_addr;
+  const uns32 hist      = OP_ORACLE(op).pred_global_hist;
   const uns32 pht_index = get_pht_index(addr, hist);
   const uns8  pht_entry = gshare_state.pht[pht_index];
   const uns8  pred      = pht_entry >> (PHT_CTR_BITS - 1) & 0x1;
@@ -77,7 +78,7 @@ uns8 bp_gshare_pred(Op* op) {
   DEBUG(proc_id, "Predicting with gshare for  op_num:%s  index:%d\n",
         unsstr64(op->op_num), pht_index);
   DEBUG(proc_id, "Predicting  addr:%s  pht:%u  pred:%d  dir:%d\n",
-        hexstr64s(addr), pht_index, pred, op->oracle_info.dir);
+        hexstr64s(addr), pht_index, pred, OP_ORACLE(op).dir);
 
   return pred;
 }
@@ -90,20 +91,27 @@ void bp_gshare_update(Op* op) {
 
   const uns   proc_id      = op->proc_id;
   auto&       gshare_state = gshare_state_all_cores.at(proc_id);
-  const Addr  addr         = op->oracle_info.pred_addr;
-  const uns32 hist         = op->oracle_info.pred_global_hist;
+  const Addr  addr         = OP_ORACLE(op).pred_addr;
+  const uns32 hist         = OP_ORACLE(op).pred_global_hist;
   const uns32 pht_index    = get_pht_index(addr, hist);
   const uns8  pht_entry    = gshare_state.pht[pht_index];
 
   DEBUG(proc_id, "Writing gshare PHT for  op_num:%s  index:%d  dir:%d\n",
-        unsstr64(op->op_num), pht_index, op->oracle_info.dir);
+        unsstr64(op->op_num), pht_index, OP_ORACLE(op).dir);
 
-  if(op->oracle_info.dir) {
+  if(OP_ORACLE(op).dir) {
     gshare_state.pht[pht_index] = SAT_INC(pht_entry, N_BIT_MASK(PHT_CTR_BITS));
   } else {
     gshare_state.pht[pht_index] = SAT_DEC(pht_entry, 0);
   }
 
   DEBUG(proc_id, "Updating addr:%s  pht:%u  ent:%u  dir:%d\n", hexstr64s(addr),
-        pht_index, gshare_state.pht[pht_index], op->oracle_info.dir);
+        pht_index, gshare_state.pht[pht_index], OP_ORACLE(op).dir);
+}
+
+void bp_gshare_checkpoint(uns proc_id) {
+  auto& pht  = gshare_state_all_cores.at(proc_id).pht;
+  uns64 size = pht.size();
+  checkpoint_match(&size, sizeof(size), "gshare PHT size");
+  checkpoint_transfer(pht.data(), sizeof(pht[0]) * pht.size());
 }
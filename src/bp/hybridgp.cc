@@ -25,7 +25,9 @@
 
 extern "C" {
 #include "bp/bp.param.h"
+#include "checkpoint.h"
 #include "globals/assert.h"
+#include "globals/utils.h"
 #include "libs/cache_lib.h"
 #include "libs/hash_lib.h"
 #include "statistics.h"
@@ -208,7 +210,7 @@ void update_loop_filter(Op* op, Hybridgp_State& hybridgp_state,
   const uns32 counter        = features.packed_entry & 0x7f;
   const uns32 repeat_counter = (features.packed_entry & 0xf0000) >> 0x10;
 
-  if(features.dir == op->oracle_info.dir) {
+  if(features.dir == OP_ORACLE(op).dir) {
     hybridgp_state.filter[filter_index] = (0xFFF00000 |
                                            (features.packed_entry &
                                             0xFFFFFF80) |
@@ -236,14 +238,14 @@ bool get_gpred(Op* op, Hybridgp_State& hybridgp_state, const Addr addr,
   uns8 gpht_entry;
   if(INF_HYBRIDGP) {
     Flag        new_entry;
-    const int64 key = addr << 32 | (Addr)op->oracle_info.pred_global_hist;
+    const int64 key = addr << 32 | (Addr)OP_ORACLE(op).pred_global_hist;
     uns8* entry = (uns8*)hash_table_access_create(&hybridgp_state.hybgpht_hash,
                                                   key, &new_entry);
     if(new_entry) {
       *entry = PHT_INIT_VALUE;
     }
-    gpht_entry                      = *entry;
-    op->oracle_info.pred_gpht_entry = entry;  // need for update
+    gpht_entry                    = *entry;
+    OP_ORACLE(op).pred_gpht_entry = entry;  // need for update
   } else {
     gpht_entry = hybridgp_state.hybgpht[gpht_index];
   }
@@ -257,20 +259,20 @@ bool get_ppred(const Hybridgp_State& hybridgp_state, const uns32 ppht_index) {
 
 void update_all_phts(const Op* op, Hybridgp_State& hybridgp_state,
                      const Hybridgp_Indices& indices) {
-  uns8* gpht_entry = INF_HYBRIDGP ? op->oracle_info.pred_gpht_entry :
+  uns8* gpht_entry = INF_HYBRIDGP ? OP_ORACLE(op).pred_gpht_entry :
                                     &hybridgp_state.hybgpht[indices.gpht];
   uns8* spht_entry = &hybridgp_state.hybspht[indices.spht];
   uns8* ppht_entry = &hybridgp_state.hybppht[indices.ppht];
 
   const uns8 gpred = USE_FILTER ? (*gpht_entry >> (PHT_CTR_BITS - 1)) :
-                                  op->oracle_info.hybridgp_gpred;
+                                  OP_ORACLE(op).hybridgp_gpred;
   const uns8 ppred = *ppht_entry >> (PHT_CTR_BITS - 1);
 
   DEBUG(op->proc_id, "Writing hybridgp PHT for op_num:%s\n",
         unsstr64(op->op_num));
 
 
-  if(op->oracle_info.dir) {
+  if(OP_ORACLE(op).dir) {
     *gpht_entry = SAT_INC(*gpht_entry, N_BIT_MASK(PHT_CTR_BITS));
     *ppht_entry = SAT_INC(*ppht_entry, N_BIT_MASK(PHT_CTR_BITS));
   } else {
@@ -278,9 +280,9 @@ void update_all_phts(const Op* op, Hybridgp_State& hybridgp_state,
     *ppht_entry = SAT_DEC(*ppht_entry, 0);
   }
 
-  if((gpred == op->oracle_info.dir) && (ppred != op->oracle_info.dir)) {
+  if((gpred == OP_ORACLE(op).dir) && (ppred != OP_ORACLE(op).dir)) {
     *spht_entry = SAT_INC(*spht_entry, N_BIT_MASK(PHT_CTR_BITS));
-  } else if((gpred != op->oracle_info.dir) && (ppred == op->oracle_info.dir)) {
+  } else if((gpred != OP_ORACLE(op).dir) && (ppred == OP_ORACLE(op).dir)) {
     *spht_entry = SAT_DEC(*spht_entry, 0);
   }
 }
@@ -318,8 +320,8 @@ uns8 bp_hybridgp_pred(Op* op) {
   const uns proc_id        = op->proc_id;
   auto&     hybridgp_state = hybridgp_state_all_cores.at(proc_id);
 
-  const Addr  addr    = op->oracle_info.pred_addr;
-  const uns32 ghist   = op->oracle_info.pred_global_hist;
+  const Addr  addr    = OP_ORACLE(op).pred_addr;
+  const uns32 ghist   = OP_ORACLE(op).pred_global_hist;
   const uns32 phist   = get_local_history(hybridgp_state, addr);
   const auto  indices = cook_indices(addr, ghist, phist);
 
@@ -336,10 +338,10 @@ uns8 bp_hybridgp_pred(Op* op) {
     }
   }
 
-  op->pred_cycle                  = cycle_count;
-  op->oracle_info.hybridgp_gpred  = gpred;
-  op->oracle_info.hybridgp_ppred  = ppred;
-  op->oracle_info.pred_local_hist = phist;
+  op->pred_cycle                = cycle_count;
+  OP_ORACLE(op).hybridgp_gpred  = gpred;
+  OP_ORACLE(op).hybridgp_ppred  = ppred;
+  OP_ORACLE(op).pred_local_hist = phist;
 
   const auto branch_id = op->recovery_info.branch_id;
   hybridgp_state.in_flight[branch_id].updated_local_history = true;
@@ -368,9 +370,9 @@ void bp_hybridgp_update(Op* op) {
   const uns proc_id        = op->proc_id;
   auto&     hybridgp_state = hybridgp_state_all_cores.at(proc_id);
 
-  const Addr  addr    = op->oracle_info.pred_addr;
-  const uns32 ghist   = op->oracle_info.pred_global_hist;
-  const uns32 phist   = op->oracle_info.pred_local_hist;
+  const Addr  addr    = OP_ORACLE(op).pred_addr;
+  const uns32 ghist   = OP_ORACLE(op).pred_global_hist;
+  const uns32 phist   = OP_ORACLE(op).pred_local_hist;
   const auto  indices = cook_indices(addr, ghist, phist);
 
   const uns32 resolution_time = cycle_count -
@@ -402,8 +404,8 @@ void bp_hybridgp_update(Op* op) {
   if(KNOB_PRINT_BRINFO) {
     ASSERT(proc_id, brmispred != NULL);
     fprintf(brmispred, "%16llx %d %d %d %d %d\n", addr,
-            op->oracle_info.mispred ? 1 : 0, op->oracle_info.misfetch ? 1 : 0,
-            op->oracle_info.pred_conf ? 1 : 0, op->oracle_info.dir ? 1 : 0,
+            OP_ORACLE(op).mispred ? 1 : 0, OP_ORACLE(op).misfetch ? 1 : 0,
+            OP_ORACLE(op).pred_conf ? 1 : 0, OP_ORACLE(op).dir ? 1 : 0,
             resolution_time);
   }
 }
@@ -460,3 +462,23 @@ uns8 bp_hybridgp_full(uns proc_id) {
 
   return hybridgp_state.in_flight.is_full();
 }
+
+void bp_hybridgp_checkpoint(uns proc_id) {
+  auto& hybridgp_state = hybridgp_state_all_cores.at(proc_id);
+  auto  transfer_table = [](auto& table, const char* what) {
+    uns64 size = table.size();
+    checkpoint_match(&size, sizeof(size), what);
+    checkpoint_transfer(table.data(), sizeof(table[0]) * table.size());
+  };
+
+  transfer_table(hybridgp_state.hybspht, "hybridgp SPHT size");
+  transfer_table(hybridgp_state.hybgpht, "hybridgp GPHT size");
+  transfer_table(hybridgp_state.hybppht, "hybridgp PPHT size");
+  transfer_table(hybridgp_state.filter, "hybridgp loop filter size");
+  if(INF_HYBRIDGP) {
+    WARNINGU_ONCE(proc_id, "The interference-free BHT and GPHT of hybridgp "
+                           "cannot be checkpointed, they start cold\n");
+  } else {
+    checkpoint_cache(&hybridgp_state.bht);
+  }
+}
@@ -26,6 +26,7 @@
 
 extern "C" {
 #include "bp.param.h"
+#include "checkpoint.h"
 #include "core.param.h"
 #include "globals/assert.h"
 #include "table_info.h"
@@ -101,23 +102,23 @@ void bp_tagescl_spec_update(Op* op) {
   uns proc_id = op->proc_id;
   tagescl_predictors.at(proc_id)->update_speculative_state(
     op->recovery_info.branch_id, op->inst_info->addr,
-    get_branch_type(proc_id, op->table_info->cf_type), op->oracle_info.pred,
-    op->oracle_info.target);
+    get_branch_type(proc_id, op->table_info->cf_type), OP_ORACLE(op).pred,
+    OP_ORACLE(op).target);
 }
 
 void bp_tagescl_update(Op* op) {
   uns proc_id = op->proc_id;
   tagescl_predictors.at(proc_id)->commit_state(
     op->recovery_info.branch_id, op->inst_info->addr,
-    get_branch_type(proc_id, op->table_info->cf_type), op->oracle_info.dir);
+    get_branch_type(proc_id, op->table_info->cf_type), OP_ORACLE(op).dir);
 }
 
 void bp_tagescl_retire(Op* op) {
   uns proc_id = op->proc_id;
   tagescl_predictors.at(proc_id)->commit_state_at_retire(
     op->recovery_info.branch_id, op->inst_info->addr,
-    get_branch_type(proc_id, op->table_info->cf_type), op->oracle_info.dir,
-    op->oracle_info.target);
+    get_branch_type(proc_id, op->table_info->cf_type), OP_ORACLE(op).dir,
+    OP_ORACLE(op).target);
 }
 
 void bp_tagescl_recover(Recovery_Info* recovery_info) {
@@ -131,3 +132,8 @@ void bp_tagescl_recover(Recovery_Info* recovery_info) {
 uns8 bp_tagescl_full(uns proc_id) {
     return tagescl_predictors.at(proc_id)->is_full();
 }
+
+void bp_tagescl_checkpoint(uns proc_id) {
+  State_Archive archive(checkpoint_transfer, checkpoint_match);
+  tagescl_predictors.at(proc_id)->serialize(archive);
+}
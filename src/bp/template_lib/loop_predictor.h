@@ -212,6 +212,8 @@ class Loop_Predictor {
     prediction_info->hit_bank = -1;
   }
 
+  void serialize(State_Archive& archive) { archive(table_); }
+
  private:
   struct LoopPredictorEntry {
     int16_t total_iterations = 0;  // 10 bits
@@ -192,6 +192,38 @@ class Statistical_Corrector {
     }
   }
 
+  void serialize(State_Archive& archive) {
+    archive(global_history_);
+    archive(path_);
+    archive(first_local_history_table_);
+    archive(second_local_history_table_);
+    archive(third_local_history_table_);
+    archive(imli_counter_);
+    archive(imli_table_);
+    archive(first_high_confidence_ctr_);
+    archive(second_high_confidence_ctr_);
+    archive(update_threshold_);
+    archive(p_update_thresholds_);
+    archive(global_history_gehl_);
+    archive(path_gehl_);
+    archive(first_local_gehl_);
+    archive(second_local_gehl_);
+    archive(third_local_gehl_);
+    archive(first_imli_gehl_);
+    archive(second_imli_gehl_);
+    archive(global_history_threshold_table_);
+    archive(path_threshold_table_);
+    archive(first_local_threshold_table_);
+    archive(second_local_threshold_table_);
+    archive(third_local_threshold_table_);
+    archive(first_imli_threshold_table_);
+    archive(second_imli_threshold_table_);
+    archive(bias_threshold_table_);
+    archive(bias_table_);
+    archive(bias_sk_table_);
+    archive(bias_bank_table_);
+  }
+
  private:
   using Counter_Type = Saturating_Counter<CONFIG::SC::PRECISION, true>;
   using Per_PC_Threshold_Table_Type =
@@ -79,6 +79,12 @@ class Long_History_Register {
 
   int64_t head_idx() const { return head_; }
 
+  void serialize(State_Archive& archive) {
+    archive(num_speculative_bits_);
+    archive(history_bits_);
+    archive(head_);
+  }
+
  private:
   int num_speculative_bits_ = 0;  // keeps track of how many bits can be
                                   // discarded during a rewind without losing
@@ -279,6 +285,16 @@ class Tage_Histories {
 
   void intialize_folded_history(void);
 
+  void serialize(State_Archive& archive) {
+    history_register_.serialize(archive);
+    archive(folded_histories_for_indices_);
+    archive(folded_histories_for_tags_0_);
+    archive(folded_histories_for_tags_1_);
+    archive(path_history_);
+    archive(head_old_);
+    archive(path_history_old_);
+  }
+
   // Hash function for the path history used in creating table indices.
   int64_t compute_path_hash(int64_t path_history, int max_width, int bank,
                             int index_size) const;
@@ -608,6 +624,17 @@ class Tage {
     *prediction_info = {};
   }
 
+  // The table pointers and the random number generator are not part of the
+  // serialized state (the generator is owned by Tage_SC_L).
+  void serialize(State_Archive& archive) {
+    tage_histories_.serialize(archive);
+    archive(bimodal_table_);
+    archive(low_history_tagged_table_);
+    archive(high_history_tagged_table_);
+    archive(alt_selector_table_);
+    archive(tick_);
+  }
+
  private:
   struct Bimodal_Entry {
     int8_t hysteresis = 1;
@@ -51,6 +51,7 @@ class Tage_SC_L_Base {
                                              bool        resolve_dir,
                                              uint64_t    br_target)      = 0;
   virtual bool is_full()                                              = 0;
+  virtual void serialize(State_Archive& archive)                      = 0;
 };
 
 /* Interface functions:
@@ -89,6 +90,16 @@ class Tage_SC_L : public Tage_SC_L_Base {
     return prediction_info_buffer_.is_full();
   }
 
+  // Saves or loads the predictor tables and histories. The in-flight
+  // prediction info is not included, so no branch may be in flight.
+  void serialize(State_Archive& archive) override {
+    archive(random_number_gen_.seed_);
+    tage_.serialize(archive);
+    statistical_corrector_.serialize(archive);
+    loop_predictor_.serialize(archive);
+    archive(loop_predictor_beneficial_);
+  }
+
   // It uses the speculative state of the predictor to generate a prediction.
   // Should be called before update_speculative_state.
   bool get_prediction(int64_t branch_id, uint64_t br_pc) override;
@@ -23,6 +23,9 @@
 #define __TAGE_SC_L_LIB_H_
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 inline int get_min_num_bits_to_represent(int x) {
   assert(x > 0);
@@ -140,6 +143,56 @@ class Random_Number_Generator {
   int64_t* ptghist_ptr_;
 };
 
+/* Saves or loads the long-lived predictor state for checkpointing. The
+ * transfer function either writes the bytes out or fills them in, so a single
+ * serialize() method per class covers both directions. The match function
+ * writes the bytes out or stops the simulation if the saved ones differ.
+ * Tables of trivially copyable entries (counters, POD structs and arrays of
+ * them) are transferred as raw bytes. */
+class State_Archive {
+ public:
+  using Transfer_Func = void (*)(void* buf, size_t size);
+  using Match_Func    = void (*)(const void* buf, size_t size, const char* what);
+
+  State_Archive(Transfer_Func transfer, Match_Func match) :
+      transfer_(transfer), match_(match) {}
+
+  template <typename T>
+  void operator()(T& value) {
+    transfer_(&value, sizeof(T));
+  }
+
+  template <typename T>
+  void operator()(std::vector<T>& vec) {
+    transfer_size(vec.size());
+    transfer_(vec.data(), sizeof(T) * vec.size());
+  }
+
+  void operator()(std::vector<bool>& vec) {
+    transfer_size(vec.size());
+    for(size_t i = 0; i < vec.size(); i += 64) {
+      uint64_t word = 0;
+      for(size_t j = i; j < vec.size() && j < i + 64; ++j) {
+        word |= uint64_t(vec[j]) << (j - i);
+      }
+      transfer_(&word, sizeof(word));
+      for(size_t j = i; j < vec.size() && j < i + 64; ++j) {
+        vec[j] = (word >> (j - i)) & 1;
+      }
+    }
+  }
+
+ private:
+  // Tables are sized by the configuration, which must not have changed.
+  void transfer_size(size_t size) {
+    uint64_t saved_size = size;
+    match_(&saved_size, sizeof(saved_size), "predictor table size");
+  }
+
+  Transfer_Func transfer_;
+  Match_Func    match_;
+};
+
 struct Branch_Type {
   bool is_conditional;
   bool is_indirect;
@@ -182,7 +182,7 @@ void bp_twolevel_init_ahrt(){
 }
 /**************************************************/
 uns8 bp_twolevel_pred_hhrt(Op* op) {
-  const Addr address = op->oracle_info.pred_addr;
+  const Addr address = OP_ORACLE(op).pred_addr;
   unsigned int ghrIndex = hash(address);
 	unsigned int ghr = hash_hrt[ghrIndex];
 
@@ -191,7 +191,7 @@ uns8 bp_twolevel_pred_hhrt(Op* op) {
 }
 /**************************************************/
 uns8 bp_twolevel_pred_ahrt(Op* op) {
-  const Addr address = op->oracle_info.pred_addr;
+  const Addr address = OP_ORACLE(op).pred_addr;
   long long ghr = get_cache_entry(address);
   unsigned int index = static_cast<unsigned int> (ghr);
 
@@ -200,11 +200,11 @@ uns8 bp_twolevel_pred_ahrt(Op* op) {
 }
 /**************************************************/
 void bp_twolevel_update_hhrt(Op* op) {
-  const Addr address = op->oracle_info.pred_addr;
+  const Addr address = OP_ORACLE(op).pred_addr;
   unsigned int ghrIndex = hash(address);
   unsigned int ghr = hash_hrt[ghrIndex];
   
-  bool actual_outcome = (op->oracle_info.dir == TAKEN);
+  bool actual_outcome = (OP_ORACLE(op).dir == TAKEN);
 
   if (actual_outcome) {
     if (pattern_history_table[ghr] < 3) {
@@ -220,11 +220,11 @@ void bp_twolevel_update_hhrt(Op* op) {
 }
 /**************************************************/
 void bp_twolevel_update_ahrt(Op* op) {
-  const Addr address = op->oracle_info.pred_addr;
+  const Addr address = OP_ORACLE(op).pred_addr;
   long long ghr = get_cache_entry(address);
   unsigned int index = static_cast<unsigned int> (ghr);
 
-  bool actual_outcome = (op->oracle_info.dir == TAKEN);
+  bool actual_outcome = (OP_ORACLE(op).dir == TAKEN);
 
   if (actual_outcome) {
     if (pattern_history_table[index] < 3) {
@@ -1,31 +1,82 @@
-#include <unordered_map>
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : cache_miss_analyzer.cpp
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : 3C miss classification (see cache_miss_analyzer.h).
+ ***************************************************************************************/
+
+#include <vector>
+
 #include "cache_miss_analyzer.h"
-#include <iostream>
+#include "libs/stack_distance.h"
 
-std::unordered_map<uint64_t, bool> address_seen;
+struct Miss_Classifier_struct {
+  uns                    line_shift;
+  Stack_Distance_Tracker fa_lru; /* fully-associative shadow of the cache */
+  std::vector<uns64>     filter; /* first-touch Bloom filter */
+  uns64                  filter_mask;
 
-enum class MissType {
-    COMPULSORY,
-    CAPACITY,
-    CONFLICT,
-    OTHER
+  Miss_Classifier_struct(uns num_lines, uns line_size, uns filter_bits) :
+      line_shift(0), fa_lru(num_lines),
+      filter(((uns64)1 << filter_bits) / 64 + 1, 0),
+      filter_mask(((uns64)1 << filter_bits) - 1) {
+    while((1u << line_shift) < line_size)
+      line_shift++;
+  }
+
+  /* sets the two filter bits of 'line' and returns whether both were set */
+  bool touch(Addr line) {
+    uns64 hash = (uns64)line * 0x9e3779b97f4a7c15ull;
+    uns64 bit0 = (hash >> 16) & filter_mask;
+    uns64 bit1 = ((hash >> 40) ^ hash) & filter_mask;
+    bool  seen = (filter[bit0 >> 6] >> (bit0 & 63) & 1) &&
+                (filter[bit1 >> 6] >> (bit1 & 63) & 1);
+    filter[bit0 >> 6] |= (uns64)1 << (bit0 & 63);
+    filter[bit1 >> 6] |= (uns64)1 << (bit1 & 63);
+    return seen;
+  }
 };
 
-MissType categorize_miss(uint64_t address, int set_full) {
-    
-    if (address_seen.find(address) == address_seen.end()) { // address not found
-        address_seen[address] = true;
-        return MissType::COMPULSORY;
-    } else if (set_full == 1) { // set is full
-        return MissType::CAPACITY;
-    } else {
-        return MissType::CONFLICT;
-    }
+extern "C" {
+
+Miss_Classifier* miss_classifier_create(uns num_lines, uns line_size,
+                                        uns filter_bits) {
+  return new Miss_Classifier(num_lines, line_size, filter_bits);
 }
 
-extern "C" {
-    int log_cache_miss(Addr address, int set_full) {
-        MissType miss_type = categorize_miss(address, set_full);
-        return static_cast<int>(miss_type);
-    }
+void miss_classifier_free(Miss_Classifier* mc) {
+  delete mc;
+}
+
+Miss_Type miss_classifier_access(Miss_Classifier* mc, Addr addr, Flag hit) {
+  Addr line     = addr >> mc->line_shift;
+  uns  distance = mc->fa_lru.access(line);
+  bool seen     = mc->touch(line);
+  if(hit)
+    return MISS_NONE;
+  if(distance != Stack_Distance_Tracker::BEYOND_DEPTH)
+    return MISS_CONFLICT;
+  return seen ? MISS_CAPACITY : MISS_COMPULSORY;
+}
 }
@@ -1,11 +1,66 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : cache_miss_analyzer.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : 3C (compulsory / capacity / conflict) classification of the
+ *                misses of one cache.  The classifier is fed every access the
+ *                cache sees and models a fully-associative LRU cache with the
+ *                same number of lines: a miss is compulsory if the line has
+ *                never been touched, capacity if the fully-associative cache
+ *                would miss as well, and conflict otherwise.
+ ***************************************************************************************/
+
+#ifndef __CACHE_MISS_ANALYZER_H__
+#define __CACHE_MISS_ANALYZER_H__
+
 #include "globals/global_types.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-int log_cache_miss(Addr address, int cache_size);
+/* the order matches the <CACHE>_MISS_COMPULSORY/CAPACITY/CONFLICT stats */
+typedef enum Miss_Type_enum {
+  MISS_COMPULSORY,
+  MISS_CAPACITY,
+  MISS_CONFLICT,
+  MISS_NONE, /* the access hit */
+} Miss_Type;
+
+typedef struct Miss_Classifier_struct Miss_Classifier;
+
+/* 'filter_bits' is the log2 of the size in bits of the first-touch filter;
+   the filter is a Bloom filter, so a line that aliases with previously
+   touched lines is (rarely) classified as capacity instead of compulsory */
+Miss_Classifier* miss_classifier_create(uns num_lines, uns line_size,
+                                        uns filter_bits);
+void             miss_classifier_free(Miss_Classifier* mc);
+Miss_Type        miss_classifier_access(Miss_Classifier* mc, Addr addr,
+                                        Flag hit);
 
 #ifdef __cplusplus
 }
 #endif
+
+#endif /* #ifndef __CACHE_MISS_ANALYZER_H__ */
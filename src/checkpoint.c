@@ -0,0 +1,416 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : checkpoint.c
+ * Author       : HPS Research Group
+ * Date         :
+ * Description  : Snapshot of the warmed-up microarchitectural state.
+ *
+ * With CHECKPOINT_SAVE set, full_sim() writes the state left by the warmup to a
+ * file. With CHECKPOINT_LOAD set, it restores that state instead of running the
+ * warmup, so a sweep over parameters the warmup does not depend on (core
+ * widths, queue sizes, ...) pays for the warmup once.
+ *
+ * A snapshot is laid out as
+ *
+ *   header | per-core inst counts | core 0 | ... | core N-1 | uncore |
+ *   prefetchers | end
+ *
+ * where each core section holds the icache, the dcache, the branch predictor
+ * (BTB, indirect target predictors, CRS, histories and the tables of BP_MECH
+ * and LATE_BP_MECH) and the uop cache, and the uncore section holds the MLC
+ * and the L1. Every structure is preceded by a section tag and, for caches, by
+ * its geometry, both of which are checked on load. The per-core instruction
+ * counts give the trace position to resume from.
+ *
+ * Only long-lived state is saved: after the warmup nothing is in flight, so
+ * the per-branch buffers of the predictors and the prefetch request queues
+ * are empty anyway. Predictors and prefetchers without a checkpoint hook in
+ * bp_table.def / pref_table.def start cold after a restore (with a warning).
+ ***************************************************************************************/
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "bp/bp.h"
+#include "bp/bp.param.h"
+#include "checkpoint.h"
+#include "cmp_model.h"
+#include "core.param.h"
+#include "freq.h"
+#include "frontend/frontend_intf.h"
+#include "frontend/pin_trace_fe.h"
+#include "general.param.h"
+#include "libs/cache_lib.h"
+#include "memory/memory.h"
+#include "memory/memory.param.h"
+#include "model.h"
+#include "prefetcher/pref_common.h"
+#include "uop_cache.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define CHECKPOINT_SECTION_SIZE 16
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Checkpoint_Header_struct {
+  char    magic[CHECKPOINT_MAGIC_SIZE];
+  uns32   version;
+  uns32   num_cores;
+  Counter trace_start_inst;
+  Counter sim_time;
+} Checkpoint_Header;
+
+typedef struct Checkpoint_Cache_Geometry_struct {
+  uns32 num_sets;
+  uns32 assoc;
+  uns32 line_size;
+  uns32 data_size;
+  uns32 repl_policy;
+} Checkpoint_Cache_Geometry;
+
+/* On-disk form of a Cache_Entry (without the data pointer) */
+typedef struct Checkpoint_Cache_Entry_struct {
+  Addr    tag;
+  Addr    base;
+  Addr    pw_start_addr;
+  Counter last_access_time;
+  Counter insertion_time;
+  uns8    proc_id;
+  Flag    valid;
+  Flag    pref;
+  Flag    dirty;
+  uns8    reference_val;
+  Flag    outcome;
+} Checkpoint_Cache_Entry;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static FILE*       checkpoint_file;
+static const char* checkpoint_path;
+static Flag        loading;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void checkpoint_open(const char* path, Flag load);
+static void checkpoint_close(void);
+static void checkpoint_state(Counter* trace_pos);
+static void checkpoint_core(uns proc_id);
+static void checkpoint_bp(Bp_Data* bp_data);
+static void checkpoint_bp_tables(Bp* bp, uns proc_id);
+static void checkpoint_uncore(void);
+
+/**************************************************************************************/
+/* checkpoint_save */
+
+void checkpoint_save(const char* path) {
+  Counter* trace_pos = (Counter*)malloc(sizeof(Counter) * NUM_CORES);
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    trace_pos[proc_id] = inst_count[proc_id];
+
+  checkpoint_open(path, FALSE);
+  checkpoint_state(trace_pos);
+  checkpoint_close();
+  free(trace_pos);
+
+  printf("Saved warmup checkpoint to %s after %llu instructions\n", path,
+         inst_count[0]);
+}
+
+/**************************************************************************************/
+/* checkpoint_load */
+
+void checkpoint_load(const char* path) {
+  Counter* trace_pos = (Counter*)malloc(sizeof(Counter) * NUM_CORES);
+
+  checkpoint_open(path, TRUE);
+  checkpoint_state(trace_pos);
+  checkpoint_close();
+
+  /* Resume every trace right after the instructions consumed by the warmup
+     that produced the snapshot */
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(DUMB_CORE_ON && DUMB_CORE == proc_id)
+      continue;
+    trace_close_trace_file(proc_id);
+    trace_setup_at(proc_id, trace_pos[proc_id]);
+    trace_read_done[proc_id] = FALSE;
+    reached_exit[proc_id]    = FALSE;
+  }
+
+  printf("Loaded warmup checkpoint from %s (%llu instructions)\n", path,
+         trace_pos[0]);
+  free(trace_pos);
+}
+
+/**************************************************************************************/
+/* checkpoint_open / checkpoint_close */
+
+static void checkpoint_open(const char* path, Flag load) {
+  ASSERTM(0, SIM_MODEL == CMP_MODEL, "Checkpoints need the cmp model\n");
+  ASSERTM(0, FRONTEND == FE_TRACE,
+          "Checkpoints can only resume the trace frontend\n");
+
+  loading         = load;
+  checkpoint_path = path;
+  checkpoint_file = fopen(path, load ? "rb" : "wb");
+  if(!checkpoint_file)
+    FATAL_ERROR(0, "Could not open checkpoint %s\n", path);
+}
+
+static void checkpoint_close(void) {
+  checkpoint_section("end");
+  if(fclose(checkpoint_file))
+    FATAL_ERROR(0, "Could not close checkpoint %s\n", checkpoint_path);
+  checkpoint_file = NULL;
+}
+
+/**************************************************************************************/
+/* checkpoint_state: the whole snapshot, in either direction */
+
+static void checkpoint_state(Counter* trace_pos) {
+  Checkpoint_Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE);
+  header.version          = CHECKPOINT_VERSION;
+  header.num_cores        = NUM_CORES;
+  header.trace_start_inst = TRACE_START_INST;
+
+  checkpoint_match(&header, offsetof(Checkpoint_Header, sim_time),
+                   "header (version, NUM_CORES or TRACE_START_INST)");
+  /* Cache replacement runs on timestamps, so the restored lines are only
+     comparable to new ones if time continues from where the warmup left it */
+  header.sim_time = freq_time();
+  checkpoint_transfer(&header.sim_time, sizeof(header.sim_time));
+  checkpoint_transfer(trace_pos, sizeof(Counter) * NUM_CORES);
+  if(loading) {
+    freq_set_time(header.sim_time);
+    sim_time = header.sim_time;
+  }
+
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    checkpoint_core(proc_id);
+  checkpoint_uncore();
+  pref_checkpoint();
+}
+
+/**************************************************************************************/
+/* checkpoint_core */
+
+static void checkpoint_core(uns proc_id) {
+  checkpoint_section("core");
+  checkpoint_cache(&cmp_model.icache_stage[proc_id].icache);
+  line_cache_checkpoint(cmp_model.dcache_stage[proc_id].dcache);
+  checkpoint_bp(&cmp_model.bp_data[proc_id]);
+  uop_cache_checkpoint(proc_id);
+}
+
+/**************************************************************************************/
+/* checkpoint_bp */
+
+static void checkpoint_bp(Bp_Data* bp_data) {
+  checkpoint_section("bp");
+  checkpoint_transfer(&bp_data->global_hist, sizeof(bp_data->global_hist));
+  checkpoint_transfer(&bp_data->targ_hist, sizeof(bp_data->targ_hist));
+  checkpoint_transfer(&bp_data->targ_index, sizeof(bp_data->targ_index));
+
+  checkpoint_transfer(bp_data->crs.entries,
+                      sizeof(Crs_Entry) * CRS_ENTRIES * 2);
+  checkpoint_transfer(bp_data->crs.off_path, sizeof(Flag) * CRS_ENTRIES);
+  checkpoint_transfer(&bp_data->crs.depth, sizeof(bp_data->crs.depth));
+  checkpoint_transfer(&bp_data->crs.head, sizeof(bp_data->crs.head));
+  checkpoint_transfer(&bp_data->crs.tail, sizeof(bp_data->crs.tail));
+  checkpoint_transfer(&bp_data->crs.tail_save, sizeof(bp_data->crs.tail_save));
+  checkpoint_transfer(&bp_data->crs.depth_save,
+                      sizeof(bp_data->crs.depth_save));
+  checkpoint_transfer(&bp_data->crs.tos, sizeof(bp_data->crs.tos));
+  checkpoint_transfer(&bp_data->crs.next, sizeof(bp_data->crs.next));
+
+  line_cache_checkpoint(bp_data->btb);
+  /* the indirect target structures that exist depend on IBTB_MECH */
+  if(bp_data->tc_tagged.entries)
+    checkpoint_cache(&bp_data->tc_tagged);
+  if(bp_data->tc_tagless)
+    checkpoint_transfer(bp_data->tc_tagless,
+                        sizeof(Addr) * (0x1 << IBTB_HIST_LENGTH));
+  if(bp_data->tc_selector)
+    checkpoint_transfer(bp_data->tc_selector,
+                        sizeof(uns8) * (0x1 << IBTB_HIST_LENGTH));
+
+  checkpoint_bp_tables(bp_data->bp, bp_data->proc_id);
+  if(bp_data->late_bp && bp_data->late_bp != bp_data->bp)
+    checkpoint_bp_tables(bp_data->late_bp, bp_data->proc_id);
+}
+
+static void checkpoint_bp_tables(Bp* bp, uns proc_id) {
+  checkpoint_section(bp->name);
+  if(bp->checkpoint_func) {
+    bp->checkpoint_func(proc_id);
+  } else {
+    WARNINGU_ONCE(proc_id,
+                  "Branch predictor %s cannot be checkpointed, its tables "
+                  "start cold\n",
+                  bp->name);
+  }
+}
+
+/**************************************************************************************/
+/* checkpoint_uncore */
+
+static void checkpoint_uncore(void) {
+  Uncore* uncores = cmp_model.memory.uncores;
+
+  checkpoint_section("uncore");
+  /* the MLC is shared and so is the L1 unless PRIVATE_L1 is on */
+  checkpoint_cache(&uncores[0].mlc->cache);
+  for(uns proc_id = 0; proc_id < (PRIVATE_L1 ? NUM_CORES : 1); proc_id++)
+    checkpoint_cache(&uncores[proc_id].l1->cache);
+}
+
+/**************************************************************************************/
+/* checkpoint_loading */
+
+Flag checkpoint_loading(void) {
+  return loading;
+}
+
+/**************************************************************************************/
+/* checkpoint_transfer */
+
+void checkpoint_transfer(void* buf, size_t size) {
+  ASSERT(0, checkpoint_file);
+  if(!size)
+    return;
+  if(loading) {
+    if(fread(buf, size, 1, checkpoint_file) != 1)
+      FATAL_ERROR(0, "Checkpoint %s is truncated\n", checkpoint_path);
+  } else {
+    if(fwrite(buf, size, 1, checkpoint_file) != 1)
+      FATAL_ERROR(0, "Could not write checkpoint %s\n", checkpoint_path);
+  }
+}
+
+/**************************************************************************************/
+/* checkpoint_match */
+
+void checkpoint_match(const void* buf, size_t size, const char* what) {
+  if(!loading) {
+    checkpoint_transfer((void*)buf, size);
+    return;
+  }
+  void* saved = malloc(size);
+  checkpoint_transfer(saved, size);
+  if(memcmp(saved, buf, size))
+    FATAL_ERROR(0, "Checkpoint %s does not match this configuration: %s\n",
+                checkpoint_path, what);
+  free(saved);
+}
+
+/**************************************************************************************/
+/* checkpoint_section */
+
+void checkpoint_section(const char* name) {
+  char tag[CHECKPOINT_SECTION_SIZE];
+  memset(tag, 0, sizeof(tag));
+  memcpy(tag, name, MIN2(strlen(name), sizeof(tag)));
+  checkpoint_match(tag, sizeof(tag), name);
+}
+
+/**************************************************************************************/
+/* checkpoint_cache: the lines and replacement state of a cache_lib cache.
+   Line data is saved as raw bytes, so it must not hold pointers. */
+
+void checkpoint_cache(Cache* cache) {
+  Checkpoint_Cache_Geometry geometry = {cache->num_sets, cache->assoc,
+                                        cache->line_size, cache->data_size,
+                                        cache->repl_policy};
+
+  checkpoint_section(cache->name);
+  checkpoint_match(&geometry, sizeof(geometry), cache->name);
+
+  switch(cache->repl_policy) {
+    case REPL_IDEAL:
+    case REPL_SHADOW_IDEAL:
+    case REPL_IDEAL_STORAGE:
+    case REPL_PARTITION:
+    case REPL_DRRIP:
+    case REPL_SHIP:
+      WARNINGU(0,
+               "Only the lines of %s are checkpointed, the side state of its "
+               "replacement policy starts cold\n",
+               cache->name);
+      break;
+    default:
+      break;
+  }
+
+  for(uns set = 0; set < cache->num_sets; set++) {
+    for(uns way = 0; way < cache->assoc; way++) {
+      Cache_Entry*           entry = &cache->entries[set][way];
+      Checkpoint_Cache_Entry saved;
+      memset(&saved, 0, sizeof(saved));
+      if(!loading) {
+        saved.tag              = entry->tag;
+        saved.base             = entry->base;
+        saved.pw_start_addr    = entry->pw_start_addr;
+        saved.last_access_time = entry->last_access_time;
+        saved.insertion_time   = entry->insertion_time;
+        saved.proc_id          = entry->proc_id;
+        saved.valid            = entry->valid;
+        saved.pref             = entry->pref;
+        saved.dirty            = entry->dirty;
+        saved.reference_val    = entry->reference_val;
+        saved.outcome          = entry->outcome;
+      }
+      checkpoint_transfer(&saved, sizeof(saved));
+      if(loading) {
+        entry->tag              = saved.tag;
+        entry->base             = saved.base;
+        entry->pw_start_addr    = saved.pw_start_addr;
+        entry->last_access_time = saved.last_access_time;
+        entry->insertion_time   = saved.insertion_time;
+        entry->proc_id          = saved.proc_id;
+        entry->valid            = saved.valid;
+        entry->pref             = saved.pref;
+        entry->dirty            = saved.dirty;
+        entry->reference_val    = saved.reference_val;
+        entry->outcome          = saved.outcome;
+      }
+      if(cache->data_size)
+        checkpoint_transfer(entry->data, cache->data_size);
+    }
+  }
+  if(loading)
+    cache_sync_tag_array(cache);
+
+  /* the replacement counters only exist for the policies below REPL_VOID */
+  if(cache->repl_policy < REPL_VOID)
+    checkpoint_transfer(cache->repl_ctrs, sizeof(uns) * cache->num_sets);
+}
@@ -0,0 +1,76 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : checkpoint.h
+ * Author       : HPS Research Group
+ * Date         :
+ * Description  : Snapshot of the warmed-up microarchitectural state.
+ ***************************************************************************************/
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include <stddef.h>
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Forward Declarations */
+
+struct Cache_struct;
+
+/**************************************************************************************/
+/* Defines */
+
+#define CHECKPOINT_MAGIC "SCRBCKPT"
+#define CHECKPOINT_MAGIC_SIZE 8
+/* Bump whenever the layout of any section changes */
+#define CHECKPOINT_VERSION 3
+
+/**************************************************************************************/
+/* Prototypes */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Writes the state left by the warmup to path (see checkpoint.c) */
+void checkpoint_save(const char* path);
+/* Restores the state saved by checkpoint_save() in place of the warmup */
+void checkpoint_load(const char* path);
+
+/* For the checkpoint hooks of the individual structures. Each hook is called
+   both when saving and when loading, so the same code describes the layout in
+   both directions: checkpoint_transfer() writes the buffer out or fills it in.
+   checkpoint_match() writes the buffer out or checks that the snapshot holds
+   the same bytes, which catches snapshots taken with another configuration
+   (table sizes, section order) before any state is loaded from them. */
+Flag checkpoint_loading(void);
+void checkpoint_transfer(void* buf, size_t size);
+void checkpoint_match(const void* buf, size_t size, const char* what);
+void checkpoint_section(const char* name);
+void checkpoint_cache(struct Cache_struct* cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __CHECKPOINT_H__ */
@@ -40,6 +40,7 @@
 #include "general.param.h"
 #include "globals/assert.h"
 #include "memory/cache_part.h"
+#include "memory/stack_sweep.h"
 #include "memory/memory.param.h"
 #include "op_pool.h"
 #include "prefetcher/pref.param.h"
@@ -52,6 +53,8 @@
 #include "sim.h"
 #include "statistics.h"
 
+#include "cmp_threads.h"
+
 #include "freq.h"
 #include "uop_queue_stage.h"
 #include "decoupled_frontend.h"
@@ -62,15 +65,28 @@
 Cmp_Model cmp_model;
 Flag perf_pred_started = FALSE;
 
+/* the chip cycles [quantum_start, quantum_end) the cores are running ahead
+   (CMP_THREAD_QUANTUM > 1) and the simulated time at quantum_start */
+static Counter quantum_start;
+static Counter quantum_end;
+static Counter quantum_time;
+
 /**************************************************************************************/
 /* Static prototypes */
 
 static void cmp_recover(void);
 static void cmp_redirect(void);
 static void cmp_measure_chip_util(void);
-static void cmp_istreams(void);
-static void cmp_cores(void);
-static void warmup_uncore(uns proc_id, Addr addr, Flag write);
+static void cmp_quantum_cycle(void);
+static void cmp_core_quantum(uns proc_id);
+static void cmp_istream(uns proc_id);
+static void cmp_istream_cycle(uns proc_id);
+static void cmp_core(uns proc_id);
+static void cmp_core_cycle(uns proc_id);
+static void warmup_l1(uns proc_id, Addr addr, Flag write, Addr load_pc,
+                      Flag train_pref);
+static void warmup_uncore(uns proc_id, Addr addr, Flag write, Addr load_pc,
+                          Flag train_pref);
 
 /**************************************************************************************/
 /* cmp_init */
@@ -84,6 +100,7 @@ void cmp_init(uns mode) {
         0, cmp_model.memory.uncores[0].l1->cache.repl_policy == REPL_PARTITION);
       cmp_model.memory.uncores[0].l1->cache.repl_policy = REPL_TRUE_LRU;
     }
+    cmp_threads_init();
     return;
   }
 
@@ -145,6 +162,7 @@ void cmp_init(uns mode) {
     dvfs_init();
 
   cache_part_init();
+  stack_sweep_init();
 
   ASSERTM(0, !USE_LATE_BP || LATE_BP_LATENCY < (DECODE_CYCLES + MAP_CYCLES),
           "Late branch prediction latency should be less than the total "
@@ -175,79 +193,196 @@ void cmp_reset() {
 /* cmp_cycle: */
 
 void cmp_cycle() {
-  cmp_istreams();
+  if(cmp_threads_on() && CMP_THREAD_QUANTUM > 1) {
+    cmp_quantum_cycle();
+    return;
+  }
+
+  cmp_threads_run(cmp_istream);
 
   /* Frequency domain checking is inside this function, since it
      handles both shared cache and memory */
   update_memory();
 
-  cmp_cores();
+  cmp_threads_run(cmp_core);
 
   if(DVFS_ON)
     dvfs_cycle();
   cache_part_update();
 }
 
-void cmp_istreams(void) {
+/**************************************************************************************/
+/* cmp_quantum_cycle: lets the cores run CMP_THREAD_QUANTUM cycles ahead of
+ * the memory system without synchronizing.  Requests the cores issue within
+ * a quantum are only seen by the memory system after the quantum, so the
+ * timing of shared resources is off by up to a quantum. */
+
+static void cmp_quantum_cycle() {
+  update_memory();
+
+  if(!freq_is_ready(FREQ_DOMAIN_CORES[0]))
+    return;
+
+  Counter cycle = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  if(cycle >= quantum_end) {
+    quantum_start = cycle;
+    quantum_end   = cycle + CMP_THREAD_QUANTUM;
+    quantum_time  = freq_time();
+    cmp_threads_run(cmp_core_quantum);
+  }
+  cache_part_update();
+}
+
+static void cmp_core_quantum(uns proc_id) {
+  uns cycle_time = freq_get_cycle_time(FREQ_DOMAIN_CORES[proc_id]);
+
+  for(Counter cycle = quantum_start; cycle < quantum_end; cycle++) {
+    cycle_count = cycle;
+    sim_time    = quantum_time + (cycle - quantum_start) * cycle_time;
+    cmp_istream_cycle(proc_id);
+    cmp_core_cycle(proc_id);
+  }
+}
+
+/**************************************************************************************/
+/* cmp_istream: recovers and redirects the fetch of one core. */
+
+static void cmp_istream(uns proc_id) {
+  if(DUMB_CORE_ON && DUMB_CORE == proc_id)
+    return;
+
+  if(freq_is_ready(FREQ_DOMAIN_CORES[proc_id])) {
+    cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+    sim_time    = freq_time();
+    cmp_istream_cycle(proc_id);
+  }
+}
+
+static void cmp_istream_cycle(uns proc_id) {
+  set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
+  if(cycle_count >= bp_recovery_info->recovery_cycle) {
+    set_bp_data(&cmp_model.bp_data[proc_id]);
+    cmp_set_all_stages(proc_id);
+    cmp_recover();
+  }
+  if(cycle_count >= bp_recovery_info->redirect_cycle) {
+    set_icache_stage(&cmp_model.icache_stage[proc_id]);
+    ASSERT(proc_id, proc_id == bp_recovery_info->redirect_op->proc_id);
+    ASSERT_PROC_ID_IN_ADDR(proc_id,
+                           OP_ORACLE(bp_recovery_info->redirect_op).pred_npc);
+    cmp_redirect();
+  }
+}
+
+/**************************************************************************************/
+/* cmp_core: simulates one cycle of the pipeline of one core. */
+
+static void cmp_core(uns proc_id) {
+  if(DUMB_CORE_ON && DUMB_CORE == proc_id)
+    return;
+
+  if(freq_is_ready(FREQ_DOMAIN_CORES[proc_id])) {
+    cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+    sim_time    = freq_time();
+    cmp_core_cycle(proc_id);
+  }
+}
+
+static void cmp_core_cycle(uns proc_id) {
+  set_bp_data(&cmp_model.bp_data[proc_id]);
+  set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
+  cmp_set_all_stages(proc_id);
+
+  update_dcache_stage(&exec->sd);
+  update_exec_stage(&node->sd);
+  update_node_stage(map->last_sd);
+  // Map stage can get ops from either the uop queue following the uop cache
+  // or the decoder.
+  Stage_Data* map_stage_uop_cache_src = NULL;
+  if (UOP_CACHE_ENABLE) {
+    map_stage_uop_cache_src = get_uop_queue_stage_length() > 0 ? uop_queue_stage_get_latest_sd() : &ic->uopc_sd;
+  }
+  // doesnt work: decode_stage_process_op must be called once per op. For uop cache, one cycle after fetch.
+  // I can add a flag: decode_cycle (cycle decoded).
+  update_map_stage(dec->last_sd, map_stage_uop_cache_src);
+  update_uop_queue_stage(&ic->uopc_sd);
+  update_decode_stage(&ic->sd);
+  update_decoupled_fe();
+  update_fdip();
+  update_eip();
+  update_icache_stage();
+
+  node_sched_ops();
+
+  cmp_measure_chip_util();
+}
+
+/**************************************************************************************/
+/* cmp_next_event_cycle: returns the earliest cycle at which any core or the
+ * on-chip memory system may change state on its own, or the next cycle if the
+ * chip is busy.  DRAM responses are not accounted for: the caller also asks
+ * the memory system for its next event (mem_next_event_time). */
+
+Counter cmp_next_event_cycle() {
+  Counter next = MAX_CTR;
+
+  if(!mem_is_quiescent())
+    return freq_cycle_count(FREQ_DOMAIN_CORES[0]) + 1;
+
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    if(DUMB_CORE_ON && DUMB_CORE == proc_id)
-      continue;
-
-    if(freq_is_ready(FREQ_DOMAIN_CORES[proc_id])) {
-      cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
-
-      set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
-      if(cycle_count >= bp_recovery_info->recovery_cycle) {
-        set_bp_data(&cmp_model.bp_data[proc_id]);
-        cmp_set_all_stages(proc_id);
-        cmp_recover();
-      }
-      if(cycle_count >= bp_recovery_info->redirect_cycle) {
-        set_icache_stage(&cmp_model.icache_stage[proc_id]);
-        ASSERT(proc_id, proc_id == bp_recovery_info->redirect_op->proc_id);
-        ASSERT_PROC_ID_IN_ADDR(
-          proc_id, bp_recovery_info->redirect_op->oracle_info.pred_npc);
-        cmp_redirect();
-      }
-    }
+    cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+
+    set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
+    cmp_set_all_stages(proc_id);
+
+    if(exec->sd.op_count || dc->sd.op_count)
+      return cycle_count + 1;
+
+    next = MIN2(next, bp_recovery_info->recovery_cycle);
+    next = MIN2(next, bp_recovery_info->redirect_cycle);
+    next = MIN2(next, node_next_event_cycle());
   }
+
+  return next;
 }
 
-void cmp_cores(void) {
+/**************************************************************************************/
+/* cmp_signature: folds the progress counters and the pipeline occupancy of
+ * all cores into one value.  Equal signatures before and after a cycle mean
+ * that no op was fetched, moved, or retired in that cycle. */
+
+Counter cmp_signature() {
+  Counter sig = 0;
+
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    if(DUMB_CORE_ON && DUMB_CORE == proc_id)
-      continue;
-
-    if(freq_is_ready(FREQ_DOMAIN_CORES[proc_id])) {
-      cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
-
-      set_bp_data(&cmp_model.bp_data[proc_id]);
-      set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
-      cmp_set_all_stages(proc_id);
-
-      update_dcache_stage(&exec->sd);
-      update_exec_stage(&node->sd);
-      update_node_stage(map->last_sd);
-      // Map stage can get ops from either the uop queue following the uop cache
-      // or the decoder.
-      Stage_Data* map_stage_uop_cache_src = NULL;
-      if (UOP_CACHE_ENABLE) {
-        map_stage_uop_cache_src = get_uop_queue_stage_length() > 0 ? uop_queue_stage_get_latest_sd() : &ic->uopc_sd;
-      }
-      // doesnt work: decode_stage_process_op must be called once per op. For uop cache, one cycle after fetch.
-      // I can add a flag: decode_cycle (cycle decoded).
-      update_map_stage(dec->last_sd, map_stage_uop_cache_src);
-      update_uop_queue_stage(&ic->uopc_sd);
-      update_decode_stage(&ic->sd);
-      update_decoupled_fe();
-      update_fdip();
-      update_eip();
-      update_icache_stage();
-
-      node_sched_ops();
-
-      cmp_measure_chip_util();
-    }
+    cmp_set_all_stages(proc_id);
+
+    sig = sig * 31 + op_count[proc_id];
+    sig = sig * 31 + inst_count[proc_id];
+    sig = sig * 31 + uop_count[proc_id];
+    sig = sig * 31 + ic->state;
+    sig = sig * 31 + ic->fetch_addr;
+    sig = sig * 31 + ic->sd.op_count;
+    sig = sig * 31 + ic->uopc_sd.op_count;
+    sig = sig * 31 + decoupled_fe_ftq_num_ops();
+    sig = sig * 31 + get_uop_queue_stage_length();
+    sig = sig * 31 + decode_stage_signature();
+    sig = sig * 31 + map_stage_signature();
+    sig = sig * 31 + node->node_count;
+    sig = sig * 31 + (Counter)node->next_op_into_rs;
+  }
+
+  return sig * 31 + mem->req_count;
+}
+
+/**************************************************************************************/
+/* cmp_skip_cycle: advances the per-core state that quiescent cycles would
+ * have changed (see cmp_next_event_cycle) without simulating the cycles. */
+
+void cmp_skip_cycle(Counter cycles) {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    set_node_stage(&cmp_model.node_stage[proc_id]);
+    node_skip_cycle(cycles);
   }
 }
 
@@ -281,12 +416,14 @@ void cmp_debug() {
 /* cmp_done: */
 
 void cmp_done() {
+  cmp_threads_done();
   if(PREF_FRAMEWORK_ON)
     pref_done();
   if(DVFS_ON)
     dvfs_done();
 
   finalize_memory();
+  stack_sweep_done();
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     cmp_set_all_stages(proc_id);
   }
@@ -329,9 +466,7 @@ void cmp_wake(Op* src_op, Op* dep_op, uns8 rdy_bit) {
      !dep_op->in_rdy_list) {
     _DEBUG(dep_op->proc_id, DEBUG_NODE_STAGE,
            "Adding to ready list  op_num:%s\n", unsstr64(dep_op->op_num));
-    dep_op->next_rdy    = node->rdy_head;
-    node->rdy_head      = dep_op;
-    dep_op->in_rdy_list = TRUE;
+    node_rdy_insert(dep_op);
   }
 }
 
@@ -354,15 +489,15 @@ void cmp_recover() {
 
   if(USE_LATE_BP && bp_recovery_info->late_bp_recovery) {
     Op* op                   = bp_recovery_info->recovery_op;
-    op->oracle_info.pred     = op->oracle_info.late_pred;
-    op->oracle_info.pred_npc = op->oracle_info.late_pred_npc;
-    ASSERT_PROC_ID_IN_ADDR(op->proc_id, op->oracle_info.pred_npc);
-    op->oracle_info.mispred  = op->oracle_info.late_mispred;
-    op->oracle_info.misfetch = op->oracle_info.late_misfetch;
+    OP_ORACLE(op).pred     = OP_ORACLE(op).late_pred;
+    OP_ORACLE(op).pred_npc = OP_ORACLE(op).late_pred_npc;
+    ASSERT_PROC_ID_IN_ADDR(op->proc_id, OP_ORACLE(op).pred_npc);
+    OP_ORACLE(op).mispred  = OP_ORACLE(op).late_mispred;
+    OP_ORACLE(op).misfetch = OP_ORACLE(op).late_misfetch;
 
     // Reset to FALSE to allow for another potential recovery after the branch
     // is resolved when executed.
-    op->oracle_info.recovery_sch = FALSE;
+    OP_ORACLE(op).recovery_sch = FALSE;
   }
 
   recover_thread(td, bp_recovery_info->recovery_fetch_addr,
@@ -381,6 +516,7 @@ void cmp_recover() {
   recover_exec_stage();
   recover_dcache_stage();
   recover_memory();
+  recover_op_pool(bp_recovery_info->proc_id);
 }
 
 /**************************************************************************************/
@@ -393,10 +529,10 @@ void cmp_redirect() {
          unsstr64(bp_recovery_info->redirect_op_num));
   ASSERT(bp_recovery_info->proc_id,
          bp_recovery_info->redirect_cycle != MAX_CTR);
-  bp_recovery_info->redirect_cycle                             = MAX_CTR;
-  bp_recovery_info->redirect_op->oracle_info.btb_miss_resolved = TRUE;
+  bp_recovery_info->redirect_cycle                           = MAX_CTR;
+  OP_ORACLE(bp_recovery_info->redirect_op).btb_miss_resolved = TRUE;
   ASSERT_PROC_ID_IN_ADDR(bp_recovery_info->proc_id,
-                         bp_recovery_info->redirect_op->oracle_info.pred_npc);
+                         OP_ORACLE(bp_recovery_info->redirect_op).pred_npc);
   redirect_icache_stage();
 }
 
@@ -407,15 +543,20 @@ void cmp_retire_hook(Op* op) {
   free_op(op);
 }
 
-void warmup_uncore(uns proc_id, Addr addr, Flag write) {
-  Addr dummy_line_addr;
-  ASSERTM(0, !MLC_PRESENT, "Warmup for MLC not implemented\n");
+/**************************************************************************************/
+/* warmup_l1: functional access to the shared L1 during warmup. */
 
+static void warmup_l1(uns proc_id, Addr addr, Flag write, Addr load_pc,
+                      Flag train_pref) {
+  Addr     dummy_line_addr;
   Cache*   l1_cache = &(cmp_model.memory.uncores[proc_id].l1->cache);
   L1_Data* l1_data  = cache_access(l1_cache, addr, &dummy_line_addr, TRUE);
   if(l1_data) {  // hit
     if(write)
       l1_data->dirty = TRUE;
+    if(train_pref)
+      pref_ul1_hit(proc_id, dummy_line_addr, load_pc,
+                   cmp_model.bp_data[proc_id].global_hist);
   } else {  // miss
     Addr repl_line_addr;
     Flag repl_line_valid;
@@ -432,25 +573,61 @@ void warmup_uncore(uns proc_id, Addr addr, Flag write) {
                                      &repl_line_addr);
     l1_data->proc_id = proc_id;
     l1_data->dirty   = write;
+    if(train_pref)
+      pref_ul1_miss(proc_id, dummy_line_addr, load_pc,
+                    cmp_model.bp_data[proc_id].global_hist);
   }
   if(L1_PART_SHADOW_WARMUP)
     cache_part_l1_warmup(proc_id, addr);
 }
 
 /**************************************************************************************/
-/* Warm up select microarchitectural structures: BP, icache, dcache,
-   and L1. No wrong path warmup.
-*/
+/* warmup_uncore: functional access to the MLC (if present) and L1 during
+   warmup. Dirty MLC victims are written back to the L1. */
+
+static void warmup_uncore(uns proc_id, Addr addr, Flag write, Addr load_pc,
+                          Flag train_pref) {
+  stack_sweep_access(STACK_SWEEP_LEVEL_WARMUP_UNCORE, proc_id, addr);
+  if(!MLC_PRESENT) {
+    warmup_l1(proc_id, addr, write, load_pc, train_pref);
+    return;
+  }
 
-void cmp_warmup(Op* op) {
-  uns  proc_id = op->proc_id;
-  Addr ia      = op->inst_info->addr;
-  Addr va      = op->oracle_info.va;
-  Addr dummy_line_addr;
-  Addr dummy_line_addr2;
+  Addr      dummy_line_addr;
+  Cache*    mlc_cache = &(cmp_model.memory.uncores[proc_id].mlc->cache);
+  MLC_Data* mlc_data  = cache_access(mlc_cache, addr, &dummy_line_addr, TRUE);
+  if(mlc_data) {  // hit
+    if(write)
+      mlc_data->dirty = TRUE;
+    if(train_pref)
+      pref_umlc_hit(proc_id, dummy_line_addr, load_pc,
+                    cmp_model.bp_data[proc_id].global_hist);
+  } else {  // miss
+    if(train_pref)
+      pref_umlc_miss(proc_id, dummy_line_addr, load_pc,
+                     cmp_model.bp_data[proc_id].global_hist);
+    warmup_l1(proc_id, addr, FALSE, load_pc, train_pref);
+    Addr repl_line_addr;
+    mlc_data = (MLC_Data*)cache_insert(mlc_cache, proc_id, addr,
+                                       &dummy_line_addr, &repl_line_addr);
+    if(repl_line_addr && mlc_data->dirty)
+      warmup_l1(get_proc_id_from_cmp_addr(repl_line_addr), repl_line_addr,
+                TRUE, 0, FALSE);
+    mlc_data->proc_id = proc_id;
+    mlc_data->dirty   = write;
+  }
+}
+
+/**************************************************************************************/
+/* cmp_warmup_icache: warm the icache and the uncore for an instruction fetch.
+   Misses train the uncore prefetchers only with PREF_I_TOGETHER, as in
+   simulation mode. */
+
+void cmp_warmup_icache(uns proc_id, Addr ia, Flag train_pref) {
+  Addr         dummy_line_addr;
+  Addr         dummy_line_addr2;
   Icache_Data* line_info = NULL;
 
-  // Warmup caches for instructions
   Icache_Stage* ic = &(cmp_model.icache_stage[proc_id]);
   Cache*      icache  = &(ic->icache);
   Inst_Info** ic_data = (Inst_Info**)cache_access(icache, ia, &dummy_line_addr,
@@ -459,7 +636,7 @@ void cmp_warmup(Op* op) {
     line_info = (Icache_Data*)cache_access(&ic->icache_line_info, ia, &dummy_line_addr2, TRUE);
 
   if(ic_data == NULL) {
-    warmup_uncore(proc_id, ia, FALSE);
+    warmup_uncore(proc_id, ia, FALSE, ia, train_pref && PREF_I_TOGETHER);
     Addr repl_line_addr;
     ic_data = (Inst_Info**)cache_insert(icache, proc_id, ia, &dummy_line_addr,
                                         &repl_line_addr);
@@ -478,43 +655,84 @@ void cmp_warmup(Op* op) {
       line_info->read_count[0] += 1;
     }
   }
+}
+
+/**************************************************************************************/
+/* cmp_warmup_dcache: warm the dcache and the uncore for a load or store at
+   va issued by the instruction at pc. With train_pref the data prefetchers
+   see the same dl0/umlc/ul1 hit and miss hooks as in simulation mode.
+   Returns the dcache line. */
+
+Dcache_Data* cmp_warmup_dcache(uns proc_id, Addr va, Addr pc, Flag is_store,
+                               Flag train_pref) {
+  Addr         dummy_line_addr;
+  Flag         is_load = !is_store;
+  Line_Cache*  dcache  = cmp_model.dcache_stage[proc_id].dcache;
+  Dcache_Data* dc_data = line_cache_access(dcache, va, &dummy_line_addr, TRUE);
+  if(train_pref)
+    set_dcache_stage(&cmp_model.dcache_stage[proc_id]);
+  if(dc_data) {
+    // set some fields to meet expectations of the simulation mode
+    if(is_store)
+      dc_data->dirty = TRUE;
+    dc_data->read_count[0] += is_load;
+    dc_data->write_count[0] += is_store;
+    if(train_pref)
+      pref_dl0_hit(dummy_line_addr, pc);
+  } else {
+    if(train_pref)
+      pref_dl0_miss(dummy_line_addr, pc);
+    warmup_uncore(proc_id, va, FALSE, pc, train_pref);
+    Addr repl_line_addr;
+    dc_data = (Dcache_Data*)line_cache_insert(dcache, proc_id, va,
+                                              &dummy_line_addr,
+                                              &repl_line_addr);
+    if(dc_data->dirty)
+      warmup_uncore(proc_id, repl_line_addr, TRUE, 0, FALSE);
+    dc_data->dirty          = is_store;
+    dc_data->read_count[0]  = is_load;
+    dc_data->write_count[0] = is_store;
+  }
+  return dc_data;
+}
+
+/**************************************************************************************/
+/* cmp_warmup_bp: predict, resolve and retire a control flow op in the branch
+   predictor, BTB and indirect target predictor. */
+
+void cmp_warmup_bp(Op* op) {
+  Bp_Data* bp_data = &(cmp_model.bp_data[op->proc_id]);
+  bp_predict_op(bp_data, op, 1, op->inst_info->addr);
+  bp_target_known_op(bp_data, op);
+  bp_resolve_op(bp_data, op);
+  if(OP_ORACLE(op).mispred || OP_ORACLE(op).misfetch) {
+    bp_recover_op(bp_data, op->table_info->cf_type, &op->recovery_info);
+  }
+  bp_data->bp->retire_func(op);
+}
+
+/**************************************************************************************/
+/* Warm up select microarchitectural structures: BP, icache, dcache,
+   and uncore. No wrong path warmup.
+*/
+
+void cmp_warmup(Op* op) {
+  uns  proc_id = op->proc_id;
+  Addr ia      = op->inst_info->addr;
+  Addr va      = OP_ORACLE(op).va;
+
+  // Warmup caches for instructions
+  cmp_warmup_icache(proc_id, ia, FALSE);
 
   // Warmup caches for data
   Flag is_load  = op->table_info->mem_type == MEM_LD;
   Flag is_store = op->table_info->mem_type == MEM_ST;
-  if(is_load || is_store) {
-    Cache*       dcache  = &(cmp_model.dcache_stage[proc_id].dcache);
-    Dcache_Data* dc_data = cache_access(dcache, va, &dummy_line_addr, TRUE);
-    if(dc_data) {
-      // set some fields to meet expectations of the simulation mode
-      if(is_store)
-        dc_data->dirty = TRUE;
-      dc_data->read_count[0] += is_load;
-      dc_data->write_count[0] += is_store;
-    } else {
-      warmup_uncore(proc_id, va, FALSE);
-      Addr repl_line_addr;
-      dc_data = (Dcache_Data*)cache_insert(dcache, proc_id, va,
-                                           &dummy_line_addr, &repl_line_addr);
-      if(dc_data->dirty)
-        warmup_uncore(proc_id, repl_line_addr, TRUE);
-      dc_data->dirty          = is_store;
-      dc_data->read_count[0]  = is_load;
-      dc_data->write_count[0] = is_store;
-    }
-  }
+  if(is_load || is_store)
+    cmp_warmup_dcache(proc_id, va, ia, is_store, FALSE);
 
   // Warmup BP for CF instructions
-  if(op->table_info->cf_type != NOT_CF) {
-    Bp_Data* bp_data = &(cmp_model.bp_data[proc_id]);
-    bp_predict_op(bp_data, op, 1, ia);
-    bp_target_known_op(bp_data, op);
-    bp_resolve_op(bp_data, op);
-    if(op->oracle_info.mispred || op->oracle_info.misfetch) {
-      bp_recover_op(bp_data, op->table_info->cf_type, &op->recovery_info);
-    }
-    bp_data->bp->retire_func(op);
-  }
+  if(op->table_info->cf_type != NOT_CF)
+    cmp_warmup_bp(op);
 }
 
 static void cmp_measure_chip_util() {
@@ -85,6 +85,13 @@ void cmp_done(void);
 void cmp_wake(Op*, Op*, uns8);
 void cmp_retire_hook(Op*);
 void cmp_warmup(Op*);
+void cmp_warmup_icache(uns proc_id, Addr ia, Flag train_pref);
+Dcache_Data* cmp_warmup_dcache(uns proc_id, Addr va, Addr pc, Flag is_store,
+                               Flag train_pref);
+void cmp_warmup_bp(Op*);
+Counter cmp_next_event_cycle(void);
+Counter cmp_signature(void);
+void    cmp_skip_cycle(Counter cycles);
 
 /**************************************************************************************/
 
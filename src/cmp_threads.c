@@ -0,0 +1,333 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : cmp_threads.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Simulation of the cmp cores on parallel host threads.
+ *
+ * With CMP_THREADS > 1, the per-core phases of a chip cycle (see cmp_cycle)
+ * are split among CMP_THREADS host threads.  Core proc_id is always simulated
+ * by thread proc_id % CMP_THREADS, so a core's ops come from and return to
+ * one thread's op pool.  The main simulation thread is thread 0; the other
+ * threads wait on a spinning barrier between phases.
+ *
+ * Everything a core touches while it is simulated is either per core, per
+ * host thread (SIM_THREAD_LOCAL), or shared and guarded by cmp_threads_lock
+ * (the memory system entry points called from the core stages).  The shared
+ * memory system itself is still updated serially between the phases.  Stats
+ * a core keeps in another core's counters (core 0 totals, STAT_EVENT_ALL)
+ * are updated with the atomic SHARED_ stat macros of statistics.h.
+ *
+ * Within a phase, the cores take turns at the shared state in proc_id order:
+ * the first cmp_threads_lock of core proc_id waits until cores 0..proc_id-1
+ * have finished the phase, and the core keeps its turn until it is done.
+ * The memory system therefore sees the calls of each phase in the same order
+ * as the serial simulator, and a core sees the results of the calls of the
+ * lower cores of the same cycle, so runs are reproducible and match
+ * CMP_THREADS=1.  Only the work a core does before its first shared access
+ * overlaps with the other cores.
+ *
+ * With CMP_THREAD_QUANTUM > 1 a phase spans a whole quantum, so taking turns
+ * would serialize the quantum.  The lock is a plain mutex instead and the
+ * calls of different cores reach the memory system in host thread order.
+ * This mode trades reproducibility and timing accuracy for speed.
+ *
+ * Op unique numbers are per core while the threads are on (see
+ * cmp_threads_unique_count), so they do not depend on the thread schedule
+ * in either mode.
+ ***************************************************************************************/
+
+#include "cmp_threads.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "bp/bp.param.h"
+#include "core.param.h"
+#include "dvfs/dvfs.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/l2l1pref.param.h"
+#include "prefetcher/pref.param.h"
+
+#include "bp/bp.h"
+#include "freq.h"
+#include "frontend/frontend_intf.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define CMP_THREADS_SPINS 1024 /* barrier spins before yielding the cpu */
+
+/**************************************************************************************/
+/* Global Variables */
+
+static uns             num_threads = 1;
+static pthread_t*      workers;
+static pthread_mutex_t shared_lock;
+static void (*phase_func)(uns proc_id);
+static Flag phase_running;
+static Flag phase_ordered; /* cores take turns at the shared state */
+static Flag exiting;
+
+/* the core whose turn it is, and the core a host thread is simulating */
+static uns                  turn;
+static SIM_THREAD_LOCAL uns cur_proc_id;
+
+/* sense-reversing barrier over all num_threads threads */
+static uns                  barrier_count;
+static uns                  barrier_sense;
+static SIM_THREAD_LOCAL uns thread_sense;
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static void  cmp_threads_check_config(void);
+static void  barrier_wait(void);
+static void  wait_turn(uns proc_id);
+static void  run_phase(uns thread_id);
+static void* worker_main(void* arg);
+
+/**************************************************************************************/
+/* cmp_threads_init: */
+
+void cmp_threads_init() {
+  num_threads = MAX2(MIN2(CMP_THREADS, NUM_CORES), 1);
+  if(num_threads == 1)
+    return;
+
+  cmp_threads_check_config();
+
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&shared_lock, &attr);
+  pthread_mutexattr_destroy(&attr);
+
+  barrier_count = 0;
+  barrier_sense = 0;
+  thread_sense  = 0;
+  exiting       = FALSE;
+  phase_running = FALSE;
+
+  workers = (pthread_t*)malloc(sizeof(pthread_t) * num_threads);
+  for(uns ii = 1; ii < num_threads; ii++) {
+    if(pthread_create(&workers[ii], NULL, worker_main,
+                      (void*)(uintptr_t)ii))
+      FATAL_ERROR(0, "Could not start cmp thread %u\n", ii);
+  }
+}
+
+/**************************************************************************************/
+/* cmp_threads_check_config: rejects configurations that keep per-core state
+ * in globals that are not thread local. */
+
+static void cmp_threads_check_config() {
+  if(FRONTEND != FE_TRACE)
+    FATAL_ERROR(0, "CMP_THREADS requires the trace frontend\n");
+  if(UOP_CACHE_ENABLE)
+    FATAL_ERROR(0, "CMP_THREADS does not support the uop cache\n");
+  if(EIP_ENABLE || DJOLT_ENABLE || FNLMMA_ENABLE)
+    FATAL_ERROR(0, "CMP_THREADS does not support the EIP, D-JOLT and FNL+MMA "
+                   "prefetchers\n");
+  if(BP_MECH > TAGESCL80_BP ||
+     (LATE_BP_MECH != NUM_BP && LATE_BP_MECH > TAGESCL80_BP))
+    FATAL_ERROR(0, "CMP_THREADS supports the gshare, hybridgp and tage "
+                   "branch predictors only\n");
+  if(ENABLE_BP_CONF)
+    FATAL_ERROR(0, "CMP_THREADS does not support branch confidence\n");
+  if(STREAM_PREFETCH_ON || L2L1PREF_ON || L2WAY_PREF || L2MARKV_PREF_ON)
+    FATAL_ERROR(0, "CMP_THREADS supports the prefetcher framework "
+                   "(PREF_FRAMEWORK_ON) only\n");
+  /* these access the L1 or keep per-core counters in globals from the
+     dcache stage, outside cmp_threads_lock */
+  if(DC_PREF_CACHE_ENABLE || IDEAL_L2_L1_PREFETCHER || CACHE_STAT_ENABLE)
+    FATAL_ERROR(0, "CMP_THREADS does not support DC_PREF_CACHE_ENABLE, "
+                   "IDEAL_L2_L1_PREFETCHER and CACHE_STAT_ENABLE\n");
+  if(WP_COLLECT_STATS)
+    FATAL_ERROR(0, "CMP_THREADS does not support WP_COLLECT_STATS\n");
+  if(DUMB_CORE_ON || PIPEVIEW || MEMVIEW)
+    FATAL_ERROR(0, "CMP_THREADS does not support DUMB_CORE_ON, PIPEVIEW and "
+                   "MEMVIEW\n");
+
+  if(CMP_THREAD_QUANTUM > 1) {
+    if(DVFS_ON)
+      FATAL_ERROR(0, "CMP_THREAD_QUANTUM > 1 does not support DVFS\n");
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      if(freq_get_cycle_time(FREQ_DOMAIN_CORES[proc_id]) !=
+         freq_get_cycle_time(FREQ_DOMAIN_L1))
+        FATAL_ERROR(0, "CMP_THREAD_QUANTUM > 1 requires the cores and the L1 "
+                       "to share one clock\n");
+    }
+  }
+}
+
+/**************************************************************************************/
+/* cmp_threads_done: */
+
+void cmp_threads_done() {
+  if(num_threads == 1)
+    return;
+
+  exiting = TRUE;
+  barrier_wait();
+  for(uns ii = 1; ii < num_threads; ii++)
+    pthread_join(workers[ii], NULL);
+  free(workers);
+  pthread_mutex_destroy(&shared_lock);
+  num_threads = 1;
+}
+
+/**************************************************************************************/
+/* cmp_threads_on: */
+
+Flag cmp_threads_on() {
+  return num_threads > 1;
+}
+
+/**************************************************************************************/
+/* cmp_threads_run: */
+
+void cmp_threads_run(void (*func)(uns proc_id)) {
+  if(num_threads == 1) {
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+      func(proc_id);
+    return;
+  }
+
+  phase_func    = func;
+  phase_running = TRUE;
+  phase_ordered = CMP_THREAD_QUANTUM <= 1;
+  turn          = 0;
+  barrier_wait(); /* release the workers */
+  run_phase(0);
+  barrier_wait(); /* wait for them to finish */
+  phase_running = FALSE;
+}
+
+/**************************************************************************************/
+/* cmp_threads_lock: */
+
+void cmp_threads_lock() {
+  if(!phase_running)
+    return;
+  if(phase_ordered)
+    wait_turn(cur_proc_id);
+  else
+    pthread_mutex_lock(&shared_lock);
+}
+
+/**************************************************************************************/
+/* cmp_threads_unlock: in an ordered phase the core keeps its turn until the
+ * end of the phase. */
+
+void cmp_threads_unlock() {
+  if(phase_running && !phase_ordered)
+    pthread_mutex_unlock(&shared_lock);
+}
+
+/**************************************************************************************/
+/* cmp_threads_unique_count: the unique number of the next op of core
+ * proc_id.  The numbers of the cores are interleaved, so they are unique
+ * across cores and do not depend on the order in which the threads fetch. */
+
+Counter cmp_threads_unique_count(uns proc_id) {
+  return unique_count_per_core[proc_id] * NUM_CORES + proc_id + 1;
+}
+
+/**************************************************************************************/
+/* run_phase: */
+
+static void run_phase(uns thread_id) {
+  for(uns proc_id = thread_id; proc_id < NUM_CORES; proc_id += num_threads) {
+    cur_proc_id  = proc_id;
+    unique_count = cmp_threads_unique_count(proc_id);
+    phase_func(proc_id);
+    if(phase_ordered) {
+      wait_turn(proc_id);
+      __atomic_store_n(&turn, proc_id + 1, __ATOMIC_RELEASE);
+    }
+  }
+}
+
+/**************************************************************************************/
+/* wait_turn: waits until cores 0..proc_id-1 are done with the phase.  The
+ * lower cores of a thread run before proc_id does, and the lower cores of
+ * the other threads only wait for cores below them, so this cannot
+ * deadlock. */
+
+static void wait_turn(uns proc_id) {
+  uns spins = 0;
+  while(__atomic_load_n(&turn, __ATOMIC_ACQUIRE) != proc_id) {
+    if(++spins >= CMP_THREADS_SPINS) {
+      sched_yield();
+      spins = 0;
+    }
+  }
+}
+
+/**************************************************************************************/
+/* worker_main: */
+
+static void* worker_main(void* arg) {
+  uns thread_id = (uns)(uintptr_t)arg;
+
+  thread_sense = 0;
+  while(TRUE) {
+    barrier_wait();
+    if(exiting)
+      break;
+    run_phase(thread_id);
+    barrier_wait();
+  }
+  return NULL;
+}
+
+/**************************************************************************************/
+/* barrier_wait: the last thread to arrive flips the shared sense, which
+ * releases the others.  Phases are short, so waiting threads spin for a
+ * while before they give up the cpu. */
+
+static void barrier_wait() {
+  uns sense    = !thread_sense;
+  thread_sense = sense;
+
+  if(__atomic_add_fetch(&barrier_count, 1, __ATOMIC_ACQ_REL) == num_threads) {
+    __atomic_store_n(&barrier_count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&barrier_sense, sense, __ATOMIC_RELEASE);
+    return;
+  }
+
+  uns spins = 0;
+  while(__atomic_load_n(&barrier_sense, __ATOMIC_ACQUIRE) != sense) {
+    if(++spins >= CMP_THREADS_SPINS) {
+      sched_yield();
+      spins = 0;
+    }
+  }
+}
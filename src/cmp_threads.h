@@ -0,0 +1,59 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : cmp_threads.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Simulation of the cmp cores on parallel host threads
+ ***************************************************************************************/
+
+#ifndef __CMP_THREADS_H__
+#define __CMP_THREADS_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Start the host threads (call once the model is initialized) */
+void cmp_threads_init(void);
+
+/* Stop and join the host threads */
+void cmp_threads_done(void);
+
+/* TRUE if the cores are simulated by more than one host thread */
+Flag cmp_threads_on(void);
+
+/* Call func once for every core, in parallel if cmp threads are on.  Returns
+   when all cores are done. */
+void cmp_threads_run(void (*func)(uns proc_id));
+
+/* Serialize accesses to state that all cores share (the memory system).  The
+   lock is recursive and only taken while cores run in parallel.  With
+   CMP_THREAD_QUANTUM <= 1 the cores get the lock in proc_id order. */
+void cmp_threads_lock(void);
+void cmp_threads_unlock(void);
+
+/* The unique number of the next op of core proc_id while the threads are on */
+Counter cmp_threads_unique_count(uns proc_id);
+
+#endif  // __CMP_THREADS_H__
@@ -0,0 +1,393 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : cycle_skip.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Skipping of quiescent cycles in the main simulation loop.
+ *
+ * When every core is stalled on outstanding DRAM requests, each simulated
+ * cycle repeats the previous one: no op moves and the same set of stall
+ * stats is incremented.  Once two consecutive chip cycles leave the model
+ * quiescent (see the model's next_event_func) with an identical signature
+ * and identical stat increments, the following chip cycles are not
+ * simulated.  Instead their stat increments are credited directly and the
+ * model advances the little per-cycle state it keeps (skip_cycle_func).
+ *
+ * While skipping, the clock jumps straight to the earliest of the model's
+ * next event, the memory system's next event (mem_next_event_time, which
+ * covers the on-chip queues and the DRAM controllers) and the next point at
+ * which the main loop looks at the cycle count or stats (the forward
+ * progress check and the triggers).  The chip and memory cycles in between
+ * are credited in one step.  Skipping stops as soon as a DRAM response
+ * arrives on chip, at the cycle the model reported as its next event, and
+ * whenever a chip cycle coincides with a busy memory cycle and turns out not
+ * to be quiescent.
+ ***************************************************************************************/
+
+#include "cycle_skip.h"
+#include <string.h>
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "dvfs/dvfs.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/pref.param.h"
+
+#include "freq.h"
+#include "memory/memory.h"
+#include "model.h"
+#include "statistics.h"
+#include "trigger.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Stat_Delta_struct {
+  uns       proc_id;
+  Stat_Enum stat;
+  Counter   count;
+} Stat_Delta;
+
+typedef struct Stat_Deltas_struct {
+  Stat_Delta* deltas;
+  uns         num;
+} Stat_Deltas;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Flag        skip_enabled = FALSE;
+static Counter*    stat_snapshot; /* raw stat counts, NUM_CORES x stats */
+static Stat_Deltas stat_deltas[2];
+static uns         cur_deltas;
+static Flag        prev_quiescent; /* last chip cycle ended quiescent */
+static Flag        prev_verified;  /* ... and had a fixed-point signature */
+static Flag        skipping;
+static Counter     skip_until; /* first chip cycle that must be simulated */
+static Counter     jump_time;  /* time of the next step, 0 if not jumping */
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static Flag cycle_skip_supported(void);
+static void take_stat_snapshot(void);
+static Flag collect_stat_deltas(Stat_Deltas* deltas);
+static Flag stat_deltas_equal(const Stat_Deltas* a, const Stat_Deltas* b);
+static void credit_stat_deltas(const Stat_Deltas* deltas, Counter cycles);
+static void run_cycle(void);
+static void plan_jump(void);
+static Counter jump_stat_step(const Stat* stat);
+
+/**************************************************************************************/
+/* cycle_skip_init: */
+
+void cycle_skip_init() {
+  skip_enabled   = QUIESCENCE_SKIP && cycle_skip_supported();
+  prev_quiescent = FALSE;
+  prev_verified  = FALSE;
+  skipping       = FALSE;
+  jump_time      = 0;
+  if(!skip_enabled)
+    return;
+
+  uns num_entries = NUM_CORES * NUM_GLOBAL_STATS;
+  stat_snapshot   = (Counter*)malloc(sizeof(Counter) * num_entries);
+  for(uns ii = 0; ii < 2; ii++) {
+    stat_deltas[ii].deltas = (Stat_Delta*)malloc(sizeof(Stat_Delta) *
+                                                 num_entries);
+    stat_deltas[ii].num    = 0;
+  }
+  cur_deltas = 0;
+}
+
+/**************************************************************************************/
+/* cycle_skip_supported: skipping is only sound if nothing in the model acts
+ * on its own at fixed cycle intervals and all chip clocks tick together. */
+
+static Flag cycle_skip_supported() {
+  if(!model->next_event_func || !model->signature_func ||
+     !model->skip_cycle_func) {
+    WARNINGU_ONCE(0, "QUIESCENCE_SKIP is not supported by the %s model\n",
+                  model->name);
+    return FALSE;
+  }
+
+  if(DUMB_CORE_ON || DVFS_ON || PERF_PRED_ENABLE || L1_PART_ON || PIPEVIEW ||
+     MEMVIEW || DEBUG_MODEL || (PREF_HFILTER_ON && PREF_HFILTER_RESET_ENABLE) ||
+     FDIP_BP_CONFIDENCE || FDIP_ADJUSTABLE_FTQ || FDIP_BLOOM_FILTER) {
+    WARNINGU_ONCE(0, "QUIESCENCE_SKIP disabled: the configuration has "
+                     "periodic per-cycle events\n");
+    return FALSE;
+  }
+
+  if(CMP_THREADS > 1 && CMP_THREAD_QUANTUM > 1) {
+    WARNINGU_ONCE(0, "QUIESCENCE_SKIP disabled: the cores run ahead of the "
+                     "memory system (CMP_THREAD_QUANTUM)\n");
+    return FALSE;
+  }
+
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(freq_get_cycle_time(FREQ_DOMAIN_CORES[proc_id]) !=
+       freq_get_cycle_time(FREQ_DOMAIN_L1)) {
+      WARNINGU_ONCE(0, "QUIESCENCE_SKIP disabled: the cores and the L1 do "
+                       "not share one clock\n");
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* cycle_skip_advance_time: advances time to the next step, jumping over the
+ * cycles that plan_jump found nothing would happen in. */
+
+void cycle_skip_advance_time() {
+  if(!jump_time) {
+    freq_advance_time();
+    return;
+  }
+
+  Counter chip_cycles = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  Counter mem_cycles  = freq_cycle_count(FREQ_DOMAIN_MEMORY);
+  freq_advance_time_to(jump_time);
+  jump_time = 0;
+
+  /* The cycles that start at the new time are handled by cycle_skip_cycle */
+  chip_cycles = freq_cycle_count(FREQ_DOMAIN_CORES[0]) - chip_cycles -
+                freq_is_ready(FREQ_DOMAIN_CORES[0]);
+  mem_cycles = freq_cycle_count(FREQ_DOMAIN_MEMORY) - mem_cycles -
+               freq_is_ready(FREQ_DOMAIN_MEMORY);
+
+  if(chip_cycles) {
+    credit_stat_deltas(&stat_deltas[cur_deltas], chip_cycles);
+    model->skip_cycle_func(chip_cycles);
+    INC_STAT_EVENT(0, QUIESCENT_CYCLES_SKIPPED, chip_cycles);
+  }
+  if(mem_cycles)
+    mem_skip_cycles(mem_cycles);
+}
+
+/**************************************************************************************/
+/* cycle_skip_cycle: simulates (or skips) the current time step. */
+
+void cycle_skip_cycle() {
+  if(!skip_enabled) {
+    model->cycle_func();
+    return;
+  }
+
+  Flag    chip_ready = freq_is_ready(FREQ_DOMAIN_L1);
+  Flag    mem_ready  = freq_is_ready(FREQ_DOMAIN_MEMORY);
+  Counter cycle      = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+
+  if(!chip_ready) {
+    /* Memory-only step: the chip is left untouched unless a DRAM response
+       arrives, which makes the memory system busy. */
+    model->cycle_func();
+    if(skipping && !mem_is_quiescent())
+      skipping = FALSE;
+  } else if(skipping && !mem_ready && cycle < skip_until) {
+    credit_stat_deltas(&stat_deltas[cur_deltas], 1);
+    model->skip_cycle_func(1);
+    STAT_EVENT(0, QUIESCENT_CYCLES_SKIPPED);
+  } else if(skipping) {
+    /* The chip cycle coincides with a memory cycle or the model's next event,
+       so simulate it. The stat increments recorded when skipping started
+       remain valid as long as the model stays quiescent without progress. */
+    Counter sig = model->signature_func();
+    model->cycle_func();
+    skip_until = model->next_event_func();
+    skipping   = skip_until > cycle + 1 && model->signature_func() == sig;
+    prev_quiescent = skipping;
+    prev_verified  = FALSE;
+  } else {
+    run_cycle();
+  }
+
+  if(skipping)
+    plan_jump();
+}
+
+/**************************************************************************************/
+/* plan_jump: sets the time of the next step to the earliest of the model's
+ * next event, the memory system's next event, the next forward progress
+ * check, and the last chip cycle before which no trigger can fire.  A step
+ * that the memory system's next event lands on is simulated; the chip cycles
+ * before it are skipped with the stat increments recorded for them. */
+
+static void plan_jump() {
+  Counter cycle  = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  Counter target = MIN2(skip_until, (cycle / FORWARD_PROGRESS_INTERVAL + 1) *
+                                      FORWARD_PROGRESS_INTERVAL);
+  /* The time triggers move on memory-only steps too, so one chip cycle of
+     slack is kept for them */
+  Counter steps = trigger_steps_to_fire(jump_stat_step);
+  if(steps < target - cycle)
+    target = cycle + steps;
+  if(target <= cycle + 1)
+    return;
+
+  jump_time = MIN2(freq_cycle_start_time(FREQ_DOMAIN_CORES[0], target),
+                   mem_next_event_time());
+}
+
+/**************************************************************************************/
+/* jump_stat_step: returns how much a skipped chip cycle adds to a stat. */
+
+static Counter jump_stat_step(const Stat* stat) {
+  const Stat_Deltas* deltas = &stat_deltas[cur_deltas];
+  for(uns ii = 0; ii < deltas->num; ii++) {
+    const Stat_Delta* delta = &deltas->deltas[ii];
+    if(stat == &global_stat_array[delta->proc_id][delta->stat])
+      return delta->count;
+  }
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(stat == &global_stat_array[proc_id][EXECUTION_TIME] ||
+       stat == &global_stat_array[proc_id][POWER_TIME])
+      return freq_get_cycle_time(FREQ_DOMAIN_CORES[0]);
+  }
+  return 0;
+}
+
+/**************************************************************************************/
+/* run_cycle: simulates a chip cycle, recording its stat increments when the
+ * previous cycle ended quiescent, and starts skipping once two consecutive
+ * cycles agree. Cycles that also tick the memory domain are not recorded:
+ * their stat increments include DRAM activity. */
+
+static void run_cycle() {
+  Counter cycle  = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  Flag    record = prev_quiescent && !freq_is_ready(FREQ_DOMAIN_MEMORY);
+  Counter sig    = 0;
+
+  if(record) {
+    sig = model->signature_func();
+    take_stat_snapshot();
+  }
+
+  model->cycle_func();
+
+  Counter next_event = model->next_event_func();
+  Flag    quiescent  = next_event > cycle + 1;
+
+  Stat_Deltas* cur = &stat_deltas[cur_deltas ^ 1];
+  if(record && quiescent && model->signature_func() == sig &&
+     collect_stat_deltas(cur)) {
+    uns prev   = cur_deltas;
+    cur_deltas = cur_deltas ^ 1;
+    if(prev_verified && stat_deltas_equal(cur, &stat_deltas[prev])) {
+      skipping   = TRUE;
+      skip_until = next_event;
+    }
+    prev_verified = TRUE;
+  } else {
+    prev_verified = FALSE;
+  }
+
+  prev_quiescent = quiescent;
+}
+
+/**************************************************************************************/
+/* take_stat_snapshot: */
+
+static void take_stat_snapshot() {
+  Counter* dst = stat_snapshot;
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    memcpy(dst, global_stat_counts[proc_id],
+           NUM_GLOBAL_STATS * sizeof(Counter));
+    dst += NUM_GLOBAL_STATS;
+  }
+}
+
+/**************************************************************************************/
+/* collect_stat_deltas: records every stat that changed since the last
+ * snapshot.  Returns FALSE if a float stat changed: the difference of two
+ * doubles does not give back the exact increment, so crediting it would not
+ * round the same way as simulating the cycle. */
+
+static Flag collect_stat_deltas(Stat_Deltas* deltas) {
+  const Counter* src = stat_snapshot;
+  deltas->num        = 0;
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    const Stat*       stats  = global_stat_array[proc_id];
+    const Stat_Count* counts = global_stat_counts[proc_id];
+    for(uns ii = 0; ii < NUM_GLOBAL_STATS; ii++, src++) {
+      if(counts[ii].count == *src)
+        continue;
+      if(stats[ii].type == FLOAT_TYPE_STAT)
+        return FALSE;
+      Stat_Delta* delta = &deltas->deltas[deltas->num++];
+      delta->proc_id    = proc_id;
+      delta->stat       = ii;
+      delta->count      = counts[ii].count - *src;
+    }
+  }
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* stat_deltas_equal: */
+
+static Flag stat_deltas_equal(const Stat_Deltas* a, const Stat_Deltas* b) {
+  if(a->num != b->num)
+    return FALSE;
+  for(uns ii = 0; ii < a->num; ii++) {
+    if(a->deltas[ii].proc_id != b->deltas[ii].proc_id ||
+       a->deltas[ii].stat != b->deltas[ii].stat ||
+       a->deltas[ii].count != b->deltas[ii].count)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* credit_stat_deltas: credits the stat increments of the given number of
+ * cycles. */
+
+static void credit_stat_deltas(const Stat_Deltas* deltas, Counter cycles) {
+  for(uns ii = 0; ii < deltas->num; ii++) {
+    const Stat_Delta* delta = &deltas->deltas[ii];
+    global_stat_counts[delta->proc_id][delta->stat].count += delta->count *
+                                                              cycles;
+  }
+}
+
+/**************************************************************************************/
+/* cycle_skip_done: */
+
+void cycle_skip_done() {
+  if(!skip_enabled)
+    return;
+  free(stat_snapshot);
+  for(uns ii = 0; ii < 2; ii++)
+    free(stat_deltas[ii].deltas);
+  skip_enabled = FALSE;
+  jump_time    = 0;
+}
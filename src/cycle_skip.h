@@ -0,0 +1,49 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : cycle_skip.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Skipping of quiescent cycles in the main simulation loop
+ ***************************************************************************************/
+
+#ifndef __CYCLE_SKIP_H__
+#define __CYCLE_SKIP_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Initialize cycle skipping (call after the model is initialized) */
+void cycle_skip_init(void);
+
+/* Call instead of freq_advance_time: jumps over skipped cycles */
+void cycle_skip_advance_time(void);
+
+/* Call every cycle instead of the model's cycle function */
+void cycle_skip_cycle(void);
+
+/* Clean up */
+void cycle_skip_done(void);
+
+#endif  // __CYCLE_SKIP_H__
@@ -51,6 +51,7 @@
 #include "cmp_model.h"
 #include "prefetcher/l2l1pref.h"
 #include "cache_miss_analyzer.h"
+#include "memory/stack_sweep.h"
 
 /**************************************************************************************/
 /* Macros */
@@ -62,7 +63,7 @@
 /**************************************************************************************/
 /* Global Variables */
 
-Dcache_Stage* dc = NULL;
+SIM_THREAD_LOCAL Dcache_Stage* dc = NULL;
 
 /**************************************************************************************/
 /* set_dcache_stage: */
@@ -91,8 +92,14 @@ void init_dcache_stage(uns8 proc_id, const char* name) {
   dc->sd.ops          = (Op**)malloc(sizeof(Op*) * STAGE_MAX_OP_COUNT);
 
   /* initialize the cache structure */
-  init_cache(&dc->dcache, "DCACHE", DCACHE_SIZE, DCACHE_ASSOC, DCACHE_LINE_SIZE,
-             sizeof(Dcache_Data), DCACHE_REPL);
+  dc->dcache = line_cache_create("DCACHE", DCACHE_SIZE, DCACHE_ASSOC,
+                                 DCACHE_LINE_SIZE, sizeof(Dcache_Data),
+                                 DCACHE_REPL);
+  dc->miss_classifier = CLASSIFY_DCACHE_MISSES ?
+                          miss_classifier_create(
+                            line_cache_num_lines(dc->dcache), DCACHE_LINE_SIZE,
+                            MISS_CLASSIFIER_FILTER_BITS) :
+                          NULL;
 
   reset_dcache_stage();
 
@@ -104,12 +111,10 @@ void init_dcache_stage(uns8 proc_id, const char* name) {
                FALSE);
   }
 
-  dc->dcache.repl_pref_thresh = DCACHE_REPL_PREF_THRESH;
-
   if(DC_PREF_CACHE_ENABLE)
-    init_cache(&dc->pref_dcache, "DC_PREF_CACHE", DC_PREF_CACHE_SIZE,
-               DC_PREF_CACHE_ASSOC, DCACHE_LINE_SIZE, sizeof(Dcache_Data),
-               DCACHE_REPL);
+    dc->pref_dcache = line_cache_create(
+      "DC_PREF_CACHE", DC_PREF_CACHE_SIZE, DC_PREF_CACHE_ASSOC,
+      DCACHE_LINE_SIZE, sizeof(Dcache_Data), DCACHE_REPL);
 
   memset(dc->rand_wb_state, 0, NUM_ELEMENTS(dc->rand_wb_state));
 }
@@ -262,7 +267,7 @@ void update_dcache_stage(Stage_Data* src_sd) {
     }
 
     /* compute the bank---the bank bits are the lowest order cache index bits */
-    bank = op->oracle_info.va >> dc->dcache.shift_bits &
+    bank = OP_ORACLE(op).va >> line_cache_shift_bits(dc->dcache) &
            N_BIT_MASK(LOG2(DCACHE_BANKS));
     /* check on the availability of a read port for the given bank */
     DEBUG(dc->proc_id,
@@ -285,19 +290,16 @@ void update_dcache_stage(Stage_Data* src_sd) {
 
     /* now access the dcache with it */
 
-    line = (Dcache_Data*)cache_access(&dc->dcache, op->oracle_info.va,
-                                      &line_addr, TRUE);
-    
-    uns set = (op->oracle_info.va >> dc->dcache.shift_bits) & dc->dcache.set_mask; // get index
-    uns valid_entries = 0;
-    for(uns kk = 0; kk < dc->dcache.assoc; kk++) {
-      Cache_Entry* entry = &dc->dcache.entries[set][kk];
-      if(entry->valid) {
-        valid_entries++;
-      }
-    }
-    int set_full = (valid_entries == dc->dcache.assoc);
-    
+    line = (Dcache_Data*)line_cache_access(dc->dcache, OP_ORACLE(op).va,
+                                           &line_addr, TRUE);
+    Miss_Type miss_type = dc->miss_classifier ?
+                            miss_classifier_access(dc->miss_classifier,
+                                                   OP_ORACLE(op).va,
+                                                   line != NULL) :
+                            MISS_NONE;
+    stack_sweep_access(STACK_SWEEP_LEVEL_DCACHE, dc->proc_id,
+                       OP_ORACLE(op).va);
+
     op->dcache_cycle = cycle_count;
     dc->idle_cycle   = MAX2(dc->idle_cycle, cycle_count + DCACHE_CYCLES);
 
@@ -311,8 +313,8 @@ void update_dcache_stage(Stage_Data* src_sd) {
                                         // insert to the dcache immediately
     }
 
-    op->oracle_info.dcmiss = FALSE;
-    wrongpath_dcmiss       = FALSE;
+    OP_ORACLE(op).dcmiss = FALSE;
+    wrongpath_dcmiss     = FALSE;
     if(PERFECT_DCACHE) {
       if(!op->off_path) {
         STAT_EVENT(op->proc_id, DCACHE_HIT);
@@ -390,8 +392,8 @@ void update_dcache_stage(Stage_Data* src_sd) {
       if(op->table_info->mem_type == MEM_LD) {  // load request
         if(((model->mem == MODEL_MEM) &&
             scan_stores(
-              op->oracle_info.va,
-              op->oracle_info.mem_size))) {  // scan the store forwarding buffer
+              OP_ORACLE(op).va,
+              OP_ORACLE(op).mem_size))) {  // scan the store forwarding buffer
           if(!op->off_path) {
             STAT_EVENT(op->proc_id, DCACHE_ST_BUFFER_HIT);
             STAT_EVENT(op->proc_id, DCACHE_ST_BUFFER_HIT_ONPATH);
@@ -422,42 +424,36 @@ void update_dcache_stage(Stage_Data* src_sd) {
                               ((line_addr >> LOG2(DCACHE_LINE_SIZE)) + 1)
                                 << LOG2(DCACHE_LINE_SIZE);
 
-            extra_line = (Dcache_Data*)cache_access(&dc->dcache, one_more_addr,
-                                                    &extra_line_addr, FALSE);
+            extra_line = (Dcache_Data*)line_cache_access(
+              dc->dcache, one_more_addr, &extra_line_addr, FALSE);
             ASSERT(dc->proc_id, one_more_addr == extra_line_addr);
             if(!extra_line) {
               if(new_mem_req(
                    MRT_DFETCH, dc->proc_id, extra_line_addr, DCACHE_LINE_SIZE,
                    DCACHE_CYCLES - 1 + op->inst_info->extra_ld_latency, NULL,
                    NULL, op->unique_num, 0))
-                STAT_EVENT_ALL(ONE_MORE_SUCESS);
+                SHARED_STAT_EVENT_ALL(ONE_MORE_SUCESS);
               else
-                STAT_EVENT_ALL(ONE_MORE_DISCARDED_MEM_REQ_FULL);
+                SHARED_STAT_EVENT_ALL(ONE_MORE_DISCARDED_MEM_REQ_FULL);
             } else
-              STAT_EVENT_ALL(ONE_MORE_DISCARDED_L0CACHE);
+              SHARED_STAT_EVENT_ALL(ONE_MORE_DISCARDED_L0CACHE);
           }
 
           if(!op->off_path) {
             STAT_EVENT(op->proc_id, DCACHE_MISS);
-            int miss_type = log_cache_miss(op->oracle_info.va, set_full);
-            if(miss_type == 0){
-              STAT_EVENT(op->proc_id, DCACHE_MISS_COMPULSORY);
-            } else if (miss_type == 1){
-              STAT_EVENT(op->proc_id, DCACHE_MISS_CAPACITY);
-            } else if (miss_type == 2){
-              STAT_EVENT(op->proc_id, DCACHE_MISS_CONFLICT);
-            }
+            if(miss_type != MISS_NONE)
+              STAT_EVENT(op->proc_id, DCACHE_MISS_COMPULSORY + miss_type);
             STAT_EVENT(op->proc_id, DCACHE_MISS_ONPATH);
             STAT_EVENT(op->proc_id, DCACHE_MISS_LD_ONPATH);
-            op->oracle_info.dcmiss = TRUE;
+            OP_ORACLE(op).dcmiss = TRUE;
             STAT_EVENT(op->proc_id, DCACHE_MISS_LD);
           } else {
             wrongpath_dcmiss = TRUE;
             STAT_EVENT(op->proc_id, DCACHE_MISS_OFFPATH);
             STAT_EVENT(op->proc_id, DCACHE_MISS_LD_OFFPATH);
           }
-          op->state              = OS_MISS;
-          op->engine_info.dcmiss = TRUE;
+          op->state            = OS_MISS;
+          OP_ENGINE(op).dcmiss = TRUE;
         } else {
           op->state = OS_WAIT_MEM;  // go into this state if no miss buffer is
                                     // available
@@ -485,34 +481,28 @@ void update_dcache_stage(Stage_Data* src_sd) {
                               ((line_addr >> LOG2(DCACHE_LINE_SIZE)) + 1)
                                 << LOG2(DCACHE_LINE_SIZE);
 
-            extra_line = (Dcache_Data*)cache_access(&dc->dcache, one_more_addr,
-                                                    &extra_line_addr, FALSE);
+            extra_line = (Dcache_Data*)line_cache_access(
+              dc->dcache, one_more_addr, &extra_line_addr, FALSE);
             ASSERT(dc->proc_id, one_more_addr == extra_line_addr);
             if(!extra_line) {
               if(new_mem_req(
                    MRT_DPRF, dc->proc_id, extra_line_addr, DCACHE_LINE_SIZE,
                    DCACHE_CYCLES - 1 + op->inst_info->extra_ld_latency, NULL,
                    NULL, op->unique_num, 0))
-                STAT_EVENT_ALL(ONE_MORE_SUCESS);
+                SHARED_STAT_EVENT_ALL(ONE_MORE_SUCESS);
               else
-                STAT_EVENT_ALL(ONE_MORE_DISCARDED_MEM_REQ_FULL);
+                SHARED_STAT_EVENT_ALL(ONE_MORE_DISCARDED_MEM_REQ_FULL);
             } else
-              STAT_EVENT_ALL(ONE_MORE_DISCARDED_L0CACHE);
+              SHARED_STAT_EVENT_ALL(ONE_MORE_DISCARDED_L0CACHE);
           }
 
           if(!op->off_path) {
             STAT_EVENT(op->proc_id, DCACHE_MISS);
-            int miss_type = log_cache_miss(op->oracle_info.va, set_full);
-            if(miss_type == 0){
-              STAT_EVENT(op->proc_id, DCACHE_MISS_COMPULSORY);
-            } else if (miss_type == 1){
-              STAT_EVENT(op->proc_id, DCACHE_MISS_CAPACITY);
-            } else if (miss_type == 2){
-              STAT_EVENT(op->proc_id, DCACHE_MISS_CONFLICT);
-            }
+            if(miss_type != MISS_NONE)
+              STAT_EVENT(op->proc_id, DCACHE_MISS_COMPULSORY + miss_type);
             STAT_EVENT(op->proc_id, DCACHE_MISS_ONPATH);
             STAT_EVENT(op->proc_id, DCACHE_MISS_LD_ONPATH);
-            op->oracle_info.dcmiss = TRUE;
+            OP_ORACLE(op).dcmiss = TRUE;
             STAT_EVENT(op->proc_id, DCACHE_MISS_LD);
           } else {
             wrongpath_dcmiss = TRUE;
@@ -551,34 +541,28 @@ void update_dcache_stage(Stage_Data* src_sd) {
                               ((line_addr >> LOG2(DCACHE_LINE_SIZE)) + 1)
                                 << LOG2(DCACHE_LINE_SIZE);
 
-            extra_line = (Dcache_Data*)cache_access(&dc->dcache, one_more_addr,
-                                                    &extra_line_addr, FALSE);
+            extra_line = (Dcache_Data*)line_cache_access(
+              dc->dcache, one_more_addr, &extra_line_addr, FALSE);
             ASSERT(dc->proc_id, one_more_addr == extra_line_addr);
             if(!extra_line) {
               if(new_mem_req(
                    MRT_DFETCH, dc->proc_id, extra_line_addr, DCACHE_LINE_SIZE,
                    DCACHE_CYCLES - 1 + op->inst_info->extra_ld_latency, NULL,
                    NULL, op->unique_num, 0))
-                STAT_EVENT_ALL(ONE_MORE_SUCESS);
+                SHARED_STAT_EVENT_ALL(ONE_MORE_SUCESS);
               else
-                STAT_EVENT_ALL(ONE_MORE_DISCARDED_MEM_REQ_FULL);
+                SHARED_STAT_EVENT_ALL(ONE_MORE_DISCARDED_MEM_REQ_FULL);
             } else
-              STAT_EVENT_ALL(ONE_MORE_DISCARDED_L0CACHE);
+              SHARED_STAT_EVENT_ALL(ONE_MORE_DISCARDED_L0CACHE);
           }
 
           if(!op->off_path) {
             STAT_EVENT(op->proc_id, DCACHE_MISS);
-            int miss_type = log_cache_miss(op->oracle_info.va, set_full);
-            if(miss_type == 0){
-              STAT_EVENT(op->proc_id, DCACHE_MISS_COMPULSORY);
-            } else if (miss_type == 1){
-              STAT_EVENT(op->proc_id, DCACHE_MISS_CAPACITY);
-            } else if (miss_type == 2){
-              STAT_EVENT(op->proc_id, DCACHE_MISS_CONFLICT);
-            }
+            if(miss_type != MISS_NONE)
+              STAT_EVENT(op->proc_id, DCACHE_MISS_COMPULSORY + miss_type);
             STAT_EVENT(op->proc_id, DCACHE_MISS_ONPATH);
             STAT_EVENT(op->proc_id, DCACHE_MISS_ST_ONPATH);
-            op->oracle_info.dcmiss = TRUE;
+            OP_ORACLE(op).dcmiss = TRUE;
             STAT_EVENT(op->proc_id, DCACHE_MISS_ST);
           } else {
             wrongpath_dcmiss = TRUE;
@@ -602,7 +586,7 @@ void update_dcache_stage(Stage_Data* src_sd) {
     }
 
     if(STREAM_PREFETCH_ON &&
-       ((op->oracle_info.dcmiss == TRUE) ||
+       ((OP_ORACLE(op).dcmiss == TRUE) ||
         (STREAM_TRAIN_ON_WRONGPATH && (wrongpath_dcmiss == TRUE)))) {
       _DEBUG(dc->proc_id, DEBUG_STREAM_MEM,
              "dl0 miss : line_addr :%d op_count %lld  type :%d\n",
@@ -625,7 +609,7 @@ void update_dcache_stage(Stage_Data* src_sd) {
 /* dcache_fill_line: */
 
 Flag dcache_fill_line(Mem_Req* req) {
-  uns bank = req->addr >> dc->dcache.shift_bits &
+  uns bank = req->addr >> line_cache_shift_bits(dc->dcache) &
              N_BIT_MASK(LOG2(DCACHE_BANKS));
   Dcache_Data* data;
   Addr         line_addr, repl_line_addr;
@@ -659,8 +643,9 @@ Flag dcache_fill_line(Mem_Req* req) {
           (int)(req->addr >> LOG2(DCACHE_LINE_SIZE)), req->op_count,
           (req->op_count ? req->oldest_op_unique_num : -1));
 
-    data = (Dcache_Data*)cache_insert(&dc->pref_dcache, dc->proc_id, req->addr,
-                                      &line_addr, &repl_line_addr);
+    data = (Dcache_Data*)line_cache_insert(dc->pref_dcache, dc->proc_id,
+                                           req->addr, &line_addr,
+                                           &repl_line_addr);
     ASSERT(dc->proc_id, req->emitted_cycle);
     ASSERT(dc->proc_id, cycle_count >= req->emitted_cycle);
     // mark the data as HW_prefetch if prefetch mark it as
@@ -671,8 +656,8 @@ Flag dcache_fill_line(Mem_Req* req) {
        that we won't be able to insert the writeback into the
        memory system. */
     Flag repl_line_valid;
-    data = (Dcache_Data*)get_next_repl_line(&dc->dcache, dc->proc_id, req->addr,
-                                            &repl_line_addr, &repl_line_valid);
+    data = (Dcache_Data*)line_cache_next_repl_line(
+      dc->dcache, dc->proc_id, req->addr, &repl_line_addr, &repl_line_valid);
     if(repl_line_valid && data->dirty) {
       /* need to do a write-back */
       uns repl_proc_id = get_proc_id_from_cmp_addr(repl_line_addr);
@@ -711,8 +696,8 @@ Flag dcache_fill_line(Mem_Req* req) {
       STAT_EVENT(dc->proc_id, DCACHE_WB_REQ);
     }
 
-    data = (Dcache_Data*)cache_insert(&dc->dcache, dc->proc_id, req->addr,
-                                      &line_addr, &repl_line_addr);
+    data = (Dcache_Data*)line_cache_insert(dc->dcache, dc->proc_id, req->addr,
+                                           &line_addr, &repl_line_addr);
     DEBUG(dc->proc_id,
           "Filling dcache  off_path:%d addr:0x%s  :%7d index:%7d op_count:%d "
           "oldest:%lld\n",
@@ -787,7 +772,7 @@ Flag dcache_fill_line(Mem_Req* req) {
 
     if(op->unique_num == *op_unique && op->op_pool_valid) {
       DEBUG(dc->proc_id, "Awakening op_num:%lld %d %d\n", op->op_num,
-            op->engine_info.l1_miss_satisfied, op->in_rdy_list);
+            OP_ENGINE(op).l1_miss_satisfied, op->in_rdy_list);
       ASSERT(dc->proc_id, !op->in_rdy_list);
 
       op->done_cycle = cycle_count + 1;
@@ -823,8 +808,8 @@ Flag dcache_fill_line(Mem_Req* req) {
 
 Flag do_oracle_dcache_access(Op* op, Addr* line_addr) {
   Dcache_Data* hit;
-  hit = (Dcache_Data*)cache_access(&dc->dcache, op->oracle_info.va, line_addr,
-                                   FALSE);
+  hit = (Dcache_Data*)line_cache_access(dc->dcache, OP_ORACLE(op).va,
+                                        line_addr, FALSE);
 
   if(hit)
     return TRUE;
@@ -868,7 +853,7 @@ void wp_process_dcache_hit(Dcache_Data* line, Op* op) {
       DEBUG(0,
             "Dcache hit: On path hits off path. va:%s op:%s op:0x%s wp_op:0x%s "
             "opu:%s wpu:%s dist:%s%s\n",
-            hexstr64s(op->oracle_info.va), disasm_op(op, TRUE),
+            hexstr64s(OP_ORACLE(op).va), disasm_op(op, TRUE),
             hexstr64s(op->inst_info->addr), hexstr64s(line->offpath_op_addr),
             unsstr64(op->unique_num), unsstr64(line->offpath_op_unique),
             op->unique_num > line->offpath_op_unique ? " " : "-",
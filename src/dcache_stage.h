@@ -29,6 +29,9 @@
 #ifndef __DCACHE_STAGE_H__
 #define __DCACHE_STAGE_H__
 
+#include "cache_miss_analyzer.h"
+#include "globals/global_defs.h"
+#include "libs/cache_engine_c.h"
 #include "libs/cache_lib.h"
 #include "stage_data.h"
 
@@ -45,9 +48,10 @@ typedef struct Dcache_Stage_struct {
   uns8       proc_id;
   Stage_Data sd; /* stage interface data */
 
-  Cache  dcache;      /* the data cache */
+  Line_Cache* dcache; /* the data cache */
   Ports* ports;       /* read and write ports to the data cache (per bank) */
-  Cache  pref_dcache; /* prefetcher cache for data cache */
+  Line_Cache* pref_dcache; /* prefetcher cache for data cache */
+  Miss_Classifier* miss_classifier; /* 3C classifier (NULL if disabled) */
 
   Counter idle_cycle;  /* Cycle the cache will be idle */
   Flag    mem_blocked; /* Are memory request buffers (aka MSHRs) full? */
@@ -82,7 +86,7 @@ typedef struct Dcache_Data_struct {
 /**************************************************************************************/
 /* External variables */
 
-extern Dcache_Stage* dc;
+extern SIM_THREAD_LOCAL Dcache_Stage* dc;
 
 /**************************************************************************************/
 /* Prototypes */
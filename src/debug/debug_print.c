@@ -207,8 +207,8 @@ void print_op_field(FILE* stream, Op* op, uns field) {
                     op->replay ? 'r' : ' ');
         }
         if(op->table_info->cf_type) {
-          Flag bits = op->oracle_info.mispred << 2 |
-                      op->oracle_info.misfetch << 1 | op->oracle_info.btb_miss;
+          Flag bits = OP_ORACLE(op).mispred << 2 |
+                      OP_ORACLE(op).misfetch << 1 | OP_ORACLE(op).btb_miss;
           switch(bits) {
             case 0x4:
               fprintf(stream, "P|");
@@ -242,16 +242,16 @@ void print_op_field(FILE* stream, Op* op, uns field) {
     case OP_NUM_FIELD:
       if(op)
         fprintf(stream, "o:%-3d %3d%c %3d%c %3d%c|", (int)(op->op_num % 1000),
-                op->oracle_info.num_srcs > 0 ?
-                  (int)(op->oracle_info.src_info[0].op_num % 1000) :
+                OP_ORACLE(op).num_srcs > 0 ?
+                  (int)(OP_ORACLE(op).src_info[0].op_num % 1000) :
                   -1,
                 ((op->srcs_not_rdy_vector & 1) == 0 ? 'r' : 'w'),
-                op->oracle_info.num_srcs > 1 ?
-                  (int)(op->oracle_info.src_info[1].op_num % 1000) :
+                OP_ORACLE(op).num_srcs > 1 ?
+                  (int)(OP_ORACLE(op).src_info[1].op_num % 1000) :
                   -1,
                 ((op->srcs_not_rdy_vector & 2) == 0 ? 'r' : 'w'),
-                op->oracle_info.num_srcs > 2 ?
-                  (int)(op->oracle_info.src_info[2].op_num % 1000) :
+                OP_ORACLE(op).num_srcs > 2 ?
+                  (int)(OP_ORACLE(op).src_info[2].op_num % 1000) :
                   -1,
                 ((op->srcs_not_rdy_vector & 4) == 0 ? 'r' : 'w'));
       else
@@ -271,14 +271,14 @@ void print_op_field(FILE* stream, Op* op, uns field) {
         Counter addr_dep = 0;
         Counter data_dep = 0;
         uns     ii;
-        for(ii = 0; ii < op->oracle_info.num_srcs; ii++) {
-          Src_Info* src = &op->oracle_info.src_info[ii];
+        for(ii = 0; ii < OP_ORACLE(op).num_srcs; ii++) {
+          Src_Info* src = &OP_ORACLE(op).src_info[ii];
           if(src->type == MEM_ADDR_DEP)
             addr_dep = src->op_num;
           if(src->type == MEM_DATA_DEP)
             data_dep = src->op_num;
         }
-        fprintf(stream, "va:%-9s %3d %3d|", hexstr64s(op->oracle_info.va),
+        fprintf(stream, "va:%-9s %3d %3d|", hexstr64s(OP_ORACLE(op).va),
                 (uns)(addr_dep % 1000), (uns)(data_dep % 1000));
       }
       break;
@@ -391,9 +391,9 @@ void print_func_op(Op* op) {
   print_reg_array(buf, op->inst_info->dests, op->table_info->num_dest_regs);
   fprintf(GLOBAL_DEBUG_STREAM, "  out: %-30s", buf);
 
-  if(op->oracle_info.mem_size) {
-    fprintf(GLOBAL_DEBUG_STREAM, "  %2d @ %08x", op->oracle_info.mem_size,
-            (uns32)op->oracle_info.va);
+  if(OP_ORACLE(op).mem_size) {
+    fprintf(GLOBAL_DEBUG_STREAM, "  %2d @ %08x", OP_ORACLE(op).mem_size,
+            (uns32)OP_ORACLE(op).va);
   }
 
   fprintf(GLOBAL_DEBUG_STREAM, "\n");
@@ -465,17 +465,17 @@ char* disasm_op(Op* op, Flag wide) {
     i += sprintf(&buf[i], "(");
     i += print_reg_array(&buf[i], op->inst_info->srcs,
                          op->table_info->num_src_regs);
-    if(op->table_info->mem_type == MEM_LD && op->oracle_info.mem_size > 0) {
-      i += sprintf(&buf[i], " %d@%08x", op->oracle_info.mem_size,
-                   (int)op->oracle_info.va);
+    if(op->table_info->mem_type == MEM_LD && OP_ORACLE(op).mem_size > 0) {
+      i += sprintf(&buf[i], " %d@%08x", OP_ORACLE(op).mem_size,
+                   (int)OP_ORACLE(op).va);
     }
     if(op->table_info->num_src_regs + op->table_info->num_dest_regs > 0)
       i += sprintf(&buf[i], " ->");
     i += print_reg_array(&buf[i], op->inst_info->dests,
                          op->table_info->num_dest_regs);
-    if(op->table_info->mem_type == MEM_ST && op->oracle_info.mem_size > 0) {
-      i += sprintf(&buf[i], " %d@%08x", op->oracle_info.mem_size,
-                   (int)op->oracle_info.va);
+    if(op->table_info->mem_type == MEM_ST && OP_ORACLE(op).mem_size > 0) {
+      i += sprintf(&buf[i], " %d@%08x", OP_ORACLE(op).mem_size,
+                   (int)OP_ORACLE(op).va);
     }
     i += sprintf(&buf[i], " )");
   }
@@ -0,0 +1,452 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : decode_cache.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Decoded uops of the static instructions of a trace, kept in a
+ *                file across runs.
+ *
+ * The uop generator decodes a static instruction into uops the first time each
+ * core runs into it and keeps the result in the Inst_Info table of the core
+ * (libs/cpp_hash_lib_wrapper.cc). On traces with a large code footprint this
+ * is a good part of the run, and it is the same work in every run over the
+ * trace. With DECODE_CACHE_FILE set, a run writes the uops of every
+ * instruction it decoded to that file, and later runs map the file read-only
+ * and copy the uops of an instruction out of it instead of generating them.
+ * The Table_Infos are used in place, so every core running the same code (and
+ * every concurrent run, through the page cache) shares one copy.
+ *
+ * The file is laid out as
+ *
+ *   header | records | registers
+ *
+ * with one record per uop, sorted by (address, instruction bytes, uop index),
+ * so the uops of an instruction are contiguous and one binary search finds
+ * them all. The registers of a record (sources, then destinations) live in a
+ * separate array to keep the records small. Addresses are the ones the
+ * frontend reports, not cmp addresses. The instruction bytes tell apart code
+ * rewritten at the same address, as in the Inst_Info table, but nothing in the
+ * key identifies the binary: use one file per trace.
+ *
+ * A run that decodes instructions missing from the file writes a new file
+ * holding both, to a temporary file that then replaces the old one, so
+ * concurrent runs always see a complete file. Gather/scatter instructions are
+ * never cached because their uops change from one execution to the next.
+ * Latencies come from the configuration of the run that loads the file. The
+ * only other parameter decoding depends on, IGNORE_BAR_FETCH, is recorded in
+ * the header, and a file written with another value is left alone.
+ ***************************************************************************************/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "decode_cache.h"
+#include "general.param.h"
+#include "libs/cpp_hash_lib_wrapper.h"
+#include "statistics.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Decode_Cache_Header_struct {
+  char  magic[DECODE_CACHE_MAGIC_SIZE];
+  uns32 version;
+  uns32 record_size;
+  uns32 table_info_size;
+  uns32 ignore_bar_fetch;
+  uns64 num_records;
+  uns64 num_regs;
+} Decode_Cache_Header;
+
+typedef struct Decode_Cache_Reg_struct {
+  uns16 id;
+  uns16 reg;
+} Decode_Cache_Reg;
+
+/* One uop of a static instruction */
+typedef struct Decode_Cache_Record_struct {
+  uns64      addr;
+  uns64      lsb_bytes;
+  uns64      msb_bytes;
+  Table_Info table_info;
+  uns32      regs;  // first source in the register array
+  uns32      store_seq_num;
+  uns8       op_idx;
+  uns8       num_uop;  // only set for op 0, as in the Inst_Info table
+  uns8       inst_size;
+  uns8       load_seq_num;
+} Decode_Cache_Record;
+
+/* A record on its way into a new file, with where its registers come from */
+typedef struct Decode_Cache_Staged_struct {
+  Decode_Cache_Record     record;
+  const Decode_Cache_Reg* regs;  // registers of a record of the mapped file
+  const Inst_Info*        info;  // or the Inst_Info the uop was decoded into
+} Decode_Cache_Staged;
+
+typedef struct Decode_Cache_Stage_struct {
+  Decode_Cache_Staged* entries;
+  uns64                count;
+  uns64                capacity;
+} Decode_Cache_Stage;
+
+/**************************************************************************************/
+/* Global Variables */
+
+extern int op_type_delays[NUM_OP_TYPES];
+
+static const Decode_Cache_Record* records;
+static const Decode_Cache_Reg*    regs;
+static uns64                      num_records;
+static Flag                       enabled;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static int  decode_cache_record_cmp(const Decode_Cache_Record* a,
+                                    const Decode_Cache_Record* b);
+static int  decode_cache_staged_cmp(const void* a, const void* b);
+static Flag decode_cache_same_inst(const Decode_Cache_Record* a,
+                                   const Decode_Cache_Record* b);
+static const Decode_Cache_Record* decode_cache_find(const ctype_pin_inst* pi);
+static void decode_cache_copy(const Decode_Cache_Record* record, Addr addr,
+                              Inst_Info* info);
+static Decode_Cache_Staged* decode_cache_stage(Decode_Cache_Stage* stage);
+static void decode_cache_stage_inst_info(uint64_t addr, uint64_t lsb_bytes,
+                                         uint64_t msb_bytes, uint8_t op_idx,
+                                         Inst_Info* info, void* arg);
+static void decode_cache_write(Decode_Cache_Stage* stage);
+
+/**************************************************************************************/
+/* init_decode_cache */
+
+void init_decode_cache(void) {
+  records     = NULL;
+  regs        = NULL;
+  num_records = 0;
+  enabled     = DECODE_CACHE_FILE != NULL;
+  if(!enabled)
+    return;
+
+  int fd = open(DECODE_CACHE_FILE, O_RDONLY);
+  if(fd < 0)
+    return;  // first run over the trace
+  struct stat st;
+  if(fstat(fd, &st) || st.st_size < (off_t)sizeof(Decode_Cache_Header)) {
+    close(fd);
+    WARNINGU(0, "Decode cache %s is truncated, rebuilding it\n",
+             DECODE_CACHE_FILE);
+    return;
+  }
+  void* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED)
+    FATAL_ERROR(0, "Could not map decode cache %s\n", DECODE_CACHE_FILE);
+
+  const Decode_Cache_Header* header = (const Decode_Cache_Header*)map;
+  if(memcmp(header->magic, DECODE_CACHE_MAGIC, DECODE_CACHE_MAGIC_SIZE) ||
+     header->version != DECODE_CACHE_VERSION ||
+     header->record_size != sizeof(Decode_Cache_Record) ||
+     header->table_info_size != sizeof(Table_Info) ||
+     st.st_size != (off_t)(sizeof(Decode_Cache_Header) +
+                           header->num_records * sizeof(Decode_Cache_Record) +
+                           header->num_regs * sizeof(Decode_Cache_Reg))) {
+    WARNINGU(0, "Decode cache %s is damaged or from another build, "
+                "rebuilding it\n", DECODE_CACHE_FILE);
+    munmap(map, st.st_size);
+    return;
+  }
+  if(header->ignore_bar_fetch != IGNORE_BAR_FETCH) {
+    WARNINGU(0, "Decode cache %s was written with another IGNORE_BAR_FETCH, "
+                "not using it\n", DECODE_CACHE_FILE);
+    munmap(map, st.st_size);
+    enabled = FALSE;
+    return;
+  }
+
+  /* Stays mapped for the rest of the run: the Inst_Infos filled in from it
+     point to its Table_Infos */
+  num_records = header->num_records;
+  records     = (const Decode_Cache_Record*)(header + 1);
+  regs        = (const Decode_Cache_Reg*)(records + num_records);
+  printf("Loaded %llu decoded uops from %s\n", num_records, DECODE_CACHE_FILE);
+}
+
+/**************************************************************************************/
+/* decode_cache_fill */
+
+Flag decode_cache_fill(uns proc_id, const ctype_pin_inst* pi, Inst_Info* info) {
+  if(!enabled)
+    return FALSE;
+
+  const Decode_Cache_Record* first = decode_cache_find(pi);
+  Flag hit = first && first->num_uop > 0 && first->inst_size == pi->size &&
+             first->num_uop <= num_records - (first - records);
+  for(uns ii = 1; hit && ii < first->num_uop; ii++)
+    hit = decode_cache_same_inst(first, first + ii) && first[ii].op_idx == ii;
+  if(!hit) {
+    STAT_EVENT(proc_id, DECODE_CACHE_MISS);
+    return FALSE;
+  }
+
+  Addr addr = convert_to_cmp_addr(proc_id, pi->instruction_addr);
+  for(uns ii = 0; ii < first->num_uop; ii++) {
+    Flag       new_entry;
+    Inst_Info* uop_info = ii == 0 ? info :
+                                    cpp_hash_table_access_create(
+                                      proc_id, pi->instruction_addr,
+                                      pi->inst_binary_lsb, pi->inst_binary_msb,
+                                      ii, &new_entry);
+    decode_cache_copy(first + ii, addr, uop_info);
+  }
+  STAT_EVENT(proc_id, DECODE_CACHE_HIT);
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* decode_cache_done */
+
+void decode_cache_done(void) {
+  if(!enabled)
+    return;
+
+  Decode_Cache_Stage stage;
+  memset(&stage, 0, sizeof(stage));
+  for(uns64 ii = 0; ii < num_records; ii++) {
+    Decode_Cache_Staged* staged = decode_cache_stage(&stage);
+    staged->record              = records[ii];
+    staged->regs                = regs + records[ii].regs;
+  }
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    cpp_hash_table_scan(proc_id, decode_cache_stage_inst_info, &stage);
+
+  /* Every core decodes the instructions it runs, so most of them are staged
+     more than once (all copies are the same) */
+  qsort(stage.entries, stage.count, sizeof(Decode_Cache_Staged),
+        decode_cache_staged_cmp);
+  uns64 count = 0;
+  for(uns64 ii = 0; ii < stage.count; ii++) {
+    if(count && !decode_cache_record_cmp(&stage.entries[count - 1].record,
+                                         &stage.entries[ii].record))
+      continue;
+    stage.entries[count++] = stage.entries[ii];
+  }
+  stage.count = count;
+
+  if(stage.count > num_records)
+    decode_cache_write(&stage);
+  free(stage.entries);
+}
+
+/**************************************************************************************/
+/* decode_cache_write */
+
+static void decode_cache_write(Decode_Cache_Stage* stage) {
+  Decode_Cache_Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, DECODE_CACHE_MAGIC, DECODE_CACHE_MAGIC_SIZE);
+  header.version          = DECODE_CACHE_VERSION;
+  header.record_size      = sizeof(Decode_Cache_Record);
+  header.table_info_size  = sizeof(Table_Info);
+  header.ignore_bar_fetch = IGNORE_BAR_FETCH;
+  header.num_records      = stage->count;
+  for(uns64 ii = 0; ii < stage->count; ii++) {
+    Decode_Cache_Record* record = &stage->entries[ii].record;
+    record->regs                = header.num_regs;
+    header.num_regs += record->table_info.num_src_regs +
+                       record->table_info.num_dest_regs;
+  }
+
+  char tmp_path[MAX_STR_LENGTH + 1];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", DECODE_CACHE_FILE,
+           (int)getpid());
+  FILE* file = fopen(tmp_path, "wb");
+  if(!file) {
+    WARNINGU(0, "Could not write decode cache %s\n", tmp_path);
+    return;
+  }
+  Flag ok = fwrite(&header, sizeof(header), 1, file) == 1;
+  for(uns64 ii = 0; ok && ii < stage->count; ii++)
+    ok = fwrite(&stage->entries[ii].record, sizeof(Decode_Cache_Record), 1,
+                file) == 1;
+  for(uns64 ii = 0; ok && ii < stage->count; ii++) {
+    const Decode_Cache_Staged* staged  = &stage->entries[ii];
+    uns                        num_src = staged->record.table_info.num_src_regs;
+    uns num_regs = num_src + staged->record.table_info.num_dest_regs;
+    Decode_Cache_Reg reg_buf[MAX_SRCS + MAX_DESTS];
+    for(uns jj = 0; jj < num_regs; jj++) {
+      if(staged->regs) {
+        reg_buf[jj] = staged->regs[jj];
+      } else {
+        const Reg_Info* reg = jj < num_src ? &staged->info->srcs[jj] :
+                                             &staged->info->dests[jj - num_src];
+        reg_buf[jj].id  = reg->id;
+        reg_buf[jj].reg = reg->reg;
+      }
+    }
+    ok = fwrite(reg_buf, sizeof(Decode_Cache_Reg), num_regs, file) == num_regs;
+  }
+  ok &= fclose(file) == 0;
+
+  if(!ok || rename(tmp_path, DECODE_CACHE_FILE)) {
+    WARNINGU(0, "Could not write decode cache %s\n", DECODE_CACHE_FILE);
+    unlink(tmp_path);
+    return;
+  }
+  printf("Saved %llu decoded uops to %s\n", header.num_records,
+         DECODE_CACHE_FILE);
+}
+
+/**************************************************************************************/
+/* decode_cache_find: first uop of pi, or NULL */
+
+static const Decode_Cache_Record* decode_cache_find(const ctype_pin_inst* pi) {
+  Decode_Cache_Record key;
+  key.addr      = pi->instruction_addr;
+  key.lsb_bytes = pi->inst_binary_lsb;
+  key.msb_bytes = pi->inst_binary_msb;
+  key.op_idx    = 0;
+
+  uns64 lo = 0;
+  uns64 hi = num_records;
+  while(lo < hi) {
+    uns64 mid = lo + (hi - lo) / 2;
+    if(decode_cache_record_cmp(&records[mid], &key) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if(lo == num_records || decode_cache_record_cmp(&records[lo], &key))
+    return NULL;
+  return &records[lo];
+}
+
+/**************************************************************************************/
+/* decode_cache_copy: builds the Inst_Info of a uop as convert_t_uop_to_info()
+   does */
+
+static void decode_cache_copy(const Decode_Cache_Record* record, Addr addr,
+                              Inst_Info* info) {
+  const Table_Info*       table_info = &record->table_info;
+  const Decode_Cache_Reg* reg        = regs + record->regs;
+
+  memset(info, 0, sizeof(Inst_Info));
+  info->addr        = addr;
+  info->uop_seq_num = record->op_idx;
+  /* Read-only: nothing writes the Table_Info of a decoded instruction */
+  info->table_info = (Table_Info*)table_info;
+
+  for(uns ii = 0; ii < table_info->num_src_regs; ii++, reg++) {
+    info->srcs[ii].type = INT_REG;
+    info->srcs[ii].id   = reg->id;
+    info->srcs[ii].reg  = reg->reg;
+  }
+  for(uns ii = 0; ii < table_info->num_dest_regs; ii++, reg++) {
+    info->dests[ii].type = INT_REG;
+    info->dests[ii].id   = reg->id;
+    info->dests[ii].reg  = reg->reg;
+  }
+
+  info->latency = op_type_delays[table_info->op_type];
+  if(info->latency == 0)
+    info->latency = 1;
+
+  info->trace_info.inst_size     = record->inst_size;
+  info->trace_info.num_uop       = record->num_uop;
+  info->trace_info.load_seq_num  = record->load_seq_num;
+  info->trace_info.store_seq_num = record->store_seq_num;
+
+  info->fake_inst        = FALSE;
+  info->fake_inst_reason = WPNM_NOT_IN_WPNM;
+}
+
+/**************************************************************************************/
+/* Staging */
+
+static Decode_Cache_Staged* decode_cache_stage(Decode_Cache_Stage* stage) {
+  if(stage->count == stage->capacity) {
+    stage->capacity = stage->capacity ? 2 * stage->capacity : 1024;
+    stage->entries  = (Decode_Cache_Staged*)realloc(
+      stage->entries, stage->capacity * sizeof(Decode_Cache_Staged));
+    ASSERT(0, stage->entries);
+  }
+  Decode_Cache_Staged* staged = &stage->entries[stage->count++];
+  memset(staged, 0, sizeof(Decode_Cache_Staged));
+  return staged;
+}
+
+static void decode_cache_stage_inst_info(uint64_t addr, uint64_t lsb_bytes,
+                                         uint64_t msb_bytes, uint8_t op_idx,
+                                         Inst_Info* info, void* arg) {
+  if(!info->table_info || info->trace_info.is_gather_scatter)
+    return;
+
+  Decode_Cache_Staged* staged = decode_cache_stage((Decode_Cache_Stage*)arg);
+  Decode_Cache_Record* record = &staged->record;
+  record->addr                = addr;
+  record->lsb_bytes           = lsb_bytes;
+  record->msb_bytes           = msb_bytes;
+  record->store_seq_num       = info->trace_info.store_seq_num;
+  record->op_idx              = op_idx;
+  record->num_uop             = info->trace_info.num_uop;
+  record->inst_size           = info->trace_info.inst_size;
+  record->load_seq_num        = info->trace_info.load_seq_num;
+  staged->info                = info;
+  /* byte for byte, padding included, so that runs write the same file (the
+     uop generator zeroes the Table_Infos it allocates) */
+  memcpy(&record->table_info, info->table_info, sizeof(Table_Info));
+}
+
+/**************************************************************************************/
+/* Record order */
+
+static int decode_cache_record_cmp(const Decode_Cache_Record* a,
+                                   const Decode_Cache_Record* b) {
+  if(a->addr != b->addr)
+    return a->addr < b->addr ? -1 : 1;
+  if(a->lsb_bytes != b->lsb_bytes)
+    return a->lsb_bytes < b->lsb_bytes ? -1 : 1;
+  if(a->msb_bytes != b->msb_bytes)
+    return a->msb_bytes < b->msb_bytes ? -1 : 1;
+  return (int)a->op_idx - (int)b->op_idx;
+}
+
+static int decode_cache_staged_cmp(const void* a, const void* b) {
+  return decode_cache_record_cmp(&((const Decode_Cache_Staged*)a)->record,
+                                 &((const Decode_Cache_Staged*)b)->record);
+}
+
+static Flag decode_cache_same_inst(const Decode_Cache_Record* a,
+                                   const Decode_Cache_Record* b) {
+  return a->addr == b->addr && a->lsb_bytes == b->lsb_bytes &&
+         a->msb_bytes == b->msb_bytes;
+}
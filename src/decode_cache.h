@@ -0,0 +1,66 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : decode_cache.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Decoded uops of the static instructions of a trace, kept in a
+ *                file across runs.
+ ***************************************************************************************/
+
+#ifndef __DECODE_CACHE_H__
+#define __DECODE_CACHE_H__
+
+#include "globals/global_types.h"
+#include "inst_info.h"
+
+/**************************************************************************************/
+/* Defines */
+
+#define DECODE_CACHE_MAGIC "SCRBDCDC"
+#define DECODE_CACHE_MAGIC_SIZE 8
+/* Bump whenever the layout of the file or of Table_Info changes */
+#define DECODE_CACHE_VERSION 1
+
+/**************************************************************************************/
+/* Prototypes */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maps DECODE_CACHE_FILE, if there is one */
+void init_decode_cache(void);
+/* Fills in the Inst_Infos of every uop of pi (op 0 is info, the others are
+   created in the Inst_Info table of proc_id) from the cache. Returns FALSE if
+   pi is not in the cache. Must be called before the addresses of pi are
+   converted to cmp addresses. */
+Flag decode_cache_fill(uns proc_id, const ctype_pin_inst* pi, Inst_Info* info);
+/* Writes DECODE_CACHE_FILE again if this run decoded instructions that were
+   not in it */
+void decode_cache_done(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __DECODE_CACHE_H__ */
@@ -63,8 +63,8 @@
 /**************************************************************************************/
 /* Global Variables */
 
-Decode_Stage* dec = NULL;
-bool decode_off_path;
+SIM_THREAD_LOCAL Decode_Stage* dec = NULL;
+SIM_THREAD_LOCAL bool          decode_off_path;
 
 /**************************************************************************************/
 /* Local prototypes */
@@ -245,7 +245,7 @@ void decode_stage_process_op(Op* op) {
   if(cf) {
     DEBUG(dec->proc_id, "Decode CF instruction bar:%i fetch_addr:%llx op_num:%llu recover:%i\n",
           op->table_info->bar_type & BAR_FETCH ? TRUE : FALSE, op->inst_info->addr, op->op_num,
-          op->oracle_info.recover_at_decode);
+          OP_ORACLE(op).recover_at_decode);
     // it is a direct branch, so the target is now known
     if (cf <= CF_CALL) {
       bp_target_known_op(g_bp_data, op);
@@ -253,15 +253,15 @@ void decode_stage_process_op(Op* op) {
     // If the CF was unconditional and direct and taken and there was a BTB miss
     // we can schedule a redirect. If the branch was not taken we are on the on-path.
     // If the branch is condidtional or indirect, we will schedule recovery at exec
-    if (op->oracle_info.recover_at_decode) {
+    if (OP_ORACLE(op).recover_at_decode) {
       bp_sched_recovery(bp_recovery_info, op, cycle_count,
                         /*late_bp_recovery=*/FALSE, /*force_offpath=*/FALSE);
 
       // After recovery remove misfetch/mispred/btb_miss flags so it does not trigger flush by exec again
-      op->oracle_info.misfetch = FALSE;
-      op->oracle_info.btb_miss = FALSE;
-      op->oracle_info.pred = op->oracle_info.dir;
-      op->oracle_info.mispred = FALSE;
+      OP_ORACLE(op).misfetch = FALSE;
+      OP_ORACLE(op).btb_miss = FALSE;
+      OP_ORACLE(op).pred = OP_ORACLE(op).dir;
+      OP_ORACLE(op).mispred = FALSE;
 
       // stats for the reason of resteer
       STAT_EVENT(dec->proc_id, RESTEER_BTB_MISS_CF_BR + cf);
@@ -292,3 +292,14 @@ int get_decode_stages_filled(void) {
   }
   return full_stages;
 }
+
+/**************************************************************************************/
+/* decode_stage_signature: folds the occupancy of every decode latch into one
+ * value.  Used to detect cycles in which no op moves through the stage. */
+
+Counter decode_stage_signature() {
+  Counter sig = 0;
+  for(int ii = 0; ii < STAGE_MAX_DEPTH; ii++)
+    sig = sig * 31 + dec->sds[ii].op_count;
+  return sig;
+}
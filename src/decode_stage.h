@@ -29,6 +29,7 @@
 #ifndef __DECODE_STAGE_H__
 #define __DECODE_STAGE_H__
 
+#include "globals/global_defs.h"
 #include "stage_data.h"
 
 
@@ -47,7 +48,7 @@ typedef struct Decode_Stage_struct {
 /**************************************************************************************/
 /* External Variables */
 
-extern Decode_Stage* dec;
+extern SIM_THREAD_LOCAL Decode_Stage* dec;
 
 
 /**************************************************************************************/
@@ -65,6 +66,7 @@ void decode_stage_process_op(Op*);
 
 // For stats
 int get_decode_stages_filled(void);
+Counter decode_stage_signature(void);
 
 /**************************************************************************************/
 
@@ -49,11 +49,11 @@ std::vector<bool> per_core_stalled;
 std::vector<uint64_t> per_core_ftq_ft_num;
 
 //per_core pointers
-std::deque<FT> *df_ftq;
-int *off_path;
-int *sched_off_path;
-int set_proc_id;
-std::vector<decoupled_fe_iter> *ftq_iterator;
+SIM_THREAD_LOCAL std::deque<FT> *df_ftq;
+SIM_THREAD_LOCAL int *off_path;
+SIM_THREAD_LOCAL int *sched_off_path;
+SIM_THREAD_LOCAL int set_proc_id;
+SIM_THREAD_LOCAL std::vector<decoupled_fe_iter> *ftq_iterator;
 //need to overwrite op->op_num with decoupeld fe
 
 bool trace_mode;
@@ -132,9 +132,9 @@ void recover_decoupled_fe(int proc_id) {
     per_core_stalled[set_proc_id] = false;
   }
 
-  if (op->oracle_info.recover_at_decode)
+  if (OP_ORACLE(op).recover_at_decode)
     STAT_EVENT(proc_id, FTQ_RECOVER_DECODE);
-  else if (op->oracle_info.recover_at_exec)
+  else if (OP_ORACLE(op).recover_at_exec)
     STAT_EVENT(proc_id, FTQ_RECOVER_EXEC);
 
   uint64_t offpath_cycles = cycle_count - per_core_redirect_cycle[proc_id];
@@ -158,7 +158,7 @@ void update_decoupled_fe() {
   uns cf_num = 0;
   uint64_t bytes_this_cycle = 0;
   uint64_t cfs_taken_this_cycle = 0;
-  static int fwd_progress = 0;
+  static SIM_THREAD_LOCAL int fwd_progress = 0;
   fwd_progress++;
   if (fwd_progress >= 100000) {
     std::cout << "No forward progress for 1000000 cycles" << std::endl;
@@ -231,41 +231,41 @@ void update_decoupled_fe() {
       pred_addr = bp_predict_op(g_bp_data, op, cf_num++, op->inst_info->addr);
       DEBUG(set_proc_id,
             "Predict CF fetch_addr:%llx true_npc:%llx pred_npc:%lx mispred:%i misfetch:%i btb miss:%i taken:%i recover_at_decode:%i recover_at_exec:%i off_path:%i bar_fetch:%i\n",
-            op->inst_info->addr, op->oracle_info.npc, pred_addr,
-            op->oracle_info.mispred, op->oracle_info.misfetch,
-            op->oracle_info.btb_miss, op->oracle_info.pred == TAKEN,
-            op->oracle_info.recover_at_decode, op->oracle_info.recover_at_exec,
+            op->inst_info->addr, OP_ORACLE(op).npc, pred_addr,
+            OP_ORACLE(op).mispred, OP_ORACLE(op).misfetch,
+            OP_ORACLE(op).btb_miss, OP_ORACLE(op).pred == TAKEN,
+            OP_ORACLE(op).recover_at_decode, OP_ORACLE(op).recover_at_exec,
             *off_path, op->table_info->bar_type & BAR_FETCH);
 
       /* On fetch barrier stall the frontend. Ignore BTB misses here as the exec frontend cannot
          handle recovery/execution until syscalls retire. This is ok as stalling causes the same
          cycle penalty than recovering from BTB miss. */
       if ((op->table_info->bar_type & BAR_FETCH) || IS_CALLSYS(op->table_info)) {
-        op->oracle_info.recover_at_decode = FALSE;
-        op->oracle_info.recover_at_exec = FALSE;
+        OP_ORACLE(op).recover_at_decode = FALSE;
+        OP_ORACLE(op).recover_at_exec = FALSE;
         decoupled_fe_stall(op);
       }
 
-      if(op->oracle_info.recover_at_decode || op->oracle_info.recover_at_exec) {
-        ASSERT(0, (int)op->oracle_info.recover_at_decode + (int)op->oracle_info.recover_at_exec < 2);
+      if(OP_ORACLE(op).recover_at_decode || OP_ORACLE(op).recover_at_exec) {
+        ASSERT(0, (int)OP_ORACLE(op).recover_at_decode + (int)OP_ORACLE(op).recover_at_exec < 2);
         /* If already on the off-path do not schedule recovery as scarab cannot recover OOO
            (An older op may recover at exec and a younger op may recover at decode)
            This is not accurate but it should not affect the time spend on the off-path */
         if (*off_path) {
-          op->oracle_info.recover_at_decode = FALSE;
-          op->oracle_info.recover_at_exec = FALSE;
+          OP_ORACLE(op).recover_at_decode = FALSE;
+          OP_ORACLE(op).recover_at_exec = FALSE;
         }
         *off_path = true;
         frontend_redirect(set_proc_id, op->inst_uid, pred_addr);
         per_core_redirect_cycle[set_proc_id] = cycle_count;
       }
       // If we are already on the off-path redirect on all taken branches in TRACE-MODE
-      else if (trace_mode && *off_path && op->oracle_info.pred == TAKEN) {
+      else if (trace_mode && *off_path && OP_ORACLE(op).pred == TAKEN) {
         frontend_redirect(set_proc_id, op->inst_uid, pred_addr);
       }
     }
     else {
-      ASSERT(0,!(op->oracle_info.recover_at_decode | op->oracle_info.recover_at_exec));
+      ASSERT(0,!(OP_ORACLE(op).recover_at_decode | OP_ORACLE(op).recover_at_exec));
       /* On fetch barrier stall the frontend. */
       if (op->table_info->bar_type & BAR_FETCH) {
         decoupled_fe_stall(op);
@@ -281,7 +281,7 @@ void update_decoupled_fe() {
       uns offset = ADDR_PLUS_OFFSET(op->inst_info->addr, op->inst_info->trace_info.inst_size) -
                     ROUND_DOWN(op->inst_info->addr, ICACHE_LINE_SIZE);
       bool end_of_icache_line = offset >= ICACHE_LINE_SIZE;
-      bool cf_taken = op->table_info->cf_type && op->oracle_info.pred == TAKEN;
+      bool cf_taken = op->table_info->cf_type && OP_ORACLE(op).pred == TAKEN;
       bool bar_fetch = IS_CALLSYS(op->table_info) || op->table_info->bar_type & BAR_FETCH;
 
       if (op->exit) {
@@ -309,9 +309,9 @@ void update_decoupled_fe() {
         // sanity check of consecutivity
         Op* last_op = df_ftq->back().ops.back();
         if (df_ftq->back().ft_info.dynamic_info.ended_by == FT_TAKEN_BRANCH) {
-          ASSERT(set_proc_id, last_op->oracle_info.pred_npc == per_core_current_ft_to_push[set_proc_id].ft_info.static_info.start);
+          ASSERT(set_proc_id, OP_ORACLE(last_op).pred_npc == per_core_current_ft_to_push[set_proc_id].ft_info.static_info.start);
         } else if (df_ftq->back().ft_info.dynamic_info.ended_by == FT_BAR_FETCH) {
-          ASSERT(set_proc_id, last_op->oracle_info.pred_npc == per_core_current_ft_to_push[set_proc_id].ft_info.static_info.start ||
+          ASSERT(set_proc_id, OP_ORACLE(last_op).pred_npc == per_core_current_ft_to_push[set_proc_id].ft_info.static_info.start ||
                               last_op->inst_info->addr + last_op->inst_info->trace_info.inst_size == per_core_current_ft_to_push[set_proc_id].ft_info.static_info.start);
         } else {
           ASSERT(set_proc_id, last_op->inst_info->addr + last_op->inst_info->trace_info.inst_size == per_core_current_ft_to_push[set_proc_id].ft_info.static_info.start);
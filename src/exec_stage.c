@@ -59,9 +59,9 @@
 /**************************************************************************************/
 /* Global Variables */
 
-Exec_Stage* exec = NULL;
-int         op_type_delays[NUM_OP_TYPES];
-int         exec_off_path;
+SIM_THREAD_LOCAL Exec_Stage* exec = NULL;
+int                          op_type_delays[NUM_OP_TYPES];
+SIM_THREAD_LOCAL int         exec_off_path;
 /**************************************************************************************/
 /* Prototypes */
 
@@ -403,21 +403,21 @@ void update_exec_stage(Stage_Data* src_sd) {
         bp_resolve_op(g_bp_data, op);
       }
 
-      if (op->oracle_info.recover_at_exec){
+      if (OP_ORACLE(op).recover_at_exec){
         bp_sched_recovery(bp_recovery_info, op, op->exec_cycle,
                           /*late_bp_recovery=*/FALSE, /*force_offpath=*/FALSE);
         if(!op->off_path)
           op->recovery_scheduled = TRUE;
 
         // stats for the reason of resteer
-        if(op->oracle_info.mispred)
+        if(OP_ORACLE(op).mispred)
           STAT_EVENT(op->proc_id, RESTEER_MISPRED_NOT_CF + op->table_info->cf_type);
         else
           STAT_EVENT(op->proc_id, RESTEER_MISFETCH_NOT_CF + op->table_info->cf_type);
 
       }
       /*      else if(op->table_info->cf_type >= CF_IBR &&
-                op->oracle_info.no_target) {
+                OP_ORACLE(op).no_target) {
         ASSERT(bp_recovery_info->proc_id,
                bp_recovery_info->proc_id == op->proc_id);
         bp_sched_redirect(bp_recovery_info, op, op->exec_cycle);
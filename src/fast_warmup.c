@@ -0,0 +1,286 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : fast_warmup.c
+ * Author       : HPS Research Group
+ * Date         :
+ * Description  : Functional warmup that feeds trace records straight into the
+ *                caches, uop cache, branch predictor and prefetchers.
+ *
+ * The regular warmup (uop_sim() in WARMUP_MODE) fetches every uop through
+ * the frontend and hands it to the model's warmup_func. Here each trace record
+ * is decoded once through the uop generator's Inst_Info table (no Ops are
+ * built) and then drives, in program order:
+ *
+ *  - the icache, dcache, MLC and L1, with the data prefetchers trained through
+ *    the same pref_common hooks as in simulation mode,
+ *  - the uop cache, one fetch target (FT) at a time,
+ *  - the branch predictor, BTB and indirect target predictor, using one
+ *    scratch Op per core for the control flow instructions.
+ *
+ * Cache lookups are batched: back-to-back accesses to the line a core touched
+ * last skip the tag lookup. Nothing else can touch a private cache in between,
+ * so with true LRU replacement this leaves the cache state unchanged.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "bp/bp.param.h"
+#include "cmp_model.h"
+#include "core.param.h"
+#include "ctype_pin_inst.h"
+#include "fast_warmup.h"
+#include "frontend/frontend_intf.h"
+#include "frontend/pin_trace_fe.h"
+#include "isa/isa_macros.h"
+#include "memory/memory.param.h"
+#include "pin/pin_lib/uop_generator.h"
+#include "prefetcher/pref_common.h"
+#include "uop_cache.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Fast_Warmup_Core_struct {
+  ctype_pin_inst pi;
+  Op             op; /* scratch op for the branch predictor */
+  Op_Cold        op_cold;
+
+  /* last line accessed in the private caches, for batching */
+  Addr         icache_line;
+  Addr         dcache_line;
+  Dcache_Data* dcache_data;
+
+  /* FT being built for the uop cache */
+  FT_Info ft_info;
+  Addr*   ft_inst_addrs;
+  uns*    ft_inst_sizes;
+  uns*    ft_inst_n_uops;
+  uns     ft_num_insts;
+} Fast_Warmup_Core;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Fast_Warmup_Core* fast_warmup_cores;
+static Flag              batch_icache;
+static Flag              batch_dcache;
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static void fast_warmup_data(uns proc_id, Addr va, Addr pc, Flag is_store);
+static void fast_warmup_bp(uns proc_id, Inst_Info* info, Flag taken);
+static void fast_warmup_uop_cache(uns proc_id, Inst_Info* info, uns num_uops,
+                                  Flag taken);
+
+/**************************************************************************************/
+/* fast_warmup_init */
+
+void fast_warmup_init(void) {
+  ASSERTM(0, FRONTEND == FE_TRACE,
+          "FAST_WARMUP requires the trace frontend\n");
+  ASSERTM(0, SIM_MODEL == CMP_MODEL, "FAST_WARMUP requires the cmp model\n");
+
+  fast_warmup_cores = (Fast_Warmup_Core*)calloc(NUM_CORES,
+                                                sizeof(Fast_Warmup_Core));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Fast_Warmup_Core* core = &fast_warmup_cores[proc_id];
+    core->op.cold          = &core->op_cold;
+    core->op.mbp7_info     = NULL;
+    core->ft_inst_addrs    = (Addr*)malloc(ICACHE_LINE_SIZE * sizeof(Addr));
+    core->ft_inst_sizes    = (uns*)malloc(ICACHE_LINE_SIZE * sizeof(uns));
+    core->ft_inst_n_uops   = (uns*)malloc(ICACHE_LINE_SIZE * sizeof(uns));
+  }
+
+  /* a repeated hit only refreshes the timestamp of the MRU line under true
+     LRU; other policies (and the icache usefulness stats) see every hit */
+  batch_icache = cmp_model.icache_stage[0].icache.repl_policy ==
+                   REPL_TRUE_LRU &&
+                 !WP_COLLECT_STATS;
+  batch_dcache = line_cache_repl_policy(cmp_model.dcache_stage[0].dcache) ==
+                 REPL_TRUE_LRU;
+}
+
+/**************************************************************************************/
+/* fast_warmup_inst */
+
+Flag fast_warmup_inst(uns proc_id) {
+  Fast_Warmup_Core* core = &fast_warmup_cores[proc_id];
+  ctype_pin_inst*   pi   = &core->pi;
+
+  if(!trace_fetch_warmup_inst(proc_id, pi))
+    return FALSE;
+
+  uns        num_uops;
+  Inst_Info* info = uop_generator_decode_inst(proc_id, pi, &num_uops);
+  Addr       ia   = pi->instruction_addr;
+  Cf_Type    cf_type = info->table_info->cf_type;
+  Flag       taken   = cf_type &&
+                 (cf_type != CF_CBR || pi->actually_taken);
+
+  // Warmup caches for instructions
+  Addr icache_line = ROUND_DOWN(ia, ICACHE_LINE_SIZE);
+  if(!batch_icache || icache_line != core->icache_line) {
+    cmp_warmup_icache(proc_id, ia, TRUE);
+    core->icache_line = icache_line;
+  }
+
+  // Warmup caches for data
+  for(uns ii = 0; ii < pi->num_ld; ii++)
+    fast_warmup_data(proc_id, pi->ld_vaddr[ii], ia, FALSE);
+  for(uns ii = 0; ii < pi->num_st; ii++)
+    fast_warmup_data(proc_id, pi->st_vaddr[ii], ia, TRUE);
+
+  // Warmup BP for CF instructions
+  if(cf_type != NOT_CF)
+    fast_warmup_bp(proc_id, info, taken);
+
+  fast_warmup_uop_cache(proc_id, info, num_uops, taken);
+
+  op_count[proc_id] += num_uops;
+  return !trace_read_done[proc_id];
+}
+
+/**************************************************************************************/
+/* fast_warmup_data: a load or store; repeated accesses to the last dcache
+   line only update the line and train the dl0 prefetchers. */
+
+static void fast_warmup_data(uns proc_id, Addr va, Addr pc, Flag is_store) {
+  Fast_Warmup_Core* core = &fast_warmup_cores[proc_id];
+  Addr              line = ROUND_DOWN(va, DCACHE_LINE_SIZE);
+
+  if(batch_dcache && core->dcache_data && line == core->dcache_line) {
+    Dcache_Data* dc_data = core->dcache_data;
+    if(is_store)
+      dc_data->dirty = TRUE;
+    dc_data->read_count[0] += !is_store;
+    dc_data->write_count[0] += is_store;
+    set_dcache_stage(&cmp_model.dcache_stage[proc_id]);
+    pref_dl0_hit(line, pc);
+    return;
+  }
+
+  core->dcache_data = cmp_warmup_dcache(proc_id, va, pc, is_store, TRUE);
+  core->dcache_line = line;
+}
+
+/**************************************************************************************/
+/* fast_warmup_bp: fill in the fields of the scratch op the branch predictor
+   reads, the way the uop generator sets them up for the last uop. */
+
+static void fast_warmup_bp(uns proc_id, Inst_Info* info, Flag taken) {
+  Fast_Warmup_Core* core = &fast_warmup_cores[proc_id];
+  ctype_pin_inst*   pi   = &core->pi;
+  Op*               op   = &core->op;
+
+  memset(&OP_ORACLE(op), 0, sizeof(OP_ORACLE(op)));
+  memset(&op->recovery_info, 0, sizeof(op->recovery_info));
+  op->proc_id    = proc_id;
+  op->inst_info  = info;
+  op->table_info = info->table_info;
+  op->op_num     = op_count[proc_id];
+  op->inst_uid   = pi->inst_uid;
+  op->bom        = info->uop_seq_num == 0;
+  op->eom        = TRUE;
+  op->off_path   = FALSE;
+
+  OP_ORACLE(op).inst_info  = info;
+  OP_ORACLE(op).table_info = info->table_info;
+  OP_ORACLE(op).dir        = taken ? TAKEN : NOT_TAKEN;
+  OP_ORACLE(op).npc        = pi->instruction_next_addr;
+  /* removing proc_id from target before compare with zero */
+  OP_ORACLE(op).target = convert_to_cmp_addr(0, pi->branch_target) ?
+                             pi->branch_target :
+                             pi->instruction_next_addr;
+
+  cmp_warmup_bp(op);
+}
+
+/**************************************************************************************/
+/* fast_warmup_uop_cache: add the instruction to the current FT and warm the
+   uop cache with the FT once it ends. FTs end where the decoupled frontend
+   ends them on the correct path. */
+
+static void fast_warmup_uop_cache(uns proc_id, Inst_Info* info, uns num_uops,
+                                  Flag taken) {
+  if(!UOP_CACHE_ENABLE)
+    return;
+
+  Fast_Warmup_Core* core = &fast_warmup_cores[proc_id];
+  ctype_pin_inst*   pi   = &core->pi;
+  Addr              ia   = pi->instruction_addr;
+
+  if(core->ft_num_insts == 0) {
+    memset(&core->ft_info, 0, sizeof(core->ft_info));
+    core->ft_info.static_info.start = ia;
+  }
+  ASSERT(proc_id, core->ft_num_insts < ICACHE_LINE_SIZE);
+  core->ft_inst_addrs[core->ft_num_insts]  = ia;
+  core->ft_inst_sizes[core->ft_num_insts]  = pi->size;
+  core->ft_inst_n_uops[core->ft_num_insts] = num_uops;
+  core->ft_num_insts++;
+  core->ft_info.static_info.n_uops += num_uops;
+
+  uns offset = ADDR_PLUS_OFFSET(ia, pi->size) -
+               ROUND_DOWN(ia, ICACHE_LINE_SIZE);
+  Flag bar_fetch = IS_CALLSYS(info->table_info) ||
+                   info->table_info->bar_type & BAR_FETCH;
+  FT_Ended_By ft_ended_by = FT_NOT_ENDED;
+  if(bar_fetch)
+    ft_ended_by = FT_BAR_FETCH;
+  else if(taken)
+    ft_ended_by = FT_TAKEN_BRANCH;
+  else if(offset >= ICACHE_LINE_SIZE)
+    ft_ended_by = FT_ICACHE_LINE_BOUNDARY;
+
+  if(ft_ended_by == FT_NOT_ENDED)
+    return;
+
+  core->ft_info.static_info.length = ia + pi->size -
+                                     core->ft_info.static_info.start;
+  core->ft_info.dynamic_info.ended_by = ft_ended_by;
+  uop_cache_warmup_ft(proc_id, core->ft_info, core->ft_inst_addrs,
+                      core->ft_inst_sizes, core->ft_inst_n_uops,
+                      core->ft_num_insts);
+  core->ft_num_insts = 0;
+}
+
+/**************************************************************************************/
+/* fast_warmup_done */
+
+void fast_warmup_done(void) {
+  pref_warmup_done();
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Fast_Warmup_Core* core = &fast_warmup_cores[proc_id];
+    free(core->ft_inst_addrs);
+    free(core->ft_inst_sizes);
+    free(core->ft_inst_n_uops);
+  }
+  free(fast_warmup_cores);
+  fast_warmup_cores = NULL;
+}
@@ -0,0 +1,44 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : fast_warmup.h
+ * Author       : HPS Research Group
+ * Date         :
+ * Description  : Functional warmup that feeds trace records straight into the
+ *                caches, uop cache, branch predictor and prefetchers.
+ ***************************************************************************************/
+
+#ifndef __FAST_WARMUP_H__
+#define __FAST_WARMUP_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+void fast_warmup_init(void);
+/* Warms up with the next instruction of core proc_id. Returns FALSE if that
+   was the last instruction of the trace. */
+Flag fast_warmup_inst(uns proc_id);
+void fast_warmup_done(void);
+
+#endif /* #ifndef __FAST_WARMUP_H__ */
@@ -180,6 +180,38 @@ void freq_advance_time(void) {
   }
 }
 
+void freq_advance_time_to(Counter new_time) {
+  ASSERT(0, new_time > cur_time);
+  Counter time_delta = new_time - cur_time;
+  Flag    any_ready  = FALSE;
+
+  cur_time = new_time;
+  INC_STAT_EVENT_ALL(EXECUTION_TIME, time_delta);
+  INC_STAT_EVENT_ALL(POWER_TIME, time_delta);
+  DEBUG(0, "Advancing time to %lld fs\n", cur_time);
+
+  for(uns i = 0; i < num_domains; i++) {
+    Domain_Info* domain = &domains[i];
+    if(domain->time_until_next_cycle == 0)
+      domain->time_until_next_cycle = domain->cycle_time;
+    if(time_delta < domain->time_until_next_cycle) {
+      domain->time_until_next_cycle -= time_delta;
+      continue;
+    }
+    /* The domain starts a cycle at the time left until its next cycle and
+       every cycle time after that, up to the new time */
+    Counter after_next_cycle = time_delta - domain->time_until_next_cycle;
+    Counter cycles_after     = after_next_cycle / domain->cycle_time;
+    Counter time_after       = after_next_cycle % domain->cycle_time;
+    domain->cycles += 1 + cycles_after;
+    domain->time_until_next_cycle = time_after ?
+                                      domain->cycle_time - time_after :
+                                      0;
+    any_ready |= domain->time_until_next_cycle == 0;
+  }
+  ASSERT(0, any_ready);
+}
+
 void freq_reset_cycle_counts(void) {
   for(uns i = 0; i < num_domains; i++) {
     domains[i].cycles                = 0;
@@ -196,6 +228,10 @@ Counter freq_time(void) {
   return cur_time;
 }
 
+void freq_set_time(Counter time) {
+  cur_time = time;
+}
+
 Counter freq_future_time(Freq_Domain_Id id, Counter cycles) {
   ASSERT(0, id < num_domains);
   ASSERT(0, domains[id].cycles <= cycles);
@@ -203,6 +239,19 @@ Counter freq_future_time(Freq_Domain_Id id, Counter cycles) {
   return freq_time() + (cycles - domains[id].cycles) * domains[id].cycle_time;
 }
 
+Counter freq_cycle_start_time(Freq_Domain_Id id, Counter cycles) {
+  ASSERT(0, id < num_domains);
+  Domain_Info* domain = &domains[id];
+
+  if(domain->time_until_next_cycle == 0) {
+    ASSERT(0, domain->cycles <= cycles);
+    return cur_time + (cycles - domain->cycles) * domain->cycle_time;
+  }
+  ASSERT(0, domain->cycles < cycles);
+  return cur_time + domain->time_until_next_cycle +
+         (cycles - domain->cycles - 1) * domain->cycle_time;
+}
+
 void freq_set_cycle_time(Freq_Domain_Id id, uns cycle_time) {
   ASSERT(0, id < num_domains);
   ASSERT(0, cycle_time > 0);
@@ -257,4 +306,5 @@ void freq_done(void) {
   for(uns i = 0; i < num_domains; i++) {
     free(domains[i].name);
   }
+  num_domains = 0;
 }
@@ -61,6 +61,11 @@ Flag freq_is_ready(Freq_Domain_Id id);
    ready to be simulated */
 void freq_advance_time(void);
 
+/* Advance time straight to the specified future time, as if
+   freq_advance_time were called until the current time reached it
+   (the time must be the start of a cycle of some domain) */
+void freq_advance_time_to(Counter new_time);
+
 /* Reset cycle time of each domain to zero but keep the time value. */
 void freq_reset_cycle_counts(void);
 
@@ -70,11 +75,19 @@ Counter freq_cycle_count(Freq_Domain_Id id);
 /* Returns the current simulation time (in femtoseconds) */
 Counter freq_time(void);
 
+/* Sets the current simulation time (for restoring a warmup checkpoint) */
+void freq_set_time(Counter time);
+
 /* Returns the future simulation time (in femtoseconds) when the
    specified domain reaches the specified cycle count (without
    changing its frequency) */
 Counter freq_future_time(Freq_Domain_Id, Counter cycle_count);
 
+/* Returns the simulation time at which the specified domain starts
+   the specified cycle (the current cycle if the domain is ready,
+   otherwise a future one) */
+Counter freq_cycle_start_time(Freq_Domain_Id id, Counter cycle_count);
+
 /* Sets the cycle time of the specified frequency domain (takes effect
    on the next cycle of that domain) */
 void freq_set_cycle_time(Freq_Domain_Id, uns cycle_time);
@@ -36,6 +36,7 @@
 #include "globals/global_vars.h"
 #include "icache_stage.h"
 #include "op.h"
+#include "pin/pin_lib/uop_generator.h"
 #include "pin_exec_driven_fe.h"
 #include "pin_trace_fe.h"
 #include "sim.h"
@@ -103,6 +104,7 @@ void frontend_done(Flag* retired_exit) {
       ASSERT(0, 0);
       break;
   }
+  uop_generator_done();
 }
 
 Addr frontend_next_fetch_addr(uns proc_id) {
@@ -41,45 +41,88 @@ extern "C" {
 #include "frontend/pin_exec_driven_fe.h"
 #include "pin/pin_lib/message_queue_interface_lib.h"
 #include "pin/pin_lib/pin_scarab_common_lib.h"
+#include "pin/pin_lib/shm_ring.h"
 #include "pin/pin_lib/uop_generator.h"
 
 #include <time.h>
 
-extern int *off_path;
+extern SIM_THREAD_LOCAL int* off_path;
 
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_PIN_EXEC_DRIVEN, ##args)
 
 Server*                          server;
 std::vector<ScarabOpBuffer_type> cached_cop_buffers;
+/* With PIN_EXEC_DRIVEN_FE_SHM_RING the op buffer of a core is the published
+   batch of its ring and the ops are used in place */
+std::vector<ShmRing*>            shm_rings;
 
-void get_next_op_buffer_from_pin(uns proc_id);
-void update_op_buffer_if_empty(uns proc_id);
-void invalidate_op_buffer(uns proc_id);
+void           send_cmd_to_pin(uns proc_id, const Scarab_To_Pin_Msg& msg);
+void           get_next_op_buffer_from_pin(uns proc_id);
+void           update_op_buffer_if_empty(uns proc_id);
+void           invalidate_op_buffer(uns proc_id);
+Flag           op_buffer_empty(uns proc_id);
+compressed_op* op_buffer_front(uns proc_id);
+void           op_buffer_pop(uns proc_id);
 
 
 /**********************************************************
  * Cached Op interface
  **********************************************************/
+void send_cmd_to_pin(uns proc_id, const Scarab_To_Pin_Msg& msg) {
+  if(PIN_EXEC_DRIVEN_FE_SHM_RING)
+    shm_rings[proc_id]->send_cmd(msg);
+  else
+    server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+}
+
 void get_next_op_buffer_from_pin(uns proc_id) {
   Scarab_To_Pin_Msg msg;
   msg.type      = FE_FETCH_OP;
   msg.inst_addr = 0;
   msg.inst_uid  = 0;
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
-  cached_cop_buffers[proc_id] = server->receive<ScarabOpBuffer_type>(
-    proc_id);  // blocking
+  if(PIN_EXEC_DRIVEN_FE_SHM_RING) {
+    uint32_t batches = shm_rings[proc_id]->num_batches();
+    send_cmd_to_pin(proc_id, msg);
+    shm_rings[proc_id]->wait_for_batch(batches);  // blocking
+  } else {
+    send_cmd_to_pin(proc_id, msg);
+    cached_cop_buffers[proc_id] = server->receive<ScarabOpBuffer_type>(
+      proc_id);  // blocking
+  }
 }
 
 void update_op_buffer_if_empty(uns proc_id) {
-  if(cached_cop_buffers[proc_id].size() == 0) {
+  if(op_buffer_empty(proc_id)) {
     DEBUG(proc_id, "Calling FETCH_OP to PIN\n");
     get_next_op_buffer_from_pin(proc_id);
   }
 }
 
 inline void invalidate_op_buffer(uns proc_id) {
-  cached_cop_buffers[proc_id].clear();
+  if(PIN_EXEC_DRIVEN_FE_SHM_RING)
+    shm_rings[proc_id]->drop_ops();
+  else
+    cached_cop_buffers[proc_id].clear();
+}
+
+inline Flag op_buffer_empty(uns proc_id) {
+  if(PIN_EXEC_DRIVEN_FE_SHM_RING)
+    return shm_rings[proc_id]->num_ops() == 0;
+  return cached_cop_buffers[proc_id].empty();
+}
+
+inline compressed_op* op_buffer_front(uns proc_id) {
+  if(PIN_EXEC_DRIVEN_FE_SHM_RING)
+    return shm_rings[proc_id]->front_op();
+  return &cached_cop_buffers[proc_id].front();
+}
+
+inline void op_buffer_pop(uns proc_id) {
+  if(PIN_EXEC_DRIVEN_FE_SHM_RING)
+    shm_rings[proc_id]->pop_op();
+  else
+    cached_cop_buffers[proc_id].pop_front();
 }
 
 Addr get_fetch_address(uns proc_id, compressed_op* cop) {
@@ -92,6 +135,16 @@ Addr get_fetch_address(uns proc_id, compressed_op* cop) {
 void pin_exec_driven_init(uns numProcs) {
   server = new Server(PIN_EXEC_DRIVEN_FE_SOCKET, numProcs);
   cached_cop_buffers.resize(numProcs);
+  if(PIN_EXEC_DRIVEN_FE_SHM_RING) {
+    /* Each pintool attaches to its ring once it receives the ring size */
+    for(uns proc_id = 0; proc_id < numProcs; ++proc_id) {
+      ShmRing* ring = new ShmRing();
+      ring->create(shm_ring_path(PIN_EXEC_DRIVEN_FE_SOCKET, proc_id),
+                   PIN_EXEC_DRIVEN_FE_SHM_RING_SLOTS);
+      shm_rings.push_back(ring);
+      server->send(proc_id, (Message<uint32_t>)ring->get_op_slots());
+    }
+  }
   uop_generator_init(numProcs);
 }
 
@@ -108,6 +161,11 @@ void pin_exec_driven_done(Flag* retired_exit) {
   for(uint32_t i = 0; i < server->getNumClients(); ++i) {
     server->wait_for_client_to_close(i);
   }
+  for(uint32_t i = 0; i < shm_rings.size(); ++i) {
+    delete shm_rings[i];
+  }
+  shm_rings.clear();
+  cached_cop_buffers.clear();
   delete server;
 }
 
@@ -116,16 +174,16 @@ Flag pin_exec_driven_can_fetch_op(uns proc_id) {
   DEBUG(proc_id, "Can Fetch Op begin:\n");
   update_op_buffer_if_empty(proc_id);
 
-  return !cached_cop_buffers[proc_id].empty() &&
-         !is_sentinal_op(&cached_cop_buffers[proc_id].front());
+  return !op_buffer_empty(proc_id) &&
+         !is_sentinal_op(op_buffer_front(proc_id));
 }
 
 Addr pin_exec_driven_next_fetch_addr(uns proc_id) {
   DEBUG(proc_id, "Next Fetch Addr begin:\n");
   update_op_buffer_if_empty(proc_id);
 
-  Addr next_fetch_addr = get_fetch_address(
-    proc_id, &cached_cop_buffers[proc_id].front());
+  Addr next_fetch_addr = get_fetch_address(proc_id,
+                                           op_buffer_front(proc_id));
   ASSERT_PROC_ID_IN_ADDR(proc_id, next_fetch_addr);
   return next_fetch_addr;
 }
@@ -134,17 +192,17 @@ void pin_exec_driven_fetch_op(uns proc_id, Op* op) {
   DEBUG(proc_id, "Fetch Op begin:\n");
   update_op_buffer_if_empty(proc_id);
 
-  Flag eom = uop_generator_extract_op(proc_id, op,
-                                      &cached_cop_buffers[proc_id].front());
+  compressed_op* cop = op_buffer_front(proc_id);
+  Flag           eom = uop_generator_extract_op(proc_id, op, cop);
   if(eom) {
     if(!*off_path) {
-      if(cached_cop_buffers[proc_id].front().scarab_marker_roi_begin == true) {
+      if(cop->scarab_marker_roi_begin == true) {
         ASSERT(proc_id, !roi_dump_began);
         // reset stats
         printf("Reached roi dump begin marker, reset stats\n");
         reset_stats(TRUE);
         roi_dump_began = TRUE;
-      } else if(cached_cop_buffers[proc_id].front().scarab_marker_roi_end == true) {
+      } else if(cop->scarab_marker_roi_end == true) {
         ASSERT(proc_id, roi_dump_began);
         // dump stats
         printf("Reached roi dump end marker, dump stats between\n");
@@ -153,7 +211,7 @@ void pin_exec_driven_fetch_op(uns proc_id, Op* op) {
         roi_dump_ID ++;
       }
     }
-    cached_cop_buffers[proc_id].pop_front();
+    op_buffer_pop(proc_id);
   }
 
   DEBUG(proc_id, "Fetch Op end: %llx (%llu)\n", op->inst_info->addr, op->inst_uid);
@@ -169,7 +227,7 @@ void pin_exec_driven_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr) {
   msg.inst_uid  = inst_uid;
   uop_generator_recover(proc_id);
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+  send_cmd_to_pin(proc_id, msg);
   invalidate_op_buffer(proc_id);
   DEBUG(proc_id, "Fetch Redirect end: %llx\n", fetch_addr);
 }
@@ -184,7 +242,7 @@ void pin_exec_driven_recover(uns proc_id, uns64 inst_uid) {
   msg.inst_uid  = inst_uid;
   uop_generator_recover(proc_id);
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+  send_cmd_to_pin(proc_id, msg);
   invalidate_op_buffer(proc_id);
   DEBUG(proc_id, "Fetch Recover end: %llu\n", inst_uid);
 }
@@ -196,6 +254,6 @@ void pin_exec_driven_retire(uns proc_id, uns64 inst_uid) {
   msg.inst_addr = inst_uid == (uns64)-1;
   msg.inst_uid  = inst_uid;
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+  send_cmd_to_pin(proc_id, msg);
   DEBUG(proc_id, "Fetch Retire end: %llu\n", inst_uid);
 }
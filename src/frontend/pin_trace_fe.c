@@ -99,7 +99,21 @@ void trace_init() {
 }
 
 void trace_setup(uns proc_id) {
+  trace_setup_at(proc_id, 0);
+}
+
+/**************************************************************************************/
+/* trace_setup_at: opens the trace so that the first instruction fetched is
+   num_insts instructions past TRACE_START_INST */
+
+void trace_setup_at(uns proc_id, Counter num_insts) {
+  Counter skip = TRACE_START_INST + num_insts;
   pin_trace_open(proc_id, trace_files[proc_id]);
+  if(skip && !pin_trace_skip(proc_id, skip))
+    FATAL_ERROR(proc_id, "Trace %s is shorter than %llu instructions\n",
+                trace_files[proc_id], skip);
+  if(TRACE_READ_AHEAD)
+    pin_trace_start_read_ahead(proc_id, TRACE_READ_AHEAD);
   pin_trace_read(proc_id, &next_pi[proc_id]);
 }
 
@@ -149,6 +163,23 @@ void trace_fetch_op(uns proc_id, Op* op) {
   }
 }
 
+/**************************************************************************************/
+/* trace_fetch_warmup_inst: hands the next trace record to the functional
+   warmup without going through the uop generator. Returns FALSE at the end of
+   the trace. */
+
+Flag trace_fetch_warmup_inst(uns proc_id, ctype_pin_inst* pi) {
+  ASSERT(proc_id, uop_generator_get_bom(proc_id));
+  if(trace_read_done[proc_id])
+    return FALSE;
+  *pi = next_pi[proc_id];
+  if(!pin_trace_read(proc_id, &next_pi[proc_id])) {
+    trace_read_done[proc_id] = TRUE;
+    reached_exit[proc_id]    = TRUE;
+  }
+  return TRUE;
+}
+
 void trace_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr) {
   FATAL_ERROR(proc_id, "Trace frontend does not support wrong path. Turn off "
                        "FETCH_OFF_PATH_OPS\n");
@@ -51,9 +51,13 @@ void trace_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr);
 void trace_recover(uns proc_id, uns64 inst_uid);
 void trace_retire(uns proc_id, uns64 inst_uid);
 
+/* Functional warmup straight from the trace records */
+Flag trace_fetch_warmup_inst(uns proc_id, struct ctype_pin_inst_struct* pi);
+
 /* For restarting of traces */
 void trace_done(void);
 void trace_close_trace_file(uns proc_id);
 void trace_setup(uns proc_id);
+void trace_setup_at(uns proc_id, Counter num_insts);
 
 #endif
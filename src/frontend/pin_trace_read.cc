@@ -32,7 +32,9 @@
 #include <string>
 
 #include "frontend/pin_trace_read.h"
+#include "frontend/trace_read_ahead.h"
 #include "isa/isa.h"
+#include "pin/pin_lib/trace_container.h"
 
 extern "C" {
 #include "globals/assert.h"
@@ -41,14 +43,44 @@ extern "C" {
 
 #define CMP_ADDR_MASK (((uint64_t)-1) << 58)
 
-FILE** pin_file;
+/* A core reads either a bzip2 stream of raw ctype_pin_inst records through
+   pin_file or a trace container (see pin/pin_lib/trace_container.h) through
+   pin_container. The format is detected from the file itself. */
+FILE**                 pin_file;
+TraceContainerReader** pin_container;
+
+/* With read-ahead on, a producer thread per core reads the trace and
+   pin_trace_read() takes records from its ring. */
+struct Pin_Trace_Record {
+  ctype_pin_inst pi;
+  int            success;
+};
+TraceReadAhead<Pin_Trace_Record>** pin_read_ahead;
+
+static int pin_trace_read_file(unsigned char proc_id, ctype_pin_inst* pi);
 
 // static Reg_Id convert_pin_reg_to_scarab_reg(uns pin_reg);
 void pin_trace_file_pointer_init(unsigned char num_cores) {
-  pin_file = (FILE**)malloc(num_cores * sizeof(FILE*));
+  pin_file      = (FILE**)calloc(num_cores, sizeof(FILE*));
+  pin_container = (TraceContainerReader**)calloc(num_cores,
+                                                 sizeof(TraceContainerReader*));
+  pin_read_ahead = (TraceReadAhead<Pin_Trace_Record>**)calloc(
+    num_cores, sizeof(TraceReadAhead<Pin_Trace_Record>*));
 }
 
 void pin_trace_open(unsigned char proc_id, const char* name) {
+  if(trace_container_check_magic(name)) {
+    pin_container[proc_id] = new TraceContainerReader();
+    if(!pin_container[proc_id]->open(name)) {
+      printf("Cannot open trace file: %s\n", name);
+      exit(1);
+    }
+    printf("pin trace container opened for core %u: %s (%" PRIu64
+           " instructions)\n",
+           proc_id, name, pin_container[proc_id]->num_insts());
+    return;
+  }
+
   char cmdline[1024];
   sprintf(cmdline, "bzip2 -dc %s", name);
   pin_file[proc_id] = popen(cmdline, "r");
@@ -59,16 +91,62 @@ void pin_trace_open(unsigned char proc_id, const char* name) {
   }
 }
 
+void pin_trace_start_read_ahead(unsigned char proc_id, unsigned size) {
+  pin_read_ahead[proc_id] = new TraceReadAhead<Pin_Trace_Record>(
+    size, [proc_id](Pin_Trace_Record* record) {
+      record->success = pin_trace_read_file(proc_id, &record->pi);
+      return record->success != 0;
+    });
+}
+
 void pin_trace_close(unsigned char proc_id) {
-  pclose(pin_file[proc_id]);
+  if(pin_read_ahead[proc_id]) {
+    delete pin_read_ahead[proc_id];
+    pin_read_ahead[proc_id] = NULL;
+  }
+  if(pin_container[proc_id]) {
+    delete pin_container[proc_id];
+    pin_container[proc_id] = NULL;
+  } else if(pin_file[proc_id]) {
+    pclose(pin_file[proc_id]);
+    pin_file[proc_id] = NULL;
+  }
 }
 
 int pin_trace_read(unsigned char proc_id, ctype_pin_inst* pi) {
+  if(pin_read_ahead[proc_id]) {
+    Pin_Trace_Record record;
+    if(!pin_read_ahead[proc_id]->next(&record) || !record.success)
+      return 0;
+    *pi = record.pi;
+    return 1;
+  }
+  return pin_trace_read_file(proc_id, pi);
+}
+
+static int pin_trace_read_file(unsigned char proc_id, ctype_pin_inst* pi) {
   int read_size;
 
+  if(pin_container[proc_id])
+    return pin_container[proc_id]->read(pi);
+
   read_size = fread(pi, sizeof(ctype_pin_inst), 1, pin_file[proc_id]);
   if(read_size != 1) {
     return 0;
   }
   return 1;
 }
+
+int pin_trace_skip(unsigned char proc_id, uint64_t num_insts) {
+  ASSERT(proc_id, !pin_read_ahead[proc_id]);
+  if(pin_container[proc_id])
+    return pin_container[proc_id]->seek(num_insts);
+
+  /* a bzip2 stream can only be skipped by decompressing it */
+  ctype_pin_inst skipped;
+  for(uint64_t ii = 0; ii < num_insts; ii++) {
+    if(!pin_trace_read(proc_id, &skipped))
+      return 0;
+  }
+  return 1;
+}
@@ -39,6 +39,12 @@ void pin_trace_file_pointer_init(unsigned char);
 int  pin_trace_read(unsigned char, ctype_pin_inst*);
 void pin_trace_open(unsigned char, const char*);
 void pin_trace_close(unsigned char);
+/* Skips the first num_insts instructions of a freshly opened trace. Returns 0
+   if the trace is shorter. */
+int pin_trace_skip(unsigned char, uint64_t);
+/* Moves the reading of the trace to a producer thread that stays up to size
+   records ahead of pin_trace_read(). */
+void pin_trace_start_read_ahead(unsigned char, unsigned);
 
 #ifdef __cplusplus
 }
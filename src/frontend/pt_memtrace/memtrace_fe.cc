@@ -49,6 +49,7 @@ extern "C" {
 #define DR_DO_NOT_DEFINE_int64
 
 #include "frontend/pt_memtrace/memtrace_trace_reader_memtrace.h"
+#include "frontend/trace_read_ahead.h"
 #include <unordered_map>
 /**************************************************************************************/
 /* Global Variables */
@@ -71,13 +72,28 @@ std::vector<ctype_pin_inst> circ_buf;
 std::unordered_map<Addr, Counter> buf_map;
 const int CLINE = ~0x3F;
 
+/* One decoded trace entry. The decode only reads the trace; the effects it has
+   on the simulation (the instruction counters, ROI stat markers) are applied
+   when the entry is consumed, so that decoding can run ahead on another
+   thread (TRACE_READ_AHEAD). */
+struct Memtrace_Record {
+  ctype_pin_inst pi;
+  uint64_t       num_insts;    // trace entries consumed, added to ins_id
+  uint64_t       num_fetched;  // ... of which fetched, added to ins_id_fetched
+  bool           filled;       // pi was written (false at the end of trace)
+  int            success;
+};
+TraceReadAhead<Memtrace_Record>* read_ahead[MAX_NUM_PROCS];
+
 /**************************************************************************************/
 /* Private Functions */
 int memtrace_trace_read_internal(int proc_id, ctype_pin_inst* next_onpath_pi);
+void memtrace_decode(int proc_id, uint64_t uid_base, Memtrace_Record* record);
 void buf_map_insert();
 void buf_map_remove();
 
-void fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
+void fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi,
+                          uint64_t inst_uid) {
   uint8_t ld = 0;
   uint8_t st = 0;
 
@@ -86,7 +102,7 @@ void fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
   info->instruction_next_addr = insi->target;
   info->actually_taken        = insi->taken;
   info->branch_target         = insi->target;
-  info->inst_uid              = ins_id;
+  info->inst_uid              = inst_uid;
   info->last_inst_from_trace  = insi->last_inst_from_trace;
   info->fetched_instruction   = insi->fetched_instruction;
 
@@ -191,8 +207,48 @@ int memtrace_trace_read(int proc_id, ctype_pin_inst* next_onpath_pi) {
 }
 
 int memtrace_trace_read_internal(int proc_id, ctype_pin_inst* next_onpath_pi) {
+  Memtrace_Record record;
+
+  if(read_ahead[proc_id]) {
+    if(!read_ahead[proc_id]->next(&record))
+      return 0;  // end of trace
+  } else {
+    memtrace_decode(proc_id, ins_id, &record);
+  }
+
+  ins_id += record.num_insts;
+  ins_id_fetched += record.num_fetched;
+  if(!record.filled)
+    return record.success;
+  *next_onpath_pi = record.pi;
+
+  if (next_onpath_pi->scarab_marker_roi_begin == true) {
+    assert(!roi_dump_began);
+    // reset stats
+    std::cout << "Reached roi dump begin marker, reset stats" << std::endl;
+    reset_stats(TRUE);
+    roi_dump_began = TRUE;
+  } else if (next_onpath_pi->scarab_marker_roi_end == true) {
+    assert(roi_dump_began);
+    // dump stats
+    std::cout << "Reached roi dump end marker, dump stats between" << std::endl;
+    dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
+    roi_dump_began = FALSE;
+    roi_dump_ID ++;
+  }
+
+  return record.success;
+}
+
+/* Decodes the next entry of the trace as if ins_id were uid_base. */
+void memtrace_decode(int proc_id, uint64_t uid_base, Memtrace_Record* record) {
   InstInfo* insi;
 
+  record->num_insts   = 0;
+  record->num_fetched = 0;
+  record->filled      = false;
+  record->success     = 0;
+
   do {
     insi = const_cast<InstInfo*>(trace_readers[proc_id]->nextInstruction());
 
@@ -205,17 +261,18 @@ int memtrace_trace_read_internal(int proc_id, ctype_pin_inst* next_onpath_pi) {
       ASSERT(proc_id, prior_pid);
     }
     if(insi->valid) {
-      ins_id++;
+      record->num_insts++;
       if(insi->fetched_instruction) {
-        ins_id_fetched++;
+        record->num_fetched++;
       }
     } else {
-      return 0;  // end of trace
+      return;  // end of trace
     }
   } while(insi->pid != prior_pid || insi->tid != prior_tid);
 
+  ctype_pin_inst* next_onpath_pi = &record->pi;
   memset(next_onpath_pi, 0, sizeof(ctype_pin_inst));
-  fill_in_dynamic_info(next_onpath_pi, insi);
+  fill_in_dynamic_info(next_onpath_pi, insi, uid_base + record->num_insts);
   fill_in_basic_info(next_onpath_pi, insi->ins);
   if(XED_INS_IsVgather(insi->ins) || XED_INS_IsVscatter(insi->ins)) {
     xed_category_enum_t category           = XED_INS_Category(insi->ins);
@@ -227,27 +284,10 @@ int memtrace_trace_read_internal(int proc_id, ctype_pin_inst* next_onpath_pi) {
   apply_x87_bug_workaround(next_onpath_pi, insi->ins);
   fill_in_cf_info(next_onpath_pi, insi->ins);
   print_err_if_invalid(next_onpath_pi, insi->ins);
-
-  if (next_onpath_pi->scarab_marker_roi_begin == true) {
-    assert(!roi_dump_began);
-    // reset stats
-    std::cout << "Reached roi dump begin marker, reset stats" << std::endl;
-    reset_stats(TRUE);
-    roi_dump_began = TRUE;
-  } else if (next_onpath_pi->scarab_marker_roi_end == true) {
-    assert(roi_dump_began);
-    // dump stats
-    std::cout << "Reached roi dump end marker, dump stats between" << std::endl;
-    dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
-    roi_dump_began = FALSE;
-    roi_dump_ID ++;
-  }
+  record->filled = true;
 
   // End of ROI
-  if(roi(insi->ins))
-    return 0;
-
-  return 1;
+  record->success = !roi(insi->ins);
 }
 
 
@@ -322,6 +362,18 @@ void memtrace_setup(uns proc_id) {
     std::cout << "Exit fast forward " << inst_count_to_use << std::endl;
   }
 
+  if(TRACE_READ_AHEAD) {
+    ASSERTM(proc_id, NUM_CORES == 1,
+            "TRACE_READ_AHEAD with memtraces supports a single core only\n");
+    uint64_t uid_base = ins_id;
+    read_ahead[proc_id] = new TraceReadAhead<Memtrace_Record>(
+      TRACE_READ_AHEAD, [proc_id, uid_base](Memtrace_Record* record) mutable {
+        memtrace_decode(proc_id, uid_base, record);
+        uid_base += record->num_insts;
+        return record->filled;
+      });
+  }
+
   if (MEMTRACE_BUF_SIZE) {
     circ_buf.resize(MEMTRACE_BUF_SIZE);
     rdptr = 0;
@@ -332,3 +384,10 @@ void memtrace_setup(uns proc_id) {
     }
   }
 }
+
+void memtrace_done(void) {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    delete read_ahead[proc_id];
+    read_ahead[proc_id] = NULL;
+  }
+}
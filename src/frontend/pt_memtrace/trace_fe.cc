@@ -237,6 +237,8 @@ void ext_trace_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr) {
 
 void ext_trace_recover(uns proc_id, uns64 inst_uid) {
   Op dummy_op;
+  Op_Cold dummy_op_cold;
+  dummy_op.cold = &dummy_op_cold;
   off_path_mode[proc_id] = false;
   // Finish decoding of the current off-path inst before switching to on-path
   while (!uop_generator_get_eom(proc_id)) {
@@ -273,7 +275,8 @@ void ext_trace_init() {
 }
 
 void ext_trace_done() {
-
+  if (FRONTEND == FE_MEMTRACE)
+    memtrace_done();
 }
 
 // is also used to print footprint
@@ -0,0 +1,103 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/trace_read_ahead.h
+ * Author       : HPS Research Group
+ * Date         :
+ * Description  : Decodes trace records ahead of the simulation on a producer
+ *                thread and hands them over through a single-producer,
+ *                single-consumer ring.
+ *
+ * The producer function is called on the read-ahead thread until it returns
+ * false, which marks its last record as the end of the stream. It must not
+ * touch simulator state: anything with side effects on the simulation (stats,
+ * global instruction counters) belongs to the consumer, after next().
+ ***************************************************************************************/
+
+#ifndef __TRACE_READ_AHEAD_H__
+#define __TRACE_READ_AHEAD_H__
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+template <typename Record>
+class TraceReadAhead {
+ public:
+  /* produce() fills in the next record and returns false once that record
+     ends the stream. */
+  TraceReadAhead(size_t size, std::function<bool(Record*)> produce) :
+      ring_(size + 1), produce_(produce), head_(0), tail_(0), done_(false),
+      stop_(false), thread_(&TraceReadAhead::run, this) {}
+
+  ~TraceReadAhead() {
+    stop_.store(true, std::memory_order_relaxed);
+    thread_.join();
+  }
+
+  /* Returns false, leaving record untouched, once the record that ended the
+     stream has been consumed. */
+  bool next(Record* record) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    while(tail == head_.load(std::memory_order_acquire)) {
+      if(done_.load(std::memory_order_acquire) &&
+         tail == head_.load(std::memory_order_acquire))
+        return false;
+      std::this_thread::yield();
+    }
+    *record = ring_[tail];
+    tail_.store(advance(tail), std::memory_order_release);
+    return true;
+  }
+
+ private:
+  std::vector<Record>          ring_;
+  std::function<bool(Record*)> produce_;
+  std::atomic<size_t>          head_;  // next slot the producer writes
+  std::atomic<size_t>          tail_;  // next slot the consumer reads
+  std::atomic<bool>            done_;
+  std::atomic<bool>            stop_;
+  std::thread                  thread_;
+
+  size_t advance(size_t pos) const {
+    return pos + 1 == ring_.size() ? 0 : pos + 1;
+  }
+
+  void run() {
+    bool more = true;
+    while(more && !stop_.load(std::memory_order_relaxed)) {
+      size_t head = head_.load(std::memory_order_relaxed);
+      if(advance(head) == tail_.load(std::memory_order_acquire)) {
+        /* the simulation is behind; there is no hurry to refill */
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        continue;
+      }
+      more = produce_(&ring_[head]);
+      head_.store(advance(head), std::memory_order_release);
+    }
+    done_.store(true, std::memory_order_release);
+  }
+};
+
+#endif
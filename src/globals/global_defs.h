@@ -65,6 +65,12 @@
 #undef UNUSED
 #define UNUSED(X) (void)(X)
 
+/* Per-core simulation context that the cmp model swaps in before it
+   simulates a core (stage pointers, cycle_count, ...). Each host thread keeps
+   its own copy so that cores can be simulated in parallel (see
+   cmp_threads.c). */
+#define SIM_THREAD_LOCAL __thread
+
 /**************************************************************************************/
 
 #ifndef NULL
@@ -32,6 +32,7 @@
 /**************************************************************************************/
 
 #include <stdio.h>
+#include "globals/global_defs.h"
 #include "globals/global_types.h"
 #include "statistics.h"
 
@@ -39,13 +40,13 @@
 
 /**************************************************************************************/
 
-extern Counter  unique_count;
 extern Counter* unique_count_per_core;
 extern Counter* op_count;
 extern Counter* inst_count;
 extern Counter* inst_count_fetched;
-extern Counter  cycle_count;
-extern Counter  sim_time;
+extern SIM_THREAD_LOCAL Counter unique_count;
+extern SIM_THREAD_LOCAL Counter cycle_count;
+extern SIM_THREAD_LOCAL Counter sim_time;
 extern Counter* uop_count;
 extern Counter* pret_inst_count;
 extern uns      operating_mode;
@@ -37,5 +37,6 @@
 #include "dvfs/perf_pred.h"
 #include "frontend/frontend_intf.h"
 #include "memory/cache_part.h"
+#include "memory/stack_sweep.h"
 
 #endif  // __PARAM_ENUM_HEADERS_H__
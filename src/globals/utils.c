@@ -140,8 +140,9 @@ void byte_swap(void* ptr, size_t size) {
  from printf, so I need it to return a pointer to a string.  */
 
 char* hexstr64(uns64 value) {
-  static char hex64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
-  static int  counter = 0;
+  static SIM_THREAD_LOCAL char
+    hex64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
+  static SIM_THREAD_LOCAL int counter = 0;
 
   counter = CIRC_INC2(counter, MAX_SIMULTANEOUS_STRINGS);
   snprintf(hex64_buffer[counter], MAX_STR_LENGTH, "%08x%08x",
@@ -154,9 +155,10 @@ char* hexstr64(uns64 value) {
 /* hexstr64s:  Just like hexstr64, except it strips off leading zeros */
 
 char* hexstr64s(uns64 value) {
-  static char hex64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
-  static int  counter = 0;
-  char*       temp;
+  static SIM_THREAD_LOCAL char
+    hex64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
+  static SIM_THREAD_LOCAL int counter = 0;
+  char*                       temp;
 
   counter = CIRC_INC2(counter, MAX_SIMULTANEOUS_STRINGS);
   snprintf(hex64_buffer[counter], MAX_STR_LENGTH, "%08x%08x",
@@ -173,8 +175,9 @@ char* hexstr64s(uns64 value) {
  from printf, so I need it to return a pointer to a string.  */
 
 char* binstr64(uns64 value) {
-  static char bin64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
-  static int  counter = 0;
+  static SIM_THREAD_LOCAL char
+    bin64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
+  static SIM_THREAD_LOCAL int counter = 0;
   int         ii      = 0;
   counter             = CIRC_INC2(counter, MAX_SIMULTANEOUS_STRINGS);
   while(ii < 64) {
@@ -191,9 +194,10 @@ char* binstr64(uns64 value) {
 /* binstr64s:  Just like binstr64, except it strips off leading zeros */
 
 char* binstr64s(uns64 value) {
-  static char bin64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
-  static int  counter = 0;
-  char*       temp;
+  static SIM_THREAD_LOCAL char
+    bin64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
+  static SIM_THREAD_LOCAL int counter = 0;
+  char*                       temp;
   int         ii = 0;
   counter        = CIRC_INC2(counter, MAX_SIMULTANEOUS_STRINGS);
   while(ii < 64) {
@@ -265,9 +269,10 @@ static char* print_ull_guts(char* d, uns64 ull, unsigned zero_p) {
 /* unsstr64:  Prints a 64-bit number in decimal format. */
 
 char* unsstr64(uns64 value) {
-  static char uns64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
-  static int  counter = 0;
-  char*       temp;
+  static SIM_THREAD_LOCAL char
+    uns64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
+  static SIM_THREAD_LOCAL int counter = 0;
+  char*                       temp;
 
   counter = CIRC_INC2(counter, MAX_SIMULTANEOUS_STRINGS);
   uns64_buffer[counter][MAX_STR_LENGTH] = '\0';
@@ -281,8 +286,9 @@ char* unsstr64(uns64 value) {
 /* unsstr64c:  Prints a 64-bit number in decimal format with commas. */
 
 char* unsstr64c(uns64 value) {
-  static char uns64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
-  static int  counter = 0;
+  static SIM_THREAD_LOCAL char
+    uns64_buffer[MAX_SIMULTANEOUS_STRINGS][MAX_STR_LENGTH + 1];
+  static SIM_THREAD_LOCAL int counter = 0;
   char        buffer[MAX_STR_LENGTH + 1];
   char *      temp, *temp2, *temp3;
   uns         comma_count = 0;
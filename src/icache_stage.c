@@ -44,6 +44,7 @@
 
 #include "bp/bp.param.h"
 #include "cmp_model.h"
+#include "cmp_threads.h"
 #include "core.param.h"
 #include "debug/debug.param.h"
 #include "frontend/frontend.h"
@@ -74,12 +75,12 @@
 
 /**************************************************************************************/
 
-Icache_Stage* ic = NULL;
+SIM_THREAD_LOCAL Icache_Stage* ic = NULL;
 
 extern Cmp_Model              cmp_model;
 extern Memory*                mem;
-extern Rob_Stall_Reason       rob_stall_reason;
-extern Rob_Block_Issue_Reason rob_block_issue_reason;
+extern SIM_THREAD_LOCAL Rob_Stall_Reason       rob_stall_reason;
+extern SIM_THREAD_LOCAL Rob_Block_Issue_Reason rob_block_issue_reason;
 
 /**************************************************************************************/
 /* Local prototypes */
@@ -134,6 +135,12 @@ void init_icache_stage(uns8 proc_id, const char* name) {
   /* initialize the cache structure */
   init_cache(&ic->icache, "ICACHE", ICACHE_SIZE, ICACHE_ASSOC, ICACHE_LINE_SIZE,
              0, REPL_TRUE_LRU);
+  ic->miss_classifier = CLASSIFY_ICACHE_MISSES ?
+                          miss_classifier_create(ic->icache.num_lines,
+                                                 ICACHE_LINE_SIZE,
+                                                 MISS_CLASSIFIER_FILTER_BITS) :
+                          NULL;
+  ic->miss_type = MISS_NONE;
 
   /* init icache_line_info struct - this struct keeps data about corresponding
    * icache lines */
@@ -151,8 +158,9 @@ void init_icache_stage(uns8 proc_id, const char* name) {
   reset_icache_stage();
 
   if(IC_PREF_CACHE_ENABLE)
-    init_cache(&ic->pref_icache, "IC_PREF_CACHE", IC_PREF_CACHE_SIZE,
-               IC_PREF_CACHE_ASSOC, ICACHE_LINE_SIZE, 0, REPL_TRUE_LRU);
+    ic->pref_icache = line_cache_create("IC_PREF_CACHE", IC_PREF_CACHE_SIZE,
+                                        IC_PREF_CACHE_ASSOC, ICACHE_LINE_SIZE,
+                                        0, REPL_TRUE_LRU);
 
   memset(ic->rand_wb_state, 0, NUM_ELEMENTS(ic->rand_wb_state));
 }
@@ -224,8 +232,8 @@ void recover_icache_stage() {
   ic->back_on_path = !bp_recovery_info->recovery_force_offpath;
 
   Op* op = bp_recovery_info->recovery_op;
-  if(bp_recovery_info->late_bp_recovery && op->oracle_info.btb_miss &&
-     !op->oracle_info.btb_miss_resolved) {
+  if(bp_recovery_info->late_bp_recovery && OP_ORACLE(op).btb_miss &&
+     !OP_ORACLE(op).btb_miss_resolved) {
     // Late branch predictor recovered before btb miss is resolved (i.e., icache
     // stage should still wait for redirect)
   } else {
@@ -291,6 +299,9 @@ Inst_Info** lookup_cache() {
   Inst_Info** line = NULL;
   line = (Inst_Info**)cache_access(&ic->icache, ic->fetch_addr,
                                              &ic->line_addr, TRUE);
+  if(ic->miss_classifier)
+    ic->miss_type = miss_classifier_access(ic->miss_classifier, ic->fetch_addr,
+                                           line != NULL);
   if(PERFECT_ICACHE && !line)
     line = (Inst_Info**)INIT_CACHE_DATA_VALUE;
 
@@ -301,9 +312,11 @@ Inst_Info** lookup_cache() {
     Cache*   l1_cache = model->mem == MODEL_MEM ?
                         &mem->uncores[ic->proc_id].l1->cache :
                         NULL;
+    cmp_threads_lock();
     data = l1_cache ? (L1_Data*)cache_access(l1_cache, ic->fetch_addr,
                                               &dummy_line_addr, TRUE) :
                       NULL;
+    cmp_threads_unlock();
     if(data) {  // second level cache hit
       STAT_EVENT(ic->proc_id, L2_IDEAL_FILL_ICACHE);
       // actually bring it into the L1 icache
@@ -359,6 +372,9 @@ void icache_miss_events(Flag uop_cache_hit) {
       }
     }
 
+    if(ic->miss_classifier && !ic->off_path && ic->miss_type != MISS_NONE)
+      STAT_EVENT(ic->proc_id, ICACHE_MISS_COMPULSORY + ic->miss_type);
+
     prefetcher_update_on_icache_access(/*icache_hit*/ FALSE);
     log_stats_ic_miss();
     log_stats_mshr_hit(ic->line_addr);
@@ -400,11 +416,11 @@ Flag mem_req_on_icache_miss() {
           if(new_mem_req(MRT_IFETCH, ic->proc_id, extra_line_addr,
                           ICACHE_LINE_SIZE, 0, NULL, NULL, unique_count,
                           0))
-            STAT_EVENT_ALL(ONE_MORE_SUCESS);
+            SHARED_STAT_EVENT_ALL(ONE_MORE_SUCESS);
           else
-            STAT_EVENT_ALL(ONE_MORE_DISCARDED_MEM_REQ_FULL);
+            SHARED_STAT_EVENT_ALL(ONE_MORE_DISCARDED_MEM_REQ_FULL);
         } else
-          STAT_EVENT_ALL(ONE_MORE_DISCARDED_L0CACHE);
+          SHARED_STAT_EVENT_ALL(ONE_MORE_DISCARDED_L0CACHE);
       }
     }
     return success;
@@ -805,7 +821,7 @@ void update_stats_bf_retired(void) {
 /* icache_process_ops: process all ops fetched in a cycle.*/
 
 static inline void icache_process_ops(Stage_Data* cur_data) {
-  static uns last_icache_issue_time = 0; /* for computing fetch break latency */
+  static SIM_THREAD_LOCAL uns last_icache_issue_time = 0; /* for computing fetch break latency */
   uns            fetch_lag;
 
   ASSERT(ic->proc_id, ic->proc_id == td->proc_id);
@@ -828,7 +844,7 @@ static inline void icache_process_ops(Stage_Data* cur_data) {
     if(!op->off_path &&
        (op->table_info->mem_type == MEM_LD ||
         op->table_info->mem_type == MEM_ST) &&
-       op->oracle_info.va == 0) {
+       OP_ORACLE(op).va == 0) {
       // don't care if the va is 0x0 if mem_type is MEM_PF(SW prefetch),
       // MEM_WH(write hint), or MEM_EVICT(cache block eviction hint)
       print_func_op(op);
@@ -848,7 +864,7 @@ static inline void icache_process_ops(Stage_Data* cur_data) {
     ASSERT(ic->proc_id, td->seq_op_list.count <= op_pool_active_ops);
 
     /* map the op based on true dependencies & set information in
-     * op->oracle_info */
+     * OP_ORACLE(op) */
     /* num cycles since last group issued */
     op->fetch_lag = fetch_lag;
 
@@ -865,7 +881,10 @@ static inline void icache_process_ops(Stage_Data* cur_data) {
 
     op_count[ic->proc_id]++;          /* increment instruction counters */
     unique_count_per_core[ic->proc_id]++;
-    unique_count++;
+    if(cmp_threads_on())
+      unique_count = cmp_threads_unique_count(ic->proc_id);
+    else
+      unique_count++;
     /* check trigger */
     if(op->inst_info->trigger_op_fetched_hook)
       model->op_fetched_hook(op);
@@ -882,32 +901,32 @@ static inline void icache_process_ops(Stage_Data* cur_data) {
     if(op->table_info->cf_type) {
       //TODO: can we move this prefetch update to decoupled front-end or need it be here?
       if(DJOLT_ENABLE)
-        update_djolt(ic->proc_id, op->inst_info->addr, op->table_info->cf_type, op->oracle_info.pred_npc);
+        update_djolt(ic->proc_id, op->inst_info->addr, op->table_info->cf_type, OP_ORACLE(op).pred_npc);
 
       ASSERT(ic->proc_id,
-             (op->oracle_info.mispred << 2 | op->oracle_info.misfetch << 1 |
-              op->oracle_info.btb_miss) <= 0x7);
+             (OP_ORACLE(op).mispred << 2 | OP_ORACLE(op).misfetch << 1 |
+              OP_ORACLE(op).btb_miss) <= 0x7);
 
       inc_bstat_fetched(op);
 
-      ic->off_path = ic->off_path || op->oracle_info.recover_at_decode || op->oracle_info.recover_at_exec;
+      ic->off_path = ic->off_path || OP_ORACLE(op).recover_at_decode || OP_ORACLE(op).recover_at_exec;
 
       // Measuring basic block lengths
       /*static int bbl_len = 0;
-      static int bbl_len_dont_end_pred_nt = 0;
+      static SIM_THREAD_LOCAL int bbl_len_dont_end_pred_nt = 0;
       bbl_len++;
       bbl_len_dont_end_pred_nt++;
       if (op->table_info->cf_type) {
         STAT_EVENT(ic->proc_id, BBL_LENGTH_1 + bbl_len-1);
         bbl_len = 0;
-        if (op->oracle_info.pred == TAKEN) {
+        if (OP_ORACLE(op).pred == TAKEN) {
           STAT_EVENT(ic->proc_id, BBL_DONT_END_PRED_NT_LENGTH_1 + bbl_len_dont_end_pred_nt-1);
           bbl_len_dont_end_pred_nt = 0;
         }
       }*/
     } else {
       // pass the global branch history to all the instructions
-      op->oracle_info.pred_global_hist = g_bp_data->global_hist;
+      OP_ORACLE(op).pred_global_hist = g_bp_data->global_hist;
     }
   }
 }
@@ -947,9 +966,9 @@ Flag icache_fill_line(Mem_Req* req)  // cmp FIXME maybe needed to be optimized
        (USE_CONFIRMED_OFF ? req->off_path_confirmed : req->off_path)) {
       Addr pref_line_addr;
 
-      line = (Inst_Info**)cache_insert(&ic->pref_icache, ic->proc_id,
-                                       ic->fetch_addr, &pref_line_addr,
-                                       &repl_line_addr);
+      line = (Inst_Info**)line_cache_insert(ic->pref_icache, ic->proc_id,
+                                            ic->fetch_addr, &pref_line_addr,
+                                            &repl_line_addr);
       DEBUG(
         ic->proc_id,
         "Insert PREF_ICACHE fetch_addr0x:%s line_addr:%s index:%ld addr:0x%s\n",
@@ -1021,8 +1040,9 @@ Flag icache_fill_line(Mem_Req* req)  // cmp FIXME maybe needed to be optimized
        (USE_CONFIRMED_OFF ? req->off_path_confirmed : req->off_path)) {
       Addr pref_line_addr;
 
-      line = (Inst_Info**)cache_insert(&ic->pref_icache, ic->proc_id, req->addr,
-                                       &pref_line_addr, &repl_line_addr);
+      line = (Inst_Info**)line_cache_insert(ic->pref_icache, ic->proc_id,
+                                            req->addr, &pref_line_addr,
+                                            &repl_line_addr);
       DEBUG(
         ic->proc_id,
         "Insert PREF_ICACHE fetch_addr0x:%s line_addr:%s index:%ld addr:0x%s\n",
@@ -1106,8 +1126,8 @@ Inst_Info** ic_pref_cache_access(void) {
   Inst_Info** inserted_line = NULL;
 
   ASSERT_PROC_ID_IN_ADDR(ic->proc_id, ic->fetch_addr)
-  Inst_Info** line = (Inst_Info**)cache_access(&ic->pref_icache, ic->fetch_addr,
-                                               &ic->line_addr, FALSE);
+  Inst_Info** line = (Inst_Info**)line_cache_access(
+    ic->pref_icache, ic->fetch_addr, &ic->line_addr, FALSE);
 
   if(ic->off_path && !PREFCACHE_MOVE_OFFPATH) {
     if(line) {
@@ -1131,14 +1151,16 @@ Inst_Info** ic_pref_cache_access(void) {
 
     STAT_EVENT(ic->proc_id, IC_PREF_CACHE_HIT_PER + MIN2(ic->off_path, 1));
     STAT_EVENT(ic->proc_id, IC_PREF_CACHE_HIT + MIN2(ic->off_path, 1));
-    cache_invalidate(&ic->pref_icache, ic->fetch_addr, &inval_line_addr);
+    line_cache_invalidate(ic->pref_icache, ic->fetch_addr, &inval_line_addr);
 
     if(PREF_ICACHE_HIT_FILL_L1) {
       if(model->mem == MODEL_MEM) {
         Addr     line_addr;
         Cache*   l1_cache = &mem->uncores[ic->proc_id].l1->cache;
+        cmp_threads_lock();
         L1_Data* l1_data  = (L1_Data*)cache_access(l1_cache, ic->fetch_addr,
                                                   &line_addr, TRUE);
+        cmp_threads_unlock();
         if(!l1_data) {
           Mem_Req tmp_req;
           tmp_req.addr     = ic->fetch_addr;
@@ -29,7 +29,10 @@
 #ifndef __ICACHE_STAGE_H__
 #define __ICACHE_STAGE_H__
 
+#include "globals/global_defs.h"
 #include "globals/global_types.h"
+#include "cache_miss_analyzer.h"
+#include "libs/cache_engine_c.h"
 #include "libs/cache_lib.h"
 #include "stage_data.h"
 #include "decoupled_frontend.h"
@@ -108,8 +111,10 @@ typedef struct Icache_Stage_struct {
 
   Cache icache;           /* the cache storage structure (caches Inst_Info *) */
   Cache icache_line_info; /* contains info about the icache lines */
-  Cache
-       pref_icache; /* Prefetcher cache storage structure (caches Inst_Info *) */
+  Line_Cache*
+    pref_icache; /* Prefetcher cache storage structure (caches Inst_Info *) */
+  Miss_Classifier* miss_classifier; /* 3C classifier (NULL if disabled) */
+  Miss_Type        miss_type; /* class of the last icache lookup */
   char rand_wb_state[31]; /* State of random number generator for random
                              writeback */
 } Icache_Stage;
@@ -132,7 +137,7 @@ typedef struct Icache_Data_struct {
 /**************************************************************************************/
 /* External Variables */
 
-extern Icache_Stage* ic;
+extern SIM_THREAD_LOCAL Icache_Stage* ic;
 
 /**************************************************************************************/
 /* Prototypes */
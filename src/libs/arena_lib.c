@@ -0,0 +1,157 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/arena_lib.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Bump allocator for small objects that come and go with the
+ *                pipeline
+ ***************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug/debug_macros.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "libs/arena_lib.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define ARENA_CLASS(nbytes) (((nbytes) + ARENA_ALIGN - 1) / ARENA_ALIGN)
+#define ARENA_HEADER_SIZE (ARENA_CLASS(sizeof(Arena_Block)) * ARENA_ALIGN)
+#define ARENA_BLOCK_DATA(block) ((char*)(block) + ARENA_HEADER_SIZE)
+
+/**************************************************************************************/
+/* init_arena: no memory is carved until the first allocation */
+
+void init_arena(Arena* arena, const char* name, uns block_size) {
+  memset(arena, 0, sizeof(Arena));
+  arena->name        = name;
+  arena->block_size  = ARENA_CLASS(block_size) * ARENA_ALIGN;
+  arena->num_classes = ARENA_CLASS(block_size) + 1;
+  arena->free_lists  = (Arena_Free**)calloc(arena->num_classes,
+                                           sizeof(Arena_Free*));
+  ASSERT(0, arena->block_size);
+  ASSERT(0, arena->free_lists);
+}
+
+/**************************************************************************************/
+/* arena_alloc: returns uninitialized memory for 'nbytes' bytes */
+
+void* arena_alloc(Arena* arena, uns nbytes) {
+  uns   size_class = ARENA_CLASS(nbytes);
+  uns   size       = size_class * ARENA_ALIGN;
+  void* ptr;
+
+  ASSERTM(0, nbytes && size <= arena->block_size,
+          "%u bytes do not fit in a block of arena %s\n", nbytes, arena->name);
+  arena->num_allocs++;
+  arena->live++;
+
+  if(arena->free_lists[size_class]) {
+    Arena_Free* entry              = arena->free_lists[size_class];
+    arena->free_lists[size_class] = entry->next;
+    return entry;
+  }
+
+  if(!arena->cur_block || arena->cur_offset + size > arena->block_size) {
+    Arena_Block* next = arena->cur_block ? arena->cur_block->next :
+                                           arena->blocks;
+    if(!next) {
+      next = (Arena_Block*)malloc(ARENA_HEADER_SIZE + arena->block_size);
+      ASSERT(0, next);
+      next->next = NULL;
+      if(arena->cur_block)
+        arena->cur_block->next = next;
+      else
+        arena->blocks = next;
+      arena->num_block_mallocs++;
+    }
+    arena->cur_block  = next;
+    arena->cur_offset = 0;
+  }
+
+  ptr = ARENA_BLOCK_DATA(arena->cur_block) + arena->cur_offset;
+  arena->cur_offset += size;
+  return ptr;
+}
+
+/**************************************************************************************/
+/* arena_free: 'nbytes' must be the size the object was allocated with */
+
+void arena_free(Arena* arena, void* ptr, uns nbytes) {
+  uns         size_class = ARENA_CLASS(nbytes);
+  Arena_Free* entry      = (Arena_Free*)ptr;
+
+  ASSERT(0, ptr);
+  ASSERT(0, arena->live > 0);
+  arena->num_frees++;
+  arena->live--;
+
+  entry->next                   = arena->free_lists[size_class];
+  arena->free_lists[size_class] = entry;
+  arena->max_class              = MAX2(arena->max_class, size_class);
+}
+
+/**************************************************************************************/
+/* arena_reset: rewinds the arena to its first block if every object has been
+   freed; returns whether it did */
+
+Flag arena_reset(Arena* arena) {
+  if(arena->live || !arena->cur_block)
+    return FALSE;
+
+  memset(arena->free_lists, 0, (arena->max_class + 1) * sizeof(Arena_Free*));
+  arena->max_class  = 0;
+  arena->cur_block  = NULL;
+  arena->cur_offset = 0;
+  arena->num_resets++;
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* arena_clear: drops every object, freed or not, and rewinds the arena */
+
+void arena_clear(Arena* arena) {
+  arena->live = 0;
+  arena_reset(arena);
+}
+
+/**************************************************************************************/
+/* free_arena: returns every block to the system */
+
+void free_arena(Arena* arena) {
+  Arena_Block* block = arena->blocks;
+  while(block) {
+    Arena_Block* next = block->next;
+    free(block);
+    block = next;
+  }
+  free(arena->free_lists);
+  memset(arena, 0, sizeof(Arena));
+}
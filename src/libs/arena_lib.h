@@ -0,0 +1,83 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/arena_lib.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Bump allocator for small objects that come and go with the
+ *                pipeline.  Freed objects go to a free list per size class
+ *                and are handed out again before any new memory is carved,
+ *                and once every object is freed (e.g. after a pipeline flush)
+ *                the arena can be rewound in one step.  Blocks are kept for
+ *                reuse, so a warmed-up arena never calls malloc.
+ ***************************************************************************************/
+
+#ifndef __ARENA_LIB_H__
+#define __ARENA_LIB_H__
+
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Defines */
+
+#define ARENA_ALIGN 16 /* alignment and size class granularity, in bytes */
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Arena_Block_struct {
+  struct Arena_Block_struct* next;
+} Arena_Block; /* the block's memory follows the header */
+
+typedef struct Arena_Free_struct {
+  struct Arena_Free_struct* next;
+} Arena_Free;
+
+typedef struct Arena_struct {
+  const char*  name;       /* name of the arena */
+  uns          block_size; /* usable bytes per block */
+  Arena_Block* blocks;     /* every block ever allocated, oldest first */
+  Arena_Block* cur_block;  /* block being carved (NULL until first use) */
+  uns          cur_offset; /* first free byte of cur_block */
+  Arena_Free** free_lists; /* one list per ARENA_ALIGN-byte size class */
+  uns          num_classes;
+  uns          max_class; /* highest class freed into since the last reset */
+
+  Counter live; /* objects currently allocated */
+  Counter num_allocs;
+  Counter num_frees;
+  Counter num_block_mallocs;
+  Counter num_resets;
+} Arena;
+
+/**************************************************************************************/
+/* Prototypes */
+
+void  init_arena(Arena* arena, const char* name, uns block_size);
+void* arena_alloc(Arena* arena, uns nbytes);
+void  arena_free(Arena* arena, void* ptr, uns nbytes);
+Flag  arena_reset(Arena* arena);
+void  arena_clear(Arena* arena);
+void  free_arena(Arena* arena);
+
+#endif /* #ifndef __ARENA_LIB_H__ */
@@ -0,0 +1,335 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/cache_engine.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Header-only set-associative cache for C++ users, templated
+ *                on the key, the line payload, the set index function and the
+ *                replacement policy.  Payloads are stored in the cache itself
+ *                (no per-line allocation, no pointer to follow on a hit), and
+ *                the index function and the policy are inlined into the
+ *                lookup instead of being called through virtual functions or
+ *                a function table.
+ ***************************************************************************************/
+
+#ifndef __CACHE_ENGINE_H__
+#define __CACHE_ENGINE_H__
+
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+extern "C" {
+#include "checkpoint.h"
+#include "globals/assert.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "libs/cache_lib.h"
+}
+
+/**************************************************************************************/
+/* Set index functions */
+
+/* Line address keys: the bits above the line offset, modulo the number of
+   sets (which does not have to be a power of 2) */
+struct Cache_Addr_Index {
+  uns offset_bits;
+  uns num_sets;
+
+  uns operator()(Addr addr) const { return (addr >> offset_bits) % num_sets; }
+};
+
+/* Line address keys of a cache with a power of 2 number of sets, indexed the
+   way cache_lib does it */
+struct Cache_Mask_Index {
+  uns  offset_bits;
+  Addr set_mask;
+
+  uns operator()(Addr addr) const { return addr >> offset_bits & set_mask; }
+};
+
+/**************************************************************************************/
+/* Replacement policies.  The engine fills invalid ways first and only asks
+   the policy for a victim when the set is full.  touch() is called on hits
+   that update the replacement state and on insertions.  Policies that can
+   name their next victim without changing any state also have
+   peek_victim(). */
+
+/* Clocks of Cache_Lru_Repl: the core cycle, or the simulation time that
+   cache_lib's REPL_TRUE_LRU caches are stamped with */
+struct Cache_Cycle_Clock {
+  Counter operator()() const { return cycle_count; }
+};
+
+struct Cache_Sim_Time_Clock {
+  Counter operator()() const { return sim_time; }
+};
+
+template <typename Clock = Cache_Cycle_Clock>
+class Cache_Lru_Repl {
+  uns                  assoc = 0;
+  std::vector<Counter> last_access;
+
+ public:
+  void init(uns num_sets, uns _assoc) {
+    assoc = _assoc;
+    last_access.assign(num_sets * assoc, 0);
+  }
+  void touch(uns set, uns way) { last_access[set * assoc + way] = Clock()(); }
+  uns  victim(uns set) { return peek_victim(set); }
+  uns  peek_victim(uns set) const {
+    const Counter* times    = &last_access[set * assoc];
+    uns            repl_idx = 0;
+    for(uns ii = 1; ii < assoc; ii++) {
+      if(times[ii] < times[repl_idx])
+        repl_idx = ii;
+    }
+    return repl_idx;
+  }
+  void checkpoint() {
+    checkpoint_transfer(last_access.data(), sizeof(Counter) * last_access.size());
+  }
+};
+
+class Cache_Random_Repl {
+  uns assoc = 0;
+
+ public:
+  void init(uns num_sets, uns _assoc) { assoc = _assoc; }
+  void touch(uns set, uns way) {}
+  uns  victim(uns set) { return rand() % assoc; }
+  void checkpoint() {}
+};
+
+class Cache_Round_Robin_Repl {
+  uns              assoc = 0;
+  std::vector<uns> next_evict;
+
+ public:
+  void init(uns num_sets, uns _assoc) {
+    assoc = _assoc;
+    next_evict.assign(num_sets, 0);
+  }
+  void touch(uns set, uns way) {}
+  uns  victim(uns set) {
+    next_evict[set] = peek_victim(set);
+    return next_evict[set];
+  }
+  uns peek_victim(uns set) const { return (next_evict[set] + 1) % assoc; }
+  void checkpoint() {
+    checkpoint_transfer(next_evict.data(), sizeof(uns) * next_evict.size());
+  }
+};
+
+/* One of the policies above, picked at run time (for caches whose policy is
+   a parameter) */
+class Cache_Param_Repl {
+  Repl_Policy            policy;
+  Cache_Lru_Repl<>       lru;
+  Cache_Random_Repl      random;
+  Cache_Round_Robin_Repl round_robin;
+
+ public:
+  Cache_Param_Repl(Repl_Policy policy = REPL_TRUE_LRU) : policy(policy) {
+    ASSERTM(0,
+            policy == REPL_TRUE_LRU || policy == REPL_RANDOM ||
+              policy == REPL_ROUND_ROBIN,
+            "Unsupported replacement policy %u\n", policy);
+  }
+  void init(uns num_sets, uns assoc) {
+    if(policy == REPL_TRUE_LRU)
+      lru.init(num_sets, assoc);
+    else if(policy == REPL_RANDOM)
+      random.init(num_sets, assoc);
+    else
+      round_robin.init(num_sets, assoc);
+  }
+  void touch(uns set, uns way) {
+    if(policy == REPL_TRUE_LRU)
+      lru.touch(set, way);
+  }
+  uns victim(uns set) {
+    if(policy == REPL_TRUE_LRU)
+      return lru.victim(set);
+    else if(policy == REPL_RANDOM)
+      return random.victim(set);
+    return round_robin.victim(set);
+  }
+  void checkpoint() {
+    uns saved_policy = policy;
+    checkpoint_match(&saved_policy, sizeof(saved_policy), "cache replacement");
+    lru.checkpoint();
+    round_robin.checkpoint();
+  }
+};
+
+/**************************************************************************************/
+/* Cache_Engine.  Lines are numbered set * assoc + way; the keys, valid bits
+   and payloads of all lines live in three flat arrays, so a lookup scans
+   the keys of a set without touching the payloads. */
+
+template <typename Key, typename Payload, typename Index, typename Repl>
+class Cache_Engine {
+ public:
+  struct Line {
+    Flag    valid;
+    Key     key;
+    Payload data;
+  };
+
+ private:
+  uns                  assoc;
+  uns                  num_sets;
+  Index                index;
+  Repl                 repl;
+  std::vector<Key>     keys;
+  std::vector<Flag>    valid;
+  std::vector<Payload> payloads;
+
+  uns first_invalid_way(uns set) const {
+    const Flag* set_valid = &valid[set * assoc];
+    uns         way       = 0;
+    while(way < assoc && set_valid[way])
+      way++;
+    return way;
+  }
+
+  int find_way(uns set, const Key& key) const {
+    const Key*  set_keys  = &keys[set * assoc];
+    const Flag* set_valid = &valid[set * assoc];
+    for(uns ii = 0; ii < assoc; ii++) {
+      if(set_valid[ii] && set_keys[ii] == key)
+        return ii;
+    }
+    return -1;
+  }
+
+ public:
+  Cache_Engine(uns num_lines, uns assoc, Index index, Repl repl = Repl())
+      : assoc(assoc), num_sets(num_lines / assoc), index(index), repl(repl),
+        keys(num_lines), valid(num_lines, FALSE), payloads(num_lines) {
+    this->repl.init(num_sets, assoc);
+  }
+
+  uns get_assoc() const { return assoc; }
+  uns get_num_sets() const { return num_sets; }
+
+  /* Returns the line number of key, or -1 on a miss */
+  int lookup(const Key& key, bool update_repl) {
+    uns set = index(key);
+    int way = find_way(set, key);
+    if(way < 0)
+      return -1;
+    if(update_repl)
+      repl.touch(set, way);
+    return set * assoc + way;
+  }
+
+  /* Takes a line for key (which must not be cached yet), evicting one if the
+     set is full, and returns its number.  The payload of the line is left as
+     it was; *evicted is set to the evicted line's key if there was one. */
+  uns replace(const Key& key, Flag* evicted, Key* evicted_key) {
+    uns set = index(key);
+    uns way = first_invalid_way(set);
+    if(way == assoc)
+      way = repl.victim(set);
+
+    uns line = set * assoc + way;
+    *evicted = valid[line];
+    if(*evicted)
+      *evicted_key = keys[line];
+    keys[line]  = key;
+    valid[line] = TRUE;
+    repl.touch(set, way);
+    return line;
+  }
+
+  /* Returns the number of the line replace() would take for key, without
+     changing any state; *evicted and *evicted_key as in replace().  Needs a
+     policy with peek_victim(). */
+  uns next_victim(const Key& key, Flag* evicted, Key* evicted_key) const {
+    uns set = index(key);
+    uns way = first_invalid_way(set);
+    if(way == assoc)
+      way = repl.peek_victim(set);
+
+    uns line = set * assoc + way;
+    *evicted = valid[line];
+    if(*evicted)
+      *evicted_key = keys[line];
+    return line;
+  }
+
+  /* Invalidates the line of key, returns its number or -1 on a miss */
+  int invalidate_line(const Key& key) {
+    uns set = index(key);
+    int way = find_way(set, key);
+    if(way < 0)
+      return -1;
+    valid[set * assoc + way] = FALSE;
+    return set * assoc + way;
+  }
+
+  Payload& payload(uns line) { return payloads[line]; }
+
+  /* Returns the payload of key, NULL on a miss */
+  Payload* access(const Key& key, bool update_repl) {
+    int line = lookup(key, update_repl);
+    return line < 0 ? NULL : &payloads[line];
+  }
+
+  /* Inserts key (which must not be cached yet) with data; returns the
+     evicted line, which is valid only if there was one */
+  Line insert(const Key& key, const Payload& data) {
+    ASSERT(0, lookup(key, false) < 0);
+    Line evicted_line{};
+    uns  line = replace(key, &evicted_line.valid, &evicted_line.key);
+    if(evicted_line.valid)
+      evicted_line.data = payloads[line];
+    payloads[line] = data;
+    return evicted_line;
+  }
+
+  /* Invalidates key; returns the invalidated line, which is valid only if
+     key was cached */
+  Line invalidate(const Key& key) {
+    Line invalidated_line{};
+    int  line = invalidate_line(key);
+    if(line >= 0)
+      invalidated_line = Line{TRUE, keys[line], payloads[line]};
+    return invalidated_line;
+  }
+
+  /* Saves or loads all lines (see checkpoint.h); keys and payloads must be
+     POD */
+  void checkpoint() {
+    uns geometry[] = {num_sets, assoc, (uns)sizeof(Key), (uns)sizeof(Payload)};
+    checkpoint_match(geometry, sizeof(geometry), "cache geometry");
+    checkpoint_transfer(keys.data(), sizeof(Key) * keys.size());
+    checkpoint_transfer(valid.data(), sizeof(Flag) * valid.size());
+    checkpoint_transfer(payloads.data(), sizeof(Payload) * payloads.size());
+    repl.checkpoint();
+  }
+};
+
+#endif  // __CACHE_ENGINE_H__
@@ -0,0 +1,190 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/cache_engine_c.cc
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : C interface to libs/cache_engine.h
+ ***************************************************************************************/
+
+#include <cstring>
+#include <vector>
+#include "libs/cache_engine.h"
+
+extern "C" {
+#include "globals/utils.h"
+#include "libs/cache_engine_c.h"
+}
+
+/* The engine only keeps the line addresses; the payload bytes of line n are
+   data[n * data_size ...] */
+struct Line_Cache_Slot {};
+
+typedef Cache_Engine<Addr, Line_Cache_Slot, Cache_Mask_Index,
+                     Cache_Lru_Repl<Cache_Sim_Time_Clock>>
+  Line_Cache_Engine;
+
+struct Line_Cache_struct {
+  char               name[MAX_STR_LENGTH + 1];
+  Line_Cache_Engine* engine; /* NULL if lib holds the lines */
+  Cache              lib;    /* for the policies the engine does not have */
+  Repl_Policy        repl_policy;
+  uns                num_lines;
+  uns                shift_bits;
+  Addr               offset_mask;
+  Addr               set_mask;
+  uns                data_size;
+  std::vector<char>  data;
+
+  void* line_data(uns line) {
+    if(!data_size)
+      return INIT_CACHE_DATA_VALUE;
+    return &data[(size_t)line * data_size];
+  }
+};
+
+/**************************************************************************************/
+/* line_cache_create */
+
+Line_Cache* line_cache_create(const char* name, uns cache_size, uns assoc,
+                              uns line_size, uns data_size,
+                              Repl_Policy repl_policy) {
+  Line_Cache* cache = new Line_Cache();
+  uns         num_sets;
+
+  strncpy(cache->name, name, MAX_STR_LENGTH);
+  cache->repl_policy = repl_policy;
+  cache->num_lines   = cache_size / line_size;
+  cache->shift_bits  = LOG2(line_size);
+  cache->offset_mask = N_BIT_MASK(cache->shift_bits);
+  num_sets           = cache->num_lines / assoc;
+  cache->set_mask    = N_BIT_MASK(LOG2(num_sets));
+  cache->data_size   = data_size;
+
+  if(repl_policy != REPL_TRUE_LRU || (num_sets & (num_sets - 1))) {
+    init_cache(&cache->lib, name, cache_size, assoc, line_size, data_size,
+               repl_policy);
+    cache->engine = NULL;
+    return cache;
+  }
+
+  cache->engine = new Line_Cache_Engine(
+    cache->num_lines, assoc,
+    Cache_Mask_Index{cache->shift_bits, cache->set_mask});
+  cache->data.assign((size_t)cache->num_lines * data_size, 0);
+  return cache;
+}
+
+/**************************************************************************************/
+/* line_cache_access */
+
+void* line_cache_access(Line_Cache* cache, Addr addr, Addr* line_addr,
+                        Flag update_repl) {
+  if(!cache->engine)
+    return cache_access(&cache->lib, addr, line_addr, update_repl);
+
+  *line_addr = addr & ~cache->offset_mask;
+  int line   = cache->engine->lookup(*line_addr, update_repl);
+  return line < 0 ? NULL : cache->line_data(line);
+}
+
+/**************************************************************************************/
+/* line_cache_insert: like cache_insert, the payload of the new line still
+   holds the data of the line it replaced */
+
+void* line_cache_insert(Line_Cache* cache, uns8 proc_id, Addr addr,
+                        Addr* line_addr, Addr* repl_line_addr) {
+  if(!cache->engine)
+    return cache_insert(&cache->lib, proc_id, addr, line_addr, repl_line_addr);
+
+  Flag evicted;
+  *line_addr = addr & ~cache->offset_mask;
+  // like cache_insert, make sure that the line is not inserted twice
+  cache->engine->invalidate_line(*line_addr);
+  uns line = cache->engine->replace(*line_addr, &evicted, repl_line_addr);
+  if(!evicted)
+    *repl_line_addr = 0;
+  return cache->line_data(line);
+}
+
+/**************************************************************************************/
+/* line_cache_invalidate */
+
+void line_cache_invalidate(Line_Cache* cache, Addr addr, Addr* line_addr) {
+  if(!cache->engine) {
+    cache_invalidate(&cache->lib, addr, line_addr);
+    return;
+  }
+
+  *line_addr = addr & ~cache->offset_mask;
+  cache->engine->invalidate_line(*line_addr);
+}
+
+/**************************************************************************************/
+/* line_cache_next_repl_line: the line the next insertion of addr would
+   replace, without changing any state */
+
+void* line_cache_next_repl_line(Line_Cache* cache, uns8 proc_id, Addr addr,
+                                Addr* repl_line_addr, Flag* valid) {
+  if(!cache->engine)
+    return get_next_repl_line(&cache->lib, proc_id, addr, repl_line_addr,
+                              valid);
+
+  uns line = cache->engine->next_victim(addr & ~cache->offset_mask, valid,
+                                        repl_line_addr);
+  if(!*valid)
+    *repl_line_addr = 0;
+  return cache->line_data(line);
+}
+
+/**************************************************************************************/
+/* Geometry */
+
+uns line_cache_set(Line_Cache* cache, Addr addr) {
+  return addr >> cache->shift_bits & cache->set_mask;
+}
+
+uns line_cache_shift_bits(Line_Cache* cache) {
+  return cache->shift_bits;
+}
+
+uns line_cache_num_lines(Line_Cache* cache) {
+  return cache->num_lines;
+}
+
+Repl_Policy line_cache_repl_policy(Line_Cache* cache) {
+  return cache->repl_policy;
+}
+
+/**************************************************************************************/
+/* line_cache_checkpoint */
+
+void line_cache_checkpoint(Line_Cache* cache) {
+  if(!cache->engine) {
+    checkpoint_cache(&cache->lib);
+    return;
+  }
+
+  checkpoint_section(cache->name);
+  cache->engine->checkpoint();
+  checkpoint_transfer(cache->data.data(), cache->data.size());
+}
@@ -0,0 +1,83 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/cache_engine_c.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : C interface to libs/cache_engine.h for caches of line
+ *                addresses with a fixed-size payload per line, kept in one
+ *                array next to the lines.  It follows the conventions of
+ *                cache_access/cache_insert/cache_invalidate/get_next_repl_line
+ *                in libs/cache_lib.h, so a cache_lib cache that only uses
+ *                those moves over without other changes.  REPL_TRUE_LRU
+ *                caches with a power of 2 number of sets run on the engine,
+ *                and replace exactly like cache_lib; any other cache is a
+ *                cache_lib cache behind the same interface.
+ ***************************************************************************************/
+
+#ifndef __CACHE_ENGINE_C_H__
+#define __CACHE_ENGINE_C_H__
+
+#include "globals/global_types.h"
+#include "libs/cache_lib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Line_Cache_struct Line_Cache;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Same arguments as init_cache */
+Line_Cache* line_cache_create(const char* name, uns cache_size, uns assoc,
+                              uns line_size, uns data_size,
+                              Repl_Policy repl_policy);
+
+/* Same as cache_access, cache_insert, cache_invalidate and get_next_repl_line:
+   line_addr is set to the address of the line of addr, repl_line_addr to the
+   address of the evicted line (0 if none).  A cache with a data_size of 0
+   returns INIT_CACHE_DATA_VALUE for its lines. */
+void* line_cache_access(Line_Cache* cache, Addr addr, Addr* line_addr,
+                        Flag update_repl);
+void* line_cache_insert(Line_Cache* cache, uns8 proc_id, Addr addr,
+                        Addr* line_addr, Addr* repl_line_addr);
+void  line_cache_invalidate(Line_Cache* cache, Addr addr, Addr* line_addr);
+void* line_cache_next_repl_line(Line_Cache* cache, uns8 proc_id, Addr addr,
+                                Addr* repl_line_addr, Flag* valid);
+
+/* Geometry: the set of addr, the number of line offset bits (for the bank
+   of an address) and the number of lines */
+uns         line_cache_set(Line_Cache* cache, Addr addr);
+uns         line_cache_shift_bits(Line_Cache* cache);
+uns         line_cache_num_lines(Line_Cache* cache);
+Repl_Policy line_cache_repl_policy(Line_Cache* cache);
+
+/* Saves or loads all lines (see checkpoint.h) */
+void line_cache_checkpoint(Line_Cache* cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __CACHE_ENGINE_C_H__ */
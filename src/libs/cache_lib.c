@@ -27,6 +27,9 @@
  ***************************************************************************************/
 
 #include <stdlib.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 #include "debug/debug_macros.h"
 #include "globals/assert.h"
 #include "globals/global_defs.h"
@@ -57,6 +60,11 @@ static inline uns  cache_index(Cache* cache, Addr addr, Addr* tag,
                                Addr* line_addr);
 static inline void update_repl_policy(Cache*, Cache_Entry*, uns, uns, Flag);
 static inline Cache_Entry* find_repl_entry(Cache*, uns8, uns, uns*);
+static inline void         sync_packed_tag(Cache*, uns, uns);
+static inline void         sync_packed_line(Cache*, uns, Cache_Entry*);
+static inline void         sync_packed_set(Cache*, uns);
+static inline int          next_tag_match(Cache*, uns, Addr, uns);
+static inline void* cache_access_true_lru(Cache*, uns, Addr, Flag);
 
 /* for ideal replacement */
 static inline void*        access_unsure_lines(Cache*, uns, Addr, Flag);
@@ -88,6 +96,94 @@ uns ext_cache_index(Cache* cache, Addr addr, Addr* tag, Addr* line_addr) {
 }
 
 
+/**************************************************************************************/
+/* Packed tags: cache->tag_array mirrors the tag and valid bit of every entry,
+ * so that a lookup compares the tags of a set a few ways at a time instead of
+ * walking its Cache_Entry structs.  Every change to the tag or valid bit of an
+ * entry must be followed by one of the sync functions below. */
+
+static inline void sync_packed_tag(Cache* cache, uns set, uns way) {
+  Cache_Entry* line = &cache->entries[set][way];
+  cache->tag_array[set * cache->assoc + way] = line->valid ? line->tag :
+                                                             CACHE_TAG_INVALID;
+}
+
+static inline void sync_packed_line(Cache* cache, uns set, Cache_Entry* line) {
+  sync_packed_tag(cache, set, line - cache->entries[set]);
+}
+
+static inline void sync_packed_set(Cache* cache, uns set) {
+  uns ii;
+  for(ii = 0; ii < cache->assoc; ii++)
+    sync_packed_tag(cache, set, ii);
+}
+
+void cache_sync_tag_array(Cache* cache) {
+  uns ii;
+  for(ii = 0; ii < cache->num_sets; ii++)
+    sync_packed_set(cache, ii);
+}
+
+/* match_packed_tags: returns the mask of the first num (<= 64) tags that are
+ * equal to tag */
+static inline uns64 match_packed_tags(const Addr* tags, uns num, Addr tag) {
+  uns64 mask = 0;
+  uns   ii   = 0;
+#if defined(__AVX2__)
+  const __m256i key4 = _mm256_set1_epi64x(tag);
+  for(; ii + 4 <= num; ii += 4) {
+    __m256i eq = _mm256_cmpeq_epi64(
+      _mm256_loadu_si256((const __m256i*)(tags + ii)), key4);
+    mask |= (uns64)_mm256_movemask_pd(_mm256_castsi256_pd(eq)) << ii;
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i key2 = _mm_set1_epi64x(tag);
+  for(; ii + 2 <= num; ii += 2) {
+    /* no 64-bit compare before SSE4.1: both 32-bit halves have to match */
+    __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(tags + ii)),
+                                 key2);
+    eq         = _mm_and_si128(eq, _mm_shuffle_epi32(eq, 0xb1));
+    mask |= (uns64)_mm_movemask_pd(_mm_castsi128_pd(eq)) << ii;
+  }
+#endif
+  for(; ii < num; ii++)
+    mask |= (uns64)(tags[ii] == tag) << ii;
+  return mask;
+}
+
+/* tag_matches: returns the mask of the ways base..base+63 of the set that
+ * hold a valid line with the tag */
+static inline uns64 tag_matches(Cache* cache, uns set, Addr tag, uns base) {
+  uns64 hits = match_packed_tags(&cache->tag_array[set * cache->assoc + base],
+                                 MIN2(cache->assoc - base, 64), tag);
+  uns64 left;
+
+  /* invalid lines only match a tag that happens to be CACHE_TAG_INVALID */
+  if(tag == CACHE_TAG_INVALID) {
+    for(left = hits; left; left &= left - 1) {
+      uns way = base + __builtin_ctzll(left);
+      if(!cache->entries[set][way].valid)
+        hits &= ~(1ULL << (way - base));
+    }
+  }
+  return hits;
+}
+
+/* next_tag_match: returns the first way at or after way 'from' that holds a
+ * valid line with the tag, or -1 */
+static inline int next_tag_match(Cache* cache, uns set, Addr tag, uns from) {
+  uns base;
+
+  for(base = from; base < cache->assoc; base += 64) {
+    uns64 hits = tag_matches(cache, set, tag, base);
+    if(hits)
+      return base + __builtin_ctzll(hits);
+  }
+  return -1;
+}
+
+
 /**************************************************************************************/
 /* init_cache: */
 
@@ -125,6 +221,7 @@ void init_cache(Cache* cache, const char* name, uns cache_size, uns assoc,
 
   /* allocate memory for all the sets (pointers to line arrays)  */
   cache->entries = (Cache_Entry**)malloc(sizeof(Cache_Entry*) * num_sets);
+  cache->tag_array = (Addr*)malloc(sizeof(Addr) * num_lines);
 
   /* allocate memory for the unsure lists (if necessary) */
   if(cache->repl_policy == REPL_IDEAL)
@@ -136,6 +233,7 @@ void init_cache(Cache* cache, const char* name, uns cache_size, uns assoc,
     /* allocate memory for all of the data elements in each line */
     for(jj = 0; jj < assoc; jj++) {
       cache->entries[ii][jj].valid = FALSE;
+      cache->tag_array[ii * assoc + jj] = CACHE_TAG_INVALID;
       if(data_size) {
         cache->entries[ii][jj].data = (void*)malloc(data_size);
         memset(cache->entries[ii][jj].data, 0, data_size);
@@ -217,9 +315,13 @@ void init_cache(Cache* cache, const char* name, uns cache_size, uns assoc,
 void* cache_access(Cache* cache, Addr addr, Addr* line_addr, Flag update_repl) {
   Addr tag;
   uns  set = cache_index(cache, addr, &tag, line_addr);
-  uns  ii;
+  int  ii;
   void* line_data = NULL;
 
+  /* true LRU, the common case, has its own lookup without any policy checks */
+  if(cache->repl_policy == REPL_TRUE_LRU)
+    return cache_access_true_lru(cache, set, tag, update_repl);
+
   if (cache->repl_policy >= REPL_VOID)
     return cache_access_strategy(cache, addr, line_addr, update_repl);
 
@@ -227,26 +329,25 @@ void* cache_access(Cache* cache, Addr addr, Addr* line_addr, Flag update_repl) {
     return access_ideal_storage(cache, set, tag, addr);
   }
 
-  for(ii = 0; ii < cache->assoc; ii++) {
+  for(ii = next_tag_match(cache, set, tag, 0); ii >= 0;
+      ii = next_tag_match(cache, set, tag, ii + 1)) {
     Cache_Entry* line = &cache->entries[set][ii];
 
-    if(line->valid && line->tag == tag) {
-      /* update replacement state if necessary */
-      ASSERT(0, line->data);
-      DEBUG(0, "Found line in cache '%s' at (set %u, way %u, base 0x%s)\n",
-            cache->name, set, ii, hexstr64s(line->base));
+    /* update replacement state if necessary */
+    ASSERT(0, line->data);
+    DEBUG(0, "Found line in cache '%s' at (set %u, way %u, base 0x%s)\n",
+          cache->name, set, ii, hexstr64s(line->base));
 
-      if(update_repl) {
-        if(line->pref) {
-          line->pref = FALSE;
-        }
-        cache->num_demand_access++;
-        update_repl_policy(cache, line, set, ii, FALSE);
-        DEBUG(0, "(%s, %d) [0x%x, 0x%x]: in access\n\n", cache->name, cache->repl_policy, cache->num_sets, cache->assoc);
+    if(update_repl) {
+      if(line->pref) {
+        line->pref = FALSE;
       }
-
-      line_data = line->data;
+      cache->num_demand_access++;
+      update_repl_policy(cache, line, set, ii, FALSE);
+      DEBUG(0, "(%s, %d) [0x%x, 0x%x]: in access\n\n", cache->name, cache->repl_policy, cache->num_sets, cache->assoc);
     }
+
+    line_data = line->data;
   }
 
   if (line_data)
@@ -271,7 +372,36 @@ void* cache_access(Cache* cache, Addr addr, Addr* line_addr, Flag update_repl) {
   return NULL;
 }
 
- 
+
+/**************************************************************************************/
+/* cache_access_true_lru: cache_access for REPL_TRUE_LRU caches */
+
+static inline void* cache_access_true_lru(Cache* cache, uns set, Addr tag,
+                                          Flag update_repl) {
+  void* line_data = NULL;
+  uns   base;
+
+  for(base = 0; base < cache->assoc; base += 64) {
+    uns64 hits;
+    for(hits = tag_matches(cache, set, tag, base); hits; hits &= hits - 1) {
+      uns          ii   = base + __builtin_ctzll(hits);
+      Cache_Entry* line = &cache->entries[set][ii];
+      ASSERT(0, line->data);
+      DEBUG(0, "Found line in cache '%s' at (set %u, way %u, base 0x%s)\n",
+            cache->name, set, ii, hexstr64s(line->base));
+
+      if(update_repl) {
+        line->pref = FALSE;
+        cache->num_demand_access++;
+        line->last_access_time = sim_time;
+      }
+      line_data = line->data;
+    }
+  }
+  return line_data;
+}
+
+
 /**************************************************************************************/
 /* cache_insert: returns a pointer to the data section of the new cache line.
    Sets line_addr to the address of the first block of the new line.  Sets
@@ -343,6 +473,7 @@ void* cache_insert_replpos(Cache* cache, uns8 proc_id, Addr addr,
   new_line->pref = isPrefetch;
 
   new_line->pw_start_addr = addr; // only means anything for uop cache
+  sync_packed_line(cache, set, new_line);
 
   switch(insert_repl_policy) {
     case INSERT_REPL_DEFAULT:
@@ -430,6 +561,7 @@ void* cache_insert_replpos(Cache* cache, uns8 proc_id, Addr addr,
       main_line->tag              = tag;
       main_line->base             = *line_addr;
       main_line->last_access_time = sim_time;
+      sync_packed_tag(cache, set, lru_ind);
     }
   }
   return new_line->data;
@@ -442,15 +574,15 @@ void* cache_insert_replpos(Cache* cache, uns8 proc_id, Addr addr,
 void cache_invalidate(Cache* cache, Addr addr, Addr* line_addr) {
   Addr tag;
   uns  set = cache_index(cache, addr, &tag, line_addr);
-  uns  ii;
+  int  ii;
 
-  for(ii = 0; ii < cache->assoc; ii++) {
+  for(ii = next_tag_match(cache, set, tag, 0); ii >= 0;
+      ii = next_tag_match(cache, set, tag, ii + 1)) {
     Cache_Entry* line = &cache->entries[set][ii];
-    if(line->tag == tag && line->valid) {
-      line->tag   = 0;
-      line->valid = FALSE;
-      line->base  = 0;
-    }
+    line->tag   = 0;
+    line->valid = FALSE;
+    line->base  = 0;
+    sync_packed_tag(cache, set, ii);
   }
 
   if(cache->repl_policy == REPL_IDEAL)
@@ -790,6 +922,7 @@ static inline void* access_unsure_lines(Cache* cache, uns set, Addr tag,
         if(!cache->entries[set][ii].valid) {
           void* data = cache->entries[set][ii].data;
           memcpy(&cache->entries[set][ii], temp, sizeof(Cache_Entry));
+          sync_packed_tag(cache, set, ii);
           temp->data = data;
           ASSERT(0, dl_list_remove_current(list) == temp);
           ASSERT(0, ++cache->repl_ctrs[set] <=
@@ -831,6 +964,7 @@ static inline Cache_Entry* insert_sure_line(Cache* cache, uns set, Addr tag) {
       }
     }
     ASSERT(0, count == cache->repl_ctrs[set]);
+    sync_packed_set(cache, set);
     cache->repl_ctrs[set] = 1;
     return &cache->entries[set][0];
   } else {
@@ -912,6 +1046,7 @@ void* access_shadow_lines(Cache* cache, uns set, Addr tag) {
         line->last_access_time =
           (cache->entries[set][lru_ind]).last_access_time;
         (cache->entries[set][lru_ind]).last_access_time = sim_time;
+        sync_packed_tag(cache, set, lru_ind);
         DEBUG(0,
               "shadow cache line is swaped\n cache->addr:0x%s "
               "cache->lru_time:%lld  shadow_tag:0x%s shadow_insert:%lld \n",
@@ -1100,6 +1235,7 @@ void* cache_insert_lru(Cache* cache, uns8 proc_id, Addr addr, Addr* line_addr,
   new_line->valid   = TRUE;
   new_line->tag     = tag;
   new_line->base    = *line_addr;
+  sync_packed_line(cache, set, new_line);
   update_repl_policy(cache, new_line, set, repl_index, TRUE);
   if(cache->repl_policy == REPL_TRUE_LRU)
     new_line->last_access_time = 137;
@@ -1142,6 +1278,7 @@ void* cache_insert_lru(Cache* cache, uns8 proc_id, Addr addr, Addr* line_addr,
       main_line->tag              = tag;
       main_line->base             = *line_addr;
       main_line->last_access_time = sim_time;
+      sync_packed_tag(cache, set, lru_ind);
     }
   }
   return new_line->data;
@@ -1158,6 +1295,7 @@ void reset_cache(Cache* cache) {
       cache->entries[ii][jj].valid = FALSE;
     }
   }
+  cache_sync_tag_array(cache);
 }
 
 /**************************************************************************************/
@@ -1344,6 +1482,7 @@ void *cache_insert_strategy(Cache* cache, uns8 proc_id, Addr addr, Addr* line_ad
   else
     *repl_line_addr = 0;
   repl_policy_func_table[policy].action_repl(cache, new_line, proc_id, tag, line_addr, repl_line_addr);
+  sync_packed_tag(cache, set, repl_index);
   repl_policy_func_table[policy].update_insert(cache, proc_id, set, repl_index, NULL);
 
   return new_line->data;
@@ -1434,6 +1573,7 @@ void general_action_init(Cache* cache, const char* name, uns cache_size, uns ass
 
   /* allocate memory for all the sets (pointers to line arrays)  */
   cache->entries = (Cache_Entry**)malloc(sizeof(Cache_Entry*) * num_sets);
+  cache->tag_array = (Addr*)malloc(sizeof(Addr) * num_lines);
 
   /* allocate memory for all of the lines in each set */
   for(ii = 0; ii < num_sets; ii++) {
@@ -1441,6 +1581,7 @@ void general_action_init(Cache* cache, const char* name, uns cache_size, uns ass
     /* allocate memory for all of the data elements in each line */
     for(jj = 0; jj < assoc; jj++) {
       cache->entries[ii][jj].valid = FALSE;
+      cache->tag_array[ii * assoc + jj] = CACHE_TAG_INVALID;
       if(data_size) {
         cache->entries[ii][jj].data = (void*)malloc(data_size);
         memset(cache->entries[ii][jj].data, 0, data_size);
@@ -38,6 +38,10 @@
 #define INIT_CACHE_DATA_VALUE \
   ((void*)0x8badbeef) /* set data pointers to this initially */
 
+#define CACHE_TAG_INVALID \
+  ((Addr)-1) /* packed tag of an invalid line (a match is still checked \
+                against the valid bit) */
+
 
 /**************************************************************************************/
 
@@ -125,6 +129,9 @@ typedef struct Cache_struct {
   Cache_Entry** entries;   /* A dynamically allocated array of all
                               of the cache entries. The array is
                               two-dimensional, sets are row major. */
+  Addr* tag_array;         /* Packed copy of the tags of the entries (assoc
+                              per set, CACHE_TAG_INVALID if not valid) that
+                              lookups compare several ways at a time */
   List* unsure_lists;      /* A linked list for each set in the cache that
                               is used when simulating ideal replacement policies */
   Flag perfect;            /* is the cache perfect (for henry mem system) */
@@ -200,6 +207,7 @@ void* shadow_cache_insert(Cache* cache, uns set, Addr tag, Addr base);
 void* access_shadow_lines(Cache* cache, uns set, Addr tag);
 void* access_ideal_storage(Cache* cache, uns set, Addr tag, Addr addr);
 void  reset_cache(Cache*);
+void  cache_sync_tag_array(Cache*);
 int   cache_find_pos_in_lru_stack(Cache* cache, uns8 proc_id, Addr addr,
                                   Addr* line_addr);
 void  set_partition_allocate(Cache* cache, uns8 proc_id, uns num_ways);
@@ -1,11 +0,0 @@
-// CPP implementation of a cache.
-
-#ifndef __CPP_CACHE_H__
-#define __CPP_CACHE_H__
-
-#include "globals/global_types.h"
-#include "cache_lib.h"
-
-#include "cpp_cache.tpp"
-
-#endif
\ No newline at end of file
@@ -1,51 +1,72 @@
 #include "libs/cpp_hash_lib_wrapper.h"
-#include <unordered_map>
-#include <vector>
-#include <iostream>
-
-struct key {
-  uint64_t addr;
-  uint64_t lsb_bytes;
-  uint64_t msb_bytes;
-  uint8_t op_idx;
-
-  key () : addr(0), lsb_bytes(0), msb_bytes(0), op_idx(0) {};
-  key ( uint64_t _addr, uint64_t _lsb_bytes, uint64_t _msb_bytes, uint8_t _op_idx) :
-  addr(_addr), lsb_bytes(_lsb_bytes), msb_bytes(_msb_bytes), op_idx(_op_idx) {};
-
-  bool operator==(const key &p) const {
-    return addr == p.addr && lsb_bytes == p.lsb_bytes && msb_bytes == p.msb_bytes && op_idx == p.op_idx;
-  }
-};
+#include <cstring>
 
-// The specialized hash function for `unordered_map` keys
-struct hash_fn
-{
-  //template <class T1, class T2>
-    std::size_t operator() (const key &key) const
-    {
-        std::size_t h1 = std::hash<uint64_t>()(key.addr);
-        std::size_t h2 = std::hash<uint64_t>()(key.lsb_bytes);
-        std::size_t h3 = std::hash<uint64_t>()(key.msb_bytes);
-        std::size_t h4 = std::hash<uint8_t>()(key.op_idx);
-        return h1 ^ h2 ^ h3 ^ h4;
-    }
+extern "C" {
+#include "libs/hash_lib.h"
+}
+
+// Entries are found by (addr, op_idx); the instruction bytes tell apart code
+// that was rewritten at the same address (e.g. by a JIT).
+struct Inst_Info_Entry {
+  uint64_t  addr;
+  uint64_t  lsb_bytes;
+  uint64_t  msb_bytes;
+  uint8_t   op_idx;
+  Inst_Info info;
 };
 
-std::unordered_map<key, Inst_Info*, hash_fn> hash_map;
+static Flag inst_info_entry_eq(void const* a, void const* b) {
+  const Inst_Info_Entry* x = (const Inst_Info_Entry*)a;
+  const Inst_Info_Entry* y = (const Inst_Info_Entry*)b;
+  return x->addr == y->addr && x->lsb_bytes == y->lsb_bytes &&
+         x->msb_bytes == y->msb_bytes && x->op_idx == y->op_idx;
+}
+
+// One table per core so that cores simulated on different host threads never
+// share a table (see cmp_threads.c). The Inst_Infos live in the table, which
+// keeps them in place for the rest of the run.
+static Hash_Table hash_tables[MAX_NUM_PROCS];
+static bool       hash_tables_init[MAX_NUM_PROCS];
 
   Inst_Info *cpp_hash_table_access_create(int core, uint64_t addr, uint64_t lsb_bytes, uint64_t msb_bytes, uint8_t op_idx, unsigned char *new_entry) {
-    *new_entry = false;
-    key _key(addr, lsb_bytes, msb_bytes, op_idx);
-    auto lookup = hash_map.find(_key);
-    if (lookup != hash_map.end()) {
-      return lookup->second;
+    Hash_Table* table = &hash_tables[core];
+    if (!hash_tables_init[core]) {
+      init_complex_hash_table(table, "inst info", 1 << 14,
+                              sizeof(Inst_Info_Entry), inst_info_entry_eq);
+      hash_tables_init[core] = true;
     }
-    else {
-      Inst_Info * info = new Inst_Info(); //&vec.back();
-      hash_map.insert(std::pair<key, Inst_Info*>(_key, info));
-      *new_entry = true;
-      return info;
+    Inst_Info_Entry query;
+    query.addr      = addr;
+    query.lsb_bytes = lsb_bytes;
+    query.msb_bytes = msb_bytes;
+    query.op_idx    = op_idx;
+    Inst_Info_Entry* entry = (Inst_Info_Entry*)complex_hash_table_access_create(
+      table, (int64)((addr << 8) | op_idx), &query, new_entry);
+    if (*new_entry) {
+      memset(entry, 0, sizeof(Inst_Info_Entry));
+      entry->addr      = addr;
+      entry->lsb_bytes = lsb_bytes;
+      entry->msb_bytes = msb_bytes;
+      entry->op_idx    = op_idx;
     }
+    return &entry->info;
   }
 
+struct Inst_Info_Scan {
+  void (*func)(uint64_t, uint64_t, uint64_t, uint8_t, Inst_Info*, void*);
+  void* arg;
+};
+
+static void inst_info_scan_entry(void* data, void* arg) {
+  Inst_Info_Entry* entry = (Inst_Info_Entry*)data;
+  Inst_Info_Scan*  scan  = (Inst_Info_Scan*)arg;
+  scan->func(entry->addr, entry->lsb_bytes, entry->msb_bytes, entry->op_idx,
+             &entry->info, scan->arg);
+}
+
+  void cpp_hash_table_scan(int core, void (*func)(uint64_t addr, uint64_t lsb_bytes, uint64_t msb_bytes, uint8_t op_idx, Inst_Info *info, void *arg), void *arg) {
+    if (!hash_tables_init[core])
+      return;
+    Inst_Info_Scan scan = {func, arg};
+    hash_table_scan(&hash_tables[core], inst_info_scan_entry, &scan);
+  }
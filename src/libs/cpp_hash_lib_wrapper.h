@@ -12,6 +12,9 @@ extern "C" {
 
   Inst_Info * cpp_hash_table_access_create(int core, uint64_t addr, uint64_t lsb_bytes, uint64_t msb_bytes, uint8_t op_idx, unsigned char *new_entry);
 
+  // Calls func for every Inst_Info created for core so far
+  void cpp_hash_table_scan(int core, void (*func)(uint64_t addr, uint64_t lsb_bytes, uint64_t msb_bytes, uint8_t op_idx, Inst_Info *info, void *arg), void *arg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,14 +27,18 @@
  ***************************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "debug/debug_macros.h"
 #include "globals/assert.h"
 #include "globals/global_defs.h"
 #include "globals/global_types.h"
 #include "globals/global_vars.h"
+#include "globals/utils.h"
 
 #include "libs/hash_lib.h"
-#include "libs/malloc_lib.h"
 
 #include "debug/debug.param.h"
 
@@ -43,28 +47,97 @@
 
 #define DEBUG(args...) _DEBUG(DEBUG_HASH_LIB, ##args)
 
-int64 HASH_INDEX(const Hash_Table* table, int64 key);
-int64 HASH_INDEX(const Hash_Table*  table, int64 key) {
-  int64_t mask = (~0UL) % table->buckets;
-  int64_t hash = 0;
-  int log2 = 64 - __builtin_clzl(table->buckets);
-  for (int i = 0; i < 64; i += log2) {
-    hash ^= (key & mask);
-    key = key >> log2;
-  }
-  return hash;
+#define HASH_GROUP_SIZE 16 /* slots probed at once */
+#define HASH_CTRL_EMPTY 0x80
+#define HASH_CTRL_DELETED 0xFE /* any control byte >= 0x80 is free */
+#define HASH_MIN_CAPACITY HASH_GROUP_SIZE
+#define HASH_MAX_INIT_CAPACITY (1 << 16) /* larger tables grow when needed */
+#define HASH_ARENA_BLOCK (16 * 1024)
+
+/**************************************************************************************/
+/* Prototypes */
+
+static inline uns64            hash_key(int64 key);
+static inline uns              hash_group_match(const uns8* group, uns8 h2);
+static inline uns              hash_group_empty(const uns8* group);
+static inline uns              hash_group_free(const uns8* group);
+static inline void             hash_set_ctrl(Hash_Table* table, uns idx, uns8 ctrl);
+static inline Hash_Table_Slot* hash_table_find(Hash_Table const* table,
+                                               int64 key, void const* data);
+static Hash_Table_Slot*        hash_table_insert(Hash_Table* table, int64 key);
+static void                    hash_table_delete(Hash_Table* table,
+                                                 Hash_Table_Slot* slot);
+static void hash_table_resize(Hash_Table* table, uns capacity);
+
+/**************************************************************************************/
+/* hash_key: mixes all bits of the key; the low 7 bits go to the control byte
+   and the rest pick the first group to probe */
+
+static inline uns64 hash_key(int64 key) {
+  uns64 x = (uns64)key;
+  x ^= x >> 33;
+  x *= 0xFF51AFD7ED558CCDULL;
+  x ^= x >> 33;
+  x *= 0xC4CEB9FE1A85EC53ULL;
+  x ^= x >> 33;
+  return x;
 }
 
 /**************************************************************************************/
-// Global variables
+/* hash_group_*: bit masks of the slots of a group whose control byte is h2,
+   empty, or free (empty or deleted) */
+
+#ifdef __SSE2__
 
-#define NUM_HASH_TABLE_PRIMES 12
-static uns const hash_table_primes[NUM_HASH_TABLE_PRIMES] = {
-  1, 5, 11, 23, 47, 101, 211, 401, 811, 1601, 3209, 6373};
+static inline uns hash_group_match(const uns8* group, uns8 h2) {
+  __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+}
+
+static inline uns hash_group_empty(const uns8* group) {
+  __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+  return _mm_movemask_epi8(
+    _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)HASH_CTRL_EMPTY)));
+}
+
+static inline uns hash_group_free(const uns8* group) {
+  return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+}
 
+#else
+
+static inline uns hash_group_match(const uns8* group, uns8 h2) {
+  uns mask = 0;
+  for(uns ii = 0; ii < HASH_GROUP_SIZE; ii++)
+    mask |= (uns)(group[ii] == h2) << ii;
+  return mask;
+}
+
+static inline uns hash_group_empty(const uns8* group) {
+  return hash_group_match(group, HASH_CTRL_EMPTY);
+}
+
+static inline uns hash_group_free(const uns8* group) {
+  uns mask = 0;
+  for(uns ii = 0; ii < HASH_GROUP_SIZE; ii++)
+    mask |= (uns)(group[ii] >> 7) << ii;
+  return mask;
+}
+
+#endif
 
 /**************************************************************************************/
-/* init_hash_table: */
+/* hash_set_ctrl: sets the control byte of a slot and of its copy */
+
+static inline void hash_set_ctrl(Hash_Table* table, uns idx, uns8 ctrl) {
+  table->ctrl[idx] = ctrl;
+  if(idx < HASH_GROUP_SIZE)
+    table->ctrl[table->capacity + idx] = ctrl;
+}
+
+
+/**************************************************************************************/
+/* init_hash_table: 'buckets' is the expected number of entries */
 
 void init_hash_table(Hash_Table* table, const char* name, uns buckets,
                      uns data_size) {
@@ -74,13 +147,153 @@ void init_hash_table(Hash_Table* table, const char* name, uns buckets,
 void init_complex_hash_table(Hash_Table* table, const char* name, uns buckets,
                              uns data_size,
                              Flag (*eq_func)(void const*, void const*)) {
+  uns capacity = HASH_MIN_CAPACITY;
+  while(capacity < HASH_MAX_INIT_CAPACITY && 7 * capacity < 8 * buckets)
+    capacity *= 2;
+
   table->name      = strdup(name);
-  table->buckets   = buckets;
   table->data_size = data_size;
   table->count     = 0;
-  table->entries   = (Hash_Table_Entry**)calloc(buckets,
-                                              sizeof(Hash_Table_Entry*));
+  table->capacity  = 0;
+  table->deleted   = 0;
+  table->ctrl      = NULL;
+  table->slots     = NULL;
   table->eq_func   = eq_func;
+  init_arena(&table->data_arena, table->name,
+             MAX2(HASH_ARENA_BLOCK, data_size));
+  hash_table_resize(table, capacity);
+}
+
+
+/**************************************************************************************/
+/* hash_table_resize: moves every entry to a table of 'capacity' slots (this
+   also drops the deleted entries) */
+
+static void hash_table_resize(Hash_Table* table, uns capacity) {
+  uns8*            old_ctrl     = table->ctrl;
+  Hash_Table_Slot* old_slots    = table->slots;
+  uns              old_capacity = table->capacity;
+  uns              ii;
+
+  ASSERT(0, capacity >= HASH_MIN_CAPACITY && !(capacity & (capacity - 1)));
+  ASSERT(0, 8 * (uns64)table->count < 7 * (uns64)capacity);
+  table->capacity = capacity;
+  table->deleted  = 0;
+  table->ctrl     = (uns8*)malloc(capacity + HASH_GROUP_SIZE);
+  table->slots    = (Hash_Table_Slot*)malloc(capacity * sizeof(Hash_Table_Slot));
+  ASSERTM(0, table->ctrl && table->slots,
+          "Could not allocate %u slots for %s\n", capacity, table->name);
+  memset(table->ctrl, HASH_CTRL_EMPTY, capacity + HASH_GROUP_SIZE);
+
+  for(ii = 0; ii < old_capacity; ii++) {
+    if(old_ctrl[ii] & HASH_CTRL_EMPTY)
+      continue;
+    uns64 hash = hash_key(old_slots[ii].key);
+    uns   mask = capacity - 1;
+    uns   pos  = (hash >> 7) & mask;
+    uns   step = 0;
+    uns   free_mask;
+    while(!(free_mask = hash_group_free(table->ctrl + pos))) {
+      step += HASH_GROUP_SIZE;
+      pos = (pos + step) & mask;
+    }
+    pos = (pos + __builtin_ctz(free_mask)) & mask;
+    hash_set_ctrl(table, pos, hash & 0x7F);
+    table->slots[pos] = old_slots[ii];
+  }
+  free(old_ctrl);
+  free(old_slots);
+}
+
+
+/**************************************************************************************/
+/* hash_table_find: returns the slot of the entry with 'key' (and, for complex
+   tables, equal to 'data'), or NULL. Groups are probed with growing strides,
+   which visits every group of a power-of-two table; an empty slot ends the
+   search since an entry is never placed past an empty slot. */
+
+static inline Hash_Table_Slot* hash_table_find(Hash_Table const* table,
+                                               int64 key, void const* data) {
+  uns64 hash = hash_key(key);
+  uns8  h2   = hash & 0x7F;
+  uns   mask = table->capacity - 1;
+  uns   pos  = (hash >> 7) & mask;
+  uns   step = 0;
+
+  for(;;) {
+    const uns8* group = table->ctrl + pos;
+    uns         match;
+    for(match = hash_group_match(group, h2); match; match &= match - 1) {
+      Hash_Table_Slot* slot = &table->slots[(pos + __builtin_ctz(match)) &
+                                            mask];
+      if(slot->key == key && (!data || table->eq_func(slot->data, data)))
+        return slot;
+    }
+    if(hash_group_empty(group))
+      return NULL;
+    step += HASH_GROUP_SIZE;
+    pos = (pos + step) & mask;
+  }
+}
+
+
+/**************************************************************************************/
+/* hash_table_insert: claims a slot for a new entry with 'key'; the caller
+   sets its data */
+
+static Hash_Table_Slot* hash_table_insert(Hash_Table* table, int64 key) {
+  uns64 hash;
+  uns   mask, pos, step, free_mask;
+
+  if(8 * (uns64)(table->count + table->deleted + 1) > 7 * (uns64)table->capacity) {
+    /* grow if mostly live, otherwise just sweep out the deleted entries */
+    if(16 * (uns64)(table->count + 1) > 7 * (uns64)table->capacity)
+      hash_table_resize(table, 2 * table->capacity);
+    else
+      hash_table_resize(table, table->capacity);
+  }
+
+  hash = hash_key(key);
+  mask = table->capacity - 1;
+  pos  = (hash >> 7) & mask;
+  step = 0;
+  while(!(free_mask = hash_group_free(table->ctrl + pos))) {
+    step += HASH_GROUP_SIZE;
+    pos = (pos + step) & mask;
+  }
+  pos = (pos + __builtin_ctz(free_mask)) & mask;
+  if(table->ctrl[pos] == HASH_CTRL_DELETED)
+    table->deleted--;
+  hash_set_ctrl(table, pos, hash & 0x7F);
+  table->count++;
+  table->slots[pos].key = key;
+  return &table->slots[pos];
+}
+
+
+/**************************************************************************************/
+/* hash_table_delete: frees the entry of a slot. The slot can go back to empty
+   unless it sits in a run of HASH_GROUP_SIZE or more non-empty slots, in
+   which case some probe may have passed over it. */
+
+static void hash_table_delete(Hash_Table* table, Hash_Table_Slot* slot) {
+  uns mask         = table->capacity - 1;
+  uns idx          = slot - table->slots;
+  uns empty_before = hash_group_empty(table->ctrl +
+                                      ((idx - HASH_GROUP_SIZE) & mask));
+  uns empty_after  = hash_group_empty(table->ctrl + idx);
+
+  arena_free(&table->data_arena, slot->data, table->data_size);
+  if(empty_before && empty_after &&
+     __builtin_ctz(empty_after) + (__builtin_clz(empty_before) - 16) <
+       HASH_GROUP_SIZE) {
+    hash_set_ctrl(table, idx, HASH_CTRL_EMPTY);
+  } else {
+    hash_set_ctrl(table, idx, HASH_CTRL_DELETED);
+    table->deleted++;
+  }
+  table->count--;
+  ASSERT(0, table->count >= 0);
 }
 
 
@@ -90,35 +303,19 @@ void init_complex_hash_table(Hash_Table* table, const char* name, uns buckets,
 
 
 void* hash_table_access(Hash_Table const* table, int64 key) {
-  // {{{ access hash table using simple key compare
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-
-  for(temp = bucket; temp != NULL; temp = temp->next)
-    if(temp->key == key)
-      return temp->data;
-
-  return NULL;
-  // }}}
+  Hash_Table_Slot* slot = hash_table_find(table, key, NULL);
+  return slot ? slot->data : NULL;
 }
 
 void* complex_hash_table_access(Hash_Table const* table, int64 key,
                                 void const* data) {
-  // {{{ access hash table using a complex comparison
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
+  Hash_Table_Slot* slot;
 
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
 
-  for(temp = bucket; temp != NULL; temp = temp->next)
-    if(temp->key == key && table->eq_func(temp->data, data))
-      return temp->data;
-
-  return NULL;
-  // }}}
+  slot = hash_table_find(table, key, data);
+  return slot ? slot->data : NULL;
 }
 
 
@@ -128,83 +325,42 @@ void* complex_hash_table_access(Hash_Table const* table, int64 key,
    entry and return its data pointer. */
 
 void* hash_table_access_create(Hash_Table* table, int64 key, Flag* new_entry) {
-  // {{{ access hash table using simple key compare
-  uns               index    = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket   = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
+  Hash_Table_Slot* slot = hash_table_find(table, key, NULL);
 
   *new_entry = FALSE;
-  ASSERT(0, index < table->buckets);
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key)
-      return temp->data;
-    else
-      prev = temp;
-  }
-  table->count++;
+  if(slot)
+    return slot->data;
+
   *new_entry = TRUE;
-  new_hash   = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key  = key;
-  new_hash->next = NULL;
-  new_hash->data = (void*)smalloc(table->data_size);
-  ASSERT(0, new_hash->data);
-
-  if(prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry) + table->data_size,
+  slot       = hash_table_insert(table, key);
+  slot->data = arena_alloc(&table->data_arena, table->data_size);
+
+  _DEBUGA(0, 0, "allocated %u bytes for %s (%d entries)\n", table->data_size,
           table->name, table->count);
 
-  return new_hash->data;
-  // }}}
+  return slot->data;
 }
 
 void* complex_hash_table_access_create(Hash_Table* table, int64 key,
                                        void const* data, Flag* new_entry) {
-  // {{{ access hash table using a complex comparison
-  uns               index    = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket   = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
+  Hash_Table_Slot* slot;
 
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
 
   *new_entry = FALSE;
-  ASSERT(0, index < table->buckets);
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key && table->eq_func(temp->data, data))
-      return temp->data;
-    else
-      prev = temp;
-  }
-  table->count++;
+  slot       = hash_table_find(table, key, data);
+  if(slot)
+    return slot->data;
+
   *new_entry = TRUE;
-  new_hash   = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key  = key;
-  new_hash->next = NULL;
-  new_hash->data = (void*)smalloc(table->data_size);
-  ASSERT(0, new_hash->data);
-
-  if(prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry) + table->data_size,
+  slot       = hash_table_insert(table, key);
+  slot->data = arena_alloc(&table->data_arena, table->data_size);
+
+  _DEBUGA(0, 0, "allocated %u bytes for %s (%d entries)\n", table->data_size,
           table->name, table->count);
 
-  return new_hash->data;
-  // }}}
+  return slot->data;
 }
 
 
@@ -213,61 +369,26 @@ void* complex_hash_table_access_create(Hash_Table* table, int64 key,
    TRUE if it was found, FALSE otherwise */
 
 Flag hash_table_access_delete(Hash_Table* table, int64 key) {
-  // {{{ access hash table using simple key compare
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key) {
-      Hash_Table_Entry* next_ptr = temp->next;
-      sfree(table->data_size, temp->data);
-      sfree(sizeof(Hash_Table_Entry), temp);
-      if(prev)
-        prev->next = next_ptr;
-      else
-        table->entries[index] = next_ptr;
-      table->count--;
-      ASSERT(0, table->count >= 0);
-      return TRUE;
-    } else
-      prev = temp;
-  }
+  Hash_Table_Slot* slot = hash_table_find(table, key, NULL);
 
-  return FALSE;
-  // }}}
+  if(!slot)
+    return FALSE;
+  hash_table_delete(table, slot);
+  return TRUE;
 }
 
 Flag complex_hash_table_access_delete(Hash_Table* table, int64 key,
                                       void const* data) {
-  // {{{ access hash table using a complex comparison
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
+  Hash_Table_Slot* slot;
 
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
 
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key && table->eq_func(temp->data, data)) {
-      Hash_Table_Entry* next_ptr = temp->next;
-      sfree(table->data_size, temp->data);
-      sfree(sizeof(Hash_Table_Entry), temp);
-      if(prev)
-        prev->next = next_ptr;
-      else
-        table->entries[index] = next_ptr;
-      table->count--;
-      ASSERT(0, table->count >= 0);
-      return TRUE;
-    } else
-      prev = temp;
-  }
-
-  return FALSE;
-  // }}}
+  slot = hash_table_find(table, key, data);
+  if(!slot)
+    return FALSE;
+  hash_table_delete(table, slot);
+  return TRUE;
 }
 
 
@@ -275,24 +396,10 @@ Flag complex_hash_table_access_delete(Hash_Table* table, int64 key,
 /* hash_table_clear: */
 
 void hash_table_clear(Hash_Table* table) {
-  Hash_Table_Entry* temp0;
-  Hash_Table_Entry* temp1;
-  uns               count = 0;
-  int               ii;
-
-  for(ii = 0; ii < table->buckets; ii++) {
-    temp0 = table->entries[ii];
-    while(temp0) {
-      temp1 = temp0->next;
-      sfree(table->data_size, temp0->data);
-      sfree(sizeof(Hash_Table_Entry), temp0);
-      temp0 = temp1;
-      count++;
-    }
-    table->entries[ii] = NULL;
-  }
-  ASSERT(0, count == table->count);
-  table->count = 0;
+  memset(table->ctrl, HASH_CTRL_EMPTY, table->capacity + HASH_GROUP_SIZE);
+  arena_clear(&table->data_arena);
+  table->count   = 0;
+  table->deleted = 0;
 }
 
 
@@ -302,10 +409,9 @@ void hash_table_clear(Hash_Table* table) {
  */
 
 void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
-  Hash_Table_Entry* temp;
-  void**            new_array;
-  uns               count = 0;
-  int               ii;
+  void** new_array;
+  uns    count = 0;
+  uns    ii;
 
   if(table->count == 0)
     return NULL;
@@ -318,13 +424,9 @@ void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
   }
 
   /* write into the new array */
-  count = 0;
-  for(ii = 0; ii < table->buckets; ii++) {
-    temp = table->entries[ii];
-    while(temp) {
-      new_array[count++] = temp->data;
-      temp               = temp->next;
-    }
+  for(ii = 0; ii < table->capacity; ii++) {
+    if(!(table->ctrl[ii] & HASH_CTRL_EMPTY))
+      new_array[count++] = table->slots[ii].data;
   }
 
   ASSERTM(0, count == table->count, "%d %d\n", count, table->count);
@@ -340,21 +442,18 @@ void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
 
 void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*),
                      void*       arg) {
-  int               count = 0;
-  Hash_Table_Entry* temp;
-  int               ii;
+  int count = 0;
+  uns ii;
 
   ASSERT(0, scan_func);
 
   if(table->count == 0)
     return;
 
-  for(ii = 0; ii < table->buckets; ii++) {
-    temp = table->entries[ii];
-    while(temp) {
+  for(ii = 0; ii < table->capacity; ii++) {
+    if(!(table->ctrl[ii] & HASH_CTRL_EMPTY)) {
       count++;
-      scan_func(temp->data, arg);
-      temp = temp->next;
+      scan_func(table->slots[ii].data, arg);
     }
   }
   ASSERT(0, count == table->count);
@@ -362,99 +461,34 @@ void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*),
 
 
 /**************************************************************************************/
-// hash_table_rehash: expand or contract the hash table
-// WARNING: this hasn't really been tested
+// hash_table_rehash: resize the hash table for 'new_buckets' entries (0
+// doubles it); it never shrinks below what the current entries need
 
 void hash_table_rehash(Hash_Table* table, int new_buckets) {
-  Hash_Table_Entry** new_entries;
-  Hash_Table_Entry** flat_entries;
-  Hash_Table_Entry** old_entries = table->entries;
-  uns                old_buckets = table->buckets;
-  Hash_Table_Entry*  temp;
-  uns                ii, jj;
+  uns capacity = HASH_MIN_CAPACITY;
 
   ASSERT(0, new_buckets >= 0);
-  if(new_buckets == 0) {  // use next prime
-    new_buckets = table->buckets;
-    for(ii = 0; ii < NUM_HASH_TABLE_PRIMES - 1; ii++)
-      if(hash_table_primes[ii] == old_buckets) {
-        new_buckets = hash_table_primes[ii + 1];
-        break;
-      }
-  }
-  if(new_buckets == old_buckets)
-    return;
-
-  // flatten hash table into an array of entries
-  flat_entries = (Hash_Table_Entry**)malloc(table->count *
-                                            sizeof(Hash_Table_Entry*));
-  for(ii = 0, jj = 0; ii < old_buckets; ii++)
-    for(temp = old_entries[ii]; temp; temp = temp->next)
-      flat_entries[jj++] = temp;
-  ASSERT(0, jj == table->count);
-
-  // replace old with new and free the old entry array
-  new_entries = (Hash_Table_Entry**)calloc(new_buckets,
-                                           sizeof(Hash_Table_Entry*));
-  ASSERT(0, new_entries);
-  ASSERT(0, new_buckets > 0 && new_buckets < 100000);
-  table->buckets = new_buckets;
-  table->entries = new_entries;
-  free(old_entries);
-
-  // insert each element
-  for(ii = 0; ii < table->count; ii++) {
-    Hash_Table_Entry* temp  = flat_entries[ii];
-    uns               index = HASH_INDEX(table, temp->key);
-    temp->next              = table->entries[index];
-    table->entries[index]   = temp;
-  }
-
-  free(flat_entries);
+  if(new_buckets == 0)
+    capacity = 2 * table->capacity;
+  while(7 * (uns64)capacity <= 8 * (uns64)MAX2((uns)new_buckets,
+                                                (uns)table->count))
+    capacity *= 2;
+  hash_table_resize(table, capacity);
 }
 
 /**************************************************************************************/
 // hash_table_access_replace: replace the data in an existing entry, or create
 // it
 //                            if it doesn't exist yet
+// The table does not own 'replacement': such entries must not be deleted.
 void hash_table_access_replace(Hash_Table* table, int64 key,
                                void* replacement) {
-  // {{{ access hash table using simple key compare
-  uns               index    = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket   = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev      = NULL;
-  Flag              new_entry = FALSE;
-  UNUSED(new_entry);
+  Hash_Table_Slot* slot = hash_table_find(table, key, NULL);
+
   ASSERT(0, replacement);
-  ASSERT(0, index < table->buckets);
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key) {
-      /* May not want to free the memory in case there are other valid pointers
-         to it. ASSERT(0,temp->data); free(table->data_size, temp->data);
-      */
-      temp->data = replacement;
-      return;
-    } else {
-      prev = temp;
-    }
-  }
-  table->count++;
-  new_entry = TRUE;
-  new_hash  = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key  = key;
-  new_hash->next = NULL;
-  new_hash->data = replacement;
-
-  if(prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry), table->name,
-          table->count);
-  // }}}
+  if(!slot)
+    slot = hash_table_insert(table, key);
+  /* May not want to free the memory in case there are other valid pointers
+     to it. */
+  slot->data = replacement;
 }
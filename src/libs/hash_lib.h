@@ -30,23 +30,34 @@
 #define __HASH_LIB_H__
 
 #include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "libs/arena_lib.h"
 
 
 /**************************************************************************************/
 /* Types */
 
-typedef struct Hash_Table_Entry_struct {
-  int64                           key;
-  void*                           data;
-  struct Hash_Table_Entry_struct* next;
-} Hash_Table_Entry;
+/* The table is open addressing in the style of Swiss tables: a control byte
+   per slot (empty, deleted, or 7 bits of the key's hash) is probed 16 slots
+   at a time, and only slots whose control byte matches are compared. The
+   entry data lives in an arena, so data pointers stay valid until the entry
+   is deleted, however the table grows. */
+
+typedef struct Hash_Table_Slot_struct {
+  int64 key;
+  void* data;
+} Hash_Table_Slot;
 
 typedef struct Hash_Table_struct {
-  char*              name;
-  uns                buckets;
-  uns                data_size;
-  int                count;  // total number of elements in the hash table
-  Hash_Table_Entry** entries;
+  char*            name;
+  uns              data_size;
+  int              count;     // total number of elements in the hash table
+  uns              capacity;  // number of slots (a power of two)
+  uns              deleted;   // number of slots holding a deleted entry
+  uns8*            ctrl;      // control bytes; the first group is repeated
+                              // after the last slot so groups never wrap
+  Hash_Table_Slot* slots;
+  Arena            data_arena;
   Flag (*eq_func)(void const* const, void const* const);
 } Hash_Table;
 
@@ -0,0 +1,267 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/line_table.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Per-cache-line bookkeeping without a heap node per line.
+ *                Line_Table is an open-addressing (linear probing) map from
+ *                line address to a value; the values live in a block arena
+ *                in insertion order, so pointers to them stay valid and a
+ *                walk over the table touches memory sequentially.  A table
+ *                can be bounded (inserts past 'max_lines' are dropped and
+ *                counted) and sampled (only lines whose hash falls in one of
+ *                2^'sample_bits' buckets are tracked).  Line_History keeps an
+ *                append-only event list per line in a shared arena.
+ ***************************************************************************************/
+
+#ifndef __LINE_TABLE_H__
+#define __LINE_TABLE_H__
+
+#include <memory>
+#include <vector>
+
+extern "C" {
+#include "globals/global_types.h"
+}
+
+/**************************************************************************************/
+/* Line_Arena: growable array made of fixed-size blocks; never moves elements */
+
+template <typename T>
+class Line_Arena {
+ public:
+  static constexpr uns BLOCK_BITS = 12;
+  static constexpr uns BLOCK_SIZE = 1 << BLOCK_BITS;
+
+  Line_Arena() : count(0) {}
+
+  uns size() const { return count; }
+
+  T&       operator[](uns idx) { return blocks[idx >> BLOCK_BITS][idx & (BLOCK_SIZE - 1)]; }
+  const T& operator[](uns idx) const { return blocks[idx >> BLOCK_BITS][idx & (BLOCK_SIZE - 1)]; }
+
+  uns push_back(const T& elem) {
+    if((count & (BLOCK_SIZE - 1)) == 0 && (count >> BLOCK_BITS) == blocks.size())
+      blocks.emplace_back(new T[BLOCK_SIZE]);
+    (*this)[count] = elem;
+    return count++;
+  }
+
+  void clear() {
+    blocks.clear();
+    count = 0;
+  }
+
+ private:
+  std::vector<std::unique_ptr<T[]>> blocks;
+  uns                               count;
+};
+
+/**************************************************************************************/
+/* Line_Table */
+
+template <typename V>
+class Line_Table {
+ public:
+  typedef V Value;
+
+  explicit Line_Table(uns max_lines = 0, uns sample_bits = 0) :
+      max_lines(max_lines), sample_mask((1ULL << sample_bits) - 1), dropped(0) {
+    resize_slots(MIN_SLOTS);
+  }
+
+  /* Changes the bound and the sampling rate; only allowed while empty */
+  void configure(uns new_max_lines, uns new_sample_bits) {
+    max_lines   = new_max_lines;
+    sample_mask = (1ULL << new_sample_bits) - 1;
+  }
+
+  uns     size() const { return entries.size(); }
+  Counter get_dropped() const { return dropped; }
+
+  /* TRUE if lines like this one are kept by a sampled table */
+  Flag sampled(Addr line) const { return ((hash(line) >> 40) & sample_mask) == 0; }
+
+  V* find(Addr line) {
+    for(uns pos = hash(line) & mask;; pos = (pos + 1) & mask) {
+      if(slots[pos].idx == EMPTY)
+        return NULL;
+      if(slots[pos].line == line)
+        return &entries[slots[pos].idx].value;
+    }
+  }
+
+  /* Returns the value of 'line', inserting 'init' first if the line is new.
+     Returns NULL if the line is sampled out or the table is full. */
+  V* insert(Addr line, const V& init, Flag* inserted = NULL) {
+    if(inserted)
+      *inserted = FALSE;
+    uns pos = hash(line) & mask;
+    for(; slots[pos].idx != EMPTY; pos = (pos + 1) & mask) {
+      if(slots[pos].line == line)
+        return &entries[slots[pos].idx].value;
+    }
+    if(!sampled(line))
+      return NULL;
+    if(max_lines && entries.size() >= max_lines) {
+      dropped++;
+      return NULL;
+    }
+    if(4 * (entries.size() + 1) > 3 * (mask + 1)) {
+      resize_slots(2 * (mask + 1));
+      for(pos = hash(line) & mask; slots[pos].idx != EMPTY; pos = (pos + 1) & mask)
+        ;
+    }
+    slots[pos].line = line;
+    slots[pos].idx  = entries.push_back(Entry{line, init});
+    if(inserted)
+      *inserted = TRUE;
+    return &entries[slots[pos].idx].value;
+  }
+
+  /* Calls f(line, value) for every line in insertion order */
+  template <typename F>
+  void for_each(F f) {
+    for(uns ii = 0; ii < entries.size(); ii++)
+      f(entries[ii].line, entries[ii].value);
+  }
+
+  void clear() {
+    entries.clear();
+    resize_slots(MIN_SLOTS);
+    dropped = 0;
+  }
+
+ private:
+  static constexpr uns MIN_SLOTS = 64;
+  static constexpr uns EMPTY     = (uns)-1;
+
+  struct Slot {
+    Addr line;
+    uns  idx;
+  };
+  struct Entry {
+    Addr line;
+    V    value;
+  };
+
+  uns               max_lines;
+  uns64             sample_mask;
+  Counter           dropped;
+  std::vector<Slot> slots;
+  uns               mask;
+  Line_Arena<Entry> entries;
+
+  static uns64 hash(Addr line) {
+    uns64 x = (uns64)line;
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    return x;
+  }
+
+  void resize_slots(uns num_slots) {
+    slots.assign(num_slots, Slot{0, EMPTY});
+    mask = num_slots - 1;
+    for(uns ii = 0; ii < entries.size(); ii++) {
+      uns pos = hash(entries[ii].line) & mask;
+      while(slots[pos].idx != EMPTY)
+        pos = (pos + 1) & mask;
+      slots[pos].line = entries[ii].line;
+      slots[pos].idx  = ii;
+    }
+  }
+};
+
+/**************************************************************************************/
+/* Line_History: per-line event lists threaded through one shared arena */
+
+template <typename T>
+class Line_History {
+ public:
+  explicit Line_History(uns max_lines = 0, uns sample_bits = 0) :
+      chains(max_lines, sample_bits) {}
+
+  void configure(uns max_lines, uns sample_bits) {
+    chains.configure(max_lines, sample_bits);
+  }
+
+  uns     size() const { return chains.size(); }
+  Counter get_dropped() const { return chains.get_dropped(); }
+  Flag    sampled(Addr line) const { return chains.sampled(line); }
+
+  void append(Addr line, const T& event) {
+    Chain* chain = chains.insert(line, Chain{NONE, NONE, 0});
+    if(!chain)
+      return;
+    uns idx = events.push_back(Event{event, NONE});
+    if(chain->tail == NONE)
+      chain->head = idx;
+    else
+      events[chain->tail].next = idx;
+    chain->tail = idx;
+    chain->length++;
+  }
+
+  uns length(Addr line) {
+    Chain* chain = chains.find(line);
+    return chain ? chain->length : 0;
+  }
+
+  /* Calls f(event) for every event of 'line', oldest first */
+  template <typename F>
+  void for_each_event(Addr line, F f) {
+    Chain* chain = chains.find(line);
+    for(uns idx = chain ? chain->head : NONE; idx != NONE; idx = events[idx].next)
+      f(events[idx].event);
+  }
+
+  /* Calls f(line) for every line in order of first event */
+  template <typename F>
+  void for_each_line(F f) {
+    chains.for_each([&](Addr line, Chain&) { f(line); });
+  }
+
+  void clear() {
+    chains.clear();
+    events.clear();
+  }
+
+ private:
+  static constexpr uns NONE = (uns)-1;
+
+  struct Chain {
+    uns head;
+    uns tail;
+    uns length;
+  };
+  struct Event {
+    T   event;
+    uns next;
+  };
+
+  Line_Table<Chain>  chains;
+  Line_Arena<Event>  events;
+};
+
+#endif /* #ifndef __LINE_TABLE_H__ */
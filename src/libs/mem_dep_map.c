@@ -0,0 +1,228 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/mem_dep_map.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Memory dependence map
+ ***************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug/debug_macros.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "libs/mem_dep_map.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+static inline uns  mem_dep_home(const Mem_Dep_Map* map, Addr word_addr);
+static inline uns  mem_dep_find_slot(const Mem_Dep_Map* map, Addr word_addr);
+static inline uns  mem_dep_flags(const Mem_Dep_Map* map, const Mem_Dep_Word* word);
+static void        mem_dep_resize(Mem_Dep_Map* map, uns num_slots);
+static void        mem_dep_delete(Mem_Dep_Map* map, uns pos);
+
+/**************************************************************************************/
+/* mem_dep_home: first table slot probed for a word */
+
+static inline uns mem_dep_home(const Mem_Dep_Map* map, Addr word_addr) {
+  uns64 x = (uns64)word_addr >> MEM_DEP_WORD_SIZE_LOG;
+  x ^= x >> 33;
+  x *= 0xFF51AFD7ED558CCDULL;
+  x ^= x >> 33;
+  return (uns)x & map->mask;
+}
+
+/**************************************************************************************/
+/* mem_dep_find_slot: slot of the word, or the empty slot where it would go */
+
+static inline uns mem_dep_find_slot(const Mem_Dep_Map* map, Addr word_addr) {
+  uns pos = mem_dep_home(map, word_addr);
+  while(map->words[pos].store_mask && map->words[pos].word_addr != word_addr)
+    pos = (pos + 1) & map->mask;
+  return pos;
+}
+
+/**************************************************************************************/
+/* mem_dep_flags: off-path flags of the word (none since the last recovery) */
+
+static inline uns mem_dep_flags(const Mem_Dep_Map* map,
+                                const Mem_Dep_Word* word) {
+  return word->flag_epoch == map->epoch ? word->flag_mask : 0;
+}
+
+/**************************************************************************************/
+/* init_mem_dep_map: the table starts with room for num_words words */
+
+void init_mem_dep_map(Mem_Dep_Map* map, const char* name, uns num_words) {
+  uns num_slots = 16;
+  while(3 * num_slots < 4 * num_words)
+    num_slots *= 2;
+
+  memset(map, 0, sizeof(Mem_Dep_Map));
+  map->name  = name;
+  map->epoch = 1;
+  mem_dep_resize(map, num_slots);
+}
+
+/**************************************************************************************/
+/* mem_dep_resize: rehashes every word into a table of num_slots slots */
+
+static void mem_dep_resize(Mem_Dep_Map* map, uns num_slots) {
+  Mem_Dep_Word* old_words = map->words;
+  uns           old_slots = old_words ? map->mask + 1 : 0;
+  uns           ii;
+
+  ASSERT(0, (num_slots & (num_slots - 1)) == 0);
+  map->words = (Mem_Dep_Word*)calloc(num_slots, sizeof(Mem_Dep_Word));
+  ASSERTM(0, map->words, "Could not allocate %u words for %s\n", num_slots,
+          map->name);
+  map->mask = num_slots - 1;
+  for(ii = 0; ii < old_slots; ii++) {
+    if(old_words[ii].store_mask)
+      map->words[mem_dep_find_slot(map, old_words[ii].word_addr)] =
+        old_words[ii];
+  }
+  free(old_words);
+}
+
+/**************************************************************************************/
+/* mem_dep_delete: empties a slot, shifting back the words probed past it so
+   lookups never need tombstones */
+
+static void mem_dep_delete(Mem_Dep_Map* map, uns pos) {
+  uns next = pos;
+
+  for(;;) {
+    next = (next + 1) & map->mask;
+    if(!map->words[next].store_mask)
+      break;
+    uns home = mem_dep_home(map, map->words[next].word_addr);
+    /* the word can move back to pos if its home is not in (pos, next] */
+    if(((next - home) & map->mask) >= ((next - pos) & map->mask)) {
+      map->words[pos] = map->words[next];
+      pos             = next;
+    }
+  }
+  map->words[pos].store_mask = 0;
+  map->count--;
+}
+
+/**************************************************************************************/
+/* mem_dep_map_write: makes op the youngest store of the bytes in byte_mask */
+
+void mem_dep_map_write(Mem_Dep_Map* map, Addr word_addr, uns byte_mask,
+                       Flag off_path, struct Op_struct* op) {
+  uns           pos   = mem_dep_find_slot(map, word_addr);
+  Mem_Dep_Word* word  = &map->words[pos];
+  uns           slots = mem_dep_slots(byte_mask, off_path);
+
+  ASSERT(0, byte_mask && !(byte_mask & ~MEM_DEP_ALL_BYTES));
+  if(!word->store_mask) {
+    if(4 * (map->count + 1) > 3 * (map->mask + 1)) {
+      mem_dep_resize(map, 2 * (map->mask + 1));
+      word = &map->words[mem_dep_find_slot(map, word_addr)];
+    }
+    word->word_addr  = word_addr;
+    word->flag_mask  = 0;
+    word->flag_epoch = map->epoch;
+    map->count++;
+  }
+
+  word->flag_mask  = mem_dep_flags(map, word);
+  word->flag_epoch = map->epoch;
+  if(off_path)
+    word->flag_mask |= byte_mask;
+  else
+    word->flag_mask &= ~byte_mask;
+  word->store_mask |= slots;
+  for(; slots; slots &= slots - 1)
+    word->op[__builtin_ctz(slots)] = op;
+}
+
+/**************************************************************************************/
+/* mem_dep_map_release: forgets op as the store of the bytes in byte_mask that
+   no younger store has overwritten; drops the word once no store is left */
+
+void mem_dep_map_release(Mem_Dep_Map* map, Addr word_addr, uns byte_mask,
+                         Flag off_path, struct Op_struct* op) {
+  uns           pos  = mem_dep_find_slot(map, word_addr);
+  Mem_Dep_Word* word = &map->words[pos];
+  uns           slots;
+
+  if(!word->store_mask)
+    return;
+
+  for(slots = word->store_mask & mem_dep_slots(byte_mask, off_path); slots;
+      slots &= slots - 1) {
+    uns slot = __builtin_ctz(slots);
+    if(word->op[slot] == op)
+      word->store_mask &= ~(1 << slot);
+  }
+  if(!word->store_mask)
+    mem_dep_delete(map, pos);
+}
+
+/**************************************************************************************/
+/* mem_dep_map_read: returns the slots of *word that hold the stores a read of
+   the bytes in byte_mask depends on (0 if there are none) */
+
+uns mem_dep_map_read(Mem_Dep_Map* map, Addr word_addr, uns byte_mask,
+                     Mem_Dep_Word** word) {
+  uns pos = mem_dep_find_slot(map, word_addr);
+  uns flags;
+
+  *word = &map->words[pos];
+  if(!(*word)->store_mask)
+    return 0;
+
+  flags = mem_dep_flags(map, *word);
+  return (*word)->store_mask & (mem_dep_slots(byte_mask & ~flags, FALSE) |
+                                mem_dep_slots(byte_mask & flags, TRUE));
+}
+
+/**************************************************************************************/
+/* mem_dep_map_recover: makes the on-path stores the youngest ones again. The
+   off-path stores stay in the map until they are released. */
+
+void mem_dep_map_recover(Mem_Dep_Map* map) {
+  if(++map->epoch == 0) {
+    /* the epoch wrapped around, old flags could look current again */
+    for(uns ii = 0; ii <= map->mask; ii++)
+      map->words[ii].flag_mask = 0;
+    map->epoch = 1;
+  }
+}
+
+/**************************************************************************************/
+/* free_mem_dep_map: */
+
+void free_mem_dep_map(Mem_Dep_Map* map) {
+  free(map->words);
+  memset(map, 0, sizeof(Mem_Dep_Map));
+}
@@ -0,0 +1,141 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/mem_dep_map.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Memory dependence map: for every 8-byte word written by an
+ *                in-flight store, the youngest on-path and off-path store of
+ *                each byte.  An access is turned into one byte mask per word,
+ *                so reads, writes and releases are bitwise operations on the
+ *                word instead of per-byte walks.  Words live in an
+ *                open-addressing (linear probing) table.
+ ***************************************************************************************/
+
+#ifndef __MEM_DEP_MAP_H__
+#define __MEM_DEP_MAP_H__
+
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/utils.h"
+
+/**************************************************************************************/
+/* Defines */
+
+#define MEM_DEP_WORD_SIZE_LOG 3
+#define MEM_DEP_WORD_SIZE (1 << MEM_DEP_WORD_SIZE_LOG)
+#define MEM_DEP_WORD_ADDR(va) ((va) & ~(Addr)(MEM_DEP_WORD_SIZE - 1))
+#define MEM_DEP_BYTE_IN_WORD(va) ((va) & (MEM_DEP_WORD_SIZE - 1))
+#define MEM_DEP_ALL_BYTES N_BIT_MASK(MEM_DEP_WORD_SIZE)
+
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Mem_Dep_Word_struct {
+  Addr  word_addr;
+  uns16 store_mask; /* slots holding a store; 0 marks an empty table slot */
+  uns8  flag_mask;  /* bytes whose youngest store is off-path */
+  uns32 flag_epoch; /* flag_mask is only valid in this epoch of the map */
+  /* youngest store of each byte, on-path in slot 2 * byte and off-path in
+     slot 2 * byte + 1, so slot masks visit the bytes in address order */
+  struct Op_struct* op[2 * MEM_DEP_WORD_SIZE];
+} Mem_Dep_Word;
+
+typedef struct Mem_Dep_Map_struct {
+  const char*   name;
+  Mem_Dep_Word* words;
+  uns           mask; /* number of table slots - 1 */
+  uns           count;
+  uns32         epoch; /* bumped by mem_dep_map_recover() */
+} Mem_Dep_Map;
+
+/* walks the words touched by an access, giving the bytes touched in each */
+typedef struct Mem_Dep_Traversal_struct {
+  Addr word_addr; /* current word */
+  uns  byte_mask; /* bytes of the current word that are accessed */
+  Addr last_word_addr;
+  uns  last_byte_mask; /* bytes of the last word that are accessed */
+} Mem_Dep_Traversal;
+
+/**************************************************************************************/
+/* Prototypes */
+
+void  init_mem_dep_map(Mem_Dep_Map* map, const char* name, uns num_words);
+void  mem_dep_map_write(Mem_Dep_Map* map, Addr word_addr, uns byte_mask,
+                        Flag off_path, struct Op_struct* op);
+void  mem_dep_map_release(Mem_Dep_Map* map, Addr word_addr, uns byte_mask,
+                          Flag off_path, struct Op_struct* op);
+uns   mem_dep_map_read(Mem_Dep_Map* map, Addr word_addr, uns byte_mask,
+                       Mem_Dep_Word** word);
+void  mem_dep_map_recover(Mem_Dep_Map* map);
+void  free_mem_dep_map(Mem_Dep_Map* map);
+
+/**************************************************************************************/
+/* mem_dep_slots: slot mask of the bytes in byte_mask */
+
+static inline uns mem_dep_slots(uns byte_mask, Flag off_path) {
+  uns slots = byte_mask;
+  slots     = (slots | (slots << 4)) & 0x0F0F;
+  slots     = (slots | (slots << 2)) & 0x3333;
+  slots     = (slots | (slots << 1)) & 0x5555;
+  return off_path ? slots << 1 : slots;
+}
+
+/**************************************************************************************/
+/* Traversal */
+
+static inline void mem_dep_traversal_init(Mem_Dep_Traversal* traversal,
+                                          Addr va, uns size) {
+  Addr last_va = ADDR_PLUS_OFFSET(va, size - 1); /* last byte in access */
+
+  traversal->word_addr      = MEM_DEP_WORD_ADDR(va);
+  traversal->last_word_addr = MEM_DEP_WORD_ADDR(last_va);
+  traversal->last_byte_mask = MEM_DEP_ALL_BYTES >>
+                              (MEM_DEP_WORD_SIZE - 1 - MEM_DEP_BYTE_IN_WORD(last_va));
+  traversal->byte_mask = (MEM_DEP_ALL_BYTES << MEM_DEP_BYTE_IN_WORD(va)) &
+                         MEM_DEP_ALL_BYTES;
+  if(traversal->word_addr == traversal->last_word_addr)
+    traversal->byte_mask &= traversal->last_byte_mask;
+
+  if(size == 0) {
+    /* nothing to traverse */
+    traversal->last_word_addr = traversal->word_addr;
+    traversal->word_addr      = ADDR_PLUS_OFFSET(traversal->word_addr,
+                                                 MEM_DEP_WORD_SIZE);
+  }
+}
+
+static inline Flag mem_dep_traversal_done(const Mem_Dep_Traversal* traversal) {
+  return traversal->word_addr ==
+         ADDR_PLUS_OFFSET(traversal->last_word_addr, MEM_DEP_WORD_SIZE);
+}
+
+static inline void mem_dep_traversal_next(Mem_Dep_Traversal* traversal) {
+  traversal->word_addr = ADDR_PLUS_OFFSET(traversal->word_addr,
+                                          MEM_DEP_WORD_SIZE);
+  traversal->byte_mask = traversal->word_addr == traversal->last_word_addr ?
+                           traversal->last_byte_mask :
+                           MEM_DEP_ALL_BYTES;
+}
+
+#endif /* #ifndef __MEM_DEP_MAP_H__ */
@@ -0,0 +1,155 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/stack_distance.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : LRU stack distance of a stream of line addresses, in
+ *                O(log n) per access.  Every tracked line owns the slot of
+ *                its last access in a timestamp window; a Fenwick tree over
+ *                the window counts the slots that are still the last access
+ *                of some line, so the distance of a reuse is the number of
+ *                marked slots after the previous one.  Only the most recent
+ *                'depth' distinct lines are tracked: anything older is at
+ *                least 'depth' deep, which is all a fully-associative LRU
+ *                cache of 'depth' lines needs to know.
+ ***************************************************************************************/
+
+#ifndef __STACK_DISTANCE_H__
+#define __STACK_DISTANCE_H__
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include "globals/global_types.h"
+}
+
+class Stack_Distance_Tracker {
+ public:
+  /* returned by access() for lines that are not among the 'depth' most
+     recently used ones (or have never been seen) */
+  static constexpr uns BEYOND_DEPTH = (uns)-1;
+
+  explicit Stack_Distance_Tracker(uns depth) :
+      depth(depth ? depth : 1), window(2 * this->depth + 2),
+      tree(window + 1, 0), slot_line(window, 0), next_slot(0) {
+    last_slot.reserve(this->depth + 1);
+  }
+
+  uns get_depth() const { return depth; }
+  uns size() const { return (uns)last_slot.size(); }
+
+  /* Records an access to 'line' and returns the number of distinct lines
+     accessed since its previous access (0 for back-to-back reuses), or
+     BEYOND_DEPTH */
+  uns access(Addr line) {
+    uns  distance = BEYOND_DEPTH;
+    auto it       = last_slot.find(line);
+    if(it != last_slot.end()) {
+      uns slot = it->second;
+      distance = prefix(next_slot) - prefix(slot + 1);
+      update(slot, -1);
+      last_slot.erase(it);
+    }
+
+    if(next_slot == window)
+      compact();
+    slot_line[next_slot] = line;
+    update(next_slot, +1);
+    last_slot.emplace(line, next_slot);
+    next_slot++;
+
+    if(last_slot.size() > depth) {
+      uns oldest = first_marked();
+      update(oldest, -1);
+      last_slot.erase(slot_line[oldest]);
+    }
+    return distance;
+  }
+
+  void clear() {
+    std::fill(tree.begin(), tree.end(), 0);
+    last_slot.clear();
+    next_slot = 0;
+  }
+
+ private:
+  uns                           depth;
+  uns                           window;
+  std::vector<int>              tree;      /* 1-based Fenwick tree */
+  std::vector<Addr>             slot_line; /* line that owns each slot */
+  std::unordered_map<Addr, uns> last_slot; /* line -> slot of last access */
+  uns                           next_slot;
+
+  void update(uns slot, int delta) {
+    for(uns ii = slot + 1; ii <= window; ii += ii & -ii)
+      tree[ii] += delta;
+  }
+
+  /* number of marked slots in [0, end) */
+  int prefix(uns end) const {
+    int sum = 0;
+    for(uns ii = end; ii > 0; ii -= ii & -ii)
+      sum += tree[ii];
+    return sum;
+  }
+
+  /* lowest marked slot (the least recently used tracked line) */
+  uns first_marked() const {
+    uns pos  = 0;
+    uns step = 1;
+    while(step * 2 <= window)
+      step *= 2;
+    for(; step; step >>= 1) {
+      if(pos + step <= window && tree[pos + step] == 0)
+        pos += step;
+    }
+    return pos;
+  }
+
+  /* Slides the live slots to the front of the window, keeping their order.
+     At most 'depth' slots are live, so this runs at most once every
+     'depth' accesses and is O(1) amortized. */
+  void compact() {
+    uns live = 0;
+    for(uns slot = 0; slot < next_slot; slot++) {
+      auto it = last_slot.find(slot_line[slot]);
+      if(it == last_slot.end() || it->second != slot)
+        continue;
+      slot_line[live] = slot_line[slot];
+      it->second      = live;
+      live++;
+    }
+    std::fill(tree.begin(), tree.end(), 0);
+    for(uns ii = 1; ii <= window; ii++) {
+      tree[ii] += ii <= live;
+      uns parent = ii + (ii & -ii);
+      if(parent <= window)
+        tree[parent] += tree[ii];
+    }
+    next_slot = live;
+  }
+};
+
+#endif /* #ifndef __STACK_DISTANCE_H__ */
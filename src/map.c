@@ -43,7 +43,6 @@
 #include "memory/memory.param.h"
 
 #include "cmp_model.h"
-#include "libs/hash_lib.h"
 #include "statistics.h"
 
 #include "xed-interface.h"
@@ -58,38 +57,6 @@
 #define MEM_ADDR_SRC \
   0 /* address for memory instructions calculated off source 0 */
 
-#define MEM_MAP_ENTRY_SIZE_LOG 3
-#define MEM_MAP_ENTRY_SIZE (1 << MEM_MAP_ENTRY_SIZE_LOG)
-#define MEM_MAP_BYTE_IN_ENTRY(va) ((va) & (MEM_MAP_ENTRY_SIZE - 1))
-#define MEM_MAP_ENTRY_ADDR(va) ((va) & ~(Addr)(MEM_MAP_ENTRY_SIZE - 1))
-
-#define MEM_MAP_KEY(va) ((va) >> MEM_MAP_ENTRY_SIZE_LOG)
-#define MEM_MAP_BYTE_INDEX(byte, off_path) \
-  ((byte) + ((off_path) ? MEM_MAP_ENTRY_SIZE : 0))
-
-/**************************************************************************************/
-/* Types */
-
-typedef struct Mem_Map_Entry_struct {
-  Op* op[2 * MEM_MAP_ENTRY_SIZE]; /* last op to write (invalid when committed),
-                                   * first half onpath, second half offpath*/
-  uns flag_mask;                  /* offpath flags, one per byte */
-  uns store_mask;                 /* shows position of all distinct stores
-                                   * supplying a partial value to this map entry */
-} Mem_Map_Entry;
-
-/* Data structure for easy traversal of memory map hash given an
-   access with an address and size */
-typedef struct Mem_Map_Traversal_struct {
-  Addr entry_addr; /* Entry address, can be used by caller */
-  Addr first_entry_addr;
-  Addr last_entry_addr;
-  uns  byte; /* Byte within entry, can be used by caller */
-  uns  last_byte;
-  uns  first_entry_first_byte;
-  uns  last_entry_last_byte;
-} Mem_Map_Traversal;
-
 /**************************************************************************************/
 /* External variables */
 
@@ -99,7 +66,7 @@ extern Op invalid_op;
 /**************************************************************************************/
 /* Global Variables */
 
-Map_Data* map_data = NULL;
+SIM_THREAD_LOCAL Map_Data* map_data = NULL;
 
 const char* const dep_type_names[NUM_DEP_TYPES] = {
   "REG_DATA",
@@ -118,16 +85,6 @@ static inline void expand_wake_up_entries(void);
 static inline void update_store_hash(Op* op);
 static inline Op*  add_store_deps(Op* op);
 static inline void update_map_entry(Op* op, Map_Entry* map_entry);
-static inline void recover_mem_map_entry(void* hash_entry, void* arg);
-
-/* memory map hash traversal */
-static inline void mem_map_entry_traversal_init(Mem_Map_Traversal* traversal,
-                                                Addr va, uns size);
-static inline Flag mem_map_entry_traversal_done(Mem_Map_Traversal* traversal);
-static inline void mem_map_entry_traversal_next(Mem_Map_Traversal* traversal);
-static inline void mem_map_byte_traversal_init(Mem_Map_Traversal* traversal);
-static inline Flag mem_map_byte_traversal_done(Mem_Map_Traversal* traversal);
-static inline void mem_map_byte_traversal_next(Mem_Map_Traversal* traversal);
 
 /**************************************************************************************/
 /* set_map_data: */
@@ -165,15 +122,12 @@ void init_map(uns8 proc_id) {
   /* Allocate the wake_up_entry pool. */
   expand_wake_up_entries();
 
-  /* Initialize the memory dependence hash table. The number of
-     buckets matters since we scan all entries (and all buckets) on
-     branch misprediction recovery, so we want to keep the number of
-     buckets large enough to avoid collisions but small enough to
-     keep the scan fast. Since the number of entries is roughly at
-     most the number of in-flight stores, we set the number of
-     buckets to the size of instruction window. */
-  init_hash_table(&map_data->oracle_mem_hash, "oracle mem dependence map",
-                  NODE_TABLE_SIZE, sizeof(Mem_Map_Entry));
+  /* Initialize the memory dependence map. The number of words is
+     roughly at most the number of in-flight stores, so start with
+     room for an instruction window of them; the table grows if
+     wide stores need more. Recovery does not scan the table. */
+  init_mem_dep_map(&map_data->oracle_mem_map, "oracle mem dependence map",
+                   NODE_TABLE_SIZE);
 
   /* Init the register renaming table */
   map_data->rename_table = NULL;
@@ -190,18 +144,10 @@ void recover_map() {
   for(ii = 0; ii < NUM_REG_IDS; ii++)
     map_data->map_flags[ii] = FALSE;
   map_data->last_store_flag = FALSE;
-  hash_table_scan(&map_data->oracle_mem_hash, recover_mem_map_entry, NULL);
+  mem_dep_map_recover(&map_data->oracle_mem_map);
   rebuild_offpath_map();
 }
 
-/**************************************************************************************/
-/* recover_mem_map_entry: */
-
-void recover_mem_map_entry(void* hash_entry, void* arg) {
-  Mem_Map_Entry* entry = (Mem_Map_Entry*)hash_entry;
-  entry->flag_mask     = 0;
-}
-
 /**************************************************************************************/
 /* rebuild_offpath_map: rebuild the offpath half of map structures
    using the sequential op list from a Thread. Make sure you recover
@@ -238,6 +184,7 @@ static inline void expand_wake_up_entries() {
 
   DEBUGU(map_data->proc_id, "Expanding wake up pool to size %d\n",
          (map_data->wake_up_entries + WAKE_UP_ENTRIES_INC));
+  STAT_EVENT(map_data->proc_id, WAKE_UP_POOL_EXPAND);
   for(ii = 0; ii < WAKE_UP_ENTRIES_INC - 1; ii++)
     new_pool[ii].next = &new_pool[ii + 1];
   new_pool[ii].next        = map_data->free_list_head;
@@ -375,90 +322,20 @@ void map_mem_dep(Op* op) {
     add_store_deps(op);
 }
 
-/**************************************************************************************/
-/* map_mem_*_traversal_*: these functions traverse the memory map
-   entries and bytes within those entries given an access with an
-   address and size. */
-
-static inline void mem_map_entry_traversal_init(Mem_Map_Traversal* traversal,
-                                                Addr va, uns size) {
-  Addr last_va = ADDR_PLUS_OFFSET(va, size - 1);  // last byte in access
-  traversal->first_entry_addr       = MEM_MAP_ENTRY_ADDR(va);
-  traversal->last_entry_addr        = MEM_MAP_ENTRY_ADDR(last_va);
-  traversal->entry_addr             = traversal->first_entry_addr;
-  traversal->first_entry_first_byte = MEM_MAP_BYTE_IN_ENTRY(va);
-  traversal->last_entry_last_byte   = MEM_MAP_BYTE_IN_ENTRY(last_va);
-
-  if(0 == size) {
-    // special case - if the size is 0, we shouldn't do a traversal at all, so
-    // force the traversal to be "done"
-    traversal->entry_addr = ADDR_PLUS_OFFSET(traversal->last_entry_addr,
-                                             MEM_MAP_ENTRY_SIZE);
-    ASSERT(get_proc_id_from_cmp_addr(va),
-           mem_map_entry_traversal_done(traversal));
-  }
-}
-
-static inline Flag mem_map_entry_traversal_done(Mem_Map_Traversal* traversal) {
-  return traversal->entry_addr ==
-         ADDR_PLUS_OFFSET(traversal->last_entry_addr, MEM_MAP_ENTRY_SIZE);
-}
-
-static inline void mem_map_entry_traversal_next(Mem_Map_Traversal* traversal) {
-  traversal->entry_addr = ADDR_PLUS_OFFSET(traversal->entry_addr,
-                                           MEM_MAP_ENTRY_SIZE);
-}
-
-static inline void mem_map_byte_traversal_init(Mem_Map_Traversal* traversal) {
-  traversal->byte = traversal->entry_addr == traversal->first_entry_addr ?
-                      traversal->first_entry_first_byte :
-                      0;
-  traversal->last_byte = traversal->entry_addr == traversal->last_entry_addr ?
-                           traversal->last_entry_last_byte :
-                           MEM_MAP_ENTRY_SIZE - 1;
-  ASSERT(0, traversal->byte <= traversal->last_byte);
-}
-
-static inline Flag mem_map_byte_traversal_done(Mem_Map_Traversal* traversal) {
-  return traversal->byte > traversal->last_byte;
-}
-
-static inline void mem_map_byte_traversal_next(Mem_Map_Traversal* traversal) {
-  traversal->byte++;
-}
-
 /**************************************************************************************/
 /* delete_store_hash_entry */
 
 void delete_store_hash_entry(Op* op) {
-  Addr              va = op->oracle_info.va;
-  Mem_Map_Traversal traversal;
+  Mem_Dep_Traversal traversal;
 
   ASSERT(map_data->proc_id, map_data->proc_id == op->proc_id);
 
-  /* Iterate through each entry that was written to by the op */
-  for(mem_map_entry_traversal_init(&traversal, va, op->oracle_info.mem_size);
-      !mem_map_entry_traversal_done(&traversal);
-      mem_map_entry_traversal_next(&traversal)) {
-    Mem_Map_Entry* mem_map_p = (Mem_Map_Entry*)hash_table_access(
-      &map_data->oracle_mem_hash, MEM_MAP_KEY(traversal.entry_addr));
-
-    if(!mem_map_p)
-      continue;
-
-    /* Iterate through each byte written to by the op (within this entry) */
-    for(mem_map_byte_traversal_init(&traversal);
-        !mem_map_byte_traversal_done(&traversal);
-        mem_map_byte_traversal_next(&traversal)) {
-      uns ind = MEM_MAP_BYTE_INDEX(traversal.byte, op->off_path);
-      if(TESTBIT(mem_map_p->store_mask, ind) && mem_map_p->op[ind] == op) {
-        CLRBIT(mem_map_p->store_mask, ind);
-      }
-    }
-    if(!mem_map_p->store_mask) {
-      hash_table_access_delete(&map_data->oracle_mem_hash,
-                               MEM_MAP_KEY(traversal.entry_addr));
-    }
+  /* Release the bytes of each word that was written to by the op */
+  for(mem_dep_traversal_init(&traversal, OP_ORACLE(op).va,
+                             OP_ORACLE(op).mem_size);
+      !mem_dep_traversal_done(&traversal); mem_dep_traversal_next(&traversal)) {
+    mem_dep_map_release(&map_data->oracle_mem_map, traversal.word_addr,
+                        traversal.byte_mask, op->off_path, op);
   }
 }
 
@@ -466,37 +343,33 @@ void delete_store_hash_entry(Op* op) {
 /* add_store_deps: */
 
 static inline Op* add_store_deps(Op* op) {
-  Addr              va            = op->oracle_info.va;
+  Addr              va            = OP_ORACLE(op).va;
   Op*               last_src_op   = NULL;
-  uns               orig_num_srcs = op->oracle_info.num_srcs;
-  Mem_Map_Traversal traversal;
+  uns               orig_num_srcs = OP_ORACLE(op).num_srcs;
+  Mem_Dep_Traversal traversal;
 
   ASSERT(map_data->proc_id, map_data->proc_id == op->proc_id);
 
-  /* Iterate through each entry that is read by the op */
-  for(mem_map_entry_traversal_init(&traversal, va, op->oracle_info.mem_size);
-      !mem_map_entry_traversal_done(&traversal);
-      mem_map_entry_traversal_next(&traversal)) {
-    Mem_Map_Entry* mem_map_p = (Mem_Map_Entry*)hash_table_access(
-      &map_data->oracle_mem_hash, MEM_MAP_KEY(traversal.entry_addr));
-
-    if(!mem_map_p)
-      continue;
+  /* Iterate through each word that is read by the op */
+  for(mem_dep_traversal_init(&traversal, va, OP_ORACLE(op).mem_size);
+      !mem_dep_traversal_done(&traversal); mem_dep_traversal_next(&traversal)) {
+    Mem_Dep_Word* word;
+    uns slots = mem_dep_map_read(&map_data->oracle_mem_map, traversal.word_addr,
+                                 traversal.byte_mask, &word);
+
+    /* Visit the stores supplying the bytes read by the op in byte order,
+       skipping the rest of a store's bytes in one go */
+    while(slots) {
+      Op* src_op = word->op[__builtin_ctz(slots)];
+      do {
+        slots &= slots - 1;
+      } while(slots && word->op[__builtin_ctz(slots)] == src_op);
 
-    /* Iterate through each byte read by the op (within this entry) */
-    for(mem_map_byte_traversal_init(&traversal);
-        !mem_map_byte_traversal_done(&traversal);
-        mem_map_byte_traversal_next(&traversal)) {
-      uns ind = MEM_MAP_BYTE_INDEX(
-        traversal.byte, TESTBIT(mem_map_p->flag_mask, traversal.byte));
-      if(!TESTBIT(mem_map_p->store_mask, ind))
-        continue; /* ensure mem_map_p info is valid */
-      Op* src_op = mem_map_p->op[ind];
       ASSERTM(op->proc_id,
-              BYTE_OVERLAP(src_op->oracle_info.va, src_op->oracle_info.mem_size,
-                           va, op->oracle_info.mem_size),
-              "%d@0x%08x and %d@0x%08x\n", src_op->oracle_info.mem_size,
-              (uns32)src_op->oracle_info.va, op->oracle_info.mem_size,
+              BYTE_OVERLAP(OP_ORACLE(src_op).va, OP_ORACLE(src_op).mem_size,
+                           va, OP_ORACLE(op).mem_size),
+              "%d@0x%08x and %d@0x%08x\n", OP_ORACLE(src_op).mem_size,
+              (uns32)OP_ORACLE(src_op).va, OP_ORACLE(op).mem_size,
               (uns32)va);
       if(MEM_OOO_STORES && !src_op->marked) {
         add_src_from_op(op, src_op, MEM_DATA_DEP);
@@ -519,9 +392,9 @@ static inline Op* add_store_deps(Op* op) {
   ASSERT(op->proc_id, last_src_op->op_num < op->op_num || op->off_path);
   if(MEM_OOO_STORES) {
     /* unmark all ops we marked earlier */
-    for(uns ii = orig_num_srcs; ii < op->oracle_info.num_srcs; ii++) {
-      ASSERT(op->proc_id, op->oracle_info.src_info[ii].op->marked);
-      op->oracle_info.src_info[ii].op->marked = FALSE;
+    for(uns ii = orig_num_srcs; ii < OP_ORACLE(op).num_srcs; ii++) {
+      ASSERT(op->proc_id, OP_ORACLE(op).src_info[ii].op->marked);
+      OP_ORACLE(op).src_info[ii].op->marked = FALSE;
     }
   } else {
     add_src_from_op(op, last_src_op, MEM_DATA_DEP);
@@ -535,35 +408,16 @@ static inline Op* add_store_deps(Op* op) {
 /* update_store_hash: */
 
 static inline void update_store_hash(Op* op) {
-  Mem_Map_Entry*    mem_map_p;
-  Addr              va = op->oracle_info.va;
-  Mem_Map_Traversal traversal;
+  Mem_Dep_Traversal traversal;
 
   ASSERT(map_data->proc_id, map_data->proc_id == op->proc_id);
 
-  /* Iterate through each entry that was written to by the op */
-  for(mem_map_entry_traversal_init(&traversal, va, op->oracle_info.mem_size);
-      !mem_map_entry_traversal_done(&traversal);
-      mem_map_entry_traversal_next(&traversal)) {
-    Flag new_entry = FALSE;
-    mem_map_p      = (Mem_Map_Entry*)hash_table_access_create(
-      &map_data->oracle_mem_hash, MEM_MAP_KEY(traversal.entry_addr),
-      &new_entry);
-
-    if(new_entry) {
-      mem_map_p->flag_mask  = 0;
-      mem_map_p->store_mask = 0;
-    }
-
-    /* Iterate through each byte written to by the op (within this entry) */
-    for(mem_map_byte_traversal_init(&traversal);
-        !mem_map_byte_traversal_done(&traversal);
-        mem_map_byte_traversal_next(&traversal)) {
-      DEFBIT(mem_map_p->flag_mask, traversal.byte, op->off_path);
-      uns ind = MEM_MAP_BYTE_INDEX(traversal.byte, op->off_path);
-      SETBIT(mem_map_p->store_mask, ind);
-      mem_map_p->op[ind] = op;
-    }
+  /* Make the op the youngest store of each byte it writes */
+  for(mem_dep_traversal_init(&traversal, OP_ORACLE(op).va,
+                             OP_ORACLE(op).mem_size);
+      !mem_dep_traversal_done(&traversal); mem_dep_traversal_next(&traversal)) {
+    mem_dep_map_write(&map_data->oracle_mem_map, traversal.word_addr,
+                      traversal.byte_mask, op->off_path, op);
   }
 }
 
@@ -688,12 +542,12 @@ void add_to_wake_up_lists(Op* op, Op_Info* op_info,
 
       if(TRACK_L1_MISS_DEPS) {
         // An op can occupy multiple entries in the wakeup list of another op
-        if(src_op->engine_info.l1_miss &&
-           !src_op->engine_info.l1_miss_satisfied)
-          op->engine_info.dep_on_l1_miss = TRUE;
+        if(OP_ENGINE(src_op).l1_miss &&
+           !OP_ENGINE(src_op).l1_miss_satisfied)
+          OP_ENGINE(op).dep_on_l1_miss = TRUE;
 
-        if(src_op->engine_info.dep_on_l1_miss)
-          op->engine_info.dep_on_l1_miss = TRUE;
+        if(OP_ENGINE(src_op).dep_on_l1_miss)
+          OP_ENGINE(op).dep_on_l1_miss = TRUE;
       }
 
       if(src_op->wake_up_signaled[src_info->type]) {
@@ -742,8 +596,8 @@ void free_wake_up_list(Op* op) {
 /* add_src_from_op: . */
 
 void add_src_from_op(Op* op, Op* src_op, Dep_Type type) {
-  uns       src_num = op->oracle_info.num_srcs++;
-  Src_Info* info    = &op->oracle_info.src_info[src_num];
+  uns       src_num = OP_ORACLE(op).num_srcs++;
+  Src_Info* info    = &OP_ORACLE(op).src_info[src_num];
 
   ASSERT(map_data->proc_id, op);
   ASSERT(map_data->proc_id, src_op);
@@ -775,8 +629,8 @@ void add_src_from_op(Op* op, Op* src_op, Dep_Type type) {
 /* add_src_from_map_entry: set the src_info array */
 
 void add_src_from_map_entry(Op* op, Map_Entry* map_entry, Dep_Type type) {
-  uns       src_num = op->oracle_info.num_srcs++;
-  Src_Info* info    = &op->oracle_info.src_info[src_num];
+  uns       src_num = OP_ORACLE(op).num_srcs++;
+  Src_Info* info    = &OP_ORACLE(op).src_info[src_num];
 
   ASSERT(map_data->proc_id, op);
   ASSERT(map_data->proc_id, map_data->proc_id == op->proc_id);
@@ -810,7 +664,7 @@ void add_src_from_map_entry(Op* op, Map_Entry* map_entry, Dep_Type type) {
 
 void clear_not_rdy_bit(Op* op, uns bit) {
   ASSERT(map_data->proc_id, op);
-  ASSERT(map_data->proc_id, bit < op->oracle_info.num_srcs);
+  ASSERT(map_data->proc_id, bit < OP_ORACLE(op).num_srcs);
   DEBUG(map_data->proc_id, "Clearing not rdy bit  op_num:%s  bit:%d\n",
         unsstr64(op->op_num), bit);
   op->srcs_not_rdy_vector &= ~(0x1 << bit);
@@ -822,7 +676,7 @@ void clear_not_rdy_bit(Op* op, uns bit) {
 
 void set_not_rdy_bit(Op* op, uns bit) {
   ASSERT(map_data->proc_id, op);
-  ASSERT(map_data->proc_id, bit < op->oracle_info.num_srcs);
+  ASSERT(map_data->proc_id, bit < OP_ORACLE(op).num_srcs);
   /*  this message gets annoying
       DEBUG("Setting not rdy bit  op_num:%s  bit:%d\n", unsstr64(op->op_num),
      bit);
@@ -836,7 +690,7 @@ void set_not_rdy_bit(Op* op, uns bit) {
 
 Flag test_not_rdy_bit(Op* op, uns bit) {
   ASSERT(map_data->proc_id, op);
-  ASSERT(map_data->proc_id, bit < op->oracle_info.num_srcs);
+  ASSERT(map_data->proc_id, bit < OP_ORACLE(op).num_srcs);
   return (op->srcs_not_rdy_vector & (0x1 << bit)) > 0;
 }
 
@@ -1026,8 +880,8 @@ void merged_reg_file_read_entry(Op *op, Reg_File_Entry *entry) {
   ASSERT(map->proc_id, op->op_num != entry->op_num);
 
   // increase src num
-  uns       src_num = op->oracle_info.num_srcs++;
-  Src_Info* info    = &op->oracle_info.src_info[src_num];
+  uns       src_num = OP_ORACLE(op).num_srcs++;
+  Src_Info* info    = &OP_ORACLE(op).src_info[src_num];
 
   // get info from the entry
   info->type       = REG_DATA_DEP;
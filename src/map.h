@@ -29,9 +29,11 @@
 #ifndef __MAP_H__
 #define __MAP_H__
 
+#include "globals/global_defs.h"
 #include "isa/isa_macros.h"
 #include "libs/hash_lib.h"
 #include "libs/list_lib.h"
+#include "libs/mem_dep_map.h"
 #include "op.h"
 
 /**************************************************************************************/
@@ -109,7 +111,7 @@ typedef struct Map_Data_struct {
   Map_Entry last_store[2];
   Flag      last_store_flag;
 
-  Hash_Table oracle_mem_hash;
+  Mem_Dep_Map oracle_mem_map;
 
   Wake_Up_Entry* free_list_head;
   uns            wake_up_entries;
@@ -123,7 +125,7 @@ typedef struct Map_Data_struct {
 /**************************************************************************************/
 /* External Variables */
 
-extern Map_Data* map_data;
+extern SIM_THREAD_LOCAL Map_Data* map_data;
 
 
 /**************************************************************************************/
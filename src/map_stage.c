@@ -59,11 +59,8 @@
 /**************************************************************************************/
 /* Global Variables */
 
-Map_Stage* map = NULL;
-// The next op number is used when deciding whether to consume ops from the
-// uop cache: i.e. check if any preceding instructions are still in the decoder.
-Counter map_stage_next_op_num = 1;
-int map_off_path = 0;
+SIM_THREAD_LOCAL Map_Stage* map = NULL;
+SIM_THREAD_LOCAL int map_off_path = 0;
 
 /**************************************************************************************/
 /* Local prototypes */
@@ -91,7 +88,8 @@ void init_map_stage(uns8 proc_id, const char* name) {
   DEBUG(proc_id, "Initializing %s stage\n", name);
 
   memset(map, 0, sizeof(Map_Stage));
-  map->proc_id = proc_id;
+  map->proc_id     = proc_id;
+  map->next_op_num = 1;
 
   map->sds = (Stage_Data*)malloc(sizeof(Stage_Data) * STAGE_MAX_DEPTH);
   for(ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
@@ -151,9 +149,9 @@ void recover_map_stage() {
     }
   }
 
-  if (map_stage_next_op_num > bp_recovery_info->recovery_op_num) {
-    map_stage_next_op_num = bp_recovery_info->recovery_op_num + 1;
-    DEBUG(map->proc_id, "Recovering map_stage_next_op_num to %llu\n", map_stage_next_op_num);
+  if (map->next_op_num > bp_recovery_info->recovery_op_num) {
+    map->next_op_num = bp_recovery_info->recovery_op_num + 1;
+    DEBUG(map->proc_id, "Recovering next_op_num to %llu\n", map->next_op_num);
   }
 }
 
@@ -172,6 +170,18 @@ void debug_map_stage() {
 }
 
 
+/**************************************************************************************/
+/* map_stage_signature: folds the occupancy of every map latch into one value.
+ * Used to detect cycles in which no op moves through the stage. */
+
+Counter map_stage_signature() {
+  Counter sig = 0;
+  for(uns ii = 0; ii < STAGE_MAX_DEPTH; ii++)
+    sig = sig * 31 + map->sds[ii].op_count;
+  return sig;
+}
+
+
 /**************************************************************************************/
 /* map_cycle: */
 
@@ -211,10 +221,10 @@ void update_map_stage(Stage_Data* dec_src_sd, Stage_Data* uopq_src_sd) {
     // The map stage may consume multiple ops in one cycle from both
     // the map stage and the uop cache source if allowed.
     ASSERT(map->proc_id, uopq_src_sd != NULL);
-    if (dec_src_sd->op_count && dec_src_sd->ops[0]->op_num == map_stage_next_op_num) {
+    if (dec_src_sd->op_count && dec_src_sd->ops[0]->op_num == map->next_op_num) {
       consume_from_sd = dec_src_sd;
       other_sd = uopq_src_sd;  //can only consume ALL ops from this stage if the other sd has them ready. Otherwise only the first few
-    } else if (uopq_src_sd->op_count && uopq_src_sd->ops[0]->op_num == map_stage_next_op_num) {
+    } else if (uopq_src_sd->op_count && uopq_src_sd->ops[0]->op_num == map->next_op_num) {
       consume_from_sd = uopq_src_sd;
       other_sd = dec_src_sd;
     }
@@ -224,7 +234,7 @@ void update_map_stage(Stage_Data* dec_src_sd, Stage_Data* uopq_src_sd) {
     // is from the decode stage.
     ASSERT(map->proc_id, uopq_src_sd == NULL);
     if (dec_src_sd->op_count) {
-      ASSERT(map->proc_id, dec_src_sd->ops[0]->op_num == map_stage_next_op_num);
+      ASSERT(map->proc_id, dec_src_sd->ops[0]->op_num == map->next_op_num);
       consume_from_sd = dec_src_sd;
     }
   }
@@ -290,7 +300,7 @@ void update_map_stage(Stage_Data* dec_src_sd, Stage_Data* uopq_src_sd) {
 
 static inline void stage_process_op(Op* op) {
   /* the map stage is currently responsible only for setting wake up lists */
-  add_to_wake_up_lists(op, &op->oracle_info, model->wake_hook);
+  add_to_wake_up_lists(op, &OP_ORACLE(op), model->wake_hook);
 }
 
 
@@ -304,14 +314,14 @@ static inline Flag map_fetch_fill_op(Stage_Data* src_sd, int* fetch_idx) {
 
   Op* op = src_sd->ops[*fetch_idx];
 
-  if (op && op->op_num == map_stage_next_op_num) {
+  if (op && op->op_num == map->next_op_num) {
     DEBUG(map->proc_id, "Fetching opnum=%llu from %s at idx=%i\n", op->op_num, src_sd->name, *fetch_idx);
     if (!op->decode_cycle) decode_stage_process_op(op);
     op->map_cycle = cycle_count;
     dest_sd->ops[dest_sd->op_count++] = op;
     src_sd->ops[*fetch_idx] = NULL;
     src_sd->op_count--;
-    map_stage_next_op_num++;
+    map->next_op_num++;
     *fetch_idx = *fetch_idx + 1;
     return TRUE;
   }
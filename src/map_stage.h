@@ -29,6 +29,7 @@
 #ifndef __MAP_STAGE_H__
 #define __MAP_STAGE_H__
 
+#include "globals/global_defs.h"
 #include "stage_data.h"
 
 
@@ -41,13 +42,16 @@ typedef struct Map_Stage_struct {
                         * allocated number of pipe stages) */
   Stage_Data* last_sd; /* pointer to last decode pipeline stage
                         * (for passing ops to map) */
+  Counter     next_op_num; /* op_num of the next op to map; used to decide
+                            * whether to consume ops from the uop cache, i.e.
+                            * whether older ops are still in the decoder */
 } Map_Stage;
 
 
 /**************************************************************************************/
 /* External Variables */
 
-extern Map_Stage* map;
+extern SIM_THREAD_LOCAL Map_Stage* map;
 
 
 /**************************************************************************************/
@@ -60,6 +64,7 @@ void reset_map_stage(void);
 void recover_map_stage(void);
 void debug_map_stage(void);
 void update_map_stage(Stage_Data* dec_src_sd, Stage_Data* uop_queue_src_sd);
+Counter map_stage_signature(void);
 
 
 /**************************************************************************************/
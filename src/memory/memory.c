@@ -40,12 +40,14 @@
 #include "addr_trans.h"
 #include "bp/bp.h"
 #include "cache_part.h"
+#include "stack_sweep.h"
 #include "mem_req.h"
 #include "memory.h"
 #include "op.h"
 #include "prefetcher//pref_stream.h"
 
 #include "cmp_model.h"
+#include "cmp_threads.h"
 #include "core.param.h"
 #include "debug/debug.param.h"
 #include "dvfs/perf_pred.h"
@@ -92,9 +94,10 @@ static Counter* core_fill_seq_num;
 static uns      mem_req_demand_entries = 0;
 static uns      mem_req_pref_entries   = 0;
 static uns      mem_req_wb_entries     = 0;
+static uns      mem_queue_index_line_size;
 
 Memory*              mem = NULL;
-extern Icache_Stage* ic;
+extern SIM_THREAD_LOCAL Icache_Stage* ic;
 extern Counter  last_recover_cycle;
 
 Counter Mem_Req_Priority[MRT_NUM_ELEMS];
@@ -108,6 +111,19 @@ static void init_uncores(void);
 static void update_memory_queues(void);
 static void update_on_chip_memory_stats(void);
 
+static Flag new_mem_req_unlocked(Mem_Req_Type type, uns8 proc_id, Addr addr,
+                                 uns size, uns delay, Op* op,
+                                 Flag done_func(Mem_Req*), Counter unique_num,
+                                 Pref_Req_Info* pref_info);
+static Flag new_mem_dc_wb_req_unlocked(Mem_Req_Type type, uns8 proc_id,
+                                       Addr addr, uns size, uns delay, Op* op,
+                                       Flag done_func(Mem_Req*),
+                                       Counter unique_num, Flag used_onpath);
+static Flag mem_can_allocate_req_buffer_unlocked(uns proc_id,
+                                                 Mem_Req_Type type,
+                                                 Flag for_l1_writeback);
+static Flag l1_fill_line_unlocked(Mem_Req* req);
+
 static void mark_ops_as_l1_miss(Mem_Req* req);
 static void mark_l1_miss_deps(Op* op);
 static void unmark_l1_miss_deps(Op* op);
@@ -191,6 +207,13 @@ static inline void init_mem_queue(Mem_Queue* queue, char* name, uns size,
 
 static void print_mem_queue_generic(Mem_Queue* queue);
 
+static inline Addr mem_queue_index_key(Addr addr);
+static inline void mem_queue_index_add(Mem_Queue* queue, Addr line_addr);
+static inline void mem_queue_index_remove(Mem_Queue* queue, Addr line_addr);
+static inline void mem_queue_remove_tail(Mem_Queue* queue, int count);
+static inline void mem_queue_clear(Mem_Queue* queue);
+static void        mem_queue_sort(Mem_Queue* queue);
+
 static inline void queue_sanity_check(int location);
 
 void mem_insert_req_round_robin(void);
@@ -235,6 +258,64 @@ static inline void init_mem_queue(Mem_Queue* queue, char* name, uns size,
   queue->reserved_entry_count = 0;
   queue->type                 = type;
   strcpy(queue->name, name);
+  init_hash_table(&queue->addr_index, name, size, sizeof(uns));
+}
+
+
+/**************************************************************************************/
+/* mem_queue_index_key: Queues are indexed by the address of the largest line
+   any request can cover, so that every request matching an address under
+   CACHE_SIZE_ADDR() shares that address's key. */
+
+static inline Addr mem_queue_index_key(Addr addr) {
+  return addr & ~(Addr)(mem_queue_index_line_size - 1);
+}
+
+
+/**************************************************************************************/
+/* mem_queue_index_add: */
+
+static inline void mem_queue_index_add(Mem_Queue* queue, Addr line_addr) {
+  Flag new_entry;
+  uns* count = (uns*)hash_table_access_create(&queue->addr_index, line_addr,
+                                              &new_entry);
+  if(new_entry)
+    *count = 0;
+  (*count)++;
+}
+
+
+/**************************************************************************************/
+/* mem_queue_index_remove: */
+
+static inline void mem_queue_index_remove(Mem_Queue* queue, Addr line_addr) {
+  uns* count = (uns*)hash_table_access(&queue->addr_index, line_addr);
+  ASSERTM(0, count && *count > 0, "%s index lost line %s\n", queue->name,
+          hexstr64s(line_addr));
+  if(--(*count) == 0)
+    hash_table_access_delete(&queue->addr_index, line_addr);
+}
+
+
+/**************************************************************************************/
+/* mem_queue_remove_tail: drop the last count entries of the queue (the ones
+   sorted to the tail for removal) */
+
+static inline void mem_queue_remove_tail(Mem_Queue* queue, int count) {
+  int ii;
+  ASSERT(0, count <= queue->entry_count);
+  for(ii = queue->entry_count - count; ii < queue->entry_count; ii++)
+    mem_queue_index_remove(queue, queue->base[ii].line_addr);
+  queue->entry_count -= count;
+}
+
+
+/**************************************************************************************/
+/* mem_queue_clear: */
+
+static inline void mem_queue_clear(Mem_Queue* queue) {
+  queue->entry_count = 0;
+  hash_table_clear(&queue->addr_index);
 }
 
 /**************************************************************************************/
@@ -345,6 +426,9 @@ void init_memory() {
     init_list(&mem->req_buffer[ii].op_uniques, name, sizeof(Counter), TRUE);
   }
 
+  mem_queue_index_line_size = MAX2(MAX2(L1_LINE_SIZE, MLC_LINE_SIZE),
+                                   MAX2(ICACHE_LINE_SIZE, DCACHE_LINE_SIZE));
+
   /* Initialize l1 and bus access queues which hold id's of request buffers */
   init_mem_queue(
     &mem->mlc_queue, "MLC_QUEUE",
@@ -376,9 +460,9 @@ void init_memory() {
 
   init_uncores();
 
-  init_cache(&mem->pref_l1_cache, "L1_PREF_CACHE", L1_PREF_CACHE_SIZE,
-             L1_PREF_CACHE_ASSOC, L1_LINE_SIZE, sizeof(L1_Data),
-             L1_CACHE_REPL_POLICY);
+  mem->pref_l1_cache = line_cache_create(
+    "L1_PREF_CACHE", L1_PREF_CACHE_SIZE, L1_PREF_CACHE_ASSOC, L1_LINE_SIZE,
+    sizeof(L1_Data), L1_CACHE_REPL_POLICY);
 
   if(STREAM_PREFETCH_ON)
     init_stream_HWP();
@@ -412,6 +496,11 @@ void init_uncores(void) {
   Ported_Cache* mlc = (Ported_Cache*)malloc(sizeof(Ported_Cache));
   init_cache(&mlc->cache, "MLC_CACHE", MLC_SIZE, MLC_ASSOC, MLC_LINE_SIZE,
              sizeof(MLC_Data), MLC_CACHE_REPL_POLICY);
+  mlc->miss_classifier = CLASSIFY_MLC_MISSES ?
+                           miss_classifier_create(mlc->cache.num_lines,
+                                                  MLC_LINE_SIZE,
+                                                  MISS_CLASSIFIER_FILTER_BITS) :
+                           NULL;
   mlc->num_banks = MLC_BANKS;
   mlc->ports     = (Ports*)malloc(sizeof(Ports) * mlc->num_banks);
   for(uns ii = 0; ii < mlc->num_banks; ii++) {
@@ -438,6 +527,11 @@ void init_uncores(void) {
       sprintf(buf, "L1[%d]", proc_id);
       init_cache(&l1->cache, buf, L1_SIZE / NUM_CORES, L1_ASSOC, L1_LINE_SIZE,
                  sizeof(L1_Data), L1_CACHE_REPL_POLICY);
+      l1->miss_classifier = CLASSIFY_L1_MISSES ?
+                              miss_classifier_create(
+                                l1->cache.num_lines, L1_LINE_SIZE,
+                                MISS_CLASSIFIER_FILTER_BITS) :
+                              NULL;
 
       l1->num_banks = L1_BANKS / NUM_CORES;
       l1->ports     = (Ports*)malloc(sizeof(Ports) * l1->num_banks);
@@ -452,6 +546,11 @@ void init_uncores(void) {
     Ported_Cache* l1 = (Ported_Cache*)malloc(sizeof(Ported_Cache));
     init_cache(&l1->cache, "L1_CACHE", L1_SIZE, L1_ASSOC, L1_LINE_SIZE,
                sizeof(L1_Data), L1_CACHE_REPL_POLICY);
+    l1->miss_classifier = CLASSIFY_L1_MISSES ?
+                            miss_classifier_create(l1->cache.num_lines,
+                                                   L1_LINE_SIZE,
+                                                   MISS_CLASSIFIER_FILTER_BITS) :
+                            NULL;
     l1->num_banks = L1_BANKS;
     l1->ports     = (Ports*)malloc(sizeof(Ports) * l1->num_banks);
     for(uns ii = 0; ii < l1->num_banks; ii++) {
@@ -521,11 +620,11 @@ void reset_memory() {
 
   clear_list(&mem->req_buffer_free_list);
 
-  mem->l1_queue.entry_count       = 0;
-  mem->mlc_queue.entry_count      = 0;
-  mem->bus_out_queue.entry_count  = 0;
-  mem->l1fill_queue.entry_count   = 0;
-  mem->mlc_fill_queue.entry_count = 0;
+  mem_queue_clear(&mem->l1_queue);
+  mem_queue_clear(&mem->mlc_queue);
+  mem_queue_clear(&mem->bus_out_queue);
+  mem_queue_clear(&mem->l1fill_queue);
+  mem_queue_clear(&mem->mlc_fill_queue);
 
   for(ii = 0; ii < mem->total_mem_req_buffers; ii++) {
     int* free_list_entry      = sl_list_add_tail(&mem->req_buffer_free_list);
@@ -793,6 +892,7 @@ static inline void set_off_path_confirmed_status(Mem_Req* req) {
 
 void recover_memory() {
   if(SET_OFF_PATH_CONFIRMED) {
+    cmp_threads_lock();
     for(uns ii = 0; ii < mem->total_mem_req_buffers;
         ii++) {  // FIXME: inefficient
       Mem_Req* req = &(mem->req_buffer[ii]);
@@ -800,6 +900,7 @@ void recover_memory() {
         set_off_path_confirmed_status(req);
       }
     }
+    cmp_threads_unlock();
   }
 
   /* If we are supposed to do really nothing for requests that are known to be
@@ -864,20 +965,17 @@ void update_memory_queues() {
   }
 
   if(!ALL_FIFO_QUEUES && (cycle_l1q_insert_count > 0)) {
-    qsort(mem->l1_queue.base, mem->l1_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_queue_sort(&mem->l1_queue);
     cycle_l1q_insert_count = 0;
   }
 
   if(!ALL_FIFO_QUEUES && (cycle_mlcq_insert_count > 0)) {
-    qsort(mem->mlc_queue.base, mem->mlc_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_queue_sort(&mem->mlc_queue);
     cycle_mlcq_insert_count = 0;
   }
 
   if(!ALL_FIFO_QUEUES && (cycle_busoutq_insert_count > 0)) {
-    qsort(mem->bus_out_queue.base, mem->bus_out_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_queue_sort(&mem->bus_out_queue);
     cycle_busoutq_insert_count = 0;
   }
 }
@@ -949,6 +1047,53 @@ void update_memory() {
   }
 }
 
+/**************************************************************************************/
+/* mem_is_quiescent: returns TRUE if no request is queued anywhere on chip and
+ * no DRAM response is waiting to be returned, i.e. an L1 cycle would not
+ * change the state of the memory system. Requests that are still in DRAM do
+ * not count: they show up in the queues once ramulator completes them. */
+
+Flag mem_is_quiescent() {
+  if(mem->mlc_queue.entry_count || mem->mlc_fill_queue.entry_count ||
+     mem->l1_queue.entry_count || mem->bus_out_queue.entry_count ||
+     mem->l1fill_queue.entry_count)
+    return FALSE;
+
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(mem->core_fill_queues[proc_id].entry_count ||
+       (ROUND_ROBIN_TO_L1 && mem->l1_in_buffer_core[proc_id].count))
+      return FALSE;
+  }
+
+  return ramulator_get_num_pending_resps() == 0;
+}
+
+/**************************************************************************************/
+/* mem_next_event_time: returns the earliest time at which the memory system
+ * may change state on its own.  The on-chip queues are processed every L1
+ * cycle while they hold a request, so that is the next L1 cycle unless the
+ * memory system is quiescent.  Otherwise only DRAM can act, in the first
+ * memory cycle that ramulator does not report as idle. */
+
+Counter mem_next_event_time() {
+  if(!mem_is_quiescent())
+    return freq_cycle_start_time(FREQ_DOMAIN_L1,
+                                 freq_cycle_count(FREQ_DOMAIN_L1) + 1);
+
+  return freq_cycle_start_time(FREQ_DOMAIN_MEMORY,
+                               freq_cycle_count(FREQ_DOMAIN_MEMORY) + 1 +
+                                 ramulator_idle_cycles());
+}
+
+/**************************************************************************************/
+/* mem_skip_cycles: accounts for memory cycles that were not simulated because
+ * they lay before mem_next_event_time(). */
+
+void mem_skip_cycles(Counter cycles) {
+  ASSERT(0, mem_is_quiescent());
+  ramulator_skip_cycles(cycles);
+}
+
 /**************************************************************************************/
 /* mem_compare_priority: */
 
@@ -966,6 +1111,36 @@ int mem_compare_priority(const void* a, const void* b) {
     return 0;
 }
 
+/**************************************************************************************/
+/* mem_queue_sort: Stable sort of a queue by mem_compare_priority. Queues are
+   kept sorted, so between sorts only the entries appended since the last sort
+   or whose priority was changed in place (promotions, removal marks) are out
+   of order. An insertion sort moves just those, and ties keep their queue
+   order, which makes the result independent of the libc qsort. */
+
+static void mem_queue_sort(Mem_Queue* queue) {
+  Mem_Queue_Entry* base = queue->base;
+  int              ii;
+
+  for(ii = 1; ii < queue->entry_count; ii++) {
+    if(mem_compare_priority(&base[ii - 1], &base[ii]) <= 0)
+      continue;
+
+    /* find the first entry in base[0..ii) that sorts after base[ii] */
+    Mem_Queue_Entry entry = base[ii];
+    int             lo = 0, hi = ii - 1;
+    while(lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if(mem_compare_priority(&base[mid], &entry) <= 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    memmove(&base[lo + 1], &base[lo], sizeof(Mem_Queue_Entry) * (ii - lo));
+    base[lo] = entry;
+  }
+}
+
 /**************************************************************************************/
 /* mem_start_mlc_access: */
 
@@ -1111,6 +1286,10 @@ Flag mem_process_l1_hit_access(Mem_Req* req, Mem_Queue_Entry* l1_queue_entry,
      (req->type == MRT_IFETCH)) {
     STAT_EVENT(req->proc_id, L1_HIT);
     STAT_EVENT(req->proc_id, CORE_L1_HIT);
+    if(L1(req->proc_id)->miss_classifier)
+      miss_classifier_access(L1(req->proc_id)->miss_classifier, req->addr,
+                             TRUE);
+    stack_sweep_access(STACK_SWEEP_LEVEL_L1, req->proc_id, req->addr);
     STAT_EVENT(req->proc_id, L1_HIT_ONPATH + req->off_path);
     if(0 && DEBUG_EXC_INSERTS) {
       printf("addr:%s hit in L1 type:%s\n", hexstr64s(req->addr),
@@ -1232,6 +1411,9 @@ Flag mem_process_mlc_hit_access(Mem_Req* req, Mem_Queue_Entry* mlc_queue_entry,
        (req->type == MRT_IFETCH)) {
       STAT_EVENT(req->proc_id, MLC_HIT);
       STAT_EVENT(req->proc_id, CORE_MLC_HIT);
+      if(MLC(req->proc_id)->miss_classifier)
+        miss_classifier_access(MLC(req->proc_id)->miss_classifier, req->addr,
+                               TRUE);
       STAT_EVENT(req->proc_id, MLC_HIT_ONPATH + req->off_path);
       if(0 && DEBUG_EXC_INSERTS) {
         printf("addr:%s hit in MLC type:%s\n", hexstr64s(req->addr),
@@ -1305,6 +1487,12 @@ static Flag mem_process_l1_miss_access(Mem_Req*         req,
        (req->type == MRT_IFETCH)) {
       STAT_EVENT(req->proc_id, L1_MISS);
       STAT_EVENT(req->proc_id, CORE_L1_MISS);
+      if(L1(req->proc_id)->miss_classifier)
+        STAT_EVENT(req->proc_id,
+                   L1_MISS_COMPULSORY +
+                     miss_classifier_access(L1(req->proc_id)->miss_classifier,
+                                            req->addr, FALSE));
+      stack_sweep_access(STACK_SWEEP_LEVEL_L1, req->proc_id, req->addr);
       STAT_EVENT(req->proc_id, L1_MISS_ONPATH + req->off_path);
       STAT_EVENT(req->proc_id, PER1K_L1_DEMAND_MISS_ONPATH + req->off_path);
     }
@@ -1442,6 +1630,11 @@ static Flag mem_process_mlc_miss_access(Mem_Req*         req,
        (req->type == MRT_IFETCH)) {
       STAT_EVENT(req->proc_id, MLC_MISS);
       STAT_EVENT(req->proc_id, CORE_MLC_MISS);
+      if(MLC(req->proc_id)->miss_classifier)
+        STAT_EVENT(req->proc_id,
+                   MLC_MISS_COMPULSORY +
+                     miss_classifier_access(MLC(req->proc_id)->miss_classifier,
+                                            req->addr, FALSE));
       STAT_EVENT(req->proc_id, MLC_MISS_ONPATH + req->off_path);
     }
     STAT_EVENT(req->proc_id, MLC_MISS_ALL);
@@ -1956,9 +2149,8 @@ static void mem_process_l1_reqs() {
     /* After this sort requests that should be removed will be at the tail of
      * the l1_queue */
     DEBUG(0, "l1_queue removal\n");
-    qsort(mem->l1_queue.base, mem->l1_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
-    mem->l1_queue.entry_count -= l1_queue_removal_count;
+    mem_queue_sort(&mem->l1_queue);
+    mem_queue_remove_tail(&mem->l1_queue, l1_queue_removal_count);
     ASSERT(req->proc_id, mem->l1_queue.entry_count >= 0);
     /* if HIER_MSHR_ON, requests stay in the queues until filled (by reserving
      * entries) */
@@ -1970,11 +2162,9 @@ static void mem_process_l1_reqs() {
   /* Sort the out queue if requests were inserted */
   if(!ALL_FIFO_QUEUES && (out_queue_insertion_count > 0)) {
     if(CONSTANT_MEMORY_LATENCY) {  // request went straight to L1 fill queue
-      qsort(mem->l1fill_queue.base, mem->l1fill_queue.entry_count,
-            sizeof(Mem_Queue_Entry), mem_compare_priority);
+      mem_queue_sort(&mem->l1fill_queue);
     } else {
-      qsort(mem->bus_out_queue.base, mem->bus_out_queue.entry_count,
-            sizeof(Mem_Queue_Entry), mem_compare_priority);
+      mem_queue_sort(&mem->bus_out_queue);
     }
   }
 }
@@ -2048,9 +2238,8 @@ static void mem_process_mlc_reqs() {
     /* After this sort requests that should be removed will be at the tail of
      * the mlc_queue */
     DEBUG(0, "mlc_queue removal\n");
-    qsort(mem->mlc_queue.base, mem->mlc_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
-    mem->mlc_queue.entry_count -= mlc_queue_removal_count;
+    mem_queue_sort(&mem->mlc_queue);
+    mem_queue_remove_tail(&mem->mlc_queue, mlc_queue_removal_count);
     ASSERT(req->proc_id, mem->mlc_queue.entry_count >= 0);
     /* if HIER_MSHR_ON, requests stay in the queues until filled (by reserving
      * entries) */
@@ -2061,8 +2250,7 @@ static void mem_process_mlc_reqs() {
 
   /* Sort the l1 queue if requests were inserted */
   if(!ALL_FIFO_QUEUES && (l1_queue_insertion_count > 0)) {
-    qsort(mem->l1_queue.base, mem->l1_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_queue_sort(&mem->l1_queue);
   }
 }
 
@@ -2380,9 +2568,8 @@ static void mem_process_bus_out_reqs() {
     //}
 
     DEBUG(0, "bus_out_queue removal\n");
-    qsort(mem->bus_out_queue.base, mem->bus_out_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
-    mem->bus_out_queue.entry_count--;
+    mem_queue_sort(&mem->bus_out_queue);
+    mem_queue_remove_tail(&mem->bus_out_queue, 1);
     ASSERT(req->proc_id, mem->bus_out_queue.entry_count >= 0);
 
     // Ramulator_remove: Ramulator implements its own request queues. This
@@ -2458,9 +2645,8 @@ static void remove_from_l1_fill_queue(uns  proc_id,
     /* After this sort requests that should be removed will be at the tail of
      * the l1_queue */
     DEBUG(0, "l1fill_queue removal\n");
-    qsort(mem->l1fill_queue.base, mem->l1fill_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
-    mem->l1fill_queue.entry_count -= *p_l1fill_queue_removal_count;
+    mem_queue_sort(&mem->l1fill_queue);
+    mem_queue_remove_tail(&mem->l1fill_queue, *p_l1fill_queue_removal_count);
     ASSERT(proc_id, mem->l1fill_queue.entry_count >= 0);
     /* free corresponding reserved entries in the L1 queue if HIER_MSHR_ON */
     if(HIER_MSHR_ON) {
@@ -2640,9 +2826,8 @@ static void mem_process_mlc_fill_reqs() {
     /* After this sort requests that should be removed will be at the tail of
      * the mlc_queue */
     DEBUG(0, "mlc_fill_queue removal\n");
-    qsort(mem->mlc_fill_queue.base, mem->mlc_fill_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
-    mem->mlc_fill_queue.entry_count -= mlc_fill_queue_removal_count;
+    mem_queue_sort(&mem->mlc_fill_queue);
+    mem_queue_remove_tail(&mem->mlc_fill_queue, mlc_fill_queue_removal_count);
     ASSERT(req->proc_id, mem->mlc_fill_queue.entry_count >= 0);
     /* free corresponding reserved entries in the MLC queue if HIER_MSHR_ON */
     if(HIER_MSHR_ON) {
@@ -2694,9 +2879,8 @@ static void mem_process_core_fill_reqs(uns proc_id) {
     /* After this sort requests that should be removed will be at the tail of
      * the core_fill_queue */
     DEBUG(0, "core_fill_queue removal\n");
-    qsort(core_fill_queue->base, core_fill_queue->entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
-    core_fill_queue->entry_count -= core_fill_queue_removal_count;
+    mem_queue_sort(core_fill_queue);
+    mem_queue_remove_tail(core_fill_queue, core_fill_queue_removal_count);
     ASSERT(req->proc_id, core_fill_queue->entry_count >= 0);
   }
 }
@@ -2705,8 +2889,10 @@ static void mem_process_core_fill_reqs(uns proc_id) {
 /* scan_stores: */
 
 Flag scan_stores(Addr addr, uns size) {
-  uns ii;
+  uns  ii;
+  Flag result = FAILURE;
 
+  cmp_threads_lock();
   for(ii = 0; ii < mem->total_mem_req_buffers; ii++) {
     Mem_Req* req = &mem->req_buffer[ii];
     if(req->state != MRS_INV && req->type == MRT_DSTORE &&
@@ -2715,10 +2901,12 @@ Flag scan_stores(Addr addr, uns size) {
       ASSERTM(req->proc_id, req->proc_id == load_proc_id,
               "Load from %d matched a store from %d!\n", load_proc_id,
               req->proc_id);
-      return SUCCESS;
+      result = SUCCESS;
+      break;
     }
   }
-  return FAILURE;
+  cmp_threads_unlock();
+  return result;
 }
 
 
@@ -2745,6 +2933,10 @@ static inline Mem_Req* mem_search_queue(
 
   *demand_hit_prefetch = FALSE;
 
+  /* nothing in the queue can match an address its index has never seen */
+  if(!hash_table_access(&queue->addr_index, mem_queue_index_key(addr)))
+    return NULL;
+
   // CMP ignore "size" from argument
 
   for(ii = 0; ii < queue->entry_count; ii++) {
@@ -3068,19 +3260,19 @@ Flag mem_adjust_matching_request(Mem_Req* req, Mem_Req_Type type, Addr addr,
     if(!req->done_func)
       req->done_func = done_func;
     if(req->mlc_miss)
-      op->engine_info.mlc_miss = TRUE;
+      OP_ENGINE(op).mlc_miss = TRUE;
     if(req->l1_miss) {
-      op->engine_info.l1_miss = TRUE;
+      OP_ENGINE(op).l1_miss = TRUE;
       if(TRACK_L1_MISS_DEPS)
         mark_l1_miss_deps(op);
     }
 
-    op->engine_info.mlc_miss_satisfied = req->mlc_miss_satisfied ?
+    OP_ENGINE(op).mlc_miss_satisfied = req->mlc_miss_satisfied ?
                                            TRUE :
-                                           op->engine_info.mlc_miss_satisfied;
-    op->engine_info.l1_miss_satisfied = req->l1_miss_satisfied ?
+                                           OP_ENGINE(op).mlc_miss_satisfied;
+    OP_ENGINE(op).l1_miss_satisfied = req->l1_miss_satisfied ?
                                           TRUE :
-                                          op->engine_info.l1_miss_satisfied;
+                                          OP_ENGINE(op).l1_miss_satisfied;
 
     // cmp FIXME prefetchers
     if(demand_hit_prefetch && type != MRT_DPRF && type != MRT_IPRF) {
@@ -3131,8 +3323,7 @@ Flag mem_adjust_matching_request(Mem_Req* req, Mem_Req_Type type, Addr addr,
         req->type = type;
         memview_req_changed_type(req);
       }
-      qsort(req->queue->base, req->queue->entry_count, sizeof(Mem_Queue_Entry),
-            mem_compare_priority); /* Sort the associated queue */
+      mem_queue_sort(req->queue); /* Sort the associated queue */
     }
 
     switch(req->queue->type) {
@@ -3229,8 +3420,9 @@ Flag mem_adjust_matching_request(Mem_Req* req, Mem_Req_Type type, Addr addr,
 /**************************************************************************************/
 /* mem_can_allocate_req_buffer: */
 
-Flag mem_can_allocate_req_buffer(uns proc_id, Mem_Req_Type type,
-                                 Flag for_l1_writeback) {
+static Flag mem_can_allocate_req_buffer_unlocked(uns          proc_id,
+                                                 Mem_Req_Type type,
+                                                 Flag         for_l1_writeback) {
   Counter watermark = MEM_REQ_BUFFER_PREF_WATERMARK;
 
   if(type == MRT_IPRF || type == MRT_DPRF || type == MRT_UOCPRF || type == MRT_FDIPPRFON || type == MRT_FDIPPRFOFF) {
@@ -3325,8 +3517,7 @@ static Mem_Req* mem_kick_out_prefetch_from_queue(uns mem_bank, Mem_Queue* queue,
   if(queue->entry_count == 0)
     return NULL;
 
-  qsort(queue->base, queue->entry_count, sizeof(Mem_Queue_Entry),
-        mem_compare_priority);
+  mem_queue_sort(queue);
 
   if(KICKOUT_OLDEST_PREFETCH) {
     int      ii, oldest_index = 0;
@@ -3373,9 +3564,8 @@ static Mem_Req* mem_kick_out_prefetch_from_queue(uns mem_bank, Mem_Queue* queue,
       queue->base[oldest_index].priority =
         Mem_Req_Priority_Offset[MRT_MIN_PRIORITY];
       DEBUG(0, "%s removal\n", queue->name);
-      qsort(queue->base, queue->entry_count, sizeof(Mem_Queue_Entry),
-            mem_compare_priority);
-      queue->entry_count--;
+      mem_queue_sort(queue);
+      mem_queue_remove_tail(queue, 1);
       pref_req_drop_process(
         req_kicked_out->proc_id,
         mem->req_buffer[queue->base[oldest_index].reqbuf].prefetcher_id);
@@ -3398,7 +3588,7 @@ static Mem_Req* mem_kick_out_prefetch_from_queue(uns mem_bank, Mem_Queue* queue,
                  ONPATH_KICKED_OUT_PREFETCH);
       queue->base[queue->entry_count - 1].priority =
         Mem_Req_Priority_Offset[MRT_MIN_PRIORITY];
-      queue->entry_count--;
+      mem_queue_remove_tail(queue, 1);
       pref_req_drop_process(mem->req_buffer[kickout_reqbuf_num].proc_id,
                             mem->req_buffer[kickout_reqbuf_num].prefetcher_id);
       return &(mem->req_buffer[kickout_reqbuf_num]);
@@ -3674,10 +3864,14 @@ static inline Mem_Queue_Entry* mem_insert_req_into_queue(Mem_Req*   new_req,
           mem->l1_queue.entry_count, mem->bus_out_queue.entry_count,
           mem->l1fill_queue.entry_count, mem->req_buffer_free_list.count);
 
+  ASSERT(new_req->proc_id, new_req->size <= mem_queue_index_line_size);
+
   Mem_Queue_Entry* new_entry = &queue->base[queue->entry_count];
   new_entry->reqbuf          = new_req->id;
   new_entry->priority        = priority > 0 ? priority : new_req->priority;
+  new_entry->line_addr       = mem_queue_index_key(new_req->addr);
   queue->entry_count++;
+  mem_queue_index_add(queue, new_entry->line_addr);
 
 
   DEBUG(new_req->proc_id,
@@ -3723,10 +3917,11 @@ void mem_insert_req_round_robin() {
 /* new_mem_req: */
 /* Returns TRUE if the request is successfully entered into the memory system */
 
-Flag new_mem_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
-                 uns delay, Op* op, Flag done_func(Mem_Req*),
-                 Counter unique_num, /* This counter is used when op is NULL */
-                 Pref_Req_Info* pref_info) {
+static Flag new_mem_req_unlocked(
+  Mem_Req_Type type, uns8 proc_id, Addr addr, uns size, uns delay, Op* op,
+  Flag    done_func(Mem_Req*),
+  Counter unique_num, /* This counter is used when op is NULL */
+  Pref_Req_Info* pref_info) {
   Mem_Req*         new_req              = NULL;
   Mem_Req*         matching_req         = NULL;
   Mem_Queue_Entry* queue_entry          = NULL;
@@ -3913,11 +4108,11 @@ Flag new_mem_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
 
       if(data) {
         pref_ul1_hit(proc_id, addr, (op ? op->inst_info->addr : 0),
-                     (op ? op->oracle_info.pred_global_hist : 0));
+                     (op ? OP_ORACLE(op).pred_global_hist : 0));
       } else {
         // TREAT queue hits as misses
         pref_ul1_miss(proc_id, addr, (op ? op->inst_info->addr : 0),
-                      (op ? op->oracle_info.pred_global_hist : 0));
+                      (op ? OP_ORACLE(op).pred_global_hist : 0));
       }
     }
   } else {
@@ -3936,11 +4131,11 @@ Flag new_mem_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
 
       if(data) {
         pref_umlc_hit(proc_id, addr, (op ? op->inst_info->addr : 0),
-                      (op ? op->oracle_info.pred_global_hist : 0));
+                      (op ? OP_ORACLE(op).pred_global_hist : 0));
       } else {
         // TREAT queue hits as misses
         pref_umlc_miss(proc_id, addr, (op ? op->inst_info->addr : 0),
-                       (op ? op->oracle_info.pred_global_hist : 0));
+                       (op ? OP_ORACLE(op).pred_global_hist : 0));
       }
     }
   }
@@ -4023,9 +4218,10 @@ static Flag insert_new_req_into_mlc_queue(uns proc_id, Mem_Req* new_req) {
 /* new_mem_dc_wb_req: */
 /* Returns TRUE if the request is successfully entered into the memory system */
 
-Flag new_mem_dc_wb_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
-                       uns delay, Op* op, Flag done_func(Mem_Req*),
-                       Counter unique_num, Flag used_onpath) {
+static Flag new_mem_dc_wb_req_unlocked(Mem_Req_Type type, uns8 proc_id,
+                                       Addr addr, uns size, uns delay, Op* op,
+                                       Flag    done_func(Mem_Req*),
+                                       Counter unique_num, Flag used_onpath) {
   Mem_Req*         new_req              = NULL;
   Mem_Req*         matching_req         = NULL;
   Mem_Queue_Entry* queue_entry          = NULL;
@@ -4383,7 +4579,7 @@ void op_nuke_mem_req(Op* op) {
  * @param req
  * @return Flag 1 on successful fill
  */
-Flag l1_fill_line(Mem_Req* req) {
+static Flag l1_fill_line_unlocked(Mem_Req* req) {
   L1_Data* data;
   Addr     line_addr, repl_line_addr = 0;
   Op*      top;
@@ -4409,8 +4605,8 @@ Flag l1_fill_line(Mem_Req* req) {
      ((USE_CONFIRMED_OFF ? req->off_path_confirmed : req->off_path) ||
       (req->type == MRT_DPRF))) {  // ONURP: Add prefetches
     ASSERT(0, ADDR_TRANSLATION == ADDR_TRANS_NONE);
-    data = (L1_Data*)cache_insert(&mem->pref_l1_cache, req->proc_id, req->addr,
-                                  &line_addr, &repl_line_addr);
+    data = (L1_Data*)line_cache_insert(mem->pref_l1_cache, req->proc_id,
+                                       req->addr, &line_addr, &repl_line_addr);
     STAT_EVENT(req->proc_id, L1_PREF_CACHE_FILL);
     req->l1_miss_satisfied = TRUE;
 
@@ -4999,8 +5195,10 @@ L1_Data* do_l1_access(Op* op) {
   L1_Data* hit;
   Addr     line_addr;
 
-  hit = (L1_Data*)cache_access(&L1(op->proc_id)->cache, op->oracle_info.va,
+  cmp_threads_lock();
+  hit = (L1_Data*)cache_access(&L1(op->proc_id)->cache, OP_ORACLE(op).va,
                                &line_addr, FALSE);
+  cmp_threads_unlock();
 
   return hit;
 }
@@ -5012,7 +5210,7 @@ MLC_Data* do_mlc_access(Op* op) {
   MLC_Data* hit;
   Addr      line_addr;
 
-  hit = (MLC_Data*)cache_access(&MLC(op->proc_id)->cache, op->oracle_info.va,
+  hit = (MLC_Data*)cache_access(&MLC(op->proc_id)->cache, OP_ORACLE(op).va,
                                 &line_addr, FALSE);
 
   return hit;
@@ -5026,7 +5224,9 @@ L1_Data* do_l1_access_addr(Addr addr) {
   Addr     line_addr;
   uns      proc_id = get_proc_id_from_cmp_addr(addr);
 
+  cmp_threads_lock();
   hit = (L1_Data*)cache_access(&L1(proc_id)->cache, addr, &line_addr, FALSE);
+  cmp_threads_unlock();
 
   return hit;
 }
@@ -5059,7 +5259,7 @@ static void mark_ops_as_l1_miss(Mem_Req* req) {
     if(op->unique_num == *op_unique && op->op_pool_valid) {
       ASSERT(req->proc_id, req->proc_id == op->proc_id);
       if(op->req == req) {
-        op->engine_info.l1_miss = TRUE;
+        OP_ENGINE(op).l1_miss = TRUE;
         if(TRACK_L1_MISS_DEPS)
           mark_l1_miss_deps(op);
       }
@@ -5091,7 +5291,7 @@ void mark_ops_as_l1_miss_satisfied(Mem_Req* req) {
               op->off_path, op->table_info->op_type, op->table_info->mem_type);
 
       if(op->req == req) {
-        op->engine_info.l1_miss_satisfied = TRUE;
+        OP_ENGINE(op).l1_miss_satisfied = TRUE;
         if(TRACK_L1_MISS_DEPS) {
           unmark_l1_miss_deps(op);
         }
@@ -5110,8 +5310,8 @@ static void mark_l1_miss_deps(Op* op) {
   Wake_Up_Entry* temp;
 
   ASSERT(op->proc_id,
-         (op->engine_info.l1_miss && !op->engine_info.l1_miss_satisfied) ||
-           op->engine_info.dep_on_l1_miss);
+         (OP_ENGINE(op).l1_miss && !OP_ENGINE(op).l1_miss_satisfied) ||
+           OP_ENGINE(op).dep_on_l1_miss);
 
   for(temp = op->wake_up_head; temp; temp = temp->next) {
     Op*     dep_op         = temp->op;
@@ -5123,13 +5323,13 @@ static void mark_l1_miss_deps(Op* op) {
       /*printf("MARK c: %s dep_op: %s %s %s %s op: %s %s %s %s\n",
          unsstr64(cycle_count), unsstr64(dep_op->unique_num),
          unsstr64(dep_op->exec_cycle), disasm_op(dep_op, TRUE),
-         unsstr64(dep_op->oracle_info.va), unsstr64(op->unique_num),
+         unsstr64(OP_ORACLE(dep_op).va), unsstr64(op->unique_num),
          unsstr64(op->exec_cycle), disasm_op(op, TRUE),
-         unsstr64(op->oracle_info.va)); */
-      ASSERT(dep_op->proc_id, !dep_op->engine_info.l1_miss ||
+         unsstr64(OP_ORACLE(op).va)); */
+      ASSERT(dep_op->proc_id, !OP_ENGINE(dep_op).l1_miss ||
                                 dep_op->table_info->mem_type == MEM_ST);
-      if(!dep_op->engine_info.dep_on_l1_miss) {
-        dep_op->engine_info.dep_on_l1_miss = TRUE;
+      if(!OP_ENGINE(dep_op).dep_on_l1_miss) {
+        OP_ENGINE(dep_op).dep_on_l1_miss = TRUE;
         mark_l1_miss_deps(dep_op);
       }
     }
@@ -5144,9 +5344,9 @@ static void mark_l1_miss_deps(Op* op) {
 static void unmark_l1_miss_deps(Op* op) {
   Wake_Up_Entry* temp;
 
-  ASSERT(op->proc_id, op->engine_info.l1_miss_satisfied ||
-                        (!op->engine_info.dep_on_l1_miss &&
-                         op->engine_info.was_dep_on_l1_miss));
+  ASSERT(op->proc_id, OP_ENGINE(op).l1_miss_satisfied ||
+                        (!OP_ENGINE(op).dep_on_l1_miss &&
+                         OP_ENGINE(op).was_dep_on_l1_miss));
 
   /* Go thru the wake up list and unmark ops if they are not dependent on
    * another l1 miss */
@@ -5156,14 +5356,14 @@ static void unmark_l1_miss_deps(Op* op) {
 
     if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
       int      ii;
-      Op_Info* op_info              = &dep_op->oracle_info;
+      Op_Info* op_info              = &OP_ORACLE(dep_op);
       Flag     still_dep_on_l1_miss = FALSE;
 
       ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
-      ASSERT(dep_op->proc_id, dep_op->engine_info.dep_on_l1_miss ||
-                                dep_op->engine_info.was_dep_on_l1_miss);
+      ASSERT(dep_op->proc_id, OP_ENGINE(dep_op).dep_on_l1_miss ||
+                                OP_ENGINE(dep_op).was_dep_on_l1_miss);
 
-      if(dep_op->engine_info.dep_on_l1_miss) {
+      if(OP_ENGINE(dep_op).dep_on_l1_miss) {
         /* Determine if the op is dependent on another l1_miss */
         for(ii = 0; ii < op_info->num_srcs; ii++) {
           Src_Info* src_info = &op_info->src_info[ii];
@@ -5172,9 +5372,9 @@ static void unmark_l1_miss_deps(Op* op) {
           if(src_op->unique_num == src_info->unique_num &&
              src_op->op_pool_valid) {
             if(src_op->unique_num != op->unique_num)
-              if((src_op->engine_info.l1_miss &&
-                  !src_op->engine_info.l1_miss_satisfied) ||
-                 src_op->engine_info.dep_on_l1_miss)
+              if((OP_ENGINE(src_op).l1_miss &&
+                  !OP_ENGINE(src_op).l1_miss_satisfied) ||
+                 OP_ENGINE(src_op).dep_on_l1_miss)
                 still_dep_on_l1_miss = TRUE;
           }
           if(still_dep_on_l1_miss)
@@ -5184,8 +5384,8 @@ static void unmark_l1_miss_deps(Op* op) {
         /* If the op is not dependent on another l1 miss, then go ahead and
            unmark it and figure out if we need to unmark its dependents */
         if(!still_dep_on_l1_miss) {
-          dep_op->engine_info.dep_on_l1_miss     = FALSE;
-          dep_op->engine_info.was_dep_on_l1_miss = TRUE;
+          OP_ENGINE(dep_op).dep_on_l1_miss     = FALSE;
+          OP_ENGINE(dep_op).was_dep_on_l1_miss = TRUE;
           unmark_l1_miss_deps(dep_op);
         }
       }
@@ -5196,8 +5396,8 @@ static void unmark_l1_miss_deps(Op* op) {
 L1_Data* l1_pref_cache_access(Mem_Req* req) {
   Addr     line_addr, repl_line_addr, pref_line_addr;
   L1_Data* data      = NULL;
-  L1_Data* pref_data = (L1_Data*)cache_access(&mem->pref_l1_cache, req->addr,
-                                              &pref_line_addr, FALSE);
+  L1_Data* pref_data = (L1_Data*)line_cache_access(
+    mem->pref_l1_cache, req->addr, &pref_line_addr, FALSE);
 
   if(req->off_path && !PREFCACHE_MOVE_OFFPATH)
     return pref_data;  // offpath request doesn't change pref cache and l1 cache
@@ -5253,7 +5453,7 @@ L1_Data* l1_pref_cache_access(Mem_Req* req) {
     STAT_EVENT(req->proc_id, L1_PREF_CACHE_HIT + req->off_path);
 
     ASSERT(0, ADDR_TRANSLATION == ADDR_TRANS_NONE);
-    cache_invalidate(&mem->pref_l1_cache, req->addr, &pref_line_addr);
+    line_cache_invalidate(mem->pref_l1_cache, req->addr, &pref_line_addr);
   }
   return data;
 }
@@ -5482,7 +5682,7 @@ void wp_process_reqbuf_match(Mem_Req* req, Op* op) {
         DEBUG(0,
               "Reqbuf match: On path hits off path. va:%s op:%s op:0x%s "
               "wp_op:0x%s opu:%s wpu:%s dist:%s%s\n",
-              hexstr64s(op->oracle_info.va), disasm_op(op, TRUE),
+              hexstr64s(OP_ORACLE(op).va), disasm_op(op, TRUE),
               hexstr64s(op->inst_info->addr), hexstr64s(req->oldest_op_addr),
               unsstr64(op->unique_num), unsstr64(req->oldest_op_unique_num),
               op->unique_num > req->oldest_op_unique_num ? " " : "-",
@@ -5537,11 +5737,58 @@ uns num_offchip_stall_reqs(uns proc_id) {
              // only to collect statistics
 }
 
+/**************************************************************************************/
+/* Entry points of the memory system for the core stages.  When the cores are
+ * simulated on parallel host threads (see cmp_threads.c), they serialize on
+ * the cmp threads lock. */
+
+Flag new_mem_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
+                 uns delay, Op* op, Flag done_func(Mem_Req*),
+                 Counter unique_num, /* This counter is used when op is NULL */
+                 Pref_Req_Info* pref_info) {
+  cmp_threads_lock();
+  Flag result = new_mem_req_unlocked(type, proc_id, addr, size, delay, op,
+                                     done_func, unique_num, pref_info);
+  cmp_threads_unlock();
+  return result;
+}
+
+Flag new_mem_dc_wb_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
+                       uns delay, Op* op, Flag done_func(Mem_Req*),
+                       Counter unique_num, Flag used_onpath) {
+  cmp_threads_lock();
+  Flag result = new_mem_dc_wb_req_unlocked(type, proc_id, addr, size, delay,
+                                           op, done_func, unique_num,
+                                           used_onpath);
+  cmp_threads_unlock();
+  return result;
+}
+
+Flag mem_can_allocate_req_buffer(uns proc_id, Mem_Req_Type type,
+                                 Flag for_l1_writeback) {
+  cmp_threads_lock();
+  Flag result = mem_can_allocate_req_buffer_unlocked(proc_id, type,
+                                                     for_l1_writeback);
+  cmp_threads_unlock();
+  return result;
+}
+
+Flag l1_fill_line(Mem_Req* req) {
+  cmp_threads_lock();
+  Flag result = l1_fill_line_unlocked(req);
+  cmp_threads_unlock();
+  return result;
+}
+
 Mem_Req* mem_search_reqbuf_wrapper(
   uns8 proc_id, Addr addr, Mem_Req_Type type, uns size,
   Flag* demand_hit_prefetch, Flag* demand_hit_writeback, uns queues_to_search,
   Mem_Queue_Entry** queue_entry, Flag* ramulator_match) {
-  return mem_search_reqbuf(proc_id, addr, type, size,
-                           demand_hit_prefetch, demand_hit_writeback,
-                           queues_to_search, queue_entry, ramulator_match);
+  cmp_threads_lock();
+  Mem_Req* req = mem_search_reqbuf(proc_id, addr, type, size,
+                                   demand_hit_prefetch, demand_hit_writeback,
+                                   queues_to_search, queue_entry,
+                                   ramulator_match);
+  cmp_threads_unlock();
+  return req;
 }
@@ -30,9 +30,11 @@
 #ifndef __MEMORY_H__
 #define __MEMORY_H__
 
+#include "cache_miss_analyzer.h"
 #include "freq.h"
 #include "globals/global_defs.h"
 #include "globals/global_types.h"
+#include "libs/cache_engine_c.h"
 #include "libs/cache_lib.h"
 #include "libs/hash_lib.h"
 #include "libs/list_lib.h"
@@ -96,6 +98,7 @@ typedef struct Mem_Queue_Entry_struct {
   int     reqbuf;   /* request buffer num */
   Counter priority; /* priority of the miss */
   Counter rdy_cycle;
+  Addr    line_addr; /* index key, latched at insert (reqbuf may be reused) */
 } Mem_Queue_Entry;
 
 typedef struct Mem_Queue_struct {
@@ -105,6 +108,7 @@ typedef struct Mem_Queue_struct {
   uns              size;
   char             name[20];
   Mem_Queue_Type   type;
+  Hash_Table       addr_index; /* line addr -> number of entries (uns) */
 } Mem_Queue;
 
 typedef struct Mem_Bank_Queue_Entry_struct {
@@ -126,6 +130,7 @@ typedef struct Ported_Cache_struct {
   struct Cache_struct  cache;
   struct Ports_struct* ports;
   uns                  num_banks;
+  Miss_Classifier*     miss_classifier; /* 3C classifier (NULL if disabled) */
 } Ported_Cache;
 
 typedef struct Uncore_struct {
@@ -150,7 +155,7 @@ typedef struct Memory_struct {
   Uncore* uncores;
 
   /* prfetcher cache */
-  Cache pref_l1_cache;
+  Line_Cache* pref_l1_cache;
 
   /* various queues (arrays) */
   Mem_Queue  mlc_queue;
@@ -217,6 +222,9 @@ typedef struct Umon_Cache_Data_struct {
 /**************************************************************************************/
 /* Prototypes */
 int mem_compare_priority(const void* a, const void* b);
+Flag mem_is_quiescent(void);
+Counter mem_next_event_time(void);
+void    mem_skip_cycles(Counter cycles);
 
 void set_memory(Memory*);
 void init_memory(void);
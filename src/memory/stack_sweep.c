@@ -0,0 +1,191 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/stack_sweep.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Miss ratio curves for a whole range of cache geometries in
+ *                one run.  Every power-of-two set count between
+ *                STACK_SWEEP_MIN_SETS and STACK_SWEEP_MAX_SETS keeps an LRU
+ *                stack of STACK_SWEEP_MAX_ASSOC lines per set; the position
+ *                of each hit in its stack tells, by the LRU inclusion
+ *                property, which associativities would have hit too.
+ ***************************************************************************************/
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "memory/stack_sweep.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Sweep_Geometry_struct {
+  uns      num_sets;
+  Addr*    stacks; /* STACK_SWEEP_MAX_ASSOC lines per set, MRU first */
+  Counter* hits;   /* hits at each stack position */
+} Sweep_Geometry;
+
+typedef struct Sweep_struct {
+  Counter         accesses;
+  Sweep_Geometry* geometries;
+} Sweep;
+
+/**************************************************************************************/
+/* Global variables */
+
+static Sweep* sweeps;  // one per core, or a single one for a shared level
+static uns    num_sweeps;
+static Flag   shared;
+static uns    num_geometries;
+static uns    line_size;
+static uns    line_shift;
+
+/**************************************************************************************/
+/* Enums */
+
+DEFINE_ENUM(Stack_Sweep_Level, STACK_SWEEP_LEVEL_LIST);
+
+/**************************************************************************************/
+/* stack_sweep_init: */
+
+void stack_sweep_init(void) {
+  if(STACK_SWEEP_LEVEL == STACK_SWEEP_LEVEL_NONE)
+    return;
+
+  ASSERTM(0, is_power_of_2(STACK_SWEEP_MIN_SETS),
+          "STACK_SWEEP_MIN_SETS must be a power of two\n");
+  ASSERTM(0, is_power_of_2(STACK_SWEEP_MAX_SETS) &&
+               STACK_SWEEP_MAX_SETS >= STACK_SWEEP_MIN_SETS,
+          "STACK_SWEEP_MAX_SETS must be a power of two >= "
+          "STACK_SWEEP_MIN_SETS\n");
+  ASSERT(0, STACK_SWEEP_MAX_ASSOC > 0);
+
+  switch(STACK_SWEEP_LEVEL) {
+    case STACK_SWEEP_LEVEL_DCACHE:
+      line_size = DCACHE_LINE_SIZE;
+      shared    = FALSE;
+      break;
+    case STACK_SWEEP_LEVEL_L1:
+      line_size = L1_LINE_SIZE;
+      shared    = !PRIVATE_L1;
+      break;
+    case STACK_SWEEP_LEVEL_WARMUP_UNCORE:
+      // the first uncore level: the (shared) MLC if present, else the L1
+      line_size = MLC_PRESENT ? MLC_LINE_SIZE : L1_LINE_SIZE;
+      shared    = MLC_PRESENT || !PRIVATE_L1;
+      break;
+    default:
+      FATAL_ERROR(0, "Unknown STACK_SWEEP_LEVEL %s\n",
+                  Stack_Sweep_Level_str(STACK_SWEEP_LEVEL));
+  }
+  line_shift = LOG2(line_size);
+  num_sweeps = shared ? 1 : NUM_CORES;
+
+  num_geometries = 0;
+  for(uns sets = STACK_SWEEP_MIN_SETS; sets <= STACK_SWEEP_MAX_SETS; sets <<= 1)
+    num_geometries++;
+
+  sweeps = (Sweep*)calloc(num_sweeps, sizeof(Sweep));
+  for(uns ii = 0; ii < num_sweeps; ii++) {
+    Sweep* sweep      = &sweeps[ii];
+    sweep->geometries = (Sweep_Geometry*)calloc(num_geometries,
+                                                sizeof(Sweep_Geometry));
+    for(uns jj = 0; jj < num_geometries; jj++) {
+      Sweep_Geometry* geometry = &sweep->geometries[jj];
+      uns             entries  = (STACK_SWEEP_MIN_SETS << jj) *
+                      STACK_SWEEP_MAX_ASSOC;
+      geometry->num_sets = STACK_SWEEP_MIN_SETS << jj;
+      geometry->stacks   = (Addr*)malloc(entries * sizeof(Addr));
+      memset(geometry->stacks, 0xff, entries * sizeof(Addr));  // empty ways
+      geometry->hits = (Counter*)calloc(STACK_SWEEP_MAX_ASSOC,
+                                        sizeof(Counter));
+    }
+  }
+}
+
+/**************************************************************************************/
+/* stack_sweep_access: */
+
+void stack_sweep_access(Stack_Sweep_Level level, uns proc_id, Addr addr) {
+  if(level != STACK_SWEEP_LEVEL)
+    return;
+
+  Sweep* sweep = &sweeps[shared ? 0 : proc_id];
+  Addr   line  = addr >> line_shift;
+  uns    assoc = STACK_SWEEP_MAX_ASSOC;
+
+  sweep->accesses++;
+  for(uns ii = 0; ii < num_geometries; ii++) {
+    Sweep_Geometry* geometry = &sweep->geometries[ii];
+    Addr* stack = &geometry->stacks[(line & (geometry->num_sets - 1)) * assoc];
+    uns   pos   = 0;
+    while(pos < assoc && stack[pos] != line)
+      pos++;
+    if(pos < assoc)
+      geometry->hits[pos]++;
+    else
+      pos = assoc - 1;  // the LRU line falls off the stack
+    memmove(&stack[1], &stack[0], pos * sizeof(Addr));
+    stack[0] = line;
+  }
+}
+
+/**************************************************************************************/
+/* stack_sweep_done: */
+
+void stack_sweep_done(void) {
+  if(STACK_SWEEP_LEVEL == STACK_SWEEP_LEVEL_NONE)
+    return;
+
+  FILE* file = file_tag_fopen(OUTPUT_DIR, "stack_sweep", "w");
+  ASSERTM(0, file, "Could not open the stack sweep output file\n");
+
+  for(uns ii = 0; ii < num_sweeps; ii++) {
+    Sweep* sweep = &sweeps[ii];
+    fprintf(file, "# level %s  %s %u  line_size %u  accesses %llu\n",
+            Stack_Sweep_Level_str(STACK_SWEEP_LEVEL),
+            shared ? "shared" : "core", ii,
+            line_size, sweep->accesses);
+    fprintf(file, "%10s %6s %12s %14s %10s\n", "sets", "assoc", "size",
+            "misses", "miss_ratio");
+    for(uns jj = 0; jj < num_geometries; jj++) {
+      Sweep_Geometry* geometry = &sweep->geometries[jj];
+      Counter         hits     = 0;
+      for(uns assoc = 1; assoc <= STACK_SWEEP_MAX_ASSOC; assoc++) {
+        hits += geometry->hits[assoc - 1];
+        Counter misses = sweep->accesses - hits;
+        fprintf(file, "%10u %6u %12llu %14llu %10.6f\n", geometry->num_sets,
+                assoc, (uns64)geometry->num_sets * assoc * line_size, misses,
+                sweep->accesses ? (double)misses / sweep->accesses : 0.0);
+      }
+    }
+    fprintf(file, "\n");
+  }
+  fclose(file);
+}
@@ -0,0 +1,58 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/stack_sweep.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Single-pass miss ratio curves (Mattson stack analysis) for
+ *                every power-of-two set count and every associativity up to
+ *                STACK_SWEEP_MAX_ASSOC, over the access stream of one level
+ ***************************************************************************************/
+
+#ifndef __STACK_SWEEP_H__
+#define __STACK_SWEEP_H__
+
+#include "globals/enum.h"
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Enums */
+
+#define STACK_SWEEP_LEVEL_LIST(elem) \
+  elem(NONE) elem(DCACHE) elem(L1) elem(WARMUP_UNCORE)
+
+DECLARE_ENUM(Stack_Sweep_Level, STACK_SWEEP_LEVEL_LIST, STACK_SWEEP_LEVEL_);
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Initialize */
+void stack_sweep_init(void);
+
+/* Report an access at 'level' (ignored unless it is STACK_SWEEP_LEVEL) */
+void stack_sweep_access(Stack_Sweep_Level level, uns proc_id, Addr addr);
+
+/* Write the miss ratio curves */
+void stack_sweep_done(void);
+
+#endif /* #ifndef __STACK_SWEEP_H__ */
+
@@ -73,6 +73,15 @@ typedef struct Model_struct {
   void (*op_retired_hook)(Op*);  // called just before the op is freed
   void (*warmup_func)(Op* op);   /* called for warmup(may be NULL) */
 
+  /* these functions let the main loop skip cycles in which the model cannot
+     make progress on its own (may be NULL) */
+  Counter (*next_event_func)(void); /* earliest cycle the model may change
+                                       state, cycle_count + 1 if busy */
+  Counter (*signature_func)(void);  /* folds the model's progress into one
+                                       value */
+  void (*skip_cycle_func)(Counter); /* called instead of cycle_func for a
+                                       number of skipped cycles */
+
   /*      void (*l0_cache_miss_hook)      (Op *); */
   /*      void (*resolve_mispredict_hook) (Op *); */
 } Model;
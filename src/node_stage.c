@@ -64,13 +64,14 @@
 
 #define DEBUG_NODE_WIDTH ISSUE_WIDTH
 #define OP_IS_IN_RS(op) (op->state >= OS_IN_RS && op->state < OS_SCHEDULED)
+#define RDY_NUM_WORDS ((NODE_TABLE_SIZE + 63) / 64)
 
 /**************************************************************************************/
 /* Global Variables */
 
-Node_Stage*            node                   = NULL;
-Rob_Stall_Reason       rob_stall_reason       = ROB_STALL_NONE;
-Rob_Block_Issue_Reason rob_block_issue_reason = ROB_BLOCK_ISSUE_NONE;
+SIM_THREAD_LOCAL Node_Stage*            node                   = NULL;
+SIM_THREAD_LOCAL Rob_Stall_Reason       rob_stall_reason       = ROB_STALL_NONE;
+SIM_THREAD_LOCAL Rob_Block_Issue_Reason rob_block_issue_reason = ROB_BLOCK_ISSUE_NONE;
 
 
 /**************************************************************************************/
@@ -89,6 +90,8 @@ Flag is_node_table_empty(void);
 void collect_not_ready_to_retire_stats(Op* op);
 Flag is_node_table_full(void);
 void collect_node_table_full_stats(Op* op);
+void reset_ready_list(void);
+static Op* rdy_find_op(uns age);
 
 /**************************************************************************************/
 /* set_node_stage:*/
@@ -111,6 +114,9 @@ void init_node_stage(uns8 proc_id, const char* name) {
   node->sd.max_op_count = NUM_FUS;  // Bandwidth between schedule and FUS
   node->sd.ops          = (Op**)malloc(sizeof(Op*) * node->sd.max_op_count);
 
+  node->rdy_ops    = (Op**)calloc(NODE_TABLE_SIZE, sizeof(Op*));
+  node->rdy_bitmap = (uns64*)calloc(RDY_NUM_WORDS, sizeof(uns64));
+
   reset_node_stage();
 }
 
@@ -125,8 +131,8 @@ void reset_node_stage() {
 
   node->node_head       = NULL;
   node->node_tail       = NULL;
-  node->rdy_head        = NULL;
   node->next_op_into_rs = NULL;
+  reset_ready_list();
 
   node->node_count           = 0;
   node->ret_op               = 1;
@@ -147,8 +153,8 @@ void reset_all_ops_node_stage() {
 
   node->node_head       = NULL;
   node->node_tail       = NULL;
-  node->rdy_head        = NULL;
   node->next_op_into_rs = NULL;
+  reset_ready_list();
 
   node->node_count       = 0;
   node->node_count       = 0;
@@ -182,16 +188,12 @@ void recover_node_stage() {
 }
 
 void flush_ready_list() {
-  Op*  op;
-  Op** last;
-  for(op = node->rdy_head, last = &node->rdy_head; op; op = op->next_rdy) {
+  for(Op* op = node_rdy_first(); op; op = node_rdy_next(op)) {
     ASSERT(node->proc_id, node->proc_id == op->proc_id);
     if(FLUSH_OP(op)) {
       ASSERT(node->proc_id, op->op_num > bp_recovery_info->recovery_op_num);
-      *last           = op->next_rdy;
-      op->in_rdy_list = FALSE;
-    } else
-      last = &op->next_rdy;
+      node_rdy_remove(op);
+    }
   }
 }
 
@@ -365,7 +367,7 @@ void debug_print_ready_list() {
 
   DPRINTF("Ready list:");
 
-  for(op = node->rdy_head; op; op = op->next_rdy) {
+  for(op = node_rdy_first(); op; op = node_rdy_next(op)) {
     DPRINTF(" %s", unsstr64(op->op_num));
   }
 
@@ -507,75 +509,102 @@ void check_if_mem_blocked() {
 }
 
 /**************************************************************************************/
-/* bubble: bubble pass for the ready list. Part of the bubble sort function
- * below. */
-
-static Flag bubble(Op* head, int n) {
-  Flag swapped     = FALSE;
-  Flag swapped_now = FALSE;
-  int  i;
-  Op*  prev = NULL;
-  Op*  cur  = head;
-  Op*  next = head->next_rdy;
-
-  for(i = 0; i < n - 1; i++) {
-    swapped_now = FALSE;
-    if(cur->op_num > next->op_num) {
-      if(prev)
-        prev->next_rdy = next;
-      cur->next_rdy  = next->next_rdy;
-      next->next_rdy = cur;
-      swapped        = TRUE;
-      swapped_now    = TRUE;
-      if(!prev)
-        node->rdy_head = next;
-    }
-    if(swapped_now) {
-      prev = next;
-      next = cur->next_rdy;
-    } else {
-      prev = cur;
-      cur  = next;
-      next = next->next_rdy;
-    }
-  }
+/* reset_ready_list: */
 
-  return swapped;
+void reset_ready_list() {
+  memset(node->rdy_ops, 0, sizeof(Op*) * NODE_TABLE_SIZE);
+  memset(node->rdy_bitmap, 0, sizeof(uns64) * RDY_NUM_WORDS);
+  node->rdy_count = 0;
 }
 
 /**************************************************************************************/
-/* sort_node_ready_list: sorts the ready list */
+/* node_rdy_insert: adds an op to the ready list. The op must be in the node
+ * table, which guarantees that its slot is free. */
+
+void node_rdy_insert(Op* op) {
+  uns slot = op->op_num % NODE_TABLE_SIZE;
+  ASSERT(node->proc_id, !op->in_rdy_list);
+  ASSERT(node->proc_id, op->in_node_list);
+  ASSERTM(node->proc_id,
+          op->op_num - node->node_head->op_num < NODE_TABLE_SIZE,
+          "op_num: %llu, node head: %llu\n", op->op_num,
+          node->node_head->op_num);
+  ASSERT(node->proc_id, !node->rdy_ops[slot]);
+  node->rdy_ops[slot] = op;
+  node->rdy_bitmap[slot / 64] |= 1ULL << (slot % 64);
+  node->rdy_count++;
+  op->in_rdy_list = TRUE;
+}
 
-inline static void sort_node_ready_list() {
-  Op* op;
-  int i;
-  int count_rdy = 0;
-  for(op = node->rdy_head; op; op = op->next_rdy) {
-    count_rdy++;
+/**************************************************************************************/
+/* node_rdy_remove: */
+
+void node_rdy_remove(Op* op) {
+  uns slot = op->op_num % NODE_TABLE_SIZE;
+  ASSERT(node->proc_id, op->in_rdy_list);
+  ASSERT(node->proc_id, node->rdy_ops[slot] == op);
+  node->rdy_ops[slot] = NULL;
+  node->rdy_bitmap[slot / 64] &= ~(1ULL << (slot % 64));
+  node->rdy_count--;
+  op->in_rdy_list = FALSE;
+}
+
+/**************************************************************************************/
+/* rdy_find_slot: returns the first occupied ready list slot in [start, end),
+ * or end if there is none. */
+
+static inline uns rdy_find_slot(uns start, uns end) {
+  if(start >= end)
+    return end;
+  uns   word = start / 64;
+  uns64 bits = node->rdy_bitmap[word] & (~0ULL << (start % 64));
+  while(!bits) {
+    if(++word * 64 >= end)
+      return end;
+    bits = node->rdy_bitmap[word];
   }
+  return MIN2(word * 64 + __builtin_ctzll(bits), end);
+}
 
-  DEBUG(node->proc_id, "Unsorted ready list: count: %d\n", count_rdy);
-  if(DEBUG_NODE_STAGE && DEBUG_RANGE_COND(node->proc_id)) {
-    for(op = node->rdy_head; op; op = op->next_rdy) {
-      DPRINTF("%s ", unsstr64(op->op_num));
-    }
-    DPRINTF("\n");
+/**************************************************************************************/
+/* rdy_find_op: returns the oldest ready op that is at least 'age' ops younger
+ * than the node table head, or NULL. Slots are allocated in op number order
+ * starting at the head's slot and wrapping around the table. */
+
+static Op* rdy_find_op(uns age) {
+  if(!node->rdy_count || age >= NODE_TABLE_SIZE)
+    return NULL;
+
+  uns head  = node->node_head->op_num % NODE_TABLE_SIZE;
+  uns start = (head + age) % NODE_TABLE_SIZE;
+  uns slot;
+  if(start >= head) {
+    slot = rdy_find_slot(start, NODE_TABLE_SIZE);
+    if(slot == NODE_TABLE_SIZE)
+      slot = rdy_find_slot(0, head);
+  } else {
+    slot = rdy_find_slot(start, head);
   }
 
-  for(i = count_rdy; (i > 1) && bubble(node->rdy_head, i); i--)
-    ;
+  if(slot == head && (start != head || !node->rdy_ops[slot]))
+    return NULL;
+  ASSERT(node->proc_id, node->rdy_ops[slot]);
+  return node->rdy_ops[slot];
+}
 
-  count_rdy = 0;
-  for(op = node->rdy_head; op; op = op->next_rdy)
-    count_rdy++;
+/**************************************************************************************/
+/* node_rdy_first: returns the oldest op in the ready list (NULL if empty) */
 
-  DEBUG(node->proc_id, "Sorted ready list: count: %d\n", count_rdy);
-  if(DEBUG_NODE_STAGE && DEBUG_RANGE_COND(node->proc_id)) {
-    for(op = node->rdy_head; op; op = op->next_rdy) {
-      DPRINTF("%s ", unsstr64(op->op_num));
-    }
-    DPRINTF("\n");
-  }
+Op* node_rdy_first() {
+  return rdy_find_op(0);
+}
+
+/**************************************************************************************/
+/* node_rdy_next: returns the oldest ready op younger than op (NULL if none).
+ * The op itself may have been removed from the ready list. */
+
+Op* node_rdy_next(Op* op) {
+  return rdy_find_op(op->op_num + 1 - node->node_head->op_num);
 }
 
 /**************************************************************************************/
@@ -607,7 +636,7 @@ void oldest_first_sched(Op* op) {
         DEBUG(node->proc_id,
               "Scheduler selecting    op_num:%s  fu_id:%d op:%s l1:%d\n",
               unsstr64(op->op_num), fu_id, disasm_op(op, TRUE),
-              op->engine_info.l1_miss);
+              OP_ENGINE(op).l1_miss);
         ASSERT(node->proc_id, fu_id < node->sd.max_op_count);
         op->fu_num                 = fu_id;
         node->sd.ops[op->fu_num]   = op;
@@ -639,7 +668,7 @@ void oldest_first_sched(Op* op) {
     DEBUG(node->proc_id,
           "Scheduler selecting    op_num:%s  fu_id:%d op:%s l1:%d\n",
           unsstr64(op->op_num), fu_id, disasm_op(op, TRUE),
-          op->engine_info.l1_miss);
+          OP_ENGINE(op).l1_miss);
     ASSERT(node->proc_id, fu_id < node->sd.max_op_count);
     op->fu_num                 = fu_id;
     node->sd.ops[op->fu_num]   = op;
@@ -671,7 +700,7 @@ void node_sched_ops() {
   // Check to see if the L1 Q is (still) full
   check_if_mem_blocked();
 
-  for(op = node->rdy_head; op; op = op->next_rdy) {
+  for(op = node_rdy_first(); op; op = node_rdy_next(op)) {
     ASSERT(node->proc_id, node->proc_id == op->proc_id);
     ASSERTM(node->proc_id, op->in_rdy_list, "op_num %llu\n", op->op_num);
     if(op->state == OS_WAIT_MEM) {
@@ -680,6 +709,13 @@ void node_sched_ops() {
       else
         op->state = OS_READY;
     }
+    /* Ops are examined oldest first, so once every FU has an op, younger
+       ops cannot take a slot. Keep walking only to wake up WAIT_MEM ops. */
+    if(node->sd.op_count == node->sd.max_op_count) {
+      if(node->mem_blocked)
+        break;
+      continue;
+    }
     if(op->state == OS_TENTATIVE || op->state == OS_WAIT_DCACHE)
       continue;
     ASSERTM(node->proc_id,
@@ -690,7 +726,7 @@ void node_sched_ops() {
     DEBUG(node->proc_id,
           "Scheduler examining    op_num:%s op:%s l1:%d st:%s rdy:%s exec:%s "
           "done:%s\n",
-          unsstr64(op->op_num), disasm_op(op, TRUE), op->engine_info.l1_miss,
+          unsstr64(op->op_num), disasm_op(op, TRUE), OP_ENGINE(op).l1_miss,
           Op_State_str(op->state), unsstr64(op->rdy_cycle),
           unsstr64(op->exec_cycle), unsstr64(op->done_cycle));
 
@@ -699,7 +735,7 @@ void node_sched_ops() {
     if(cycle_count >= op->rdy_cycle - 1) {
       ASSERT(node->proc_id, op->srcs_not_rdy_vector == 0x0);
       DEBUG(node->proc_id, "Scheduler considering  op_num:%s op:%s l1:%d\n",
-            unsstr64(op->op_num), disasm_op(op, TRUE), op->engine_info.l1_miss);
+            unsstr64(op->op_num), disasm_op(op, TRUE), OP_ENGINE(op).l1_miss);
 
       // Put your own scheduling algorithm here
       if(OLDEST_FIRST_SCHED) {
@@ -945,11 +981,9 @@ void node_fill_rs() {
     if(op->srcs_not_rdy_vector == 0) {
       /* op is ready to issue right now */
       DEBUG(node->proc_id, "Adding to ready list  op_num:%s op:%s l1:%d\n",
-            unsstr64(op->op_num), disasm_op(op, TRUE), op->engine_info.l1_miss);
+            unsstr64(op->op_num), disasm_op(op, TRUE), OP_ENGINE(op).l1_miss);
       op->state = (cycle_count + 1 >= op->rdy_cycle ? OS_READY : OS_WAIT_FWD);
-      op->next_rdy    = node->rdy_head;
-      node->rdy_head  = op;
-      op->in_rdy_list = TRUE;
+      node_rdy_insert(op);
     }
 
     // This is the max number of ops we can fill into the RS per cycle.
@@ -970,18 +1004,14 @@ void node_handle_scheduled_ops() {
   /* this traversal could be made more efficient since we know what
      ops we tried to schedule last cycle, but for now let's look at
      the whole ready list */
-  Op** last = &node->rdy_head;
-  for(Op* op = node->rdy_head; op; op = op->next_rdy) {
+  for(Op* op = node_rdy_first(); op; op = node_rdy_next(op)) {
     if(op->state == OS_SCHEDULED || op->state == OS_MISS) {
       DEBUG(node->proc_id,
             "Removing from RS (and ready list)  op_num:%s op:%s l1:%d\n",
-            unsstr64(op->op_num), disasm_op(op, TRUE), op->engine_info.l1_miss);
-      *last           = op->next_rdy;
-      op->in_rdy_list = FALSE;
+            unsstr64(op->op_num), disasm_op(op, TRUE), OP_ENGINE(op).l1_miss);
+      node_rdy_remove(op);
       ASSERT(node->proc_id, node->rs[op->rs_id].rs_op_count > 0);
       node->rs[op->rs_id].rs_op_count--;
-    } else {
-      last = &op->next_rdy;
     }
   }
 }
@@ -992,10 +1022,64 @@ void node_handle_scheduled_ops() {
 
 Flag is_node_stage_stalled() {
   return (node->node_count == NODE_TABLE_SIZE) && /* node table is full */
-         !node->rdy_head &&                       /* no ready ops */
+         !node->rdy_count &&                      /* no ready ops */
          !node->next_op_into_rs; /* no ops waiting to enter RS */
 }
 
+/**************************************************************************************/
+/* node_next_event_cycle: returns the earliest cycle at which the node stage
+ * can make progress on its own, or cycle_count + 1 if it may make progress
+ * right away.  Ops waiting on a cache miss are woken up by the fill, which
+ * the memory system reports separately. */
+
+Counter node_next_event_cycle() {
+  Counter next = MAX_CTR;
+
+  if(node->rdy_count || node->sd.op_count)
+    return cycle_count + 1;
+  if(node->next_op_into_rs && find_emptiest_rs(node->next_op_into_rs) != -1)
+    return cycle_count + 1;
+  if(node->node_head && !op_not_ready_for_retire(node->node_head))
+    return cycle_count + 1;
+
+  for(Op* op = node->node_head; op; op = op->next_node) {
+    switch(op->state) {
+      case OS_ISSUED:
+      case OS_MISS:
+      case OS_WAIT_MEM:
+        break;
+      case OS_IN_RS:
+        if(!op->srcs_not_rdy_vector)
+          return cycle_count + 1;
+        break;
+      case OS_SCHEDULED:
+      case OS_DONE:
+        /* results are broadcast one cycle before the op is done */
+        if(op->done_cycle != MAX_CTR && op->done_cycle > cycle_count + 1)
+          next = MIN2(next, op->done_cycle - 1);
+        else if(!OP_DONE(op))
+          return cycle_count + 1;
+        break;
+      default:
+        return cycle_count + 1;
+    }
+  }
+
+  return next;
+}
+
+/**************************************************************************************/
+/* node_skip_cycle: accounts for cycles in which the node stage was not
+ * simulated because it could not make progress (see node_next_event_cycle).
+ * Only the state that update_node_stage would have changed is advanced; stats
+ * are credited by the caller. */
+
+void node_skip_cycle(Counter cycles) {
+  if(node->node_head)
+    node->ret_stall_length += cycles;
+  node->mem_block_length += node->mem_blocked * cycles;
+}
+
 void debug_print_retired_uop(Op* op) {
   PRINT_RETIRED_UOP(node->proc_id, "============================\n");
   PRINT_RETIRED_UOP(node->proc_id, "EIP: 0x%llx\n", op->inst_info->addr);
@@ -1045,13 +1129,13 @@ void collect_not_ready_to_retire_stats(Op* op) {
     rob_stall_reason = ROB_STALL_WAIT_FOR_REDIRECT;
   }
 
-  if(op->engine_info.l1_miss) {
+  if(OP_ENGINE(op).l1_miss) {
     rob_stall_reason = ROB_STALL_WAIT_FOR_L1_MISS;
     STAT_EVENT(op->proc_id, RET_BLOCKED_L1_MISS);
-    Flag bw_prefetch = !op->engine_info.l1_miss_satisfied &&  // op->req is OK
+    Flag bw_prefetch = !OP_ENGINE(op).l1_miss_satisfied &&  // op->req is OK
                                                               // to use
                        op->req->demand_match_prefetch && op->req->bw_prefetch;
-    Flag bw_prefetchable = !op->engine_info.l1_miss_satisfied &&  // op->req is
+    Flag bw_prefetchable = !OP_ENGINE(op).l1_miss_satisfied &&  // op->req is
                                                                   // OK to use
                            !op->req->demand_match_prefetch &&
                            op->req->bw_prefetchable;
@@ -1059,7 +1143,7 @@ void collect_not_ready_to_retire_stats(Op* op) {
       STAT_EVENT(op->proc_id, RET_BLOCKED_L1_MISS_BW_PREF);
   }
 
-  if(op->engine_info.l1_miss || op->state == OS_WAIT_MEM) {
+  if(OP_ENGINE(op).l1_miss || op->state == OS_WAIT_MEM) {
     rob_stall_reason = ROB_STALL_WAIT_FOR_MEMORY;
     STAT_EVENT(op->proc_id, RET_BLOCKED_MEM_STALL);
     if(num_offchip_stall_reqs(op->proc_id) > 0) {
@@ -1067,10 +1151,10 @@ void collect_not_ready_to_retire_stats(Op* op) {
     }
   }
 
-  if(op->engine_info.dcmiss) {
+  if(OP_ENGINE(op).dcmiss) {
     rob_stall_reason = ROB_STALL_WAIT_FOR_DC_MISS;
     STAT_EVENT(op->proc_id, RET_BLOCKED_DC_MISS);
-    if(!op->engine_info.l1_miss)
+    if(!OP_ENGINE(op).l1_miss)
       STAT_EVENT(op->proc_id, RET_BLOCKED_L1_ACCESS);
   }
 
@@ -30,6 +30,7 @@
 #define __NODE_STAGE_H__
 
 #include "exec_stage.h"
+#include "globals/global_defs.h"
 #include "stage_data.h"
 
 
@@ -55,9 +56,13 @@ typedef struct Node_Stage_struct {
   Op*   node_tail;   // linked-list of ops in the node stage
   int32 node_count;  // number of ops in the node table
 
-  Op* rdy_head;  // linked-list of ops that are ready to schedule. Ops
-                 // are put in here when they are issued, or after they
-                 // are issued and another op wakes them up.
+  // Ready list: ops that are ready to schedule. Ops are put in here when they
+  // are issued, or after they are issued and another op wakes them up. Ops in
+  // the node table have consecutive op numbers, so each one owns the slot
+  // op_num % NODE_TABLE_SIZE and the list is kept in age order by a bitmap.
+  Op**   rdy_ops;     // ready op in each node table slot (NULL if none)
+  uns64* rdy_bitmap;  // one bit per rdy_ops slot
+  uns    rdy_count;   // number of ops in the ready list
 
   Counter ret_op;  // next op number to retire
 
@@ -76,7 +81,7 @@ typedef struct Node_Stage_struct {
 /**************************************************************************************/
 // External Variables
 
-extern Node_Stage* node;
+extern SIM_THREAD_LOCAL Node_Stage* node;
 
 
 /**************************************************************************************/
@@ -90,6 +95,13 @@ void recover_node_stage(void);
 void debug_node_stage(void);
 void update_node_stage(Stage_Data*);
 Flag is_node_stage_stalled(void);
+Counter node_next_event_cycle(void);
+void    node_skip_cycle(Counter cycles);
+
+void node_rdy_insert(Op*);
+void node_rdy_remove(Op*);
+Op*  node_rdy_first(void);
+Op*  node_rdy_next(Op*);
 
 void  node_sched_ops(void);
 void  node_handle_scheduled_ops(void);
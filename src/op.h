@@ -44,6 +44,9 @@
   ((x)->srcs_not_rdy_vector == 0 && cycle_count >= (x)->rdy_cycle)
 #define OP_DONE(x) (cycle_count >= (x)->done_cycle)
 #define OP_BROADCAST(x) ((cycle_count + 1) >= (x)->done_cycle)
+/* the oracle and engine Op_Infos live in the op's Op_Cold */
+#define OP_ORACLE(x) ((x)->cold->oracle_info)
+#define OP_ENGINE(x) ((x)->cold->engine_info)
 #define MULTI_CYCLE_OP(x)                       \
   ((x)->inst_info->latency > 1 + RFILE_STAGE || \
    (x)->table_info->mem_type == MEM_LD)
@@ -146,9 +149,26 @@ typedef struct Dp_Info_struct {
 // }}}
 
 
+/**************************************************************************************/
+// {{{ Op_Cold
+// Bulky per-op data that the scheduling, wake up and retirement loops never
+// touch. Each op points to its own Op_Cold, allocated by the op pool in an
+// array parallel to the ops themselves.
+
+typedef struct Op_Cold_struct {
+  Op_Info oracle_info;  // information about the execution of the op in the
+                        // oracle
+  Op_Info engine_info;  // information about the execution of the op in the
+                        // engine
+} Op_Cold;
+// }}}
+
+
 /**************************************************************************************/
 // {{{ Op
 // typedef in globals/global_types.h
+// Fields read every cycle by the node stage and the wake up logic come first
+// so that they share the first cache lines of the struct.
 struct Op_struct {
   // {{{ op_pool stuff --- don't use outside of op pool management
   Flag op_pool_valid;  // is op allocated from the op_pool?
@@ -156,46 +176,71 @@ struct Op_struct {
   uns  op_pool_id;     // unique identifier for op (doesn't change)
   // }}}
 
-  // {{{ op numbers and info pointers
-  uns     proc_id;     // processor id for cmp model
+  // {{{ hot: scheduling, wake up and retirement
+  Op_State state;       // the state of the op in the datapath
+  uns      proc_id;     // processor id for cmp model
+  Counter  op_num;      // op number
+  Counter  unique_num;  // unique number for each instance of an op (not reset
+                        // on recovery)
+  Table_Info* table_info;  // copy of info->table_info to limit pointer chasing
+  Inst_Info* inst_info;  // pointer to unique struct for each static instruction
+
+  uns srcs_not_rdy_vector;  // bits as given by order in the src_info array
+  Counter rdy_cycle;    // cycle when the final source value is available to the
+                        // op (only useful when vector is clear)
+  Counter sched_cycle;  // cycle when the op is scheduled (arrives at the
+                        // functional unit)
+  Counter exec_cycle;   // cycle when execution (or addr gen) of op will be
+                        // completed (result usable)
+  Counter done_cycle;   // cycle when the op is ready to retire
+  Counter issue_cycle;  // cycle an individual instruction is issued -- same as
+                        // chkpt
+
+  uns     fu_num;   // functional unit number the op will or did execute on
+  Counter node_id;  // id for position in the node table
+  Counter rs_id;    // id for which Reservation Station (RS) this op is assigned
+                    // to
+  struct Op_struct* next_node;     // pointer to the next op in the node table
+  Flag              in_rdy_list;   // is the op in the node stage's ready list?
+  Flag              in_node_list;  // is the op in the node list?
+  Flag              replay;        // is the op waiting to replay?
+  Flag off_path;  // is the op on the correct path of the program? - oracle
+                  // information
+  Flag bom;       // begining of macro instruction when we use op as a uop
+  Flag eom;       // end of macro instruction when we use op as a uop
+  Flag exit;      // is this the last instruction to execute?
+  Flag recovery_scheduled;
+  Flag redirect_scheduled;
+
+  Flag wake_up_signaled[NUM_DEP_TYPES];  // set to true once a wake up has been
+                                         // signaled by the op for the given
+                                         // type
+  Wake_Up_Entry* wake_up_head;  // list of ops that are dependent on this op, by
+                                // dependency type
+  Wake_Up_Entry* wake_up_tail;  // last entry in each wake up list (for speed)
+  uns wake_up_count;   // count of ops to be awakened by this op (wake up list
+                       // length)
+  Counter wake_cycle;  // used by wake up logic for time wake up signal is sent
+
+  Op_Cold* cold;  // oracle_info and engine_info (set by the op pool)
+  // }}}
+
+  // {{{ op numbers
   uns     thread_id;   // id number for the thread to which this op belongs
-  Flag    bom;         // begining of macro instruction when we use op as a uop
-  Flag    eom;         // end of macro instruction when we use op as a uop
   Flag    fetched_instruction;  // is this op fetched or a rep op?
-  Counter op_num;      // op number
-  Counter unique_num;  // unique number for each instance of an op (not reset on
-                       // recovery)
   Counter unique_num_per_proc;  // unique number per core
   uns64   inst_uid;  // unique number for the macro instruction provided
                      // by the frontend (PIN)
-  Counter     addr_pred_num;  // unique number for each address prediction
-  Table_Info* table_info;  // copy of info->table_info to limit pointer chasing
-  Inst_Info* inst_info;  // pointer to unique struct for each static instruction
-  Op_Info    oracle_info;  // information about the execution of the op in the
-                           // oracle
-  Op_Info engine_info;     // information about the execution of the op in the
-                           // engine
   int oracle_cp_num;  // if the op has created an oracle checkpointed this is
                       // not -1
   // }}}
 
-  int32 perceptron_output;       //
   int32 conf_perceptron_output;  // confidece perceptron
-  // {{{ state and event cycle counters
-  Op_State state;        // the state of the op in the datapath
-  Counter  fetch_cycle;  // cycle an individual instruction is fetched
-  Counter  bp_cycle;     // cycle a CF instruction accesses the branch predictor
-  Counter  map_cycle;    // cycle an individual instruction enters the map stage
-  Counter  issue_cycle;  // cycle an individual instruction is issued -- same as
-                         // chkpt
-  Counter rdy_cycle;    // cycle when the final source value is available to the
-                        // op (only useful when vector is clear)
-  Counter sched_cycle;  // cycle when the op is scheduled (arrives at the
-                        // functional unit)
-  Counter exec_cycle;   // cycle when execution (or addr gen) of op will be
-                        // completed (result usable)
+  // {{{ event cycle counters
+  Counter fetch_cycle;   // cycle an individual instruction is fetched
+  Counter bp_cycle;      // cycle a CF instruction accesses the branch predictor
+  Counter map_cycle;     // cycle an individual instruction enters the map stage
   Counter dcache_cycle;  // cycle when the op accesses the dcache
-  Counter done_cycle;    // cycle when the op is ready to retire
   Counter retire_cycle;  // cycle when the op actually retires (useful if you
                          // keep the ops around after they leave the node
                          // talbes)
@@ -206,51 +251,24 @@ struct Op_struct {
   // }}}
 
   // {{{ path and fetch info
-  Flag off_path;    // is the op on the correct path of the program? - oracle
-                    // information
-  Flag exit;        // is this the last instruction to execute?
-  Flag prog_input;  // is this op directly related to an input value of the
-                    // program ?
   uns           cf_within_fetch;  // branch number within a fetch cycle
   Recovery_Info recovery_info;    // information that will be used to recover a
                                   // mispredict by the op
   // }}}
 
   // {{{ scheduler information
-  uns     fu_num;   // functional unit number the op will or did execute on
-  Counter node_id;  // id for position in the node table
-  Counter rs_id;    // id for which Reservation Station (RS) this op is assigned
-                    // to
   Counter chkpt_num;  // id for chkpt (WARNING: this can change due to
                       // recoveries)
 
-  struct Op_struct* next_rdy;      // pointer to next ready op (node table)
-  Flag              in_rdy_list;   // is the op in the node stage's ready list?
-  struct Op_struct* next_node;     // pointer to the next op in the node table
-  Flag              in_node_list;  // is the op in the node list?
-  Flag              replay;        // is the op waiting to replay?
-  uns               replay_count;  // number of times the op has replayed
+  uns  replay_count;        // number of times the op has replayed
   Flag dont_cause_replays;  // true if the op should not cause other ops to
                             // replay (like a correct value prediction)
   uns exec_count;           // how many times has this op been executed?
-  // }}}
-
-  // {{{ dependency information
-  uns  srcs_not_rdy_vector;  // bits as given by order in the src_info array
-  Flag wake_up_signaled[NUM_DEP_TYPES];  // set to true once a wake up has been
-                                         // signaled by the op for the given
-                                         // type
-  Wake_Up_Entry* wake_up_head;  // list of ops that are dependent on this op, by
-                                // dependency type
-  Wake_Up_Entry* wake_up_tail;  // last entry in each wake up list (for speed)
-  uns wake_up_count;   // count of ops to be awakened by this op (wake up list
-                       // length)
-  Counter wake_cycle;  // used by wake up logic for time wake up signal is sent
+  uns delay_bit;            // set when the op is rejected by a busy FU
   // }}}
 
   struct Mem_Req_struct* req;  // pointer to memory request responsible for
                                // waking up the op
-  // }}}
 
   Flag marked;  // for algorithms that mark already seen ops
 
@@ -258,35 +276,7 @@ struct Op_struct {
   // FIELDS BELOW THIS POINT SHOULD BE MOVED INTO OTHER HEADERS
   // (along with any related structs above)
 
-  // {{{ pipelined scheduler specific fields (move these)
-  struct Sched_Info_struct* sched_info;
-  Counter request_cycle;  // first cycle inst can request func unit i.e. is
-                          // awake
-  uns gps_not_rdy;        // vector for determining which gs's aren't ready.
-  uns delay_bit;          // rejected ops in pipelined schedule is delayed
-  uns first;  // op's sources were ready when dispatched => op is first in dep
-              // chain
-  uns src_same_chkpt;  // bookkeeping info: set if any parent is in same chkpt
-  uns parent_load;     // vector for determining which parents are loads
-  Counter same_src_last_op;  // bit vector indicating if any src of last op in
-                             // same slot was the same
-  int dup_fu_num;
-  int dup_cluster;
-  // }}}
-
-  /* predict wait time specific fields */
-
-  // {{{ predict wait time specific fields (move these)
-  uns      trigger_parent;  // parent number from which trigger is received.
-  Counter  pred_wait_time;  // number of cycles the op should wait before waking
-  Counter  reject_count;    // number of times the op has been rejected
-  Src_Info wakeup_trigger;  // op used to trigger wakeup. not necessarily parent
-                            // op.
-  uns trigger_type;         // does op have a valid trigger.
-
-  uns  fetch_lag;  // num cycles since the previous group was issued.
-  Flag dcache_miss;
-  // }}}
+  uns fetch_lag;  // num cycles since the previous group was issued.
 
   struct Mbp7gshare_Info_struct* mbp7_info;  // multiple branch predictor
                                              // information
@@ -296,14 +286,8 @@ struct Op_struct {
 
   // {{{ temporary fields -> will be deleted later (move these)
   int  derived_from_prog_input;  // derivation level from program read()
-  int  min_input_id;
-  int  max_input_id;
   Flag sources_addr_reg;
-  uns  addr_pred_flags;
-  uns  stephan_corr_index;
   Addr pred_addr;
-  Flag recovery_scheduled;
-  Flag redirect_scheduled;
   // }}}
 
   FT_Info ft_info;  // FT the op associated with
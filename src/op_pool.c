@@ -36,8 +36,10 @@ allocates them once and then hands out pointers every time 'alloc_op' is called.
 #include "globals/utils.h"
 
 #include "debug/pipeview.h"
+#include "libs/arena_lib.h"
 #include "model.h"
 #include "op_pool.h"
+#include "statistics.h"
 
 #include "debug/debug.param.h"
 #include "general.param.h"
@@ -60,15 +62,21 @@ allocates them once and then hands out pointers every time 'alloc_op' is called.
 
 // TODO: it should be increased to 512 to use more than 50,000 FDIP lookahead buffer entries
 #define OP_POOL_ENTRIES_INC 128 /* default 128 */
+#define FAKE_INST_ARENA_BLOCK (64 * 1024)
 
 /**************************************************************************************/
 /* Global variables */
 
-uns        op_pool_entries    = 0;
-uns        op_pool_active_ops = 0;
-static Op* op_pool_free_head;
+SIM_THREAD_LOCAL uns        op_pool_entries    = 0;
+SIM_THREAD_LOCAL uns        op_pool_active_ops = 0;
+static SIM_THREAD_LOCAL Op* op_pool_free_head;
 
-Op invalid_op;
+Op             invalid_op;
+static Op_Cold invalid_op_cold;
+
+/* Inst_Infos of fake (wrong path) instructions live only as long as their op,
+   so each core carves them out of its own arena */
+static Arena* fake_inst_arenas;
 
 
 /**************************************************************************************/
@@ -85,11 +93,17 @@ void init_op_pool() {
   DEBUGU(0, "Initializing op pool...\n");
 
   /* set up invalid op (for use as default value various places) */
+  invalid_op.cold = &invalid_op_cold;
   op_pool_init_op(&invalid_op);
   invalid_op.op_pool_valid = FALSE;
   invalid_op.op_num        = 0;
   invalid_op.unique_num    = 0;
 
+  fake_inst_arenas = (Arena*)malloc(sizeof(Arena) * NUM_CORES);
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    init_arena(&fake_inst_arenas[proc_id], "fake inst info",
+               FAKE_INST_ARENA_BLOCK);
+
   /* clear counters */
   reset_op_pool();
 
@@ -116,6 +130,7 @@ Op* alloc_op(uns proc_id) {
 
   if(op_pool_free_head == NULL) {
     ASSERT(0, op_pool_active_ops == op_pool_entries);
+    STAT_EVENT(proc_id, OP_POOL_EXPAND);
     expand_op_pool();
   }
 
@@ -151,9 +166,6 @@ void free_op(Op* op) {
   DEBUG(0, "Freed op  id:%u  op_pool_active_ops: %u\n", op->op_pool_id,
         op_pool_active_ops);
 
-  if(op->sched_info)
-    free(op->sched_info);
-
   if(op->table_info->mem_type == MEM_ST)
     delete_store_hash_entry(op);
 
@@ -161,7 +173,9 @@ void free_op(Op* op) {
     ASSERT(0, op->table_info == op->inst_info->table_info);
     //we no longer allocate memory for fake nops
     //free(op->inst_info->table_info);
-    free(op->inst_info);
+    arena_free(&fake_inst_arenas[op->proc_id], op->inst_info,
+               sizeof(Inst_Info));
+    STAT_EVENT(op->proc_id, FAKE_INST_INFO_FREE);
     op->inst_info = NULL;
   }
 
@@ -171,14 +185,42 @@ void free_op(Op* op) {
 }
 
 
+/**************************************************************************************/
+/* alloc_fake_inst_info: returns a zeroed Inst_Info for a fake instruction; it
+   is released by free_op() together with the op that carries it */
+
+Inst_Info* alloc_fake_inst_info(uns proc_id) {
+  Arena*     arena  = &fake_inst_arenas[proc_id];
+  Counter    blocks = arena->num_block_mallocs;
+  Inst_Info* info   = (Inst_Info*)arena_alloc(arena, sizeof(Inst_Info));
+
+  memset(info, 0, sizeof(Inst_Info));
+  STAT_EVENT(proc_id, FAKE_INST_INFO_ALLOC);
+  if(arena->num_block_mallocs != blocks)
+    STAT_EVENT(proc_id, FAKE_INST_ARENA_MALLOC);
+  return info;
+}
+
+
+/**************************************************************************************/
+/* recover_op_pool: called after a pipeline flush. If the flush took every
+   fake instruction of the core with it, the core's arena starts over from its
+   first block, so wrong paths keep reusing the same few (cache-warm) blocks. */
+
+void recover_op_pool(uns proc_id) {
+  if(arena_reset(&fake_inst_arenas[proc_id]))
+    STAT_EVENT(proc_id, FAKE_INST_ARENA_RESET);
+}
+
+
 /**************************************************************************************/
 /* op_pool_init_op: this function is called only once per op
    struct---when it is first allocated.  Intialization put in here
    should be for things that never change. */
 
 void op_pool_init_op(Op* op) {
-  op->oracle_info.mispred  = FALSE;
-  op->oracle_info.misfetch = FALSE;
+  OP_ORACLE(op).mispred  = FALSE;
+  OP_ORACLE(op).misfetch = FALSE;
 }
 
 
@@ -196,7 +238,6 @@ void op_pool_setup_op(uns proc_id, Op* op) {
   op->srcs_not_rdy_vector     = 0x0;
   op->derived_from_prog_input = 0;
   op->sources_addr_reg        = 0;
-  op->sched_info              = NULL;
   op->marked                  = FALSE;
 
   op->op_num              = op_count[proc_id];
@@ -227,28 +268,27 @@ void op_pool_setup_op(uns proc_id, Op* op) {
   op->req = NULL;
 
   /* pipelined scheduler fields */
-  op->chkpt_num        = MAX_CTR;
-  op->node_id          = MAX_CTR;
-  op->rs_id            = MAX_CTR;
-  op->same_src_last_op = 0;
-
-  op->oracle_info.num_srcs          = 0;
-  op->oracle_info.update_fpcr       = FALSE;
-  op->oracle_info.error_event       = 0;
-  op->oracle_info.mispred           = FALSE;
-  op->oracle_info.misfetch          = FALSE;
-  op->oracle_info.recovery_sch      = FALSE;
-  op->oracle_info.recover_at_decode = FALSE;
-  op->oracle_info.recover_at_exec   = FALSE;
-
-  op->oracle_cp_num                  = -1;
-  op->engine_info.dcmiss             = FALSE;
-  op->engine_info.l1_miss            = FALSE;
-  op->engine_info.l1_miss_satisfied  = FALSE;
-  op->engine_info.dep_on_l1_miss     = FALSE;
-  op->engine_info.was_dep_on_l1_miss = FALSE;
-  op->engine_info.num_srcs           = 0;
-  op->engine_info.update_fpcr        = FALSE;
+  op->chkpt_num = MAX_CTR;
+  op->node_id   = MAX_CTR;
+  op->rs_id     = MAX_CTR;
+
+  OP_ORACLE(op).num_srcs          = 0;
+  OP_ORACLE(op).update_fpcr       = FALSE;
+  OP_ORACLE(op).error_event       = 0;
+  OP_ORACLE(op).mispred           = FALSE;
+  OP_ORACLE(op).misfetch          = FALSE;
+  OP_ORACLE(op).recovery_sch      = FALSE;
+  OP_ORACLE(op).recover_at_decode = FALSE;
+  OP_ORACLE(op).recover_at_exec   = FALSE;
+
+  op->oracle_cp_num                = -1;
+  OP_ENGINE(op).dcmiss             = FALSE;
+  OP_ENGINE(op).l1_miss            = FALSE;
+  OP_ENGINE(op).l1_miss_satisfied  = FALSE;
+  OP_ENGINE(op).dep_on_l1_miss     = FALSE;
+  OP_ENGINE(op).was_dep_on_l1_miss = FALSE;
+  OP_ENGINE(op).num_srcs           = 0;
+  OP_ENGINE(op).update_fpcr        = FALSE;
 
   op->recovery_scheduled = FALSE;
   op->redirect_scheduled = FALSE;
@@ -263,11 +303,14 @@ void op_pool_setup_op(uns proc_id, Op* op) {
 
 
 /**************************************************************************************/
-/* expand_op_pool: */
+/* expand_op_pool: ops and their cold halves are allocated as two parallel
+   slabs, so the ops of a slab are packed together and the scheduler does not
+   drag the oracle/engine info through the host caches. */
 
 static inline void expand_op_pool() {
-  Op* new_pool = (Op*)calloc(OP_POOL_ENTRIES_INC, sizeof(Op));
-  uns ii;
+  Op*      new_pool = (Op*)calloc(OP_POOL_ENTRIES_INC, sizeof(Op));
+  Op_Cold* new_cold = (Op_Cold*)calloc(OP_POOL_ENTRIES_INC, sizeof(Op_Cold));
+  uns      ii;
 
   DEBUGU(0, "Expanding op pool to size %d\n",
          op_pool_entries + OP_POOL_ENTRIES_INC);
@@ -275,11 +318,13 @@ static inline void expand_op_pool() {
     new_pool[ii].op_pool_valid = FALSE;
     new_pool[ii].op_pool_next  = &new_pool[ii + 1];
     new_pool[ii].op_pool_id    = op_pool_entries++;
+    new_pool[ii].cold          = &new_cold[ii];
     op_pool_init_op(&new_pool[ii]);
   }
   new_pool[ii].op_pool_valid = FALSE;
   new_pool[ii].op_pool_next  = op_pool_free_head;
   new_pool[ii].op_pool_id    = op_pool_entries++;
+  new_pool[ii].cold          = &new_cold[ii];
   op_pool_init_op(&new_pool[ii]);
 
   op_pool_free_head = &new_pool[0];
@@ -37,8 +37,8 @@ extern "C" {
 /* Global Variables */
 
 extern Op  invalid_op;
-extern uns op_pool_entries;
-extern uns op_pool_active_ops;
+extern SIM_THREAD_LOCAL uns op_pool_entries;
+extern SIM_THREAD_LOCAL uns op_pool_active_ops;
 
 
 /**************************************************************************************/
@@ -51,6 +51,9 @@ void free_op(Op*);
 void op_pool_init_op(Op*);
 void op_pool_setup_op(uns proc_id, Op* op);
 
+Inst_Info* alloc_fake_inst_info(uns proc_id);
+void       recover_op_pool(uns proc_id);
+
 /**************************************************************************************/
 
 #ifdef __cplusplus
@@ -62,6 +62,11 @@ KNOB<string> KnobSocketPath(KNOB_MODE_WRITEONCE, "pintool", "socket_path",
 KNOB<UINT32> KnobCoreId(KNOB_MODE_WRITEONCE, "pintool", "core_id", "0",
                         "The ID of the Scarab core to connect to");
 
+KNOB<bool> KnobShmRing(
+  KNOB_MODE_WRITEONCE, "pintool", "shm_ring", "0",
+  "exchange ops and commands with Scarab through a shared-memory ring "
+  "(Scarab must run with --pin_exec_driven_fe_shm_ring 1)");
+
 KNOB<UINT32> KnobMaxBufferSize(
   KNOB_MODE_WRITEONCE, "pintool", "max_buffer_size", "8",
   "pintool buffers up to (max_buffer_size-2) instructions for sending");
@@ -257,6 +262,8 @@ void Fini(INT32 code, void* v) {
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "Fini reached, app exit code=%d\n.", code);
   *out << "End of program reached, disconnect from Scarab.\n" << endl;
+  if(scarab_ring)
+    scarab_ring->close();
   scarab->disconnect();
   *out << "Pintool Fini Reached.\n" << endl;
 }
@@ -325,6 +332,15 @@ int main(int argc, char* argv[]) {
   PIN_AddFiniFunction(Fini, 0);
 
   scarab = new Client(KnobSocketPath, KnobCoreId);
+  if(KnobShmRing.Value()) {
+    // Scarab sends the ring size once it has created the ring
+    uint32_t op_slots = scarab->receive<uint32_t>();
+    scarab_ring       = new ShmRing();
+    scarab_ring->attach(shm_ring_path(KnobSocketPath, KnobCoreId));
+    assertm(op_slots == scarab_ring->get_op_slots() &&
+              max_buffer_size <= op_slots,
+            "Scarab shared-memory ring is smaller than max_buffer_size");
+  }
 
   // Start the program, never returns
   PIN_StartProgram();
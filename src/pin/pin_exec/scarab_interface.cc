@@ -26,7 +26,10 @@ Scarab_To_Pin_Msg get_scarab_cmd() {
 
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "START: Receiving from Scarab\n");
-  cmd = scarab->receive<Scarab_To_Pin_Msg>();
+  if(scarab_ring)
+    cmd = scarab_ring->receive_cmd();
+  else
+    cmd = scarab->receive<Scarab_To_Pin_Msg>();
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "END: %d Received from Scarab\n", cmd.type);
 
@@ -34,17 +37,26 @@ Scarab_To_Pin_Msg get_scarab_cmd() {
 }
 
 void insert_scarab_op_in_buffer(compressed_op& cop) {
-  scarab_op_buffer.push_back(cop);
+  if(scarab_ring)
+    scarab_ring->stage_op(cop);
+  else
+    scarab_op_buffer.push_back(cop);
 }
 
 bool scarab_buffer_full() {
-  return scarab_op_buffer.size() > (max_buffer_size - 2);
+  size_t size = scarab_ring ? scarab_ring->num_staged_ops() :
+                              scarab_op_buffer.size();
+  return size > (max_buffer_size - 2);
   // Two spots are always reserved in the buffer just in case the
   // exit syscall and sentinel nullop are
   // the last two elements of a packet sent to Scarab.
 }
 
 void scarab_send_buffer() {
+  if(scarab_ring) {
+    scarab_ring->publish_ops();
+    return;
+  }
   Message<ScarabOpBuffer_type> message = scarab_op_buffer;
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "START: Sending message to Scarab.\n");
@@ -56,5 +68,7 @@ void scarab_send_buffer() {
 
 void scarab_clear_all_buffers() {
   scarab_op_buffer.clear();
+  if(scarab_ring)
+    scarab_ring->discard_staged_ops();
   op_mailbox_full = false;
 }
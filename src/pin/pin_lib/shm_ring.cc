@@ -0,0 +1,279 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pin/pin_lib/shm_ring.cc
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Shared-memory transport between Scarab and the exec-driven
+ *                pintool.
+ ***************************************************************************************/
+
+#include "shm_ring.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHM_RING_MAGIC 0x53524e47u /* "SRNG" */
+#define SHM_RING_LINE_SIZE 64
+#define SHM_RING_SPIN_ITERS 4096
+#define SHM_RING_WAIT_NS 100000000 /* recheck the peer every 100ms */
+#define SHM_RING_ATTACH_TRIES 1000
+
+/* One direction of the region.  Each side only writes its own index, and the
+   two indices live on separate cache lines so they do not false-share. */
+struct alignas(SHM_RING_LINE_SIZE) ShmRingIndex {
+  uint32_t value;
+};
+
+struct ShmRingChannel {
+  ShmRingIndex head;     // written by the consumer
+  ShmRingIndex tail;     // written by the producer
+  ShmRingIndex seq;      // futex word, bumped on every publish
+  ShmRingIndex waiters;  // consumers sleeping on seq
+};
+
+struct ShmRingHeader {
+  alignas(SHM_RING_LINE_SIZE) uint32_t magic;
+  uint32_t       op_slots;
+  uint32_t       cmd_slots;
+  uint32_t       closed;
+  ShmRingChannel cmd;
+  ShmRingChannel op;
+};
+
+static void shm_ring_fatal(const std::string& path, const char* msg) {
+  fprintf(stderr, "Shared-memory ring %s: %s (%s)\n", path.c_str(), msg,
+          errno ? strerror(errno) : "");
+  exit(1);
+}
+
+static uint32_t load_acquire(const ShmRingIndex& idx) {
+  return __atomic_load_n(&idx.value, __ATOMIC_ACQUIRE);
+}
+
+static void store_release(ShmRingIndex& idx, uint32_t value) {
+  __atomic_store_n(&idx.value, value, __ATOMIC_RELEASE);
+}
+
+static size_t shm_ring_region_size(uint32_t op_slots) {
+  return sizeof(ShmRingHeader) +
+         SHM_RING_CMD_SLOTS * sizeof(Scarab_To_Pin_Msg) +
+         (size_t)op_slots * sizeof(compressed_op);
+}
+
+/* Publishes the new tail of a channel and wakes its consumer if it sleeps */
+static void shm_ring_publish(ShmRingChannel& ch, uint32_t tail) {
+  store_release(ch.tail, tail);
+  __atomic_add_fetch(&ch.seq.value, 1, __ATOMIC_SEQ_CST);
+  if(__atomic_load_n(&ch.waiters.value, __ATOMIC_SEQ_CST))
+    syscall(SYS_futex, &ch.seq.value, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+/* Blocks until ready() holds.  The consumer announces itself in waiters
+   before its last check, so a publish either is seen by that check or sees
+   the waiter and wakes it. */
+template <typename Ready>
+static void shm_ring_wait(ShmRingHeader* header, ShmRingChannel& ch,
+                          const std::string& path, Ready ready) {
+  for(uint32_t ii = 0; ii < SHM_RING_SPIN_ITERS; ii++) {
+    if(ready())
+      return;
+    sched_yield();
+  }
+  while(true) {
+    uint32_t seq = __atomic_load_n(&ch.seq.value, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&ch.waiters.value, 1, __ATOMIC_SEQ_CST);
+    if(ready()) {
+      __atomic_sub_fetch(&ch.waiters.value, 1, __ATOMIC_SEQ_CST);
+      return;
+    }
+    struct timespec timeout = {0, SHM_RING_WAIT_NS};
+    syscall(SYS_futex, &ch.seq.value, FUTEX_WAIT, seq, &timeout, NULL, 0);
+    __atomic_sub_fetch(&ch.waiters.value, 1, __ATOMIC_SEQ_CST);
+    if(ready())
+      return;
+    if(__atomic_load_n(&header->closed, __ATOMIC_ACQUIRE))
+      shm_ring_fatal(path, "peer closed the ring");
+  }
+}
+
+std::string shm_ring_path(const std::string& socket_path, uint32_t core_id) {
+  return socket_path + ".ring." + std::to_string(core_id);
+}
+
+ShmRing::ShmRing() :
+    header(NULL), cmds(NULL), ops(NULL), region_size(0), op_slots(0),
+    staged(0), owner(false) {}
+
+ShmRing::~ShmRing() {
+  close();
+}
+
+void ShmRing::map(int fd, size_t size) {
+  void* region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if(region == MAP_FAILED)
+    shm_ring_fatal(path, "mmap failed");
+  ::close(fd);
+  region_size = size;
+  header      = (ShmRingHeader*)region;
+  cmds = (Scarab_To_Pin_Msg*)((char*)region + sizeof(ShmRingHeader));
+  ops  = (compressed_op*)(cmds + SHM_RING_CMD_SLOTS);
+}
+
+void ShmRing::create(const std::string& ring_path, uint32_t slots) {
+  path = ring_path;
+  if(slots == 0 || (slots & (slots - 1)))
+    shm_ring_fatal(path, "the number of op slots must be a power of two");
+  unlink(path.c_str());
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if(fd < 0)
+    shm_ring_fatal(path, "cannot create the ring file");
+  size_t size = shm_ring_region_size(slots);
+  if(ftruncate(fd, size))
+    shm_ring_fatal(path, "cannot size the ring file");
+  map(fd, size);
+  owner             = true;
+  op_slots          = slots;
+  header->op_slots  = slots;
+  header->cmd_slots = SHM_RING_CMD_SLOTS;
+  __atomic_store_n(&header->magic, SHM_RING_MAGIC, __ATOMIC_RELEASE);
+}
+
+void ShmRing::attach(const std::string& ring_path) {
+  path   = ring_path;
+  int fd = open(path.c_str(), O_RDWR);
+  if(fd < 0)
+    shm_ring_fatal(path, "cannot open the ring file");
+  struct stat st;
+  if(fstat(fd, &st) || (size_t)st.st_size < sizeof(ShmRingHeader))
+    shm_ring_fatal(path, "ring file is truncated");
+  map(fd, st.st_size);
+  for(uint32_t ii = 0; __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) !=
+                       SHM_RING_MAGIC;
+      ii++) {
+    if(ii == SHM_RING_ATTACH_TRIES)
+      shm_ring_fatal(path, "ring was never initialized");
+    usleep(1000);
+  }
+  op_slots = header->op_slots;
+  if(header->cmd_slots != SHM_RING_CMD_SLOTS ||
+     shm_ring_region_size(op_slots) != region_size)
+    shm_ring_fatal(path, "ring layout does not match this build");
+}
+
+void ShmRing::close() {
+  if(!header)
+    return;
+  __atomic_store_n(&header->closed, 1, __ATOMIC_RELEASE);
+  syscall(SYS_futex, &header->cmd.seq.value, FUTEX_WAKE, INT32_MAX, NULL,
+          NULL, 0);
+  syscall(SYS_futex, &header->op.seq.value, FUTEX_WAKE, INT32_MAX, NULL, NULL,
+          0);
+  munmap(header, region_size);
+  if(owner)
+    unlink(path.c_str());
+  header = NULL;
+  cmds   = NULL;
+  ops    = NULL;
+}
+
+/**************************************************************************************/
+/* Command ring */
+
+void ShmRing::send_cmd(const Scarab_To_Pin_Msg& msg) {
+  ShmRingChannel& ch   = header->cmd;
+  uint32_t        tail = ch.tail.value;
+  /* Scarab waits for the reply to every fetch, so the pintool never falls a
+     full ring behind; spin just in case it does. */
+  while(tail - load_acquire(ch.head) == SHM_RING_CMD_SLOTS)
+    sched_yield();
+  cmds[tail % SHM_RING_CMD_SLOTS] = msg;
+  shm_ring_publish(ch, tail + 1);
+}
+
+Scarab_To_Pin_Msg ShmRing::receive_cmd() {
+  ShmRingChannel& ch   = header->cmd;
+  uint32_t          head = ch.head.value;
+  shm_ring_wait(header, ch, path, [&] { return load_acquire(ch.tail) != head; });
+  Scarab_To_Pin_Msg msg  = cmds[head % SHM_RING_CMD_SLOTS];
+  store_release(ch.head, head + 1);
+  return msg;
+}
+
+/**************************************************************************************/
+/* Op ring */
+
+void ShmRing::stage_op(const compressed_op& op) {
+  ShmRingChannel& ch   = header->op;
+  uint32_t        tail = ch.tail.value + staged;
+  /* Scarab may still be consuming the previous batch; it drains it without
+     waiting on the pintool. */
+  while(tail - load_acquire(ch.head) >= op_slots) {
+    if(__atomic_load_n(&header->closed, __ATOMIC_ACQUIRE))
+      shm_ring_fatal(path, "peer closed the ring");
+    sched_yield();
+  }
+  ops[tail & (op_slots - 1)] = op;
+  staged++;
+}
+
+void ShmRing::publish_ops() {
+  ShmRingChannel& ch = header->op;
+  shm_ring_publish(ch, ch.tail.value + staged);
+  staged = 0;
+}
+
+uint32_t ShmRing::num_batches() const {
+  return __atomic_load_n(&header->op.seq.value, __ATOMIC_SEQ_CST);
+}
+
+void ShmRing::wait_for_batch(uint32_t prev_batches) {
+  ShmRingChannel& ch = header->op;
+  shm_ring_wait(header, ch, path, [&] {
+    return __atomic_load_n(&ch.seq.value, __ATOMIC_ACQUIRE) != prev_batches;
+  });
+}
+
+uint32_t ShmRing::num_ops() const {
+  return load_acquire(header->op.tail) - header->op.head.value;
+}
+
+compressed_op* ShmRing::front_op() {
+  return &ops[header->op.head.value & (op_slots - 1)];
+}
+
+void ShmRing::pop_op() {
+  store_release(header->op.head, header->op.head.value + 1);
+}
+
+void ShmRing::drop_ops() {
+  store_release(header->op.head, load_acquire(header->op.tail));
+}
@@ -0,0 +1,108 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pin/pin_lib/shm_ring.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Shared-memory transport between Scarab and the exec-driven
+ *                pintool.
+ *
+ * One region per core, created by Scarab and mapped by the pintool, holds
+ *
+ *   header | command ring (Scarab -> Pin) | op ring (Pin -> Scarab)
+ *
+ * Both rings are single-producer/single-consumer with free-running head and
+ * tail indices.  Ops are written by the pintool straight into the ring slots
+ * and read by Scarab in place, so neither side copies them into messages.
+ * The op ring keeps the request/response protocol of the socket transport:
+ * Scarab asks for ops with FE_FETCH_OP and the pintool publishes one batch in
+ * reply, so the published ops always form exactly one batch.
+ *
+ * A consumer that finds its ring empty spins briefly and then sleeps on a
+ * futex in the region; producers only make the wake-up system call when the
+ * consumer is asleep.
+ ***************************************************************************************/
+
+#ifndef __SHM_RING_H__
+#define __SHM_RING_H__
+
+#include <stdint.h>
+#include <string>
+#include "pin_scarab_common_lib.h"
+
+#define SHM_RING_DEFAULT_OP_SLOTS (1 << 10)
+#define SHM_RING_CMD_SLOTS 256
+
+struct ShmRingHeader;
+
+class ShmRing {
+ public:
+  ShmRing();
+  ~ShmRing();
+
+  /* Scarab creates the region (op_slots must be a power of two), the pintool
+     attaches to it. */
+  void create(const std::string& path, uint32_t op_slots);
+  void attach(const std::string& path);
+  /* Unmaps the region and tells the other side that this side is gone. */
+  void close();
+
+  /* Scarab -> Pin */
+  void              send_cmd(const Scarab_To_Pin_Msg& msg);
+  Scarab_To_Pin_Msg receive_cmd();
+
+  /* Pin side of the op ring: ops are staged in place and become visible to
+     Scarab as one batch on publish_ops(). */
+  void     stage_op(const compressed_op& op);
+  uint32_t num_staged_ops() const { return staged; }
+  void     discard_staged_ops() { staged = 0; }
+  void     publish_ops();
+
+  /* Scarab side of the op ring: the ops of the last published batch.  A batch
+     may be empty, so Scarab waits for the batch count to move past the count
+     it saw before asking for ops. */
+  uint32_t       num_batches() const;
+  void           wait_for_batch(uint32_t prev_batches);
+  uint32_t       num_ops() const;
+  compressed_op* front_op();
+  void           pop_op();
+  void           drop_ops();
+
+  uint32_t get_op_slots() const { return op_slots; }
+
+ private:
+  ShmRingHeader*     header;
+  Scarab_To_Pin_Msg* cmds;
+  compressed_op*     ops;
+  size_t             region_size;
+  uint32_t           op_slots;
+  uint32_t           staged;
+  std::string        path;
+  bool               owner;
+
+  void map(int fd, size_t size);
+};
+
+/* Name of the ring region of a core, next to the frontend socket */
+std::string shm_ring_path(const std::string& socket_path, uint32_t core_id);
+
+#endif
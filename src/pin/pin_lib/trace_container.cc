@@ -0,0 +1,408 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pin/pin_lib/trace_container.cc
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Compressed, seekable container for ctype_pin_inst traces.
+ ***************************************************************************************/
+
+#include "pin/pin_lib/trace_container.h"
+#include <algorithm>
+#include <cstdlib>
+#include <zlib.h>
+
+#define TRACE_CONTAINER_VERSION 1
+
+/* Every multi-byte field is stored in host byte order, like the
+   ctype_pin_inst records of the bzip2 traces. */
+struct TraceContainerHeader {
+  char     magic[TRACE_CONTAINER_MAGIC_SIZE];
+  uint32_t version;
+  uint32_t record_size;  // sizeof(ctype_pin_inst) of the writer
+};
+
+struct TraceContainerFooter {
+  uint64_t static_offset;
+  uint64_t static_comp_size;
+  uint64_t num_static_insts;
+  uint64_t index_offset;
+  uint64_t num_blocks;
+  uint64_t num_insts;
+  char     magic[TRACE_CONTAINER_MAGIC_SIZE];
+};
+
+static void trace_container_fatal(const char* path, const char* msg) {
+  fprintf(stderr, "Trace container %s: %s\n", path ? path : "", msg);
+  exit(1);
+}
+
+/**************************************************************************************/
+/* Record encoding */
+
+static inline void put_varint(std::vector<uint8_t>* out, uint64_t value) {
+  while(value >= 0x80) {
+    out->push_back((uint8_t)(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back((uint8_t)value);
+}
+
+static inline void put_svarint(std::vector<uint8_t>* out, int64_t value) {
+  put_varint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static inline uint64_t get_varint(const std::vector<uint8_t>& in,
+                                  size_t*                     pos) {
+  uint64_t value = 0;
+  for(int shift = 0; shift < 64; shift += 7) {
+    if(*pos >= in.size())
+      trace_container_fatal(NULL, "truncated block");
+    uint8_t byte = in[(*pos)++];
+    value |= (uint64_t)(byte & 0x7f) << shift;
+    if(!(byte & 0x80))
+      return value;
+  }
+  trace_container_fatal(NULL, "corrupt block");
+  return 0;
+}
+
+static inline int64_t get_svarint(const std::vector<uint8_t>& in,
+                                  size_t*                     pos) {
+  uint64_t value = get_varint(in, pos);
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/* Copies the static part of pi into st, i.e. pi with every field that is
+   coded in the dynamic stream cleared. */
+static inline void strip_dynamic(const ctype_pin_inst* pi, ctype_pin_inst* st) {
+  memcpy(st, pi, sizeof(ctype_pin_inst));
+  st->inst_uid              = 0;
+  st->instruction_next_addr = 0;
+  st->actually_taken        = 0;
+  memset(st->ld_vaddr, 0, sizeof(st->ld_vaddr));
+  memset(st->st_vaddr, 0, sizeof(st->st_vaddr));
+}
+
+/* The dynamic record of an instruction is
+     varint  static id << 1 | actually_taken
+     svarint inst_uid - (previous inst_uid + 1)
+     svarint instruction_next_addr - (instruction_addr + size)
+     varint  mask of non-zero ld_vaddr slots | mask of st_vaddr slots << 8
+     svarint per non-zero slot: address - last address seen in that slot
+   with all "previous" values starting from zero in each block. */
+static void encode_record(std::vector<uint8_t>* out, uint32_t static_id,
+                          const ctype_pin_inst* pi, ctype_pin_inst* prev) {
+  put_varint(out, ((uint64_t)static_id << 1) | pi->actually_taken);
+  put_svarint(out, (int64_t)(pi->inst_uid - prev->inst_uid - 1));
+  put_svarint(out, (int64_t)(pi->instruction_next_addr -
+                             (pi->instruction_addr + pi->size)));
+  prev->inst_uid = pi->inst_uid;
+
+  uint64_t mask = 0;
+  for(int ii = 0; ii < MAX_LD_NUM; ii++)
+    if(pi->ld_vaddr[ii])
+      mask |= 1ULL << ii;
+  for(int ii = 0; ii < MAX_ST_NUM; ii++)
+    if(pi->st_vaddr[ii])
+      mask |= 1ULL << (MAX_LD_NUM + ii);
+  put_varint(out, mask);
+
+  for(int ii = 0; ii < MAX_LD_NUM; ii++) {
+    if(pi->ld_vaddr[ii]) {
+      put_svarint(out, (int64_t)(pi->ld_vaddr[ii] - prev->ld_vaddr[ii]));
+      prev->ld_vaddr[ii] = pi->ld_vaddr[ii];
+    }
+  }
+  for(int ii = 0; ii < MAX_ST_NUM; ii++) {
+    if(pi->st_vaddr[ii]) {
+      put_svarint(out, (int64_t)(pi->st_vaddr[ii] - prev->st_vaddr[ii]));
+      prev->st_vaddr[ii] = pi->st_vaddr[ii];
+    }
+  }
+}
+
+static void decode_record(const std::vector<uint8_t>&        in, size_t* pos,
+                          const std::vector<ctype_pin_inst>& static_insts,
+                          ctype_pin_inst* pi, ctype_pin_inst* prev) {
+  uint64_t id_taken  = get_varint(in, pos);
+  uint64_t static_id = id_taken >> 1;
+  if(static_id >= static_insts.size())
+    trace_container_fatal(NULL, "static id out of range");
+
+  memcpy(pi, &static_insts[static_id], sizeof(ctype_pin_inst));
+  pi->actually_taken = id_taken & 1;
+  pi->inst_uid       = prev->inst_uid + 1 + (uint64_t)get_svarint(in, pos);
+  pi->instruction_next_addr = pi->instruction_addr + pi->size +
+                              (uint64_t)get_svarint(in, pos);
+  prev->inst_uid = pi->inst_uid;
+
+  uint64_t mask = get_varint(in, pos);
+  for(int ii = 0; ii < MAX_LD_NUM; ii++) {
+    if(mask & (1ULL << ii)) {
+      prev->ld_vaddr[ii] += (uint64_t)get_svarint(in, pos);
+      pi->ld_vaddr[ii] = prev->ld_vaddr[ii];
+    }
+  }
+  for(int ii = 0; ii < MAX_ST_NUM; ii++) {
+    if(mask & (1ULL << (MAX_LD_NUM + ii))) {
+      prev->st_vaddr[ii] += (uint64_t)get_svarint(in, pos);
+      pi->st_vaddr[ii] = prev->st_vaddr[ii];
+    }
+  }
+}
+
+/**************************************************************************************/
+/* trace_container_check_magic */
+
+bool trace_container_check_magic(const char* path) {
+  char  magic[TRACE_CONTAINER_MAGIC_SIZE];
+  FILE* file = fopen(path, "rb");
+  if(!file)
+    return false;
+  bool match = fread(magic, sizeof(magic), 1, file) == 1 &&
+               memcmp(magic, TRACE_CONTAINER_MAGIC, sizeof(magic)) == 0;
+  fclose(file);
+  return match;
+}
+
+/**************************************************************************************/
+/* TraceContainerWriter */
+
+TraceContainerWriter::TraceContainerWriter() :
+    file(NULL), block_insts(0), inst_count(0), block_count(0) {}
+
+TraceContainerWriter::~TraceContainerWriter() {
+  if(file)
+    close();
+}
+
+bool TraceContainerWriter::open(const char* path, uint32_t new_block_insts) {
+  file = fopen(path, "wb");
+  if(!file)
+    return false;
+
+  block_insts = new_block_insts;
+  inst_count  = 0;
+  block_count = 0;
+  static_ids.clear();
+  static_insts.clear();
+  blocks.clear();
+  raw_block.clear();
+  memset(&prev, 0, sizeof(prev));
+
+  TraceContainerHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, TRACE_CONTAINER_MAGIC, TRACE_CONTAINER_MAGIC_SIZE);
+  header.version     = TRACE_CONTAINER_VERSION;
+  header.record_size = sizeof(ctype_pin_inst);
+  return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+void TraceContainerWriter::write(const ctype_pin_inst* pi) {
+  ctype_pin_inst st;
+  strip_dynamic(pi, &st);
+
+  std::string key((const char*)&st, sizeof(st));
+  auto        it = static_ids.find(key);
+  uint32_t    static_id;
+  if(it == static_ids.end()) {
+    static_id = static_insts.size();
+    static_ids.emplace(key, static_id);
+    static_insts.push_back(st);
+  } else {
+    static_id = it->second;
+  }
+
+  encode_record(&raw_block, static_id, pi, &prev);
+  inst_count++;
+  if(++block_count == block_insts)
+    flush_block();
+}
+
+bool TraceContainerWriter::write_compressed(const std::vector<uint8_t>& raw,
+                                            uint32_t* comp_size) {
+  uLongf               size = compressBound(raw.size());
+  std::vector<uint8_t> comp(size);
+  if(compress2(comp.data(), &size, raw.data(), raw.size(),
+               Z_DEFAULT_COMPRESSION) != Z_OK)
+    return false;
+  *comp_size = size;
+  return fwrite(comp.data(), 1, size, file) == size;
+}
+
+void TraceContainerWriter::flush_block() {
+  if(block_count == 0)
+    return;
+
+  TraceContainerBlock block;
+  memset(&block, 0, sizeof(block));
+  block.offset     = ftell(file);
+  block.first_inst = inst_count - block_count;
+  block.raw_size   = raw_block.size();
+  block.num_insts  = block_count;
+  if(!write_compressed(raw_block, &block.comp_size))
+    trace_container_fatal(NULL, "failed to write block");
+  blocks.push_back(block);
+
+  raw_block.clear();
+  block_count = 0;
+  memset(&prev, 0, sizeof(prev));
+}
+
+bool TraceContainerWriter::close() {
+  flush_block();
+
+  TraceContainerFooter footer;
+  memset(&footer, 0, sizeof(footer));
+  footer.static_offset    = ftell(file);
+  footer.num_static_insts = static_insts.size();
+  footer.num_blocks       = blocks.size();
+  footer.num_insts        = inst_count;
+  memcpy(footer.magic, TRACE_CONTAINER_MAGIC, TRACE_CONTAINER_MAGIC_SIZE);
+
+  std::vector<uint8_t> raw((const uint8_t*)static_insts.data(),
+                           (const uint8_t*)static_insts.data() +
+                             static_insts.size() * sizeof(ctype_pin_inst));
+  uint32_t             static_comp_size;
+  bool                 ok = write_compressed(raw, &static_comp_size);
+  footer.static_comp_size = static_comp_size;
+  footer.index_offset     = ftell(file);
+  ok = ok && fwrite(blocks.data(), sizeof(TraceContainerBlock), blocks.size(),
+                    file) == blocks.size();
+  ok = ok && fwrite(&footer, sizeof(footer), 1, file) == 1;
+  ok = (fclose(file) == 0) && ok;
+  file = NULL;
+  return ok;
+}
+
+/**************************************************************************************/
+/* TraceContainerReader */
+
+TraceContainerReader::TraceContainerReader() :
+    file(NULL), total_insts(0), next_block(0), raw_pos(0), block_left(0) {}
+
+TraceContainerReader::~TraceContainerReader() {
+  close();
+}
+
+bool TraceContainerReader::read_compressed(uint64_t offset, uint32_t comp_size,
+                                           uint32_t              raw_size,
+                                           std::vector<uint8_t>* raw) {
+  std::vector<uint8_t> comp(comp_size);
+  if(fseek(file, offset, SEEK_SET) != 0 ||
+     fread(comp.data(), 1, comp_size, file) != comp_size)
+    return false;
+  raw->resize(raw_size);
+  uLongf size = raw_size;
+  return uncompress(raw->data(), &size, comp.data(), comp_size) == Z_OK &&
+         size == raw_size;
+}
+
+bool TraceContainerReader::open(const char* path) {
+  file = fopen(path, "rb");
+  if(!file)
+    return false;
+
+  TraceContainerHeader header;
+  TraceContainerFooter footer;
+  if(fread(&header, sizeof(header), 1, file) != 1 ||
+     memcmp(header.magic, TRACE_CONTAINER_MAGIC, TRACE_CONTAINER_MAGIC_SIZE))
+    trace_container_fatal(path, "not a trace container");
+  if(header.version != TRACE_CONTAINER_VERSION ||
+     header.record_size != sizeof(ctype_pin_inst))
+    trace_container_fatal(path, "written with an incompatible ctype_pin_inst");
+  if(fseek(file, -(long)sizeof(footer), SEEK_END) != 0 ||
+     fread(&footer, sizeof(footer), 1, file) != 1 ||
+     memcmp(footer.magic, TRACE_CONTAINER_MAGIC, TRACE_CONTAINER_MAGIC_SIZE))
+    trace_container_fatal(path, "missing footer (was the writer closed?)");
+
+  std::vector<uint8_t> raw;
+  if(!read_compressed(footer.static_offset, footer.static_comp_size,
+                      footer.num_static_insts * sizeof(ctype_pin_inst), &raw))
+    trace_container_fatal(path, "corrupt static table");
+  static_insts.resize(footer.num_static_insts);
+  memcpy(static_insts.data(), raw.data(), raw.size());
+
+  blocks.resize(footer.num_blocks);
+  if(fseek(file, footer.index_offset, SEEK_SET) != 0 ||
+     fread(blocks.data(), sizeof(TraceContainerBlock), blocks.size(), file) !=
+       blocks.size())
+    trace_container_fatal(path, "corrupt block index");
+
+  total_insts = footer.num_insts;
+  next_block  = 0;
+  block_left  = 0;
+  return true;
+}
+
+bool TraceContainerReader::load_block(size_t block) {
+  const TraceContainerBlock& entry = blocks[block];
+  if(!read_compressed(entry.offset, entry.comp_size, entry.raw_size,
+                      &raw_block))
+    trace_container_fatal(NULL, "corrupt block");
+  next_block = block + 1;
+  raw_pos    = 0;
+  block_left = entry.num_insts;
+  memset(&prev, 0, sizeof(prev));
+  return true;
+}
+
+bool TraceContainerReader::read(ctype_pin_inst* pi) {
+  while(block_left == 0) {
+    if(next_block >= blocks.size())
+      return false;
+    load_block(next_block);
+  }
+  decode_record(raw_block, &raw_pos, static_insts, pi, &prev);
+  block_left--;
+  return true;
+}
+
+bool TraceContainerReader::seek(uint64_t inst_num) {
+  if(inst_num >= total_insts) {
+    next_block = blocks.size();
+    block_left = 0;
+    return false;
+  }
+
+  auto it = std::upper_bound(blocks.begin(), blocks.end(), inst_num,
+                             [](uint64_t n, const TraceContainerBlock& b) {
+                               return n < b.first_inst;
+                             });
+  size_t block = (it - blocks.begin()) - 1;
+  load_block(block);
+
+  ctype_pin_inst skipped;
+  for(uint64_t ii = blocks[block].first_inst; ii < inst_num; ii++)
+    read(&skipped);
+  return true;
+}
+
+void TraceContainerReader::close() {
+  if(file)
+    fclose(file);
+  file = NULL;
+  static_insts.clear();
+  blocks.clear();
+  raw_block.clear();
+}
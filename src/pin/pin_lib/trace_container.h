@@ -0,0 +1,132 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pin/pin_lib/trace_container.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Compressed, seekable container for ctype_pin_inst traces.
+ *
+ * A container file is laid out as
+ *
+ *   header | block 0 | block 1 | ... | static table | block index | footer
+ *
+ * The static table holds every distinct ctype_pin_inst with its dynamic
+ * fields (inst_uid, load/store addresses, taken bit and next address)
+ * cleared. The branch target stays in the static part, as ctype_pin_inst
+ * treats it, so an indirect branch gets one entry per target. Each block
+ * holds the dynamic stream of up to block_insts instructions: a static
+ * table id plus the dynamic fields, delta coded against the previous
+ * instruction of the same block and deflated with zlib. Blocks carry no state across their boundaries, so any
+ * block can be decoded on its own given the static table, and the block
+ * index maps instruction numbers to blocks for seeking.
+ *
+ * Records round-trip byte for byte: a read returns exactly the bytes of the
+ * ctype_pin_inst that was written.
+ ***************************************************************************************/
+
+#ifndef __TRACE_CONTAINER_H__
+#define __TRACE_CONTAINER_H__
+
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../../ctype_pin_inst.h"
+
+#define TRACE_CONTAINER_MAGIC "SCRBTRC1"
+#define TRACE_CONTAINER_MAGIC_SIZE 8
+#define TRACE_CONTAINER_DEFAULT_BLOCK_INSTS (1 << 16)
+
+/* Returns true if the file at path starts with the container magic. */
+bool trace_container_check_magic(const char* path);
+
+struct TraceContainerBlock {
+  uint64_t offset;      // file offset of the compressed block
+  uint64_t first_inst;  // number of the first instruction in the block
+  uint32_t comp_size;
+  uint32_t raw_size;
+  uint32_t num_insts;
+  uint32_t pad;
+};
+
+class TraceContainerWriter {
+ public:
+  TraceContainerWriter();
+  ~TraceContainerWriter();
+
+  bool open(const char* path,
+            uint32_t    block_insts = TRACE_CONTAINER_DEFAULT_BLOCK_INSTS);
+  void write(const ctype_pin_inst* pi);
+  bool close();
+
+  uint64_t num_insts() const { return inst_count; }
+  uint64_t num_static_insts() const { return static_insts.size(); }
+
+ private:
+  FILE*                                  file;
+  uint32_t                               block_insts;
+  uint64_t                               inst_count;
+  std::unordered_map<std::string, uint32_t> static_ids;
+  std::vector<ctype_pin_inst>            static_insts;
+  std::vector<TraceContainerBlock>       blocks;
+  std::vector<uint8_t>                   raw_block;
+  uint32_t                               block_count;
+  ctype_pin_inst                         prev;
+
+  void flush_block();
+  bool write_compressed(const std::vector<uint8_t>& raw, uint32_t* comp_size);
+};
+
+class TraceContainerReader {
+ public:
+  TraceContainerReader();
+  ~TraceContainerReader();
+
+  bool open(const char* path);
+  /* Returns false at the end of the trace. */
+  bool read(ctype_pin_inst* pi);
+  /* Positions the reader so that the next read returns instruction
+     inst_num (0-based). Returns false if the trace is shorter. */
+  bool seek(uint64_t inst_num);
+  void close();
+
+  uint64_t num_insts() const { return total_insts; }
+
+ private:
+  FILE*                            file;
+  uint64_t                         total_insts;
+  std::vector<ctype_pin_inst>      static_insts;
+  std::vector<TraceContainerBlock> blocks;
+  std::vector<uint8_t>             raw_block;
+  size_t                           next_block;
+  size_t                           raw_pos;
+  uint32_t                         block_left;
+  ctype_pin_inst                   prev;
+
+  bool load_block(size_t block);
+  bool read_compressed(uint64_t offset, uint32_t comp_size, uint32_t raw_size,
+                       std::vector<uint8_t>* raw);
+};
+
+#endif
@@ -41,8 +41,10 @@
 #include "../../statistics.h"
 
 #include "../../ctype_pin_inst.h"
+#include "../../decode_cache.h"
 #include "../../isa/isa.h"
 #include "../../libs/hash_lib.h"
+#include "../../op_pool.h"
 
 #include "libs/cpp_hash_lib_wrapper.h"
 #include "uop_generator.h"
@@ -187,7 +189,7 @@ static void print_op_fields(uns proc_id, Op* op) {
     DEBUG_PRINT(proc_id, "DEBUG_OP_FIELDS op: %s\n", disasm_op(op, FALSE));
     DEBUG_PRINT(proc_id, "DEBUG_OP_FIELDS op cf dir: %d %d %d\n",
                 op->table_info->op_type, op->table_info->cf_type,
-                op->oracle_info.dir);
+                OP_ORACLE(op).dir);
     DEBUG_PRINT(proc_id, "DEBUG_OP_FIELDS src regs: ");
     for(int i = 0; i < op->table_info->num_src_regs; ++i) {
       DEBUG_PRINT(proc_id, "%d ", op->inst_info->srcs[i].id);
@@ -203,7 +205,7 @@ static void print_op_fields(uns proc_id, Op* op) {
                 op->table_info->is_simd ? op->table_info->num_simd_lanes : 0,
                 op->table_info->is_simd ? op->table_info->lane_width_bytes : 0);
     DEBUG_PRINT(proc_id, "DEBUG_OP_FIELDS mem_type addr mem_size: %d %llx %d\n",
-                op->table_info->mem_type, op->oracle_info.va,
+                op->table_info->mem_type, OP_ORACLE(op).va,
                 op->table_info->mem_size);
   }
 }
@@ -229,6 +231,12 @@ void uop_generator_init(uint32_t num_cores) {
   memset(num_sending_uop, 0, num_cores * sizeof(uns));
 
   last_ga_va = (Addr*)malloc(num_cores * sizeof(Addr));
+
+  init_decode_cache();
+}
+
+void uop_generator_done(void) {
+  decode_cache_done();
 }
 
 Flag uop_generator_extract_op(uns proc_id, Op* op, compressed_op* cop) {
@@ -339,39 +347,39 @@ void uop_generator_get_uop(uns proc_id, Op* op, ctype_pin_inst* inst) {
   } else
     bom[proc_id] = FALSE;
 
-  op->op_num                   = op_count[proc_id];
-  op->inst_uid                 = trace_uop->inst_uid;
-  op->unique_num               = unique_count;
-  op->unique_num_per_proc      = unique_count_per_core[proc_id];
-  op->proc_id                  = proc_id;
-  op->thread_id                = 0;
-  op->eom                      = trace_uop->eom;
-  op->fetched_instruction      = fetched_instruction[proc_id];
-  op->inst_info                = info;
-  op->table_info               = info->table_info;
-  op->oracle_info.inst_info    = info;
-  op->oracle_info.table_info   = info->table_info;
-  op->engine_info.inst_info    = info;
-  op->engine_info.table_info   = info->table_info;
-  op->off_path                 = FALSE;
-  op->state                    = OS_FETCHED;
-  op->fu_num                   = -1;
-  op->issue_cycle              = MAX_CTR;
-  op->map_cycle                = MAX_CTR;
-  op->rdy_cycle                = 1;
-  op->sched_cycle              = MAX_CTR;
-  op->exec_cycle               = MAX_CTR;
-  op->dcache_cycle             = MAX_CTR;
-  op->done_cycle               = MAX_CTR;
-  op->replay_cycle             = MAX_CTR;
-  op->retire_cycle             = MAX_CTR;
-  op->replay                   = FALSE;
-  op->replay_count             = 0;
-  op->dont_cause_replays       = FALSE;
-  op->exec_count               = 0;
-  op->in_rdy_list              = FALSE;
-  op->in_node_list             = FALSE;
-  op->oracle_info.recovery_sch = FALSE;
+  op->op_num                 = op_count[proc_id];
+  op->inst_uid               = trace_uop->inst_uid;
+  op->unique_num             = unique_count;
+  op->unique_num_per_proc    = unique_count_per_core[proc_id];
+  op->proc_id                = proc_id;
+  op->thread_id              = 0;
+  op->eom                    = trace_uop->eom;
+  op->fetched_instruction    = fetched_instruction[proc_id];
+  op->inst_info              = info;
+  op->table_info             = info->table_info;
+  OP_ORACLE(op).inst_info    = info;
+  OP_ORACLE(op).table_info   = info->table_info;
+  OP_ENGINE(op).inst_info    = info;
+  OP_ENGINE(op).table_info   = info->table_info;
+  op->off_path               = FALSE;
+  op->state                  = OS_FETCHED;
+  op->fu_num                 = -1;
+  op->issue_cycle            = MAX_CTR;
+  op->map_cycle              = MAX_CTR;
+  op->rdy_cycle              = 1;
+  op->sched_cycle            = MAX_CTR;
+  op->exec_cycle             = MAX_CTR;
+  op->dcache_cycle           = MAX_CTR;
+  op->done_cycle             = MAX_CTR;
+  op->replay_cycle           = MAX_CTR;
+  op->retire_cycle           = MAX_CTR;
+  op->replay                 = FALSE;
+  op->replay_count           = 0;
+  op->dont_cause_replays     = FALSE;
+  op->exec_count             = 0;
+  op->in_rdy_list            = FALSE;
+  op->in_node_list           = FALSE;
+  OP_ORACLE(op).recovery_sch = FALSE;
 
   op->req    = NULL;
   op->marked = FALSE;
@@ -379,15 +387,14 @@ void uop_generator_get_uop(uns proc_id, Op* op, ctype_pin_inst* inst) {
   /* pipelined scheduler fields */
   op->chkpt_num = MAX_CTR;
   // op->row_num	         = MAX_CTR;
-  op->node_id          = MAX_CTR;
-  op->rs_id            = MAX_CTR;
-  op->same_src_last_op = 0;
+  op->node_id = MAX_CTR;
+  op->rs_id   = MAX_CTR;
 
-  op->oracle_cp_num                  = -1;
-  op->engine_info.l1_miss            = FALSE;
-  op->engine_info.l1_miss_satisfied  = FALSE;
-  op->engine_info.dep_on_l1_miss     = FALSE;
-  op->engine_info.was_dep_on_l1_miss = FALSE;
+  op->oracle_cp_num                = -1;
+  OP_ENGINE(op).l1_miss            = FALSE;
+  OP_ENGINE(op).l1_miss_satisfied  = FALSE;
+  OP_ENGINE(op).dep_on_l1_miss     = FALSE;
+  OP_ENGINE(op).was_dep_on_l1_miss = FALSE;
 
   /* multi path support */
 
@@ -395,38 +402,38 @@ void uop_generator_get_uop(uns proc_id, Op* op, ctype_pin_inst* inst) {
 
   if(op->table_info->op_type == OP_CF) {
     if (op->table_info->cf_type == CF_CBR) {
-      op->oracle_info.dir = (trace_uop->actual_taken == 0) ? NOT_TAKEN : TAKEN;
+      OP_ORACLE(op).dir = (trace_uop->actual_taken == 0) ? NOT_TAKEN : TAKEN;
     } else {
       //assume that all CFs besides CBR are actually always taken. This fixes the
       //issue where fall-through PC == target.
-      op->oracle_info.dir = TAKEN;
+      OP_ORACLE(op).dir = TAKEN;
     }
   }
   else
-    op->oracle_info.dir = NOT_TAKEN;
+    OP_ORACLE(op).dir = NOT_TAKEN;
 
   if((op->table_info->cf_type == CF_ICALL) ||
      (op->table_info->cf_type == CF_IBR) || (op->table_info->cf_type == CF_ICO))
-    op->oracle_info.dir = 1;  // FIXME Hack!! because of StringMOV
+    OP_ORACLE(op).dir = 1;  // FIXME Hack!! because of StringMOV
 
   /* removing proc_id from target before compare with zero */
-  op->oracle_info.target = convert_to_cmp_addr(0, trace_uop->target) ?
+  OP_ORACLE(op).target = convert_to_cmp_addr(0, trace_uop->target) ?
                              trace_uop->target :
                              trace_uop->npc;
-  op->oracle_info.va  = trace_uop->va;
-  op->oracle_info.npc = trace_uop->npc;
+  OP_ORACLE(op).va  = trace_uop->va;
+  OP_ORACLE(op).npc = trace_uop->npc;
   if(op->proc_id)
-    ASSERT(op->proc_id, op->oracle_info.npc);
-  op->oracle_info.mem_size = trace_uop->mem_size;
+    ASSERT(op->proc_id, OP_ORACLE(op).npc);
+  OP_ORACLE(op).mem_size = trace_uop->mem_size;
   // op->table_info->mem_size = trace_uop->mem_size;  // because of repeat move
   // mem size is dynamic info  WRONG!!!!
 
 
-  if(op->table_info->mem_type && !(op->oracle_info.va)) {
-    op->oracle_info.va = last_ga_va[proc_id];  // QUESTION why? //TODO: Really
+  if(op->table_info->mem_type && !(OP_ORACLE(op).va)) {
+    OP_ORACLE(op).va = last_ga_va[proc_id];  // QUESTION why? //TODO: Really
                                                // why?
-  } else if(op->oracle_info.va)
-    last_ga_va[proc_id] = op->oracle_info.va;
+  } else if(OP_ORACLE(op).va)
+    last_ga_va[proc_id] = OP_ORACLE(op).va;
 
 
   if((op->eom && trace_read_done[proc_id]) || trace_uop->exit) {
@@ -439,15 +446,15 @@ void uop_generator_get_uop(uns proc_id, Op* op, ctype_pin_inst* inst) {
         "op_num:%s unique_num:%s pc:0x%s npc:0x%s va:0x%s mem_type:%d "
         "mem_size:%d cf_type:%d oracle_target:%s dir:%d\n",
         unsstr64(op->op_num), unsstr64(op->unique_num),
-        hexstr64s(op->inst_info->addr), hexstr64s(op->oracle_info.npc),
-        hexstr64s(op->oracle_info.va), op->table_info->mem_type,
-        op->oracle_info.mem_size, op->table_info->cf_type,
-        hexstr64s(op->oracle_info.target), op->oracle_info.dir);
+        hexstr64s(op->inst_info->addr), hexstr64s(OP_ORACLE(op).npc),
+        hexstr64s(OP_ORACLE(op).va), op->table_info->mem_type,
+        OP_ORACLE(op).mem_size, op->table_info->cf_type,
+        hexstr64s(OP_ORACLE(op).target), OP_ORACLE(op).dir);
 
   for(ii = 0; ii < op->inst_info->table_info->num_src_regs; ii++) {
     DEBUG(proc_id, "op_num:%s unique_num:%s pc:0x%s npc:0x%s, src(%d/%d):%s \n",
           unsstr64(op->op_num), unsstr64(op->unique_num),
-          hexstr64s(op->inst_info->addr), hexstr64s(op->oracle_info.npc),
+          hexstr64s(op->inst_info->addr), hexstr64s(OP_ORACLE(op).npc),
           ii + 1, op->inst_info->table_info->num_src_regs,
           disasm_reg(op->inst_info->srcs[ii].id));
   }
@@ -456,7 +463,7 @@ void uop_generator_get_uop(uns proc_id, Op* op, ctype_pin_inst* inst) {
     DEBUG(proc_id,
           "op_num:%s unique_num:%s pc:0x%s npc:0x%s, dest(%d/%d):%s \n",
           unsstr64(op->op_num), unsstr64(op->unique_num),
-          hexstr64s(op->inst_info->addr), hexstr64s(op->oracle_info.npc),
+          hexstr64s(op->inst_info->addr), hexstr64s(OP_ORACLE(op).npc),
           ii + 1, op->inst_info->table_info->num_dest_regs,
           disasm_reg(op->inst_info->dests[ii].id));
   }
@@ -470,15 +477,29 @@ Flag uop_generator_get_eom(uns proc_id) {
   return eom[proc_id];
 }
 
+/* Decodes inst without building an Op, for the functional warmup. Like
+   uop_generator_get_uop(), this converts the addresses in inst to cmp
+   addresses and goes through the same Inst_Info table, so simulation mode
+   finds the instruction already decoded. Returns the Inst_Info of the last
+   uop, which carries the control flow and barrier type. */
+Inst_Info* uop_generator_decode_inst(uns proc_id, compressed_op* inst,
+                                     uns* num_uops) {
+  ASSERT(proc_id, bom[proc_id]);
+  ASSERT(proc_id, !inst->fake_inst);
+  Trace_Uop** trace_uop = trace_uop_bulk[proc_id];
+  convert_pinuop_to_t_uop(proc_id, inst, trace_uop);
+  *num_uops = trace_uop[0]->info->trace_info.num_uop;
+  return trace_uop[*num_uops - 1]->info;
+}
+
 void convert_t_uop_to_info(uns8 proc_id, Trace_Uop* t_uop, Inst_Info* info) {
   int ii;
 
   // build info // we  can optimize to build this info only once
-  info->table_info = (Table_Info*)malloc(sizeof(Table_Info));  // FIXME. at
-                                                               // least a hash
-                                                               // function based
-                                                               // on the same
-                                                               // table info.
+  // FIXME. at least a hash function based on the same table info.
+  // Zeroed: the decode cache writes Table_Infos to its file byte for byte, so
+  // the fields set below must be all there is.
+  info->table_info = (Table_Info*)calloc(1, sizeof(Table_Info));
 
   ASSERT(proc_id, info);
   ASSERT(proc_id, info->table_info);
@@ -820,7 +841,7 @@ static uns generate_uops(uns8 proc_id, ctype_pin_inst* pi,
     clear_t_uop(uop);
 
     uop->op_type = OP_NOP;
-    STAT_EVENT(0, STATIC_PIN_NOP);
+    SHARED_STAT_EVENT(0, STATIC_PIN_NOP);
   }
 
   return idx;
@@ -833,10 +854,10 @@ void convert_pinuop_to_t_uop(uns8 proc_id, ctype_pin_inst* pi,
   // Due to JIT compilation, each branch must be decoded to verify which instruction the PC maps to.
   // To decrease unnecessary malloc/free, fetch inst_info from hashmap
   // instead of allocating. However first instruction must be decoded.
-  static Inst_Info dummy_nop;
-  static Flag generated_dummy_nop = FALSE;
+  static SIM_THREAD_LOCAL Inst_Info dummy_nop;
+  static SIM_THREAD_LOCAL Flag      generated_dummy_nop = FALSE;
   if(pi->fake_inst) {
-    info                   = (Inst_Info*)calloc(1, sizeof(Inst_Info));
+    info                   = alloc_fake_inst_info(proc_id);
     if (generated_dummy_nop) {
       *info = dummy_nop;
       info->addr = pi->instruction_addr;
@@ -846,6 +867,9 @@ void convert_pinuop_to_t_uop(uns8 proc_id, ctype_pin_inst* pi,
   } else {
     info = cpp_hash_table_access_create(proc_id, pi->instruction_addr, pi->inst_binary_lsb,
                                         pi->inst_binary_msb, 0, &new_entry);
+    // a previous run may have decoded it already
+    if(new_entry && !pi->is_gather_scatter)
+      new_entry = !decode_cache_fill(proc_id, pi, info);
     info->fake_inst        = FALSE;
     info->fake_inst_reason = WPNM_NOT_IN_WPNM;
   }
@@ -886,7 +910,7 @@ void convert_pinuop_to_t_uop(uns8 proc_id, ctype_pin_inst* pi,
     for(ii = 0; ii < num_uop; ii++) {
       if(ii > 0) {
         if(pi->fake_inst) {
-          info                   = (Inst_Info*)calloc(1, sizeof(Inst_Info));
+          info                   = alloc_fake_inst_info(proc_id);
           info->fake_inst        = TRUE;
           info->fake_inst_reason = pi->fake_inst_reason;
         } else {
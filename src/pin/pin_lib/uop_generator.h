@@ -39,12 +39,15 @@ extern "C" {
 #endif
 
 void uop_generator_init(uint32_t num_cores);
+void uop_generator_done(void);
 Flag uop_generator_extract_op(uns proc_id, Op* op, compressed_op* cop);
 
 void uop_generator_get_uop(uns proc_id, Op* op, compressed_op* inst);
 Flag uop_generator_get_bom(uns proc_id);  // Called before
                                           // uop_generator_get_uop.
 Flag uop_generator_get_eom(uns proc_id);  // Called after uop_generator_get_uop.
+Inst_Info* uop_generator_decode_inst(uns proc_id, compressed_op* inst,
+                                     uns* num_uops);
 void uop_generator_recover(uns8 proc_id);
 
 #ifdef __cplusplus
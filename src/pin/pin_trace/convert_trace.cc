@@ -0,0 +1,76 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pin/pin_trace/convert_trace.cc
+ * Author       : HPS Research Group
+ * Date         :
+ * Description  : Converts a bzip2 trace written by gen_trace into a trace
+ *                container (see pin_lib/trace_container.h).
+ ***************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <inttypes.h>
+#include <iostream>
+
+#include "../pin_lib/trace_container.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+  if(argc < 3) {
+    cerr << "Usage: convert_trace <bzip2 trace> <container> [block insts]"
+         << endl;
+    exit(1);
+  }
+
+  uint32_t block_insts = argc > 3 ? strtoul(argv[3], NULL, 0) :
+                                    TRACE_CONTAINER_DEFAULT_BLOCK_INSTS;
+  char     cmdline[1024];
+  sprintf(cmdline, "bzip2 -dc %s", argv[1]);
+  FILE* orig_stream = popen(cmdline, "r");
+  if(!orig_stream) {
+    cerr << "Cannot open " << argv[1] << endl;
+    exit(1);
+  }
+
+  TraceContainerWriter writer;
+  if(!writer.open(argv[2], block_insts)) {
+    cerr << "Cannot open " << argv[2] << endl;
+    exit(1);
+  }
+
+  ctype_pin_inst pin_inst;
+  while(fread(&pin_inst, sizeof(ctype_pin_inst), 1, orig_stream))
+    writer.write(&pin_inst);
+  pclose(orig_stream);
+
+  uint64_t num_insts        = writer.num_insts();
+  uint64_t num_static_insts = writer.num_static_insts();
+  if(!writer.close()) {
+    cerr << "Failed to write " << argv[2] << endl;
+    exit(1);
+  }
+  cout << "Wrote " << num_insts << " instructions (" << num_static_insts
+       << " static) to " << argv[2] << endl;
+  return 0;
+}
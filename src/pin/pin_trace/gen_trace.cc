@@ -77,6 +77,7 @@ using namespace CONTROLLER;
 
 #include "../../ctype_pin_inst.h"
 #include "../../table_info.h"
+#include "../pin_lib/trace_container.h"
 
 std::vector<std::string> iclass_prints;
 
@@ -95,6 +96,10 @@ KNOB<BOOL> KnobPinPlayReplayer(KNOB_MODE_WRITEONCE, "pintool", "replay", "0",
 // Knobs that control trace generation
 KNOB<string> Knob_output(KNOB_MODE_WRITEONCE, "pintool", "o", "trace.bz2",
                          "trace outputfilename");
+KNOB<BOOL> KnobContainer(
+  KNOB_MODE_WRITEONCE, "pintool", "container", "0",
+  "Write a seekable trace container (see pin_lib/trace_container.h) instead "
+  "of a bzip2 stream");
 
 // Trace start and end options
 KNOB<UINT64> KnobStartRip(
@@ -108,7 +113,9 @@ KNOB<UINT64> KnobFastForward(
   "Number of instructions to fast-forward before generating the trace");
 
 /*** globals ***/
-FILE* output_stream;
+FILE*                output_stream;
+TraceContainerWriter container_writer;
+bool                 output_enabled = false;
 
 ctype_pin_inst mailbox;
 bool           mailbox_full = false;
@@ -133,13 +140,23 @@ void change_rip(CONTEXT* ctx) {
   PIN_ExecuteAt(ctx);
 }
 
+void write_instruction(const ctype_pin_inst* inst) {
+  if(KnobContainer.Value())
+    container_writer.write(inst);
+  else
+    fwrite(inst, sizeof(*inst), 1, output_stream);
+}
+
 LOCALFUN VOID Fini(int n, void* v) {
   pin_decoder_print_unknown_opcodes();
-  if(output_stream) {
+  if(output_enabled) {
     if(mailbox_full) {
-      fwrite(&mailbox, sizeof(mailbox), 1, output_stream);
+      write_instruction(&mailbox);
     }
-    pclose(output_stream);
+    if(KnobContainer.Value())
+      container_writer.close();
+    else
+      pclose(output_stream);
   }
 }
 
@@ -178,7 +195,7 @@ void dump_instruction() {
   ctype_pin_inst* info = pin_decoder_get_latest_inst();
   if(mailbox_full) {
     mailbox.instruction_next_addr = info->instruction_addr;
-    fwrite(&mailbox, sizeof(mailbox), 1, output_stream);
+    write_instruction(&mailbox);
   }
   mailbox      = *info;
   mailbox_full = true;
@@ -207,7 +224,7 @@ void insert_instrumentation(TRACE trace, void* v) {
       INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)fast_forward_ins, IARG_END);
       INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)check_end_of_trace, IARG_END);
       pin_decoder_insert_analysis_functions(ins);
-      if(output_stream) {
+      if(output_enabled) {
         INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)dump_instruction, IARG_END);
       }
     });
@@ -221,10 +238,17 @@ int main(int argc, char* argv[]) {
 
   pinplay_engine.Activate(argc, argv, KnobPinPlayLogger, KnobPinPlayReplayer);
 
-  if(!Knob_output.Value().empty()) {
+  if(!Knob_output.Value().empty() && KnobContainer.Value()) {
+    if(!container_writer.open(Knob_output.Value().c_str())) {
+      std::cerr << "Cannot open " << Knob_output.Value() << endl;
+      return -1;
+    }
+    output_enabled = true;
+  } else if(!Knob_output.Value().empty()) {
     char popename[1024];
     sprintf(popename, "bzip2 > %s", Knob_output.Value().c_str());
-    output_stream = popen(popename, "w");
+    output_stream  = popen(popename, "w");
+    output_enabled = output_stream != NULL;
   } else {
     cout << "No trace specified. Only verifying opcodes." << endl;
   }
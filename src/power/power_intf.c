@@ -85,7 +85,9 @@ void power_intf_init(void) {
 
   ASSERTM(0, NUM_CORES <= 8, "power_intf supports up to 8 cores\n");
 
+  require_stat(POWER_TIME);
   for(uns stat = POWER_STATS_BEGIN; stat <= POWER_STATS_END; ++stat) {
+    require_stat(stat);
     ASSERT(0, GET_TOTAL_STAT_EVENT(0, stat) == 0);
   }
 }
@@ -62,7 +62,7 @@ using std::dec;
 
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_EIP, ##args)
 
-extern int per_cyc_ipref;
+extern SIM_THREAD_LOCAL int per_cyc_ipref;
 extern const int MAX_FTQ_ENTRY_CYC;
 
 // To access cpu in my functions
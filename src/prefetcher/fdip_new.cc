@@ -1,6 +1,7 @@
 #include "decoupled_frontend.h"
 #include "prefetcher/fdip_new.h"
 #include "libs/bloom_filter.hpp"
+#include "libs/line_table.h"
 #include "sim.h"
 #include "frontend/pt_memtrace/memtrace_fe.h"
 
@@ -10,25 +11,24 @@ extern "C" {
 #include "prefetcher/eip.h"
 #include "memory/memory.h"
 #include "memory/memory.param.h"
+#include "cmp_threads.h"
 }
 
 #include <iostream>
-#include <unordered_map>
-#include <map>
 #include <algorithm>
 #include <deque>
 #include <tuple>
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_FDIP, ##args)
 
-decoupled_fe_iter* iter;
+SIM_THREAD_LOCAL decoupled_fe_iter* iter;
 extern const int MAX_FTQ_ENTRY_CYC = 2;
-int fdip_proc_id;
-Icache_Stage *ic_ref;
+SIM_THREAD_LOCAL int fdip_proc_id;
+SIM_THREAD_LOCAL Icache_Stage *ic_ref;
 std::vector<Op*> per_core_cur_op;
 std::vector<decoupled_fe_iter*> per_core_ftq_iter;
 std::vector<Addr> per_core_last_line_addr;
 std::vector<Flag> per_core_warmed_up;
-int per_cyc_ipref = 0;
+SIM_THREAD_LOCAL int per_cyc_ipref = 0;
 
 typedef enum FDIP_BREAK_enum {
   BR_REACH_FTQ_END,
@@ -62,51 +62,65 @@ std::vector<uns> per_core_last_imiss_reason;
 // for assertions
 std::vector<uns> per_core_last_break_reason;
 std::vector<Counter> per_core_last_recover_cycle;
+/* Per-line tables live in open-addressing Line_Tables (libs/line_table.h). FDIP_LINE_TABLE_MAX_LINES bounds every
+   table; FDIP_LINE_STATS_SAMPLE_BITS samples the tables that only feed statistics, never the ones that steer
+   prefetch decisions. */
 // <CL address, # of first demand load on-path hits of cache lines, flag for learning from a true miss> - useful count
-std::vector<std::unordered_map<Addr, std::pair<Counter, Flag>>> per_core_cnt_useful;
+std::vector<Line_Table<std::pair<Counter, Flag>>> per_core_cnt_useful;
 // <CL address, # of first demand load on-path hits of cache lines, flag for learning from a true miss> - useful count after warm-up
-std::vector<std::unordered_map<Addr, std::pair<Counter, Flag>>> per_core_cnt_useful_aw;
+std::vector<Line_Table<std::pair<Counter, Flag>>> per_core_cnt_useful_aw;
 // <CL address, # of evictions w/o hit of cache lines> - unuseful count
-std::vector<std::unordered_map<Addr, Counter>> per_core_cnt_unuseful;
+std::vector<Line_Table<Counter>> per_core_cnt_unuseful;
 // <CL address, # of evictions w/o hit of cache lines> - unuseful count after warm-up
-std::vector<std::unordered_map<Addr, Counter>> per_core_cnt_unuseful_aw;
+std::vector<Line_Table<Counter>> per_core_cnt_unuseful_aw;
 // Increment if useful by UDP_WEIGHT_USEFUL, decrement if unuseful by UDP_WEIGHT_UNUSEFUL
 // <CL address, counter for on/off-path unuseful/useful> init by UDP_USEFUL_THRESHOLD
 // OPTIMISTIC POLICY : do not prefetch if < USEFUL_THRESHOLD, otherwise, prefetch (do not prefetch only when it was unuseful at least once)
 // CONSERVATIVE POLICY : prefetch if > USEFUL_THRESHOLD, otherwise, do not prefetch (prefetch only when it was useful at least once)
-std::vector<std::unordered_map<Addr, int32_t>> per_core_cnt_useful_signed;
+std::vector<Line_Table<int32_t>> per_core_cnt_useful_signed;
 // <CL addresses, retirement count> - on-path retired cache line count
-std::vector<std::unordered_map<Addr, Counter>> per_core_cnt_useful_ret;
+std::vector<Line_Table<Counter>> per_core_cnt_useful_ret;
 // <CL addresses, icache miss count>
-std::vector<std::map<Addr, Counter>> per_core_icache_miss;
+std::vector<Line_Table<Counter>> per_core_icache_miss;
 // <CL addresses, icache miss count> after warm-up
-std::vector<std::map<Addr, Counter>> per_core_icache_miss_aw;
+std::vector<Line_Table<Counter>> per_core_icache_miss_aw;
 // <CL addresses, icache hit count>
-std::vector<std::map<Addr, Counter>> per_core_icache_hit;
+std::vector<Line_Table<Counter>> per_core_icache_hit;
 // <CL addresses, icache hit count> after warm-up
-std::vector<std::map<Addr, Counter>> per_core_icache_hit_aw;
+std::vector<Line_Table<Counter>> per_core_icache_hit_aw;
 // <CL addresses, fetched_cycle on the off-path>
-std::vector<std::map<Addr, Counter>> per_core_off_fetched_cls;;
+std::vector<Line_Table<Counter>> per_core_off_fetched_cls;
 // <CL addresses, prefetched count>
-std::vector<std::map<Addr, Counter>> per_core_prefetched_cls;
+std::vector<Line_Table<Counter>> per_core_prefetched_cls;
 // <CL addresses, prefetched count> after warm-up
-std::vector<std::map<Addr, Counter>> per_core_prefetched_cls_aw;
+std::vector<Line_Table<Counter>> per_core_prefetched_cls_aw;
 // <CL addresses, new_prefetched count>
-std::vector<std::map<Addr, Counter>> per_core_new_prefetched_cls;
+std::vector<Line_Table<Counter>> per_core_new_prefetched_cls;
 // <CL addresses, new_prefetched count> after warm-up
-std::vector<std::map<Addr, Counter>> per_core_new_prefetched_cls_aw;
+std::vector<Line_Table<Counter>> per_core_new_prefetched_cls_aw;
 // <CL address, cyc_access_by_fdip, conf_on/off-path, cyc_evicted_from_l1_by_demand_load, cyc_evicted_from_l1_by_FDIP> - prefetched and access time information for timeliness analysis
-std::vector<std::unordered_map<Addr, std::pair<std::pair<Counter, Flag>, std::pair<Counter, Counter>>>> per_core_prefetched_cls_info;
+std::vector<Line_Table<std::pair<std::pair<Counter, Flag>, std::pair<Counter, Counter>>>> per_core_prefetched_cls_info;
 // <CL address, sequence of useful/unuseful>
-std::vector<std::unordered_map<Addr, std::vector<uns8>>> per_core_useful_sequence;
+std::vector<Line_History<uns8>> per_core_useful_sequence;
 // <CL address, sequence of hit/miss>
-std::vector<std::unordered_map<Addr, std::vector<uns8>>> per_core_icache_sequence;
-// <CL address, all sequence> char - P: prefetch, p: not prefetch, m: icache miss, h: icache hit, U: useful, u: unuseful (Counter - cycle count)
-std::vector<std::unordered_map<Addr, std::vector<std::pair<char,Counter>>>> per_core_sequence_bw;
-// <CL address, all sequence> char - P: prefetch, p: not prefetch, m: icache miss, h: icache hit, U: useful, u: unuseful (Counter - cycle count)
-std::vector<std::unordered_map<Addr, std::vector<std::pair<char,Counter>>>> per_core_sequence_aw;
+std::vector<Line_History<uns8>> per_core_icache_sequence;
+// char - P: prefetch, p: not prefetch, m: icache miss, h: icache hit, U: useful, u: unuseful, e: evict
+typedef struct Seq_Summary_struct {
+  uns     length;
+  char    first[2]; // first two events of the sequence
+  Counter cnt_p;
+  Counter cnt_u;
+  Counter cnt_U;
+} Seq_Summary;
+// <CL address, summary of the whole sequence> before / after warm-up
+std::vector<Line_Table<Seq_Summary>> per_core_sequence_bw;
+std::vector<Line_Table<Seq_Summary>> per_core_sequence_aw;
+// <CL address, all sequence after warm-up> (Counter - cycle count), unless streamed to disk
+std::vector<Line_History<std::pair<char,Counter>>> per_core_sequence_aw_hist;
+// per-line sequences are written here instead of kept in memory when FDIP_STREAM_LINE_HISTORY is set
+std::vector<FILE*> per_core_line_history_stream;
 // <CL address, total miss delay>
-std::vector<std::map<Addr, Counter>> per_core_per_line_delay_aw;
+std::vector<Line_Table<Counter>> per_core_per_line_delay_aw;
 std::vector<Counter> per_core_cur_line_delay;
 // accumulated FTQ occupancy every cycle
 std::vector<uint64_t> per_core_fdip_ftq_occupancy_ops;
@@ -176,6 +190,8 @@ void alloc_mem_fdip(uns numCores) {
   per_core_icache_sequence.resize(numCores);
   per_core_sequence_bw.resize(numCores);
   per_core_sequence_aw.resize(numCores);
+  per_core_sequence_aw_hist.resize(numCores);
+  per_core_line_history_stream.resize(numCores);
   per_core_per_line_delay_aw.resize(numCores);
   per_core_cur_line_delay.resize(numCores);
   per_core_fdip_ftq_occupancy_ops.resize(numCores);
@@ -240,6 +256,37 @@ void init_fdip(uns proc_id) {
   per_core_fdip_ftq_occupancy_ops[proc_id] = 0;
   per_core_fdip_ftq_occupancy_blocks[proc_id] = 0;
   per_core_cur_line_delay[proc_id] = 0;
+  // tables consulted by the prefetch decision are bounded but never sampled
+  per_core_cnt_useful[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, 0);
+  per_core_cnt_unuseful[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, 0);
+  per_core_cnt_useful_signed[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, 0);
+  per_core_prefetched_cls[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, 0);
+  per_core_prefetched_cls_info[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, 0);
+  per_core_cnt_useful_aw[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_cnt_unuseful_aw[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_cnt_useful_ret[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_icache_miss[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_icache_miss_aw[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_icache_hit[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_icache_hit_aw[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_off_fetched_cls[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_prefetched_cls_aw[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_new_prefetched_cls[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_new_prefetched_cls_aw[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_useful_sequence[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_icache_sequence[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_sequence_bw[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_sequence_aw[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_sequence_aw_hist[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_per_line_delay_aw[proc_id].configure(FDIP_LINE_TABLE_MAX_LINES, FDIP_LINE_STATS_SAMPLE_BITS);
+  per_core_line_history_stream[proc_id] = NULL;
+  if (FDIP_STREAM_LINE_HISTORY) {
+    char name[MAX_STR_LENGTH + 1];
+    snprintf(name, MAX_STR_LENGTH, "fdip_line_history_%u", proc_id);
+    per_core_line_history_stream[proc_id] = file_tag_fopen(OUTPUT_DIR, name, "w");
+    ASSERTM(proc_id, per_core_line_history_stream[proc_id], "Could not open %s\n", name);
+    fprintf(per_core_line_history_stream[proc_id], "kind,cl_addr,event,cycle\n");
+  }
   if (FDIP_UTILITY_HASH_ENABLE || FDIP_UC_SIZE || FDIP_BLOOM_FILTER) {
     per_core_last_cl_unuseful[proc_id] = 0;
     per_core_last_bbl_start_addr[proc_id] = 0;
@@ -414,7 +461,7 @@ void update_fdip() {
     if((op)->table_info->cf_type == CF_CBR || 
       (op)->table_info->cf_type == CF_IBR || 
       (op)->table_info->cf_type == CF_ICALL){
-      if(op->oracle_info.mispred) {
+      if(OP_ORACLE(op).mispred) {
         //reorder stats
         STAT_EVENT(fdip_proc_id, FDIP_BP_CONF_0_MISPRED + op->bp_confidence);
       } else {
@@ -449,8 +496,10 @@ void update_fdip() {
           bool line_info = (Icache_Data*)cache_access(&ic_ref->icache_line_info, pc_addr, &dummy_addr, TRUE);
           UNUSED(line_info);
         }
+        cmp_threads_lock();
         bool mlc_line = (Inst_Info**)cache_access(&mem->uncores[ic_ref->proc_id].mlc->cache, pc_addr, &dummy_addr, FALSE);
         bool l1_line = (Inst_Info**)cache_access(&mem->uncores[ic_ref->proc_id].l1->cache, pc_addr, &dummy_addr, FALSE);
+        cmp_threads_unlock();
         UNUSED(dummy_addr);
         uns pref_from = line ? 0 : (mlc_line ? 1 : (l1_line ? 2 : 3));
         STAT_EVENT(ic_ref->proc_id, FDIP_PREFETCH_HIT_ICACHE + pref_from);
@@ -617,333 +666,273 @@ Flag fdip_conf_off_path(uns proc_id) {
   return fdip_off_path(proc_id);
 }
 
-template<typename A, typename B>
-std::pair<B,A> flip_pair(const std::pair<A,B> &p)
-{
-  return std::pair<B,A>(p.second, p.first);
+template<typename V>
+static inline V* line_table_insert(uns proc_id, Line_Table<V>* table, Addr line_addr,
+                                   const typename Line_Table<V>::Value& init, Flag* inserted = NULL) {
+  Counter dropped = table->get_dropped();
+  V* value = table->insert(line_addr, init, inserted);
+  if (table->get_dropped() != dropped)
+    STAT_EVENT(proc_id, FDIP_LINE_TABLE_DROPS);
+  return value;
 }
 
-template<typename A, typename B>
-std::multimap<B,A> flip_map(const std::map<A,B> &src)
-{
-  std::multimap<B,A> dst;
-  std::transform(src.begin(), src.end(), std::inserter(dst, dst.begin()), flip_pair<A,B>);
-  return dst;
+// <count, CL address> pairs in ascending count order (ties by address)
+static std::vector<std::pair<Counter, Addr>> sort_by_count(Line_Table<Counter>* table) {
+  std::vector<std::pair<Counter, Addr>> sorted;
+  sorted.reserve(table->size());
+  table->for_each([&](Addr line_addr, Counter& cnt) { sorted.push_back(std::make_pair(cnt, line_addr)); });
+  std::sort(sorted.begin(), sorted.end());
+  return sorted;
+}
+
+static inline void add_seq(uns proc_id, Addr line_addr, char event, Counter cyc) {
+  Flag warmed_up = per_core_warmed_up[proc_id];
+  Line_Table<Seq_Summary>* summaries = warmed_up ? &per_core_sequence_aw[proc_id] : &per_core_sequence_bw[proc_id];
+  Seq_Summary* summary = line_table_insert(proc_id, summaries, line_addr, Seq_Summary{0, {0, 0}, 0, 0, 0});
+  if (!summary)
+    return;
+  if (summary->length < 2)
+    summary->first[summary->length] = event;
+  summary->length++;
+  if (event == 'p')
+    summary->cnt_p++;
+  else if (event == 'u')
+    summary->cnt_u++;
+  else if (event == 'U')
+    summary->cnt_U++;
+
+  if (FDIP_STREAM_LINE_HISTORY)
+    fprintf(per_core_line_history_stream[proc_id], "%s,%llx,%c,%lld\n", warmed_up ? "seq_aw" : "seq_bw", line_addr, event, cyc);
+  else if (warmed_up)
+    per_core_sequence_aw_hist[proc_id].append(line_addr, std::make_pair(event, cyc));
+}
+
+static inline void add_line_event(uns proc_id, Line_History<uns8>* hist, const char* kind, Addr line_addr, uns8 value) {
+  if (!FDIP_STREAM_LINE_HISTORY)
+    hist->append(line_addr, value);
+  else if (hist->sampled(line_addr))
+    fprintf(per_core_line_history_stream[proc_id], "%s,%llx,%u,%llu\n", kind, line_addr, value, cycle_count);
+}
+
+static void print_line_history(FILE* fp, Line_History<uns8>* hist) {
+  fprintf(fp, "cl_addr,seq\n");
+  hist->for_each_line([&](Addr line_addr) {
+    fprintf(fp, "%llx", line_addr);
+    hist->for_each_event(line_addr, [&](uns8 value) { fprintf(fp, ",%u", value); });
+    fprintf(fp, "\n");
+  });
 }
 
 void print_cl_info(uns proc_id) {
   if (!FDIP_ENABLE)
     return;
-  std::unordered_map<Addr, Counter>* cnt_useful_ret = &per_core_cnt_useful_ret[proc_id];
-  std::map<Addr, Counter>* prefetched_cls = &per_core_prefetched_cls[proc_id];
-  std::map<Addr, Counter>* icache_miss = &per_core_icache_miss[proc_id];
-  std::map<Addr, Counter>* icache_hit = &per_core_icache_hit[proc_id];
+  Line_Table<Counter>* cnt_useful_ret = &per_core_cnt_useful_ret[proc_id];
+  Line_Table<Counter>* prefetched_cls = &per_core_prefetched_cls[proc_id];
+  Line_Table<Counter>* icache_miss = &per_core_icache_miss[proc_id];
+  Line_Table<Counter>* icache_hit = &per_core_icache_hit[proc_id];
 
-  DEBUG(proc_id, "icache miss cache lines (UNIQUE_MISSED_LINES) size: %lu, icache hit cache lines (UNIQUE_MISSED_LINES): %lu\n", icache_miss->size(), icache_hit->size());
+  DEBUG(proc_id, "icache miss cache lines (UNIQUE_MISSED_LINES) size: %u, icache hit cache lines (UNIQUE_MISSED_LINES): %u\n", icache_miss->size(), icache_hit->size());
   INC_STAT_EVENT(proc_id, ICACHE_UNIQUE_MISSED_LINES, icache_miss->size());
   INC_STAT_EVENT(proc_id, ICACHE_UNIQUE_HIT_LINES, icache_hit->size());
-  std::multimap<Counter, Addr> icache_miss_sorted = flip_map(*icache_miss);
-  for(std::multimap<Counter, Addr>::const_iterator it = icache_miss_sorted.begin();
-      it != icache_miss_sorted.end(); ++it) {
+  std::vector<std::pair<Counter, Addr>> icache_miss_sorted = sort_by_count(icache_miss);
+  for(auto it = icache_miss_sorted.begin(); it != icache_miss_sorted.end(); ++it) {
     DEBUG(proc_id, "[set %u] 0x%llx missed %llu times\n", (uns)(it->second >> ic_ref->icache.shift_bits & ic_ref->icache.set_mask), it->second, it->first);
   }
-  DEBUG(proc_id, "unique prefetched lines (UNIQUE_PREFETCHED_LINES) size: %lu\n", prefetched_cls->size());
-  std::multimap<Counter, Addr> prefetched_cls_sorted = flip_map(*prefetched_cls);
-  for(std::multimap<Counter, Addr>::const_iterator it = prefetched_cls_sorted.begin();
-      it != prefetched_cls_sorted.end(); ++it) {
-    auto useful_ret_iter = cnt_useful_ret->find(it->second);
-    if (useful_ret_iter == cnt_useful_ret->end()) {
+  DEBUG(proc_id, "unique prefetched lines (UNIQUE_PREFETCHED_LINES) size: %u\n", prefetched_cls->size());
+  std::vector<std::pair<Counter, Addr>> prefetched_cls_sorted = sort_by_count(prefetched_cls);
+  for(auto it = prefetched_cls_sorted.begin(); it != prefetched_cls_sorted.end(); ++it) {
+    if (!cnt_useful_ret->find(it->second)) {
       DEBUG(proc_id, "Unuseful 0x%llx prefetched %llu times\n", it->second, it->first);
     }
   }
 
-  std::unordered_map<Addr, int32_t>* cnt_learned_cl = &per_core_cnt_useful_signed[proc_id];
+  // a bounded table may have dropped the line from one of the two sets
+  Flag complete = !per_core_cnt_useful[proc_id].get_dropped() && !per_core_cnt_unuseful[proc_id].get_dropped();
   FILE* fp = fopen("per_line_icache_line_info.csv", "w");
   fprintf(fp, "cl_addr,useful_cnt,unuseful_cnt,prefetch_cnt,new_prefetch_cnt,icache_hit,icache_miss\n");
-  for(auto it = cnt_learned_cl->begin(); it != cnt_learned_cl->end(); ++it) {
-    auto cnt_useful_iter = per_core_cnt_useful[proc_id].find(it->first);
-    auto cnt_unuseful_iter = per_core_cnt_unuseful[proc_id].find(it->first);
-    auto cnt_prefetch_iter = per_core_prefetched_cls[proc_id].find(it->first);
-    auto cnt_new_prefetch_iter = per_core_new_prefetched_cls[proc_id].find(it->first);
-    auto hit_iter = per_core_icache_hit[proc_id].find(it->first);
-    auto miss_iter = per_core_icache_miss[proc_id].find(it->first);
-    Counter cnt_useful = (cnt_useful_iter != per_core_cnt_useful[proc_id].end())? cnt_useful_iter->second.first : 0;
-    Counter cnt_unuseful = (cnt_unuseful_iter != per_core_cnt_unuseful[proc_id].end())? cnt_unuseful_iter->second : 0;
-    Counter cnt_prefetch = (cnt_prefetch_iter != per_core_prefetched_cls[proc_id].end())? cnt_prefetch_iter->second : 0;
-    Counter cnt_new_prefetch = (cnt_new_prefetch_iter != per_core_new_prefetched_cls[proc_id].end())? cnt_new_prefetch_iter->second : 0;
-    Counter num_hit = (hit_iter != per_core_icache_hit[proc_id].end())? hit_iter->second : 0;
-    Counter num_miss = (miss_iter != per_core_icache_miss[proc_id].end())? miss_iter->second : 0;
-    fprintf(fp, "%llx,%llu,%llu,%llu,%llu,%llu,%llu\n", it->first, cnt_useful, cnt_unuseful, cnt_prefetch, cnt_new_prefetch, num_hit, num_miss);
-    ASSERT(proc_id, (cnt_useful_iter != per_core_cnt_useful[proc_id].end()) || (cnt_unuseful_iter != per_core_cnt_unuseful[proc_id].end()));
-  }
+  per_core_cnt_useful_signed[proc_id].for_each([&](Addr line_addr, int32_t&) {
+    std::pair<Counter, Flag>* useful = per_core_cnt_useful[proc_id].find(line_addr);
+    Counter* unuseful = per_core_cnt_unuseful[proc_id].find(line_addr);
+    Counter* prefetch = per_core_prefetched_cls[proc_id].find(line_addr);
+    Counter* new_prefetch = per_core_new_prefetched_cls[proc_id].find(line_addr);
+    Counter* hit = per_core_icache_hit[proc_id].find(line_addr);
+    Counter* miss = per_core_icache_miss[proc_id].find(line_addr);
+    Counter cnt_useful = useful ? useful->first : 0;
+    Counter cnt_unuseful = unuseful ? *unuseful : 0;
+    Counter cnt_prefetch = prefetch ? *prefetch : 0;
+    Counter cnt_new_prefetch = new_prefetch ? *new_prefetch : 0;
+    Counter num_hit = hit ? *hit : 0;
+    Counter num_miss = miss ? *miss : 0;
+    fprintf(fp, "%llx,%llu,%llu,%llu,%llu,%llu,%llu\n", line_addr, cnt_useful, cnt_unuseful, cnt_prefetch, cnt_new_prefetch, num_hit, num_miss);
+    ASSERT(proc_id, !complete || useful || unuseful);
+  });
   fclose(fp);
 
-  cnt_learned_cl = &per_core_cnt_useful_signed[proc_id];
   fp = fopen("per_line_icache_line_info_after_warmup.csv", "w");
   fprintf(fp, "cl_addr,useful_cnt,unuseful_cnt,prefetch_cnt,new_prefetch_cnt,icache_hit,icache_miss\n");
-  for(auto it = cnt_learned_cl->begin(); it != cnt_learned_cl->end(); ++it) {
-    auto cnt_useful_iter = per_core_cnt_useful_aw[proc_id].find(it->first);
-    auto cnt_unuseful_iter = per_core_cnt_unuseful_aw[proc_id].find(it->first);
-    auto cnt_prefetch_iter = per_core_prefetched_cls_aw[proc_id].find(it->first);
-    auto cnt_new_prefetch_iter = per_core_new_prefetched_cls_aw[proc_id].find(it->first);
-    auto hit_iter = per_core_icache_hit_aw[proc_id].find(it->first);
-    auto miss_iter = per_core_icache_miss_aw[proc_id].find(it->first);
-    Counter cnt_useful = (cnt_useful_iter != per_core_cnt_useful_aw[proc_id].end())? cnt_useful_iter->second.first : 0;
-    Counter cnt_unuseful = (cnt_unuseful_iter != per_core_cnt_unuseful_aw[proc_id].end())? cnt_unuseful_iter->second : 0;
-    Counter cnt_prefetch = (cnt_prefetch_iter != per_core_prefetched_cls_aw[proc_id].end())? cnt_prefetch_iter->second : 0;
-    Counter cnt_new_prefetch = (cnt_new_prefetch_iter != per_core_new_prefetched_cls_aw[proc_id].end())? cnt_new_prefetch_iter->second : 0;
-    Counter num_hit = (hit_iter != per_core_icache_hit_aw[proc_id].end())? hit_iter->second : 0;
-    Counter num_miss = (miss_iter != per_core_icache_miss_aw[proc_id].end())? miss_iter->second : 0;
+  per_core_cnt_useful_signed[proc_id].for_each([&](Addr line_addr, int32_t&) {
+    std::pair<Counter, Flag>* useful = per_core_cnt_useful_aw[proc_id].find(line_addr);
+    Counter* unuseful = per_core_cnt_unuseful_aw[proc_id].find(line_addr);
+    Counter* prefetch = per_core_prefetched_cls_aw[proc_id].find(line_addr);
+    Counter* new_prefetch = per_core_new_prefetched_cls_aw[proc_id].find(line_addr);
+    Counter* hit = per_core_icache_hit_aw[proc_id].find(line_addr);
+    Counter* miss = per_core_icache_miss_aw[proc_id].find(line_addr);
+    Counter cnt_useful = useful ? useful->first : 0;
+    Counter cnt_unuseful = unuseful ? *unuseful : 0;
+    Counter cnt_prefetch = prefetch ? *prefetch : 0;
+    Counter cnt_new_prefetch = new_prefetch ? *new_prefetch : 0;
+    Counter num_hit = hit ? *hit : 0;
+    Counter num_miss = miss ? *miss : 0;
     if (cnt_useful != 0 || cnt_unuseful != 0)
-      fprintf(fp, "%llx,%llu,%llu,%llu,%llu,%llu,%llu\n", it->first, cnt_useful, cnt_unuseful, cnt_prefetch, cnt_new_prefetch, num_hit, num_miss);
-  }
-  fclose(fp);
-
-  std::unordered_map<Addr, std::vector<uns8>>* useful_seq = &per_core_useful_sequence[proc_id];
-  fp = fopen("per_line_useful_seq.csv", "w");
-  fprintf(fp, "cl_addr,seq\n");
-  for(auto it = useful_seq->begin(); it != useful_seq->end(); ++it) {
-    fprintf(fp, "%llx", it->first);
-    for(auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
-      fprintf(fp, ",%u", *it2);
-    }
-    fprintf(fp, "\n");
-  }
+      fprintf(fp, "%llx,%llu,%llu,%llu,%llu,%llu,%llu\n", line_addr, cnt_useful, cnt_unuseful, cnt_prefetch, cnt_new_prefetch, num_hit, num_miss);
+  });
   fclose(fp);
 
-  std::unordered_map<Addr, std::vector<uns8>>* icache_seq = &per_core_icache_sequence[proc_id];
-  fp = fopen("per_line_icache_seq.csv", "w");
-  fprintf(fp, "cl_addr,seq\n");
-  for(auto it = icache_seq->begin(); it != icache_seq->end(); ++it) {
-    fprintf(fp, "%llx", it->first);
-    for(auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
-      fprintf(fp, ",%u", *it2);
-    }
-    fprintf(fp, "\n");
-  }
-  fclose(fp);
-
-  std::unordered_map<Addr, std::vector<std::pair<char,Counter>>>* seq = &per_core_sequence_aw[proc_id];
-  fp = fopen("per_line_seq_aw.csv", "w");
-  fprintf(fp, "cl_addr,seq\n");
-  for(auto it = seq->begin(); it != seq->end(); ++it) {
-    fprintf(fp, "%llx", it->first);
-    if (it->second.size() == 2) {
-      auto it2 = it->second.begin();
-      if (it2++->first == 'P' && it2->first == 'u')
-        STAT_EVENT(proc_id, FDIP_PREFETCH_EVICT_NO_HIT_ONLY_ONCE);
-    }
-    for(auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
-      fprintf(fp, ",%c", it2->first);
-    }
-    fprintf(fp, "\n");
-    for(auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
-      fprintf(fp, ",%lld", it2->second);
-    }
-    fprintf(fp, "\n");
-  }
-  fclose(fp);
+  per_core_sequence_aw[proc_id].for_each([&](Addr, Seq_Summary& summary) {
+    if (summary.length == 2 && summary.first[0] == 'P' && summary.first[1] == 'u')
+      STAT_EVENT(proc_id, FDIP_PREFETCH_EVICT_NO_HIT_ONLY_ONCE);
+  });
 
-  std::map<Addr, Counter>* per_line_delay = &per_core_per_line_delay_aw[proc_id];
-  std::multimap<Counter, Addr> per_line_delay_sorted = flip_map(*per_line_delay);
+  if (FDIP_STREAM_LINE_HISTORY) {
+    // the sequences are already on disk
+    fflush(per_core_line_history_stream[proc_id]);
+  } else {
+    fp = fopen("per_line_useful_seq.csv", "w");
+    print_line_history(fp, &per_core_useful_sequence[proc_id]);
+    fclose(fp);
+
+    fp = fopen("per_line_icache_seq.csv", "w");
+    print_line_history(fp, &per_core_icache_sequence[proc_id]);
+    fclose(fp);
+
+    Line_History<std::pair<char,Counter>>* seq = &per_core_sequence_aw_hist[proc_id];
+    fp = fopen("per_line_seq_aw.csv", "w");
+    fprintf(fp, "cl_addr,seq\n");
+    seq->for_each_line([&](Addr line_addr) {
+      fprintf(fp, "%llx", line_addr);
+      seq->for_each_event(line_addr, [&](const std::pair<char,Counter>& event) { fprintf(fp, ",%c", event.first); });
+      fprintf(fp, "\n");
+      seq->for_each_event(line_addr, [&](const std::pair<char,Counter>& event) { fprintf(fp, ",%lld", event.second); });
+      fprintf(fp, "\n");
+    });
+    fclose(fp);
+  }
+
+  std::vector<std::pair<Counter, Addr>> per_line_delay_sorted = sort_by_count(&per_core_per_line_delay_aw[proc_id]);
   fp = fopen("per_line_delay.csv", "w");
   fprintf(fp, "cl_addr,delay\n");
-  for(std::multimap<Counter, Addr>::const_iterator it = per_line_delay_sorted.begin();
-      it != per_line_delay_sorted.end(); ++it) {
+  for(auto it = per_line_delay_sorted.begin(); it != per_line_delay_sorted.end(); ++it) {
     fprintf(fp, "%llx,%lld\n", it->second, it->first);
   }
   fclose(fp);
 }
 
 void inc_cnt_useful(uns proc_id, Addr line_addr, Flag pref_miss) {
-  auto useful_iter = per_core_cnt_useful[proc_id].find(line_addr);
-  DEBUG(proc_id, "cnt_useful size %ld\n", per_core_cnt_useful[proc_id].size());
-  if (useful_iter == per_core_cnt_useful[proc_id].end()) {
+  Flag inserted = FALSE;
+  DEBUG(proc_id, "cnt_useful size %u\n", per_core_cnt_useful[proc_id].size());
+  std::pair<Counter, Flag>* useful = line_table_insert(proc_id, &per_core_cnt_useful[proc_id], line_addr, std::make_pair((Counter)0, pref_miss), &inserted);
+  if (inserted) {
     DEBUG(proc_id, "%llx useful line new insert\n", line_addr);
     STAT_EVENT(proc_id, ICACHE_USEFUL_FETCHES);
-    per_core_cnt_useful[proc_id].insert(std::make_pair(std::move(line_addr), std::make_pair(1, pref_miss)));
-  } else {
-    useful_iter->second.first++;
-    useful_iter->second.second = pref_miss;
   }
-  DEBUG(proc_id, "cnt_useful size after inserted %ld\n", per_core_cnt_useful[proc_id].size());
+  if (useful) {
+    useful->first++;
+    useful->second = pref_miss;
+  }
+  DEBUG(proc_id, "cnt_useful size after inserted %u\n", per_core_cnt_useful[proc_id].size());
 
   if (per_core_warmed_up[proc_id]) {
-    auto it = per_core_cnt_useful_aw[proc_id].find(line_addr);
-    if (it == per_core_cnt_useful_aw[proc_id].end())
-      per_core_cnt_useful_aw[proc_id].insert(std::make_pair(std::move(line_addr), std::make_pair(1, pref_miss)));
-    else {
-      it->second.first++;
-      it->second.second = pref_miss;
-    }
-
-    auto it2 = per_core_sequence_aw[proc_id].find(line_addr);
-    if (it2 == per_core_sequence_aw[proc_id].end()) {
-      per_core_sequence_aw[proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_aw[proc_id][line_addr].push_back(std::make_pair('U',cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('U',cycle_count));
-    }
-  } else {
-    auto iter = per_core_sequence_bw[proc_id].find(line_addr);
-    if (iter == per_core_sequence_bw[proc_id].end()) {
-      per_core_sequence_bw[proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_bw[proc_id][line_addr].push_back(std::make_pair('U',cycle_count));
-    } else {
-      iter->second.push_back(std::make_pair('U',cycle_count));
+    std::pair<Counter, Flag>* useful_aw = line_table_insert(proc_id, &per_core_cnt_useful_aw[proc_id], line_addr, std::make_pair((Counter)0, pref_miss));
+    if (useful_aw) {
+      useful_aw->first++;
+      useful_aw->second = pref_miss;
     }
   }
+  add_seq(proc_id, line_addr, 'U', cycle_count);
 }
 
 void inc_cnt_unuseful(uns proc_id, Addr line_addr) {
   if (FDIP_BLOOM_FILTER)
     per_core_bloom_filter[proc_id].cnt_unuseful++;
-  auto unuseful_iter = per_core_cnt_unuseful[proc_id].find(line_addr);
-  if (unuseful_iter == per_core_cnt_unuseful[proc_id].end()) {
+  Flag inserted = FALSE;
+  Counter* unuseful = line_table_insert(proc_id, &per_core_cnt_unuseful[proc_id], line_addr, 0, &inserted);
+  if (inserted)
     STAT_EVENT(proc_id, ICACHE_UNUSEFUL_FETCHES);
-    per_core_cnt_unuseful[proc_id].insert(std::make_pair(std::move(line_addr), 1));
-  } else {
-    unuseful_iter->second++;
-  }
+  if (unuseful)
+    (*unuseful)++;
 
   if (per_core_warmed_up[proc_id]) {
-    auto it = per_core_cnt_unuseful_aw[proc_id].find(line_addr);
-    if (it == per_core_cnt_unuseful_aw[proc_id].end())
-      per_core_cnt_unuseful_aw[proc_id].insert(std::make_pair(std::move(line_addr), 1));
-    else
-      it->second++;
-
-    auto it2 = per_core_sequence_aw[proc_id].find(line_addr);
-    if (it2 == per_core_sequence_aw[proc_id].end()) {
-      per_core_sequence_aw[proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_aw[proc_id][line_addr].push_back(std::make_pair('u',cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('u',cycle_count));
-    }
-  } else {
-    auto it2 = per_core_sequence_bw[proc_id].find(line_addr);
-    if (it2 == per_core_sequence_bw[proc_id].end()) {
-      per_core_sequence_bw[proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_bw[proc_id][line_addr].push_back(std::make_pair('u',cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('u',cycle_count));
-    }
+    Counter* unuseful_aw = line_table_insert(proc_id, &per_core_cnt_unuseful_aw[proc_id], line_addr, 0);
+    if (unuseful_aw)
+      (*unuseful_aw)++;
   }
+  add_seq(proc_id, line_addr, 'u', cycle_count);
 }
 
 void inc_cnt_useful_signed(uns proc_id, Addr line_addr) {
-  auto it = per_core_cnt_useful_signed[proc_id].find(line_addr);
-  if (it == per_core_cnt_useful_signed[proc_id].end())
-    per_core_cnt_useful_signed[proc_id].insert(std::pair<Addr, int64_t>(line_addr, UDP_USEFUL_THRESHOLD+UDP_WEIGHT_USEFUL));
-  else if (it->second + UDP_WEIGHT_USEFUL <= UDP_WEIGHT_POSITIVE_SATURATION)
-    it->second += UDP_WEIGHT_USEFUL;
+  Flag inserted = FALSE;
+  int32_t* cnt = line_table_insert(proc_id, &per_core_cnt_useful_signed[proc_id], line_addr, UDP_USEFUL_THRESHOLD+UDP_WEIGHT_USEFUL, &inserted);
+  if (cnt && !inserted && *cnt + UDP_WEIGHT_USEFUL <= UDP_WEIGHT_POSITIVE_SATURATION)
+    *cnt += UDP_WEIGHT_USEFUL;
 
   uns8 useful_value = per_core_warmed_up[proc_id]? 3 : 1;
-  auto it2 = per_core_useful_sequence[proc_id].find(line_addr);
-  if (it2 == per_core_useful_sequence[proc_id].end()) {
-    per_core_useful_sequence[proc_id].insert(std::make_pair(line_addr, std::vector<uns8>()));
-    per_core_useful_sequence[proc_id][line_addr].push_back(useful_value);
-  } else {
-    it2->second.push_back(useful_value);
-  }
+  add_line_event(proc_id, &per_core_useful_sequence[proc_id], "useful", line_addr, useful_value);
 }
 
 void dec_cnt_useful_signed(uns proc_id, Addr line_addr) {
-  auto it = per_core_cnt_useful_signed[proc_id].find(line_addr);
-  if (it == per_core_cnt_useful_signed[proc_id].end())
-    per_core_cnt_useful_signed[proc_id].insert(std::pair<Addr, int64_t>(line_addr, UDP_USEFUL_THRESHOLD-UDP_WEIGHT_UNUSEFUL));
-  else
-    it->second -= UDP_WEIGHT_UNUSEFUL;
+  Flag inserted = FALSE;
+  int32_t* cnt = line_table_insert(proc_id, &per_core_cnt_useful_signed[proc_id], line_addr, UDP_USEFUL_THRESHOLD-UDP_WEIGHT_UNUSEFUL, &inserted);
+  if (cnt && !inserted)
+    *cnt -= UDP_WEIGHT_UNUSEFUL;
 
   uns8 unuseful_value = per_core_warmed_up[proc_id]? 2 : 0;
-  auto it2 = per_core_useful_sequence[proc_id].find(line_addr);
-  if (it2 == per_core_useful_sequence[proc_id].end()) {
-    per_core_useful_sequence[proc_id].insert(std::make_pair(line_addr, std::vector<uns8>()));
-    per_core_useful_sequence[proc_id][line_addr].push_back(unuseful_value);
-  } else {
-    it2->second.push_back(unuseful_value);
-  }
+  add_line_event(proc_id, &per_core_useful_sequence[proc_id], "useful", line_addr, unuseful_value);
 }
 
 void inc_cnt_useful_ret(uns proc_id, Addr line_addr) {
-  auto useful_iter = per_core_cnt_useful_ret[proc_id].find(line_addr);
-  if (useful_iter == per_core_cnt_useful_ret[proc_id].end()) {
+  Flag inserted = FALSE;
+  Counter* useful = line_table_insert(proc_id, &per_core_cnt_useful_ret[proc_id], line_addr, 0, &inserted);
+  if (inserted)
     STAT_EVENT(proc_id, USEFUL_CACHELINES_RETIRED);
-    per_core_cnt_useful_ret[proc_id].insert(std::pair<Addr, Counter>(line_addr, 1));
-  }
-  else
-    useful_iter->second++;
+  if (useful)
+    (*useful)++;
 }
 
 void inc_icache_miss(uns proc_id, Addr line_addr) {
-
-  auto cl_iter = per_core_icache_miss[proc_id].find(line_addr);
-  if (cl_iter == per_core_icache_miss[proc_id].end()) {
+  Flag inserted = FALSE;
+  Counter* miss = line_table_insert(proc_id, &per_core_icache_miss[proc_id], line_addr, 0, &inserted);
+  if (inserted)
     STAT_EVENT(proc_id, UNIQUE_MISSED_LINES);
-    per_core_icache_miss[proc_id].insert(std::pair<Addr, Counter>(line_addr, 1));
-  }
-  else
-    cl_iter->second++;
+  if (miss)
+    (*miss)++;
+  // first hit or miss of this line
+  Flag first_icache_access = inserted && !per_core_icache_hit[proc_id].find(line_addr);
 
   if (per_core_warmed_up[proc_id]) {
-    auto it = per_core_icache_miss_aw[proc_id].find(line_addr);
-    if (it == per_core_icache_miss_aw[proc_id].end())
-      per_core_icache_miss_aw[proc_id].insert(std::pair<Addr, Counter>(line_addr, 1));
-    else
-      it->second++;
-
-    auto it2 = per_core_sequence_aw[proc_id].find(line_addr);
-    if (it2 == per_core_sequence_aw[proc_id].end()) {
-      per_core_sequence_aw[proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_aw[proc_id][line_addr].push_back(std::make_pair('m',cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('m',cycle_count));
-    }
-
+    Counter* miss_aw = line_table_insert(proc_id, &per_core_icache_miss_aw[proc_id], line_addr, 0);
+    if (miss_aw)
+      (*miss_aw)++;
     per_core_cur_line_delay[proc_id] = cycle_count;
-  } else {
-    auto it2 = per_core_sequence_bw[proc_id].find(line_addr);
-    if (it2 == per_core_sequence_bw[proc_id].end()) {
-      per_core_sequence_bw[proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_bw[proc_id][line_addr].push_back(std::make_pair('m',cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('m',cycle_count));
-    }
   }
+  add_seq(proc_id, line_addr, 'm', cycle_count);
 
   uns icache_val = per_core_warmed_up[proc_id]? 2 : 0;
-  auto it = per_core_icache_sequence[proc_id].find(line_addr);
-  if (it == per_core_icache_sequence[proc_id].end()) {
-    per_core_icache_sequence[proc_id].insert(std::make_pair(line_addr, std::vector<uns8>()));
-    per_core_icache_sequence[proc_id][line_addr].push_back(icache_val);
-    if (icache_val == 2) {
-      auto it2 = per_core_sequence_bw[proc_id].find(line_addr);
-      if (it2 != per_core_sequence_bw[proc_id].end()) {
-        STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_SEEN_DURING_WARMUP);
-        Counter no_pref = 0;
-        Counter unuseful = 0;
-        Counter useful = 0;
-        auto it3 = it2->second.begin();
-        while(it3 != it2->second.end()) {
-          if (it3->first == 'p')
-            no_pref++;
-          else if (it3->first == 'u')
-            useful++;
-          else if (it3->first == 'U')
-            unuseful++;
-          ++it3;
-        }
-        if (no_pref && !unuseful && !useful)
-          STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_NO_PREF_DURING_WARMUP);
-        if (!no_pref && unuseful && !useful)
-          STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_TRAINED_UNUSEFUL_DURING_WARMUP);
-        if (!no_pref && !unuseful && useful)
-          STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_TRAINED_USEFUL_DURING_WARMUP);
-      } else
-        STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_NOT_SEEN_DURING_WARMUP);
-    }
-  } else {
-    it->second.push_back(icache_val);
+  add_line_event(proc_id, &per_core_icache_sequence[proc_id], "icache", line_addr, icache_val);
+  if (first_icache_access && icache_val == 2) {
+    Seq_Summary* summary = per_core_sequence_bw[proc_id].find(line_addr);
+    if (summary) {
+      STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_SEEN_DURING_WARMUP);
+      Counter no_pref = summary->cnt_p;
+      Counter unuseful = summary->cnt_U;
+      Counter useful = summary->cnt_u;
+      if (no_pref && !unuseful && !useful)
+        STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_NO_PREF_DURING_WARMUP);
+      if (!no_pref && unuseful && !useful)
+        STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_TRAINED_UNUSEFUL_DURING_WARMUP);
+      if (!no_pref && !unuseful && useful)
+        STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_TRAINED_USEFUL_DURING_WARMUP);
+    } else
+      STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_NOT_SEEN_DURING_WARMUP);
   }
 }
 
@@ -956,139 +945,101 @@ void inc_prefetched_cls(Addr line_addr, uns success) {
   if (!FDIP_BP_CONFIDENCE && !fdip_off_path(fdip_proc_id))
     on_path = TRUE;
 
-  auto cl_iter = per_core_prefetched_cls[fdip_proc_id].find(line_addr);
-  if (cl_iter == per_core_prefetched_cls[fdip_proc_id].end()) {
-    per_core_prefetched_cls[fdip_proc_id].insert(std::pair<Addr, Counter>(line_addr, 1));
-    per_core_prefetched_cls_info[fdip_proc_id].insert(std::make_pair(std::move(line_addr), std::make_pair(std::make_pair(std::move(cycle_count), on_path), std::make_pair(0, 0))));
+  Flag inserted = FALSE;
+  Counter* prefetched = line_table_insert(fdip_proc_id, &per_core_prefetched_cls[fdip_proc_id], line_addr, 0, &inserted);
+  if (inserted) {
+    (*prefetched)++;
+    line_table_insert(fdip_proc_id, &per_core_prefetched_cls_info[fdip_proc_id], line_addr,
+                      std::make_pair(std::make_pair(cycle_count, on_path), std::make_pair((Counter)0, (Counter)0)));
     DEBUG(fdip_proc_id, "%llx inserted into prefetched_cls at %llu\n", line_addr, cycle_count);
-  } else {
-    cl_iter->second++;
-    auto cl_info_iter = per_core_prefetched_cls_info[fdip_proc_id].find(line_addr);
-    ASSERT(fdip_proc_id, cl_info_iter != per_core_prefetched_cls_info[fdip_proc_id].end());
-    cl_info_iter->second.first.first = cycle_count;
-    cl_info_iter->second.first.second = on_path;
-    DEBUG(fdip_proc_id, "%llx updated with cnt %llu in prefetched_cls at cyc %llu\n", line_addr, cl_iter->second, cycle_count);
+  } else if (prefetched) {
+    (*prefetched)++;
+    auto cl_info = per_core_prefetched_cls_info[fdip_proc_id].find(line_addr);
+    ASSERT(fdip_proc_id, cl_info);
+    cl_info->first.first = cycle_count;
+    cl_info->first.second = on_path;
+    DEBUG(fdip_proc_id, "%llx updated with cnt %llu in prefetched_cls at cyc %llu\n", line_addr, *prefetched, cycle_count);
   }
 
   if (success == Mem_Queue_Req_Result::SUCCESS_NEW) {
-    auto cl_new_iter = per_core_new_prefetched_cls[fdip_proc_id].find(line_addr);
-    if (cl_new_iter == per_core_new_prefetched_cls[fdip_proc_id].end())
-      per_core_new_prefetched_cls[fdip_proc_id].insert(std::pair<Addr, Counter>(line_addr, 1));
-    else
-      cl_new_iter->second++;
+    Counter* new_prefetched = line_table_insert(fdip_proc_id, &per_core_new_prefetched_cls[fdip_proc_id], line_addr, 0);
+    if (new_prefetched)
+      (*new_prefetched)++;
   }
 
   if (per_core_warmed_up[fdip_proc_id]) {
-    auto it = per_core_prefetched_cls_aw[fdip_proc_id].find(line_addr);
-    if (it == per_core_prefetched_cls_aw[fdip_proc_id].end())
-      per_core_prefetched_cls_aw[fdip_proc_id].insert(std::pair<Addr, Counter>(line_addr, 1));
-    else
-      it->second++;
+    Counter* prefetched_aw = line_table_insert(fdip_proc_id, &per_core_prefetched_cls_aw[fdip_proc_id], line_addr, 0);
+    if (prefetched_aw)
+      (*prefetched_aw)++;
 
     if (success == Mem_Queue_Req_Result::SUCCESS_NEW) {
-      it = per_core_new_prefetched_cls_aw[fdip_proc_id].find(line_addr);
-      if (it == per_core_new_prefetched_cls_aw[fdip_proc_id].end())
-        per_core_new_prefetched_cls_aw[fdip_proc_id].insert(std::pair<Addr, Counter>(line_addr, 1));
-      else
-        it->second++;
-    }
-
-    auto it2 = per_core_sequence_aw[fdip_proc_id].find(line_addr);
-    Counter onoff_cycle_count = fdip_off_path(fdip_proc_id)? -cycle_count : cycle_count;
-    if (it2 == per_core_sequence_aw[fdip_proc_id].end()) {
-      per_core_sequence_aw[fdip_proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_aw[fdip_proc_id][line_addr].push_back(std::make_pair('P',onoff_cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('P',onoff_cycle_count));
-    }
-  } else {
-    auto it2 = per_core_sequence_bw[fdip_proc_id].find(line_addr);
-    Counter onoff_cycle_count = fdip_off_path(fdip_proc_id)? -cycle_count : cycle_count;
-    if (it2 == per_core_sequence_bw[fdip_proc_id].end()) {
-      per_core_sequence_bw[fdip_proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_bw[fdip_proc_id][line_addr].push_back(std::make_pair('P',onoff_cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('P',onoff_cycle_count));
+      Counter* new_prefetched_aw = line_table_insert(fdip_proc_id, &per_core_new_prefetched_cls_aw[fdip_proc_id], line_addr, 0);
+      if (new_prefetched_aw)
+        (*new_prefetched_aw)++;
     }
   }
+  Counter onoff_cycle_count = fdip_off_path(fdip_proc_id)? -cycle_count : cycle_count;
+  add_seq(fdip_proc_id, line_addr, 'P', onoff_cycle_count);
 }
 
 void not_prefetch(Addr line_addr) {
-  if (per_core_warmed_up[fdip_proc_id]) {
-    auto it = per_core_sequence_aw[fdip_proc_id].find(line_addr);
-    Counter onoff_cycle_count = fdip_off_path(fdip_proc_id)? -cycle_count : cycle_count;
-    if (it == per_core_sequence_aw[fdip_proc_id].end()) {
-      per_core_sequence_aw[fdip_proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_aw[fdip_proc_id][line_addr].push_back(std::make_pair('p',onoff_cycle_count));
-    } else {
-      it->second.push_back(std::make_pair('p',onoff_cycle_count));
-    }
-  } else {
-    auto it = per_core_sequence_bw[fdip_proc_id].find(line_addr);
-    Counter onoff_cycle_count = fdip_off_path(fdip_proc_id)? -cycle_count : cycle_count;
-    if (it == per_core_sequence_bw[fdip_proc_id].end()) {
-      per_core_sequence_bw[fdip_proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_bw[fdip_proc_id][line_addr].push_back(std::make_pair('p',onoff_cycle_count));
-    } else {
-      it->second.push_back(std::make_pair('p',onoff_cycle_count));
-    }
-  }
+  Counter onoff_cycle_count = fdip_off_path(fdip_proc_id)? -cycle_count : cycle_count;
+  add_seq(fdip_proc_id, line_addr, 'p', onoff_cycle_count);
 }
 
 void inc_off_fetched_cls(Addr line_addr) {
-  auto cl_iter = per_core_off_fetched_cls[fdip_proc_id].find(line_addr);
-  if (cl_iter == per_core_off_fetched_cls[fdip_proc_id].end()) {
-    per_core_off_fetched_cls[fdip_proc_id].insert(std::pair<Addr, Counter>(line_addr, cycle_count));
+  Flag inserted = FALSE;
+  Counter* fetched_cycle = line_table_insert(fdip_proc_id, &per_core_off_fetched_cls[fdip_proc_id], line_addr, cycle_count, &inserted);
+  if (inserted) {
     DEBUG(fdip_proc_id, "%llx inserted into off_fetched_cls at %llu\n", line_addr, cycle_count);
-  } else {
-    cl_iter->second = cycle_count;
+  } else if (fetched_cycle) {
+    *fetched_cycle = cycle_count;
     DEBUG(fdip_proc_id, "%llx in off_fetched_cls updated at %llu\n", line_addr, cycle_count);
   }
 }
 
 void probe_prefetched_cls(Addr line_addr) {
-  auto cl_iter = per_core_prefetched_cls_info[fdip_proc_id].find(line_addr);
-  if (cl_iter != per_core_prefetched_cls_info[fdip_proc_id].end())
-    cl_iter->second.first.first = cycle_count;
+  auto cl_info = per_core_prefetched_cls_info[fdip_proc_id].find(line_addr);
+  if (cl_info)
+    cl_info->first.first = cycle_count;
 }
 
 void evict_prefetched_cls(uns proc_id, Addr line_addr, Flag by_fdip) {
-  auto cl_iter = per_core_prefetched_cls_info[proc_id].find(line_addr);
-  if (cl_iter != per_core_prefetched_cls_info[proc_id].end()) {
+  auto cl_info = per_core_prefetched_cls_info[proc_id].find(line_addr);
+  if (cl_info) {
     if (by_fdip) {
-      cl_iter->second.second.first = 0;
-      cl_iter->second.second.second = cycle_count;
+      cl_info->second.first = 0;
+      cl_info->second.second = cycle_count;
     } else {
-      cl_iter->second.second.first = cycle_count;
-      cl_iter->second.second.second = 0;
+      cl_info->second.first = cycle_count;
+      cl_info->second.second = 0;
     }
   }
 }
 
 uns get_miss_reason(uns proc_id, Addr line_addr) {
-  auto cl_iter = per_core_prefetched_cls_info[proc_id].find(line_addr);
-  if (cl_iter == per_core_prefetched_cls_info[proc_id].end()) {
-    auto tmp_iter = per_core_prefetched_cls[proc_id].find(line_addr);
+  auto cl_info = per_core_prefetched_cls_info[proc_id].find(line_addr);
+  if (!cl_info) {
     DEBUG(proc_id, "%llx misses due to 'not prefetched ever'\n", line_addr);
-    ASSERT(proc_id, tmp_iter == per_core_prefetched_cls[proc_id].end());
+    ASSERT(proc_id, !per_core_prefetched_cls[proc_id].find(line_addr));
     return Imiss_Reason::IMISS_NOT_PREFETCHED;
   }
-  if (cl_iter->second.first.first < per_core_last_recover_cycle[proc_id]) {
+  if (cl_info->first.first < per_core_last_recover_cycle[proc_id]) {
     DEBUG(proc_id, "%llx misses due to 'not prefetched after last recover cycle'\n", line_addr);
     return Imiss_Reason::IMISS_NOT_PREFETCHED;
   }
 
-  if (cl_iter->second.first.first >= per_core_last_recover_cycle[proc_id]) {
-   if (cl_iter->second.second.first > cl_iter->second.first.first) {
+  if (cl_info->first.first >= per_core_last_recover_cycle[proc_id]) {
+   if (cl_info->second.first > cl_info->first.first) {
     DEBUG(proc_id, "%llx misses due to 'prefetched but evicted by a demand load'\n", line_addr);
     return Imiss_Reason::IMISS_TOO_EARLY_EVICTED_BY_IFETCH;
-   } else if (cl_iter->second.second.second > cl_iter->second.first.first) {
+   } else if (cl_info->second.second > cl_info->first.first) {
     DEBUG(proc_id, "%llx misses due to 'prefetched but evicted by FDIP'\n", line_addr);
     return Imiss_Reason::IMISS_TOO_EARLY_EVICTED_BY_FDIP;
    }
   }
 
-  if (cl_iter->second.first.second) {
+  if (cl_info->first.second) {
     DEBUG(proc_id, "%llx misses due to 'MSHR hit prefetched on path'\n", line_addr);
     return Imiss_Reason::IMISS_MSHR_HIT_PREFETCHED_ONPATH;
   }
@@ -1125,9 +1076,7 @@ static inline void determine_usefulness_by_inf_hash(Addr line_addr, Flag* emit_n
   } else {
     switch(FDIP_UTILITY_PREF_POLICY) {
       case Utility_Pref_Policy::PREF_CONV_FROM_USEFUL_SET: {
-        std::unordered_map<Addr, std::pair<Counter, Flag>>* cnt_useful = &per_core_cnt_useful[fdip_proc_id];
-        auto iter = cnt_useful->find(hashed_line_addr);
-        if (iter == cnt_useful->end()) {
+        if (!per_core_cnt_useful[fdip_proc_id].find(hashed_line_addr)) {
           *emit_new_prefetch = FALSE;
 	      }
         else {
@@ -1136,9 +1085,7 @@ static inline void determine_usefulness_by_inf_hash(Addr line_addr, Flag* emit_n
         break;
       }
       case Utility_Pref_Policy::PREF_OPT_FROM_UNUSEFUL_SET: {
-        std::unordered_map<Addr, Counter>* cnt_unuseful = &per_core_cnt_unuseful[fdip_proc_id];
-        auto iter = cnt_unuseful->find(hashed_line_addr);
-        if (iter == cnt_unuseful->end())
+        if (!per_core_cnt_unuseful[fdip_proc_id].find(hashed_line_addr))
           *emit_new_prefetch = TRUE;
         else {
           *emit_new_prefetch = FALSE;
@@ -1146,9 +1093,8 @@ static inline void determine_usefulness_by_inf_hash(Addr line_addr, Flag* emit_n
         break;
       }
       case Utility_Pref_Policy::PREF_CONV_FROM_THROTTLE_CNT: {
-        std::unordered_map<Addr, int32_t>* cnt = &per_core_cnt_useful_signed[fdip_proc_id];
-        auto iter = cnt->find(hashed_line_addr);
-        if (iter != cnt->end() && iter->second > UDP_USEFUL_THRESHOLD)
+        int32_t* cnt = per_core_cnt_useful_signed[fdip_proc_id].find(hashed_line_addr);
+        if (cnt && *cnt > UDP_USEFUL_THRESHOLD)
           *emit_new_prefetch = TRUE;
         else {
           *emit_new_prefetch = FALSE;
@@ -1156,9 +1102,8 @@ static inline void determine_usefulness_by_inf_hash(Addr line_addr, Flag* emit_n
         break;
       }
       case Utility_Pref_Policy::PREF_OPT_FROM_THROTTLE_CNT: {
-        std::unordered_map<Addr, int32_t>* cnt = &per_core_cnt_useful_signed[fdip_proc_id];
-        auto iter = cnt->find(hashed_line_addr);
-        if (iter != cnt->end() && iter->second < UDP_USEFUL_THRESHOLD) {
+        int32_t* cnt = per_core_cnt_useful_signed[fdip_proc_id].find(hashed_line_addr);
+        if (cnt && *cnt < UDP_USEFUL_THRESHOLD) {
           *emit_new_prefetch = FALSE;
 	      }
 	      else
@@ -1463,7 +1408,7 @@ void update_useful_lines(uns proc_id, Op* op) {
     last_useful_cl_addr = useful_cl_addr;
     useful_cl_addr = ++fetch_addr & ~0x3F;
   }
-  per_core_last_bbl_start_addr[proc_id] = op->oracle_info.npc;
+  per_core_last_bbl_start_addr[proc_id] = OP_ORACLE(op).npc;
   DEBUG(proc_id, "last_bbl_start_addr: %llx\n", per_core_last_bbl_start_addr[proc_id]);
 }
 
@@ -1617,63 +1562,36 @@ void dec_useful_lines_uc(uns proc_id, Addr line_addr) {
 void assert_fdip_break_reason(uns proc_id, Addr line_addr) {
   if (!FDIP_UTILITY_HASH_ENABLE || (FDIP_UTILITY_PREF_POLICY != PREF_CONV_FROM_USEFUL_SET) || (FULL_WARMUP && !warmup_dump_done[proc_id]) || !FDIP_BP_PERFECT_CONFIDENCE)
     return;
-  auto useful_iter = per_core_cnt_useful[proc_id].find(line_addr);
-  if (useful_iter != per_core_cnt_useful[proc_id].end() && !useful_iter->second.second) { // learned from a seniority-FTQ hit
+  std::pair<Counter, Flag>* useful = per_core_cnt_useful[proc_id].find(line_addr);
+  if (useful && !useful->second) { // learned from a seniority-FTQ hit
     ASSERT(proc_id, per_core_last_break_reason[proc_id] == BR_FULL_MEM_REQ_BUF);
   }
 }
 
 void inc_icache_hit(uns proc_id, Addr line_addr) {
-  auto cl_iter = per_core_icache_hit[proc_id].find(line_addr);
-  if (cl_iter == per_core_icache_hit[proc_id].end()) {
+  Flag inserted = FALSE;
+  Counter* hit = line_table_insert(proc_id, &per_core_icache_hit[proc_id], line_addr, 0, &inserted);
+  if (inserted)
     STAT_EVENT(proc_id, UNIQUE_HIT_LINES);
-    per_core_icache_hit[proc_id].insert(std::pair<Addr, Counter>(line_addr, 1));
-  }
-  else
-    cl_iter->second++;
+  if (hit)
+    (*hit)++;
 
   if (per_core_warmed_up[proc_id]) {
-    auto it = per_core_icache_hit_aw[proc_id].find(line_addr);
-    if (it == per_core_icache_hit_aw[proc_id].end())
-      per_core_icache_hit_aw[proc_id].insert(std::pair<Addr, Counter>(line_addr, 1));
-    else
-      it->second++;
-
-    auto it2 = per_core_sequence_aw[proc_id].find(line_addr);
-    if (it2 == per_core_sequence_aw[proc_id].end()) {
-      per_core_sequence_aw[proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_aw[proc_id][line_addr].push_back(std::make_pair('h',cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('h',cycle_count));
-    }
+    Counter* hit_aw = line_table_insert(proc_id, &per_core_icache_hit_aw[proc_id], line_addr, 0);
+    if (hit_aw)
+      (*hit_aw)++;
 
     if (per_core_cur_line_delay[proc_id]) {
-      auto it3 = per_core_per_line_delay_aw[proc_id].find(line_addr);
-      if (it3 == per_core_per_line_delay_aw[proc_id].end()) {
-        per_core_per_line_delay_aw[proc_id].insert(std::make_pair(line_addr, cycle_count - per_core_cur_line_delay[proc_id]));
-      } else {
-        it3->second += cycle_count - per_core_cur_line_delay[proc_id];
-      }
+      Counter* delay = line_table_insert(proc_id, &per_core_per_line_delay_aw[proc_id], line_addr, 0);
+      if (delay)
+        *delay += cycle_count - per_core_cur_line_delay[proc_id];
     }
     per_core_cur_line_delay[proc_id] = 0;
-  } else {
-    auto it2 = per_core_sequence_bw[proc_id].find(line_addr);
-    if (it2 == per_core_sequence_bw[proc_id].end()) {
-      per_core_sequence_bw[proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_bw[proc_id][line_addr].push_back(std::make_pair('h',cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('h',cycle_count));
-    }
   }
+  add_seq(proc_id, line_addr, 'h', cycle_count);
 
   uns icache_val = per_core_warmed_up[proc_id]? 3 : 1;
-  auto it = per_core_icache_sequence[proc_id].find(line_addr);
-  if (it == per_core_icache_sequence[proc_id].end()) {
-    per_core_icache_sequence[proc_id].insert(std::make_pair(line_addr, std::vector<uns8>()));
-    per_core_icache_sequence[proc_id][line_addr].push_back(icache_val);
-  } else {
-    it->second.push_back(icache_val);
-  }
+  add_line_event(proc_id, &per_core_icache_sequence[proc_id], "icache", line_addr, icache_val);
 }
 
 void inc_br_conf_counters(int conf){
@@ -1735,7 +1653,7 @@ void inc_low_conf_ctr_(Op * op){
   per_core_low_confidence_cnt[fdip_proc_id] += 3 - op->bp_confidence + (double)FDIP_BTB_MISS_RATE_WEIGHT*per_core_btb_miss_rate[fdip_proc_id]; //3 is highest bp_confidence
   per_core_cf_op_distance[fdip_proc_id] = 0.0;
 
-  if(op->oracle_info.btb_miss){
+  if(OP_ORACLE(op).btb_miss){
     per_core_conf_info[fdip_proc_id].num_BTB_misses += 1;
   }
   inc_br_conf_counters(op->bp_confidence);
@@ -1754,7 +1672,7 @@ void default_conf_update(Op * op){
       per_core_low_confidence_cnt[fdip_proc_id] += 3 - op->bp_confidence + (double)FDIP_BTB_MISS_RATE_WEIGHT*per_core_btb_miss_rate[fdip_proc_id]; //3 is highest bp_confidence
       per_core_cf_op_distance[fdip_proc_id] = 0.0;
       //log stats
-      if(op->oracle_info.btb_miss){
+      if(OP_ORACLE(op).btb_miss){
         per_core_conf_info[fdip_proc_id].num_BTB_misses += 1;
       }
       inc_br_conf_counters(op->bp_confidence);
@@ -1776,7 +1694,7 @@ void btb_miss_bp_taken_conf_update(Op * op){
     return;
   if(per_core_low_confidence_cnt[fdip_proc_id] != ~0U){
     if (op->table_info->cf_type) {
-      if(op->oracle_info.btb_miss && op->oracle_info.pred_orig == TAKEN && (op->bp_confidence >= FDIP_BTB_MISS_BP_TAKEN_CONF_THRESHOLD)){
+      if(OP_ORACLE(op).btb_miss && OP_ORACLE(op).pred_orig == TAKEN && (op->bp_confidence >= FDIP_BTB_MISS_BP_TAKEN_CONF_THRESHOLD)){
         per_core_low_confidence_cnt[fdip_proc_id] = ~0U;
         if(!per_core_conf_info[fdip_proc_id].fdip_on_conf_off_event){
           switch(op->bp_confidence){
@@ -1802,7 +1720,7 @@ void btb_miss_bp_taken_conf_update(Op * op){
           per_core_conf_info[fdip_proc_id].conf_off_path_reason = REASON_INV_CONF_INC;
       }
       //log stats
-      if(op->oracle_info.btb_miss){
+      if(OP_ORACLE(op).btb_miss){
         per_core_conf_info[fdip_proc_id].num_BTB_misses += 1;
       }
       inc_br_conf_counters(op->bp_confidence);
@@ -1833,24 +1751,24 @@ void log_stats_bp_conf() {
         ASSERT(fdip_proc_id, conf_info->prev_op->table_info->cf_type); // must be a cf as the last on-path op
         conf_info->fdip_off_conf_on_event = true;
         STAT_EVENT(fdip_proc_id, FDIP_OFF_CONF_ON_NUM_EVENTS);
-        if (conf_info->prev_op->oracle_info.mispred) {
+        if (OP_ORACLE(conf_info->prev_op).mispred) {
           conf_info->off_path_reason = REASON_MISPRED;
           STAT_EVENT(fdip_proc_id, FDIP_OFF_CONF_ON_BP_INCORRECT);
           STAT_EVENT(fdip_proc_id, FDIP_OFF_CONF_ON_BP_INCORRECT_0_CONF + conf_info->prev_op->bp_confidence);
         }
         //if off path due to btb miss
-        else if (conf_info->prev_op->oracle_info.btb_miss) {
+        else if (OP_ORACLE(conf_info->prev_op).btb_miss) {
           conf_info->off_path_reason = REASON_BTB_MISS;
           STAT_EVENT(fdip_proc_id, FDIP_OFF_CONF_ON_BTB_MISS);
           STAT_EVENT(fdip_proc_id, FDIP_OFF_CONF_ON_BTB_MISS_NOT_CF + conf_info->prev_op->table_info->cf_type);
         }
         //if off path due to no target
-        else if (conf_info->prev_op->oracle_info.no_target) {
+        else if (OP_ORACLE(conf_info->prev_op).no_target) {
           conf_info->off_path_reason = REASON_NO_TARGET;
           STAT_EVENT(fdip_proc_id, FDIP_OFF_CONF_ON_NO_TARGET);
         }
         //if off path due to misfetch
-        else if (conf_info->prev_op->oracle_info.misfetch) {
+        else if (OP_ORACLE(conf_info->prev_op).misfetch) {
           conf_info->off_path_reason = REASON_MISFETCH;
           STAT_EVENT(fdip_proc_id, FDIP_OFF_CONF_ON_MISFETCH);
         }
@@ -1922,23 +1840,7 @@ void log_stats_bp_conf_emitted() {
 }
 
 void add_evict_seq(uns proc_id, Addr line_addr) {
-  if (per_core_warmed_up[proc_id]) {
-    auto it2 = per_core_sequence_aw[proc_id].find(line_addr);
-    if (it2 == per_core_sequence_aw[proc_id].end()) {
-      per_core_sequence_aw[proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_aw[proc_id][line_addr].push_back(std::make_pair('e',cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('e',cycle_count));
-    }
-  } else {
-    auto it2 = per_core_sequence_bw[proc_id].find(line_addr);
-    if (it2 == per_core_sequence_bw[proc_id].end()) {
-      per_core_sequence_bw[proc_id].insert(std::make_pair(line_addr, std::vector<std::pair<char,Counter>>()));
-      per_core_sequence_bw[proc_id][line_addr].push_back(std::make_pair('e',cycle_count));
-    } else {
-      it2->second.push_back(std::make_pair('e',cycle_count));
-    }
-  }
+  add_seq(proc_id, line_addr, 'e', cycle_count);
 }
 
 /* Returns a new computed FTQ depth based on the current utility ratio or/and timeliness ratio of
@@ -58,7 +58,7 @@
 /* Global Variables */
 
 extern Memory*       mem;
-extern Dcache_Stage* dc;
+extern SIM_THREAD_LOCAL Dcache_Stage* dc;
 static Cache*        l1_cache;
 
 /***************************************************************************************/
@@ -133,8 +133,7 @@ void l2l1pref_mem_process(Mem_Req_Info* req) {
 
   if(L1_HIT_DUMP_FILE_ON && (req->type == MRT_DFETCH)) {
     int l1_set = req->addr >> (l1_cache)->shift_bits & (l1_cache)->set_mask;
-    int dc_set = req->addr >> (&dc->dcache)->shift_bits &
-                 (&dc->dcache)->set_mask;
+    int dc_set = line_cache_set(dc->dcache, req->addr);
     if(!L1_HIT_DUMP_WO_TXT)
       fprintf(f_l1_hit,
               "op_uniq_no:%8s l *0x%10s va:0x%s li:%4s l1_set:%4d dc_set:%4d "
@@ -216,8 +215,7 @@ void l2l1pref_dcache(Addr line_addr, Op* op) {
     int  pref_req  = 0;
     Addr req_addr  = 0;
     int  l1_set    = line_addr >> (l1_cache)->shift_bits & (l1_cache)->set_mask;
-    int  dc_set    = line_addr >> (&dc->dcache)->shift_bits &
-                 (&dc->dcache)->set_mask;
+    int  dc_set    = line_cache_set(dc->dcache, line_addr);
 
     l2markv_pref(&tmp_req, &train_hit, &pref_req, &req_addr);
     if(L1_HIT_DUMP_FILE_ON) {
@@ -240,8 +238,8 @@ Dcache_Data* dc_pref_cache_access(Op* op) {
   Flag         data_hit       = FALSE;
   Dcache_Data* old_data       = NULL;
 
-  Dcache_Data* data = (Dcache_Data*)cache_access(
-    &dc->pref_dcache, op->oracle_info.va, &pref_line_addr, FALSE);
+  Dcache_Data* data = (Dcache_Data*)line_cache_access(
+    dc->pref_dcache, OP_ORACLE(op).va, &pref_line_addr, FALSE);
 
   if(data && (!PREF_CACHE_USE_RDY_CYCLE || (data->rdy_cycle <= cycle_count)))
     data_hit = TRUE;
@@ -274,7 +272,7 @@ Dcache_Data* dc_pref_cache_access(Op* op) {
 
   if(DC_PREF_ONLY_L1HIT) {
     Addr     line_addr;
-    L1_Data* l1_data = (L1_Data*)cache_access(l1_cache, op->oracle_info.va,
+    L1_Data* l1_data = (L1_Data*)cache_access(l1_cache, OP_ORACLE(op).va,
                                               &line_addr, FALSE);
     if(!l1_data) {
       pref_cache_hit = FALSE;
@@ -299,14 +297,15 @@ Dcache_Data* dc_pref_cache_access(Op* op) {
 
   if(PREF_INSERT_DCACHE_IMM && pref_cache_hit) {
     Addr dcache_line_addr;
-    old_data = (Dcache_Data*)cache_insert(&dc->dcache, dc->proc_id,
-                                          op->oracle_info.va, &dcache_line_addr,
-                                          &repl_line_addr);
+    old_data = (Dcache_Data*)line_cache_insert(dc->dcache, dc->proc_id,
+                                               OP_ORACLE(op).va,
+                                               &dcache_line_addr,
+                                               &repl_line_addr);
 
     STAT_EVENT(0, DC_PREF_MOVE_DC);
     DEBUG(dc->proc_id, "pref_dcache fill dcache  addr:0x%s  :%7s index:%7s\n",
-          hexstr64s(op->oracle_info.va), unsstr64(op->oracle_info.va),
-          unsstr64((op->oracle_info.va) >> LOG2(DCACHE_LINE_SIZE)));
+          hexstr64s(OP_ORACLE(op).va), unsstr64(OP_ORACLE(op).va),
+          unsstr64((OP_ORACLE(op).va) >> LOG2(DCACHE_LINE_SIZE)));
 
     if(old_data->dirty) {
       DEBUG(dc->proc_id, "Scheduling writeback of addr:0x%s\n",
@@ -328,22 +327,22 @@ Dcache_Data* dc_pref_cache_access(Op* op) {
     // prefetcher if old_HW_prefetch is true
     old_data->HW_prefetch = data->HW_prefetch;
     /* line is invalidate */
-    cache_invalidate(&dc->pref_dcache, op->oracle_info.va, &pref_line_addr);
+    line_cache_invalidate(dc->pref_dcache, OP_ORACLE(op).va, &pref_line_addr);
 
     if(PREF_DCACHE_HIT_FILL_L1) {
       if(model->mem == MODEL_MEM) {
         Addr     line_addr;
-        L1_Data* l1_data = (L1_Data*)cache_access(l1_cache, op->oracle_info.va,
+        L1_Data* l1_data = (L1_Data*)cache_access(l1_cache, OP_ORACLE(op).va,
                                                   &line_addr, TRUE);
         if(!l1_data) {
           Mem_Req tmp_req;
-          tmp_req.addr     = op->oracle_info.va;
+          tmp_req.addr     = OP_ORACLE(op).va;
           tmp_req.op_count = 0;
           tmp_req.off_path = FALSE;
           DEBUG(dc->proc_id,
                 "pref_dcache request fill l1cache  addr:0x%s  :%7s index:%7s\n",
-                hexstr64s(op->oracle_info.va), unsstr64(op->oracle_info.va),
-                unsstr64((op->oracle_info.va) >> LOG2(DCACHE_LINE_SIZE)));
+                hexstr64s(OP_ORACLE(op).va), unsstr64(OP_ORACLE(op).va),
+                unsstr64((OP_ORACLE(op).va) >> LOG2(DCACHE_LINE_SIZE)));
 
           FATAL_ERROR(0, "This fill code is wrong. Writebacks may be lost.");
           l1_fill_line(&tmp_req);
@@ -354,7 +353,7 @@ Dcache_Data* dc_pref_cache_access(Op* op) {
   }
   if(pref_cache_hit) {
     DEBUG(dc->proc_id, "pref_dcache hit addr:0x%s \n",
-          hexstr64s(op->oracle_info.va));
+          hexstr64s(OP_ORACLE(op).va));
     STAT_EVENT(0, DC_PREF_CACHE_HIT_PER + op->off_path);
     STAT_EVENT(0, DC_PREF_CACHE_HIT + op->off_path);
   }
@@ -373,8 +372,8 @@ Flag dc_pref_cache_fill_line(Mem_Req* req) {
   Addr         addr = req->addr;
   Dcache_Data* old_data;
   Addr         line_addr, repl_line_addr;
-  old_data = (Dcache_Data*)cache_insert(&dc->pref_dcache, dc->proc_id, addr,
-                                        &line_addr, &repl_line_addr);
+  old_data = (Dcache_Data*)line_cache_insert(dc->pref_dcache, dc->proc_id,
+                                             addr, &line_addr, &repl_line_addr);
   old_data->rdy_cycle = cycle_count + DC_PREF_CACHE_CYCLE;
   DEBUG(dc->proc_id, "Filling pref_cache addr:0x%s :%8s index:%7s \n",
         hexstr64s(addr), unsstr64(addr),
@@ -386,11 +385,11 @@ Flag dc_pref_cache_fill_line(Mem_Req* req) {
 void dc_pref_cache_insert(Addr addr) {
   Addr line_addr, repl_line_addr;
 
-  Dcache_Data* data = (Dcache_Data*)cache_access(&dc->pref_dcache, addr,
-                                                 &line_addr, FALSE);
+  Dcache_Data* data = (Dcache_Data*)line_cache_access(dc->pref_dcache, addr,
+                                                      &line_addr, FALSE);
 
-  Dcache_Data* dc_data = (Dcache_Data*)cache_access(&dc->dcache, addr,
-                                                    &line_addr, FALSE);
+  Dcache_Data* dc_data = (Dcache_Data*)line_cache_access(dc->dcache, addr,
+                                                         &line_addr, FALSE);
 
   L1_Data* l1_data = (L1_Data*)cache_access(l1_cache, addr, &line_addr, FALSE);
 
@@ -406,8 +405,8 @@ void dc_pref_cache_insert(Addr addr) {
   STAT_EVENT(0, DC_PREF_CACHE_INSERT_REQ);
 
   if(!data && l1_data) {
-    Dcache_Data* new_data = (Dcache_Data*)cache_insert(
-      &dc->pref_dcache, dc->proc_id, addr, &line_addr, &repl_line_addr);
+    Dcache_Data* new_data = (Dcache_Data*)line_cache_insert(
+      dc->pref_dcache, dc->proc_id, addr, &line_addr, &repl_line_addr);
     DEBUG(dc->proc_id, "Filling pref_cache addr:0x%s :%8s index:%7s \n",
           hexstr64s(addr), unsstr64(addr),
           unsstr64(addr >> LOG2(DCACHE_LINE_SIZE)));
@@ -420,20 +419,21 @@ void dc_pref_cache_insert(Addr addr) {
 
 void ideal_l2l1_prefetcher(Op* op) {
   Addr         line_addr;
-  Dcache_Data* line = (Dcache_Data*)cache_access(
-    &dc->dcache, op->oracle_info.va, &line_addr, FALSE);
+  Dcache_Data* line = (Dcache_Data*)line_cache_access(
+    dc->dcache, OP_ORACLE(op).va, &line_addr, FALSE);
 
   if(!line) {  // dcache miss
     L1_Data* data = (L1_Data*)cache_access(
-      l1_cache, op->oracle_info.va, &line_addr,
+      l1_cache, OP_ORACLE(op).va, &line_addr,
       TRUE);  // update the replacement policy
 
     if(data) {  // l1 hit
       Addr         repl_line_addr;
       Dcache_Data* dcache_data;
-      dcache_data = (Dcache_Data*)cache_insert(&dc->dcache, dc->proc_id,
-                                               op->oracle_info.va, &line_addr,
-                                               &repl_line_addr);
+      dcache_data = (Dcache_Data*)line_cache_insert(dc->dcache, dc->proc_id,
+                                                    OP_ORACLE(op).va,
+                                                    &line_addr,
+                                                    &repl_line_addr);
       STAT_EVENT(0, L2_IDEAL_FILL_L1);
       // need to do a write-back
       if(dcache_data->dirty) {
@@ -55,7 +55,7 @@
 /**************************************************************************************/
 /* Global Variables */
 
-extern Dcache_Stage* dc;
+extern SIM_THREAD_LOCAL Dcache_Stage* dc;
 
 /***************************************************************************************/
 /* Local Prototypes */
@@ -204,10 +204,11 @@ int l2markv_pref_pred(Mem_Req_Info* req, Addr* req_addr) {
       STAT_EVENT(0, L2MARKV_PREF_REQ);
     } else if(L1MARKV_PREF_IMMEDIATE) {
       Dcache_Data *data, *line;
-      line = (Dcache_Data*)cache_access(&dc->dcache, req_va, &line_addr, FALSE);
+      line = (Dcache_Data*)line_cache_access(dc->dcache, req_va, &line_addr,
+                                             FALSE);
       if(!line) {
-        data = (Dcache_Data*)cache_insert(&dc->dcache, dc->proc_id, req_va,
-                                          &line_addr, &repl_line_addr);
+        data = (Dcache_Data*)line_cache_insert(dc->dcache, dc->proc_id, req_va,
+                                               &line_addr, &repl_line_addr);
         if(data->dirty) {
           FATAL_ERROR(0,
                       "This writeback code is wrong. Writebacks may be lost.");
@@ -274,15 +275,15 @@ void update_l2markv_pref_req_queue(void) {
         Addr         line_addr;
         int  q_index = l1pref_markv_send_no % L1PREF_MARKV_REQ_QUEUE_SIZE;
         Addr req_va  = l1pref_markv_req_queue[q_index].va;
-        uns  bank    = req_va >> dc->dcache.shift_bits &
+        uns  bank    = req_va >> line_cache_shift_bits(dc->dcache) &
                    N_BIT_MASK(LOG2(DCACHE_BANKS));
 
         if(get_read_port(&dc->ports[bank]) &&
            get_write_port(&dc->ports[bank])) {  // get ports
           // !!! we need to check whether the data is in the L1 cache (second
           // level cache or not!!!!)
-          line = (Dcache_Data*)cache_access(&dc->dcache, req_va, &line_addr,
-                                            FALSE);
+          line = (Dcache_Data*)line_cache_access(dc->dcache, req_va,
+                                                 &line_addr, FALSE);
           if(!line) {
             markv_l2send_req_queue[markv_l2access_req_no %
                                    MARKV_L2ACCESS_REQ_Q_SIZE]
@@ -370,7 +371,7 @@ void l2next_pref(Mem_Req_Info* req) {
       dc_pref_cache_insert(req_va);
       STAT_EVENT(0, L2NEXT_PREF_REQ);
     } else {
-      uns bank = req_va >> dc->dcache.shift_bits &
+      uns bank = req_va >> line_cache_shift_bits(dc->dcache) &
                  N_BIT_MASK(LOG2(DCACHE_BANKS));
       Cache*   l1_cache = &mem->uncores[req->proc_id].l1->cache;
       L1_Data* l1_data  = cache_access(l1_cache, req_va, &line_addr, FALSE);
@@ -381,11 +382,11 @@ void l2next_pref(Mem_Req_Info* req) {
           // !!! we need to check whether the data is in the L1 cache (second
           // level cache or not!!!!)
           Addr         line_addr, repl_line_addr;
-          Dcache_Data* line = (Dcache_Data*)cache_access(&dc->dcache, req_va,
-                                                         &line_addr, FALSE);
+          Dcache_Data* line = (Dcache_Data*)line_cache_access(
+            dc->dcache, req_va, &line_addr, FALSE);
           if(!line) {
-            Dcache_Data* data = (Dcache_Data*)cache_insert(
-              &dc->dcache, dc->proc_id, req_va, &line_addr, &repl_line_addr);
+            Dcache_Data* data = (Dcache_Data*)line_cache_insert(
+              dc->dcache, dc->proc_id, req_va, &line_addr, &repl_line_addr);
             if(data->dirty) {
               new_mem_req(MRT_WB, req->proc_id, repl_line_addr,
                           DCACHE_LINE_SIZE, 1, NULL, NULL, 0,
@@ -55,7 +55,7 @@
 /* Global Variables */
 
 extern Memory*       mem;
-extern Dcache_Stage* dc;
+extern SIM_THREAD_LOCAL Dcache_Stage* dc;
 
 /***************************************************************************************/
 /* Local Prototypes */
@@ -190,10 +190,11 @@ void l2way_pref_pred(Mem_Req_Info* req) {
       STAT_EVENT(0, L2WAY_PREF_REQ);
     } else if(L1PREF_IMMEDIATE) {
       Dcache_Data *data, *line;
-      line = (Dcache_Data*)cache_access(&dc->dcache, va, &line_addr, FALSE);
+      line = (Dcache_Data*)line_cache_access(dc->dcache, va, &line_addr,
+                                             FALSE);
       if(!line) {
-        data = (Dcache_Data*)cache_insert(&dc->dcache, dc->proc_id, va,
-                                          &line_addr, &repl_line_addr);
+        data = (Dcache_Data*)line_cache_insert(dc->dcache, dc->proc_id, va,
+                                               &line_addr, &repl_line_addr);
         if(data->dirty) {
           FATAL_ERROR(0,
                       "This writeback code is wrong. Writebacks may be lost.");
@@ -237,17 +238,17 @@ void update_l2way_pref_req_queue(void) {
         Addr         line_addr, repl_line_addr;
         Addr         req_va =
           l1pref_req_queue[l1pref_send_no % L1PREF_REQ_QUEUE_SIZE].va;
-        uns bank = req_va >> dc->dcache.shift_bits &
+        uns bank = req_va >> line_cache_shift_bits(dc->dcache) &
                    N_BIT_MASK(LOG2(DCACHE_BANKS));
 
         if(get_read_port(&dc->ports[bank]) &&
            get_write_port(&dc->ports[bank])) {  // get ports
 
-          line = (Dcache_Data*)cache_access(&dc->dcache, req_va, &line_addr,
-                                            FALSE);
+          line = (Dcache_Data*)line_cache_access(dc->dcache, req_va,
+                                                 &line_addr, FALSE);
           if(!line) {
-            data = (Dcache_Data*)cache_insert(&dc->dcache, dc->proc_id, req_va,
-                                              &line_addr, &repl_line_addr);
+            data = (Dcache_Data*)line_cache_insert(
+              dc->dcache, dc->proc_id, req_va, &line_addr, &repl_line_addr);
             if(data->dirty) {
               FATAL_ERROR(
                 0, "This writeback code is wrong. Writebacks may be lost.");
@@ -38,7 +38,9 @@
 #include "globals/utils.h"
 #include "op.h"
 
+#include "checkpoint.h"
 #include "cmp_model.h"
+#include "cmp_threads.h"
 #include "core.param.h"
 #include "dcache_stage.h"
 #include "debug/debug.param.h"
@@ -78,7 +80,7 @@ static int pref_table_size;
 /* Global Variables */
 
 extern Memory*       mem;
-extern Dcache_Stage* dc;
+extern SIM_THREAD_LOCAL Dcache_Stage* dc;
 
 HWP_Common pref;
 
@@ -87,6 +89,14 @@ FILE* PREF_TRACE_OUT;
 FILE* PREF_DEGFB_FILE;
 
 static void pref_core_init(HWP_Core* pref_core);
+static void pref_queue_index_init(Pref_Queue_Index* index, uns queue_size);
+static void pref_queue_index_clear(Pref_Queue_Index* index);
+static void pref_queue_index_fill(Pref_Queue_Index* index,
+                                  Pref_Mem_Req* queue, int slot,
+                                  Pref_Mem_Req* new_req);
+static int  pref_queue_index_find(Pref_Queue_Index* index,
+                                  Pref_Mem_Req* queue, Addr line_index,
+                                  Flag valid_only);
 static void pref_update_core(uns proc_id);
 static void pref_polbv_update_on_evict(uns8 pref_proc_id, uns8 evicted_proc_id,
                                        Addr evicted_addr);
@@ -124,6 +134,120 @@ void pref_core_init(HWP_Core* pref_core) {
 
   pref_core->ul1req_queue_req_pos  = -1;
   pref_core->ul1req_queue_send_pos = 0;
+
+  pref_queue_index_init(&pref_core->dl0req_index, PREF_DL0REQ_QUEUE_SIZE);
+  pref_queue_index_init(&pref_core->umlc_req_index, PREF_UMLC_REQ_QUEUE_SIZE);
+  pref_queue_index_init(&pref_core->ul1req_index, PREF_UL1REQ_QUEUE_SIZE);
+}
+
+static void pref_queue_index_init(Pref_Queue_Index* index, uns queue_size) {
+  uns num_buckets = 1;
+  while(num_buckets < 2 * queue_size)
+    num_buckets <<= 1;
+  index->buckets = (int*)malloc(num_buckets * sizeof(int));
+  index->mask    = num_buckets - 1;
+  pref_queue_index_clear(index);
+}
+
+static void pref_queue_index_clear(Pref_Queue_Index* index) {
+  memset(index->buckets, -1, (index->mask + 1) * sizeof(int));
+}
+
+static inline uns pref_queue_index_home(Pref_Queue_Index* index,
+                                        Addr              line_index) {
+  return (uns)((line_index * 0x9e3779b97f4a7c15ull) >> 32) & index->mask;
+}
+
+/* pref_queue_index_fill: writes new_req into queue[slot], moving the slot
+   from the bucket of the request it overwrites to the bucket of new_req */
+static void pref_queue_index_fill(Pref_Queue_Index* index,
+                                  Pref_Mem_Req* queue, int slot,
+                                  Pref_Mem_Req* new_req) {
+  int* buckets = index->buckets;
+  uns  mask    = index->mask;
+
+  if(queue[slot].line_index) {
+    uns hole = pref_queue_index_home(index, queue[slot].line_index);
+    while(buckets[hole] != slot)
+      hole = (hole + 1) & mask;
+    // backward-shift the rest of the run so no probe stops early
+    for(uns next = (hole + 1) & mask; buckets[next] != -1;
+        next     = (next + 1) & mask) {
+      uns home = pref_queue_index_home(index, queue[buckets[next]].line_index);
+      if(((next - home) & mask) >= ((next - hole) & mask)) {
+        buckets[hole] = buckets[next];
+        hole          = next;
+      }
+    }
+    buckets[hole] = -1;
+  }
+
+  queue[slot] = *new_req;
+
+  uns bucket = pref_queue_index_home(index, new_req->line_index);
+  while(buckets[bucket] != -1)
+    bucket = (bucket + 1) & mask;
+  buckets[bucket] = slot;
+}
+
+/* pref_queue_index_find: lowest slot holding line_index (and still valid if
+   valid_only), or -1. The lowest slot is what a scan of the queue finds. */
+static int pref_queue_index_find(Pref_Queue_Index* index,
+                                 Pref_Mem_Req* queue, Addr line_index,
+                                 Flag valid_only) {
+  int found = -1;
+  for(uns bucket = pref_queue_index_home(index, line_index);
+      index->buckets[bucket] != -1; bucket = (bucket + 1) & index->mask) {
+    int slot = index->buckets[bucket];
+    if(queue[slot].line_index == line_index &&
+       (!valid_only || queue[slot].valid) && (found == -1 || slot < found))
+      found = slot;
+  }
+  return found;
+}
+
+/* pref_warmup_done: drop the requests queued while the prefetchers were
+   trained by the functional warmup. Only the trained state carries over into
+   simulation mode. */
+void pref_warmup_done(void) {
+  if(!PREF_FRAMEWORK_ON)
+    return;
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    HWP_Core* pref_core = pref.cores[proc_id];
+    memset(pref_core->dl0req_queue, 0,
+           PREF_DL0REQ_QUEUE_SIZE * sizeof(Pref_Mem_Req));
+    memset(pref_core->umlc_req_queue, 0,
+           PREF_UMLC_REQ_QUEUE_SIZE * sizeof(Pref_Mem_Req));
+    memset(pref_core->ul1req_queue, 0,
+           PREF_UL1REQ_QUEUE_SIZE * sizeof(Pref_Mem_Req));
+    pref_core->dl0req_queue_req_pos    = -1;
+    pref_core->dl0req_queue_send_pos   = 0;
+    pref_core->umlc_req_queue_req_pos  = -1;
+    pref_core->umlc_req_queue_send_pos = 0;
+    pref_core->ul1req_queue_req_pos    = -1;
+    pref_core->ul1req_queue_send_pos   = 0;
+    pref_queue_index_clear(&pref_core->dl0req_index);
+    pref_queue_index_clear(&pref_core->umlc_req_index);
+    pref_queue_index_clear(&pref_core->ul1req_index);
+  }
+}
+
+/* pref_checkpoint: save or restore the trained state of every enabled
+   prefetcher. The request queues are not part of it, they are empty after
+   the warmup (see pref_warmup_done). */
+void pref_checkpoint(void) {
+  if(!PREF_FRAMEWORK_ON)
+    return;
+  for(int ii = 0; ii < pref_table_size; ii++) {
+    if(!pref_table[ii].hwp_info->enabled)
+      continue;
+    checkpoint_section(pref_table[ii].name);
+    if(pref_table[ii].checkpoint_func)
+      pref_table[ii].checkpoint_func();
+    else
+      WARNINGU(0, "Prefetcher %s has no checkpoint support, it starts cold\n",
+               pref_table[ii].name);
+  }
 }
 
 void pref_init(void) {
@@ -268,11 +392,13 @@ void pref_dl0_miss(Addr line_addr, Addr load_PC) {
   if(!PREF_FRAMEWORK_ON)
     return;
   if(PREF_DL0_MISS_ON) {
+    cmp_threads_lock();
     for(ii = 0; ii < pref_table_size; ii++) {
       if(pref_table[ii].hwp_info->enabled && pref_table[ii].dl0_miss_func) {
         pref_table[ii].dl0_miss_func(line_addr, load_PC);
       }
     }
+    cmp_threads_unlock();
   }
 }
 
@@ -282,11 +408,13 @@ void pref_dl0_hit(Addr line_addr, Addr load_PC) {
   if(!PREF_FRAMEWORK_ON)
     return;
   if(PREF_DL0_HIT_ON) {
+    cmp_threads_lock();
     for(ii = 0; ii < pref_table_size; ii++) {
       if(pref_table[ii].hwp_info->enabled && pref_table[ii].dl0_hit_func) {
         pref_table[ii].dl0_hit_func(line_addr, load_PC);
       }
     }
+    cmp_threads_unlock();
   }
 }
 
@@ -299,11 +427,13 @@ void pref_dl0_pref_hit(Addr line_addr, Addr load_PC, uns8 prefetcher_id) {
     return;
 
   if(PREF_DL0_HIT_ON) {
+    cmp_threads_lock();
     for(ii = 0; ii < pref_table_size; ii++) {
       if(pref_table[ii].hwp_info->enabled && pref_table[ii].dl0_pref_hit) {
         pref_table[ii].dl0_pref_hit(line_addr, load_PC);
       }
     }
+    cmp_threads_unlock();
   }
 }
 
@@ -485,16 +615,15 @@ void pref_ul1_pref_hit(uns8 proc_id, Addr line_addr, Addr load_PC,
 Flag pref_dl0req_queue_filter(Addr line_addr) {
   if(!PREF_DL0REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns           proc_id      = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* dl0req_queue = pref.cores[proc_id]->dl0req_queue;
-  for(uns ii = 0; ii < PREF_DL0REQ_QUEUE_SIZE; ii++) {
-    if(dl0req_queue[ii].valid &&
-       (dl0req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      dl0req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_DL0REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
+  uns       proc_id   = get_proc_id_from_cmp_addr(line_addr);
+  HWP_Core* pref_core = pref.cores[proc_id];
+  int       slot      = pref_queue_index_find(
+    &pref_core->dl0req_index, pref_core->dl0req_queue,
+    line_addr >> LOG2(DCACHE_LINE_SIZE), TRUE);
+  if(slot != -1) {
+    pref_core->dl0req_queue[slot].valid = FALSE;
+    STAT_EVENT(0, PREF_DL0REQ_QUEUE_HIT_BY_DEMAND);
+    return TRUE;
   }
   return FALSE;
 }
@@ -502,16 +631,15 @@ Flag pref_dl0req_queue_filter(Addr line_addr) {
 Flag pref_umlc_req_queue_filter(Addr line_addr) {
   if(!PREF_UMLC_REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns           proc_id        = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* umlc_req_queue = pref.cores[proc_id]->umlc_req_queue;
-  for(uns ii = 0; ii < PREF_UMLC_REQ_QUEUE_SIZE; ii++) {
-    if(umlc_req_queue[ii].valid &&
-       (umlc_req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      umlc_req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
+  uns       proc_id   = get_proc_id_from_cmp_addr(line_addr);
+  HWP_Core* pref_core = pref.cores[proc_id];
+  int       slot      = pref_queue_index_find(
+    &pref_core->umlc_req_index, pref_core->umlc_req_queue,
+    line_addr >> LOG2(DCACHE_LINE_SIZE), TRUE);
+  if(slot != -1) {
+    pref_core->umlc_req_queue[slot].valid = FALSE;
+    STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_HIT_BY_DEMAND);
+    return TRUE;
   }
   return FALSE;
 }
@@ -519,48 +647,39 @@ Flag pref_umlc_req_queue_filter(Addr line_addr) {
 Flag pref_ul1req_queue_filter(Addr line_addr) {
   if(!PREF_UL1REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns           proc_id      = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* ul1req_queue = pref.cores[proc_id]->ul1req_queue;
-  for(uns ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-    if(ul1req_queue[ii].valid &&
-       (ul1req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      ul1req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_UL1REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
+  uns       proc_id   = get_proc_id_from_cmp_addr(line_addr);
+  HWP_Core* pref_core = pref.cores[proc_id];
+  int       slot      = pref_queue_index_find(
+    &pref_core->ul1req_index, pref_core->ul1req_queue,
+    line_addr >> LOG2(DCACHE_LINE_SIZE), TRUE);
+  if(slot != -1) {
+    pref_core->ul1req_queue[slot].valid = FALSE;
+    STAT_EVENT(0, PREF_UL1REQ_QUEUE_HIT_BY_DEMAND);
+    return TRUE;
   }
   return FALSE;
 }
 
 Flag pref_ul1req_queue_match(Addr line_addr) {
-  uns           proc_id      = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* ul1req_queue = pref.cores[proc_id]->ul1req_queue;
-  for(uns ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-    if(ul1req_queue[ii].valid &&
-       (ul1req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      return TRUE;
-    }
-  }
-  return FALSE;
+  uns       proc_id   = get_proc_id_from_cmp_addr(line_addr);
+  HWP_Core* pref_core = pref.cores[proc_id];
+  return pref_queue_index_find(&pref_core->ul1req_index,
+                               pref_core->ul1req_queue,
+                               line_addr >> LOG2(DCACHE_LINE_SIZE), TRUE) != -1;
 }
 
 Flag pref_addto_dl0req_queue(uns8 proc_id, Addr line_index,
                              uns8 prefetcher_id) {
-  int          ii;
   Pref_Mem_Req new_req = {0};
   if(!line_index)  // addr = 0
     return TRUE;
   Pref_Mem_Req* dl0req_queue = pref.cores[proc_id]->dl0req_queue;
   int* dl0req_queue_req_pos  = &pref.cores[proc_id]->dl0req_queue_req_pos;
-  if(PREF_DL0REQ_ADD_FILTER_ON) {
-    for(ii = 0; ii < PREF_DL0REQ_QUEUE_SIZE; ii++) {
-      if(dl0req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_DL0REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  if(PREF_DL0REQ_ADD_FILTER_ON &&
+     pref_queue_index_find(&pref.cores[proc_id]->dl0req_index, dl0req_queue,
+                           line_index, FALSE) != -1) {
+    STAT_EVENT(0, PREF_DL0REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if(dl0req_queue[(*dl0req_queue_req_pos + 1) % PREF_DL0REQ_QUEUE_SIZE].valid) {
     STAT_EVENT_ALL(PREF_DL0REQ_QUEUE_FULL);
@@ -577,25 +696,23 @@ Flag pref_addto_dl0req_queue(uns8 proc_id, Addr line_index,
 
   *dl0req_queue_req_pos = (*dl0req_queue_req_pos + 1) % PREF_DL0REQ_QUEUE_SIZE;
 
-  dl0req_queue[*dl0req_queue_req_pos] = new_req;
+  pref_queue_index_fill(&pref.cores[proc_id]->dl0req_index, dl0req_queue,
+                        *dl0req_queue_req_pos, &new_req);
   return TRUE;
 }
 
 Flag pref_addto_umlc_req_queue(uns8 proc_id, Addr line_index,
                                uns8 prefetcher_id) {
-  int          ii;
   Pref_Mem_Req new_req = {0};
   if(!line_index)  // addr = 0
     return TRUE;
   Pref_Mem_Req* umlc_req_queue = pref.cores[proc_id]->umlc_req_queue;
   int* umlc_req_queue_req_pos  = &pref.cores[proc_id]->umlc_req_queue_req_pos;
-  if(PREF_UMLC_REQ_ADD_FILTER_ON) {
-    for(ii = 0; ii < PREF_UMLC_REQ_QUEUE_SIZE; ii++) {
-      if(umlc_req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  if(PREF_UMLC_REQ_ADD_FILTER_ON &&
+     pref_queue_index_find(&pref.cores[proc_id]->umlc_req_index,
+                           umlc_req_queue, line_index, FALSE) != -1) {
+    STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if(umlc_req_queue[(*umlc_req_queue_req_pos + 1) % PREF_UMLC_REQ_QUEUE_SIZE]
        .valid) {
@@ -616,7 +733,8 @@ Flag pref_addto_umlc_req_queue(uns8 proc_id, Addr line_index,
   *umlc_req_queue_req_pos = (*umlc_req_queue_req_pos + 1) %
                             PREF_UMLC_REQ_QUEUE_SIZE;
 
-  umlc_req_queue[*umlc_req_queue_req_pos] = new_req;
+  pref_queue_index_fill(&pref.cores[proc_id]->umlc_req_index, umlc_req_queue,
+                        *umlc_req_queue_req_pos, &new_req);
   return TRUE;
 }
 
@@ -629,7 +747,6 @@ Flag pref_addto_ul1req_queue(uns8 proc_id, Addr line_index,
 Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index,
                                  uns8 prefetcher_id, uns distance, Addr loadPC,
                                  uns32 global_hist, Flag bw) {
-  int          ii;
   Pref_Mem_Req new_req;
   Addr         line_addr;
   if(!line_index)  // addr = 0
@@ -642,13 +759,11 @@ Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index,
 
   pref_feed_back_info_update(prefetcher_id);
 
-  if(PREF_UL1REQ_ADD_FILTER_ON) {
-    for(ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-      if(ul1req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_UL1REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  if(PREF_UL1REQ_ADD_FILTER_ON &&
+     pref_queue_index_find(&pref.cores[proc_id]->ul1req_index, ul1req_queue,
+                           line_index, FALSE) != -1) {
+    STAT_EVENT(0, PREF_UL1REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if(ul1req_queue[(*ul1req_queue_req_pos + 1) % PREF_UL1REQ_QUEUE_SIZE].valid) {
     STAT_EVENT_ALL(PREF_UL1REQ_QUEUE_FULL);
@@ -669,7 +784,8 @@ Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index,
 
   *ul1req_queue_req_pos = (*ul1req_queue_req_pos + 1) % PREF_UL1REQ_QUEUE_SIZE;
 
-  ul1req_queue[*ul1req_queue_req_pos] = new_req;
+  pref_queue_index_fill(&pref.cores[proc_id]->ul1req_index, ul1req_queue,
+                        *ul1req_queue_req_pos, &new_req);
   return TRUE;
 }
 
@@ -722,7 +838,8 @@ void pref_update_core(uns proc_id) {
 
       ASSERT(proc_id, proc_id == dl0req_queue[q_index].line_addr >> 58);
 
-      bank = dl0req_queue[q_index].line_addr >> dc->dcache.shift_bits &
+      bank = dl0req_queue[q_index].line_addr >>
+               line_cache_shift_bits(dc->dcache) &
              N_BIT_MASK(LOG2(DCACHE_BANKS));
 
       // check on the availability of a read port for the given bank
@@ -734,8 +851,8 @@ void pref_update_core(uns proc_id) {
       }
       // Now, access the cache
 
-      dc_hit = (Dcache_Data*)cache_access(
-        &dc->dcache, dl0req_queue[q_index].line_addr, &dummy_line_addr, FALSE);
+      dc_hit = (Dcache_Data*)line_cache_access(
+        dc->dcache, dl0req_queue[q_index].line_addr, &dummy_line_addr, FALSE);
 
       if(dc_hit) {
         // nothing for now
@@ -121,8 +121,18 @@ struct HWP_struct {
                        uns32 global_hist);  // called when a ul1 access hits a
                                             // prefetched line for the first
                                             // time
+  void (*checkpoint_func)(void);  // saves or restores the trained state
+                                  // (see checkpoint.h)
 };
 
+/* Hash index of a request queue. Every slot holding a request (valid or
+   already sent) is filed under its line_index, so the demand filters and the
+   duplicate check probe a few buckets instead of scanning the whole queue. */
+typedef struct Pref_Queue_Index_struct {
+  int* buckets;  // queue slot, -1 if empty (open addressing, linear probing)
+  uns  mask;
+} Pref_Queue_Index;
+
 /* Per core prefetching data */
 typedef struct HWP_Core_struct {
   Pref_Mem_Req* dl0req_queue;    // L1 req queue
@@ -138,6 +148,10 @@ typedef struct HWP_Core_struct {
   int ul1req_queue_req_pos;
   int ul1req_queue_send_pos;
 
+  Pref_Queue_Index dl0req_index;
+  Pref_Queue_Index umlc_req_index;
+  Pref_Queue_Index ul1req_index;
+
   Counter ul1_misses;
   Counter curr_ul1_misses;
 
@@ -179,6 +193,8 @@ typedef enum {
 void pref_init(void);
 void pref_done(void);
 void pref_per_core_done(uns proc_id);
+void pref_warmup_done(void);
+void pref_checkpoint(void);
 
 void pref_dl0_miss(Addr line_addr, Addr load_PC);
 void pref_dl0_hit(Addr line_addr, Addr load_PC);
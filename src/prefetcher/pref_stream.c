@@ -36,6 +36,7 @@
 #include "globals/utils.h"
 #include "op.h"
 
+#include "checkpoint.h"
 #include "core.param.h"
 #include "dcache_stage.h"
 #include "debug/debug.param.h"
@@ -60,12 +61,13 @@
 /**************************************************************************************/
 /* Global Variables */
 
-extern Dcache_Stage* dc;
+extern SIM_THREAD_LOCAL Dcache_Stage* dc;
 
 /***************************************************************************************/
 /* Local Prototypes */
 
 static void collect_stream_stats(const Stream_Buffer* stream);
+static void checkpoint_stream_core(Pref_Stream* pref_stream_core);
 
 /**************************************************************************************/
 /* stream prefetcher  */
@@ -632,6 +634,32 @@ void pref_stream_per_core_done(uns proc_id) {
   }
 }
 
+void pref_stream_checkpoint(void) {
+  if(PREF_UMLC_ON)
+    checkpoint_stream_core(stream_prefetchers_array.pref_stream_core_umlc);
+  if(PREF_UL1_ON)
+    checkpoint_stream_core(stream_prefetchers_array.pref_stream_core_ul1);
+}
+
+static void checkpoint_stream_core(Pref_Stream* pref_stream_core) {
+  // the stream buffers and train filter live in core 0 when they are shared
+  uns num_tables = PREF_STREAM_PER_CORE_ENABLE ? NUM_CORES : 1;
+  for(uns proc_id = 0; proc_id < num_tables; proc_id++) {
+    Pref_Stream* pref_stream = &pref_stream_core[proc_id];
+    checkpoint_transfer(pref_stream->stream,
+                        STREAM_BUFFER_N * sizeof(Stream_Buffer));
+    checkpoint_transfer(pref_stream->train_filter,
+                        TRAIN_FILTER_SIZE * sizeof(Addr));
+    checkpoint_transfer(pref_stream->train_filter_no, sizeof(int));
+  }
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Pref_Stream* pref_stream = &pref_stream_core[proc_id];
+    checkpoint_transfer(&pref_stream->train_num, sizeof(uns));
+    checkpoint_transfer(&pref_stream->distance, sizeof(uns));
+    checkpoint_transfer(&pref_stream->num_tosend, sizeof(uns));
+  }
+}
+
 void pref_stream_throttle_fb(Pref_Stream* pref_stream, uns8 proc_id) {
   if(PREF_DHAL) {  // on pref_dhal, we update the dyn_degree based on sent pref
     pref_stream->distance = pref_stream->hwp_info->dyn_degree_core[proc_id];
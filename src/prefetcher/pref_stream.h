@@ -91,6 +91,7 @@ typedef struct{
 void pref_stream_init(HWP* hwp);
 
 void pref_stream_per_core_done(uns proc_id);
+void pref_stream_checkpoint(void);
 /*************************************************************/
 /* HWP Interface */
 void pref_stream_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
@@ -36,6 +36,7 @@
 #include "globals/utils.h"
 #include "op.h"
 
+#include "checkpoint.h"
 #include "core.param.h"
 #include "debug/debug.param.h"
 #include "general.param.h"
@@ -95,6 +96,21 @@ void init_stridepc(HWP* hwp, Pref_StridePC* stridepc_hwp_core) {
   }
 }
 
+void pref_stridepc_checkpoint(void) {
+  uns8 proc_id;
+
+  for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(PREF_UMLC_ON)
+      checkpoint_transfer(
+        stridepc_prefetche_array.stridepc_hwp_core_umlc[proc_id].stride_table,
+        PREF_STRIDEPC_TABLE_N * sizeof(StridePC_Table_Entry));
+    if(PREF_UL1_ON)
+      checkpoint_transfer(
+        stridepc_prefetche_array.stridepc_hwp_core_ul1[proc_id].stride_table,
+        PREF_STRIDEPC_TABLE_N * sizeof(StridePC_Table_Entry));
+  }
+}
+
 void pref_stridepc_ul1_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
                            uns32 global_hist) {
   pref_stridepc_train(&stridepc_prefetche_array.stridepc_hwp_core_ul1[proc_id], proc_id, lineAddr, loadPC, TRUE);
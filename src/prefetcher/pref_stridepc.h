@@ -68,6 +68,7 @@ void pref_stridepc_umlc_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
                             uns32 global_hist);
 void pref_stridepc_umlc_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
                            uns32 global_hist);
+void pref_stridepc_checkpoint(void);
 
 
 /*************************************************************/
@@ -59,7 +59,7 @@
 /**************************************************************************************/
 /* Global Variables */
 
-extern Dcache_Stage* dc;
+extern SIM_THREAD_LOCAL Dcache_Stage* dc;
 
 /***************************************************************************************/
 /* Local Prototypes */
@@ -369,12 +369,12 @@ void update_pref_queue(void) {
       Addr line_addr;
 
       if(stream_hwp->l2hit_pref_req_queue[q_index].valid) {
-        uns bank = req_va >> dc->dcache.shift_bits &
+        uns bank = req_va >> line_cache_shift_bits(dc->dcache) &
                    N_BIT_MASK(LOG2(DCACHE_BANKS));
 
         if(get_read_port(&dc->ports[bank])) {
-          Dcache_Data* data = (Dcache_Data*)cache_access(&dc->dcache, req_va,
-                                                         &line_addr, FALSE);
+          Dcache_Data* data = (Dcache_Data*)line_cache_access(
+            dc->dcache, req_va, &line_addr, FALSE);
 
           if(data) {
             // L1 hit
@@ -139,6 +139,8 @@ void init_configs() {
   configs->add("print_cmd_trace", RAMULATOR_PRINT_CMD_TRACE);
   configs->add("use_rest_of_addr_as_row_addr",
                RAMULATOR_USE_REST_OF_ADDR_AS_ROW_ADDR);
+  configs->add("skip_idle_cycles", RAMULATOR_SKIP_IDLE_CYCLES);
+  configs->add("channel_threads", to_string(RAMULATOR_CHANNEL_THREADS));
 
   configs->add("scheduling_policy", RAMULATOR_SCHEDULING_POLICY);
   configs->add("readq_entries", to_string(RAMULATOR_READQ_ENTRIES));
@@ -304,6 +306,24 @@ void ramulator_tick() {
   }
 }
 
+// Number of upcoming ramulator_tick()s that neither complete a request nor
+// change the state of DRAM
+Counter ramulator_idle_cycles() {
+  if(resp_queue.size() > 0)
+    return 0;
+  return wrapper->idle_ticks();
+}
+
+// Same as calling ramulator_tick() for the given number of idle cycles
+void ramulator_skip_cycles(Counter cycles) {
+  ASSERT(0, resp_queue.size() == 0);
+  wrapper->skip_ticks(cycles);
+}
+
+int ramulator_get_num_pending_resps() {
+  return resp_queue.size();
+}
+
 int ramulator_get_chip_width() {
   return wrapper->get_chip_width();
 }
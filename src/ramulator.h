@@ -43,6 +43,9 @@ EXTERNC void ramulator_finish();
 
 EXTERNC int  ramulator_send(Mem_Req* scarab_req);
 EXTERNC void ramulator_tick();
+EXTERNC Counter ramulator_idle_cycles();
+EXTERNC void    ramulator_skip_cycles(Counter cycles);
+EXTERNC int  ramulator_get_num_pending_resps();
 
 EXTERNC int ramulator_get_chip_width();
 EXTERNC int ramulator_get_chip_size();
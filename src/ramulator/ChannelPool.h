@@ -0,0 +1,145 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CHANNEL_POOL_H
+#define __CHANNEL_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace ramulator
+{
+
+/* Small pool of host threads that runs one job per DRAM channel. Channel i is
+   always run by thread i % num_threads; the calling thread is thread 0. A run
+   is as short as one controller tick, so between runs the other threads spin,
+   then yield, and only then block on a condition variable; run() only takes
+   the lock to wake them when one of them went to sleep. run() returns once
+   every channel is done. */
+class ChannelPool
+{
+    static constexpr int spins_before_yield = 1024;
+    static constexpr int yields_before_sleep = 64;
+
+    int num_threads;
+    int num_channels;
+    vector<thread> workers;
+
+    void (*job)(void* arg, int channel) = nullptr;
+    void* job_arg = nullptr;
+    atomic<unsigned> generation{0};
+    atomic<int> running{0};
+    atomic<bool> exiting{false};
+
+    mutex sleep_mutex;
+    condition_variable wake;
+    atomic<int> sleepers{0};
+
+    void run_share(int tid)
+    {
+        for (int ch = tid; ch < num_channels; ch += num_threads)
+            job(job_arg, ch);
+    }
+
+    // Returns the generation that ends the wait for a run after seen
+    unsigned wait_for_run(unsigned seen)
+    {
+        unsigned gen;
+        int spins = 0;
+        while ((gen = generation.load(memory_order_acquire)) == seen) {
+            if (++spins <= spins_before_yield)
+                continue;
+            if (spins <= spins_before_yield + yields_before_sleep) {
+                this_thread::yield();
+                continue;
+            }
+            // sleepers and generation are seq_cst so that run() either sees
+            // this sleeper or this sleeper sees its new generation
+            unique_lock<mutex> lock(sleep_mutex);
+            sleepers.fetch_add(1);
+            wake.wait(lock, [&] { return generation.load() != seen; });
+            sleepers.fetch_sub(1);
+            spins = 0;
+        }
+        return gen;
+    }
+
+    void wake_sleepers()
+    {
+        if (sleepers.load()) {
+            lock_guard<mutex> lock(sleep_mutex);
+            wake.notify_all();
+        }
+    }
+
+    void worker_main(int tid)
+    {
+        unsigned seen = 0;
+        while (true) {
+            seen = wait_for_run(seen);
+            if (exiting.load(memory_order_relaxed))
+                return;
+            run_share(tid);
+            running.fetch_sub(1, memory_order_release);
+        }
+    }
+
+public:
+    ChannelPool(int num_threads, int num_channels)
+        : num_threads(num_threads), num_channels(num_channels)
+    {
+        for (int tid = 1; tid < num_threads; tid++)
+            workers.emplace_back(&ChannelPool::worker_main, this, tid);
+    }
+
+    ~ChannelPool()
+    {
+        exiting.store(true, memory_order_relaxed);
+        generation.fetch_add(1);
+        wake_sleepers();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    void run(void (*_job)(void*, int), void* arg)
+    {
+        job = _job;
+        job_arg = arg;
+        running.store(num_threads - 1, memory_order_relaxed);
+        generation.fetch_add(1);
+        wake_sleepers();
+        run_share(0);
+        int spins = 0;
+        while (running.load(memory_order_acquire)) {
+            if (++spins > spins_before_yield)
+                this_thread::yield();
+        }
+    }
+};
+
+} /*namespace ramulator*/
+
+#endif /*__CHANNEL_POOL_H*/
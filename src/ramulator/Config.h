@@ -70,7 +70,9 @@ private:
         // Other
         {"record_cmd_trace", "off"},
         {"print_cmd_trace", "off"},
-        {"use_rest_of_addr_as_row_addr", "on"}
+        {"use_rest_of_addr_as_row_addr", "on"},
+        {"skip_idle_cycles", "on"},
+        {"channel_threads", "1"}
     };
 
 	template<typename T>
@@ -197,6 +199,15 @@ public:
       }
       return false;
     }
+    bool skip_idle_cycles() const {
+      if (options.find("skip_idle_cycles") != options.end()) {
+        if ((options.find("skip_idle_cycles"))->second == "on") {
+          return true;
+        }
+        return false;
+      }
+      return false;
+    }
     bool use_rest_of_addr_as_row_addr() const {
       if (options.find("use_rest_of_addr_as_row_addr") != options.end()) {
         if ((options.find("use_rest_of_addr_as_row_addr"))->second == "on") {
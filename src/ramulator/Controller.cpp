@@ -29,7 +29,7 @@ using namespace ramulator;
 namespace ramulator
 {
 
-static vector<int> get_offending_subarray(DRAM<SALP>* channel, vector<int> & addr_vec){
+static vector<int> get_offending_subarray(DRAM<SALP>* channel, const AddrVec& addr_vec){
     int sa_id = 0;
     auto rank = channel->children[addr_vec[int(SALP::Level::Rank)]];
     auto bank = rank->children[addr_vec[int(SALP::Level::Bank)]];
@@ -47,7 +47,7 @@ static vector<int> get_offending_subarray(DRAM<SALP>* channel, vector<int> & add
 
 
 template <>
-vector<int> Controller<SALP>::get_addr_vec(SALP::Command cmd, list<Request>::iterator req){
+vector<int> Controller<SALP>::get_addr_vec(SALP::Command cmd, RequestQueue::iterator req){
     if (cmd == SALP::Command::PRE_OTHER)
         return get_offending_subarray(channel, req->addr_vec);
     else
@@ -56,7 +56,7 @@ vector<int> Controller<SALP>::get_addr_vec(SALP::Command cmd, list<Request>::ite
 
 
 template <>
-bool Controller<SALP>::is_ready(list<Request>::iterator req){
+bool Controller<SALP>::is_ready(RequestQueue::iterator req){
     SALP::Command cmd = get_first_cmd(req);
     if (cmd == SALP::Command::PRE_OTHER){
 
@@ -66,6 +66,19 @@ bool Controller<SALP>::is_ready(list<Request>::iterator req){
     else return channel->check(cmd, req->addr_vec.data(), clk);
 }
 
+// PRE_OTHER is checked against another subarray than the request's, so
+// SALP is always ticked cycle by cycle
+template <>
+long Controller<SALP>::next_event(){
+    return clk + 1;
+}
+
+// PRE_OTHER depends on the other subarrays of the bank
+template <>
+bool Controller<SALP>::bank_indexed_scheduling(){
+    return false;
+}
+
 template <>
 void Controller<ALDRAM>::update_temp(ALDRAM::Temp current_temperature){
     channel->spec->aldram_timing(current_temperature);
@@ -88,7 +101,7 @@ void Controller<TLDRAM>::tick(){
                   channel->update_serving_requests(
                       req.addr_vec.data(), -1, clk);
           }
-            req.callback(req);
+            complete(req);
             pending.pop_front();
         }
     }
@@ -184,6 +197,19 @@ void Controller<TLDRAM>::tick(){
     queue->q.erase(req);
 }
 
+// TLDRAM turns reads into migrations as they are scheduled and keeps its own
+// write mode thresholds, so it is always ticked cycle by cycle
+template <>
+long Controller<TLDRAM>::next_event(){
+    return clk + 1;
+}
+
+// reads turn into migrations while they sit in readq
+template <>
+bool Controller<TLDRAM>::bank_indexed_scheduling(){
+    return false;
+}
+
 template<>
 void Controller<TLDRAM>::cmd_issue_autoprecharge(typename TLDRAM::Command& cmd,
                                                     const vector<int>& addr_vec) {
@@ -34,6 +34,7 @@
 #include "DRAM.h"
 #include "Refresh.h"
 #include "Request.h"
+#include "RequestQueue.h"
 #include "Scheduler.h"
 #include "Statistics.h"
 
@@ -97,13 +98,13 @@ public:
     Refresh<T>* refresh;
 
     struct Queue {
-        list<Request> q;
+        RequestQueue q;
         unsigned int max = 32;
         unsigned int size() {return q.size();}
     };
 
-    Queue readq;  // queue for read requests
-    Queue writeq;  // queue for write requests
+    Queue readq;  // queue for read requests (all of them READs, in order of arrival)
+    Queue writeq;  // queue for write requests (all of them WRITEs, in order of arrival)
     Queue actq; // read and write requests for which activate was issued are moved to 
                    // actq, which has higher priority than readq and writeq.
                    // This is an optimization
@@ -127,6 +128,12 @@ public:
     // callback function for passing stats to Scarab when an event occurs
     void (*stats_callback)(int, int) = nullptr;
 
+    // While the channels are ticked in parallel, completed reads and stat
+    // events go to these logs instead of the callbacks, and the memory
+    // replays them in channel order once all channels are done
+    bool defer_callbacks = false;
+    vector<Request> deferred_completions;
+    vector<pair<int, int>> deferred_stats;
 
     /* Constructor */
     Controller(const Config& configs, DRAM<T>* channel, void (*_stats_callback)(int,int)) :
@@ -155,6 +162,12 @@ public:
         readq.max = (unsigned int) configs.get_int("readq_entries");
         writeq.max = (unsigned int) configs.get_int("writeq_entries");
 
+        // chain the requests of every row buffer (bank or subarray) together
+        vector<int> bank_levels(channel->spec->org_entry.count + 1,
+                                channel->spec->org_entry.count + int(T::Level::Row));
+        for (Queue* queue : {&readq, &writeq, &actq, &otherq})
+            queue->q.set_bank_levels(bank_levels);
+
         // regStats
 
         row_hits
@@ -377,7 +390,7 @@ public:
                   channel->update_serving_requests(
                       req.addr_vec.data(), -1, clk);
                 }
-                req.callback(req);
+                complete(req);
                 pending.pop_front();
             }
         }
@@ -386,19 +399,7 @@ public:
         refresh->tick_ref();
 
         /*** 3. Should we schedule writes? ***/
-        if (!write_mode) {
-            // yes -- write queue is almost full or read queue is empty
-            if (writeq.size() > unsigned(wr_high_watermark * writeq.max) 
-                    /*|| readq.size() == 0*/) // Hasan: Switching to write mode when there are just a few 
-                                              // write requests, even if the read queue is empty, incurs a lot of overhead. 
-                                              // Commented out the read request queue empty condition
-                write_mode = true;
-        }
-        else {
-            // no -- write queue is almost empty and read queue is not empty
-            if (writeq.size() < unsigned(wr_low_watermark * writeq.max) && readq.size() != 0)
-                write_mode = false;
-        }
+        write_mode = next_write_mode();
 
         /*** 4. Find the best command to schedule, if any ***/
 
@@ -490,7 +491,89 @@ public:
         queue->q.erase(req);
     }
 
-    bool is_ready(list<Request>::iterator req)
+    bool next_write_mode()
+    {
+        if (!write_mode) {
+            // yes -- write queue is almost full or read queue is empty
+            if (writeq.size() > unsigned(wr_high_watermark * writeq.max) 
+                    /*|| readq.size() == 0*/) // Hasan: Switching to write mode when there are just a few 
+                                              // write requests, even if the read queue is empty, incurs a lot of overhead. 
+                                              // Commented out the read request queue empty condition
+                return true;
+        }
+        else {
+            // no -- write queue is almost empty and read queue is not empty
+            if (writeq.size() < unsigned(wr_low_watermark * writeq.max) && readq.size() != 0)
+                return false;
+        }
+        return write_mode;
+    }
+
+    /* Earliest clk at which tick() can do more than add to the queue length
+       sums: the next read departure, the next refresh, or the first cycle in
+       which a request of a schedulable queue has a legal next command.
+       Nothing else changes the timing state while no command is issued, so
+       the ticks before it can be replaced by skip(). Returns clk + 1 when no
+       cycle can be skipped. */
+    long next_event()
+    {
+        long now = clk + 1;
+        if (next_write_mode() != write_mode)
+            return now;
+        // speculative precharges depend on open rows, not on queued requests
+        if (rowpolicy->type != RowPolicy<T>::Type::Opened && rowtable->table.size())
+            return now;
+
+        long event = refresh->next_ref();
+        if (pending.size())
+            event = min(event, pending[0].depart);
+        // only the queues tick() schedules from in the current mode
+        Queue* queues[] = {&actq, otherq.size() ? &otherq : !write_mode ? &readq : &writeq};
+        for (Queue* queue : queues) {
+            for (auto req = queue->q.begin(); req != queue->q.end() && event > now; ++req)
+                event = min(event, channel->get_next(get_first_cmd(req), req->addr_vec.data()));
+        }
+        return max(event, now);
+    }
+
+    void complete(Request& req)
+    {
+        if (defer_callbacks)
+            deferred_completions.push_back(req);
+        else
+            req.callback(req);
+    }
+
+    void stat_event(int coreid, int type)
+    {
+        if (defer_callbacks)
+            deferred_stats.emplace_back(coreid, type);
+        else
+            stats_callback(coreid, type);
+    }
+
+    // Deliver what a deferred tick logged, in the order the tick produced it
+    void replay_deferred()
+    {
+        for (auto& req : deferred_completions)
+            req.callback(req);
+        deferred_completions.clear();
+        for (auto& stat : deferred_stats)
+            stats_callback(stat.first, stat.second);
+        deferred_stats.clear();
+    }
+
+    // Account for idle cycles up to (but not including) next_event()
+    void skip(long cycles)
+    {
+        clk += cycles;
+        req_queue_length_sum += cycles * (readq.size() + writeq.size() + pending.size());
+        read_req_queue_length_sum += cycles * (readq.size() + pending.size());
+        write_req_queue_length_sum += cycles * writeq.size();
+        refresh->skip(cycles);
+    }
+
+    bool is_ready(RequestQueue::iterator req)
     {
         typename T::Command cmd = get_first_cmd(req);
         return channel->check(cmd, req->addr_vec.data(), clk);
@@ -501,7 +584,7 @@ public:
         return channel->check(cmd, addr_vec.data(), clk);
     }
 
-    bool is_row_hit(list<Request>::iterator req)
+    bool is_row_hit(RequestQueue::iterator req)
     {
         // cmd must be decided by the request type, not the first cmd
         typename T::Command cmd = channel->spec->translate[int(req->type)];
@@ -513,7 +596,7 @@ public:
         return channel->check_row_hit(cmd, addr_vec.data());
     }
 
-    bool is_row_open(list<Request>::iterator req)
+    bool is_row_open(RequestQueue::iterator req)
     {
         // cmd must be decided by the request type, not the first cmd
         typename T::Command cmd = channel->spec->translate[int(req->type)];
@@ -559,7 +642,7 @@ public:
     }
 
 private:
-    typename T::Command get_first_cmd(list<Request>::iterator req)
+    typename T::Command get_first_cmd(RequestQueue::iterator req)
     {
         typename T::Command cmd = channel->spec->translate[int(req->type)];
         return channel->decode(cmd, req->addr_vec.data());
@@ -622,16 +705,16 @@ private:
         channel->update(cmd, addr_vec.data(), clk);
 
         if(channel->spec->is_opening(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_ACT));
+            stat_event(coreid, int(StatCallbackType::DRAM_ACT));
 
         if(channel->spec->is_closing(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_PRE));
+            stat_event(coreid, int(StatCallbackType::DRAM_PRE));
         
         if(channel->spec->is_reading(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_READ));
+            stat_event(coreid, int(StatCallbackType::DRAM_READ));
 
         if(channel->spec->is_writing(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_WRITE));
+            stat_event(coreid, int(StatCallbackType::DRAM_WRITE));
 
 
         if(cmd == T::Command::PRE){
@@ -663,17 +746,29 @@ private:
             printf("\n");
         }
     }
-    vector<int> get_addr_vec(typename T::Command cmd, list<Request>::iterator req){
+    vector<int> get_addr_vec(typename T::Command cmd, RequestQueue::iterator req){
         return req->addr_vec;
     }
+
+public:
+    /* Whether the first command of a queued request, and whether it is
+       ready, follow from its row buffer and from whether it hits the open
+       row, which lets the scheduler pick from readq and writeq one bank at a
+       time. */
+    bool bank_indexed_scheduling() {
+        return true;
+    }
 };
 
 template <>
 vector<int> Controller<SALP>::get_addr_vec(
-    SALP::Command cmd, list<Request>::iterator req);
+    SALP::Command cmd, RequestQueue::iterator req);
+
+template <>
+bool Controller<SALP>::is_ready(RequestQueue::iterator req);
 
 template <>
-bool Controller<SALP>::is_ready(list<Request>::iterator req);
+bool Controller<SALP>::bank_indexed_scheduling();
 
 template <>
 void Controller<ALDRAM>::update_temp(ALDRAM::Temp current_temperature);
@@ -681,6 +776,15 @@ void Controller<ALDRAM>::update_temp(ALDRAM::Temp current_temperature);
 template <>
 void Controller<TLDRAM>::tick();
 
+template <>
+long Controller<SALP>::next_event();
+
+template <>
+long Controller<TLDRAM>::next_event();
+
+template <>
+bool Controller<TLDRAM>::bank_indexed_scheduling();
+
 template <>
 void Controller<TLDRAM>::cmd_issue_autoprecharge(typename TLDRAM::Command& cmd,
                                                     const vector<int>& addr_vec);
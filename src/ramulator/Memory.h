@@ -26,6 +26,7 @@
 #include "DRAM.h"
 #include "Request.h"
 #include "Controller.h"
+#include "ChannelPool.h"
 #include "SpeedyController.h"
 #include "Statistics.h"
 #include "GDDR5.h"
@@ -56,6 +57,8 @@ public:
     virtual void tick() = 0;
     virtual bool send(Request req) = 0;
     virtual int pending_requests() = 0;
+    virtual long idle_ticks() = 0;
+    virtual void skip_ticks(long ticks) = 0;
     virtual void finish(void) = 0;
     virtual long page_allocator(long addr, int coreid) = 0;
     virtual void record_core(int coreid) = 0;
@@ -129,6 +132,25 @@ public:
 
     bool use_rest_of_addr_as_row_addr;
 
+    // Idle cycles are skipped lazily: while every controller waits for a
+    // known future event, tick() only counts the cycle, and the counted
+    // cycles are applied in one step before anything looks at the
+    // controllers again (next real tick, next request, end of simulation).
+    bool skip_idle_cycles = true;
+    long idle_until = 0;   // controller clk of the next real tick
+    long idle_cycles = 0;  // counted but not yet applied
+    // When the controllers are busy, looking for the next event every cycle
+    // costs more than it saves, so fruitless lookups back off exponentially.
+    int idle_probe_interval = 1;
+    int idle_probe_countdown = 1;
+    int max_idle_probe_interval = 16;
+
+    // With channel_threads > 1, the channel controllers are ticked on a
+    // worker pool. Channels share nothing within a tick, and their
+    // completions are delivered in channel order afterwards, so the results
+    // match ticking them one after the other.
+    ChannelPool* channel_pool = nullptr;
+
     vector<int> free_physical_pages;
     long free_physical_pages_remaining;
     map<pair<int, long>, long> page_translation;
@@ -180,6 +202,14 @@ public:
         }
 
         use_rest_of_addr_as_row_addr = configs.use_rest_of_addr_as_row_addr();
+        skip_idle_cycles = configs.skip_idle_cycles();
+        // printed command traces would interleave
+        int channel_threads = min(configs.get_int("channel_threads"), int(ctrls.size()));
+        if (channel_threads > 1 && !configs.print_cmd_trace()) {
+            channel_pool = new ChannelPool(channel_threads, ctrls.size());
+            for (auto ctrl : ctrls)
+                ctrl->defer_callbacks = true;
+        }
 
         dram_capacity
             .name("dram_capacity")
@@ -284,6 +314,7 @@ public:
 
     ~Memory()
     {
+        delete channel_pool;
         for (auto ctrl: ctrls)
             delete ctrl;
         delete spec;
@@ -324,6 +355,12 @@ public:
 
     void tick()
     {
+        if (skip_idle_cycles && ctrls[0]->clk + idle_cycles + 1 < idle_until) {
+            ++idle_cycles;
+            return;
+        }
+        apply_idle_cycles();
+
         ++num_dram_cycles;
         int cur_que_req_num = 0;
         int cur_que_readreq_num = 0;
@@ -338,17 +375,87 @@ public:
         in_queue_write_req_num_sum += cur_que_writereq_num;
 
         bool is_active = false;
-        for (auto ctrl : ctrls) {
-          is_active = is_active || ctrl->is_active();
-          ctrl->tick();
+        if (channel_pool) {
+          for (auto ctrl : ctrls)
+            is_active = is_active || ctrl->is_active();
+          channel_pool->run(&tick_channel, this);
+          for (auto ctrl : ctrls)
+            ctrl->replay_deferred();
+        } else {
+          for (auto ctrl : ctrls) {
+            is_active = is_active || ctrl->is_active();
+            ctrl->tick();
+          }
         }
         if (is_active) {
           ramulator_active_cycles++;
         }
+
+        if (skip_idle_cycles && --idle_probe_countdown == 0) {
+            idle_until = LONG_MAX;
+            for (auto ctrl : ctrls)
+                idle_until = min(idle_until, ctrl->next_event());
+            if (idle_until > ctrls[0]->clk + 1)
+                idle_probe_interval = 1;
+            else
+                idle_probe_interval = min(2 * idle_probe_interval, max_idle_probe_interval);
+            idle_probe_countdown = idle_probe_interval;
+        }
+    }
+
+    static void tick_channel(void* memory, int channel)
+    {
+        static_cast<Memory*>(memory)->ctrls[channel]->tick();
+    }
+
+    // Credit the skipped cycles to the per-cycle stats of the memory and of
+    // every controller, as if they had been ticked one by one
+    void apply_idle_cycles()
+    {
+        if (!idle_cycles)
+            return;
+        long cur_que_readreq_num = 0;
+        long cur_que_writereq_num = 0;
+        bool is_active = false;
+        for (auto ctrl : ctrls) {
+          cur_que_readreq_num += ctrl->readq.size() + ctrl->pending.size();
+          cur_que_writereq_num += ctrl->writeq.size();
+          is_active = is_active || ctrl->is_active();
+          ctrl->skip(idle_cycles);
+        }
+        num_dram_cycles += idle_cycles;
+        in_queue_req_num_sum += idle_cycles * (cur_que_readreq_num + cur_que_writereq_num);
+        in_queue_read_req_num_sum += idle_cycles * cur_que_readreq_num;
+        in_queue_write_req_num_sum += idle_cycles * cur_que_writereq_num;
+        if (is_active)
+            ramulator_active_cycles += idle_cycles;
+        idle_cycles = 0;
+    }
+
+    // Number of upcoming tick()s that would only count an idle cycle. Unlike
+    // the probes in tick(), this always looks up the next event.
+    long idle_ticks()
+    {
+        if (!skip_idle_cycles)
+            return 0;
+        apply_idle_cycles();
+        idle_until = LONG_MAX;
+        for (auto ctrl : ctrls)
+            idle_until = min(idle_until, ctrl->next_event());
+        return idle_until - ctrls[0]->clk - 1;
+    }
+
+    // Same as calling tick() the given number of times, which must not be
+    // more than idle_ticks()
+    void skip_ticks(long ticks)
+    {
+        assert(ctrls[0]->clk + idle_cycles + ticks < idle_until);
+        idle_cycles += ticks;
     }
 
     bool send(Request req)
     {
+        apply_idle_cycles();
         req.addr_vec.resize(addr_bits.size());
         long addr = req.addr;
         int coreid = req.coreid;
@@ -387,6 +494,7 @@ public:
         }
 
         if(ctrls[req.addr_vec[0]]->enqueue(req)) {
+            idle_until = 0;
             // tally stats here to avoid double counting for requests that aren't enqueued
             ++num_incoming_requests;
             if (req.type == Request::Type::READ) {
@@ -422,6 +530,7 @@ public:
     }
 
     void finish(void) {
+      apply_idle_cycles();
       dram_capacity = max_address;
       int *sz = spec->org_entry.count;
       maximum_bandwidth = spec->speed_entry.rate * 1e6 * spec->channel_width * sz[int(T::Level::Channel)] / 8;
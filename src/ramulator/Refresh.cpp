@@ -271,6 +271,13 @@ void Refresh<DSARP>::tick_ref() {
   if ((clk - refreshed) >= refresh_interval)
     inject_refresh(b_ref_rank);
 }
+
+// DSARP pulls refreshes in early depending on the queues, so every cycle
+// has to be ticked
+template<>
+long Refresh<DSARP>::next_ref() {
+  return clk + 1;
+}
 /**** End DSARP specialization ****/
 
 } /* namespace ramulator */
@@ -104,6 +104,16 @@ public:
     }
   }
 
+  // Earliest controller clk at which tick_ref() injects a refresh
+  long next_ref() {
+    return refreshed + ctrl->channel->spec->speed_entry.nREFI;
+  }
+
+  // Advance over cycles in which no refresh is due
+  void skip(long cycles) {
+    clk += cycles;
+  }
+
 private:
   // Keeping track of refresh status of every bank: + means ahead of schedule, - means behind schedule
   vector<vector<int>*> bank_refresh_backlog;
@@ -153,6 +163,7 @@ private:
 // where to look for these definitions when controller calls them!
 template<> Refresh<DSARP>::Refresh(Controller<DSARP>* ctrl);
 template<> void Refresh<DSARP>::tick_ref();
+template<> long Refresh<DSARP>::next_ref();
 
 } /* namespace ramulator */
 
@@ -22,6 +22,8 @@
 #ifndef __REQUEST_H
 #define __REQUEST_H
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 #include <functional>
 
@@ -30,13 +32,53 @@ using namespace std;
 namespace ramulator
 {
 
+/* Address of a request, one entry per DRAM level. The few levels of any
+   standard fit inline, so copying a request around the queues does not
+   allocate. */
+class AddrVec
+{
+public:
+    static constexpr int max_levels = 8;
+
+    AddrVec() : v(), n(0) {}
+    AddrVec(const vector<int>& addr_vec) : v(), n(0)
+    {
+        resize(addr_vec.size());
+        copy(addr_vec.begin(), addr_vec.end(), v);
+    }
+
+    operator vector<int>() const { return vector<int>(begin(), end()); }
+
+    size_t size() const { return n; }
+    void resize(size_t size, int value = 0)
+    {
+        assert(size <= size_t(max_levels));
+        for (size_t i = n; i < size; i++)
+            v[i] = value;
+        n = size;
+    }
+
+    int& operator[](size_t i) { return v[i]; }
+    const int& operator[](size_t i) const { return v[i]; }
+    int* data() { return v; }
+    const int* data() const { return v; }
+    int* begin() { return v; }
+    int* end() { return v + n; }
+    const int* begin() const { return v; }
+    const int* end() const { return v + n; }
+
+private:
+    int v[max_levels];
+    size_t n;
+};
+
 class Request
 {
 public:
     bool is_first_command;
     long addr;
     // long addr_row;
-    vector<int> addr_vec;
+    AddrVec addr_vec;
     // specify which core this request sent from, for virtual address translation
     int coreid;
 
@@ -62,11 +104,11 @@ public:
     Request(long addr, Type type, function<void(Request&)> callback, int coreid = 0)
         : is_first_command(true), addr(addr), coreid(coreid), type(type), callback(callback) {}
 
-    Request(vector<int>& addr_vec, Type type, function<void(Request&)> callback, int coreid = 0)
-        : is_first_command(true), addr_vec(addr_vec), coreid(coreid), type(type), callback(callback) {}
+    Request(const vector<int>& addr_vec, Type type, function<void(Request&)> callback, int coreid = 0)
+        : is_first_command(true), addr(-1), addr_vec(addr_vec), coreid(coreid), type(type), callback(callback) {}
 
     Request()
-        : is_first_command(true), coreid(0) {}
+        : is_first_command(true), addr(-1), coreid(0), type(Type::MAX) {}
 };
 
 } /*namespace ramulator*/
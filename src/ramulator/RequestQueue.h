@@ -0,0 +1,197 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __REQUEST_QUEUE_H
+#define __REQUEST_QUEUE_H
+
+#include <cassert>
+#include <iterator>
+#include <vector>
+
+#include "Request.h"
+
+using namespace std;
+
+namespace ramulator
+{
+
+/* Request queue of a controller. Requests live in a flat array of slots that
+   is reused as requests come and go, and are chained in arrival order twice:
+   across the whole queue, and per bank (or subarray, i.e. per row buffer).
+   The per-bank chains let the scheduler pick a request by looking at the
+   oldest requests of each bank instead of at every request. */
+class RequestQueue
+{
+    struct Slot {
+        Request req;
+        long seq;  // arrival order
+        int bank;
+        int prev, next;
+        int bank_prev, bank_next;
+    };
+
+public:
+    static constexpr int NONE = -1;
+
+    class iterator
+    {
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef Request value_type;
+        typedef ptrdiff_t difference_type;
+        typedef Request* pointer;
+        typedef Request& reference;
+
+        iterator() : queue(nullptr), slot(NONE) {}
+        iterator(RequestQueue* queue, int slot) : queue(queue), slot(slot) {}
+
+        Request& operator*() const { return queue->slots[slot].req; }
+        Request* operator->() const { return &queue->slots[slot].req; }
+        iterator& operator++() { slot = queue->slots[slot].next; return *this; }
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+        bool operator==(const iterator& other) const { return slot == other.slot; }
+        bool operator!=(const iterator& other) const { return slot != other.slot; }
+
+        // the next request of the same bank
+        iterator next_in_bank() const { return iterator(queue, queue->slots[slot].bank_next); }
+        // true if this request arrived before other
+        bool precedes(const iterator& other) const
+        {
+            return queue->slots[slot].seq < queue->slots[other.slot].seq;
+        }
+
+    private:
+        friend class RequestQueue;
+        RequestQueue* queue;
+        int slot;
+    };
+
+    /* The bank of a request is the flattened index of its address between
+       the channel and the row level; bank_levels holds the number of entries
+       of each of those levels. Requests with a wildcard in those levels
+       (e.g. rank refreshes) share one extra chain. */
+    void set_bank_levels(const vector<int>& levels)
+    {
+        assert(!count);
+        bank_levels = levels;
+        int banks = 1;
+        for (int& entries : bank_levels) {
+            entries = max(entries, 1);
+            banks *= entries;
+        }
+        bank_head.assign(banks + 1, NONE);
+        bank_tail.assign(banks + 1, NONE);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return !count; }
+
+    iterator begin() { return iterator(this, head); }
+    iterator end() { return iterator(this, NONE); }
+    Request& back() { return slots[tail].req; }
+
+    int num_banks() const { return bank_head.size(); }
+    // the oldest request of a bank, end() if it has none
+    iterator bank_begin(int bank) { return iterator(this, bank_head[bank]); }
+
+    void push_back(const Request& req)
+    {
+        int bank = bank_of(req.addr_vec);
+        int slot;
+        if (free_slots.size()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+            slots[slot].req = req;
+        } else {
+            slot = slots.size();
+            slots.push_back({req});
+        }
+        Slot& s = slots[slot];
+        s.seq = next_seq++;
+        s.bank = bank;
+        link(s, slot, head, tail, &Slot::prev, &Slot::next);
+        link(s, slot, bank_head[bank], bank_tail[bank], &Slot::bank_prev, &Slot::bank_next);
+        count++;
+    }
+
+    void pop_back() { erase(iterator(this, tail)); }
+
+    iterator erase(iterator it)
+    {
+        int slot = it.slot;
+        Slot& s = slots[slot];
+        int next = s.next;
+        unlink(s, head, tail, &Slot::prev, &Slot::next);
+        unlink(s, bank_head[s.bank], bank_tail[s.bank], &Slot::bank_prev, &Slot::bank_next);
+        free_slots.push_back(slot);
+        count--;
+        return iterator(this, next);
+    }
+
+private:
+    vector<Slot> slots;
+    vector<int> free_slots;
+    int head = NONE, tail = NONE;
+    size_t count = 0;
+    long next_seq = 0;
+
+    vector<int> bank_levels;
+    vector<int> bank_head = {NONE}, bank_tail = {NONE};
+
+    int bank_of(const AddrVec& addr_vec) const
+    {
+        int bank = 0;
+        for (size_t level = 0; level < bank_levels.size(); level++) {
+            int id = level + 1 < addr_vec.size() ? addr_vec[level + 1] : -1;
+            if (id < 0 || id >= bank_levels[level])
+                return bank_head.size() - 1;
+            bank = bank * bank_levels[level] + id;
+        }
+        return bank;
+    }
+
+    void link(Slot& s, int slot, int& first, int& last, int Slot::*prev, int Slot::*next)
+    {
+        s.*prev = last;
+        s.*next = NONE;
+        if (last != NONE)
+            slots[last].*next = slot;
+        else
+            first = slot;
+        last = slot;
+    }
+
+    void unlink(Slot& s, int& first, int& last, int Slot::*prev, int Slot::*next)
+    {
+        if (s.*prev != NONE)
+            slots[s.*prev].*next = s.*next;
+        else
+            first = s.*next;
+        if (s.*next != NONE)
+            slots[s.*next].*prev = s.*prev;
+        else
+            last = s.*prev;
+    }
+};
+
+} /*namespace ramulator*/
+
+#endif /*__REQUEST_QUEUE_H*/
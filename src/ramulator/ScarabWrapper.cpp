@@ -74,6 +74,14 @@ void ScarabWrapper::tick() {
   mem->tick();
 }
 
+long ScarabWrapper::idle_ticks() {
+  return mem->idle_ticks();
+}
+
+void ScarabWrapper::skip_ticks(long ticks) {
+  mem->skip_ticks(ticks);
+}
+
 bool ScarabWrapper::send(Request req) {
   return mem->send(req);
 }
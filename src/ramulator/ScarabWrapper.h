@@ -43,6 +43,8 @@ public:
     ScarabWrapper(const Config& configs, const unsigned int cacheline, void (* stats_callback)(int, int));
     ~ScarabWrapper();
     void tick();
+    long idle_ticks();
+    void skip_ticks(long ticks);
     bool send(Request req);
     void finish(void);
 
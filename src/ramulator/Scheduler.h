@@ -68,8 +68,12 @@ sure to set RAMULATOR_SCHEDULING_POLICY to one of the \
 available policies: FCFS, FRFCFS, FRFCFS_Cap, \
 FRFCFS_PriorHit"); }
 
-    list<Request>::iterator get_head(list<Request>& q)
+    RequestQueue::iterator get_head(RequestQueue& q)
     {
+      if ((policy == Policy::FRFCFS || policy == Policy::FRFCFS_Cap) &&
+          (&q == &ctrl->readq.q || &q == &ctrl->writeq.q) && ctrl->bank_indexed_scheduling())
+          return get_head_by_bank(q);
+
       // TODO make the decision at compile time
       if (policy != Policy::FRFCFS_PriorHit) {
         if (!q.size())
@@ -140,7 +144,47 @@ FRFCFS_PriorHit"); }
     }
 
 private:
-    typedef list<Request>::iterator ReqIter;
+    typedef RequestQueue::iterator ReqIter;
+
+    bool is_ready_under_cap(ReqIter req)
+    {
+        return this->ctrl->is_ready(req) &&
+               (policy != Policy::FRFCFS_Cap || this->ctrl->rowtable->get_hits(req->addr_vec) <= this->cap);
+    }
+
+    /* FRFCFS(_Cap) over readq or writeq: the oldest ready request, or the
+       oldest request if none is ready, like the compare[] fold over the whole
+       queue (requests of these queues all have the same type and arrive in
+       queue order).
+       All requests of a bank that hit the open row share their first command
+       and whether it is ready, and so do all that miss it. So the oldest
+       ready request of a bank is its oldest request, or the oldest request of
+       the other kind, and it takes at most two readiness checks per bank. */
+    ReqIter get_head_by_bank(RequestQueue& q)
+    {
+        ReqIter best = q.end();
+        for (int bank = 0; bank < q.num_banks(); bank++) {
+            ReqIter first = q.bank_begin(bank);
+            if (first == q.end() || (best != q.end() && best.precedes(first)))
+                continue;
+            if (is_ready_under_cap(first)) {
+                best = first;
+                continue;
+            }
+            bool first_hit = this->ctrl->is_row_hit(first);
+            for (ReqIter req = first.next_in_bank(); req != q.end(); req = req.next_in_bank()) {
+                if (best != q.end() && best.precedes(req))
+                    break;
+                if (this->ctrl->is_row_hit(req) != first_hit) {
+                    if (is_ready_under_cap(req))
+                        best = req;
+                    break;
+                }
+            }
+        }
+        return best != q.end() ? best : q.begin();
+    }
+
     function<ReqIter(ReqIter, ReqIter)> compare[int(Policy::MAX)] = {
         // FCFS
         [this] (ReqIter req1, ReqIter req2) {
@@ -309,7 +353,8 @@ public:
         } /* closing */
     }
 
-    int get_hits(const vector<int>& addr_vec, const bool to_opened_row = false)
+    template <typename AddrVecT>
+    int get_hits(const AddrVecT& addr_vec, const bool to_opened_row = false)
     {
         auto begin = addr_vec.begin();
         auto end = begin + int(T::Level::Row);
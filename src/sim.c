@@ -46,10 +46,13 @@
 #include "sim.h"
 #include "thread.h"
 
+#include "checkpoint.h"
 #include "cmp_model.h"
+#include "cycle_skip.h"
 #include "debug/memview.h"
 #include "debug/pipeview.h"
 #include "dumb_model.h"
+#include "fast_warmup.h"
 #include "frontend/pin_trace_fe.h"
 #include "model.h"
 #include "optimizer2.h"
@@ -80,14 +83,14 @@ Trigger* clear_stats;
 Counter* inst_limit;
 
 // Current version does not support more than 8 cores!
-Counter  unique_count;          /* the global unique op counter */
 Counter* unique_count_per_core; /* the unique op count per core */
 Counter* op_count;              /* the global op counter per core*/
 Counter* inst_count; /* the global instruction counter - retired per core */
 Counter* inst_count_fetched; /* the global FETCHED instruction counter - retired per core */
 Counter* uop_count;  /* the global uop counter - retired per core*/
-Counter  cycle_count = 0; /* the global cycle counter */
-Counter  sim_time    = 0; /* the global time counter */
+SIM_THREAD_LOCAL Counter unique_count = 0; /* the global unique op counter */
+SIM_THREAD_LOCAL Counter cycle_count  = 0; /* the global cycle counter */
+SIM_THREAD_LOCAL Counter sim_time     = 0; /* the global time counter */
 Counter* pret_inst_count; /* the global pseudo-retired instruction counter */
 Flag*    trace_read_done;
 Flag*    reached_exit;
@@ -130,7 +133,7 @@ Model* model; /* pointer to the simulator model being used
 
 Thread_Data
              single_td; /* cmp Only For single processor: backward compatibility issue*/
-Thread_Data* td = &single_td; /* array of tds for muti-core, all state
+SIM_THREAD_LOCAL Thread_Data* td = &single_td; /* array of tds for muti-core, all state
                                  associated with the simulated thread */
 
 /**************************************************************************************/
@@ -365,7 +368,7 @@ static inline Counter check_forward_progress(uns8 proc_id) {
              "%llu, state: %u\n",
              cmp_model.node_stage[proc_id].node_head->unique_num,
              cmp_model.node_stage[proc_id].node_head->op_pool_valid,
-             cmp_model.node_stage[proc_id].node_head->oracle_info.va,
+             OP_ORACLE(cmp_model.node_stage[proc_id].node_head).va,
              cmp_model.node_stage[proc_id].node_head->state,
              cmp_model.node_stage[proc_id].node_head->table_info->op_type,
              cmp_model.node_stage[proc_id].node_head->table_info->mem_type,
@@ -624,8 +627,10 @@ void uop_sim() {
           "FAST_FORWARD_UNTIL_ADDR works only for single core\n");
 
   Op         op;
+  Op_Cold    op_cold;
   Table_Info table_info;
   Inst_Info  inst_info;
+  op.cold       = &op_cold;
   op.table_info = &table_info;
   op.inst_info  = &inst_info;
   op.mbp7_info  = NULL;
@@ -642,7 +647,7 @@ void uop_sim() {
         do {
           frontend_fetch_op(proc_id, &op);
 
-          if(op.table_info->mem_type != NOT_MEM && op.oracle_info.va == 0) {
+          if(op.table_info->mem_type != NOT_MEM && OP_ORACLE(&op).va == 0) {
             FATAL_ERROR(proc_id, "Access to 0x0\n");
           }
 
@@ -706,6 +711,36 @@ void uop_sim() {
   }
 }
 
+/**************************************************************************************/
+/* fast_warmup_sim: warmup loop that feeds trace records straight to the
+   functional warmup (see fast_warmup.c) instead of fetching uops. Cores
+   advance one instruction per iteration, as in uop_sim(). */
+
+static void fast_warmup_sim() {
+  Flag warmup_done = FALSE;
+
+  fast_warmup_init();
+  while(!warmup_done) {
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      if(DUMB_CORE_ON && DUMB_CORE == proc_id)
+        continue;
+      Flag more = fast_warmup_inst(proc_id);
+      ASSERTM(proc_id, more, "Program ended before start of simulation\n");
+      inst_count[proc_id]++;
+    }
+    if(inst_count[0] == WARMUP) {
+      warmup_done = TRUE;
+      check_heartbeat(0, TRUE);
+    }
+    // HACK that ensures that cache replacement works in warmup
+    do {
+      freq_advance_time();
+    } while(!freq_is_ready(FREQ_DOMAIN_L1));
+    sim_time = freq_time();
+  }
+  fast_warmup_done();
+}
+
 /**************************************************************************************/
 /* full_sim: This is the main loop for running in full simulation mode.*/
 
@@ -717,9 +752,21 @@ void full_sim() {
   /* perform initialization  */
   init_model(WARMUP_MODE);  // make sure this happens before init_op_pool
 
-  if(WARMUP) {
+  if(CHECKPOINT_LOAD) {
+    /* the snapshot stands in for the warmup */
+    operating_mode = WARMUP_MODE;
+    checkpoint_load(CHECKPOINT_LOAD);
+    reset_uop_mode_counters();
+    reset_stats(FALSE);
+    freq_reset_cycle_counts();
+  } else if(WARMUP) {
     operating_mode = WARMUP_MODE;
-    uop_sim();
+    if(FAST_WARMUP)
+      fast_warmup_sim();
+    else
+      uop_sim();
+    if(CHECKPOINT_SAVE)
+      checkpoint_save(CHECKPOINT_SAVE);
     reset_uop_mode_counters();
     reset_stats(FALSE);  // ignore stats accumulated during warmup
     /* The call below resets the cycle counts of all frequency
@@ -748,6 +795,7 @@ void full_sim() {
 
   sim_limit   = trigger_create("SIM_LIMIT", SIM_LIMIT, TRIGGER_ONCE);
   clear_stats = trigger_create("CLEAR_STATS", CLEAR_STATS, TRIGGER_ONCE);
+  cycle_skip_init();
 
   /* main loop */
   while(!trigger_fired(sim_limit)) {
@@ -755,9 +803,9 @@ void full_sim() {
     if((EXIT_COND == LAST_DONE && all_sim_done) ||
        (EXIT_COND == FIRST_DONE && any_sim_done))
       break;
-    freq_advance_time();
+    cycle_skip_advance_time();  // freq_advance_time() unless cycles are skipped
     sim_time = freq_time();
-    model->cycle_func();
+    cycle_skip_cycle();  // calls model->cycle_func() unless the cycle is skipped
     if(SIM_MODEL != DUMB_MODEL && DUMB_CORE_ON)
       model_table[DUMB_MODEL].cycle_func();
 
@@ -840,6 +888,7 @@ void full_sim() {
   if(SIM_MODEL != DUMB_MODEL && DUMB_CORE_ON)
     model_table[DUMB_MODEL].done_func();
 
+  cycle_skip_done();
   stat_trace_done();
   if(PIPEVIEW)
     pipeview_done();
@@ -42,11 +42,16 @@ working on this (ob).
 #include "core.param.h"
 #include "general.param.h"
 
+/**************************************************************************************/
+/* Macros */
+
+#define STAT_COUNTS_ALIGN 64 /* host cache line size */
+
 /**************************************************************************************/
 /* Global Variables */
 
 #define DEF_STAT(name, type, ratio) \
-  {type##_TYPE_STAT, #name, {0}, {0}, ratio, __FILE__, FALSE},
+  {type##_TYPE_STAT, #name, NULL, NULL, ratio, __FILE__, FALSE},
 
 Stat global_stat_sample[] = {
 #include "stat_files.def"
@@ -54,7 +59,24 @@ Stat global_stat_sample[] = {
 
 #undef DEF_STAT
 
-Stat** global_stat_array;
+Stat**       global_stat_array;
+Stat_Count** global_stat_counts;
+Stat_Count** global_stat_totals;
+
+/* Masks over the stats (all ones or zero) that select the counter stats
+   (not FLOAT_TYPE_STAT) that accumulate into their totals on a reset. */
+static Counter* count_mask;
+static Counter* noreset_count_mask;
+static uns*     float_stats; /* indices of the FLOAT_TYPE_STATs */
+static uns      num_float_stats;
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static Stat_Count* alloc_stat_counts(void);
+static Flag        stat_is_noreset(const Stat* stat);
+static void        accumulate_stats(uns proc_id, const Counter* mask,
+                                    Flag noreset_only);
 
 /**************************************************************************************/
 // init_global_stats_array:
@@ -72,15 +94,60 @@ void init_global_stats_array() {
       stat->file_name = last_slash + 1;
   }
 
-  // Make a copy of stats array for each core
-  global_stat_array = (Stat**)malloc(NUM_CORES * sizeof(Stat*));
+  count_mask         = (Counter*)malloc(NUM_GLOBAL_STATS * sizeof(Counter));
+  noreset_count_mask = (Counter*)malloc(NUM_GLOBAL_STATS * sizeof(Counter));
+  float_stats        = (uns*)malloc(NUM_GLOBAL_STATS * sizeof(uns));
+  num_float_stats    = 0;
+  for(ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+    Stat* stat     = &global_stat_sample[ii];
+    count_mask[ii] = stat->type == FLOAT_TYPE_STAT ? 0 : ~0ULL;
+    noreset_count_mask[ii] = stat_is_noreset(stat) ? count_mask[ii] : 0;
+    if(stat->type == FLOAT_TYPE_STAT)
+      float_stats[num_float_stats++] = ii;
+  }
+
+  // Make a copy of stats array for each core, with the counts in separate
+  // per-core arrays
+  global_stat_array  = (Stat**)malloc(NUM_CORES * sizeof(Stat*));
+  global_stat_counts = (Stat_Count**)malloc(NUM_CORES * sizeof(Stat_Count*));
+  global_stat_totals = (Stat_Count**)malloc(NUM_CORES * sizeof(Stat_Count*));
   for(ii = 0; ii < NUM_CORES; ii++) {
     global_stat_array[ii] = (Stat*)malloc(NUM_GLOBAL_STATS * sizeof(Stat));
     memcpy(global_stat_array[ii], global_stat_sample,
            NUM_GLOBAL_STATS * sizeof(Stat));
+    global_stat_counts[ii] = alloc_stat_counts();
+    global_stat_totals[ii] = alloc_stat_counts();
+    for(uns jj = 0; jj < NUM_GLOBAL_STATS; jj++) {
+      global_stat_array[ii][jj].cur   = &global_stat_counts[ii][jj];
+      global_stat_array[ii][jj].total = &global_stat_totals[ii][jj];
+    }
   }
 }
 
+/**************************************************************************************/
+// alloc_stat_counts: returns a zeroed count array that starts and ends on a
+// cache line boundary, so that no two cores' counts share a line.
+
+static Stat_Count* alloc_stat_counts() {
+  size_t size = NUM_GLOBAL_STATS * sizeof(Stat_Count);
+  void*  ptr;
+  size = (size + STAT_COUNTS_ALIGN - 1) / STAT_COUNTS_ALIGN * STAT_COUNTS_ALIGN;
+  if(posix_memalign(&ptr, STAT_COUNTS_ALIGN, size))
+    FATAL_ERROR(0, "Could not allocate the stat counts\n");
+  memset(ptr, 0, size);
+  return (Stat_Count*)ptr;
+}
+
+/**************************************************************************************/
+// stat_is_noreset:
+
+static Flag stat_is_noreset(const Stat* stat) {
+  const char* noreset_prefix = "NORESET";
+  const char* param_prefix   = "PARAM";
+  return !strncmp(stat->name, noreset_prefix, strlen(noreset_prefix)) ||
+         !strncmp(stat->name, param_prefix, strlen(param_prefix));
+}
+
 /**************************************************************************************/
 // gen_stat_output_file:
 
@@ -129,13 +196,9 @@ void init_global_stats(uns8 proc_id) {
   uns ii;
 
   for(ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
-    Stat*       stat           = &global_stat_array[proc_id][ii];
-    const char* noreset_prefix = "NORESET";
-    const char* param_prefix   = "PARAM";
-    if(!strncmp(stat->name, noreset_prefix, strlen(noreset_prefix)) ||
-       !strncmp(stat->name, param_prefix, strlen(param_prefix))) {
+    Stat* stat = &global_stat_array[proc_id][ii];
+    if(stat_is_noreset(stat))
       stat->noreset = TRUE;
-    }
   }
 }
 
@@ -163,14 +226,14 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
   if(!DUMP_STATS)
     return;
 
+  /* update the total counter for this interval */
+  Stat_Count* cur   = stat_array[0].cur;
+  Stat_Count* total = stat_array[0].total;
   for(ii = 0; ii < num_stats; ii++) {
-    Stat* s = &stat_array[ii];
-
-    /* update the total counter for this interval */
-    if(s->type == FLOAT_TYPE_STAT)
-      s->total_value += s->value;
+    if(stat_array[ii].type == FLOAT_TYPE_STAT)
+      total[ii].value += cur[ii].value;
     else
-      s->total_count += s->count;
+      total[ii].count += cur[ii].count;
   }
 
   const char* last_file_name  = NULL;
@@ -253,31 +316,31 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
     switch(s->type) {
       case COUNT_TYPE_STAT:
         if(!in_dist) {
-          fprintf(file_stream, "%13s %13s    %13s %13s\n", unsstr64(s->count),
-                  "", unsstr64(s->total_count), "");
+          fprintf(file_stream, "%13s %13s    %13s %13s\n", unsstr64(s->cur->count),
+                  "", unsstr64(s->total->count), "");
 
-          fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->count));
-          fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total_count));
+          fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->cur->count));
+          fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total->count));
         } else {
           fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%",
-                  unsstr64(s->count), (double)s->count / dist_sum * 100,
-                  unsstr64(s->total_count),
-                  (double)s->total_count / total_dist_sum * 100);
-
-          fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->count));
-          fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->count / dist_sum * 100);
-          fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total_count));
-          fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total_count / total_dist_sum * 100);
+                  unsstr64(s->cur->count), (double)s->cur->count / dist_sum * 100,
+                  unsstr64(s->total->count),
+                  (double)s->total->count / total_dist_sum * 100);
+
+          fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->cur->count));
+          fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->cur->count / dist_sum * 100);
+          fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total->count));
+          fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total->count / total_dist_sum * 100);
         }
         break;
 
       case FLOAT_TYPE_STAT:
         ASSERTM(0, !in_dist, "Distributions not supported for float stats\n");
-        fprintf(file_stream, "%13lf %13s    %13lf %13s\n", s->value, "",
-                s->total_value, "");
+        fprintf(file_stream, "%13lf %13s    %13lf %13s\n", s->cur->value, "",
+                s->total->value, "");
 
-        fprintf(csv_file_stream, "%s_value, %13lf\n", s->name, s->value);
-        fprintf(csv_file_stream, "%s_total_value, %13lf\n", s->name, s->total_value);    
+        fprintf(csv_file_stream, "%s_value, %13lf\n", s->name, s->cur->value);
+        fprintf(csv_file_stream, "%s_total_value, %13lf\n", s->name, s->total->value);    
         break;
 
       case DIST_TYPE_STAT:
@@ -285,64 +348,64 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
           uns jj;
 
           in_dist           = TRUE;
-          dist_sum          = s->count;
-          total_dist_sum    = s->total_count;
+          dist_sum          = s->cur->count;
+          total_dist_sum    = s->total->count;
           dist_vtotal       = 0;
           total_dist_vtotal = 0;
 
           for(jj = ii + 1; stat_array[jj].type != DIST_TYPE_STAT; jj++) {
-            dist_sum += stat_array[jj].count;
-            total_dist_sum += stat_array[jj].total_count;
-            dist_vtotal += (jj - ii) * stat_array[jj].count;
-            total_dist_vtotal += (jj - ii) * stat_array[jj].total_count;
+            dist_sum += stat_array[jj].cur->count;
+            total_dist_sum += stat_array[jj].total->count;
+            dist_vtotal += (jj - ii) * stat_array[jj].cur->count;
+            total_dist_vtotal += (jj - ii) * stat_array[jj].total->count;
           }
-          dist_sum += stat_array[jj].count;
-          total_dist_sum += stat_array[jj].total_count;
-          dist_vtotal += (jj - ii) * stat_array[jj].count;
-          total_dist_vtotal += (jj - ii) * stat_array[jj].total_count;
+          dist_sum += stat_array[jj].cur->count;
+          total_dist_sum += stat_array[jj].total->count;
+          dist_vtotal += (jj - ii) * stat_array[jj].cur->count;
+          total_dist_vtotal += (jj - ii) * stat_array[jj].total->count;
 
           dist_variance = pow((0.0 - ((double)dist_vtotal / dist_sum)), 2) *
-                          stat_array[jj].count;
+                          stat_array[jj].cur->count;
           total_dist_variance =
             pow((0.0 - ((double)total_dist_vtotal / total_dist_sum)), 2) *
-            stat_array[jj].total_count;
+            stat_array[jj].total->count;
           for(jj = ii + 1; stat_array[jj].type != DIST_TYPE_STAT; jj++) {
             dist_variance += pow((jj - ii - ((double)dist_vtotal / dist_sum)),
                                  2) *
-                             stat_array[jj].count;
+                             stat_array[jj].cur->count;
             total_dist_variance +=
               pow((jj - ii - ((double)total_dist_vtotal / total_dist_sum)), 2) *
-              stat_array[jj].total_count;
+              stat_array[jj].total->count;
           }
           dist_variance += pow((jj - ii - ((double)dist_vtotal / dist_sum)),
                                2) *
-                           stat_array[jj].count;
+                           stat_array[jj].cur->count;
           total_dist_variance +=
             pow((jj - ii - ((double)total_dist_vtotal / total_dist_sum)), 2) *
-            stat_array[jj].total_count;
+            stat_array[jj].total->count;
           dist_variance /= dist_sum - 1;
           total_dist_variance /= total_dist_sum - 1;
 
           fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%",
-                  unsstr64(s->count), (double)s->count / dist_sum * 100,
-                  unsstr64(s->total_count),
-                  (double)s->total_count / total_dist_sum * 100);
-
-          fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->count));
-          fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->count / dist_sum * 100);
-          fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total_count));
-          fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total_count / total_dist_sum * 100);
+                  unsstr64(s->cur->count), (double)s->cur->count / dist_sum * 100,
+                  unsstr64(s->total->count),
+                  (double)s->total->count / total_dist_sum * 100);
+
+          fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->cur->count));
+          fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->cur->count / dist_sum * 100);
+          fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total->count));
+          fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total->count / total_dist_sum * 100);
         } else {
           in_dist = FALSE;
           fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%\n",
-                  unsstr64(s->count), (double)s->count / dist_sum * 100,
-                  unsstr64(s->total_count),
-                  (double)s->total_count / total_dist_sum * 100);
+                  unsstr64(s->cur->count), (double)s->cur->count / dist_sum * 100,
+                  unsstr64(s->total->count),
+                  (double)s->total->count / total_dist_sum * 100);
 
-          fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->count));
-          fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->count / dist_sum * 100);
-          fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total_count));
-          fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total_count / total_dist_sum * 100);
+          fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->cur->count));
+          fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->cur->count / dist_sum * 100);
+          fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total->count));
+          fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total->count / total_dist_sum * 100);
 
           // print sum information
           fprintf(file_stream, "%-40s %13s %12.3f%%    %13s %12.3f%%\n", "",
@@ -369,84 +432,84 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
         break;
 
       case PER_INST_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)s->count / (double)inst_count[proc_id],
-                unsstr64(s->total_count),
-                (double)s->total_count / (double)inst_count[proc_id]);
-
-        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->count));
-        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->count / (double)inst_count[proc_id]);
-        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total_count));
-        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total_count / (double)inst_count[proc_id]);
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->cur->count),
+                (double)s->cur->count / (double)inst_count[proc_id],
+                unsstr64(s->total->count),
+                (double)s->total->count / (double)inst_count[proc_id]);
+
+        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->cur->count));
+        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->cur->count / (double)inst_count[proc_id]);
+        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total->count));
+        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total->count / (double)inst_count[proc_id]);
         break;
 
       case PER_1000_INST_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)1000.0 * (double)s->count / (double)inst_count[proc_id],
-                unsstr64(s->total_count),
-                (double)1000.0 * (double)s->total_count /
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->cur->count),
+                (double)1000.0 * (double)s->cur->count / (double)inst_count[proc_id],
+                unsstr64(s->total->count),
+                (double)1000.0 * (double)s->total->count /
                   (double)inst_count[proc_id]);
 
-        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->count));
-        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)1000.0 * (double)s->count / (double)inst_count[proc_id]);
-        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total_count));
-        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)1000.0 * (double)s->total_count / 
+        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->cur->count));
+        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)1000.0 * (double)s->cur->count / (double)inst_count[proc_id]);
+        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total->count));
+        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)1000.0 * (double)s->total->count / 
                 (double)inst_count[proc_id]);
         break;
 
       case PER_1000_PRET_INST_TYPE_STAT:
         fprintf(
-          file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-          (double)1000.0 * (double)s->count / (double)pret_inst_count[proc_id],
-          unsstr64(s->total_count),
-          (double)1000.0 * (double)s->total_count / (double)pret_inst_count[0]);
+          file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->cur->count),
+          (double)1000.0 * (double)s->cur->count / (double)pret_inst_count[proc_id],
+          unsstr64(s->total->count),
+          (double)1000.0 * (double)s->total->count / (double)pret_inst_count[0]);
 
 
-        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->count));
-        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)1000.0 * (double)s->count / (double)pret_inst_count[proc_id]);
-        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total_count));
-        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)1000.0 * (double)s->total_count / (double)pret_inst_count[0]);
+        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->cur->count));
+        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)1000.0 * (double)s->cur->count / (double)pret_inst_count[proc_id]);
+        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total->count));
+        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)1000.0 * (double)s->total->count / (double)pret_inst_count[0]);
         break;
 
       case PER_CYCLE_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)s->count / (double)cycle_count,
-                unsstr64(s->total_count),
-                (double)s->total_count / (double)cycle_count);
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->cur->count),
+                (double)s->cur->count / (double)cycle_count,
+                unsstr64(s->total->count),
+                (double)s->total->count / (double)cycle_count);
                 
-        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->count));
-        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->count / (double)cycle_count);
-        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total_count));
-        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total_count / (double)cycle_count);
+        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->cur->count));
+        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->cur->count / (double)cycle_count);
+        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total->count));
+        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total->count / (double)cycle_count);
         break;
 
       case RATIO_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)s->count / (double)(stat_array[s->ratio_stat].count),
-                unsstr64(s->total_count),
-                (double)s->total_count /
-                  (double)stat_array[s->ratio_stat].total_count);
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->cur->count),
+                (double)s->cur->count / (double)(stat_array[s->ratio_stat].cur->count),
+                unsstr64(s->total->count),
+                (double)s->total->count /
+                  (double)stat_array[s->ratio_stat].total->count);
                 
-        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->count));
-        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->count / (double)(stat_array[s->ratio_stat].count));
-        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total_count));
-        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total_count /
-                  (double)stat_array[s->ratio_stat].total_count);
+        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->cur->count));
+        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->cur->count / (double)(stat_array[s->ratio_stat].cur->count));
+        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total->count));
+        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total->count /
+                  (double)stat_array[s->ratio_stat].total->count);
         break;
 
       case PERCENT_TYPE_STAT:
         fprintf(
-          file_stream, "%13s %12.3f%%    %13s %12.3f%%\n", unsstr64(s->count),
-          (double)s->count * 100 / (double)(stat_array[s->ratio_stat].count),
-          unsstr64(s->total_count),
-          (double)s->total_count * 100 /
-            (double)stat_array[s->ratio_stat].total_count);
+          file_stream, "%13s %12.3f%%    %13s %12.3f%%\n", unsstr64(s->cur->count),
+          (double)s->cur->count * 100 / (double)(stat_array[s->ratio_stat].cur->count),
+          unsstr64(s->total->count),
+          (double)s->total->count * 100 /
+            (double)stat_array[s->ratio_stat].total->count);
                 
-        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->count));
-        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->count * 100 / (double)(stat_array[s->ratio_stat].count));
-        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total_count));
-        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total_count * 100 /
-            (double)stat_array[s->ratio_stat].total_count);
+        fprintf(csv_file_stream, "%s_count, %13s\n", s->name, unsstr64(s->cur->count));
+        fprintf(csv_file_stream, "%s_pct, %12.3f\n", s->name, (double)s->cur->count * 100 / (double)(stat_array[s->ratio_stat].cur->count));
+        fprintf(csv_file_stream, "%s_total_count, %13s\n", s->name, unsstr64(s->total->count));
+        fprintf(csv_file_stream, "%s_total_pct, %12.3f\n", s->name, (double)s->total->count * 100 /
+            (double)stat_array[s->ratio_stat].total->count);
         break;
 
       case LINE_TYPE_STAT:
@@ -476,21 +539,15 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
     csv_file_stream = NULL;
   }
 
-  /* reset the interval counters */
-  for(ii = 0; ii < num_stats; ii++) {
-    Stat* s = &stat_array[ii];
-    if(s->type == FLOAT_TYPE_STAT)
-      s->value = 0.0;
-    else
-      s->count = 0;
-  }
+  /* reset the interval counters (0.0 is all zero bits) */
+  memset(stat_array[0].cur, 0, num_stats * sizeof(Stat_Count));
 }
 
 /**************************************************************************************/
-/* dump_stats: */
+/* reset_stats: */
 
 void reset_stats(Flag keep_total) {
-  uns proc_id, ii;
+  uns proc_id;
   if(!opt2_in_use() || opt2_is_leader()) {
     fprintf(mystdout, "** Stats Cleared:   insts: { ");
     for(proc_id = 0; proc_id < NUM_CORES; proc_id++)
@@ -500,19 +557,34 @@ void reset_stats(Flag keep_total) {
     fflush(mystdout);
   }
 
-  for(ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
-    for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-      Stat* stat = &global_stat_array[proc_id][ii];
-      if(stat->type == FLOAT_TYPE_STAT) {
-        if(keep_total || stat->noreset)
-          stat->total_value += stat->value;
-        stat->value = 0.0;
-      } else {
-        if(keep_total || stat->noreset)
-          stat->total_count += stat->count;
-        stat->count = 0ULL;
-      }
-    }
+  for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    accumulate_stats(proc_id, keep_total ? count_mask : noreset_count_mask,
+                     !keep_total);
+    memset(global_stat_counts[proc_id], 0,
+           NUM_GLOBAL_STATS * sizeof(Stat_Count));
+  }
+}
+
+/**************************************************************************************/
+/* accumulate_stats: adds the current counts of a core to its totals.  The
+ * counter stats are added in one branch-free pass over the dense arrays (the
+ * mask drops the float and, if requested, the resettable stats); the few
+ * float stats are added one by one. */
+
+static void accumulate_stats(uns proc_id, const Counter* mask,
+                             Flag noreset_only) {
+  const Counter* restrict cur   = &global_stat_counts[proc_id][0].count;
+  Counter* restrict       total = &global_stat_totals[proc_id][0].count;
+  uns                     ii;
+
+  for(ii = 0; ii < NUM_GLOBAL_STATS; ii++)
+    total[ii] += cur[ii] & mask[ii];
+
+  for(ii = 0; ii < num_float_stats; ii++) {
+    uns stat = float_stats[ii];
+    if(!noreset_only || global_stat_array[proc_id][stat].noreset)
+      global_stat_totals[proc_id][stat].value +=
+        global_stat_counts[proc_id][stat].value;
   }
 }
 
@@ -529,6 +601,19 @@ Stat_Enum get_stat_idx(const char* name) {
   return ii;  // equals NUM_GLOBAL_STATS if stat not found
 }
 
+/**************************************************************************************/
+/* require_stat: FATAL if the simulation reads a stat whose group is compiled
+   out, since it would silently read zero. */
+
+void require_stat(Stat_Enum stat) {
+  if(!STAT_ON(stat)) {
+    FATAL_ERROR(0,
+                "Stat %s is read by the simulation, but its stat group is "
+                "compiled out (SCARAB_NO_STAT_GROUPS)\n",
+                global_stat_array[0][stat].name);
+  }
+}
+
 /**************************************************************************************/
 /* get_stat: */
 
@@ -550,7 +635,7 @@ Counter get_accum_stat_event(Stat_Enum name) {
     return 0;
 
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    accum += global_stat_array[proc_id][name].total_count;
+    accum += global_stat_totals[proc_id][name].count;
   }
 
   return accum;
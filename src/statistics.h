@@ -73,17 +73,19 @@ typedef enum Stat_Type_enum {
 } Stat_Type;
 
 
+/* The count or value of one stat of one core.  The counts of a core are kept
+   in a dense array apart from the stat metadata (global_stat_counts), so that
+   the counters a pipeline stage increments share few cache lines. */
+typedef union Stat_Count_union {
+  Counter count;  // all types but FLOAT_TYPE_STAT
+  double  value;  // FLOAT_TYPE_STAT
+} Stat_Count;
+
 typedef struct Stat_struct {
-  Stat_Type   type;  // see types above
-  const char* name;  // name of stat
-  union {
-    Counter count;  // count during the current stat interval
-    double  value;  // value during the current stat interval
-  };
-  union {
-    Counter total_count;  // total count from beginning of run
-    double  total_value;  // total value from beginning of run
-  };
+  Stat_Type   type;        // see types above
+  const char* name;        // name of stat
+  Stat_Count* cur;         // count during the current stat interval
+  Stat_Count* total;       // total count from beginning of run
   Stat_Enum   ratio_stat;  // stat that to use in the ratio
   const char* file_name;   // name of file to print stats
   Flag noreset;  // this stat does not get reset (name has prefix "NORESET")
@@ -105,49 +107,98 @@ typedef struct Uop_Queue_Fill_Time_struct {
 /**************************************************************************************/
 /* Macros */
 
+/* Stat groups (the .stat.def files included by stat_files.def) can be
+   compiled out with -DNO_STAT_<GROUP>.  Their stats keep their enum values and
+   are dumped as zero, but the STAT_EVENTs on them compile to nothing. */
+#if defined(NO_STAT_FETCH) || defined(NO_STAT_BP) || defined(NO_STAT_MEMORY) || \
+  defined(NO_STAT_INST) || defined(NO_STAT_STREAM) ||                            \
+  defined(NO_STAT_L2L1PREF) || defined(NO_STAT_POWER) || defined(NO_STAT_PREF)
+#define STAT_GROUPS_OFF
+#endif
+
 #ifndef NO_STAT
-#define STAT_EVENT(proc_id, stat)             \
-  do {                                        \
-    global_stat_array[proc_id][stat].count++; \
+#ifdef STAT_GROUPS_OFF
+#define DEF_STAT(name, type, ratio) STAT_GROUP_ON,
+static const Flag stat_group_on[] = {
+#include "stat_files.def"
+};
+#undef DEF_STAT
+#undef STAT_GROUP_ON
+#define STAT_ON(stat) (stat_group_on[stat])
+#else
+#define STAT_ON(stat) TRUE
+#endif
+
+#define STAT_EVENT(proc_id, stat)               \
+  do {                                          \
+    if(STAT_ON(stat))                           \
+      global_stat_counts[proc_id][stat].count++; \
+  } while(0)
+
+#define STAT_EVENT_ALL(stat)                               \
+  do {                                                     \
+    if(STAT_ON(stat))                                      \
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
+        global_stat_counts[proc_id][stat].count++;         \
+  } while(0)
+
+#define INC_STAT_EVENT(proc_id, stat, inc)             \
+  do {                                                 \
+    if(STAT_ON(stat))                                  \
+      global_stat_counts[proc_id][stat].count += (inc); \
   } while(0)
 
-#define STAT_EVENT_ALL(stat)                             \
-  do {                                                   \
-    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
-      global_stat_array[proc_id][stat].count++;          \
+#define INC_STAT_EVENT_ALL(stat, inc)                      \
+  do {                                                     \
+    if(STAT_ON(stat))                                      \
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
+        global_stat_counts[proc_id][stat].count += (inc);  \
   } while(0)
 
-#define INC_STAT_EVENT(proc_id, stat, inc)           \
-  do {                                               \
-    global_stat_array[proc_id][stat].count += (inc); \
+#define INC_STAT_VALUE(proc_id, stat, inc)             \
+  do {                                                 \
+    if(STAT_ON(stat))                                  \
+      global_stat_counts[proc_id][stat].value += (inc); \
   } while(0)
 
-#define INC_STAT_EVENT_ALL(stat, inc)                    \
-  do {                                                   \
-    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
-      global_stat_array[proc_id][stat].count += (inc);   \
+#define INC_STAT_VALUE_ALL(stat, inc)                      \
+  do {                                                     \
+    if(STAT_ON(stat))                                      \
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
+        global_stat_counts[proc_id][stat].value += (inc);  \
   } while(0)
 
-#define INC_STAT_VALUE(proc_id, stat, inc)           \
-  do {                                               \
-    global_stat_array[proc_id][stat].value += (inc); \
+/* For the stats of another core (usually the totals kept in core 0) or of
+   all cores, updated while the cores run on parallel host threads (see
+   cmp_threads.c).  The adds are atomic, so the totals do not depend on the
+   thread schedule. */
+#define SHARED_STAT_EVENT(proc_id, stat) \
+  SHARED_INC_STAT_EVENT(proc_id, stat, 1)
+
+#define SHARED_STAT_EVENT_ALL(stat)                                        \
+  do {                                                                     \
+    if(STAT_ON(stat))                                                      \
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)                 \
+        __atomic_fetch_add(&global_stat_counts[proc_id][stat].count,       \
+                           1, __ATOMIC_RELAXED);                           \
   } while(0)
 
-#define INC_STAT_VALUE_ALL(stat, inc)                    \
-  do {                                                   \
-    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
-      global_stat_array[proc_id][stat].value += (inc);   \
+#define SHARED_INC_STAT_EVENT(proc_id, stat, inc)                          \
+  do {                                                                     \
+    if(STAT_ON(stat))                                                      \
+      __atomic_fetch_add(&global_stat_counts[proc_id][stat].count, (inc),  \
+                         __ATOMIC_RELAXED);                                \
   } while(0)
 
-#define GET_STAT_EVENT(proc_id, stat) (global_stat_array[proc_id][stat].count)
-#define GET_TOTAL_STAT_EVENT(proc_id, stat) \
-  (global_stat_array[proc_id][stat].count + \
-   global_stat_array[proc_id][stat].total_count)
-#define GET_TOTAL_STAT_VALUE(proc_id, stat) \
-  (global_stat_array[proc_id][stat].value + \
-   global_stat_array[proc_id][stat].total_value)
+#define GET_STAT_EVENT(proc_id, stat) (global_stat_counts[proc_id][stat].count)
+#define GET_TOTAL_STAT_EVENT(proc_id, stat)   \
+  (global_stat_counts[proc_id][stat].count + \
+   global_stat_totals[proc_id][stat].count)
+#define GET_TOTAL_STAT_VALUE(proc_id, stat)   \
+  (global_stat_counts[proc_id][stat].value + \
+   global_stat_totals[proc_id][stat].value)
 #define GET_ACCUM_STAT_EVENT(stat) get_accum_stat_event(stat)
-#define RESET_STAT(proc_id, stat) (global_stat_array[proc_id][stat].count = 0)
+#define RESET_STAT(proc_id, stat) (global_stat_counts[proc_id][stat].count = 0)
 
 #define NO_RATIO NUM_GLOBAL_STATS
 
@@ -159,6 +210,9 @@ typedef struct Uop_Queue_Fill_Time_struct {
 #define INC_STAT_EVENT_ALL(stat, inc)
 #define INC_STAT_VALUE(proc_id, stat, inc)
 #define INC_STAT_VALUE_ALL(stat, inc)
+#define SHARED_STAT_EVENT(proc_id, stat)
+#define SHARED_STAT_EVENT_ALL(stat)
+#define SHARED_INC_STAT_EVENT(proc_id, stat, inc)
 #define GET_STAT_EVENT(proc_id, stat) 0
 #define GET_TOTAL_STAT_EVENT(proc_id, stat) 0
 #define GET_TOTAL_STAT_VALUE(proc_id, stat)
@@ -172,7 +226,9 @@ typedef struct Uop_Queue_Fill_Time_struct {
 /* Global Variables */
 
 #ifndef NO_STAT
-extern Stat** global_stat_array;
+extern Stat**       global_stat_array;  /* metadata, [proc_id][stat] */
+extern Stat_Count** global_stat_counts; /* current interval, [proc_id][stat] */
+extern Stat_Count** global_stat_totals; /* from beginning of run */
 #endif
 
 
@@ -189,6 +245,7 @@ void        dump_stats(uns8, Flag, Stat[], uns);
 void        reset_stats(Flag);
 void        fprint_line(FILE*);
 Stat_Enum   get_stat_idx(const char* name);
+void        require_stat(Stat_Enum stat);
 const Stat* get_stat(uns8, const char*);
 Counter     get_accum_stat_event(Stat_Enum name);
 
@@ -0,0 +1,104 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "gtest/gtest.h"
+
+#include "../libs/cache_engine.h"
+
+SIM_THREAD_LOCAL Counter cycle_count = 0;
+
+struct Test_Payload {
+  Addr addr;
+  uns  value;
+};
+
+typedef Cache_Engine<Addr, Test_Payload, Cache_Addr_Index, Cache_Param_Repl>
+  Test_Cache;
+
+// 4 sets of 2 ways with 64B lines
+static Test_Cache make_cache(Repl_Policy policy) {
+  return Test_Cache(8, 2, Cache_Addr_Index{6, 4}, Cache_Param_Repl(policy));
+}
+
+static Addr line_in_set(uns set, uns nth) {
+  return (Addr)(nth * 4 + set) << 6;
+}
+
+TEST(CacheEngineTest, InsertAccessInvalidate) {
+  Test_Cache cache = make_cache(REPL_TRUE_LRU);
+  Addr       addr  = line_in_set(1, 0);
+
+  EXPECT_EQ(cache.access(addr, true), nullptr);
+  Test_Cache::Line evicted = cache.insert(addr, Test_Payload{addr, 7});
+  EXPECT_FALSE(evicted.valid);
+
+  Test_Payload* payload = cache.access(addr, true);
+  ASSERT_NE(payload, nullptr);
+  EXPECT_EQ(payload->value, 7u);
+  payload->value = 8;
+  EXPECT_EQ(cache.access(addr, false)->value, 8u);
+
+  Test_Cache::Line invalidated = cache.invalidate(addr);
+  EXPECT_TRUE(invalidated.valid);
+  EXPECT_EQ(invalidated.key, addr);
+  EXPECT_EQ(invalidated.data.value, 8u);
+  EXPECT_EQ(cache.access(addr, true), nullptr);
+  EXPECT_FALSE(cache.invalidate(addr).valid);
+}
+
+TEST(CacheEngineTest, LruEvictsLeastRecentlyUsed) {
+  Test_Cache cache = make_cache(REPL_TRUE_LRU);
+  Addr       a = line_in_set(2, 0), b = line_in_set(2, 1), c = line_in_set(2, 2);
+
+  cycle_count = 1;
+  cache.insert(a, Test_Payload{a, 1});
+  cycle_count = 2;
+  cache.insert(b, Test_Payload{b, 2});
+  // a becomes the most recently used line
+  cycle_count = 3;
+  ASSERT_NE(cache.access(a, true), nullptr);
+
+  cycle_count = 4;
+  Test_Cache::Line evicted = cache.insert(c, Test_Payload{c, 3});
+  EXPECT_TRUE(evicted.valid);
+  EXPECT_EQ(evicted.key, b);
+  EXPECT_EQ(evicted.data.value, 2u);
+  EXPECT_NE(cache.access(a, false), nullptr);
+  EXPECT_NE(cache.access(c, false), nullptr);
+  // the other sets are untouched
+  EXPECT_EQ(cache.access(line_in_set(1, 0), false), nullptr);
+}
+
+TEST(CacheEngineTest, InvalidWaysAreFilledFirst) {
+  Test_Cache cache = make_cache(REPL_ROUND_ROBIN);
+  Addr       a = line_in_set(0, 0), b = line_in_set(0, 1), c = line_in_set(0, 2);
+
+  cache.insert(a, Test_Payload{a, 1});
+  cache.insert(b, Test_Payload{b, 2});
+  cache.invalidate(a);
+  EXPECT_FALSE(cache.insert(c, Test_Payload{c, 3}).valid);
+  EXPECT_NE(cache.access(b, false), nullptr);
+  EXPECT_NE(cache.access(c, false), nullptr);
+
+  // round robin starts with way 1 (b), then way 0 (c)
+  EXPECT_EQ(cache.insert(a, Test_Payload{a, 1}).key, b);
+  EXPECT_EQ(cache.insert(b, Test_Payload{b, 2}).key, c);
+}
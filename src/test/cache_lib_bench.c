@@ -0,0 +1,226 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : test/cache_lib_bench.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Microbenchmark of cache_access.  Replays an access stream
+ *                through cache_lib caches of a few typical shapes and
+ *                policies, once with cache_access and once with the lookup
+ *                cache_lib used before the packed tag array (a walk over the
+ *                Cache_Entry structs of the set), checks that both see the
+ *                same hits and reports their speed.
+ *
+ *                Usage: cache_lib_bench [stream_file]
+ *                The stream file holds one hexadecimal address per line (for
+ *                example the addresses of a memtrace); without it a synthetic
+ *                stream is used.
+ *
+ *                The speedups vary a lot from run to run, so compare several
+ *                runs. On one core of a shared x86-64 VM with the synthetic
+ *                stream, five runs per build gave 0.91-1.62x with SSE2 and
+ *                0.94-2.21x with AVX2 (BENCH_FLAGS=-mavx2). The LRU caches
+ *                of 8 or more ways gain the most. The SRRIP/DRRIP caches
+ *                keep the old lookup, so both sides run the same code
+ *                there and their rows only show the run-to-run noise.
+ ***************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../globals/global_defs.h"
+#include "../globals/global_types.h"
+#include "../libs/cache_lib.h"
+
+#define SYNTHETIC_STREAM_LENGTH 4000000
+#define BENCH_REPEATS 4
+
+SIM_THREAD_LOCAL Counter sim_time = 0;
+
+const uns  NUM_CORES             = 1;
+const uns  NODE_TABLE_SIZE       = 256;
+const Flag USE_UNSURE_FREE_LISTS = FALSE;
+const Flag L1_PART_ON            = FALSE;
+
+typedef struct Bench_Config_struct {
+  const char* name;
+  uns         size;
+  uns         assoc;
+  uns         line_size;
+  Repl_Policy policy;
+} Bench_Config;
+
+static const Bench_Config configs[] = {
+  {"icache 32KB 8-way LRU", 32 * 1024, 8, 64, REPL_TRUE_LRU},
+  {"dcache 48KB 12-way LRU", 48 * 1024, 12, 64, REPL_TRUE_LRU},
+  {"btb 4K 4-way LRU", 4096 * 4, 4, 4, REPL_TRUE_LRU},
+  {"mlc 1MB 16-way SRRIP", 1024 * 1024, 16, 64, REPL_SRRIP},
+  {"llc 2MB 16-way DRRIP", 2 * 1024 * 1024, 16, 64, REPL_DRRIP},
+  {"fa 64-entry LRU", 64 * 64, 64, 64, REPL_TRUE_LRU},
+};
+
+typedef void* (*Access_Func)(Cache*, Addr, Addr*, Flag);
+
+/**************************************************************************************/
+/* old_cache_access: the cache_access lookup before the packed tag array */
+
+static void* old_cache_access(Cache* cache, Addr addr, Addr* line_addr,
+                              Flag update_repl) {
+  Addr  tag;
+  uns   set       = ext_cache_index(cache, addr, &tag, line_addr);
+  void* line_data = NULL;
+  uns   ii;
+
+  /* the strategy policies (NRU, RRIP, ...) still use the old lookup */
+  if(cache->repl_policy >= REPL_VOID)
+    return cache_access_strategy(cache, addr, line_addr, update_repl);
+
+  for(ii = 0; ii < cache->assoc; ii++) {
+    Cache_Entry* line = &cache->entries[set][ii];
+    if(line->valid && line->tag == tag) {
+      if(update_repl) {
+        if(line->pref)
+          line->pref = FALSE;
+        cache->num_demand_access++;
+        line->last_access_time = sim_time;
+      }
+      line_data = line->data;
+    }
+  }
+  return line_data;
+}
+
+/**************************************************************************************/
+/* Streams */
+
+static Addr* read_stream(const char* file_name, uns* length) {
+  FILE*              file = fopen(file_name, "r");
+  uns                size = 1 << 20;
+  Addr*              stream;
+  unsigned long long addr;
+
+  if(!file) {
+    fprintf(stderr, "Could not open %s\n", file_name);
+    exit(1);
+  }
+  stream  = (Addr*)malloc(sizeof(Addr) * size);
+  *length = 0;
+  while(fscanf(file, "%llx", &addr) == 1) {
+    if(*length == size) {
+      size *= 2;
+      stream = (Addr*)realloc(stream, sizeof(Addr) * size);
+    }
+    stream[(*length)++] = addr;
+  }
+  fclose(file);
+  return stream;
+}
+
+/* mostly hot code and data, some accesses over a larger footprint and a
+ * streaming component */
+static Addr* synthetic_stream(uns* length) {
+  Addr* stream = (Addr*)malloc(sizeof(Addr) * SYNTHETIC_STREAM_LENGTH);
+  Addr  next   = 0x10000000;
+  uns   ii;
+
+  srand(1);
+  for(ii = 0; ii < SYNTHETIC_STREAM_LENGTH; ii++) {
+    uns kind = rand() % 32;
+    if(kind < 20)
+      stream[ii] = 0x400000 + (rand() % (4 * 1024)) * 4;
+    else if(kind < 28)
+      stream[ii] = 0x7f0000000000 + (rand() % (4 * 1024)) * 8;
+    else if(kind < 31)
+      stream[ii] = 0x7f0000000000 + (rand() % (1024 * 1024)) * 8;
+    else
+      stream[ii] = (next += 64);
+  }
+  *length = SYNTHETIC_STREAM_LENGTH;
+  return stream;
+}
+
+/**************************************************************************************/
+/* replay: runs the stream through a new cache, inserting on misses, and then
+ * looks the stream up again in the warm cache without inserting.  Only the
+ * second pass is timed (added to *seconds), so the lookups are measured
+ * rather than the replacement.  Returns the number of hits of both passes. */
+
+static Counter replay(const Bench_Config* config, Access_Func access,
+                      const Addr* stream, uns length, double* seconds) {
+  Cache           cache;
+  Counter         hits = 0;
+  struct timespec start, end;
+  uns             ii;
+
+  init_cache(&cache, config->name, config->size, config->assoc,
+             config->line_size, 0, config->policy);
+  sim_time = 0;
+  for(ii = 0; ii < length; ii++) {
+    Addr line_addr, repl_line_addr;
+    sim_time++;
+    if(access(&cache, stream[ii], &line_addr, TRUE))
+      hits++;
+    else
+      cache_insert(&cache, 0, stream[ii], &line_addr, &repl_line_addr);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(ii = 0; ii < length; ii++) {
+    Addr line_addr;
+    sim_time++;
+    if(access(&cache, stream[ii], &line_addr, TRUE))
+      hits++;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  *seconds += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+  return hits;
+}
+
+int main(int argc, char** argv) {
+  uns   length;
+  Addr* stream = argc > 1 ? read_stream(argv[1], &length) :
+                            synthetic_stream(&length);
+  uns   ii, jj;
+  int   mismatch = 0;
+
+  printf("%u accesses, %d repeats\n", length, BENCH_REPEATS);
+  printf("%-26s %12s %12s %12s %8s\n", "cache", "hits", "old ns/look",
+         "new ns/look", "speedup");
+  for(ii = 0; ii < sizeof(configs) / sizeof(configs[0]); ii++) {
+    double  old_seconds = 0, new_seconds = 0;
+    Counter old_hits = 0, new_hits = 0;
+    for(jj = 0; jj < BENCH_REPEATS; jj++) {
+      old_hits = replay(&configs[ii], old_cache_access, stream, length,
+                        &old_seconds);
+      new_hits = replay(&configs[ii], cache_access, stream, length,
+                        &new_seconds);
+    }
+    printf("%-26s %12llu %12.2f %12.2f %7.2fx%s\n", configs[ii].name,
+           (unsigned long long)new_hits,
+           old_seconds * 1e9 / length / BENCH_REPEATS,
+           new_seconds * 1e9 / length / BENCH_REPEATS,
+           old_seconds / new_seconds,
+           old_hits == new_hits ? "" : "  HIT MISMATCH");
+    mismatch |= old_hits != new_hits;
+  }
+  free(stream);
+  return mismatch;
+}
@@ -0,0 +1,81 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <list>
+
+#include "gtest/gtest.h"
+
+#include "../cache_miss_analyzer.h"
+#include "../globals/global_defs.h"
+#include "../libs/stack_distance.h"
+
+// reference LRU stack: position of the line, or BEYOND_DEPTH
+static uns reference_access(std::list<Addr>& stack, uns depth, Addr line) {
+  uns distance = Stack_Distance_Tracker::BEYOND_DEPTH;
+  uns pos      = 0;
+  for(auto it = stack.begin(); it != stack.end(); ++it, ++pos) {
+    if(*it == line) {
+      distance = pos;
+      stack.erase(it);
+      break;
+    }
+  }
+  stack.push_front(line);
+  if(stack.size() > depth)
+    stack.pop_back();
+  return distance;
+}
+
+TEST(StackDistanceTest, MatchesReferenceStack) {
+  const uns              depth = 37;
+  Stack_Distance_Tracker tracker(depth);
+  std::list<Addr>        stack;
+
+  srand(1);
+  for(uns ii = 0; ii < 20000; ii++) {
+    // mostly within the depth, sometimes well beyond it
+    Addr line = (ii % 7 == 0) ? rand() % 200 : rand() % 48;
+    ASSERT_EQ(tracker.access(line), reference_access(stack, depth, line))
+      << "access " << ii;
+  }
+  EXPECT_EQ(tracker.size(), depth);
+}
+
+TEST(MissClassifierTest, ThreeCs) {
+  // 4 lines of 64B
+  Miss_Classifier* mc = miss_classifier_create(4, 64, 16);
+
+  // first touches
+  for(Addr line = 0; line < 4; line++)
+    EXPECT_EQ(miss_classifier_access(mc, line << 6, FALSE), MISS_COMPULSORY);
+
+  // line 0 is still in a fully-associative cache of 4 lines: a miss on it in
+  // the real cache can only be a conflict
+  EXPECT_EQ(miss_classifier_access(mc, 0x8, FALSE), MISS_CONFLICT);
+  EXPECT_EQ(miss_classifier_access(mc, 0x40, TRUE), MISS_NONE);
+
+  // touching a 5th line pushes line 2 (the LRU one) out
+  EXPECT_EQ(miss_classifier_access(mc, 4 << 6, FALSE), MISS_COMPULSORY);
+  EXPECT_EQ(miss_classifier_access(mc, 2 << 6, FALSE), MISS_CAPACITY);
+
+  miss_classifier_free(mc);
+}
@@ -0,0 +1,445 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "../cycle_skip.h"
+#include "../freq.h"
+#include "../globals/global_defs.h"
+#include "../model.h"
+#include "../statistics.h"
+#include "../trigger.h"
+}
+
+#define TEST_NUM_CORES 2
+
+/* The parameters and globals that cycle_skip.c, freq.c and trigger.c use */
+extern "C" {
+#define CORE_CYCLE_TIME(n) uns CORE_##n##_CYCLE_TIME = 0;
+CORE_CYCLE_TIME(0) CORE_CYCLE_TIME(1) CORE_CYCLE_TIME(2) CORE_CYCLE_TIME(3)
+CORE_CYCLE_TIME(4) CORE_CYCLE_TIME(5) CORE_CYCLE_TIME(6) CORE_CYCLE_TIME(7)
+CORE_CYCLE_TIME(8) CORE_CYCLE_TIME(9) CORE_CYCLE_TIME(10) CORE_CYCLE_TIME(11)
+CORE_CYCLE_TIME(12) CORE_CYCLE_TIME(13) CORE_CYCLE_TIME(14)
+CORE_CYCLE_TIME(15) CORE_CYCLE_TIME(16) CORE_CYCLE_TIME(17)
+CORE_CYCLE_TIME(18) CORE_CYCLE_TIME(19) CORE_CYCLE_TIME(20)
+CORE_CYCLE_TIME(21) CORE_CYCLE_TIME(22) CORE_CYCLE_TIME(23)
+CORE_CYCLE_TIME(24) CORE_CYCLE_TIME(25) CORE_CYCLE_TIME(26)
+CORE_CYCLE_TIME(27) CORE_CYCLE_TIME(28) CORE_CYCLE_TIME(29)
+CORE_CYCLE_TIME(30) CORE_CYCLE_TIME(31) CORE_CYCLE_TIME(32)
+CORE_CYCLE_TIME(33) CORE_CYCLE_TIME(34) CORE_CYCLE_TIME(35)
+CORE_CYCLE_TIME(36) CORE_CYCLE_TIME(37) CORE_CYCLE_TIME(38)
+CORE_CYCLE_TIME(39) CORE_CYCLE_TIME(40) CORE_CYCLE_TIME(41)
+CORE_CYCLE_TIME(42) CORE_CYCLE_TIME(43) CORE_CYCLE_TIME(44)
+CORE_CYCLE_TIME(45) CORE_CYCLE_TIME(46) CORE_CYCLE_TIME(47)
+CORE_CYCLE_TIME(48) CORE_CYCLE_TIME(49) CORE_CYCLE_TIME(50)
+CORE_CYCLE_TIME(51) CORE_CYCLE_TIME(52) CORE_CYCLE_TIME(53)
+CORE_CYCLE_TIME(54) CORE_CYCLE_TIME(55) CORE_CYCLE_TIME(56)
+CORE_CYCLE_TIME(57) CORE_CYCLE_TIME(58) CORE_CYCLE_TIME(59)
+CORE_CYCLE_TIME(60) CORE_CYCLE_TIME(61) CORE_CYCLE_TIME(62)
+CORE_CYCLE_TIME(63)
+#undef CORE_CYCLE_TIME
+
+uns  NUM_CORES                 = TEST_NUM_CORES;
+uns  CMP_THREADS               = 1;
+uns  CMP_THREAD_QUANTUM        = 1;
+uns  CHIP_CYCLE_TIME           = 312500;
+uns  L1_CYCLE_TIME             = 312500;
+uns  RAMULATOR_TCK             = 833333;
+uns  FORWARD_PROGRESS_INTERVAL = 10000;
+Flag QUIESCENCE_SKIP           = TRUE;
+Flag DUMB_CORE_ON              = FALSE;
+Flag DVFS_ON                   = FALSE;
+Flag PERF_PRED_ENABLE          = FALSE;
+Flag L1_PART_ON                = FALSE;
+Flag PIPEVIEW                  = FALSE;
+Flag MEMVIEW                   = FALSE;
+Flag DEBUG_MODEL               = FALSE;
+Flag PREF_HFILTER_ON           = FALSE;
+Flag PREF_HFILTER_RESET_ENABLE = FALSE;
+Flag FDIP_BP_CONFIDENCE        = FALSE;
+Flag FDIP_ADJUSTABLE_FTQ       = FALSE;
+Flag FDIP_BLOOM_FILTER         = FALSE;
+
+SIM_THREAD_LOCAL Counter cycle_count = 0;
+SIM_THREAD_LOCAL Counter sim_time    = 0;
+Counter*                 op_count    = NULL;
+Counter*                 inst_count  = NULL;
+FILE*                    mystdout    = stdout;
+FILE*                    mystderr    = stderr;
+FILE*                    mystatus    = NULL;
+
+Stat**       global_stat_array;
+Stat_Count** global_stat_counts;
+Stat_Count** global_stat_totals;
+Model*       model;
+
+void breakpoint(const char* file, const int line) {}
+
+const Stat* get_stat(uns8 proc_id, const char* name) {
+  return NULL;
+}
+
+Stat_Enum get_stat_idx(const char* name) {
+  return NUM_GLOBAL_STATS;
+}
+
+void require_stat(Stat_Enum stat) {}
+
+/* Implemented by the toy memory system below */
+Flag    mem_is_quiescent(void);
+Counter mem_next_event_time(void);
+void    mem_skip_cycles(Counter cycles);
+}
+
+/* A toy chip in the shape of the cmp model: each core computes for a few
+   cycles, then stalls on a DRAM request.  DRAM returns the request after a
+   latency in memory cycles, and the response goes through an on-chip queue
+   that the L1 drains.  Every core also has a periodic timer interrupt, which
+   the model reports as its next event.  While idle, DRAM still has a refresh
+   to do every REFRESH_INTERVAL memory cycles. */
+
+#define TIMER_INTERVAL 3000
+#define REFRESH_INTERVAL 1000
+
+struct Toy_Core {
+  uns     compute_left;
+  Flag    waiting;
+  Counter dram_left;  // memory cycles until the request returns
+  Flag    response;   // in the on-chip fill queue
+  Counter stall_length;
+  Counter num_requests;
+};
+
+static Toy_Core toy_cores[TEST_NUM_CORES];
+static Counter  toy_dram_cycles;
+static Counter  toy_refreshes;
+static Counter  toy_cycle_funcs;
+
+static uns toy_latency(uns proc_id, Counter num_requests) {
+  uns64 hash = (num_requests + 1) * 0x9E3779B97F4A7C15ull + proc_id;
+  return 20 + (hash >> 40) % 400;
+}
+
+static void toy_memory_tick() {
+  toy_dram_cycles++;
+  if(toy_dram_cycles % REFRESH_INTERVAL == 0)
+    toy_refreshes++;
+  for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++) {
+    Toy_Core* core = &toy_cores[proc_id];
+    if(core->dram_left && --core->dram_left == 0)
+      core->response = TRUE;
+  }
+}
+
+static void toy_core_cycle(uns proc_id) {
+  Toy_Core* core = &toy_cores[proc_id];
+  Counter   cycle = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+  STAT_EVENT(proc_id, NODE_CYCLE);
+  if(cycle % TIMER_INTERVAL == 0)
+    STAT_EVENT(proc_id, FULL_WINDOW_STALL);
+  if(core->waiting) {
+    core->stall_length++;
+    STAT_EVENT(proc_id, RET_BLOCKED_L1_MISS);
+    return;
+  }
+  STAT_EVENT(proc_id, NODE_INST_COUNT);
+  INC_STAT_VALUE(proc_id, ENERGY_CORE, 0.1);
+  if(--core->compute_left == 0) {
+    core->waiting   = TRUE;
+    core->dram_left = toy_latency(proc_id, core->num_requests++);
+  }
+}
+
+static void toy_cycle() {
+  toy_cycle_funcs++;
+  if(freq_is_ready(FREQ_DOMAIN_L1)) {
+    STAT_EVENT(0, L1_CYCLE);
+    for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++) {
+      Toy_Core* core = &toy_cores[proc_id];
+      if(core->response) {
+        core->response     = FALSE;
+        core->waiting      = FALSE;
+        core->stall_length = 0;
+        core->compute_left = 1 + core->num_requests % 7;
+      }
+    }
+  }
+  if(freq_is_ready(FREQ_DOMAIN_MEMORY)) {
+    STAT_EVENT(0, DRAM_CYCLES);
+    toy_memory_tick();
+  }
+  for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++) {
+    if(freq_is_ready(FREQ_DOMAIN_CORES[proc_id]))
+      toy_core_cycle(proc_id);
+  }
+}
+
+static Counter toy_next_event_cycle() {
+  Counter cycle = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  if(!mem_is_quiescent())
+    return cycle + 1;
+  for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++) {
+    if(!toy_cores[proc_id].waiting)
+      return cycle + 1;
+  }
+  return (cycle / TIMER_INTERVAL + 1) * TIMER_INTERVAL;
+}
+
+static Counter toy_signature() {
+  Counter sig = 0;
+  for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++) {
+    sig = sig * 31 + toy_cores[proc_id].waiting;
+    sig = sig * 31 + toy_cores[proc_id].num_requests;
+  }
+  return sig;
+}
+
+static void toy_skip_cycle(Counter cycles) {
+  for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++)
+    toy_cores[proc_id].stall_length += cycles;
+}
+
+/* The memory system interface that cycle_skip.c uses */
+extern "C" {
+Flag mem_is_quiescent() {
+  for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++) {
+    if(toy_cores[proc_id].response)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+Counter mem_next_event_time() {
+  if(!mem_is_quiescent())
+    return freq_cycle_start_time(FREQ_DOMAIN_L1,
+                                 freq_cycle_count(FREQ_DOMAIN_L1) + 1);
+  Counter idle = REFRESH_INTERVAL - 1 - toy_dram_cycles % REFRESH_INTERVAL;
+  for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++) {
+    if(toy_cores[proc_id].dram_left)
+      idle = MIN2(idle, toy_cores[proc_id].dram_left - 1);
+  }
+  return freq_cycle_start_time(FREQ_DOMAIN_MEMORY,
+                               freq_cycle_count(FREQ_DOMAIN_MEMORY) + 1 + idle);
+}
+
+void mem_skip_cycles(Counter cycles) {
+  INC_STAT_EVENT(0, DRAM_CYCLES, cycles);
+  toy_dram_cycles += cycles;
+  for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++) {
+    Toy_Core* core = &toy_cores[proc_id];
+    if(core->dram_left) {
+      EXPECT_GT(core->dram_left, cycles);
+      core->dram_left -= cycles;
+    }
+  }
+}
+}
+
+static Model toy_model;
+
+struct Run_Result {
+  std::vector<Counter> stats;
+  std::vector<Counter> trigger_cycles;
+  std::vector<Counter> progress_checks;
+  Counter              chip_cycles;
+  Counter              memory_cycles;
+  Counter              time;
+  Counter              dram_cycles;
+  Counter              refreshes;
+  Counter              stall_length[TEST_NUM_CORES];
+  Counter              cycle_funcs;
+};
+
+static void init_toy_stats() {
+  global_stat_array  = (Stat**)malloc(NUM_CORES * sizeof(Stat*));
+  global_stat_counts = (Stat_Count**)malloc(NUM_CORES * sizeof(Stat_Count*));
+  global_stat_totals = (Stat_Count**)malloc(NUM_CORES * sizeof(Stat_Count*));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    global_stat_array[proc_id]  = (Stat*)calloc(NUM_GLOBAL_STATS, sizeof(Stat));
+    global_stat_counts[proc_id] = (Stat_Count*)calloc(NUM_GLOBAL_STATS,
+                                                      sizeof(Stat_Count));
+    global_stat_totals[proc_id] = (Stat_Count*)calloc(NUM_GLOBAL_STATS,
+                                                      sizeof(Stat_Count));
+    for(uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+      Stat* stat  = &global_stat_array[proc_id][ii];
+      stat->type  = ii == ENERGY_CORE ? FLOAT_TYPE_STAT : COUNT_TYPE_STAT;
+      stat->cur   = &global_stat_counts[proc_id][ii];
+      stat->total = &global_stat_totals[proc_id][ii];
+    }
+  }
+}
+
+static void free_toy_stats() {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    free(global_stat_array[proc_id]);
+    free(global_stat_counts[proc_id]);
+    free(global_stat_totals[proc_id]);
+  }
+  free(global_stat_array);
+  free(global_stat_counts);
+  free(global_stat_totals);
+}
+
+/* Runs the toy chip through the main loop of sim.c until the time limit
+   fires, with the cycle and time triggers and the forward progress checks
+   that the loop would look at. */
+static Run_Result run_toy(Flag skip, const char* limit) {
+  QUIESCENCE_SKIP = skip;
+  init_toy_stats();
+  freq_init();
+  freq_set_time(0);
+  memset(toy_cores, 0, sizeof(toy_cores));
+  for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++)
+    toy_cores[proc_id].compute_left = 1 + proc_id;
+  toy_dram_cycles = 0;
+  toy_refreshes   = 0;
+  toy_cycle_funcs = 0;
+
+  toy_model.name            = "toy";
+  toy_model.cycle_func      = toy_cycle;
+  toy_model.next_event_func = toy_next_event_cycle;
+  toy_model.signature_func  = toy_signature;
+  toy_model.skip_cycle_func = toy_skip_cycle;
+  model                     = &toy_model;
+
+  Run_Result result;
+  Trigger*   sim_limit = trigger_create("SIM_LIMIT", limit, TRIGGER_ONCE);
+  Trigger*   cycles = trigger_create("CYCLES", "c[1]:7919", TRIGGER_REPEAT);
+  Trigger*   time   = trigger_create("TIME", "t:3000000017", TRIGGER_REPEAT);
+  cycle_skip_init();
+
+  while(!trigger_fired(sim_limit)) {
+    cycle_skip_advance_time();
+    sim_time = freq_time();
+    cycle_skip_cycle();
+    cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+    if(trigger_fired(cycles))
+      result.trigger_cycles.push_back(cycle_count);
+    if(trigger_fired(time))
+      result.trigger_cycles.push_back(freq_time());
+    if(cycle_count % FORWARD_PROGRESS_INTERVAL == 0)
+      result.progress_checks.push_back(freq_time());
+  }
+
+  cycle_skip_done();
+  trigger_free(sim_limit);
+  trigger_free(cycles);
+  trigger_free(time);
+
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    for(uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+      if(ii != QUIESCENT_CYCLES_SKIPPED)
+        result.stats.push_back(global_stat_counts[proc_id][ii].count);
+    }
+    result.stall_length[proc_id] = toy_cores[proc_id].stall_length;
+  }
+  result.chip_cycles   = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  result.memory_cycles = freq_cycle_count(FREQ_DOMAIN_MEMORY);
+  result.time          = freq_time();
+  result.dram_cycles   = toy_dram_cycles;
+  result.refreshes     = toy_refreshes;
+  result.cycle_funcs   = toy_cycle_funcs;
+  freq_done();
+  free_toy_stats();
+  return result;
+}
+
+static void expect_same_run(const char* limit) {
+  Run_Result simulated = run_toy(FALSE, limit);
+  Run_Result skipped   = run_toy(TRUE, limit);
+
+  EXPECT_EQ(simulated.stats, skipped.stats);
+  EXPECT_EQ(simulated.trigger_cycles, skipped.trigger_cycles);
+  EXPECT_EQ(simulated.progress_checks, skipped.progress_checks);
+  EXPECT_EQ(simulated.chip_cycles, skipped.chip_cycles);
+  EXPECT_EQ(simulated.memory_cycles, skipped.memory_cycles);
+  EXPECT_EQ(simulated.time, skipped.time);
+  EXPECT_EQ(simulated.dram_cycles, skipped.dram_cycles);
+  EXPECT_EQ(simulated.refreshes, skipped.refreshes);
+  for(uns proc_id = 0; proc_id < TEST_NUM_CORES; proc_id++)
+    EXPECT_EQ(simulated.stall_length[proc_id], skipped.stall_length[proc_id]);
+
+  EXPECT_FALSE(simulated.trigger_cycles.empty());
+  EXPECT_FALSE(simulated.progress_checks.empty());
+  // most of the time steps are jumped over
+  EXPECT_LT(skipped.cycle_funcs * 4, simulated.cycle_funcs);
+}
+
+TEST(CycleSkipTest, SameStatsWithAndWithoutSkipping) {
+  expect_same_run("t:100000000000");
+}
+
+TEST(CycleSkipTest, SameStatsWhenStoppedByCycleLimit) {
+  expect_same_run("c:123457");
+}
+
+/* freq_advance_time_to must leave the domains in the state that stepping
+   through every intermediate time with freq_advance_time leaves them in */
+TEST(CycleSkipTest, AdvanceTimeToMatchesStepping) {
+  init_toy_stats();
+  CHIP_CYCLE_TIME = 312500;
+  RAMULATOR_TCK   = 833333;
+  freq_init();
+  freq_set_time(0);
+
+  std::vector<Counter> times;
+  for(uns ii = 0; ii < 5000; ii++) {
+    freq_advance_time();
+    times.push_back(freq_time());
+  }
+  Counter core_cycles = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  Counter mem_cycles  = freq_cycle_count(FREQ_DOMAIN_MEMORY);
+  Flag    core_ready  = freq_is_ready(FREQ_DOMAIN_CORES[0]);
+  Flag    mem_ready   = freq_is_ready(FREQ_DOMAIN_MEMORY);
+  freq_done();
+
+  for(uns stride = 1; stride < 50; stride += 7) {
+    freq_init();
+    freq_set_time(0);
+    for(uns ii = stride - 1; ii < times.size(); ii += stride)
+      freq_advance_time_to(times[ii]);
+    while(freq_time() < times.back())
+      freq_advance_time();
+    EXPECT_EQ(freq_cycle_count(FREQ_DOMAIN_CORES[0]), core_cycles);
+    EXPECT_EQ(freq_cycle_count(FREQ_DOMAIN_MEMORY), mem_cycles);
+    EXPECT_EQ(freq_is_ready(FREQ_DOMAIN_CORES[0]), core_ready);
+    EXPECT_EQ(freq_is_ready(FREQ_DOMAIN_MEMORY), mem_ready);
+
+    /* the next start of each domain is where stepping finds it */
+    Counter next_core = freq_cycle_start_time(FREQ_DOMAIN_CORES[0],
+                                              core_cycles + 1);
+    Counter next_mem  = freq_cycle_start_time(FREQ_DOMAIN_MEMORY,
+                                              mem_cycles + 1);
+    while(!freq_is_ready(FREQ_DOMAIN_CORES[0]) ||
+          freq_cycle_count(FREQ_DOMAIN_CORES[0]) == core_cycles) {
+      freq_advance_time();
+      if(freq_is_ready(FREQ_DOMAIN_MEMORY) &&
+         freq_cycle_count(FREQ_DOMAIN_MEMORY) == mem_cycles + 1)
+        EXPECT_EQ(freq_time(), next_mem);
+    }
+    EXPECT_EQ(freq_time(), next_core);
+    freq_done();
+  }
+  free_toy_stats();
+}
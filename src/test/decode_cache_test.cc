@@ -0,0 +1,345 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "../ctype_pin_inst.h"
+#include "../decode_cache.h"
+#include "../globals/global_defs.h"
+}
+
+/* The parameters, globals and helpers decode_cache.c uses */
+extern "C" {
+char* DECODE_CACHE_FILE = NULL;
+Flag  IGNORE_BAR_FETCH  = FALSE;
+uns   NUM_CORES         = 1;
+
+FILE*                    mystdout    = stdout;
+FILE*                    mystderr    = stderr;
+FILE*                    mystatus    = stdout;
+SIM_THREAD_LOCAL Counter cycle_count = 0;
+Counter*                 op_count;
+Counter*                 inst_count;
+int                      op_type_delays[NUM_OP_TYPES];
+
+Addr convert_to_cmp_addr(uns8 proc_id, Addr addr) {
+  return addr;
+}
+
+void breakpoint(const char[], const int) {}
+}
+
+/* Stands in for the per-core Inst_Info tables of libs/cpp_hash_lib_wrapper.cc,
+   so that every "run" of a test starts with empty tables */
+typedef std::tuple<int, uint64_t, uint64_t, uint64_t, uint8_t> Inst_Info_Key;
+static std::map<Inst_Info_Key, Inst_Info> inst_infos;
+
+extern "C" {
+Inst_Info* cpp_hash_table_access_create(int core, uint64_t addr,
+                                        uint64_t lsb_bytes, uint64_t msb_bytes,
+                                        uint8_t op_idx,
+                                        unsigned char* new_entry) {
+  Inst_Info_Key key(core, addr, lsb_bytes, msb_bytes, op_idx);
+  *new_entry = inst_infos.find(key) == inst_infos.end();
+  Inst_Info* info = &inst_infos[key];
+  if(*new_entry)
+    memset(info, 0, sizeof(Inst_Info));
+  return info;
+}
+
+void cpp_hash_table_scan(int core,
+                         void (*func)(uint64_t addr, uint64_t lsb_bytes,
+                                      uint64_t msb_bytes, uint8_t op_idx,
+                                      Inst_Info* info, void* arg),
+                         void* arg) {
+  for(auto& entry : inst_infos) {
+    if(std::get<0>(entry.first) == core)
+      func(std::get<1>(entry.first), std::get<2>(entry.first),
+           std::get<3>(entry.first), std::get<4>(entry.first), &entry.second,
+           arg);
+  }
+}
+}
+
+class DecodeCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path = ::testing::TempDir() + "decode_cache_test." +
+           std::to_string(getpid());
+    unlink(path.c_str());
+    DECODE_CACHE_FILE = (char*)path.c_str();
+    IGNORE_BAR_FETCH  = FALSE;
+    NUM_CORES         = 1;
+  }
+
+  void TearDown() override {
+    end_run();
+    unlink(path.c_str());
+    DECODE_CACHE_FILE = NULL;
+  }
+
+  /* A run of the simulator starts with empty Inst_Info tables */
+  void start_run() {
+    end_run();
+    init_decode_cache();
+  }
+
+  void end_run() {
+    for(Table_Info* table_info : generated)
+      free(table_info);
+    generated.clear();
+    inst_infos.clear();
+  }
+
+  static ctype_pin_inst inst(uint64_t addr) {
+    ctype_pin_inst pi;
+    memset(&pi, 0, sizeof(pi));
+    pi.instruction_addr = addr;
+    pi.inst_binary_lsb  = addr * 0x9E3779B97F4A7C15ull;
+    pi.inst_binary_msb  = addr ^ 0x5555;
+    pi.size             = 1 + addr % 15;
+    return pi;
+  }
+
+  static uns num_uops(const ctype_pin_inst& pi) {
+    return 1 + pi.instruction_addr % 3;
+  }
+
+  /* What the uop generator decodes uop ii of pi into */
+  void generate(const ctype_pin_inst& pi, uns ii, Inst_Info* info) {
+    Table_Info* table_info = (Table_Info*)calloc(1, sizeof(Table_Info));
+    generated.push_back(table_info);
+    table_info->op_type = (Op_Type)((pi.instruction_addr + ii) % NUM_OP_TYPES);
+    table_info->mem_type      = (Mem_Type)(ii % 3);
+    table_info->num_src_regs  = ii % 3;
+    table_info->num_dest_regs = 1;
+    table_info->mem_size      = 8;
+    strcpy(table_info->name, "uop");
+
+    info->table_info  = table_info;
+    info->addr        = pi.instruction_addr;
+    info->uop_seq_num = ii;
+    for(uns jj = 0; jj < table_info->num_src_regs; jj++) {
+      info->srcs[jj].type = INT_REG;
+      info->srcs[jj].id   = pi.instruction_addr % 16 + jj;
+      info->srcs[jj].reg  = jj;
+    }
+    info->dests[0].type                = INT_REG;
+    info->dests[0].id                  = ii;
+    info->dests[0].reg                 = ii;
+    info->latency                      = 1;
+    info->trace_info.inst_size         = pi.size;
+    info->trace_info.num_uop           = ii == 0 ? num_uops(pi) : 0;
+    info->trace_info.load_seq_num      = ii;
+    info->trace_info.store_seq_num     = 2 * ii;
+    info->trace_info.is_gather_scatter = pi.is_gather_scatter;
+    info->fake_inst_reason             = WPNM_NOT_IN_WPNM;
+  }
+
+  /* Decodes pi on core proc_id as the uop generator does. Returns TRUE if the
+     uops came from the decode cache. */
+  Flag decode(uns proc_id, const ctype_pin_inst& pi) {
+    Flag       new_entry;
+    Inst_Info* info = cpp_hash_table_access_create(
+      proc_id, pi.instruction_addr, pi.inst_binary_lsb, pi.inst_binary_msb, 0,
+      &new_entry);
+    EXPECT_TRUE(new_entry);
+    if(!pi.is_gather_scatter && decode_cache_fill(proc_id, &pi, info))
+      return TRUE;
+    for(uns ii = 0; ii < num_uops(pi); ii++) {
+      Inst_Info* uop_info = ii == 0 ? info :
+                                      cpp_hash_table_access_create(
+                                        proc_id, pi.instruction_addr,
+                                        pi.inst_binary_lsb, pi.inst_binary_msb,
+                                        ii, &new_entry);
+      generate(pi, ii, uop_info);
+    }
+    return FALSE;
+  }
+
+  /* Checks that the uops of pi on core proc_id are what generate() makes */
+  void expect_decoded(uns proc_id, const ctype_pin_inst& pi) {
+    for(uns ii = 0; ii < num_uops(pi); ii++) {
+      Flag       new_entry;
+      Inst_Info* info = cpp_hash_table_access_create(
+        proc_id, pi.instruction_addr, pi.inst_binary_lsb, pi.inst_binary_msb,
+        ii, &new_entry);
+      ASSERT_FALSE(new_entry);
+      Inst_Info expected;
+      memset(&expected, 0, sizeof(expected));
+      generate(pi, ii, &expected);
+      EXPECT_EQ(0, memcmp(expected.table_info, info->table_info,
+                          sizeof(Table_Info)));
+      expected.table_info = info->table_info;
+      EXPECT_EQ(0, memcmp(&expected, info, sizeof(Inst_Info)));
+    }
+  }
+
+  std::string contents() {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+  }
+
+  ino_t inode() {
+    struct stat st;
+    return stat(path.c_str(), &st) ? 0 : st.st_ino;
+  }
+
+  std::string              path;
+  std::vector<Table_Info*> generated;  // by generate(), freed at the end of a run
+};
+
+TEST_F(DecodeCacheTest, FirstRunWritesAndReloads) {
+  start_run();
+  for(uint64_t addr = 0x1000; addr < 0x1100; addr += 4)
+    EXPECT_FALSE(decode(0, inst(addr)));
+  decode_cache_done();
+  ASSERT_NE(0u, inode());
+
+  start_run();
+  for(uint64_t addr = 0x1000; addr < 0x1100; addr += 4) {
+    EXPECT_TRUE(decode(0, inst(addr)));
+    expect_decoded(0, inst(addr));
+  }
+  /* nothing new: the file is left alone */
+  ino_t old_inode = inode();
+  decode_cache_done();
+  EXPECT_EQ(old_inode, inode());
+}
+
+TEST_F(DecodeCacheTest, GrowsWithNewInstructions) {
+  start_run();
+  for(uint64_t addr = 0x1000; addr < 0x1100; addr += 4)
+    decode(0, inst(addr));
+  decode_cache_done();
+  size_t old_size = contents().size();
+
+  start_run();
+  for(uint64_t addr = 0x1000; addr < 0x1200; addr += 4)
+    EXPECT_EQ(addr < 0x1100, decode(0, inst(addr)));
+  decode_cache_done();
+  EXPECT_GT(contents().size(), old_size);
+
+  start_run();
+  for(uint64_t addr = 0x1000; addr < 0x1200; addr += 4) {
+    EXPECT_TRUE(decode(0, inst(addr)));
+    expect_decoded(0, inst(addr));
+  }
+}
+
+TEST_F(DecodeCacheTest, RebuildsTruncatedFile) {
+  start_run();
+  for(uint64_t addr = 0x1000; addr < 0x1100; addr += 4)
+    decode(0, inst(addr));
+  decode_cache_done();
+  std::string full = contents();
+  ASSERT_EQ(0, truncate(path.c_str(), full.size() / 2));
+
+  start_run();
+  for(uint64_t addr = 0x1000; addr < 0x1100; addr += 4)
+    EXPECT_FALSE(decode(0, inst(addr)));
+  decode_cache_done();
+  EXPECT_EQ(full, contents());
+}
+
+TEST_F(DecodeCacheTest, SkipsGatherScatter) {
+  ctype_pin_inst gather    = inst(0x2000);
+  gather.is_gather_scatter = 1;
+
+  start_run();
+  decode(0, inst(0x1000));
+  decode(0, gather);
+  decode_cache_done();
+
+  start_run();
+  EXPECT_TRUE(decode(0, inst(0x1000)));
+  gather.is_gather_scatter = 0;
+  EXPECT_FALSE(decode(0, gather));
+}
+
+TEST_F(DecodeCacheTest, IgnoresFileOfOtherIgnoreBarFetch) {
+  start_run();
+  decode(0, inst(0x1000));
+  decode_cache_done();
+  std::string old_contents = contents();
+
+  IGNORE_BAR_FETCH = TRUE;
+  start_run();
+  EXPECT_FALSE(decode(0, inst(0x1000)));
+  EXPECT_FALSE(decode(0, inst(0x2000)));
+  decode_cache_done();
+  EXPECT_EQ(old_contents, contents());
+}
+
+TEST_F(DecodeCacheTest, CoresShareTableInfos) {
+  NUM_CORES = 2;
+  start_run();
+  for(uint64_t addr = 0x1000; addr < 0x1100; addr += 4) {
+    decode(0, inst(addr));
+    decode(1, inst(addr));
+  }
+  decode_cache_done();
+
+  start_run();
+  for(uint64_t addr = 0x1000; addr < 0x1100; addr += 4) {
+    EXPECT_TRUE(decode(0, inst(addr)));
+    EXPECT_TRUE(decode(1, inst(addr)));
+    expect_decoded(1, inst(addr));
+    for(uns ii = 0; ii < num_uops(inst(addr)); ii++) {
+      Flag           new_entry;
+      ctype_pin_inst pi = inst(addr);
+      EXPECT_EQ(cpp_hash_table_access_create(0, addr, pi.inst_binary_lsb,
+                                             pi.inst_binary_msb, ii, &new_entry)
+                  ->table_info,
+                cpp_hash_table_access_create(1, addr, pi.inst_binary_lsb,
+                                             pi.inst_binary_msb, ii, &new_entry)
+                  ->table_info);
+    }
+  }
+}
+
+TEST_F(DecodeCacheTest, RunsWriteTheSameFile) {
+  start_run();
+  for(uint64_t addr = 0x1000; addr < 0x1100; addr += 4)
+    decode(0, inst(addr));
+  decode_cache_done();
+  std::string first = contents();
+
+  unlink(path.c_str());
+  start_run();
+  for(uint64_t addr = 0x10fc; addr >= 0x1000; addr -= 4)
+    decode(0, inst(addr));
+  decode_cache_done();
+  EXPECT_EQ(first, contents());
+}
@@ -19,22 +19,65 @@
  * SOFTWARE.
  */
 
+#include "../globals/global_defs.h"
 #include "../globals/global_types.h"
-#include "../table_info.h"
+#include "../op.h"
+#include "../pin/pin_lib/uop_generator.h"
+#include "../statistics.h"
 #include "stdio.h"
 
-FILE* mystdout = stdout;
-FILE* mystderr = stderr;
-FILE* mystatus = stdout;
-
-Counter  cycle_count  = 0;
-Counter  unique_count = 0;
-Counter* op_count;
-Counter* inst_count;
-Counter* unique_count_per_core;
-Flag*    trace_read_done;
-
-// const char* PIN_EXEC_DRIVEN_FE_SOCKET = "./temp.socket";
-const char* FILE_TAG             = "";
-uns         INST_HASH_TABLE_SIZE = 500021;
-int         op_type_delays[NUM_OP_TYPES];
+/* Globals and stubs for linking pin_exec_driven_fe without the rest of the
+   simulator.  The uop generator stub turns each compressed op into a single
+   uop whose inst_info carries the instruction address. */
+
+FILE* mystdout;
+FILE* mystderr;
+FILE* mystatus;
+
+SIM_THREAD_LOCAL Counter cycle_count  = 0;
+SIM_THREAD_LOCAL Counter unique_count = 0;
+SIM_THREAD_LOCAL int*    off_path;
+Counter*                 op_count;
+Counter*                 inst_count;
+Counter*                 unique_count_per_core;
+Flag*                    trace_read_done;
+Flag                     roi_dump_began = FALSE;
+Counter                  roi_dump_ID    = 0;
+Stat**                   global_stat_array;
+
+#define MAX_DUMMY_CORES 64
+
+Counter          uop_generator_recoveries[MAX_DUMMY_CORES];
+static Inst_Info dummy_inst_infos[MAX_DUMMY_CORES];
+
+void breakpoint(const char* file, const int line) {}
+
+Addr convert_to_cmp_addr(uns8 proc_id, Addr addr) {
+  return addr;
+}
+
+uns get_proc_id_from_cmp_addr(Addr addr) {
+  return 0;
+}
+
+void reset_stats(Flag final_reset) {}
+
+void dump_stats(uns8 proc_id, Flag final_dump, Stat stats[], uns num_stats) {}
+
+void uop_generator_init(uint32_t num_cores) {
+  for(uns proc_id = 0; proc_id < MAX_DUMMY_CORES; ++proc_id)
+    uop_generator_recoveries[proc_id] = 0;
+}
+
+Flag uop_generator_extract_op(uns proc_id, Op* op, compressed_op* cop) {
+  dummy_inst_infos[proc_id].addr = cop->instruction_addr;
+  op->inst_info                  = &dummy_inst_infos[proc_id];
+  op->inst_uid                   = cop->inst_uid;
+  op->bom                        = TRUE;
+  op->eom                        = TRUE;
+  return TRUE;
+}
+
+void uop_generator_recover(uns8 proc_id) {
+  uop_generator_recoveries[proc_id]++;
+}
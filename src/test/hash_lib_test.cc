@@ -0,0 +1,115 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "../globals/global_defs.h"
+#include "../libs/hash_lib.h"
+}
+
+struct Test_Data {
+  int64   key;
+  Counter value;
+};
+
+static Flag test_data_eq(void const* a, void const* b) {
+  return ((Test_Data const*)a)->value == ((Test_Data const*)b)->value;
+}
+
+TEST(HashLibTest, MatchesUnorderedMap) {
+  Hash_Table                          table;
+  std::unordered_map<int64, Test_Data*> reference;
+  init_hash_table(&table, "test", 16, sizeof(Test_Data));
+  srand(3);
+  for(uns ii = 0; ii < 400000; ii++) {
+    int64 key = (int64)(rand() % 30000) << (rand() % 2 ? 6 : 0);
+    Flag  new_entry;
+    switch(rand() % 4) {
+      case 0:
+      case 1: {
+        Test_Data* data = (Test_Data*)hash_table_access_create(&table, key,
+                                                               &new_entry);
+        ASSERT_EQ(new_entry, reference.find(key) == reference.end());
+        if(new_entry) {
+          data->key      = key;
+          data->value    = 0;
+          reference[key] = data;
+        }
+        /* data never moves while the entry exists */
+        ASSERT_EQ(reference[key], data);
+        data->value++;
+        break;
+      }
+      case 2:
+        ASSERT_EQ(hash_table_access(&table, key),
+                  reference.count(key) ? reference[key] : NULL);
+        break;
+      case 3:
+        ASSERT_EQ(hash_table_access_delete(&table, key),
+                  reference.erase(key) == 1);
+        break;
+    }
+    ASSERT_EQ((size_t)table.count, reference.size());
+  }
+
+  std::vector<void*> all(table.count);
+  ASSERT_EQ(hash_table_flatten(&table, all.data()), all.data());
+  for(void* data : all)
+    ASSERT_EQ(reference[((Test_Data*)data)->key], data);
+
+  hash_table_clear(&table);
+  ASSERT_EQ(table.count, 0);
+  for(auto& entry : reference)
+    ASSERT_TRUE(hash_table_access(&table, entry.first) == NULL);
+}
+
+TEST(HashLibTest, ComplexEntriesShareAKey) {
+  Hash_Table table;
+  init_complex_hash_table(&table, "complex", 4, sizeof(Test_Data),
+                          test_data_eq);
+  for(Counter value = 0; value < 100; value++) {
+    Test_Data  query = {7, value};
+    Flag       new_entry;
+    Test_Data* data  = (Test_Data*)complex_hash_table_access_create(
+      &table, 7, &query, &new_entry);
+    ASSERT_TRUE(new_entry);
+    *data = query;
+  }
+  ASSERT_EQ(table.count, 100);
+  for(Counter value = 0; value < 100; value += 2) {
+    Test_Data query = {7, value};
+    ASSERT_TRUE(complex_hash_table_access_delete(&table, 7, &query));
+  }
+  for(Counter value = 0; value < 100; value++) {
+    Test_Data  query = {7, value};
+    Test_Data* data  = (Test_Data*)complex_hash_table_access(&table, 7, &query);
+    if(value % 2)
+      ASSERT_TRUE(data && data->value == value);
+    else
+      ASSERT_TRUE(data == NULL);
+  }
+}
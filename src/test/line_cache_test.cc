@@ -0,0 +1,159 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "../globals/global_defs.h"
+#include "../libs/cache_engine_c.h"
+#include "../libs/cache_lib.h"
+}
+
+#define TEST_STREAM_LENGTH 50000
+
+/* The parameters and globals cache_lib.c and the shim use */
+extern "C" {
+SIM_THREAD_LOCAL Counter sim_time              = 0;
+extern const uns         NUM_CORES             = 1;
+extern const uns         NODE_TABLE_SIZE       = 256;
+extern const Flag        USE_UNSURE_FREE_LISTS = FALSE;
+extern const Flag        L1_PART_ON            = FALSE;
+
+void checkpoint_section(const char* name) {}
+void checkpoint_cache(Cache* cache) {}
+void checkpoint_transfer(void* data, size_t size) {}
+void checkpoint_match(const void* data, size_t size, const char* what) {}
+}
+
+struct Test_Geometry {
+  uns         cache_size;
+  uns         assoc;
+  uns         line_size;
+  Repl_Policy policy;
+};
+
+/* Replays the same random accesses, insertions on misses, invalidations and
+   victim queries through a cache_lib cache and a Line_Cache, and checks
+   that both hit, evict and return the same lines.  Each payload holds the
+   address it was inserted for, so stale payloads are compared too. */
+static void expect_same_as_cache_lib(const Test_Geometry& geometry,
+                                     uns                  seed) {
+  Cache lib;
+  init_cache(&lib, "LIB", geometry.cache_size, geometry.assoc,
+             geometry.line_size, sizeof(Addr), geometry.policy);
+  Line_Cache* cache = line_cache_create("ENGINE", geometry.cache_size,
+                                        geometry.assoc, geometry.line_size,
+                                        sizeof(Addr), geometry.policy);
+  uns   num_lines = geometry.cache_size / geometry.line_size;
+  uns64 state     = seed * 2654435761ull + 1;
+
+  EXPECT_EQ(line_cache_num_lines(cache), num_lines);
+  EXPECT_EQ(line_cache_repl_policy(cache), geometry.policy);
+  EXPECT_EQ(line_cache_shift_bits(cache), lib.shift_bits);
+
+  for(uns ii = 0; ii < TEST_STREAM_LENGTH; ii++) {
+    state      = state * 6364136223846793005ull + 1442695040888963407ull;
+    uns64 rand = state >> 33;
+    // a footprint of 3x the cache, with a hot quarter of it
+    uns64 line = rand % 4 ? rand % (num_lines / 4 + 1) : rand % (3 * num_lines);
+    Addr  addr = line * geometry.line_size + rand % geometry.line_size;
+    sim_time++;
+
+    Addr lib_line_addr, line_addr;
+    ASSERT_EQ(line_cache_set(cache, addr),
+              addr >> lib.shift_bits & lib.set_mask);
+
+    if(rand % 16 == 0) {
+      cache_invalidate(&lib, addr, &lib_line_addr);
+      line_cache_invalidate(cache, addr, &line_addr);
+      ASSERT_EQ(line_addr, lib_line_addr);
+      continue;
+    }
+
+    Flag  update_repl = rand % 8 != 0;
+    Addr* lib_data    = (Addr*)cache_access(&lib, addr, &lib_line_addr,
+                                         update_repl);
+    Addr* data = (Addr*)line_cache_access(cache, addr, &line_addr,
+                                          update_repl);
+    ASSERT_EQ(line_addr, lib_line_addr);
+    ASSERT_EQ(data == NULL, lib_data == NULL) << "access " << ii;
+    if(data) {
+      ASSERT_EQ(*data, *lib_data);
+      continue;
+    }
+
+    Addr lib_repl_line_addr, repl_line_addr;
+    Flag lib_valid, valid;
+    lib_data = (Addr*)get_next_repl_line(&lib, 0, addr, &lib_repl_line_addr,
+                                         &lib_valid);
+    data     = (Addr*)line_cache_next_repl_line(cache, 0, addr,
+                                            &repl_line_addr, &valid);
+    ASSERT_EQ(valid, lib_valid) << "victim " << ii;
+    if(valid) {
+      ASSERT_EQ(repl_line_addr, lib_repl_line_addr);
+      ASSERT_EQ(*data, *lib_data);
+    }
+
+    lib_data = (Addr*)cache_insert(&lib, 0, addr, &lib_line_addr,
+                                   &lib_repl_line_addr);
+    data     = (Addr*)line_cache_insert(cache, 0, addr, &line_addr,
+                                    &repl_line_addr);
+    ASSERT_EQ(line_addr, lib_line_addr);
+    ASSERT_EQ(repl_line_addr, lib_repl_line_addr) << "insert " << ii;
+    ASSERT_EQ(*data, *lib_data);
+    *lib_data = addr;
+    *data     = addr;
+  }
+}
+
+TEST(LineCacheTest, TrueLruMatchesCacheLib) {
+  // dcache, BTB (1B lines) and fully associative shapes
+  expect_same_as_cache_lib({32 * 1024, 8, 64, REPL_TRUE_LRU}, 1);
+  expect_same_as_cache_lib({48 * 1024, 12, 64, REPL_TRUE_LRU}, 2);
+  expect_same_as_cache_lib({4096, 4, 1, REPL_TRUE_LRU}, 3);
+  expect_same_as_cache_lib({64 * 64, 64, 64, REPL_TRUE_LRU}, 4);
+}
+
+TEST(LineCacheTest, OtherCachesMatchCacheLib) {
+  // policies the engine does not have, and a number of sets that is not a
+  // power of 2, go through cache_lib
+  expect_same_as_cache_lib({16 * 1024, 4, 64, REPL_ROUND_ROBIN}, 5);
+  expect_same_as_cache_lib({16 * 1024, 4, 64, REPL_NOT_MRU}, 6);
+  expect_same_as_cache_lib({12 * 4 * 64, 4, 64, REPL_TRUE_LRU}, 7);
+}
+
+TEST(LineCacheTest, NoPayload) {
+  Line_Cache* cache = line_cache_create("NO DATA", 4096, 4, 64, 0,
+                                        REPL_TRUE_LRU);
+  Addr        line_addr, repl_line_addr;
+
+  EXPECT_EQ(line_cache_access(cache, 0x1234, &line_addr, TRUE), nullptr);
+  EXPECT_EQ(line_cache_insert(cache, 0, 0x1234, &line_addr, &repl_line_addr),
+            INIT_CACHE_DATA_VALUE);
+  EXPECT_EQ(line_addr, 0x1200u);
+  EXPECT_EQ(repl_line_addr, 0u);
+  EXPECT_EQ(line_cache_access(cache, 0x1234, &line_addr, TRUE),
+            INIT_CACHE_DATA_VALUE);
+  line_cache_invalidate(cache, 0x1234, &line_addr);
+  EXPECT_EQ(line_cache_access(cache, 0x1234, &line_addr, TRUE), nullptr);
+}
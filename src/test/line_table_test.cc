@@ -0,0 +1,96 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "../globals/global_defs.h"
+#include "../libs/line_table.h"
+
+TEST(LineTableTest, MatchesUnorderedMap) {
+  Line_Table<Counter>               table;
+  std::unordered_map<Addr, Counter> reference;
+  std::vector<Addr>                 order;
+  srand(7);
+  for(uns ii = 0; ii < 200000; ii++) {
+    Addr line = (Addr)(rand() % 20000) << 6;
+    Flag inserted;
+    Counter* cnt = table.insert(line, 0, &inserted);
+    ASSERT_TRUE(cnt != NULL);
+    EXPECT_EQ(inserted, reference.find(line) == reference.end());
+    if(inserted)
+      order.push_back(line);
+    (*cnt)++;
+    reference[line]++;
+  }
+  EXPECT_EQ(table.size(), reference.size());
+  for(auto it = reference.begin(); it != reference.end(); ++it) {
+    Counter* cnt = table.find(it->first);
+    ASSERT_TRUE(cnt != NULL);
+    EXPECT_EQ(*cnt, it->second);
+  }
+  EXPECT_TRUE(table.find(1) == NULL);
+
+  uns pos = 0;
+  table.for_each([&](Addr line, Counter&) { EXPECT_EQ(line, order[pos++]); });
+  EXPECT_EQ(pos, order.size());
+}
+
+TEST(LineTableTest, BoundAndSampling) {
+  Line_Table<Counter> bounded(100, 0);
+  for(Addr line = 0; line < 150; line++)
+    bounded.insert(line << 6, line);
+  EXPECT_EQ(bounded.size(), 100u);
+  EXPECT_EQ(bounded.get_dropped(), 50u);
+  EXPECT_EQ(*bounded.find(99 << 6), 99u);
+  EXPECT_TRUE(bounded.find(100 << 6) == NULL);
+
+  Line_Table<Counter> sampled(0, 4);
+  uns                 kept = 0;
+  for(Addr line = 0; line < 16000; line++) {
+    Counter* cnt = sampled.insert(line << 6, 0);
+    EXPECT_EQ(cnt != NULL, sampled.sampled(line << 6));
+    kept += cnt != NULL;
+  }
+  EXPECT_EQ(sampled.size(), kept);
+  EXPECT_GT(kept, 800u);
+  EXPECT_LT(kept, 1200u);
+  EXPECT_EQ(sampled.get_dropped(), 0u);
+}
+
+TEST(LineHistoryTest, KeepsPerLineOrder) {
+  Line_History<uns8> hist;
+  for(uns ii = 0; ii < 10000; ii++)
+    hist.append((Addr)(ii % 7) << 6, (uns8)(ii / 7));
+  EXPECT_EQ(hist.size(), 7u);
+  EXPECT_EQ(hist.length(0), 1429u);
+  EXPECT_EQ(hist.length(6 << 6), 1428u);
+  EXPECT_EQ(hist.length(7 << 6), 0u);
+
+  uns8 expected = 0;
+  hist.for_each_event(3 << 6, [&](uns8 value) { EXPECT_EQ(value, expected++); });
+  uns lines = 0;
+  hist.for_each_line([&](Addr line) { EXPECT_EQ(line, (Addr)lines++ << 6); });
+  EXPECT_EQ(lines, 7u);
+}
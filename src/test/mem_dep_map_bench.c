@@ -0,0 +1,511 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : test/mem_dep_map_bench.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Microbenchmark of the store-to-load dependence map of
+ *                map.c.  Replays a stream of loads and stores through
+ *                mem_dep_map and through the map map.c used before it (a
+ *                table of 8-byte entries walked byte by byte, in the chained
+ *                hash table hash_lib had then, copied here),
+ *                with a window of in-flight stores and wrong-path bursts
+ *                that are flushed again, checks that both find the same
+ *                store dependencies and reports their speed.
+ *
+ *                Usage: mem_dep_map_bench [stream_file]
+ *                The stream file holds one access per line, "L <hex va>
+ *                <size>" or "S <hex va> <size>"; without it a synthetic
+ *                stream of scalar, AVX-512, gather/scatter and rep-string
+ *                accesses (like the programs in this directory) is used.
+ ***************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../globals/global_defs.h"
+#include "../globals/global_types.h"
+#include "../globals/utils.h"
+#include "../libs/malloc_lib.h"
+#include "../libs/mem_dep_map.h"
+
+#define SYNTHETIC_STREAM_LENGTH 2000000
+#define BENCH_REPEATS 4
+#define STORE_WINDOW 64  /* in-flight stores */
+#define WRONG_PATH_PERIOD 200 /* a wrong-path burst every so many accesses */
+#define WRONG_PATH_LENGTH 40
+
+typedef struct Bench_Access_struct {
+  Addr va;
+  uns  size;
+  Flag store;
+} Bench_Access;
+
+/* the part of an Op the maps look at */
+typedef struct Bench_Op_struct {
+  Counter op_num;
+  Addr    va;
+  uns     size;
+  Flag    off_path;
+  Flag    marked;
+} Bench_Op;
+
+typedef struct Bench_Result_struct {
+  Counter forwarded; /* loads with a store dependency */
+  Counter srcs;      /* distinct stores loads depend on */
+  Counter youngest;  /* sum of the op_num of the youngest of them */
+} Bench_Result;
+
+/* the interface map.c needs from the map */
+typedef struct Bench_Map_struct {
+  void (*init)(void);
+  void (*write)(Bench_Op*);
+  void (*release)(Bench_Op*);
+  Bench_Op* (*read)(Bench_Op*, Bench_Op**, uns*);
+  void (*recover)(void);
+  void (*done)(void);
+} Bench_Map;
+
+/**************************************************************************************/
+/* Old hash table: the chained table of hash_lib before it became an open
+ * addressing table, cut down to what the old map uses */
+
+typedef struct Old_Hash_Entry_struct {
+  int64                         key;
+  void*                         data;
+  struct Old_Hash_Entry_struct* next;
+} Old_Hash_Entry;
+
+typedef struct Old_Hash_Table_struct {
+  uns              buckets;
+  uns              data_size;
+  int              count;
+  Old_Hash_Entry** entries;
+} Old_Hash_Table;
+
+static int64 old_hash_index(const Old_Hash_Table* table, int64 key) {
+  int64_t mask = (~0UL) % table->buckets;
+  int64_t hash = 0;
+  int     log2 = 64 - __builtin_clzl(table->buckets);
+  for(int i = 0; i < 64; i += log2) {
+    hash ^= (key & mask);
+    key = key >> log2;
+  }
+  return hash;
+}
+
+static void old_hash_init(Old_Hash_Table* table, uns buckets, uns data_size) {
+  table->buckets   = buckets;
+  table->data_size = data_size;
+  table->count     = 0;
+  table->entries   = (Old_Hash_Entry**)calloc(buckets, sizeof(Old_Hash_Entry*));
+}
+
+static void* old_hash_access(Old_Hash_Table const* table, int64 key) {
+  Old_Hash_Entry* temp;
+  for(temp = table->entries[old_hash_index(table, key)]; temp;
+      temp = temp->next)
+    if(temp->key == key)
+      return temp->data;
+  return NULL;
+}
+
+static void* old_hash_access_create(Old_Hash_Table* table, int64 key,
+                                    Flag* new_entry) {
+  uns             index = old_hash_index(table, key);
+  Old_Hash_Entry* prev  = NULL;
+  Old_Hash_Entry* temp;
+
+  *new_entry = FALSE;
+  for(temp = table->entries[index]; temp; temp = temp->next) {
+    if(temp->key == key)
+      return temp->data;
+    prev = temp;
+  }
+  table->count++;
+  *new_entry = TRUE;
+  temp       = (Old_Hash_Entry*)smalloc(sizeof(Old_Hash_Entry));
+  temp->key  = key;
+  temp->next = NULL;
+  temp->data = smalloc(table->data_size);
+  if(prev)
+    prev->next = temp;
+  else
+    table->entries[index] = temp;
+  return temp->data;
+}
+
+static void old_hash_access_delete(Old_Hash_Table* table, int64 key) {
+  uns             index = old_hash_index(table, key);
+  Old_Hash_Entry* prev  = NULL;
+  Old_Hash_Entry* temp;
+
+  for(temp = table->entries[index]; temp; temp = temp->next) {
+    if(temp->key == key) {
+      if(prev)
+        prev->next = temp->next;
+      else
+        table->entries[index] = temp->next;
+      sfree(table->data_size, temp->data);
+      sfree(sizeof(Old_Hash_Entry), temp);
+      table->count--;
+      return;
+    }
+    prev = temp;
+  }
+}
+
+static void old_hash_scan(Old_Hash_Table* table, void (*scan_func)(void*)) {
+  if(table->count == 0)
+    return;
+  for(uns ii = 0; ii < table->buckets; ii++)
+    for(Old_Hash_Entry* temp = table->entries[ii]; temp; temp = temp->next)
+      scan_func(temp->data);
+}
+
+static void old_hash_free(Old_Hash_Table* table) {
+  for(uns ii = 0; ii < table->buckets; ii++) {
+    Old_Hash_Entry* temp = table->entries[ii];
+    while(temp) {
+      Old_Hash_Entry* next = temp->next;
+      sfree(table->data_size, temp->data);
+      sfree(sizeof(Old_Hash_Entry), temp);
+      temp = next;
+    }
+  }
+  free(table->entries);
+}
+
+/**************************************************************************************/
+/* Old map: entries of 8 bytes walked byte by byte */
+
+#define OLD_ENTRY_SIZE 8
+#define OLD_BYTE_INDEX(byte, off_path) ((byte) + ((off_path) ? OLD_ENTRY_SIZE : 0))
+
+typedef struct Old_Entry_struct {
+  Bench_Op* op[2 * OLD_ENTRY_SIZE];
+  uns       flag_mask;
+  uns       store_mask;
+} Old_Entry;
+
+static Old_Hash_Table old_hash;
+
+static void old_init(void) {
+  old_hash_init(&old_hash, 256, sizeof(Old_Entry));
+}
+
+static void old_done(void) {
+  old_hash_free(&old_hash);
+}
+
+static void old_write(Bench_Op* op) {
+  for(Addr va = op->va; va != op->va + op->size; va++) {
+    Flag       new_entry;
+    Old_Entry* entry = (Old_Entry*)old_hash_access_create(
+      &old_hash, va / OLD_ENTRY_SIZE, &new_entry);
+    uns byte = va % OLD_ENTRY_SIZE;
+    if(new_entry) {
+      entry->flag_mask  = 0;
+      entry->store_mask = 0;
+    }
+    DEFBIT(entry->flag_mask, byte, op->off_path);
+    SETBIT(entry->store_mask, OLD_BYTE_INDEX(byte, op->off_path));
+    entry->op[OLD_BYTE_INDEX(byte, op->off_path)] = op;
+  }
+}
+
+static void old_release(Bench_Op* op) {
+  for(Addr va = op->va; va != op->va + op->size; va++) {
+    Old_Entry* entry = (Old_Entry*)old_hash_access(&old_hash,
+                                                   va / OLD_ENTRY_SIZE);
+    uns ind = OLD_BYTE_INDEX(va % OLD_ENTRY_SIZE, op->off_path);
+    if(!entry)
+      continue;
+    if(TESTBIT(entry->store_mask, ind) && entry->op[ind] == op)
+      CLRBIT(entry->store_mask, ind);
+    if(!entry->store_mask)
+      old_hash_access_delete(&old_hash, va / OLD_ENTRY_SIZE);
+  }
+}
+
+static Bench_Op* old_read(Bench_Op* op, Bench_Op** srcs, uns* num_srcs) {
+  Bench_Op* last = NULL;
+  for(Addr va = op->va; va != op->va + op->size; va++) {
+    Old_Entry* entry = (Old_Entry*)old_hash_access(&old_hash,
+                                                   va / OLD_ENTRY_SIZE);
+    uns byte = va % OLD_ENTRY_SIZE;
+    if(!entry)
+      continue;
+    uns ind = OLD_BYTE_INDEX(byte, TESTBIT(entry->flag_mask, byte));
+    if(!TESTBIT(entry->store_mask, ind))
+      continue;
+    Bench_Op* src = entry->op[ind];
+    if(!src->marked) {
+      src->marked          = TRUE;
+      srcs[(*num_srcs)++] = src;
+    }
+    if(!last || last->op_num < src->op_num)
+      last = src;
+  }
+  return last;
+}
+
+static void old_recover_entry(void* entry) {
+  ((Old_Entry*)entry)->flag_mask = 0;
+}
+
+static void old_recover(void) {
+  old_hash_scan(&old_hash, old_recover_entry);
+}
+
+static const Bench_Map old_map = {old_init,    old_write,   old_release,
+                                  old_read,    old_recover, old_done};
+
+/**************************************************************************************/
+/* New map: mem_dep_map, used the way map.c does */
+
+static Mem_Dep_Map new_dep_map;
+
+static void new_init(void) {
+  init_mem_dep_map(&new_dep_map, "new mem map", 256);
+}
+
+static void new_done(void) {
+  free_mem_dep_map(&new_dep_map);
+}
+
+static void new_write(Bench_Op* op) {
+  Mem_Dep_Traversal traversal;
+  for(mem_dep_traversal_init(&traversal, op->va, op->size);
+      !mem_dep_traversal_done(&traversal); mem_dep_traversal_next(&traversal))
+    mem_dep_map_write(&new_dep_map, traversal.word_addr, traversal.byte_mask,
+                      op->off_path, (struct Op_struct*)op);
+}
+
+static void new_release(Bench_Op* op) {
+  Mem_Dep_Traversal traversal;
+  for(mem_dep_traversal_init(&traversal, op->va, op->size);
+      !mem_dep_traversal_done(&traversal); mem_dep_traversal_next(&traversal))
+    mem_dep_map_release(&new_dep_map, traversal.word_addr, traversal.byte_mask,
+                        op->off_path, (struct Op_struct*)op);
+}
+
+static Bench_Op* new_read(Bench_Op* op, Bench_Op** srcs, uns* num_srcs) {
+  Bench_Op*         last = NULL;
+  Mem_Dep_Traversal traversal;
+  for(mem_dep_traversal_init(&traversal, op->va, op->size);
+      !mem_dep_traversal_done(&traversal); mem_dep_traversal_next(&traversal)) {
+    Mem_Dep_Word* word;
+    uns slots = mem_dep_map_read(&new_dep_map, traversal.word_addr,
+                                 traversal.byte_mask, &word);
+    while(slots) {
+      Bench_Op* src = (Bench_Op*)word->op[__builtin_ctz(slots)];
+      do {
+        slots &= slots - 1;
+      } while(slots && (Bench_Op*)word->op[__builtin_ctz(slots)] == src);
+      if(!src->marked) {
+        src->marked          = TRUE;
+        srcs[(*num_srcs)++] = src;
+      }
+      if(!last || last->op_num < src->op_num)
+        last = src;
+    }
+  }
+  return last;
+}
+
+static void new_recover(void) {
+  mem_dep_map_recover(&new_dep_map);
+}
+
+static const Bench_Map new_map = {new_init,    new_write,   new_release,
+                                  new_read,    new_recover, new_done};
+
+/**************************************************************************************/
+/* Streams */
+
+static Bench_Access* read_stream(const char* file_name, uns* length) {
+  FILE*              file = fopen(file_name, "r");
+  uns                size = 1 << 20;
+  Bench_Access*      stream;
+  char               type;
+  unsigned long long va;
+  uns                bytes;
+
+  if(!file) {
+    fprintf(stderr, "Could not open %s\n", file_name);
+    exit(1);
+  }
+  stream  = (Bench_Access*)malloc(sizeof(Bench_Access) * size);
+  *length = 0;
+  while(fscanf(file, " %c %llx %u", &type, &va, &bytes) == 3) {
+    if(*length == size) {
+      size *= 2;
+      stream = (Bench_Access*)realloc(stream, sizeof(Bench_Access) * size);
+    }
+    stream[*length].va    = va;
+    stream[*length].size  = bytes;
+    stream[*length].store = type == 'S' || type == 's';
+    (*length)++;
+  }
+  fclose(file);
+  return stream;
+}
+
+/* scalar stack traffic, AVX-512 loads and stores, gathers and scatters (one
+ * access per element, as the trace frontend splits them) and rep movs */
+static Bench_Access* synthetic_stream(uns* length) {
+  Bench_Access* stream = (Bench_Access*)malloc(sizeof(Bench_Access) *
+                                               (SYNTHETIC_STREAM_LENGTH + 16));
+  Addr          array  = 0x7f0000100000;
+  uns           ii     = 0;
+
+  srand(1);
+  while(ii < SYNTHETIC_STREAM_LENGTH) {
+    uns  kind  = rand() % 32;
+    Flag store = rand() % 3 == 0;
+    if(kind < 18) {
+      stream[ii].va    = 0x7ffff000 + (rand() % 64) * 8;
+      stream[ii].size  = 8;
+      stream[ii].store = store;
+      ii++;
+    } else if(kind < 26) {
+      stream[ii].va    = array + (rand() % 256) * 64;
+      stream[ii].size  = 64;
+      stream[ii].store = store;
+      ii++;
+    } else if(kind < 31) {
+      uns elem_size = rand() % 2 ? 4 : 8;
+      for(uns jj = 0; jj < 16; jj++, ii++) {
+        stream[ii].va    = array + (rand() % 4096) * elem_size;
+        stream[ii].size  = elem_size;
+        stream[ii].store = store;
+      }
+    } else {
+      Addr src = array + (rand() % 256) * 64 + rand() % 8;
+      uns  len = 64 + rand() % 448;
+      stream[ii].va    = src;
+      stream[ii].size  = len;
+      stream[ii].store = FALSE;
+      stream[ii + 1].va    = src + 0x40000;
+      stream[ii + 1].size  = len;
+      stream[ii + 1].store = TRUE;
+      ii += 2;
+    }
+  }
+  *length = ii;
+  return stream;
+}
+
+/**************************************************************************************/
+/* replay: runs the stream through the map.  Stores stay in the map until
+ * STORE_WINDOW younger stores have been written.  Every WRONG_PATH_PERIOD
+ * accesses, the next WRONG_PATH_LENGTH accesses run off-path and are then
+ * flushed (their stores released and the map recovered).  Adds the time spent
+ * to *seconds. */
+
+static Bench_Result replay(const Bench_Map* map, const Bench_Access* stream,
+                           uns length, double* seconds) {
+  Bench_Result    result = {0, 0, 0};
+  Bench_Op*       ops    = (Bench_Op*)calloc(length, sizeof(Bench_Op));
+  Bench_Op**      window = (Bench_Op**)calloc(STORE_WINDOW, sizeof(Bench_Op*));
+  Bench_Op*       wrong_path[WRONG_PATH_LENGTH];
+  Bench_Op*       srcs[STORE_WINDOW + WRONG_PATH_LENGTH];
+  uns             num_wrong_path = 0;
+  uns             next_store     = 0;
+  struct timespec start, end;
+
+  map->init();
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(uns ii = 0; ii < length; ii++) {
+    Bench_Op* op = &ops[ii];
+    op->op_num   = ii;
+    op->va       = stream[ii].va;
+    op->size     = stream[ii].size;
+    op->off_path = ii % WRONG_PATH_PERIOD >= WRONG_PATH_PERIOD -
+                                               WRONG_PATH_LENGTH;
+
+    if(stream[ii].store) {
+      map->write(op);
+      if(op->off_path) {
+        wrong_path[num_wrong_path++] = op;
+      } else {
+        if(window[next_store])
+          map->release(window[next_store]);
+        window[next_store] = op;
+        next_store         = (next_store + 1) % STORE_WINDOW;
+      }
+    } else {
+      uns       num_srcs = 0;
+      Bench_Op* last     = map->read(op, srcs, &num_srcs);
+      if(last) {
+        result.forwarded++;
+        result.srcs += num_srcs;
+        result.youngest += last->op_num;
+      }
+      /* unmark the sources, as add_store_deps does */
+      for(uns jj = 0; jj < num_srcs; jj++)
+        srcs[jj]->marked = FALSE;
+    }
+
+    if(ii % WRONG_PATH_PERIOD == WRONG_PATH_PERIOD - 1) {
+      while(num_wrong_path)
+        map->release(wrong_path[--num_wrong_path]);
+      map->recover();
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  *seconds += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+  map->done();
+  free(window);
+  free(ops);
+  return result;
+}
+
+int main(int argc, char** argv) {
+  uns           length;
+  Bench_Access* stream = argc > 1 ? read_stream(argv[1], &length) :
+                                    synthetic_stream(&length);
+  double        old_seconds = 0, new_seconds = 0;
+  Bench_Result  old_result, new_result;
+  int           mismatch;
+
+  for(uns ii = 0; ii < BENCH_REPEATS; ii++) {
+    old_result = replay(&old_map, stream, length, &old_seconds);
+    new_result = replay(&new_map, stream, length, &new_seconds);
+  }
+  mismatch = memcmp(&old_result, &new_result, sizeof(Bench_Result)) != 0;
+
+  printf("%u accesses, %d repeats\n", length, BENCH_REPEATS);
+  printf("%12s %12s %12s %12s %8s\n", "forwarded", "sources", "old ns/acc",
+         "new ns/acc", "speedup");
+  printf("%12llu %12llu %12.2f %12.2f %7.2fx%s\n",
+         (unsigned long long)new_result.forwarded,
+         (unsigned long long)new_result.srcs,
+         old_seconds * 1e9 / length / BENCH_REPEATS,
+         new_seconds * 1e9 / length / BENCH_REPEATS, old_seconds / new_seconds,
+         mismatch ? "  DEPENDENCE MISMATCH" : "");
+  free(stream);
+  return mismatch;
+}
@@ -0,0 +1,262 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Runs request traces through Ramulator and checks that skipping idle DRAM
+   cycles (Memory::tick() counting them lazily, or idle_ticks()/skip_ticks()
+   jumping over them) completes every request in the same cycle and gives the
+   same stats as ticking every cycle, and that ticking the channels on a
+   ChannelPool gives the same callbacks, in the same order, and the same stats
+   as ticking them one after the other. */
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "../ramulator/Config.h"
+#include "../ramulator/DDR4.h"
+#include "../ramulator/Memory.h"
+#include "../ramulator/MemoryFactory.h"
+#include "../ramulator/Request.h"
+#include "../ramulator/StatType.h"
+
+using namespace ramulator;
+
+#define CACHE_LINE_SIZE 64
+
+struct Trace_Req {
+  long          arrival;  // DRAM cycle the request is sent in
+  long          addr;
+  Request::Type type;
+};
+
+enum Skip_Mode {
+  TICK_EVERY_CYCLE,  // skip_idle_cycles off
+  TICK_LAZILY,       // skip_idle_cycles on, tick() every cycle
+  SKIP_IDLE_TICKS,   // skip_idle_cycles on, skip_ticks() over idle cycles
+};
+
+#define COMPLETION -1
+
+struct Run_Result {
+  std::vector<std::pair<long, long>> completions;  // (addr, cycle), in order
+  std::vector<long>                  dram_events;  // per StatCallbackType
+  /* every callback in order: (COMPLETION, addr, cycle) for a request and
+     (StatCallbackType, coreid, cycle) for a DRAM event */
+  std::vector<std::tuple<int, long, long>> callbacks;
+  std::string                              stats;
+  long                                     ticks = 0;
+};
+
+static Run_Result* cur_result;
+static long*       cur_cycle;
+
+static void count_dram_event(int coreid, int type) {
+  cur_result->dram_events[type]++;
+  cur_result->callbacks.push_back(std::make_tuple(type, coreid, *cur_cycle));
+}
+
+/* Bursts of reads and writes separated by gaps long enough for the
+   controllers to drain and refresh; most requests of a burst hit a few rows */
+static std::vector<Trace_Req> make_trace(unsigned seed, int num_bursts) {
+  std::mt19937           rng(seed);
+  std::vector<Trace_Req> trace;
+  long                   cycle = 0;
+
+  for(int burst = 0; burst < num_bursts; ++burst) {
+    cycle += 100 + rng() % 20000;
+    long hot_row = (rng() % (1L << 26)) * CACHE_LINE_SIZE;
+    int  length  = 1 + rng() % 24;
+    for(int ii = 0; ii < length; ++ii) {
+      Trace_Req req;
+      cycle += rng() % 4;
+      req.arrival = cycle;
+      if(rng() % 4)
+        req.addr = hot_row + (rng() % 64) * CACHE_LINE_SIZE;
+      else
+        req.addr = (rng() % (1L << 27)) * CACHE_LINE_SIZE;
+      req.type = rng() % 4 ? Request::Type::READ : Request::Type::WRITE;
+      trace.push_back(req);
+    }
+  }
+  return trace;
+}
+
+/* The text Ramulator would write to ramulator.stat.out for the stats
+   registered since first_stat */
+static std::string print_stats(size_t first_stat) {
+  const char*   filename = "ramulator_test.stat.out";
+  std::ofstream file(filename);
+  for(size_t ii = first_stat; ii < Stats::all_stats.size(); ++ii) {
+    Stats::StatBase* stat = Stats::all_stats[ii];
+    if(stat->is_nozero() && stat->zero())
+      continue;
+    if(stat->is_display()) {
+      stat->prepare();
+      stat->print(file);
+    }
+  }
+  file.close();
+
+  std::ifstream     in(filename);
+  std::stringstream text;
+  text << in.rdbuf();
+  std::remove(filename);
+  return text.str();
+}
+
+/* Sends each request in its arrival cycle (or as soon as the controller takes
+   it) and ticks until every read completed and end_cycle is reached */
+static Run_Result run_trace(const std::vector<Trace_Req>& trace,
+                            Skip_Mode mode, long end_cycle, int channels = 2,
+                            int channel_threads = 1) {
+  Run_Result result;
+  result.dram_events.resize(int(StatCallbackType::MAX), 0);
+  cur_result = &result;
+
+  /* Scarab's default DRAM (ramulator.param.def) */
+  Config configs;
+  configs.set_core_num(1);
+  configs.add("standard", "DDR4");
+  configs.add("speed", "DDR4_2400R");
+  configs.add("org", "DDR4_8Gb_x8");
+  configs.add("channels", std::to_string(channels));
+  configs.add("ranks", "1");
+  configs.add("scheduling_policy", "FRFCFS_Cap");
+  configs.add("readq_entries", "32");
+  configs.add("writeq_entries", "32");
+  configs.add("skip_idle_cycles", mode == TICK_EVERY_CYCLE ? "off" : "on");
+  configs.add("channel_threads", std::to_string(channel_threads));
+
+  size_t      first_stat = Stats::all_stats.size();
+  MemoryBase* mem        = MemoryFactory<DDR4>::create(configs, CACHE_LINE_SIZE,
+                                                      &count_dram_event);
+  EXPECT_EQ(static_cast<Memory<DDR4>*>(mem)->channel_pool != nullptr,
+            channel_threads > 1);
+
+  long   cycle       = 0;
+  long   outstanding = 0;
+  size_t next        = 0;
+  auto   complete    = [&](Request& req) {
+    result.completions.push_back(std::make_pair(req.addr, cycle));
+    result.callbacks.push_back(std::make_tuple(COMPLETION, req.addr, cycle));
+    outstanding--;
+  };
+  cur_cycle = &cycle;
+
+  while(next < trace.size() || outstanding > 0 || cycle < end_cycle) {
+    for(; next < trace.size() && trace[next].arrival <= cycle; ++next) {
+      Request req(trace[next].addr, trace[next].type, complete);
+      if(!mem->send(req))
+        break;
+      if(trace[next].type == Request::Type::READ)
+        outstanding++;
+    }
+
+    if(mode == SKIP_IDLE_TICKS &&
+       (next == trace.size() || trace[next].arrival > cycle)) {
+      long until = next < trace.size() ? trace[next].arrival : end_cycle;
+      long skip  = std::min(mem->idle_ticks(), until - cycle);
+      if(skip > 0) {
+        mem->skip_ticks(skip);
+        cycle += skip;
+        continue;
+      }
+    }
+
+    mem->tick();
+    result.ticks++;
+    cycle++;
+  }
+
+  mem->finish();
+  result.stats = print_stats(first_stat);
+  delete mem;
+  return result;
+}
+
+static void expect_same_results(unsigned seed, int num_bursts) {
+  std::vector<Trace_Req> trace     = make_trace(seed, num_bursts);
+  long                   end_cycle = trace.back().arrival + 50000;
+  long                   num_reads = 0;
+  for(const Trace_Req& req : trace)
+    num_reads += req.type == Request::Type::READ;
+
+  Run_Result every = run_trace(trace, TICK_EVERY_CYCLE, end_cycle);
+  Run_Result lazy  = run_trace(trace, TICK_LAZILY, end_cycle);
+  Run_Result skip  = run_trace(trace, SKIP_IDLE_TICKS, end_cycle);
+
+  EXPECT_EQ(every.completions.size(), num_reads);
+  EXPECT_NE(every.stats.find("dram_cycles"), std::string::npos);
+
+  EXPECT_EQ(every.completions, lazy.completions);
+  EXPECT_EQ(every.dram_events, lazy.dram_events);
+  EXPECT_EQ(every.stats, lazy.stats);
+
+  EXPECT_EQ(every.completions, skip.completions);
+  EXPECT_EQ(every.dram_events, skip.dram_events);
+  EXPECT_EQ(every.stats, skip.stats);
+
+  // the trace is mostly idle, so most cycles must have been skipped
+  EXPECT_LT(10 * skip.ticks, every.ticks);
+}
+
+TEST(RamulatorTest, SameResultsWithAndWithoutSkipping) {
+  expect_same_results(1, 40);
+}
+
+TEST(RamulatorTest, SameResultsWithAndWithoutSkippingLongTrace) {
+  expect_same_results(7, 200);
+}
+
+/* The pool runs the channels of a tick on several threads and replays their
+   callbacks in channel order, so it must match ticking them one by one, both
+   when ticking every cycle and when the workers go to sleep over skipped
+   idle cycles */
+static void expect_same_results_on_pool(unsigned seed, int num_bursts,
+                                        int channels, int channel_threads) {
+  std::vector<Trace_Req> trace     = make_trace(seed, num_bursts);
+  long                   end_cycle = trace.back().arrival + 50000;
+
+  for(Skip_Mode mode : {TICK_EVERY_CYCLE, SKIP_IDLE_TICKS}) {
+    Run_Result serial = run_trace(trace, mode, end_cycle, channels, 1);
+    Run_Result pool   = run_trace(trace, mode, end_cycle, channels,
+                                channel_threads);
+
+    EXPECT_FALSE(serial.completions.empty());
+    EXPECT_EQ(serial.callbacks, pool.callbacks);
+    EXPECT_EQ(serial.stats, pool.stats);
+    EXPECT_EQ(serial.ticks, pool.ticks);
+  }
+}
+
+TEST(RamulatorTest, SameResultsOnChannelPool) {
+  expect_same_results_on_pool(3, 30, 2, 2);
+}
+
+TEST(RamulatorTest, SameResultsOnUnevenChannelPool) {
+  expect_same_results_on_pool(5, 30, 4, 3);
+}
@@ -23,238 +23,222 @@
  * File         : scarab_dummy_client_test.cc
  * Author       : HPS Research Group
  * Date         : 1/16/2019
- * Description  :
+ * Description  : Runs the Scarab side of the exec-driven frontend
+ *                (pin_exec_driven_fe.cc) against a dummy pintool client, over
+ *                the socket and over the shared memory rings.
  ***************************************************************************************/
 
 #include <algorithm>
+#include <unistd.h>
+#include <vector>
 #include "../frontend/pin_exec_driven_fe.h"
-#include "../frontend/pin_trace_read.h"
 #include "../op.h"
 #include "../pin/pin_lib/message_queue_interface_lib.h"
 #include "../pin/pin_lib/pin_scarab_common_lib.h"
+#include "../pin/pin_lib/shm_ring.h"
 #include "gtest/gtest.h"
 
 #ifndef TEST_SOCKET_FILE
 #define TEST_SOCKET_FILE "/tmp/test_socket.tmp"
 #endif
 
-const char* PIN_EXEC_DRIVEN_FE_SOCKET = TEST_SOCKET_FILE;
+char* PIN_EXEC_DRIVEN_FE_SOCKET         = (char*)TEST_SOCKET_FILE;
+Flag  PIN_EXEC_DRIVEN_FE_SHM_RING       = FALSE;
+uns   PIN_EXEC_DRIVEN_FE_SHM_RING_SLOTS = 1024;
 
 #ifndef NUM_CLIENTS
 #define NUM_CLIENTS 1
 #endif
 
-#define CLIENT_TRACE_FILE ((const char*)"./simple_loop.trace.bz2")
+#define TRACE_LENGTH 57
+#define TRACE_START_ADDR 0x400000
 #define NUM_OPS_IN_PACKET 10
 
 
-#define NEW_GTEST(testname, servername, clientname)                          \
-  TEST(ScarabDummyClientTest, testname) {                                    \
-    pthread_t scarab_thread;                                                 \
-    pthread_t client_thread[NUM_CLIENTS];                                    \
-                                                                             \
-    read_trace_file_into_memory();                                           \
-    client.resize(NUM_CLIENTS, nullptr);                                     \
-                                                                             \
-    ::pthread_create(&scarab_thread, nullptr, scarab_test_##servername,      \
-                     nullptr);                                               \
-    ::sleep(1);                                                              \
-                                                                             \
-    int i_array[NUM_CLIENTS];                                                \
-    for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {                              \
-      i_array[i] = i;                                                        \
-      ::pthread_create(&client_thread[i], nullptr, client_test_##clientname, \
-                       (void*)&i_array[i]);                                  \
-    }                                                                        \
-                                                                             \
-                                                                             \
-    ::pthread_join(scarab_thread, nullptr);                                  \
-    for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {                              \
-      ::pthread_join(client_thread[i], nullptr);                             \
-    }                                                                        \
-                                                                             \
-    scarab_teardown();                                                       \
-    client_teardown();                                                       \
+#define NEW_GTEST(testname, servername, use_ring)                           \
+  TEST(ScarabDummyClientTest, testname) {                                   \
+    pthread_t scarab_thread;                                                \
+    pthread_t client_thread[NUM_CLIENTS];                                   \
+                                                                            \
+    PIN_EXEC_DRIVEN_FE_SHM_RING = use_ring;                                 \
+    make_trace();                                                           \
+    client.resize(NUM_CLIENTS, nullptr);                                    \
+    retired_uids.clear();                                                   \
+    retired_uids.resize(NUM_CLIENTS);                                       \
+                                                                            \
+    ::pthread_create(&scarab_thread, nullptr, scarab_test_##servername,     \
+                     nullptr);                                              \
+    ::sleep(1);                                                             \
+                                                                            \
+    int i_array[NUM_CLIENTS];                                               \
+    for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {                             \
+      i_array[i] = i;                                                       \
+      ::pthread_create(&client_thread[i], nullptr, client_test_DummyClient, \
+                       (void*)&i_array[i]);                                 \
+    }                                                                       \
+                                                                            \
+    ::pthread_join(scarab_thread, nullptr);                                 \
+    for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {                             \
+      ::pthread_join(client_thread[i], nullptr);                            \
+    }                                                                       \
+    PIN_EXEC_DRIVEN_FE_SHM_RING = FALSE;                                    \
   }
 
-std::vector<Client*>       client;
-std::vector<compressed_op> trace;
-std::vector<uint32_t>      scarab_side_trace_index;
+extern "C" Counter uop_generator_recoveries[];
+extern SIM_THREAD_LOCAL int* off_path;
 
-extern std::vector<ScarabOpBuffer_type> cached_cop_buffers;
+std::vector<Client*>               client;
+std::vector<compressed_op>         trace;
+std::vector<std::vector<uint64_t>> retired_uids;
 
 void  setup_dummy_globals();
 void  teardown_dummy_globals();
 void  scarab_setup();
 void  scarab_teardown();
-void  client_setup(uint32_t i);
-void  client_teardown();
-void* scarab_test_CanFetchOp(void*);
+void  expect_fetch(uint32_t proc_id, uint32_t trace_idx);
+void  expect_fetch_range(uint32_t proc_id, uint32_t first, uint32_t last);
+void  expect_end_of_trace(uint32_t proc_id);
 void* scarab_test_FetchOp(void*);
+void* scarab_test_RedirectRecover(void*);
 void* scarab_test_Retire(void*);
-void* client_test_Retire(void*);
 void* client_test_DummyClient(void*);
-void* scarab_test(void*);
-void* client_test2(void*);
-void  read_trace_file_into_memory();
+void  make_trace();
 
 /*********************************************************************
  * Gtest functions
  *********************************************************************/
 
-NEW_GTEST(CanFetchOp, CanFetchOp, DummyClient);
-NEW_GTEST(FetchOp, FetchOp, DummyClient);
-NEW_GTEST(Retire, Retire, Retire);
+NEW_GTEST(FetchOp, FetchOp, FALSE);
+NEW_GTEST(RedirectRecover, RedirectRecover, FALSE);
+NEW_GTEST(Retire, Retire, FALSE);
+NEW_GTEST(RingFetchOp, FetchOp, TRUE);
+NEW_GTEST(RingRedirectRecover, RedirectRecover, TRUE);
+NEW_GTEST(RingRetire, Retire, TRUE);
 
 /*********************************************************************
  * Test Functions
  *********************************************************************/
 
-void* scarab_test_CanFetchOp(void* ptr) {
+void* scarab_test_FetchOp(void* ptr) {
   scarab_setup();
 
-  std::vector<uint32_t> expectedBufferSize(NUM_CLIENTS, NUM_OPS_IN_PACKET);
-  std::vector<uint32_t> numOpsRemaining(NUM_CLIENTS, trace.size());
-
-  for(uint32_t j = 0; j < trace.size(); ++j) {
-    for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {
-      compressed_op cop;
-      bool          success = pin_exec_driven_can_fetch_op(i);
-
-      bool trace_success = scarab_side_trace_index[i] < trace.size();
-      if(success) {
-        cop = trace[scarab_side_trace_index[i]];
-        scarab_side_trace_index[i]++;
-      }
-
-      EXPECT_EQ(memcmp(&cached_cop_buffers[i].front(), &cop, sizeof(cop)), 0);
-      EXPECT_EQ(cached_cop_buffers[i].size(), expectedBufferSize[i]);
-      EXPECT_EQ(success, j < trace.size());
-      EXPECT_EQ(success, trace_success);
-
-      expectedBufferSize[i]--;
-      numOpsRemaining[i]--;
-      if(expectedBufferSize[i] == 0)
-        expectedBufferSize[i] = std::min((uint32_t)NUM_OPS_IN_PACKET,
-                                         numOpsRemaining[i]);
-      cached_cop_buffers[i].pop_front();
-    }
+  for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {
+    expect_fetch_range(i, 0, TRACE_LENGTH - 1);
+    expect_end_of_trace(i);
   }
 
-  EXPECT_NE(trace.size(), 0);
+  scarab_teardown();
+  return nullptr;
 }
 
-void* scarab_test_FetchOp(void* ptr) {
+/* Redirect to a wrong path in the middle of a packet, then recover after the
+   last correct op.  The ops left in the packet must be dropped each time. */
+void* scarab_test_RedirectRecover(void* ptr) {
   scarab_setup();
 
-  std::vector<uint32_t> expectedBufferSize(NUM_CLIENTS, NUM_OPS_IN_PACKET);
-  std::vector<uint32_t> numOpsRemaining(NUM_CLIENTS, trace.size());
-
-  for(uint32_t j = 0; j < trace.size(); ++j) {
-    for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {
-      Op op;
-
-      do {
-        pin_exec_driven_can_fetch_op(i);
-
-        EXPECT_EQ(
-          memcmp(&cached_cop_buffers[i].front(),
-                 &trace[scarab_side_trace_index[i]], sizeof(compressed_op)),
-          0);
-        EXPECT_EQ(cached_cop_buffers[i].size(), expectedBufferSize[i]);
-
-        pin_exec_driven_fetch_op(i, &op);
-
-        EXPECT_EQ(op.fetch_addr,
-                  trace[scarab_side_trace_index[i]].instruction_addr);
-      } while(!op.eom);
+  for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {
+    expect_fetch_range(i, 0, 14);
 
-      scarab_side_trace_index[i]++;
-      expectedBufferSize[i]--;
-      numOpsRemaining[i]--;
+    pin_exec_driven_redirect(i, trace[14].inst_uid,
+                             trace[40].instruction_addr);
+    EXPECT_EQ(uop_generator_recoveries[i], 1);
+    expect_fetch_range(i, 40, 44);
 
-      if(expectedBufferSize[i] == 0)
-        expectedBufferSize[i] = std::min((uint32_t)NUM_OPS_IN_PACKET,
-                                         numOpsRemaining[i]);
-    }
+    pin_exec_driven_recover(i, trace[14].inst_uid);
+    EXPECT_EQ(uop_generator_recoveries[i], 2);
+    expect_fetch_range(i, 15, TRACE_LENGTH - 1);
+    expect_end_of_trace(i);
   }
 
-  EXPECT_NE(trace.size(), 0);
+  scarab_teardown();
+  return nullptr;
 }
 
 void* scarab_test_Retire(void* ptr) {
   scarab_setup();
 
-  pin_exec_driven_retire(0, 0);
-  pin_exec_driven_retire(0, 1);
-  pin_exec_driven_retire(0, 2);
-  pin_exec_driven_retire(0, 3);
-  pin_exec_driven_retire(0, 4);
-}
-
-void* client_test_Retire(void* ptr) {
-  uint32_t client_id = *((uint32_t*)ptr);
-  client_setup(client_id);
-  Scarab_To_Pin_Msg msg;
-
-  ::sleep(5);
-
-  msg = client[client_id]->pin_receive<Scarab_To_Pin_Msg>();
-  EXPECT_EQ(msg.inst_uid, 0);
-
-  msg = client[client_id]->pin_receive<Scarab_To_Pin_Msg>();
-  EXPECT_EQ(msg.inst_uid, 1);
-
-  msg = client[client_id]->pin_receive<Scarab_To_Pin_Msg>();
-  EXPECT_EQ(msg.inst_uid, 2);
-
-  msg = client[client_id]->pin_receive<Scarab_To_Pin_Msg>();
-  EXPECT_EQ(msg.inst_uid, 3);
+  for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {
+    for(uint64_t uid = 0; uid < 5; ++uid) {
+      pin_exec_driven_retire(i, uid);
+    }
+  }
 
-  msg = client[client_id]->pin_receive<Scarab_To_Pin_Msg>();
-  EXPECT_EQ(msg.inst_uid, 4);
+  scarab_teardown();
+  for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {
+    EXPECT_EQ(retired_uids[i], std::vector<uint64_t>({0, 1, 2, 3, 4}));
+  }
+  return nullptr;
 }
 
+/* Serves the trace as the pintool does: a packet of ops per FE_FETCH_OP, a
+   redirect moves to the op at the given address, a recover resumes after the
+   given op, and the exit retire ends the run.  With the rings the ring size
+   comes over the socket, then the commands and ops go through the ring. */
 void* client_test_DummyClient(void* ptr) {
   uint32_t client_id = *((uint32_t*)ptr);
-  client_setup(client_id);
+  client[client_id]  = new Client(TEST_SOCKET_FILE);
+
+  ShmRing* ring = nullptr;
+  if(PIN_EXEC_DRIVEN_FE_SHM_RING) {
+    uint32_t op_slots = client[client_id]->pin_receive<uint32_t>();
+    ring              = new ShmRing();
+    ring->attach(shm_ring_path(TEST_SOCKET_FILE, client_id));
+    EXPECT_EQ(ring->get_op_slots(), op_slots);
+    EXPECT_LE(NUM_OPS_IN_PACKET, op_slots);
+  }
 
-  bool     done     = false;
-  uint32_t numSends = 0, numOps = 0;
+  bool     done = false;
+  uint32_t next = 0;
 
   while(!done) {
-    Scarab_To_Pin_Msg msg = client[client_id]->receive<Scarab_To_Pin_Msg>();
+    Scarab_To_Pin_Msg msg;
+    if(ring)
+      msg = ring->receive_cmd();
+    else
+      msg = client[client_id]->pin_receive<Scarab_To_Pin_Msg>();
     switch(msg.type) {
       case FE_FETCH_OP: {
         ScarabOpBuffer_type buffer;
-
         for(uint32_t i = 0; i < NUM_OPS_IN_PACKET; ++i) {
-          compressed_op cop;
-          bool          success = numOps < trace.size();
-
-          if(!success) {
-            done = true;
+          compressed_op cop = next < trace.size() ? trace[next] :
+                                                    create_sentinel();
+          if(next < trace.size())
+            next++;
+          if(ring)
+            ring->stage_op(cop);
+          else
+            buffer.push_back(cop);
+          if(cop.is_sentinel)
             break;
-          } else {
-            cop = trace[numOps];
-          }
-
-          numOps++;
-          buffer.push_back(cop);
         }
-
-        client[client_id]->send<ScarabOpBuffer_type>(buffer);
-        numSends++;
-
+        if(ring)
+          ring->publish_ops();
+        else
+          client[client_id]->send<ScarabOpBuffer_type>(buffer);
         break;
       }
+      case FE_REDIRECT:
+        next = (msg.inst_addr - TRACE_START_ADDR) / 4;
+        break;
+      case FE_RECOVER_AFTER:
+        next = msg.inst_uid + 1;
+        break;
+      case FE_RETIRE:
+        if(msg.inst_addr)
+          done = true;
+        else
+          retired_uids[client_id].push_back(msg.inst_uid);
+        break;
       default:
-        EXPECT_EQ(1, 0);
+        ADD_FAILURE() << "unexpected command " << msg.type;
+        done = true;
     }
   }
 
-  EXPECT_EQ(trace.size(), numOps);
-  EXPECT_EQ((trace.size() / NUM_OPS_IN_PACKET) + 1, numSends);
+  /* Scarab waits for the client to go away before it unmaps the rings */
+  delete ring;
+  delete client[client_id];
+  return nullptr;
 }
 
 
@@ -262,58 +246,72 @@ void* client_test_DummyClient(void* ptr) {
  * Common Functions
  *********************************************************************/
 
-void read_trace_file_into_memory() {
-  int file_success = 1;
-  pin_trace_file_pointer_init(1);
-  pin_trace_open(0, CLIENT_TRACE_FILE);
+void expect_fetch(uint32_t proc_id, uint32_t trace_idx) {
+  Op      op;
+  Op_Cold op_cold;
+  op.cold = &op_cold;
+
+  ASSERT_TRUE(pin_exec_driven_can_fetch_op(proc_id)) << "op " << trace_idx;
+  EXPECT_EQ(pin_exec_driven_next_fetch_addr(proc_id),
+            trace[trace_idx].instruction_addr);
+  pin_exec_driven_fetch_op(proc_id, &op);
+  EXPECT_EQ(op.inst_info->addr, trace[trace_idx].instruction_addr);
+  EXPECT_EQ(op.inst_uid, trace[trace_idx].inst_uid);
+  EXPECT_TRUE(op.eom);
+}
+
+void expect_fetch_range(uint32_t proc_id, uint32_t first, uint32_t last) {
+  for(uint32_t idx = first; idx <= last; ++idx) {
+    expect_fetch(proc_id, idx);
+  }
+}
 
+void expect_end_of_trace(uint32_t proc_id) {
+  EXPECT_FALSE(pin_exec_driven_can_fetch_op(proc_id));
+}
+
+/* Straight-line code: op i is at TRACE_START_ADDR + 4 * i and has uid i */
+void make_trace() {
   trace.clear();
-  while(file_success) {
+  for(uint64_t i = 0; i < TRACE_LENGTH; ++i) {
     compressed_op cop;
-    file_success = pin_trace_read(0, &cop);
+    memset(&cop, 0, sizeof(cop));
+    cop.inst_uid              = i;
+    cop.instruction_addr      = TRACE_START_ADDR + 4 * i;
+    cop.instruction_next_addr = cop.instruction_addr + 4;
+    cop.size                  = 4;
     trace.push_back(cop);
   }
-
-  pin_trace_close(0);
 }
 
 void setup_dummy_globals() {
-  op_count   = (Counter*)malloc(sizeof(Counter) * NUM_CLIENTS);
-  inst_count = (Counter*)malloc(sizeof(Counter) * NUM_CLIENTS);
-  // op_count = new Counter [NUM_CLIENTS];
-  // inst_count = new Counter [NUM_CLIENTS];
-  unique_count_per_core = new Counter[NUM_CLIENTS];
-  trace_read_done       = new Flag[NUM_CLIENTS];
-  std::fill_n(trace_read_done, NUM_CLIENTS, 0);
+  static SIM_THREAD_LOCAL int on_path = 0;
+
+  mystdout              = stdout;
+  mystderr              = stderr;
+  mystatus              = stdout;
+  off_path              = &on_path;
+  op_count              = new Counter[NUM_CLIENTS]();
+  inst_count            = new Counter[NUM_CLIENTS]();
+  unique_count_per_core = new Counter[NUM_CLIENTS]();
+  trace_read_done       = new Flag[NUM_CLIENTS]();
 }
 
 void teardown_dummy_globals() {
-  free(op_count);
-  free(inst_count);
-  delete unique_count_per_core;
-  delete trace_read_done;
+  delete[] op_count;
+  delete[] inst_count;
+  delete[] unique_count_per_core;
+  delete[] trace_read_done;
 }
 
 void scarab_setup() {
-  pin_exec_driven_init(NUM_CLIENTS);
-  scarab_side_trace_index.clear();
-  scarab_side_trace_index.resize(NUM_CLIENTS, 0);
   setup_dummy_globals();
+  pin_exec_driven_init(NUM_CLIENTS);
 }
 
+/* Sends the exit retire and waits for the clients to close */
 void scarab_teardown() {
+  Flag retired_exit[NUM_CLIENTS] = {FALSE};
+  pin_exec_driven_done(retired_exit);
   teardown_dummy_globals();
 }
-
-void client_setup(uint32_t i) {
-  client[i] = new Client(TEST_SOCKET_FILE);
-}
-
-void client_teardown() {
-  for(uint32_t i = 0; i < NUM_CLIENTS; ++i) {
-    delete client[i];
-  }
-}
-
-
-/******************************************************************/
@@ -0,0 +1,128 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "../pin/pin_lib/shm_ring.h"
+
+#define TEST_RING_FILE "./temp_shm_ring.tmp"
+#define TEST_RING_SLOTS 64
+#define TEST_BATCH_SIZE 10
+
+static compressed_op make_op(uint64_t uid) {
+  compressed_op op;
+  memset(&op, 0, sizeof(op));
+  op.instruction_addr = 0x400000 + uid * 4;
+  op.inst_uid         = uid;
+  op.size             = 4;
+  return op;
+}
+
+/* Plays the pintool: answers every FE_FETCH_OP with the next batch of ops
+   (an empty batch once num_ops are sent), restarts the stream at inst_uid on
+   FE_REDIRECT and stops on a final FE_RETIRE. */
+static void pin_side(uint64_t num_ops) {
+  ShmRing ring;
+  ring.attach(TEST_RING_FILE);
+  uint64_t next_uid = 0;
+  while(true) {
+    Scarab_To_Pin_Msg cmd = ring.receive_cmd();
+    if(cmd.type == FE_RETIRE && cmd.inst_addr)
+      break;
+    if(cmd.type == FE_REDIRECT) {
+      ring.discard_staged_ops();
+      next_uid = cmd.inst_uid;
+    } else if(cmd.type == FE_FETCH_OP) {
+      for(int ii = 0; ii < TEST_BATCH_SIZE && next_uid < num_ops; ii++)
+        ring.stage_op(make_op(next_uid++));
+      ring.publish_ops();
+    }
+  }
+}
+
+static void send(ShmRing& ring, Scarab_To_Pin_Cmd type, uint64_t uid,
+                 uint64_t addr) {
+  Scarab_To_Pin_Msg msg;
+  msg.type      = type;
+  msg.inst_uid  = uid;
+  msg.inst_addr = addr;
+  ring.send_cmd(msg);
+}
+
+static void fetch_batch(ShmRing& ring) {
+  uint32_t batches = ring.num_batches();
+  send(ring, FE_FETCH_OP, 0, 0);
+  ring.wait_for_batch(batches);
+}
+
+TEST(ShmRing, DeliversBatchesInOrder) {
+  const uint64_t num_ops = 1000;
+  ShmRing        ring;
+  ring.create(TEST_RING_FILE, TEST_RING_SLOTS);
+  std::thread pin(pin_side, num_ops);
+
+  uint64_t uid = 0;
+  while(true) {
+    fetch_batch(ring);
+    if(!ring.num_ops())
+      break;
+    EXPECT_LE(ring.num_ops(), (uint32_t)TEST_BATCH_SIZE);
+    while(ring.num_ops()) {
+      EXPECT_EQ(ring.front_op()->inst_uid, uid);
+      EXPECT_EQ(ring.front_op()->instruction_addr, 0x400000 + uid * 4);
+      ring.pop_op();
+      uid++;
+    }
+  }
+  EXPECT_EQ(uid, num_ops);
+
+  send(ring, FE_RETIRE, -1, 1);
+  pin.join();
+  ring.close();
+  EXPECT_NE(access(TEST_RING_FILE, F_OK), 0);
+}
+
+TEST(ShmRing, DropsOpsOnRedirect) {
+  ShmRing ring;
+  ring.create(TEST_RING_FILE, TEST_RING_SLOTS);
+  std::thread pin(pin_side, 100);
+
+  for(int ii = 0; ii < 2 * TEST_RING_SLOTS; ii++) {
+    fetch_batch(ring);
+    ASSERT_EQ(ring.num_ops(), (uint32_t)TEST_BATCH_SIZE);
+    ring.pop_op();
+    send(ring, FE_REDIRECT, 50, 0);
+    ring.drop_ops();
+    EXPECT_EQ(ring.num_ops(), 0u);
+    fetch_batch(ring);
+    ASSERT_EQ(ring.num_ops(), (uint32_t)TEST_BATCH_SIZE);
+    EXPECT_EQ(ring.front_op()->inst_uid, 50u);
+    ring.drop_ops();
+    send(ring, FE_REDIRECT, 0, 0);
+  }
+
+  send(ring, FE_RETIRE, -1, 1);
+  pin.join();
+}
@@ -0,0 +1,234 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "../globals/global_defs.h"
+#include "../memory/stack_sweep.h"
+}
+
+#define TEST_LINE_SIZE 64
+#define TEST_STREAM_LENGTH 20000
+
+/* The parameters, globals and helpers stack_sweep.c uses */
+extern "C" {
+uns   STACK_SWEEP_LEVEL     = STACK_SWEEP_LEVEL_DCACHE;
+uns   STACK_SWEEP_MIN_SETS  = 1;
+uns   STACK_SWEEP_MAX_SETS  = 64;
+uns   STACK_SWEEP_MAX_ASSOC = 16;
+uns   DCACHE_LINE_SIZE      = TEST_LINE_SIZE;
+uns   L1_LINE_SIZE          = TEST_LINE_SIZE;
+uns   MLC_LINE_SIZE         = TEST_LINE_SIZE;
+Flag  MLC_PRESENT           = FALSE;
+Flag  PRIVATE_L1            = FALSE;
+uns   NUM_CORES             = 1;
+char* OUTPUT_DIR            = NULL;
+
+FILE*                    mystdout    = stdout;
+FILE*                    mystderr    = stderr;
+FILE*                    mystatus    = stdout;
+SIM_THREAD_LOCAL Counter cycle_count = 0;
+Counter*                 op_count;
+Counter*                 inst_count;
+
+void breakpoint(const char[], const int) {}
+
+FILE* file_tag_fopen(char const* const dir, char const* const name,
+                     char const* const mode) {
+  return fopen((std::string(dir) + "/" + name + ".out").c_str(), mode);
+}
+}
+
+/* (core, sets, assoc) */
+typedef std::tuple<uns, uns, uns> Geometry;
+typedef std::map<Geometry, uns64> Miss_Counts;
+
+/* A set-associative LRU cache of one geometry, simulated directly */
+class LruCache {
+ public:
+  LruCache(uns num_sets, uns assoc) :
+      num_sets(num_sets), assoc(assoc), sets(num_sets), misses(0) {}
+
+  void access(Addr addr) {
+    Addr               line = addr / TEST_LINE_SIZE;
+    std::vector<Addr>& set  = sets[line % num_sets];  // MRU first
+    auto               way  = std::find(set.begin(), set.end(), line);
+    if(way == set.end()) {
+      misses++;
+      if(set.size() == assoc)
+        set.pop_back();
+    } else {
+      set.erase(way);
+    }
+    set.insert(set.begin(), line);
+  }
+
+  uns64 get_misses() const { return misses; }
+
+ private:
+  uns                            num_sets;
+  uns                            assoc;
+  std::vector<std::vector<Addr>> sets;
+  uns64                          misses;
+};
+
+class StackSweepTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir = ::testing::TempDir() + "stack_sweep_test." + std::to_string(getpid());
+    mkdir(dir.c_str(), 0700);
+    OUTPUT_DIR        = (char*)dir.c_str();
+    STACK_SWEEP_LEVEL = STACK_SWEEP_LEVEL_DCACHE;
+    NUM_CORES         = 1;
+  }
+
+  void TearDown() override {
+    unlink(output_file().c_str());
+    rmdir(dir.c_str());
+  }
+
+  std::string output_file() const { return dir + "/stack_sweep.out"; }
+
+  /* mostly a hot set of lines, some strided accesses and some accesses over a
+     footprint a few times larger than the largest swept cache */
+  static std::vector<Addr> stream(uns seed) {
+    std::vector<Addr> addrs;
+    uns64             state = seed * 2654435761ull + 1;
+    for(uns ii = 0; ii < TEST_STREAM_LENGTH; ii++) {
+      state      = state * 6364136223846793005ull + 1442695040888963407ull;
+      uns64 rand = state >> 33;
+      Addr  line;
+      if(rand % 4 < 2)
+        line = rand % 48;
+      else if(rand % 4 == 2)
+        line = 1000 + (ii * 3) % 512;
+      else
+        line = 5000 + rand % 4096;
+      addrs.push_back(line * TEST_LINE_SIZE + rand % TEST_LINE_SIZE);
+    }
+    return addrs;
+  }
+
+  /* misses of every geometry the sweep covers, from direct simulations */
+  static Miss_Counts simulate(uns core, const std::vector<Addr>& addrs) {
+    Miss_Counts misses;
+    for(uns sets = STACK_SWEEP_MIN_SETS; sets <= STACK_SWEEP_MAX_SETS;
+        sets <<= 1) {
+      for(uns assoc = 1; assoc <= STACK_SWEEP_MAX_ASSOC; assoc++) {
+        LruCache cache(sets, assoc);
+        for(Addr addr : addrs)
+          cache.access(addr);
+        misses[Geometry(core, sets, assoc)] = cache.get_misses();
+      }
+    }
+    return misses;
+  }
+
+  /* misses of every geometry in the output of stack_sweep_done */
+  Miss_Counts read_sweep() const {
+    Miss_Counts misses;
+    FILE*       file = fopen(output_file().c_str(), "r");
+    EXPECT_NE(file, nullptr);
+    if(!file)
+      return misses;
+    char line[256];
+    uns  core = 0;
+    while(fgets(line, sizeof(line), file)) {
+      char   scope[16];
+      uns    sets, assoc, section;
+      uns64  size, count;
+      double ratio;
+      if(sscanf(line, "# level %*s %15s %u", scope, &section) == 2)
+        core = section;
+      else if(sscanf(line, "%u %u %llu %llu %lf", &sets, &assoc, &size,
+                     &count, &ratio) == 5) {
+        EXPECT_EQ(size, (uns64)sets * assoc * TEST_LINE_SIZE);
+        misses[Geometry(core, sets, assoc)] = count;
+      }
+    }
+    fclose(file);
+    return misses;
+  }
+
+  std::string dir;
+};
+
+TEST_F(StackSweepTest, MatchesSetAssociativeLru) {
+  std::vector<Addr> addrs = stream(1);
+
+  stack_sweep_init();
+  for(Addr addr : addrs) {
+    stack_sweep_access(STACK_SWEEP_LEVEL_DCACHE, 0, addr);
+    stack_sweep_access(STACK_SWEEP_LEVEL_L1, 0, addr + 64 * TEST_LINE_SIZE);
+  }
+  stack_sweep_done();
+
+  Miss_Counts expected = simulate(0, addrs);
+  Miss_Counts swept    = read_sweep();
+  EXPECT_EQ(swept.size(), 7u * 16u);
+  EXPECT_EQ(swept, expected);
+  /* a few geometries by name, so that a failure is easy to read */
+  EXPECT_EQ(swept[Geometry(0, 1, 1)], expected[Geometry(0, 1, 1)]);
+  EXPECT_EQ(swept[Geometry(0, 4, 2)], expected[Geometry(0, 4, 2)]);
+  EXPECT_EQ(swept[Geometry(0, 16, 8)], expected[Geometry(0, 16, 8)]);
+  EXPECT_EQ(swept[Geometry(0, 64, 16)], expected[Geometry(0, 64, 16)]);
+}
+
+TEST_F(StackSweepTest, KeepsPrivateLevelsApart) {
+  NUM_CORES = 2;
+  std::vector<Addr> addrs[2] = {stream(2), stream(3)};
+
+  stack_sweep_init();
+  for(uns ii = 0; ii < TEST_STREAM_LENGTH; ii++) {
+    stack_sweep_access(STACK_SWEEP_LEVEL_DCACHE, 0, addrs[0][ii]);
+    stack_sweep_access(STACK_SWEEP_LEVEL_DCACHE, 1, addrs[1][ii]);
+  }
+  stack_sweep_done();
+
+  Miss_Counts expected = simulate(0, addrs[0]);
+  Miss_Counts core1    = simulate(1, addrs[1]);
+  expected.insert(core1.begin(), core1.end());
+  EXPECT_EQ(read_sweep(), expected);
+}
+
+TEST_F(StackSweepTest, SharesASharedLevel) {
+  STACK_SWEEP_LEVEL = STACK_SWEEP_LEVEL_L1;
+  NUM_CORES         = 2;
+  std::vector<Addr> addrs = stream(4);
+
+  stack_sweep_init();
+  for(uns ii = 0; ii < TEST_STREAM_LENGTH; ii++)
+    stack_sweep_access(STACK_SWEEP_LEVEL_L1, ii % 2, addrs[ii]);
+  stack_sweep_done();
+
+  EXPECT_EQ(read_sweep(), simulate(0, addrs));
+}
@@ -0,0 +1,141 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "../pin/pin_lib/trace_container.h"
+
+#define TEST_CONTAINER_FILE "./temp_trace_container.tmp"
+
+static std::vector<ctype_pin_inst> read_bzip2_trace(const char* name) {
+  std::vector<ctype_pin_inst> insts;
+  char                        cmdline[1024];
+  sprintf(cmdline, "bzip2 -dc %s", name);
+  FILE*          stream = popen(cmdline, "r");
+  ctype_pin_inst inst;
+  while(stream && fread(&inst, sizeof(inst), 1, stream) == 1)
+    insts.push_back(inst);
+  if(stream)
+    pclose(stream);
+  return insts;
+}
+
+/* A synthetic trace with a small static footprint but noisy dynamic fields:
+   gaps in inst_uid, taken and fall-through next addresses, and memory
+   addresses that move both ways and leave holes in the address slots. */
+static std::vector<ctype_pin_inst> make_synthetic_trace(uint64_t num_insts) {
+  std::vector<ctype_pin_inst> insts;
+  uint64_t                    uid = 100;
+  srand(1);
+  for(uint64_t ii = 0; ii < num_insts; ii++) {
+    ctype_pin_inst inst;
+    memset(&inst, 0, sizeof(inst));
+    uint64_t pc_index = ii % 37;
+    inst.instruction_addr = 0x400000 + pc_index * 4;
+    inst.size             = 4;
+    inst.op_type          = pc_index % 5;
+    inst.num_ld           = pc_index % 3;
+    inst.num_st           = pc_index % 2;
+    strcpy(inst.pin_iclass, "TEST");
+    inst.inst_uid = uid;
+    uid += 1 + (rand() % 4 == 0 ? rand() % 1000 : 0);
+    inst.actually_taken        = rand() % 2;
+    inst.instruction_next_addr = inst.actually_taken ?
+                                   0x500000 - (rand() % 4096) :
+                                   inst.instruction_addr + inst.size;
+    for(int jj = 0; jj < inst.num_ld; jj++)
+      inst.ld_vaddr[jj * 3] = 0x7fff0000 + (rand() % 65536) - 32768;
+    if(inst.num_st)
+      inst.st_vaddr[MAX_ST_NUM - 1] = (uint64_t)rand() << 20;
+    insts.push_back(inst);
+  }
+  return insts;
+}
+
+static void write_container(const std::vector<ctype_pin_inst>& insts,
+                            uint32_t                           block_insts) {
+  TraceContainerWriter writer;
+  ASSERT_TRUE(writer.open(TEST_CONTAINER_FILE, block_insts));
+  for(const ctype_pin_inst& inst : insts)
+    writer.write(&inst);
+  ASSERT_TRUE(writer.close());
+}
+
+static void expect_same_inst(const ctype_pin_inst& expected,
+                             const ctype_pin_inst& actual, uint64_t index) {
+  EXPECT_EQ(0, memcmp(&expected, &actual, sizeof(ctype_pin_inst)))
+    << "instruction " << index << " differs";
+}
+
+static void check_round_trip(const std::vector<ctype_pin_inst>& insts,
+                             uint32_t                           block_insts) {
+  write_container(insts, block_insts);
+  ASSERT_TRUE(trace_container_check_magic(TEST_CONTAINER_FILE));
+
+  TraceContainerReader reader;
+  ASSERT_TRUE(reader.open(TEST_CONTAINER_FILE));
+  ASSERT_EQ(insts.size(), reader.num_insts());
+
+  ctype_pin_inst inst;
+  for(uint64_t ii = 0; ii < insts.size(); ii++) {
+    ASSERT_TRUE(reader.read(&inst));
+    expect_same_inst(insts[ii], inst, ii);
+  }
+  EXPECT_FALSE(reader.read(&inst));
+
+  for(uint64_t ii = 0; ii < insts.size(); ii += 97) {
+    ASSERT_TRUE(reader.seek(ii));
+    ASSERT_TRUE(reader.read(&inst));
+    expect_same_inst(insts[ii], inst, ii);
+  }
+  EXPECT_FALSE(reader.seek(insts.size()));
+  EXPECT_FALSE(reader.read(&inst));
+  reader.close();
+  remove(TEST_CONTAINER_FILE);
+}
+
+TEST(TraceContainer, RoundTripsBzip2Trace) {
+  std::vector<ctype_pin_inst> insts = read_bzip2_trace("simple_loop.trace.bz2");
+  ASSERT_FALSE(insts.empty());
+  check_round_trip(insts, 4);
+  check_round_trip(insts, TRACE_CONTAINER_DEFAULT_BLOCK_INSTS);
+}
+
+TEST(TraceContainer, RoundTripsDynamicFields) {
+  std::vector<ctype_pin_inst> insts = make_synthetic_trace(20000);
+  check_round_trip(insts, 1000);
+  check_round_trip(insts, 333);
+}
+
+TEST(TraceContainer, DeduplicatesStaticInsts) {
+  std::vector<ctype_pin_inst> insts = make_synthetic_trace(20000);
+  TraceContainerWriter        writer;
+  ASSERT_TRUE(writer.open(TEST_CONTAINER_FILE));
+  for(const ctype_pin_inst& inst : insts)
+    writer.write(&inst);
+  EXPECT_EQ(37u, writer.num_static_insts());
+  ASSERT_TRUE(writer.close());
+  remove(TEST_CONTAINER_FILE);
+}
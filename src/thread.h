@@ -29,6 +29,7 @@
 #ifndef __THREAD_H__
 #define __THREAD_H__
 
+#include "globals/global_defs.h"
 #include "globals/global_types.h"
 #include "libs/list_lib.h"
 #include "map.h"
@@ -68,7 +69,7 @@ typedef struct Thread_struct {
 /**************************************************************************************/
 /* External variables */
 
-extern Thread_Data* td; /* here for now, variable declared in sim.c */
+extern SIM_THREAD_LOCAL Thread_Data* td; /* here for now, variable declared in sim.c */
 /* if we ever go MT, this will turn into an array */
 
 
@@ -44,8 +44,14 @@ struct Trigger_struct {
   Trigger_Type type;
   Counter      period;
   Counter      next_threshold;
+  Trigger*     next; /* list of all triggers (see trigger_steps_to_fire) */
 };
 
+/**************************************************************************************/
+/* Global Variables */
+
+static Trigger* all_triggers = NULL;
+
 /**************************************************************************************/
 /* Implementation */
 
@@ -56,6 +62,8 @@ Trigger* trigger_create(const char* name, const char* spec, Trigger_Type type) {
   trigger->name    = strdup(name);
   ASSERT(0, type < TRIGGER_NUM_ELEMS);
   trigger->type = type;
+  trigger->next = all_triggers;
+  all_triggers  = trigger;
 
   if(!strcmp(spec, "none") || !strcmp(spec, "never")) {
     trigger->stat  = NULL;
@@ -106,6 +114,7 @@ Trigger* trigger_create(const char* name, const char* spec, Trigger_Type type) {
               "Stat '%s' for trigger '%s' is a float (triggers support counter "
               "stats only)\n",
               stat_str, name);
+      require_stat(get_stat_idx(stat_str));
   }
 
   trigger->period = atoll(number_str);
@@ -120,8 +129,9 @@ Trigger* trigger_create(const char* name, const char* spec, Trigger_Type type) {
 
 Flag trigger_fired(Trigger* trigger) {
   // common (false) case first
-  if(!trigger->armed || (trigger->stat->count + trigger->stat->total_count) <
-                          trigger->next_threshold) {
+  if(!trigger->armed ||
+     (trigger->stat->cur->count + trigger->stat->total->count) <
+       trigger->next_threshold) {
     return FALSE;
   }
 
@@ -131,7 +141,7 @@ Flag trigger_fired(Trigger* trigger) {
   } else {
     trigger->next_threshold += trigger->period;
     uns skipped = 0;
-    while(trigger->stat->count + trigger->stat->total_count >=
+    while(trigger->stat->cur->count + trigger->stat->total->count >=
           trigger->next_threshold) {
       trigger->next_threshold += trigger->period;
       skipped++;
@@ -155,7 +165,7 @@ double trigger_progress(Trigger* trigger) {
     return 1.0;
 
   ASSERT(0, trigger->next_threshold >= trigger->period);
-  Counter stat_count = trigger->stat->count + trigger->stat->total_count;
+  Counter stat_count = trigger->stat->cur->count + trigger->stat->total->count;
   ASSERT(0, stat_count >= trigger->next_threshold - trigger->period);
   if(stat_count >= trigger->next_threshold)
     return 1.0;
@@ -164,7 +174,28 @@ double trigger_progress(Trigger* trigger) {
          (double)trigger->period;
 }
 
+Counter trigger_steps_to_fire(Counter (*stat_step)(const Stat* stat)) {
+  Counter steps = MAX_CTR;
+  for(Trigger* trigger = all_triggers; trigger; trigger = trigger->next) {
+    if(!trigger->armed)
+      continue;
+    Counter step = stat_step(trigger->stat);
+    if(step == 0)
+      continue;
+    Counter stat_count = trigger->stat->cur->count +
+                         trigger->stat->total->count;
+    if(stat_count >= trigger->next_threshold)
+      continue;  // fires when it is checked next anyway
+    steps = MIN2(steps, (trigger->next_threshold - stat_count - 1) / step);
+  }
+  return steps;
+}
+
 void trigger_free(Trigger* trigger) {
+  Trigger** link = &all_triggers;
+  while(*link != trigger)
+    link = &(*link)->next;
+  *link = trigger->next;
   free(trigger->name);
   free(trigger);
 }
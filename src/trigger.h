@@ -32,6 +32,7 @@
 #define __TRIGGER_H__
 
 #include "globals/global_types.h"
+#include "statistics.h"
 
 /**************************************************************************************/
 /* Types */
@@ -56,6 +57,10 @@ Flag trigger_on(Trigger* trigger);
 
 double trigger_progress(Trigger* trigger);
 
+/* Returns how many times stat_step(stat) can be added to the stat of every
+   armed trigger before any of them fires */
+Counter trigger_steps_to_fire(Counter (*stat_step)(const Stat* stat));
+
 void trigger_free(Trigger* trigger);
 
 #endif  // __TRIGGER_H__
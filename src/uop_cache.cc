@@ -26,7 +26,8 @@
 #include "libs/cache_lib.h"
 #include "memory/memory.h"
 #include "memory/memory.param.h"
-#include "libs/cpp_cache.h"
+#include "libs/cache_engine.h"
+#include "checkpoint.h"
 #include "uop_cache.h"
 #include "icache_stage.h"
 #include "uop_queue_stage.h"
@@ -45,29 +46,24 @@ typedef std::pair<Addr, FT_Info_Static> Uop_Cache_Key;
 /**************************************************************************************/
 /* Local Prototypes */
 
-// uop cache derived class
-class Uop_Cache: public Cpp_Cache<Uop_Cache_Key, Uop_Cache_Data> {
- protected:
-  uns   offset_bits;
-
-  // implementing the virtual hash function
-  uns set_idx_hash(Uop_Cache_Key key);
-
- public:
-  // constructor
-  Uop_Cache(uns nl, uns asc, uns lb, Repl_Policy rp) : Cpp_Cache<Uop_Cache_Key, Uop_Cache_Data>::Cpp_Cache(nl, asc, lb, rp) {
-    // offset_bits is only used to denote the start of the set bits
-    // the set bits follow the offset_bits on the significant side
-    // in other words,
-    // user manipulates the line_bytes of the Cpp_Cache to change the set id hashing pattern
-    offset_bits  = LOG2(line_bytes);
+// set index of a uop cache line
+struct Uop_Cache_Index {
+  // offset_bits is only used to denote the start of the set bits
+  // the set bits follow the offset_bits on the significant side
+  // in other words,
+  // the line size passed to the uop cache changes the set id hashing pattern
+  uns offset_bits;
+  uns num_sets;
+
+  uns operator()(const Uop_Cache_Key& key) const {
+    // use % instead of masking to support num_sets that is not a power of 2
+    return (key.first >> offset_bits) % num_sets;
   }
 };
 
-uns Uop_Cache::set_idx_hash(Uop_Cache_Key key) {
-  // use % instead of masking to support num_sets that is not a power of 2
-  return (key.first >> offset_bits) % num_sets;
-}
+typedef Cache_Engine<Uop_Cache_Key, Uop_Cache_Data, Uop_Cache_Index, Cache_Param_Repl>
+  Uop_Cache;
+typedef Uop_Cache::Line Uop_Cache_Line;
 
 // overload operator == of FT_Info_Static type
 bool operator==(const FT_Info_Static& lhs, const FT_Info_Static& rhs) {
@@ -147,8 +143,10 @@ void init_uop_cache(uns8 proc_id) {
   }
 
   // The cache library computes the number of entries from cache_size_bytes/cache_line_size_bytes,
-  per_core_uop_cache[proc_id] = new Uop_Cache(UOP_CACHE_LINES, UOP_CACHE_ASSOC, UOP_CACHE_LINE_SIZE,
-                                              (Repl_Policy)UOP_CACHE_REPL);
+  per_core_uop_cache[proc_id] = new Uop_Cache(
+    UOP_CACHE_LINES, UOP_CACHE_ASSOC,
+    Uop_Cache_Index{(uns)LOG2(UOP_CACHE_LINE_SIZE), UOP_CACHE_LINES / UOP_CACHE_ASSOC},
+    Cache_Param_Repl((Repl_Policy)UOP_CACHE_REPL));
 }
 
 void set_uop_cache(uns8 proc_id) {
@@ -338,7 +336,7 @@ void end_line_accumulate(Flag last_line_of_ft) {
         } else {
           ASSERT(uop_cache_proc_id, !uop_cache_line);
 
-          Entry<Uop_Cache_Key, Uop_Cache_Data> evicted_entry = per_core_uop_cache[uop_cache_proc_id]->insert({insert_line->line_start, current_accumulating_ft->static_info}, *insert_line);
+          Uop_Cache_Line evicted_entry = per_core_uop_cache[uop_cache_proc_id]->insert({insert_line->line_start, current_accumulating_ft->static_info}, *insert_line);
 
           DEBUG(uop_cache_proc_id,
                 "uop cache line inserted. off_path=%u, addr=0x%llx\n",
@@ -349,7 +347,7 @@ void end_line_accumulate(Flag last_line_of_ft) {
             // need to invalidate all lines from the same FT
             FT_Info_Static evicted_ft_info_static = evicted_entry.key.second;
             Addr invlaidate_addr = evicted_ft_info_static.start;
-            Entry<Uop_Cache_Key, Uop_Cache_Data> invalidated_entry{};
+            Uop_Cache_Line invalidated_entry{};
             do {
               invalidated_entry = per_core_uop_cache[uop_cache_proc_id]->invalidate({invlaidate_addr, evicted_ft_info_static});
               // if the invalidation missed, it means that the line was the one evicted at first
@@ -448,7 +446,7 @@ void accumulate_op(Op* op) {
       }
 
       // if next_line_start != npc, the decoupled fe did not end the FT correctly (mispredict or btb miss), or op is off-path
-      ASSERT(uop_cache_proc_id, next_line_start == op->oracle_info.npc || op->oracle_info.recover_at_decode || op->oracle_info.recover_at_exec || op->off_path);
+      ASSERT(uop_cache_proc_id, next_line_start == OP_ORACLE(op).npc || OP_ORACLE(op).recover_at_decode || OP_ORACLE(op).recover_at_exec || op->off_path);
       current_accumulating_line->offset = next_line_start - current_accumulating_line->line_start;
     }
 
@@ -456,6 +454,48 @@ void accumulate_op(Op* op) {
   }
 }
 
+/**************************************************************************************/
+/* uop_cache_warmup_ft: functional warmup of the uop cache with an on-path FT. */
+/* a hit touches every line of the FT as the icache stage lookup does; */
+/* a miss builds the lines as accumulate_op would for the decoded uops and inserts them. */
+void uop_cache_warmup_ft(uns8 proc_id, FT_Info ft_info, const Addr* inst_addrs, const uns* inst_sizes,
+                         const uns* inst_n_uops, uns num_insts) {
+  if (!UOP_CACHE_ENABLE) {
+    return;
+  }
+
+  set_uop_cache(proc_id);
+  if (uop_cache_lookup_ft_and_fill_lookup_buffer(ft_info, FALSE)) {
+    uop_cache_clear_lookup_buffer();
+    return;
+  }
+
+  clear_accumulation(TRUE);
+  *current_accumulating_ft = ft_info;
+  for (uns i = 0; i < num_insts; i++) {
+    for (uns u = 0; u < inst_n_uops[i]; u++) {
+      if (current_accumulating_line->n_uops == 0) {
+        current_accumulating_line->ft_info_dynamic = ft_info.dynamic_info;
+        current_accumulating_line->line_start = inst_addrs[i];
+      }
+      current_accumulating_line->n_uops++;
+
+      bool eom = u == inst_n_uops[i] - 1;
+      bool end_condition_1 = eom && i == num_insts - 1;
+      bool end_condition_2 = current_accumulating_line->n_uops == ISSUE_WIDTH;
+      if (end_condition_1 || end_condition_2) {
+        if (end_condition_1) {
+          current_accumulating_line->end_of_ft = TRUE;
+        } else {
+          Addr next_line_start = eom ? inst_addrs[i] + inst_sizes[i] : inst_addrs[i];
+          current_accumulating_line->offset = next_line_start - current_accumulating_line->line_start;
+        }
+        end_line_accumulate(end_condition_1);
+      }
+    }
+  }
+}
+
 void recover_uop_cache(void) {
   if (!UOP_CACHE_ENABLE) {
     return;
@@ -482,4 +522,13 @@ void recover_uop_cache(void) {
     ASSERT(uop_cache_proc_id, current_accumulating_ft->static_info == FT_Info_Static{} &&
                               *current_accumulating_op_num == 0);
   }
-}
\ No newline at end of file
+}
+
+void uop_cache_checkpoint(uns8 proc_id) {
+  if (!UOP_CACHE_ENABLE) {
+    return;
+  }
+
+  checkpoint_section("uop_cache");
+  per_core_uop_cache[proc_id]->checkpoint();
+}
@@ -49,6 +49,11 @@ void clear_accumulation(Flag clear_line_only);
 void end_line_accumulate(Flag last_line_of_ft);
 /* accumulate uop into buffer. If terminating condition reached, call insert_uop_cache */
 void accumulate_op(Op* op);
+/* insert an on-path FT during functional warmup; the arrays describe its instructions in order */
+void uop_cache_warmup_ft(uns8 proc_id, FT_Info ft_info, const Addr* inst_addrs, const uns* inst_sizes,
+                         const uns* inst_n_uops, uns num_insts);
+/* save or load the lines of the uop cache of proc_id (see checkpoint.h) */
+void uop_cache_checkpoint(uns8 proc_id);
 
 #ifdef __cplusplus
 }